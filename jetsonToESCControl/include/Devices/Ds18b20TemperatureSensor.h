@@ -1,6 +1,6 @@
 /**
  * @file Ds18b20TemperatureSensor.h
- * @brief ITemperatureSensor implementation for Dallas DS18B20 (OneWire)
+ * @brief ITemperatureSensor implementation for Dallas DS18B20 probes (OneWire)
  * @author Oscar Martinez
  * @date 2026-07-03
  */
@@ -8,17 +8,20 @@
 #pragma once
 
 #include <Arduino.h>
-#include <OneWire.h>
-#include <DallasTemperature.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
 #include "ITemperatureSensor.h"
+#include "GpioOneWireBus.h"
+#include "MoaDs18b20Bus.h"
 
 /**
- * @brief DS18B20 temperature sensor over OneWire
+ * @brief DS18B20 probes on one OneWire bus
  *
- * Wraps a non-blocking conversion state machine internally: readCelsius()
- * kicks off a conversion request on first call (or after the previous
- * reading was consumed), returns false while the conversion is in
- * progress, and returns true with the result once it completes.
+ * Owns the bus and its MoaDs18b20Bus manager. begin() searches the bus once
+ * and caches the ROMs. Each readCelsius() call runs at most one bus
+ * transaction, returns true once per fresh reading of the ESC probe
+ * (TEMP_PROBE_ESC, the one MoaTempControl protects on), and pushes fresh
+ * motor and battery probe readings to the stats queue.
  */
 class Ds18b20TemperatureSensor : public ITemperatureSensor {
 public:
@@ -31,15 +34,24 @@ public:
     void begin() override;
     bool readCelsius(float& outCelsius) override;
 
+    /**
+     * @brief Set the stats queue for the motor and battery probes
+     * @param statsQueue FreeRTOS queue handle for stats readings
+     */
+    void setStatsQueue(QueueHandle_t statsQueue);
+
+    /**
+     * @brief Probe manager (resolution, mode, per-probe counters)
+     */
+    MoaDs18b20Bus& getBus();
+
 private:
-    enum class ConvState {
-        IDLE,       ///< Ready to request a new conversion
-        WAITING     ///< Conversion in progress, waiting for result
-    };
-
-    OneWire _oneWire;
-    DallasTemperature _sensors;
-    ConvState _convState;
-    uint32_t _convRequestTime;
-    uint16_t _convDelayMs;
+    GpioOneWireBus _wire;
+    MoaDs18b20Bus _probes;
+    QueueHandle_t _statsQueue;
+
+    /**
+     * @brief Push a fresh auxiliary probe reading to the stats queue
+     */
+    void pushStatsReading(uint8_t statsType, int32_t centiC);
 };
@@ -3,12 +3,25 @@
 * @brief ESCController class for controlling ESCs
 * @author Oscar Martinez
 * @date 2025-01-28
+*
+* PWM runs at ESC_PWM_RESOLUTION (14 bits); throttle duties in the API stay
+* in ESC_THROTTLE_BITS (10-bit) counts and are scaled on the way in. Ramps
+* are stepped in full resolution by a periodic esp_timer (one step per PWM
+* frame), which runs only while a ramp is in progress. The first step is
+* written by the call that starts the ramp.
+*
+* Each ramp has a shape (linear, S-curve, exponential). The curved shapes
+* are tabulated here, once at construction and again when the config
+* changes the curvature, so the timer callback only interpolates a table.
 */
 
 #pragma once
 
 #include "Arduino.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
 #include "Constants.h"
+#include "MoaEscRamp.h"
 
 class ESCController{
 public:
@@ -25,47 +38,44 @@ public:
      */
     void begin();
 
-    /**
-     * @brief Write the current throttle value to the ESC via PWM
-     */
-    void writeThrottle();
-
     /**
      * @brief Set the throttle value immediately (clamped to min/max bounds)
-     * @param throttle Duty cycle value (servo range: ~51-102 for 1ms-2ms at 50Hz)
+     * @param throttle Duty cycle value (servo range: ~51-102 for 1ms-2ms at 50Hz, 10-bit)
      */
     void setThrottle(uint16_t throttle);
 
     /**
      * @brief Configure a ramped throttle transition
-     * @param rampTime Number of updateRamp() calls to reach target
-     * @param targetThrottle Target throttle value to ramp towards
+     * @param rampTime Number of ramp steps (ESC_RAMP_TICK_US apart) to reach target
+     * @param targetThrottle Target throttle value to ramp towards (10-bit)
      */
     void setRampThrottle(uint16_t rampTime, uint16_t targetThrottle);
 
-    /**
-     * @brief Update the ramp state, call this periodically from a timer/task
-     * @note Safe to call when not ramping - will return immediately
-     */
-    void updateThrottle();
-
     /**
      * @brief Check if a ramp transition is currently in progress
      * @return true if ramping, false otherwise
      */
     bool isRamping() const;
 
+    /**
+     * @brief Check if the output is at minimum with no ramp pending
+     * @return true if the motor is stopped
+     */
+    bool isStopped() const;
+
     /**
      * @brief Set throttle by percentage with ramped transition
      * @param percent Throttle percentage (0-100)
+     * @param shape Ramp shape
      */
-    void setThrottlePercent(uint8_t percent);
+    void setThrottlePercent(uint8_t percent, MoaRampShape shape = MoaRampShape::LINEAR);
 
     /**
      * @brief Set throttle by raw duty cycle with ramped transition
      * @param duty Raw 10-bit duty cycle value (clamped to min/max servo range)
+     * @param shape Ramp shape
      */
-    void setThrottleDuty(uint16_t duty);
+    void setThrottleDuty(uint16_t duty, MoaRampShape shape = MoaRampShape::LINEAR);
 
     /**
      * @brief Set the ramp rate
@@ -74,34 +84,82 @@ public:
     void setRampRate(float ratePercentPerSec);
 
     /**
-     * @brief Set the tick period used for ramp step calculation
-     * @param periodMs Tick interval in milliseconds
+     * @brief Set the exponential ramp curvature and rebuild its table
+     * @param curvature Exponent c of e^(c*t) (<= 0.01 makes EXPO linear)
      */
-    void setTickPeriod(uint16_t periodMs);
+    void setRampCurvature(float curvature);
 
     /**
      * @brief Emergency stop - immediately sets throttle to minimum
      */
     void stop();
 
+    /**
+     * @brief Protection trip - cut the output and latch it at minimum
+     * 
+     * Called directly by the fast overcurrent path (ProtectionTask). While
+     * latched, every PWM write outputs the minimum pulse regardless of the
+     * requested throttle, so a concurrent ramp or throttle command from
+     * another task cannot re-enable the motor.
+     */
+    void trip();
+
+    /**
+     * @brief Release the protection latch (output stays at minimum until the next command)
+     */
+    void clearTrip();
+
+    /**
+     * @brief Check if the protection latch is set
+     * @return true if tripped
+     */
+    bool isTripped() const;
+
     /**
      * @brief Get the current throttle duty cycle value
-     * @return uint16_t Current throttle duty (servo range: ~51-102)
+     * @return uint16_t Current throttle duty (servo range: ~51-102, rounded to 10-bit)
      */
     uint16_t getCurrentThrottle() const;
+
+    /**
+     * @brief Get the duty on the wire in PWM counts
+     * @return uint16_t Current duty (ESC_PWM_RESOLUTION, ~819-1638)
+     */
+    uint16_t getCurrentDuty() const;
 private:
     uint8_t _pin;
     uint8_t _channel;
     uint16_t _frequency;
     uint8_t _resolution;
-    uint16_t _throttle;
-    uint16_t _minThrottle;
-    uint16_t _maxThrottle;
-    uint16_t _currentThrottle;
-    uint16_t _targetThrottle;
-    uint16_t _rampTime;
-    int16_t _rampStep;
-    bool _ramping;
+    uint16_t _minDuty;      // PWM counts at ESC_PULSE_MIN_US
+    uint16_t _maxDuty;      // PWM counts at ESC_PULSE_MAX_US
+    MoaEscRamp _ramp;       // Duty on the wire and ramp state (guarded by _mux)
     float _rampRate;        // %/s
-    uint16_t _tickPeriodMs; // ms per updateThrottle() call
-};
\ No newline at end of file
+    float _rampCurvature;   // EXPO exponent
+    MoaRampProfile _profiles[MOA_RAMP_SHAPE_COUNT]; // Indexed by MoaRampShape (guarded by _mux)
+    esp_timer_handle_t _rampTimer;
+    portMUX_TYPE _mux;
+    volatile bool _tripped; // Protection latch (set from ProtectionTask)
+
+    /**
+     * @brief Scale a 10-bit throttle duty to PWM counts, clamped to the servo range
+     */
+    uint16_t toDuty(uint16_t throttle) const;
+
+    /**
+     * @brief Start a ramp in PWM counts: first step now, then one per ESC_RAMP_TICK_US
+     */
+    void startRamp(uint16_t targetDuty, uint16_t steps, MoaRampShape shape = MoaRampShape::LINEAR);
+
+    /**
+     * @brief Write a duty to the LEDC channel (minimum while tripped)
+     */
+    void writeDuty(uint16_t duty);
+
+    /**
+     * @brief Take one ramp step; stops the ramp timer after the last one
+     */
+    void rampTick();
+
+    static void rampTimerCallback(void* arg);
+};
@@ -0,0 +1,62 @@
+/**
+ * @file EspAdcDmaSource.h
+ * @brief IAdcSampleSource implementation using the ESP32-C3 ADC in continuous (DMA) mode
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "IAdcSampleSource.h"
+#include "Constants.h"
+
+/**
+ * @brief Size of the driver-side DMA result store in bytes
+ * @note 4 bytes per conversion: 4096 bytes hold ~100 ms at 10 kHz
+ */
+#define ESP_ADC_DMA_STORE_BYTES 4096
+
+/**
+ * @brief Bytes converted per DMA interrupt (4 per conversion)
+ */
+#define ESP_ADC_DMA_FRAME_BYTES (ADC_DMA_FRAME_CONVERSIONS * 4)
+
+/**
+ * @brief Bytes copied out of the store per read() call
+ */
+#define ESP_ADC_DMA_READ_BYTES  256
+
+/**
+ * @brief ESP32-C3 ADC1 continuous-mode driver
+ *
+ * Runs the ADC digital controller round-robin over the configured ADC1 pins
+ * at a fixed rate; conversions land in a DMA ring owned by the IDF driver
+ * and are drained non-blockingly by read(). No CPU time is spent per
+ * conversion, and no analogRead() calls are made while it is running.
+ *
+ * @note Only ADC1 pins are supported (GPIO0-GPIO4 on the C3). While running,
+ *       the one-shot analogRead() path must not be used on ADC1.
+ */
+class EspAdcDmaSource : public IAdcSampleSource {
+public:
+    EspAdcDmaSource();
+    ~EspAdcDmaSource() override;
+
+    bool begin(const uint8_t* pins, uint8_t numPins, uint32_t sampleRateHz) override;
+    void stop() override;
+    size_t read(MoaAdcRawSample* out, size_t maxSamples) override;
+
+    /**
+     * @brief Number of read() calls that reported a driver-side store overflow
+     * @return uint32_t Overflow count since begin()
+     */
+    uint32_t getOverflowCount() const;
+
+private:
+    static const uint8_t MAX_PINS = 5;
+
+    int8_t _channelToPin[8];     ///< ADC1 channel -> GPIO pin (-1 if unused)
+    bool _running;               ///< Driver initialised and started
+    uint32_t _overflows;         ///< Store overflows reported by the driver
+};
@@ -0,0 +1,35 @@
+/**
+ * @file GpioOneWireBus.h
+ * @brief IOneWireBus backend on the OneWire library
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <OneWire.h>
+#include "IOneWireBus.h"
+
+/**
+ * @brief 1-Wire transactions bit-banged on one GPIO
+ *
+ * Each time slot is timed with interrupts disabled (~70 us per bit, ~1 ms
+ * per reset), so the cost of a transaction is its length in bits.
+ */
+class GpioOneWireBus : public IOneWireBus {
+public:
+    /**
+     * @param pin GPIO connected to the 1-Wire data line
+     */
+    explicit GpioOneWireBus(uint8_t pin);
+
+    void resetSearch() override;
+    bool search(uint8_t rom[ONEWIRE_ROM_BYTES]) override;
+    bool transaction(const uint8_t* rom, uint8_t command,
+                     const uint8_t* tx, size_t txLength,
+                     uint8_t* rx, size_t rxLength, bool strongPullup) override;
+
+private:
+    OneWire _oneWire;   ///< Bit-level driver
+};
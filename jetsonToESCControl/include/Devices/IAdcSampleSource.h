@@ -0,0 +1,57 @@
+/**
+ * @file IAdcSampleSource.h
+ * @brief Abstract interface for a continuous (block-based) ADC backend
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Decouples MoaAdcSampler from the concrete acquisition hardware, so the
+ * ESP32-C3 DMA driver (EspAdcDmaSource) and a simulated source used by the
+ * host tests (SimulatedAdcSource) can be injected interchangeably.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief One raw conversion result tagged with the pin it was taken on
+ */
+struct MoaAdcRawSample {
+    uint8_t pin;      ///< GPIO pin the conversion belongs to
+    uint16_t raw;     ///< Raw ADC code (0-4095 for 12-bit)
+};
+
+/**
+ * @brief Abstract continuous ADC sample source
+ *
+ * The source converts the configured pins round-robin at a fixed rate and
+ * buffers the results internally (DMA ring on the ESP32-C3). read() drains
+ * whatever is buffered without blocking.
+ */
+class IAdcSampleSource {
+public:
+    virtual ~IAdcSampleSource() = default;
+
+    /**
+     * @brief Configure and start continuous conversion
+     * @param pins Pins to convert, in scan order
+     * @param numPins Number of entries in pins
+     * @param sampleRateHz Total conversion rate across all pins
+     * @return true if acquisition started
+     */
+    virtual bool begin(const uint8_t* pins, uint8_t numPins, uint32_t sampleRateHz) = 0;
+
+    /**
+     * @brief Stop conversion and release the hardware
+     */
+    virtual void stop() = 0;
+
+    /**
+     * @brief Drain buffered conversions without blocking
+     * @param out Destination array
+     * @param maxSamples Capacity of out
+     * @return Number of samples written (0 if nothing is buffered yet)
+     */
+    virtual size_t read(MoaAdcRawSample* out, size_t maxSamples) = 0;
+};
@@ -0,0 +1,47 @@
+/**
+ * @file II2cBus.h
+ * @brief Abstract register-oriented I2C bus
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Decouples MoaMcpRegisterFile from the Arduino Wire library, so the
+ * ESP32-C3 I2C peripheral (WireI2cBus) and a simulated MCP23018 that
+ * counts bus traffic in host tests (SimulatedMcp23018) can be injected
+ * interchangeably.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Burst register access on an I2C bus
+ *
+ * Each call is exactly one bus transaction (START ... STOP). Multi-byte
+ * transfers rely on the device auto-incrementing its register pointer.
+ */
+class II2cBus {
+public:
+    virtual ~II2cBus() = default;
+
+    /**
+     * @brief Write consecutive registers in one transaction
+     * @param address 7-bit device address
+     * @param reg First register
+     * @param data Register values
+     * @param length Number of registers
+     * @return true if the device acknowledged every byte
+     */
+    virtual bool writeRegisters(uint8_t address, uint8_t reg, const uint8_t* data, size_t length) = 0;
+
+    /**
+     * @brief Read consecutive registers in one transaction (repeated start)
+     * @param address 7-bit device address
+     * @param reg First register
+     * @param data Destination
+     * @param length Number of registers
+     * @return true if all bytes were received
+     */
+    virtual bool readRegisters(uint8_t address, uint8_t reg, uint8_t* data, size_t length) = 0;
+};
@@ -0,0 +1,32 @@
+/**
+ * @file ILogSink.h
+ * @brief Abstract byte sink for streaming log export
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * MoaLogExporter writes its output in fixed-size chunks into an ILogSink,
+ * so the same export can go to Serial or a TCP client (PrintLogSink), a
+ * BLE characteristic, or a buffer in the host tests, without ever building
+ * the whole document in memory.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Destination for exported log chunks
+ */
+class ILogSink {
+public:
+    virtual ~ILogSink() = default;
+
+    /**
+     * @brief Write one chunk
+     * @param data Chunk bytes (only valid during the call)
+     * @param length Chunk size (<= MOA_LOG_EXPORT_CHUNK_SIZE)
+     * @return size_t Bytes accepted; fewer than length aborts the export
+     */
+    virtual size_t write(const uint8_t* data, size_t length) = 0;
+};
@@ -0,0 +1,75 @@
+/**
+ * @file ILogStorage.h
+ * @brief Abstract append-oriented file interface for the flash log
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Decouples MoaLogJournal from the filesystem, so LittleFS on the ESP32-C3
+ * (LittleFsLogStorage) and a file-backed stand-in with power-cut fault
+ * injection used by the host tests (SimulatedLogStorage) can be injected
+ * interchangeably.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Minimal file operations needed by an append-only log
+ *
+ * Paths are absolute ("/moa_log.0"). Every call opens and closes the file,
+ * so each successful append is committed when the call returns.
+ */
+class ILogStorage {
+public:
+    virtual ~ILogStorage() = default;
+
+    /**
+     * @brief Mount the filesystem
+     * @return true if the storage is usable
+     */
+    virtual bool begin() = 0;
+
+    /**
+     * @brief Size of a file
+     * @param path File path
+     * @return int32_t Size in bytes, or -1 if the file does not exist
+     */
+    virtual int32_t size(const char* path) = 0;
+
+    /**
+     * @brief Read from a file
+     * @param path File path
+     * @param offset Byte offset to start at
+     * @param buffer Destination
+     * @param length Bytes to read
+     * @return size_t Bytes actually read
+     */
+    virtual size_t read(const char* path, uint32_t offset, uint8_t* buffer, size_t length) = 0;
+
+    /**
+     * @brief Append to a file (created if missing)
+     * @param path File path
+     * @param data Bytes to append
+     * @param length Number of bytes
+     * @return size_t Bytes actually written
+     */
+    virtual size_t append(const char* path, const uint8_t* data, size_t length) = 0;
+
+    /**
+     * @brief Create or truncate a file with initial content
+     * @param path File path
+     * @param data Initial content
+     * @param length Number of bytes
+     * @return true if all bytes were written
+     */
+    virtual bool create(const char* path, const uint8_t* data, size_t length) = 0;
+
+    /**
+     * @brief Delete a file (missing files are not an error)
+     * @param path File path
+     * @return true if the file no longer exists
+     */
+    virtual bool remove(const char* path) = 0;
+};
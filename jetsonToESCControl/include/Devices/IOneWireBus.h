@@ -0,0 +1,61 @@
+/**
+ * @file IOneWireBus.h
+ * @brief Abstract transaction-oriented 1-Wire bus
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Decouples MoaDs18b20Bus from the OneWire library, so the bit-banged GPIO
+ * bus (GpioOneWireBus) and a simulated bus of DS18B20 probes that counts
+ * bus time in host tests (SimulatedDs18b20Bus) can be injected
+ * interchangeably.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief ROM code length (family, 48-bit serial, CRC)
+ */
+#define ONEWIRE_ROM_BYTES   8
+
+/**
+ * @brief 1-Wire bus: ROM search and single transactions
+ *
+ * A transaction is reset, ROM command (Match ROM or Skip ROM), one
+ * function command, then data written and data read. Nothing else touches
+ * the bus between two calls.
+ */
+class IOneWireBus {
+public:
+    virtual ~IOneWireBus() = default;
+
+    /**
+     * @brief Restart the ROM search from the first device
+     */
+    virtual void resetSearch() = 0;
+
+    /**
+     * @brief Find the next device on the bus
+     * @param rom Receives the ROM code (not CRC-checked)
+     * @return false when every device has been returned
+     */
+    virtual bool search(uint8_t rom[ONEWIRE_ROM_BYTES]) = 0;
+
+    /**
+     * @brief Run one transaction
+     * @param rom Device to address, or nullptr for every device (Skip ROM)
+     * @param command Function command
+     * @param tx Bytes written after the command (may be nullptr if txLength is 0)
+     * @param txLength Number of bytes written
+     * @param rx Bytes read after that (may be nullptr if rxLength is 0)
+     * @param rxLength Number of bytes read
+     * @param strongPullup Drive the line high after the command (parasite
+     *                     power for a conversion); released by the next reset
+     * @return true if a device answered the reset pulse
+     */
+    virtual bool transaction(const uint8_t* rom, uint8_t command,
+                             const uint8_t* tx, size_t txLength,
+                             uint8_t* rx, size_t rxLength, bool strongPullup) = 0;
+};
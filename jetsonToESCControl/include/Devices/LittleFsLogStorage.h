@@ -0,0 +1,32 @@
+/**
+ * @file LittleFsLogStorage.h
+ * @brief ILogStorage implementation on the ESP32 LittleFS partition
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "ILogStorage.h"
+
+/**
+ * @brief LittleFS-backed log storage
+ *
+ * Appends use mode "a", so LittleFS only rewrites the tail block of the
+ * file instead of the whole log.
+ */
+class LittleFsLogStorage : public ILogStorage {
+public:
+    LittleFsLogStorage();
+
+    bool begin() override;
+    int32_t size(const char* path) override;
+    size_t read(const char* path, uint32_t offset, uint8_t* buffer, size_t length) override;
+    size_t append(const char* path, const uint8_t* data, size_t length) override;
+    bool create(const char* path, const uint8_t* data, size_t length) override;
+    bool remove(const char* path) override;
+
+private:
+    bool _mounted;   ///< LittleFS mounted
+};
@@ -16,7 +16,14 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "ControlCommand.h"
+#include "MoaEventChannel.h"
 #include "StatsReading.h"
+#include "MoaMovingAverage.h"
+#include "MoaFixedPoint.h"
+#include "MoaAdcSampler.h"
+#include "MoaBattLevel.h"
+#include "MoaBattResistance.h"
+#include <atomic>
 
 /**
  * @brief Default number of samples for battery voltage averaging
@@ -38,24 +45,20 @@
  */
 #define MOA_BATT_STOP_CONFIRM_MS 500
 
-/**
- * @brief Battery level state enumeration
- */
-enum class MoaBattLevel {
-    BATT_STOP,    ///< Battery below stop threshold (critical)
-    BATT_LOW,     ///< Battery below low threshold (warning)
-    BATT_MEDIUM,  ///< Battery between low and high thresholds
-    BATT_HIGH     ///< Battery above high threshold (fully charged)
-};
-
 /**
  * @brief Battery monitoring class with threshold-based events and averaging
  * 
  * MoaBattControl provides battery voltage monitoring via ADC with:
  * - Configurable voltage divider ratio for accurate voltage calculation
- * - Configurable moving average filtering
+ * - Configurable moving average filtering (O(1) per sample, no heap)
  * - Two-threshold detection (low and high) creating three zones
  * - Event-driven integration via FreeRTOS queue
+ * - Integer-only sample path: reference voltage and divider ratio are
+ *   folded into a MoaFixedScale when set, samples are converted to mV
+ * - Load compensation: with the battery current fed in, levels are judged
+ *   on the open-circuit voltage V + I x R, R learned from throttle steps
+ *   (MoaBattResistance), so sag at full throttle is not a low battery;
+ *   events and stats still carry the averaged terminal voltage
  * 
  * When battery level crosses thresholds, it automatically pushes a ControlCommand
  * event to the configured queue.
@@ -73,8 +76,9 @@ enum class MoaBattLevel {
  * 
  * ## Usage Example
  * @code
- * QueueHandle_t eventQueue = xQueueCreate(10, sizeof(ControlCommand));
- * MoaBattControl battery(eventQueue, ADC_PIN);
+ * MoaEventChannel events;
+ * events.begin();
+ * MoaBattControl battery(&events, ADC_PIN);
  * 
  * battery.setDividerRatio(3.128f);      // 100k/47k divider
  * battery.setReferenceVoltage(3.3f);    // ESP32 ADC reference
@@ -83,12 +87,14 @@ enum class MoaBattLevel {
  * battery.begin();
  * 
  * // In SensorTask, call periodically:
+ * battery.setLoadCurrent(current.getCurrentMa());
  * battery.update();
  * 
  * // In ControlTask, handle the event:
  * // if (cmd.controlType == CONTROL_TYPE_BATTERY) {
- * //     float voltage = cmd.value / 1000.0f;  // Voltage in V (mV for precision)
- * //     stateMachine.batteryLevelCrossedLimit(cmd);
+ * //     BattEvent event(cmd);
+ * //     float voltage = event.getMillivolts() / 1000.0f;  // Voltage in V (mV for precision)
+ * //     stateMachine.batteryLevelCrossedLimit(event);
  * // }
  * @endcode
  */
@@ -97,18 +103,13 @@ public:
     /**
      * @brief Construct a new MoaBattControl object
      * 
-     * @param eventQueue FreeRTOS queue handle to push battery events to
+     * @param eventQueue Event channel to push battery events to
      * @param adcPin ADC pin connected to the voltage divider output
      * @param numSamples Number of samples for moving average (default: MOA_BATT_DEFAULT_SAMPLES)
      */
-    MoaBattControl(QueueHandle_t eventQueue, uint8_t adcPin,
+    MoaBattControl(MoaEventChannel* eventQueue, uint8_t adcPin,
                    uint8_t numSamples = MOA_BATT_DEFAULT_SAMPLES);
 
-    /**
-     * @brief Destructor - frees allocated sample buffer
-     */
-    ~MoaBattControl();
-
     /**
      * @brief Initialize the ADC for battery monitoring
      * @note Must be called before update()
@@ -119,7 +120,8 @@ public:
      * @brief Read ADC, update average, and check thresholds
      * 
      * This method:
-     * 1. Reads the ADC value from the configured pin
+     * 1. Takes the block of decimated samples from the attached MoaAdcSampler
+     *    (continuous mode), or reads the ADC value from the configured pin
      * 2. Converts to voltage using divider ratio
      * 3. Updates the moving average
      * 4. Checks if voltage crossed thresholds and pushes event if needed
@@ -128,6 +130,18 @@ public:
      */
     void update();
 
+    /**
+     * @brief Process a block of raw ADC samples
+     * 
+     * Every sample is converted and fed through the moving average; the
+     * thresholds are then evaluated once on the resulting average and one
+     * stats reading is pushed for the whole block.
+     * 
+     * @param rawSamples Raw ADC codes, oldest first
+     * @param count Number of samples in the block
+     */
+    void processBlock(const uint16_t* rawSamples, size_t count);
+
     /**
      * @brief Set the voltage divider ratio
      * 
@@ -217,6 +231,53 @@ public:
      */
     float getHysteresis() const;
 
+    /**
+     * @brief Judge levels on the open-circuit voltage (true) or the terminal voltage (false)
+     * @param enabled Load compensation on/off; any task
+     */
+    void setLoadCompensation(bool enabled);
+
+    /**
+     * @brief Check whether levels are judged on the open-circuit voltage
+     * @return true if load compensation is on
+     */
+    bool isLoadCompensated() const;
+
+    /**
+     * @brief Set the internal resistance the estimate starts from
+     * @param milliohm Resistance before any throttle step (mOhm); any task
+     */
+    void setInitialResistance(uint32_t milliohm);
+
+    /**
+     * @brief Set the most the compensation may add to the voltage
+     * @param millivolts Maximum sag compensated (mV); any task
+     */
+    void setMaxSag(uint32_t millivolts);
+
+    /**
+     * @brief Battery current for the next update()
+     *
+     * Call from the same task as update(), with the latest current. It is
+     * averaged here alongside each voltage sample of the block, so both
+     * sides of V + I x R cover the same window.
+     *
+     * @param currentMa Battery current (mA, positive = discharge)
+     */
+    void setLoadCurrent(int32_t currentMa);
+
+    /**
+     * @brief Get the internal resistance estimator
+     * @return const MoaBattResistance& Learned resistance and step counts
+     */
+    const MoaBattResistance& getResistance() const;
+
+    /**
+     * @brief Get the open-circuit voltage inferred from the last update
+     * @return int32_t Averaged voltage + averaged load current x R (mV)
+     */
+    int32_t getOpenCircuitVoltageMv() const;
+
     /**
      * @brief Get the current raw ADC reading
      * @return uint16_t Raw ADC value (0-4095 for 12-bit)
@@ -235,6 +296,18 @@ public:
      */
     float getAveragedVoltage() const;
 
+    /**
+     * @brief Get the current calculated battery voltage (not averaged)
+     * @return int32_t Battery voltage in mV
+     */
+    int32_t getCurrentVoltageMv() const;
+
+    /**
+     * @brief Get the current averaged battery voltage
+     * @return int32_t Averaged battery voltage in mV
+     */
+    int32_t getAveragedVoltageMv() const;
+
     /**
      * @brief Get the current battery level state
      * @return MoaBattLevel Current level (LOW, MEDIUM, or HIGH)
@@ -273,10 +346,10 @@ public:
     uint8_t getAdcResolution() const;
 
     /**
-     * @brief Set the event queue handle (must be called after queue creation)
-     * @param eventQueue FreeRTOS queue handle for control events
+     * @brief Set the event channel (must be called after it is created)
+     * @param eventQueue Event channel for control events
      */
-    void setEventQueue(QueueHandle_t eventQueue);
+    void setEventQueue(MoaEventChannel* eventQueue);
 
     /**
      * @brief Set the stats queue for telemetry
@@ -284,8 +357,19 @@ public:
      */
     void setStatsQueue(QueueHandle_t statsQueue);
 
+    /**
+     * @brief Attach a continuous ADC sampler as the sample source
+     * 
+     * When set, update() consumes decimated blocks from the sampler instead
+     * of calling analogRead().
+     * 
+     * @param sampler Sampler instance (not owned), or nullptr for one-shot reads
+     * @param slot Channel slot returned by MoaAdcSampler::addChannel()
+     */
+    void setAdcSampler(MoaAdcSampler* sampler, uint8_t slot);
+
 private:
-    QueueHandle_t _eventQueue;         ///< Queue to push events to
+    MoaEventChannel* _eventQueue;         ///< Channel to push events to
     QueueHandle_t _statsQueue;         ///< Queue to push stats readings to
     uint8_t _adcPin;                   ///< ADC pin number
     uint8_t _adcResolution;            ///< ADC resolution in bits
@@ -295,52 +379,59 @@ private:
     float _stopThreshold;              ///< Critical stop threshold voltage
     float _highThreshold;              ///< High battery threshold voltage
     float _hysteresis;                 ///< Hysteresis for threshold detection
+    MoaFixedScale _scale;              ///< Folded raw -> mV conversion
+    int32_t _lowMv;                    ///< Folded low threshold (mV)
+    int32_t _stopMv;                   ///< Folded stop threshold (mV)
+    int32_t _highMv;                   ///< Folded high threshold (mV)
+    int32_t _hysteresisMv;             ///< Folded hysteresis (mV)
     uint16_t _rawAdc;                  ///< Current raw ADC reading
-    float _currentVoltage;             ///< Current calculated voltage
+    int32_t _currentMv;                ///< Current calculated voltage (mV)
     MoaBattLevel _level;               ///< Current battery level state
 
-    float* _samples;                   ///< Circular buffer for voltage samples
-    uint8_t _numSamples;               ///< Number of samples for averaging
-    uint8_t _sampleIndex;              ///< Current index in circular buffer
-    uint8_t _sampleCount;              ///< Number of valid samples in buffer
-    float _averagedVoltage;            ///< Cached averaged voltage
+    MoaMovingAverage<int32_t, MOA_BATT_MAX_SAMPLES> _filter; ///< O(1) moving-window average (mV)
+    int32_t _averagedMv;               ///< Cached averaged voltage (mV)
     uint32_t _updateCount;             ///< Counter for periodic logging
+    MoaAdcSampler* _adcSampler;        ///< Continuous ADC sampler (not owned, optional)
+    uint8_t _adcSlot;                  ///< Sampler channel slot for this sensor
     uint32_t _lowConfirmMs;            ///< Required time below low threshold before LOW event
     uint32_t _stopConfirmMs;           ///< Required time below stop threshold before STOP event
     uint32_t _belowLowSinceMs;         ///< Timestamp when voltage first went below low threshold
     uint32_t _belowStopSinceMs;        ///< Timestamp when voltage first went below stop threshold
+    MoaBattResistance _resistance;     ///< Learned internal resistance
+    std::atomic<bool> _compensate;     ///< Judge levels on the open-circuit voltage
+    int32_t _loadMa;                   ///< Battery current for the next update (mA)
+    MoaMovingAverage<int32_t, MOA_BATT_MAX_SAMPLES> _loadFilter; ///< Current over the voltage window (mA)
+    int32_t _averagedLoadMa;           ///< Cached averaged current (mA)
+    int32_t _openCircuitMv;            ///< Averaged voltage + load drop (mV)
 
     /**
-     * @brief Add a new sample to the circular buffer and update average
-     * @param voltage Voltage value to add
+     * @brief Add a new sample to the moving-window filter and update average
+     * @param voltageMv Voltage value to add (mV)
      */
-    void addSample(float voltage);
-
-    /**
-     * @brief Calculate the average of all samples in the buffer
-     * @return float Averaged voltage
-     */
-    float calculateAverage() const;
+    void addSample(int32_t voltageMv);
 
     /**
      * @brief Validate that voltage has remained below threshold for a minimum duration
-     * @param voltage Current averaged voltage
-     * @param threshold Threshold to compare against
+     * @param voltageMv Current averaged voltage (mV)
+     * @param thresholdMv Threshold to compare against (mV)
      * @param confirmMs Required hold time in milliseconds
      * @param nowMs Current timestamp from millis()
      * @param sinceMs Timestamp state (updated by function)
      * @return true if voltage has been below threshold for at least confirmMs
      */
-    bool isBelowThresholdForDuration(float voltage, float threshold,
+    bool isBelowThresholdForDuration(int32_t voltageMv, int32_t thresholdMv,
                                      uint32_t confirmMs, uint32_t nowMs,
                                      uint32_t& sinceMs);
 
     /**
-     * @brief Convert raw ADC value to actual battery voltage
-     * @param rawAdc Raw ADC reading
-     * @return float Battery voltage in volts
+     * @brief Refold the raw -> mV scale after a calibration change
+     */
+    void updateScale();
+
+    /**
+     * @brief Refold the thresholds and hysteresis to mV
      */
-    float adcToVoltage(uint16_t rawAdc) const;
+    void updateThresholds();
 
     /**
      * @brief Push a battery level event to the queue
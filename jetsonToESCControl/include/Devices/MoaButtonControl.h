@@ -23,6 +23,7 @@
 #include "freertos/queue.h"
 #include "MoaMcpDevice.h"
 #include "ControlCommand.h"
+#include "MoaEventChannel.h"
 
 /**
  * @brief Button pin mapping on MCP23018 Port A
@@ -75,11 +76,12 @@
  * 
  * ## Usage Example
  * @code
- * QueueHandle_t eventQueue = xQueueCreate(10, sizeof(ControlCommand));
+ * MoaEventChannel events;
+ * events.begin();
  * MoaMcpDevice mcpDevice(0x20);
  * mcpDevice.begin();
  * 
- * MoaButtonControl buttons(eventQueue, mcpDevice, GPIO_NUM_2);
+ * MoaButtonControl buttons(&events, mcpDevice, GPIO_NUM_2);
  * buttons.setDebounceTime(50);
  * buttons.setLongPressTime(5000);
  * buttons.enableLongPress(true);
@@ -95,7 +97,8 @@
  * 
  * // In ControlTask, handle the event:
  * // if (cmd.controlType == CONTROL_TYPE_BUTTON) {
- * //     if (cmd.commandType == COMMAND_BUTTON_STOP && cmd.value == BUTTON_EVENT_LONG_PRESS) {
+ * //     ButtonEvent event(cmd);
+ * //     if (event.getButtonId() == COMMAND_BUTTON_STOP && event.getEventType() == BUTTON_EVENT_LONG_PRESS) {
  * //         enterConfigMode();
  * //     }
  * // }
@@ -106,11 +109,11 @@ public:
     /**
      * @brief Construct a new MoaButtonControl object
      * 
-     * @param eventQueue FreeRTOS queue handle to push button events to
+     * @param eventQueue Event channel to push button events to
      * @param mcpDevice Reference to shared MoaMcpDevice instance
      * @param intPin ESP32 GPIO pin connected to MCP23018 INTA (for interrupt mode)
      */
-    MoaButtonControl(QueueHandle_t eventQueue, MoaMcpDevice& mcpDevice, uint8_t intPin);
+    MoaButtonControl(MoaEventChannel* eventQueue, MoaMcpDevice& mcpDevice, uint8_t intPin);
 
     /**
      * @brief Destructor
@@ -269,13 +272,13 @@ public:
     uint8_t getInterruptPin() const;
 
     /**
-     * @brief Set the event queue handle (must be called after queue creation)
-     * @param eventQueue FreeRTOS queue handle for control events
+     * @brief Set the event channel (must be called after it is created)
+     * @param eventQueue Event channel for control events
      */
-    void setEventQueue(QueueHandle_t eventQueue);
+    void setEventQueue(MoaEventChannel* eventQueue);
 
 private:
-    QueueHandle_t _eventQueue;         ///< Queue to push events to
+    MoaEventChannel* _eventQueue;         ///< Channel to push events to
     MoaMcpDevice& _mcpDevice;          ///< Reference to shared MCP device
     uint8_t _intPin;                   ///< ESP32 interrupt pin
     
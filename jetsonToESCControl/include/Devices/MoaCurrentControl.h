@@ -22,7 +22,12 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "ControlCommand.h"
+#include "MoaEventChannel.h"
 #include "StatsReading.h"
+#include "MoaMovingAverage.h"
+#include "MoaFixedPoint.h"
+#include "MoaAdcSampler.h"
+#include "MoaOvercurrentTrip.h"
 
 /**
  * @brief Default number of samples for current averaging
@@ -50,10 +55,13 @@ enum class MoaCurrentState {
  * (ACS759-200B or similar) with:
  * - Configurable sensitivity for different sensor models
  * - Configurable zero-current offset voltage
- * - Configurable moving average filtering
+ * - Configurable moving average filtering (O(1) per sample, no heap)
  * - Bidirectional current detection (positive and negative)
  * - Threshold detection with hysteresis
  * - Event-driven integration via FreeRTOS queue
+ * - Per-sample fast trip (MoaOvercurrentTrip) for the continuous ADC path
+ * - Integer-only sample path: calibration is folded into a MoaFixedScale
+ *   when it is set, samples are converted straight to mA
  * 
  * When current crosses thresholds, it automatically pushes a ControlCommand
  * event to the configured queue.
@@ -67,11 +75,13 @@ enum class MoaCurrentState {
  * - Sensitivity: 6.6 mV/A
  * - Zero offset: VCC/2 = 1.65V (at 3.3V supply)
  * - Formula: Current = (Vadc - Voffset) / Sensitivity
+ * - Folded: mA = raw * (Vref * 1000 / (maxAdc * Sensitivity)) - Voffset * 1000 / Sensitivity
  * 
  * ## Usage Example
  * @code
- * QueueHandle_t eventQueue = xQueueCreate(10, sizeof(ControlCommand));
- * MoaCurrentControl currentSensor(eventQueue, ADC_PIN);
+ * MoaEventChannel events;
+ * events.begin();
+ * MoaCurrentControl currentSensor(&events, ADC_PIN);
  * 
  * currentSensor.setSensitivity(0.0066f);     // 6.6 mV/A = 0.0066 V/A
  * currentSensor.setZeroOffset(1.65f);        // VCC/2 at 0A
@@ -85,9 +95,10 @@ enum class MoaCurrentState {
  * 
  * // In ControlTask, handle the event:
  * // if (cmd.controlType == CONTROL_TYPE_CURRENT) {
- * //     float current = cmd.value / 10.0f;  // Current in A (x10 for precision)
- * //     if (cmd.commandType == COMMAND_CURRENT_OVERCURRENT) {
- * //         stateMachine.overcurrentDetected(cmd);
+ * //     CurrentEvent event(cmd);
+ * //     float current = event.getDeciAmps() / 10.0f;  // Current in A (x10 for precision)
+ * //     if (event.getCommand() == COMMAND_CURRENT_OVERCURRENT) {
+ * //         stateMachine.overcurrentDetected(event);
  * //     }
  * // }
  * @endcode
@@ -97,18 +108,13 @@ public:
     /**
      * @brief Construct a new MoaCurrentControl object
      * 
-     * @param eventQueue FreeRTOS queue handle to push current events to
+     * @param eventQueue Event channel to push current events to
      * @param adcPin ADC pin connected to the Hall effect sensor output
      * @param numSamples Number of samples for moving average (default: MOA_CURRENT_DEFAULT_SAMPLES)
      */
-    MoaCurrentControl(QueueHandle_t eventQueue, uint8_t adcPin,
+    MoaCurrentControl(MoaEventChannel* eventQueue, uint8_t adcPin,
                       uint8_t numSamples = MOA_CURRENT_DEFAULT_SAMPLES);
 
-    /**
-     * @brief Destructor - frees allocated sample buffer
-     */
-    ~MoaCurrentControl();
-
     /**
      * @brief Initialize the ADC for current monitoring
      * @note Must be called before update()
@@ -119,7 +125,8 @@ public:
      * @brief Read ADC, update average, and check thresholds
      * 
      * This method:
-     * 1. Reads the ADC value from the configured pin
+     * 1. Takes the block of decimated samples from the attached MoaAdcSampler
+     *    (continuous mode), or reads the ADC value from the configured pin
      * 2. Converts to current using sensitivity and offset
      * 3. Updates the moving average
      * 4. Checks if current crossed thresholds and pushes event if needed
@@ -128,6 +135,18 @@ public:
      */
     void update();
 
+    /**
+     * @brief Process a block of raw ADC samples
+     * 
+     * Every sample is converted and fed through the moving average; the
+     * thresholds are then evaluated once on the resulting average and one
+     * stats reading is pushed for the whole block.
+     * 
+     * @param rawSamples Raw ADC codes, oldest first
+     * @param count Number of samples in the block
+     */
+    void processBlock(const uint16_t* rawSamples, size_t count);
+
     /**
      * @brief Set the sensor sensitivity
      * 
@@ -240,6 +259,18 @@ public:
      */
     float getAveragedCurrent() const;
 
+    /**
+     * @brief Get the current calculated current (not averaged)
+     * @return int32_t Current in mA
+     */
+    int32_t getCurrentMa() const;
+
+    /**
+     * @brief Get the current averaged current
+     * @return int32_t Averaged current in mA
+     */
+    int32_t getAveragedCurrentMa() const;
+
     /**
      * @brief Get the current state
      * @return MoaCurrentState Current state (NORMAL, OVERCURRENT, or REVERSE_OVERCURRENT)
@@ -278,10 +309,10 @@ public:
     uint8_t getAdcResolution() const;
 
     /**
-     * @brief Set the event queue handle (must be called after queue creation)
-     * @param eventQueue FreeRTOS queue handle for control events
+     * @brief Set the event channel (must be called after it is created)
+     * @param eventQueue Event channel for control events
      */
-    void setEventQueue(QueueHandle_t eventQueue);
+    void setEventQueue(MoaEventChannel* eventQueue);
 
     /**
      * @brief Set the stats queue for telemetry
@@ -289,8 +320,67 @@ public:
      */
     void setStatsQueue(QueueHandle_t statsQueue);
 
+    /**
+     * @brief Attach a continuous ADC sampler as the sample source
+     * 
+     * When set, update() consumes decimated blocks from the sampler instead
+     * of calling analogRead().
+     * 
+     * @param sampler Sampler instance (not owned), or nullptr for one-shot reads
+     * @param slot Channel slot returned by MoaAdcSampler::addChannel()
+     */
+    void setAdcSampler(MoaAdcSampler* sampler, uint8_t slot);
+
+    /**
+     * @brief Get the per-sample fast trip comparator
+     * 
+     * Thresholds are kept in sync with the sensor calibration; attach it to
+     * the sampler with MoaAdcSampler::setTripMonitor() and set the handler.
+     * 
+     * @return MoaOvercurrentTrip& Fast trip comparator
+     */
+    MoaOvercurrentTrip& getFastTrip();
+
+    /**
+     * @brief Set the fast trip threshold (positive direction)
+     * @param current Threshold in Amps (<= 0 disables)
+     */
+    void setFastTripThreshold(float current);
+
+    /**
+     * @brief Get the fast trip threshold
+     * @return float Fast trip threshold in Amps
+     */
+    float getFastTripThreshold() const;
+
+    /**
+     * @brief Set the fast trip threshold (reverse direction)
+     * @param current Threshold in Amps (negative value, >= 0 disables)
+     */
+    void setFastTripReverseThreshold(float current);
+
+    /**
+     * @brief Get the reverse fast trip threshold
+     * @return float Reverse fast trip threshold in Amps
+     */
+    float getFastTripReverseThreshold() const;
+
+    /**
+     * @brief Convert a raw ADC code to current without touching the sensor state
+     * @param rawAdc Raw ADC reading
+     * @return int32_t Current in mA
+     */
+    int32_t rawToMilliamps(uint16_t rawAdc) const;
+
+    /**
+     * @brief Convert a current to the raw ADC code the sensor would output
+     * @param current Current in Amps
+     * @return uint16_t Raw ADC code (clamped to the ADC range)
+     */
+    uint16_t currentToRaw(float current) const;
+
 private:
-    QueueHandle_t _eventQueue;         ///< Queue to push events to
+    MoaEventChannel* _eventQueue;         ///< Channel to push events to
     QueueHandle_t _statsQueue;         ///< Queue to push stats readings to
     uint8_t _adcPin;                   ///< ADC pin number
     uint8_t _adcResolution;            ///< ADC resolution in bits
@@ -300,36 +390,38 @@ private:
     float _overcurrentThreshold;       ///< Positive overcurrent threshold
     float _reverseOvercurrentThreshold;///< Negative overcurrent threshold
     float _hysteresis;                 ///< Hysteresis for threshold detection
+    MoaFixedScale _scale;              ///< Folded raw -> mA conversion
+    int32_t _overcurrentMa;            ///< Folded positive threshold (mA)
+    int32_t _reverseOvercurrentMa;     ///< Folded negative threshold (mA)
+    int32_t _hysteresisMa;             ///< Folded hysteresis (mA)
     uint16_t _rawAdc;                  ///< Current raw ADC reading
-    float _adcVoltage;                 ///< Current ADC voltage
-    float _currentReading;             ///< Current calculated current
+    int32_t _currentMa;                ///< Current calculated current (mA)
     MoaCurrentState _state;            ///< Current state
 
-    float* _samples;                   ///< Circular buffer for current samples
-    uint8_t _numSamples;               ///< Number of samples for averaging
-    uint8_t _sampleIndex;              ///< Current index in circular buffer
-    uint8_t _sampleCount;              ///< Number of valid samples in buffer
-    float _averagedCurrent;            ///< Cached averaged current
+    MoaMovingAverage<int32_t, MOA_CURRENT_MAX_SAMPLES> _filter; ///< O(1) moving-window average (mA)
+    int32_t _averagedMa;               ///< Cached averaged current (mA)
     uint32_t _updateCount;             ///< Counter for periodic logging
+    MoaAdcSampler* _adcSampler;        ///< Continuous ADC sampler (not owned, optional)
+    uint8_t _adcSlot;                  ///< Sampler channel slot for this sensor
+    MoaOvercurrentTrip _fastTrip;      ///< Per-sample fast trip comparator
+    float _fastTripThreshold;          ///< Fast trip threshold (A, <= 0 disabled)
+    float _fastTripReverseThreshold;   ///< Reverse fast trip threshold (A, >= 0 disabled)
 
     /**
-     * @brief Add a new sample to the circular buffer and update average
-     * @param current Current value to add
+     * @brief Add a new sample to the moving-window filter and update average
+     * @param currentMa Current value to add (mA)
      */
-    void addSample(float current);
+    void addSample(int32_t currentMa);
 
     /**
-     * @brief Calculate the average of all samples in the buffer
-     * @return float Averaged current
+     * @brief Refold the raw -> mA scale after a calibration change
      */
-    float calculateAverage() const;
+    void updateScale();
 
     /**
-     * @brief Convert raw ADC value to current in Amps
-     * @param rawAdc Raw ADC reading
-     * @return float Current in Amps
+     * @brief Refold the thresholds and hysteresis to mA
      */
-    float adcToCurrent(uint16_t rawAdc);
+    void updateThresholds();
 
     /**
      * @brief Push a current event to the queue
@@ -341,4 +433,9 @@ private:
      * @brief Push a stats reading to the stats queue
      */
     void pushStatsReading();
+
+    /**
+     * @brief Recompute the fast trip raw thresholds after a calibration change
+     */
+    void updateFastTripThresholds();
 };
@@ -6,11 +6,13 @@
  * 
  * This library provides persistent event logging to internal flash using LittleFS.
  * Features:
- * - Circular buffer of 128 entries (oldest overwritten)
+ * - Circular buffer of 128 entries in RAM (oldest overwritten)
  * - Compact 8-byte binary format per entry
+ * - Append-only, segmented on-flash format with per-record CRCs
+ *   (MoaLogJournal): a flush writes only the new entries
  * - RAM buffering with periodic flush (default: 1 minute)
  * - Immediate flush on critical events (overcurrent, overtemperature)
- * - JSON export for webserver retrieval
+ * - Streaming JSON/CSV/binary export into any ILogSink, no heap use
  * - Relative timestamps (millis())
  * 
  * ## Log Entry Format (8 bytes)
@@ -25,7 +27,11 @@
 #pragma once
 
 #include <Arduino.h>
-#include <LittleFS.h>
+#include "ILogStorage.h"
+#include "MoaLogJournal.h"
+#include "MoaLogCodes.h"
+#include "ILogSink.h"
+#include "MoaLogExporter.h"
 
 /**
  * @brief Maximum number of log entries (circular buffer size)
@@ -48,104 +54,9 @@
 #define MOA_LOG_RAM_BUFFER_SIZE 8
 
 /**
- * @brief Default log filename
+ * @brief Single-file log written by earlier firmware (imported once, then removed)
  */
-#define MOA_LOG_DEFAULT_FILENAME "/moa_log.bin"
-
-/**
- * @brief Log event types (categories)
- */
-enum MoaLogType : uint8_t {
-    LOG_TYPE_SYSTEM     = 0x00,   ///< System events (boot, shutdown, config)
-    LOG_TYPE_BUTTON     = 0x10,   ///< Button events
-    LOG_TYPE_TEMP       = 0x20,   ///< Temperature events
-    LOG_TYPE_BATT       = 0x30,   ///< Battery events
-    LOG_TYPE_CURRENT    = 0x40,   ///< Current events
-    LOG_TYPE_STATE      = 0x50,   ///< State machine transitions
-    LOG_TYPE_ERROR      = 0xF0    ///< Errors and failures
-};
-
-/**
- * @brief System event codes (LOG_TYPE_SYSTEM)
- */
-enum MoaLogSystemCode : uint8_t {
-    LOG_SYS_BOOT            = 0x01,   ///< System boot
-    LOG_SYS_SHUTDOWN        = 0x02,   ///< Graceful shutdown
-    LOG_SYS_CONFIG_ENTER    = 0x03,   ///< Entered config mode
-    LOG_SYS_CONFIG_EXIT     = 0x04,   ///< Exited config mode
-    LOG_SYS_WATCHDOG_RESET  = 0x05    ///< Watchdog triggered reset
-};
-
-/**
- * @brief Button event codes (LOG_TYPE_BUTTON)
- */
-enum MoaLogButtonCode : uint8_t {
-    LOG_BTN_STOP_PRESS      = 0x01,
-    LOG_BTN_STOP_LONG       = 0x02,
-    LOG_BTN_25_PRESS        = 0x03,
-    LOG_BTN_50_PRESS        = 0x04,
-    LOG_BTN_75_PRESS        = 0x05,
-    LOG_BTN_100_PRESS       = 0x06
-};
-
-/**
- * @brief Temperature event codes (LOG_TYPE_TEMP)
- */
-enum MoaLogTempCode : uint8_t {
-    LOG_TEMP_CROSSED_ABOVE  = 0x01,   ///< Temperature crossed above threshold
-    LOG_TEMP_CROSSED_BELOW  = 0x02,   ///< Temperature crossed below threshold
-    LOG_TEMP_OVERHEAT       = 0x03    ///< Critical overheat (immediate flush)
-};
-
-/**
- * @brief Battery event codes (LOG_TYPE_BATT)
- */
-enum MoaLogBattCode : uint8_t {
-    LOG_BATT_HIGH           = 0x01,
-    LOG_BATT_MEDIUM         = 0x02,
-    LOG_BATT_LOW            = 0x03    ///< Critical low battery (immediate flush)
-};
-
-/**
- * @brief Current event codes (LOG_TYPE_CURRENT)
- */
-enum MoaLogCurrentCode : uint8_t {
-    LOG_CURRENT_NORMAL      = 0x01,
-    LOG_CURRENT_OVERCURRENT = 0x02,   ///< Critical overcurrent (immediate flush)
-    LOG_CURRENT_REVERSE     = 0x03    ///< Critical reverse overcurrent (immediate flush)
-};
-
-/**
- * @brief State machine event codes (LOG_TYPE_STATE)
- */
-enum MoaLogStateCode : uint8_t {
-    LOG_STATE_TO_INIT       = 0x01,
-    LOG_STATE_TO_IDLE       = 0x02,
-    LOG_STATE_TO_SURFING    = 0x03,
-    LOG_STATE_TO_OVERHEAT   = 0x04,
-    LOG_STATE_TO_OVERCURRENT= 0x05,
-    LOG_STATE_TO_BATT_LOW   = 0x06
-};
-
-/**
- * @brief Error event codes (LOG_TYPE_ERROR)
- */
-enum MoaLogErrorCode : uint8_t {
-    LOG_ERR_I2C_FAIL        = 0x01,   ///< I2C communication failure
-    LOG_ERR_SENSOR_FAIL     = 0x02,   ///< Sensor read failure
-    LOG_ERR_FLASH_FAIL      = 0x03,   ///< Flash write failure
-    LOG_ERR_QUEUE_FULL      = 0x04    ///< Event queue overflow
-};
-
-/**
- * @brief Log entry structure (8 bytes)
- */
-struct MoaLogEntry {
-    uint32_t timestamp;    ///< millis() at event time
-    uint8_t type;          ///< Event type (MoaLogType)
-    uint8_t code;          ///< Event code within type
-    int16_t value;         ///< Associated value
-} __attribute__((packed));
+#define MOA_LOG_LEGACY_FILENAME "/moa_log.bin"
 
 /**
  * @brief Flash-based event logger with circular buffer
@@ -155,11 +66,12 @@ struct MoaLogEntry {
  * - RAM buffering to reduce flash wear
  * - Periodic flush (default: 1 minute)
  * - Immediate flush on critical events
- * - JSON export for webserver
+ * - Streaming export (JSON, CSV, binary) for webserver, Serial or BLE
  * 
  * ## Usage Example
  * @code
- * MoaFlashLog logger;
+ * LittleFsLogStorage storage;
+ * MoaFlashLog logger(&storage);
  * logger.begin();
  * 
  * // Log events
@@ -170,8 +82,9 @@ struct MoaLogEntry {
  * // Periodic call (e.g., in main loop or task)
  * logger.update();  // Handles timed flush
  * 
- * // For webserver
- * String json = logger.toJson();
+ * // For webserver / Serial (chunked, no heap)
+ * PrintLogSink sink(client);
+ * logger.exportTo(sink, MoaLogExportFormat::JSON);
  * @endcode
  */
 class MoaFlashLog {
@@ -179,9 +92,10 @@ public:
     /**
      * @brief Construct a new MoaFlashLog object
      * 
-     * @param filename Log file path (default: "/moa_log.bin")
+     * @param storage Storage backend (not owned; LittleFsLogStorage on the device)
+     * @param basePath Segment path prefix (default: "/moa_log")
      */
-    MoaFlashLog(const char* filename = MOA_LOG_DEFAULT_FILENAME);
+    MoaFlashLog(ILogStorage* storage, const char* basePath = MOA_LOG_DEFAULT_BASENAME);
 
     /**
      * @brief Destructor - flushes pending entries
@@ -191,10 +105,12 @@ public:
     /**
      * @brief Initialize the logger
      * 
-     * Mounts LittleFS and loads existing log file or creates new one.
+     * Mounts the storage, recovers the segment ring (dropping any torn
+     * records) and loads the newest entries into RAM. A log left by the
+     * previous single-file format is imported once and removed.
      * 
      * @return true if initialization successful
-     * @return false if filesystem mount or file operation failed
+     * @return false if the filesystem could not be mounted
      */
     bool begin();
 
@@ -310,9 +226,10 @@ public:
     // === Export ===
 
     /**
-     * @brief Export log as JSON string
+     * @brief Stream the log into a sink, oldest entry first
      * 
-     * Format:
+     * Output goes out in MOA_LOG_EXPORT_CHUNK_SIZE chunks; nothing is
+     * allocated. JSON format:
      * @code
      * {
      *   "count": 42,
@@ -322,27 +239,34 @@ public:
      *   ]
      * }
      * @endcode
+     * JSON_VERBOSE uses type/code names; see MoaLogExporter for CSV and binary.
      * 
-     * @return String JSON representation of log
+     * @param sink Destination (Serial/TCP via PrintLogSink, BLE, ...)
+     * @param format Output format
+     * @return true if the sink accepted the whole export
      */
-    String toJson() const;
+    bool exportTo(ILogSink& sink, MoaLogExportFormat format) const;
 
     /**
-     * @brief Export log as human-readable JSON
-     * 
-     * Includes type/code names for easier reading.
-     * 
-     * @return String Human-readable JSON
+     * @brief Dump log to Serial (for debugging)
      */
-    String toJsonVerbose() const;
+    void dumpToSerial() const;
 
     /**
-     * @brief Dump log to Serial (for debugging)
+     * @brief Bytes written to flash since boot (wear diagnostics)
+     * @return uint32_t Header and record bytes
      */
-    void dumpToSerial() const;
+    uint32_t getFlashBytesWritten() const;
+
+    /**
+     * @brief Entries logged since boot, including ones since overwritten
+     * @return uint32_t Keeps counting after the ring is full, unlike getEntryCount()
+     */
+    uint32_t getLoggedCount() const;
 
 private:
-    const char* _filename;                         ///< Log file path
+    ILogStorage* _storage;                         ///< Storage backend
+    MoaLogJournal _journal;                        ///< Segmented on-flash log
     uint32_t _flushIntervalMs;                     ///< Flush interval
     uint32_t _lastFlushTime;                       ///< Last flush timestamp
     bool _initialized;                             ///< Initialization flag
@@ -351,23 +275,30 @@ private:
     size_t _entryCount;                            ///< Number of valid entries
     size_t _writeIndex;                            ///< Next write position
     size_t _oldestIndex;                           ///< Oldest entry position
+    size_t _unsavedCount;                          ///< Newest entries not yet on flash
     
     MoaLogEntry _ramBuffer[MOA_LOG_RAM_BUFFER_SIZE]; ///< Pending entries
     size_t _ramBufferCount;                        ///< Entries in RAM buffer
     bool _dirty;                                   ///< Unsaved changes flag
+    uint32_t _loggedCount;                         ///< log() calls since boot
 
     /**
-     * @brief Load log from flash file
-     * @return true if loaded successfully
+     * @brief Load the newest entries from the journal into RAM
+     * @return true if at least one entry was loaded
      */
     bool loadFromFlash();
 
     /**
-     * @brief Save log to flash file
-     * @return true if saved successfully
+     * @brief Append the unsaved entries to the journal
+     * @return true if all of them were committed
      */
     bool saveToFlash();
 
+    /**
+     * @brief Import and remove a log written in the previous single-file format
+     */
+    void importLegacyLog();
+
     /**
      * @brief Add entry to circular buffer
      * @param entry Entry to add
@@ -378,19 +309,4 @@ private:
      * @brief Flush RAM buffer to circular buffer
      */
     void flushRamBuffer();
-
-    /**
-     * @brief Get type name for verbose JSON
-     * @param type Event type
-     * @return const char* Type name string
-     */
-    const char* getTypeName(uint8_t type) const;
-
-    /**
-     * @brief Get code name for verbose JSON
-     * @param type Event type
-     * @param code Event code
-     * @return const char* Code name string
-     */
-    const char* getCodeName(uint8_t type, uint8_t code) const;
 };
@@ -4,9 +4,14 @@
  * @author Oscar Martinez
  * @date 2025-01-30
  * 
- * This library provides a thread-safe wrapper around the Adafruit_MCP23X18 class
- * for shared access between MoaButtonControl and MoaLedControl classes.
- * Uses a FreeRTOS mutex to protect I2C transactions.
+ * This library provides thread-safe access to the MCP23018 for
+ * MoaButtonControl and MoaLedControl. Uses a FreeRTOS mutex to protect
+ * I2C transactions.
+ * 
+ * Register access goes through MoaMcpRegisterFile, which shadows the
+ * register map: configuration changes are whole-register burst writes,
+ * writes that would not change anything are skipped, and a recovery
+ * reset restores the configuration in one burst.
  */
 
 #pragma once
@@ -14,7 +19,9 @@
 #include <Arduino.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
-#include "Adafruit_MCP23X18.h"
+#include <Wire.h>
+#include "WireI2cBus.h"
+#include "MoaMcpRegisterFile.h"
 #include "PinMapping.h"
 
 /**
@@ -30,8 +37,8 @@
 /**
  * @brief Thread-safe MCP23018 wrapper for shared I2C access
  * 
- * MoaMcpDevice wraps the Adafruit_MCP23X18 class and provides mutex-protected
- * access to the I2C port expander. This allows multiple classes (e.g., 
+ * MoaMcpDevice provides mutex-protected, register-shadowed access to the
+ * I2C port expander. This allows multiple classes (e.g., 
  * MoaButtonControl and MoaLedControl) to safely share the same MCP23018 device.
  * 
  * ## Usage Example
@@ -83,12 +90,12 @@ public:
     SemaphoreHandle_t getMutex();
 
     /**
-     * @brief Get direct access to the underlying MCP23018 object
+     * @brief Get direct access to the shadowed register file
      * 
      * @warning Caller must hold the mutex when using this!
-     * @return Adafruit_MCP23X18& Reference to the MCP23018 object
+     * @return MoaMcpRegisterFile& Register file (call commit() after set())
      */
-    Adafruit_MCP23X18& getMcp();
+    MoaMcpRegisterFile& getRegisters();
 
     /**
      * @brief Set the mutex timeout for I2C operations
@@ -116,7 +123,9 @@ public:
     /**
      * @brief Attempt to recover from I2C communication failure
      * 
-     * Performs hardware reset and re-initializes I2C communication.
+     * Performs hardware reset, checks the device answers and restores
+     * the shadowed configuration (directions, pull-ups, interrupts,
+     * output latches) in at most two burst writes.
      * Use this when I2C transactions are failing.
      * 
      * @param wire Pointer to TwoWire instance (default: &Wire)
@@ -143,6 +152,14 @@ public:
      */
     uint8_t readInterruptCapturePortA();
 
+    /**
+     * @brief Read INTCAPA and GPIOA in one burst, clearing the interrupt (thread-safe)
+     * 
+     * @param captured Optional: Port A state captured at interrupt time
+     * @return uint8_t Current Port A state, or 0 if mutex timeout / I2C error
+     */
+    uint8_t readInterruptStatePortA(uint8_t* captured = nullptr);
+
     /**
      * @brief Configure Port A pin modes (thread-safe)
      * 
@@ -165,9 +182,10 @@ public:
     /**
      * @brief Enable interrupt-on-change for Port A pins (thread-safe)
      * 
+     * Interrupts fire on any change (INTCON = 0).
+     * 
      * @param mask Bitmask of pins to enable interrupts
-     * @param defaultValue Default comparison value for interrupt
-     * @param mode Interrupt mode: CHANGE, FALLING, RISING
+     * @param defaultValue DEFVAL bits for the masked pins
      */
     void enableInterruptPortA(uint8_t mask, uint8_t defaultValue = 0x00);
 
@@ -189,7 +207,10 @@ public:
     uint8_t readPortB();
 
     /**
-     * @brief Write Port B GPIO state (thread-safe)
+     * @brief Write Port B output latch (thread-safe)
+     * 
+     * No I2C traffic if the latch already holds this value.
+     * 
      * @param value Value to write to Port B
      */
     void writePortB(uint8_t value);
@@ -239,13 +260,41 @@ public:
      */
     bool readPin(uint8_t pin);
 
+    // === Bus statistics ===
+
+    /**
+     * @brief I2C transactions issued since boot
+     * @return uint32_t Reads and writes, including failed ones
+     */
+    uint32_t getTransactionCount() const;
+
+    /**
+     * @brief Average I2C transaction rate since the previous call
+     * 
+     * The window is at least one second; calls closer together return
+     * the previous figure. Call from a single task (e.g. the CLI).
+     * 
+     * @return uint32_t Transactions per second
+     */
+    uint32_t getTransactionsPerSecond();
+
+    /**
+     * @brief Writes skipped because the device already held the values
+     * @return uint32_t Skipped commits
+     */
+    uint32_t getSkippedWrites() const;
+
 private:
-    Adafruit_MCP23X18 _mcp;            ///< Underlying MCP23018 instance
+    WireI2cBus _bus;                   ///< I2C backend
+    MoaMcpRegisterFile _regs;          ///< Shadowed register map
     SemaphoreHandle_t _mutex;          ///< Mutex for thread-safe access
     uint8_t _i2cAddr;                  ///< I2C address
     uint32_t _mutexTimeoutMs;          ///< Mutex timeout in milliseconds
     bool _initialized;                 ///< Initialization flag
     uint8_t _resetPin;                 ///< Hardware reset pin (PIN_I2C_RESET)
+    uint32_t _rateWindowStartMs;       ///< Start of the rate window
+    uint32_t _rateWindowCount;         ///< Transaction count at window start
+    uint32_t _transactionsPerSecond;   ///< Last computed rate
 
     /**
      * @brief Acquire the mutex with timeout
@@ -258,4 +307,17 @@ private:
      * @brief Release the mutex
      */
     void releaseMutex();
+
+    /**
+     * @brief Stage direction and pull-up bits for one port
+     * @param port 0 = A, 1 = B
+     * @param mask Pins to change
+     * @param mode Arduino pin mode
+     */
+    void stagePinMode(uint8_t port, uint8_t mask, uint8_t mode);
+
+    /**
+     * @brief Read one port's GPIO register
+     */
+    uint8_t readPort(uint8_t port);
 };
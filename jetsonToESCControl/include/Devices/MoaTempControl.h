@@ -17,7 +17,10 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "ControlCommand.h"
+#include "MoaEventChannel.h"
 #include "StatsReading.h"
+#include "MoaMovingAverage.h"
+#include "MoaFixedPoint.h"
 #include "ITemperatureSensor.h"
 
 /**
@@ -42,9 +45,11 @@ enum class MoaTempState {
  * @brief Temperature control class with hysteresis-based events and averaging
  * 
  * MoaTempControl provides temperature monitoring via an injected ITemperatureSensor with:
- * - Configurable moving average filtering
+ * - Configurable moving average filtering (O(1) per sample, no heap)
  * - Hysteresis-based threshold detection
  * - Event-driven integration via FreeRTOS queue
+ * - Integer averaging and thresholds in centi-degrees Celsius (the sensor
+ *   reading is converted once on entry)
  * 
  * When temperature crosses thresholds, it automatically pushes a ControlCommand
  * event to the configured queue.
@@ -55,8 +60,9 @@ enum class MoaTempState {
  * 
  * ## Usage Example
  * @code
- * QueueHandle_t eventQueue = xQueueCreate(10, sizeof(ControlCommand));
- * MoaTempControl tempSensor(eventQueue, TEMP_SENSOR_PIN);
+ * MoaEventChannel events;
+ * events.begin();
+ * MoaTempControl tempSensor(&events, TEMP_SENSOR_PIN);
  * 
  * tempSensor.setTargetTemp(50.0f);
  * tempSensor.setHysteresis(5.0f);  // Lower threshold = 45°C
@@ -67,8 +73,9 @@ enum class MoaTempState {
  * 
  * // In ControlTask, handle the event:
  * // if (cmd.controlType == CONTROL_TYPE_TEMPERATURE) {
- * //     float temp = cmd.value / 10.0f;  // Temperature in °C (x10 for precision)
- * //     stateMachine.temperatureCrossedLimit(cmd);
+ * //     TempEvent event(cmd);
+ * //     float temp = event.getDeciCelsius() / 10.0f;  // Temperature in °C (x10 for precision)
+ * //     stateMachine.temperatureCrossedLimit(event);
  * // }
  * @endcode
  */
@@ -77,18 +84,13 @@ public:
     /**
      * @brief Construct a new MoaTempControl object
      * 
-     * @param eventQueue FreeRTOS queue handle to push temperature events to
+     * @param eventQueue Event channel to push temperature events to
      * @param pin GPIO pin connected to the sensor (kept for logging/compatibility)
      * @param numSamples Number of samples for moving average (default: MOA_TEMP_DEFAULT_SAMPLES)
      */
-    MoaTempControl(QueueHandle_t eventQueue, uint8_t pin,
+    MoaTempControl(MoaEventChannel* eventQueue, uint8_t pin,
                    uint8_t numSamples = MOA_TEMP_DEFAULT_SAMPLES);
 
-    /**
-     * @brief Destructor - frees allocated sample buffer
-     */
-    ~MoaTempControl();
-
     /**
      * @brief Inject the concrete sensor backend to use
      * @param sensor Pointer to a sensor implementation (not owned; lifetime
@@ -155,6 +157,12 @@ public:
      */
     float getAveragedTemp() const;
 
+    /**
+     * @brief Get the current averaged temperature
+     * @return int32_t Averaged temperature in centi-degrees Celsius
+     */
+    int32_t getAveragedTempCentiC() const;
+
     /**
      * @brief Get the current temperature state
      * @return MoaTempState Current state (BELOW_TARGET or ABOVE_TARGET)
@@ -181,10 +189,10 @@ public:
     uint8_t getNumSamples() const;
 
     /**
-     * @brief Set the event queue handle (must be called after queue creation)
-     * @param eventQueue FreeRTOS queue handle for control events
+     * @brief Set the event channel (must be called after it is created)
+     * @param eventQueue Event channel for control events
      */
-    void setEventQueue(QueueHandle_t eventQueue);
+    void setEventQueue(MoaEventChannel* eventQueue);
 
     /**
      * @brief Set the stats queue for telemetry
@@ -193,33 +201,26 @@ public:
     void setStatsQueue(QueueHandle_t statsQueue);
 
 private:
-    QueueHandle_t _eventQueue;             ///< Queue to push events to
+    MoaEventChannel* _eventQueue;             ///< Channel to push events to
     QueueHandle_t _statsQueue;             ///< Queue to push stats readings to
     uint8_t _pin;                          ///< Sensor pin (kept for logging/compatibility)
     ITemperatureSensor* _sensor;           ///< Injected sensor backend (not owned)
     float _targetTemp;                     ///< Target temperature threshold
     float _currentTemp;                    ///< Current raw temperature reading
     float _hysteresis;                     ///< Hysteresis value for lower threshold
+    int32_t _targetCentiC;                 ///< Folded target threshold (centi-degC)
+    int32_t _hysteresisCentiC;             ///< Folded hysteresis (centi-degC)
     MoaTempState _state;                   ///< Current temperature state
 
-    float* _samples;                       ///< Circular buffer for temperature samples
-    uint8_t _numSamples;                   ///< Number of samples for averaging
-    uint8_t _sampleIndex;                  ///< Current index in circular buffer
-    uint8_t _sampleCount;                  ///< Number of valid samples in buffer
-    float _averagedTemp;                   ///< Cached averaged temperature
+    MoaMovingAverage<int32_t, MOA_TEMP_MAX_SAMPLES> _filter; ///< O(1) moving-window average (centi-degC)
+    int32_t _averagedCentiC;               ///< Cached averaged temperature (centi-degC)
     uint32_t _updateCount;                 ///< Counter for periodic logging
 
     /**
-     * @brief Add a new sample to the circular buffer and update average
-     * @param temp Temperature value to add
-     */
-    void addSample(float temp);
-
-    /**
-     * @brief Calculate the average of all samples in the buffer
-     * @return float Averaged temperature
+     * @brief Add a new sample to the moving-window filter and update average
+     * @param tempCentiC Temperature value to add (centi-degC)
      */
-    float calculateAverage() const;
+    void addSample(int32_t tempCentiC);
 
     /**
      * @brief Push a temperature event to the queue
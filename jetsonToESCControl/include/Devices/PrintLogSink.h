@@ -0,0 +1,37 @@
+/**
+ * @file PrintLogSink.h
+ * @brief ILogSink adapter for any Arduino Print (Serial, WiFiClient, ...)
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "ILogSink.h"
+
+/**
+ * @brief Forwards export chunks to an Arduino Print stream
+ *
+ * ## Usage Example
+ * @code
+ * PrintLogSink sink(Serial);
+ * flashLog.exportTo(sink, MoaLogExportFormat::CSV);
+ * @endcode
+ */
+class PrintLogSink : public ILogSink {
+public:
+    /**
+     * @param out Stream the chunks are written to (not owned)
+     */
+    explicit PrintLogSink(Print& out)
+        : _out(out) {
+    }
+
+    size_t write(const uint8_t* data, size_t length) override {
+        return _out.write(data, length);
+    }
+
+private:
+    Print& _out;
+};
@@ -0,0 +1,206 @@
+/**
+ * @file SimulatedAdcSource.h
+ * @brief IAdcSampleSource implementation that synthesises conversions
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Host-side stand-in for EspAdcDmaSource. Conversions are produced
+ * round-robin across the configured pins on demand (advance()), from a
+ * constant value or a waveform callback per pin, and buffered in a bounded
+ * FIFO that mimics the DMA store (overflow drops and counts samples).
+ * Like the DMA driver, conversions become readable a whole frame at a time
+ * (setFrameConversions(), default 1: each conversion at once).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "IAdcSampleSource.h"
+
+/**
+ * @brief Number of conversions the simulated store can hold
+ */
+#define SIM_ADC_STORE_SAMPLES 1024
+
+/**
+ * @brief Waveform callback
+ * @param pin Pin being converted
+ * @param sampleIndex Per-pin conversion index since begin()
+ * @param context User pointer passed to setWaveform()
+ * @return Raw ADC code
+ */
+typedef uint16_t (*SimAdcWaveform)(uint8_t pin, uint32_t sampleIndex, void* context);
+
+/**
+ * @brief Simulated continuous ADC for host tests
+ */
+class SimulatedAdcSource : public IAdcSampleSource {
+public:
+    SimulatedAdcSource()
+        : _numPins(0), _sampleRateHz(0), _running(false), _numCfg(0),
+          _head(0), _count(0), _readable(0), _frame(1), _unframed(0), _overflows(0), _scan(0),
+          _fractionalUs(0) {
+        for (uint8_t i = 0; i < MAX_PINS; i++) {
+            _pins[i] = 0;
+            _cfgPins[i] = 0;
+            _constant[i] = 0;
+            _waveform[i] = nullptr;
+            _context[i] = nullptr;
+            _index[i] = 0;
+        }
+    }
+
+    bool begin(const uint8_t* pins, uint8_t numPins, uint32_t sampleRateHz) override {
+        if (numPins == 0 || numPins > MAX_PINS) {
+            return false;
+        }
+        _numPins = numPins;
+        for (uint8_t i = 0; i < numPins; i++) {
+            _pins[i] = pins[i];
+            _index[i] = 0;
+        }
+        _sampleRateHz = sampleRateHz;
+        _head = 0;
+        _count = 0;
+        _readable = 0;
+        _unframed = 0;
+        _overflows = 0;
+        _scan = 0;
+        _fractionalUs = 0;
+        _running = true;
+        return true;
+    }
+
+    void stop() override {
+        _running = false;
+    }
+
+    size_t read(MoaAdcRawSample* out, size_t maxSamples) override {
+        size_t n = 0;
+        while (n < maxSamples && _readable > 0) {
+            out[n++] = _store[_head];
+            _head = (_head + 1) % SIM_ADC_STORE_SAMPLES;
+            _count--;
+            _readable--;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Hold a pin at a constant raw code
+     */
+    void setConstant(uint8_t pin, uint16_t raw) {
+        int8_t i = slotFor(pin, true);
+        if (i >= 0) {
+            _constant[i] = raw;
+            _waveform[i] = nullptr;
+        }
+    }
+
+    /**
+     * @brief Drive a pin from a waveform callback
+     */
+    void setWaveform(uint8_t pin, SimAdcWaveform waveform, void* context = nullptr) {
+        int8_t i = slotFor(pin, true);
+        if (i >= 0) {
+            _waveform[i] = waveform;
+            _context[i] = context;
+        }
+    }
+
+    /**
+     * @brief Conversions per DMA frame (ADC_DMA_FRAME_CONVERSIONS on target)
+     */
+    void setFrameConversions(size_t conversions) {
+        _frame = (conversions > 0) ? conversions : 1;
+    }
+
+    /**
+     * @brief Produce a number of conversions (round-robin across pins)
+     */
+    void produce(size_t conversions) {
+        if (!_running) {
+            return;
+        }
+        for (size_t k = 0; k < conversions; k++) {
+            uint8_t slot = _scan;
+            _scan = (_scan + 1) % _numPins;
+
+            MoaAdcRawSample s;
+            s.pin = _pins[slot];
+            int8_t cfg = slotFor(s.pin, false);
+            uint32_t idx = _index[slot]++;
+            if (cfg >= 0 && _waveform[cfg] != nullptr) {
+                s.raw = _waveform[cfg](s.pin, idx, _context[cfg]);
+            } else {
+                s.raw = (cfg >= 0) ? _constant[cfg] : 0;
+            }
+
+            if (_count >= SIM_ADC_STORE_SAMPLES) {
+                _overflows++;
+                continue;
+            }
+            _store[(_head + _count) % SIM_ADC_STORE_SAMPLES] = s;
+            _count++;
+            if (++_unframed >= _frame) {
+                _readable += _unframed;     // Frame complete: handed to the reader
+                _unframed = 0;
+            }
+        }
+    }
+
+    /**
+     * @brief Produce the conversions that the configured rate yields in elapsedUs
+     */
+    void advance(uint32_t elapsedUs) {
+        uint64_t total = static_cast<uint64_t>(elapsedUs) * _sampleRateHz + _fractionalUs;
+        _fractionalUs = total % 1000000ULL;
+        produce(static_cast<size_t>(total / 1000000ULL));
+    }
+
+    /**
+     * @brief Conversions lost because the simulated store was full
+     */
+    uint32_t getOverflowCount() const {
+        return _overflows;
+    }
+
+private:
+    static const uint8_t MAX_PINS = 8;
+
+    uint8_t _pins[MAX_PINS];             ///< Scan order passed to begin()
+    uint8_t _numPins;
+    uint32_t _sampleRateHz;
+    bool _running;
+
+    uint8_t _cfgPins[MAX_PINS];          ///< Pins with a configured signal
+    uint8_t _numCfg;
+    uint16_t _constant[MAX_PINS];
+    SimAdcWaveform _waveform[MAX_PINS];
+    void* _context[MAX_PINS];
+    uint32_t _index[MAX_PINS];           ///< Per-scan-slot conversion index
+
+    MoaAdcRawSample _store[SIM_ADC_STORE_SAMPLES];
+    size_t _head;
+    size_t _count;
+    size_t _readable;                    ///< Oldest conversions in completed frames
+    size_t _frame;                       ///< Conversions per frame
+    size_t _unframed;                    ///< Conversions of the frame in progress
+    uint32_t _overflows;
+    uint8_t _scan;                       ///< Next scan slot
+    uint64_t _fractionalUs;
+
+    int8_t slotFor(uint8_t pin, bool create) {
+        for (uint8_t i = 0; i < _numCfg; i++) {
+            if (_cfgPins[i] == pin) {
+                return static_cast<int8_t>(i);
+            }
+        }
+        if (!create || _numCfg >= MAX_PINS) {
+            return -1;
+        }
+        _cfgPins[_numCfg] = pin;
+        return static_cast<int8_t>(_numCfg++);
+    }
+};
@@ -0,0 +1,369 @@
+/**
+ * @file SimulatedDs18b20Bus.h
+ * @brief Host-side 1-Wire bus of DS18B20 probes that counts bus time
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Implements IOneWireBus, and the byte-level calls of the OneWire library
+ * (reset, select, skip, write, read) for the sim HAL, over up to
+ * MOA_SIM_ONEWIRE_MAX_PROBES DS18B20s. Models the ROM search, Convert T
+ * (the result appears in the scratchpad after the conversion time of the
+ * probe's resolution, the previous one is read before that), Read and
+ * Write Scratchpad, Read Power Supply, parasite power and unplugged
+ * probes. Alarm search, Copy Scratchpad and Recall EEPROM are not
+ * modelled.
+ *
+ * Bus time is counted at standard speed: 960 us per reset and 70 us per
+ * time slot, so tests can measure the bus time a driver spends per
+ * reading. Reading a scratchpad before its conversion is done, and any
+ * reset while a parasite-powered probe converts, are counted as faults.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include <string.h>
+#include "IOneWireBus.h"
+
+#define MOA_SIM_ONEWIRE_MAX_PROBES  8
+#define MOA_SIM_ONEWIRE_RESET_US    960
+#define MOA_SIM_ONEWIRE_SLOT_US     70
+
+/**
+ * @brief Simulated DS18B20 probes on one bus
+ */
+class SimulatedDs18b20Bus : public IOneWireBus {
+public:
+    SimulatedDs18b20Bus()
+        : _count(0), _nowMs(0), _selected(NONE), _state(State::IDLE), _dataIndex(0),
+          _searchIndex(0), _corruptNext(false) {
+        resetCounters();
+    }
+
+    /**
+     * @brief Plug in a probe (power-on scratchpad: 85 degC, 12 bits)
+     * @param serial Low 32 bits of the 48-bit serial number
+     * @param parasite true if the probe draws parasite power
+     * @return int Probe index, -1 if the bus is full
+     */
+    int addProbe(uint32_t serial, bool parasite = false) {
+        if (_count >= MOA_SIM_ONEWIRE_MAX_PROBES) {
+            return -1;
+        }
+        Probe& p = _probes[_count];
+        p.rom[0] = 0x28;
+        for (int i = 0; i < 6; i++) {
+            p.rom[1 + i] = static_cast<uint8_t>(i < 4 ? serial >> (8 * i) : 0);
+        }
+        p.rom[7] = crc8(p.rom, 7);
+        p.parasite = parasite;
+        p.connected = true;
+        p.celsius = 20.0f;
+        p.th = 0x4B;
+        p.tl = 0x46;
+        p.config = 0x7F;
+        p.raw = 0x0550;
+        p.previousRaw = 0x0550;
+        p.convertEndMs = 0;
+        p.converting = false;
+        p.conversions = 0;
+        return _count++;
+    }
+
+    /**
+     * @brief Temperature a probe converts next (degC)
+     */
+    void setTemperature(uint8_t probe, float celsius) {
+        if (probe < _count) {
+            _probes[probe].celsius = celsius;
+        }
+    }
+
+    /**
+     * @brief Unplug (false) or plug back (true) a probe
+     */
+    void setConnected(uint8_t probe, bool connected) {
+        if (probe < _count) {
+            _probes[probe].connected = connected;
+        }
+    }
+
+    /**
+     * @brief Flip one bit of the next scratchpad read (line noise)
+     */
+    void corruptNextRead() {
+        _corruptNext = true;
+    }
+
+    /**
+     * @brief Bus clock (ms), for conversion times
+     */
+    void setNowMs(uint32_t nowMs) {
+        _nowMs = nowMs;
+    }
+
+    uint8_t getProbeCount() const { return _count; }
+    const uint8_t* getRom(uint8_t probe) const { return (probe < _count) ? _probes[probe].rom : nullptr; }
+    uint8_t getResolution(uint8_t probe) const { return (probe < _count) ? 9 + ((_probes[probe].config >> 5) & 3) : 0; }
+    uint32_t getConversions(uint8_t probe) const { return (probe < _count) ? _probes[probe].conversions : 0; }
+
+    // === Counters ===
+    uint32_t getTransactions() const { return _transactions; }
+    uint32_t getSearches() const { return _searches; }
+    uint32_t getBusMicros() const { return _busUs; }
+    uint32_t getScratchpadReads() const { return _scratchReads; }
+    uint32_t getEarlyReads() const { return _earlyReads; }
+    uint32_t getParasiteFaults() const { return _parasiteFaults; }
+
+    void resetCounters() {
+        _transactions = 0;
+        _searches = 0;
+        _busUs = 0;
+        _scratchReads = 0;
+        _earlyReads = 0;
+        _parasiteFaults = 0;
+    }
+
+    // === Byte level (OneWire library calls) ===
+
+    /**
+     * @return true if a probe answered with a presence pulse
+     */
+    bool reset() {
+        _busUs += MOA_SIM_ONEWIRE_RESET_US;
+        for (uint8_t i = 0; i < _count; i++) {
+            Probe& p = _probes[i];
+            if (p.converting && p.parasite && _nowMs < p.convertEndMs) {
+                _parasiteFaults++;                  // Strong pullup dropped mid-conversion
+            }
+        }
+        _state = State::ROM;
+        _selected = NONE;
+        for (uint8_t i = 0; i < _count; i++) {
+            if (_probes[i].connected) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void select(const uint8_t rom[ONEWIRE_ROM_BYTES]) {
+        _busUs += 9 * 8 * MOA_SIM_ONEWIRE_SLOT_US;  // Match ROM + 8 bytes
+        _selected = NONE;
+        for (uint8_t i = 0; i < _count; i++) {
+            if (_probes[i].connected && memcmp(_probes[i].rom, rom, ONEWIRE_ROM_BYTES) == 0) {
+                _selected = i;
+            }
+        }
+        _state = (_state == State::ROM) ? State::FUNCTION : State::IDLE;
+    }
+
+    void skip() {
+        _busUs += 8 * MOA_SIM_ONEWIRE_SLOT_US;
+        _selected = ALL;
+        _state = (_state == State::ROM) ? State::FUNCTION : State::IDLE;
+    }
+
+    void write(uint8_t value, bool power = false) {
+        (void)power;
+        _busUs += 8 * MOA_SIM_ONEWIRE_SLOT_US;
+        if (_state == State::FUNCTION) {
+            command(value);
+        } else if (_state == State::WRITE_SCRATCH) {
+            for (uint8_t i = 0; i < _count; i++) {
+                if (isSelected(i)) {
+                    uint8_t* reg = (_dataIndex == 0) ? &_probes[i].th
+                                 : (_dataIndex == 1) ? &_probes[i].tl : &_probes[i].config;
+                    *reg = (_dataIndex == 2) ? static_cast<uint8_t>((value & 0x60) | 0x1F) : value;
+                }
+            }
+            if (++_dataIndex >= 3) {
+                _state = State::IDLE;
+            }
+        }
+    }
+
+    uint8_t read() {
+        _busUs += 8 * MOA_SIM_ONEWIRE_SLOT_US;
+        if (_state == State::READ_POWER) {
+            for (uint8_t i = 0; i < _count; i++) {
+                if (_probes[i].connected && _probes[i].parasite) {
+                    return 0x00;
+                }
+            }
+            return 0xFF;
+        }
+        if (_state != State::READ_SCRATCH || _dataIndex >= 9) {
+            return 0xFF;
+        }
+        // Several probes answering at once is a wired-AND
+        uint8_t value = 0xFF;
+        for (uint8_t i = 0; i < _count; i++) {
+            if (isSelected(i)) {
+                uint8_t scratch[9];
+                scratchpad(i, scratch);
+                value &= scratch[_dataIndex];
+            }
+        }
+        if (_corruptNext && _dataIndex == 0) {
+            value ^= 0x01;
+            _corruptNext = false;
+        }
+        _dataIndex++;
+        return value;
+    }
+
+    // === IOneWireBus ===
+
+    void resetSearch() override {
+        _searchIndex = 0;
+    }
+
+    bool search(uint8_t rom[ONEWIRE_ROM_BYTES]) override {
+        _searches++;
+        _busUs += MOA_SIM_ONEWIRE_RESET_US + (8 + 64 * 3) * MOA_SIM_ONEWIRE_SLOT_US;
+        while (_searchIndex < _count) {
+            const Probe& p = _probes[_searchIndex++];
+            if (p.connected) {
+                memcpy(rom, p.rom, ONEWIRE_ROM_BYTES);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool transaction(const uint8_t* rom, uint8_t command,
+                     const uint8_t* tx, size_t txLength,
+                     uint8_t* rx, size_t rxLength, bool strongPullup) override {
+        _transactions++;
+        if (!reset()) {
+            return false;
+        }
+        if (rom != nullptr) {
+            select(rom);
+        } else {
+            skip();
+        }
+        write(command, strongPullup);
+        for (size_t i = 0; i < txLength; i++) {
+            write(tx[i], strongPullup);
+        }
+        for (size_t i = 0; i < rxLength; i++) {
+            rx[i] = read();
+        }
+        return true;
+    }
+
+private:
+    static const uint8_t NONE = 0xFF;
+    static const uint8_t ALL = 0xFE;
+
+    enum class State : uint8_t { IDLE, ROM, FUNCTION, READ_SCRATCH, WRITE_SCRATCH, READ_POWER };
+
+    struct Probe {
+        uint8_t rom[ONEWIRE_ROM_BYTES];
+        bool parasite;
+        bool connected;
+        float celsius;
+        uint8_t th;
+        uint8_t tl;
+        uint8_t config;
+        int16_t raw;            ///< Result of the last conversion
+        int16_t previousRaw;    ///< Read until that conversion is done
+        uint32_t convertEndMs;
+        bool converting;
+        uint32_t conversions;
+    };
+
+    Probe _probes[MOA_SIM_ONEWIRE_MAX_PROBES];
+    uint8_t _count;
+    uint32_t _nowMs;
+    uint8_t _selected;
+    State _state;
+    uint8_t _dataIndex;
+    uint8_t _searchIndex;
+    bool _corruptNext;
+
+    uint32_t _transactions;
+    uint32_t _searches;
+    uint32_t _busUs;
+    uint32_t _scratchReads;
+    uint32_t _earlyReads;
+    uint32_t _parasiteFaults;
+
+    static uint8_t crc8(const uint8_t* data, size_t length) {
+        uint8_t crc = 0;
+        for (size_t i = 0; i < length; i++) {
+            crc ^= data[i];
+            for (int b = 0; b < 8; b++) {
+                crc = (crc & 0x01) ? static_cast<uint8_t>((crc >> 1) ^ 0x8C) : static_cast<uint8_t>(crc >> 1);
+            }
+        }
+        return crc;
+    }
+
+    bool isSelected(uint8_t i) const {
+        return _probes[i].connected && (_selected == ALL || _selected == i);
+    }
+
+    void command(uint8_t value) {
+        _dataIndex = 0;
+        _state = State::IDLE;
+        switch (value) {
+            case 0x44:                              // Convert T
+                for (uint8_t i = 0; i < _count; i++) {
+                    if (isSelected(i)) {
+                        startConversion(_probes[i]);
+                    }
+                }
+                break;
+            case 0xBE:                              // Read Scratchpad
+                _state = State::READ_SCRATCH;
+                _scratchReads++;
+                for (uint8_t i = 0; i < _count; i++) {
+                    if (isSelected(i) && _probes[i].converting && _nowMs < _probes[i].convertEndMs) {
+                        _earlyReads++;
+                    }
+                }
+                break;
+            case 0x4E:                              // Write Scratchpad
+                _state = State::WRITE_SCRATCH;
+                break;
+            case 0xB4:                              // Read Power Supply
+                _state = State::READ_POWER;
+                break;
+            default:
+                break;
+        }
+    }
+
+    void startConversion(Probe& p) {
+        uint8_t bits = static_cast<uint8_t>(9 + ((p.config >> 5) & 3));
+        p.previousRaw = currentRaw(p);
+        int32_t raw = static_cast<int32_t>(lroundf(p.celsius * 16.0f));
+        p.raw = static_cast<int16_t>(raw & ~((1 << (12 - bits)) - 1));
+        p.convertEndMs = _nowMs + ((750U >> (12 - bits)) + (bits == 9 ? 1 : 0));
+        p.converting = true;
+        p.conversions++;
+    }
+
+    int16_t currentRaw(const Probe& p) const {
+        return (p.converting && _nowMs < p.convertEndMs) ? p.previousRaw : p.raw;
+    }
+
+    void scratchpad(uint8_t i, uint8_t out[9]) const {
+        const Probe& p = _probes[i];
+        int16_t raw = currentRaw(p);
+        out[0] = static_cast<uint8_t>(raw & 0xFF);
+        out[1] = static_cast<uint8_t>((raw >> 8) & 0xFF);
+        out[2] = p.th;
+        out[3] = p.tl;
+        out[4] = p.config;
+        out[5] = 0xFF;
+        out[6] = 0x0C;
+        out[7] = 0x10;
+        out[8] = crc8(out, 8);
+    }
+};
@@ -0,0 +1,172 @@
+/**
+ * @file SimulatedLogStorage.h
+ * @brief File-backed ILogStorage with power-cut fault injection
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Host-side stand-in for LittleFsLogStorage. Log paths are mapped onto
+ * regular files below a root directory, so the log survives across
+ * MoaLogJournal instances like it survives a reboot on the device.
+ *
+ * setPowerCutAfter() arms a fault: once that many more bytes have been
+ * written, the write in progress is torn at that byte and every further
+ * write fails until powerCycle() - the pessimistic model of a brown-out
+ * in the middle of a flash program.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "ILogStorage.h"
+
+/**
+ * @brief Longest mapped host path
+ */
+#define SIM_LOG_PATH_MAX 256
+
+/**
+ * @brief File-backed log storage for host tests
+ */
+class SimulatedLogStorage : public ILogStorage {
+public:
+    /**
+     * @param rootDir Existing host directory the log files are placed in
+     */
+    explicit SimulatedLogStorage(const char* rootDir)
+        : _bytesWritten(0), _writeCalls(0), _cutArmed(false), _cutBudget(0), _powerLost(false) {
+        strncpy(_root, rootDir, sizeof(_root) - 1);
+        _root[sizeof(_root) - 1] = '\0';
+    }
+
+    bool begin() override {
+        return true;
+    }
+
+    int32_t size(const char* path) override {
+        FILE* f = fopen(map(path), "rb");
+        if (f == nullptr) {
+            return -1;
+        }
+        fseek(f, 0, SEEK_END);
+        int32_t bytes = static_cast<int32_t>(ftell(f));
+        fclose(f);
+        return bytes;
+    }
+
+    size_t read(const char* path, uint32_t offset, uint8_t* buffer, size_t length) override {
+        FILE* f = fopen(map(path), "rb");
+        if (f == nullptr) {
+            return 0;
+        }
+        size_t bytes = 0;
+        if (fseek(f, static_cast<long>(offset), SEEK_SET) == 0) {
+            bytes = fread(buffer, 1, length, f);
+        }
+        fclose(f);
+        return bytes;
+    }
+
+    size_t append(const char* path, const uint8_t* data, size_t length) override {
+        return write(path, "ab", data, length);
+    }
+
+    bool create(const char* path, const uint8_t* data, size_t length) override {
+        return write(path, "wb", data, length) == length;
+    }
+
+    bool remove(const char* path) override {
+        if (_powerLost) {
+            return false;
+        }
+        ::remove(map(path));
+        return size(path) < 0;
+    }
+
+    /**
+     * @brief Tear the write that crosses the next bytes and lose power
+     * @param bytes Bytes that still land before the cut
+     */
+    void setPowerCutAfter(uint32_t bytes) {
+        _cutArmed = true;
+        _cutBudget = bytes;
+    }
+
+    /**
+     * @brief Restore power (files keep whatever landed before the cut)
+     */
+    void powerCycle() {
+        _cutArmed = false;
+        _powerLost = false;
+    }
+
+    /**
+     * @brief True once an armed power cut has fired
+     */
+    bool isPowerLost() const {
+        return _powerLost;
+    }
+
+    /**
+     * @brief Total bytes written (appends and creates)
+     */
+    uint32_t getBytesWritten() const {
+        return _bytesWritten;
+    }
+
+    /**
+     * @brief Number of append/create calls
+     */
+    uint32_t getWriteCalls() const {
+        return _writeCalls;
+    }
+
+    /**
+     * @brief Reset the write counters
+     */
+    void resetCounters() {
+        _bytesWritten = 0;
+        _writeCalls = 0;
+    }
+
+private:
+    char _root[SIM_LOG_PATH_MAX];
+    char _mapped[SIM_LOG_PATH_MAX];
+    uint32_t _bytesWritten;
+    uint32_t _writeCalls;
+    bool _cutArmed;
+    uint32_t _cutBudget;
+    bool _powerLost;
+
+    const char* map(const char* path) {
+        snprintf(_mapped, sizeof(_mapped), "%s%s", _root, path);
+        return _mapped;
+    }
+
+    size_t write(const char* path, const char* mode, const uint8_t* data, size_t length) {
+        if (_powerLost) {
+            return 0;
+        }
+        FILE* f = fopen(map(path), mode);
+        if (f == nullptr) {
+            return 0;
+        }
+        _writeCalls++;
+
+        size_t landed = length;
+        if (_cutArmed && landed > _cutBudget) {
+            landed = _cutBudget;
+            _powerLost = true;
+        }
+        if (_cutArmed) {
+            _cutBudget -= static_cast<uint32_t>(landed);
+        }
+
+        size_t bytes = fwrite(data, 1, landed, f);
+        fclose(f);
+        _bytesWritten += static_cast<uint32_t>(bytes);
+        return bytes;
+    }
+};
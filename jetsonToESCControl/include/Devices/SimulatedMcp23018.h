@@ -0,0 +1,217 @@
+/**
+ * @file SimulatedMcp23018.h
+ * @brief Host-side MCP23018 model that counts I2C traffic
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Implements II2cBus with one MCP23018 at a fixed address. Models the
+ * register map in IOCON.BANK = 0 sequential mode (pointer auto-increments
+ * and wraps), read-only INTF/INTCAP, GPIO writes landing in OLAT,
+ * interrupt-on-change capture and clear-on-read. Input polarity (IPOL)
+ * and DEFVAL compare mode are not modelled.
+ *
+ * Every call is counted as one bus transaction, so tests can measure the
+ * traffic a driver generates.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "II2cBus.h"
+#include "MoaMcpRegisterFile.h"
+
+/**
+ * @brief Simulated MCP23018 on a simulated I2C bus
+ */
+class SimulatedMcp23018 : public II2cBus {
+public:
+    /**
+     * @param address 7-bit address the device answers to
+     */
+    explicit SimulatedMcp23018(uint8_t address)
+        : _address(address), _failNext(0) {
+        memset(_inputs, 0xFF, sizeof(_inputs));
+        powerOnReset();
+        resetCounters();
+    }
+
+    bool writeRegisters(uint8_t address, uint8_t reg, const uint8_t* data, size_t length) override {
+        if (!beginTransaction(address, reg)) {
+            return false;
+        }
+        _busBytes += 2 + length;                   // address + pointer + data
+        _writes++;
+        uint8_t ptr = reg;
+        for (size_t i = 0; i < length; i++) {
+            writeOne(ptr, data[i]);
+            ptr = static_cast<uint8_t>((ptr + 1) % MCP23018_REG_COUNT);
+        }
+        return true;
+    }
+
+    bool readRegisters(uint8_t address, uint8_t reg, uint8_t* data, size_t length) override {
+        if (!beginTransaction(address, reg)) {
+            return false;
+        }
+        _busBytes += 3 + length;                   // address + pointer + address + data
+        _reads++;
+        uint8_t ptr = reg;
+        for (size_t i = 0; i < length; i++) {
+            data[i] = readOne(ptr);
+            ptr = static_cast<uint8_t>((ptr + 1) % MCP23018_REG_COUNT);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Hardware reset: registers back to power-on values
+     */
+    void powerOnReset() {
+        for (uint8_t reg = 0; reg < MCP23018_REG_COUNT; reg++) {
+            _regs[reg] = MoaMcpRegisterFile::powerOnValue(reg);
+        }
+    }
+
+    /**
+     * @brief Drive the external level of a port's input pins
+     * @param port 0 = A, 1 = B
+     * @param levels Pin levels (1 = high)
+     */
+    void setInputs(uint8_t port, uint8_t levels) {
+        uint8_t before = pinLevels(port);
+        _inputs[port] = levels;
+        uint8_t changed = static_cast<uint8_t>(before ^ pinLevels(port));
+
+        uint8_t armed = _regs[MCP23018_REG_GPINTENA + port] & ~_regs[MCP23018_REG_INTCONA + port];
+        if ((changed & armed) != 0 && _regs[MCP23018_REG_INTFA + port] == 0) {
+            _regs[MCP23018_REG_INTFA + port] = changed & armed;
+            _regs[MCP23018_REG_INTCAPA + port] = pinLevels(port);
+        }
+    }
+
+    /**
+     * @brief True while the port's interrupt output is asserted
+     */
+    bool isInterruptAsserted(uint8_t port) const {
+        return _regs[MCP23018_REG_INTFA + port] != 0;
+    }
+
+    /**
+     * @brief Register value as stored in the device
+     */
+    uint8_t peek(uint8_t reg) const {
+        return _regs[reg];
+    }
+
+    /**
+     * @brief Refuse (NACK) the next transactions
+     * @param count Number of transactions to fail
+     */
+    void failNext(uint32_t count) {
+        _failNext = count;
+    }
+
+    /**
+     * @brief Transactions seen (reads + writes, including NACKed ones)
+     */
+    uint32_t getTransactions() const {
+        return _transactions;
+    }
+
+    uint32_t getReads() const {
+        return _reads;
+    }
+
+    uint32_t getWrites() const {
+        return _writes;
+    }
+
+    /**
+     * @brief Bytes on the wire (address, pointer and data bytes)
+     */
+    uint32_t getBusBytes() const {
+        return _busBytes;
+    }
+
+    /**
+     * @brief Times a register was written
+     */
+    uint32_t getRegisterWrites(uint8_t reg) const {
+        return _regWrites[reg];
+    }
+
+    void resetCounters() {
+        _transactions = 0;
+        _reads = 0;
+        _writes = 0;
+        _busBytes = 0;
+        memset(_regWrites, 0, sizeof(_regWrites));
+    }
+
+private:
+    uint8_t _address;
+    uint8_t _regs[MCP23018_REG_COUNT];
+    uint8_t _inputs[2];
+    uint32_t _failNext;
+    uint32_t _transactions;
+    uint32_t _reads;
+    uint32_t _writes;
+    uint32_t _busBytes;
+    uint32_t _regWrites[MCP23018_REG_COUNT];
+
+    bool beginTransaction(uint8_t address, uint8_t reg) {
+        _transactions++;
+        if (_failNext > 0) {
+            _failNext--;
+            return false;
+        }
+        return address == _address && reg < MCP23018_REG_COUNT;
+    }
+
+    uint8_t pinLevels(uint8_t port) const {
+        uint8_t dir = _regs[MCP23018_REG_IODIRA + port];
+        return static_cast<uint8_t>((_inputs[port] & dir) | (_regs[MCP23018_REG_OLATA + port] & ~dir));
+    }
+
+    void writeOne(uint8_t reg, uint8_t value) {
+        _regWrites[reg]++;
+        switch (reg) {
+            case MCP23018_REG_INTFA:
+            case MCP23018_REG_INTFB:
+            case MCP23018_REG_INTCAPA:
+            case MCP23018_REG_INTCAPB:
+                break;                                             // Read-only
+            case MCP23018_REG_GPIOA:
+            case MCP23018_REG_GPIOB:
+                _regs[reg + (MCP23018_REG_OLATA - MCP23018_REG_GPIOA)] = value;
+                break;
+            case MCP23018_REG_IOCON:
+            case MCP23018_REG_IOCON2:
+                _regs[MCP23018_REG_IOCON] = value;
+                _regs[MCP23018_REG_IOCON2] = value;
+                break;
+            default:
+                _regs[reg] = value;
+                break;
+        }
+    }
+
+    uint8_t readOne(uint8_t reg) {
+        switch (reg) {
+            case MCP23018_REG_GPIOA:
+            case MCP23018_REG_GPIOB: {
+                uint8_t port = reg - MCP23018_REG_GPIOA;
+                _regs[MCP23018_REG_INTFA + port] = 0;              // Reading clears the interrupt
+                return pinLevels(port);
+            }
+            case MCP23018_REG_INTCAPA:
+            case MCP23018_REG_INTCAPB:
+                _regs[MCP23018_REG_INTFA + (reg - MCP23018_REG_INTCAPA)] = 0;
+                return _regs[reg];
+            default:
+                return _regs[reg];
+        }
+    }
+};
@@ -0,0 +1,39 @@
+/**
+ * @file WireI2cBus.h
+ * @brief II2cBus backend on the Arduino Wire library
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "II2cBus.h"
+
+/**
+ * @brief Register bursts over a TwoWire instance
+ *
+ * Writes are address + register pointer + data in one transmission; reads
+ * set the pointer and use a repeated start, so each call is a single bus
+ * transaction.
+ */
+class WireI2cBus : public II2cBus {
+public:
+    /**
+     * @param wire TwoWire instance (default: &Wire)
+     */
+    explicit WireI2cBus(TwoWire* wire = &Wire);
+
+    /**
+     * @brief Switch to another TwoWire instance
+     * @param wire TwoWire instance
+     */
+    void setWire(TwoWire* wire);
+
+    bool writeRegisters(uint8_t address, uint8_t reg, const uint8_t* data, size_t length) override;
+    bool readRegisters(uint8_t address, uint8_t reg, uint8_t* data, size_t length) override;
+
+private:
+    TwoWire* _wire;    ///< Underlying I2C peripheral
+};
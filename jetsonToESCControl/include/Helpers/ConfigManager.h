@@ -15,12 +15,17 @@
 #include <Arduino.h>
 #include <Preferences.h>
 #include "Constants.h"
+#include "MoaEscRamp.h"
+#include "IOneWireBus.h"
 
 // Forward declarations
 class MoaBattControl;
 class MoaCurrentControl;
 class MoaTempControl;
+class MoaDs18b20Bus;
 class ESCController;
+class MoaTelemetryStream;
+class MoaStatsAggregator;
 
 /**
  * @brief NVS namespace for all Moa configuration
@@ -62,10 +67,14 @@ public:
      * @param batt Battery control
      * @param current Current control
      * @param temp Temperature control
+     * @param probes DS18B20 probe bus (conversion mode, resolutions)
      * @param esc ESC controller
+     * @param telemetry Telemetry stream (batch period)
+     * @param stats Stats aggregator (pack model of the energy meter)
      */
     void applyTo(MoaBattControl& batt, MoaCurrentControl& current,
-                 MoaTempControl& temp, ESCController& esc);
+                 MoaTempControl& temp, MoaDs18b20Bus& probes, ESCController& esc,
+                 MoaTelemetryStream& telemetry, MoaStatsAggregator& stats);
 
     /**
      * @brief Save all current settings to NVS
@@ -78,6 +87,18 @@ public:
      */
     void resetToDefaults();
 
+    /**
+     * @brief Persist the lifetime energy totals (only these two keys)
+     *
+     * Kept apart from save(): called by StatsTask when the energy meter
+     * says a write is due, and untouched by resetToDefaults().
+     *
+     * @param mah Lifetime charge (mAh)
+     * @param mwh Lifetime energy (mWh)
+     * @return true if both writes succeeded
+     */
+    bool saveEnergy(int32_t mah, int32_t mwh);
+
     // === Surfing Timers (ms) ===
     uint32_t escTime25;
     uint32_t escTime50;
@@ -93,17 +114,33 @@ public:
     uint16_t escAfterFullThrottle;
     float escRampRate;
 
+    // === Ramp Shapes (per throttle button) ===
+    MoaRampShape escShape25;
+    MoaRampShape escShape50;
+    MoaRampShape escShape75;
+    MoaRampShape escShape100;
+    MoaRampShape escShapeAfterFullThrottle;
+    float escRampCurvature;     ///< EXPO exponent, tabulated by applyTo()
+
     // === Battery Thresholds (V) ===
     float battHigh;
     float battMedium;
     float battLow;
     float battStop;
     float battHysteresis;
+    uint32_t battCapacityMah;   ///< Usable pack capacity (state of charge 100%)
+    float battFull;             ///< Resting voltage taken as full (V)
+    uint8_t battCompensation;   ///< 1 = levels on the open-circuit voltage, 0 = terminal voltage
+    uint16_t battResistanceMohm; ///< Internal resistance before any throttle step (mOhm)
+    uint16_t battMaxSagMv;      ///< Most the compensation may add to the terminal voltage (mV)
 
     // === Temperature Thresholds (°C) ===
     float tempTarget;
     float tempHysteresis;
     TempSensorType tempSensorType;  ///< Which sensor driver is physically installed
+    uint8_t tempProbeMode;          ///< DS18B20 conversions: 0 = broadcast, 1 = staggered
+    uint8_t tempProbeBits[TEMP_PROBE_MAX_COUNT]; ///< DS18B20 resolution per probe (9..12 bits)
+    uint8_t tempProbeRoms[TEMP_PROBE_MAX_COUNT][ONEWIRE_ROM_BYTES]; ///< DS18B20 ROM per role, all zeros = unassigned (bound at boot, kept by reset)
 
     // === Current Thresholds (A) ===
     float currentOvercurrent;
@@ -115,6 +152,16 @@ public:
     char wifiPassword[65];      ///< WiFi password (max 64 chars + null)
     char otaHostname[33];       ///< mDNS hostname for OTA discovery
 
+    // === Telemetry Stream ===
+    uint16_t telemetryPeriodMs;     ///< Batch period (ms), 0 = off
+    uint8_t telemetrySink;          ///< 0 = Jetson link, 1 = UDP
+    char telemetryHost[40];         ///< UDP destination host or IP (empty = off)
+    uint16_t telemetryPort;         ///< UDP destination port
+
+    // === Lifetime Energy (loaded at begin(), written by saveEnergy()) ===
+    int32_t energyLifetimeMah;
+    int32_t energyLifetimeMwh;
+
     // === Throttle helpers (use config values instead of Constants.h) ===
 
     /**
@@ -131,9 +178,21 @@ public:
      */
     uint32_t throttleTimeout(uint8_t commandType) const;
 
+    /**
+     * @brief Map button command type to its ramp shape
+     * @param commandType COMMAND_BUTTON_25..COMMAND_BUTTON_100
+     * @return Ramp shape, or LINEAR if unknown
+     */
+    MoaRampShape throttleShape(uint8_t commandType) const;
+
 private:
     /**
      * @brief Set all members to Constants.h defaults
      */
     void loadDefaults();
+
+    /**
+     * @brief Read a ramp shape key, falling back to the default if out of range
+     */
+    static MoaRampShape loadShape(Preferences& prefs, const char* key);
 };
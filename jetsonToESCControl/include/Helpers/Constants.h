@@ -25,6 +25,30 @@
  */
 #define ADC_REFERENCE_VOLTAGE   3.3f
 
+/**
+ * @brief Run current and battery sensing from the continuous (DMA) ADC
+ * Set to 0 to fall back to one analogRead() per SensorTask tick
+ */
+#define ADC_CONTINUOUS_ENABLED  1
+
+/**
+ * @brief Continuous ADC conversion rate across all scanned pins (Hz)
+ */
+#define ADC_CONTINUOUS_SAMPLE_RATE_HZ   10000
+
+/**
+ * @brief Conversions per DMA frame: results reach the CPU a frame at a time
+ * 32 conversions = 3.2 ms at 10 kHz, shorter than TASK_PROTECTION_PERIOD_MS,
+ * so every ProtectionTask poll sees at least one fresh frame
+ */
+#define ADC_DMA_FRAME_CONVERSIONS       32
+
+/**
+ * @brief Raw conversions averaged into one decimated sample
+ * 10 kHz over 2 pins / 16 = ~312 Hz per sensor, ~16 samples per 50ms tick
+ */
+#define ADC_OVERSAMPLING_FACTOR 16
+
 // =============================================================================
 // Battery Monitoring Constants
 // =============================================================================
@@ -102,6 +126,30 @@
  */
 #define CURRENT_AVERAGING_SAMPLES   10
 
+/**
+ * @brief Fast trip threshold (A) - per-sample peak that cuts the ESC directly
+ * Set above CURRENT_THRESHOLD_OVERCURRENT: the averaged path still handles
+ * sustained moderate overloads, the fast path handles hard faults.
+ */
+#define CURRENT_FAST_TRIP_THRESHOLD     170.0f
+
+/**
+ * @brief Reverse fast trip threshold (A), 0 = disabled
+ */
+#define CURRENT_FAST_TRIP_REVERSE       0.0f
+
+/**
+ * @brief Fast trip blanking window (raw samples) after arming or motor start
+ * 50 samples = 10 ms at 5 kHz per pin (ADC_CONTINUOUS_SAMPLE_RATE_HZ / 2 pins)
+ */
+#define CURRENT_FAST_TRIP_BLANKING_SAMPLES  50
+
+/**
+ * @brief Consecutive raw samples above the fast trip threshold needed to trip
+ * 4 samples = 0.8 ms at 5 kHz per pin
+ */
+#define CURRENT_FAST_TRIP_COUNT     4
+
 // =============================================================================
 // Temperature Sensor Constants (DS18B20)
 // =============================================================================
@@ -127,6 +175,45 @@
  */
 #define TEMP_SENSOR_TYPE_DEFAULT  0
 
+// =============================================================================
+// DS18B20 Probe Bus (used when TempSensorType::DS18B20 is selected)
+// =============================================================================
+
+/**
+ * @brief Probes managed on the OneWire bus, in ROM search order
+ * @note Probe 0 feeds MoaTempControl (overheat protection), the others
+ *       only the stats aggregator
+ */
+#define TEMP_PROBE_MAX_COUNT        3
+#define TEMP_PROBE_ESC              0
+#define TEMP_PROBE_MOTOR            1
+#define TEMP_PROBE_BATTERY          2
+
+/**
+ * @brief Default resolution per probe (bits, 9..12)
+ *
+ * Conversion time doubles with each bit: 9 = 94 ms (0.5 degC),
+ * 10 = 188 ms (0.25 degC), 11 = 375 ms, 12 = 750 ms (0.0625 degC).
+ */
+#define TEMP_PROBE_RES_ESC          10
+#define TEMP_PROBE_RES_MOTOR        10
+#define TEMP_PROBE_RES_BATTERY      9
+
+/**
+ * @brief Default conversion mode (0 = broadcast, 1 = staggered)
+ *
+ * Broadcast starts every probe with one Skip ROM command and reads each
+ * when its own conversion is done; staggered starts each probe on its own
+ * so every probe runs at the rate of its resolution.
+ */
+#define TEMP_PROBE_MODE_DEFAULT     1
+
+/**
+ * @brief Reading reported for a probe that did not answer (degC)
+ * @note Outside the range MoaTempControl accepts
+ */
+#define TEMP_PROBE_DISCONNECTED_C   -127
+
 // =============================================================================
 // NTC Thermistor Constants (used when TempSensorType::NTC is selected)
 // =============================================================================
@@ -156,6 +243,19 @@
  */
 #define NTC_ADC_VREF_MV            4450
 
+/**
+ * @brief ADC reads summed per NTC reading (power of two, at most 16)
+ */
+#define NTC_OVERSAMPLING           16
+
+/**
+ * @brief Spacing of the NTC lookup table (mV, power of two)
+ *
+ * 16 mV keeps linear interpolation within 0.25 degC of the Beta equation
+ * over -40..150 degC, in 280 entries (560 bytes of flash).
+ */
+#define NTC_LUT_STEP_MV            16
+
 // =============================================================================
 // Button Configuration
 // =============================================================================
@@ -203,6 +303,133 @@
  */
 #define LOG_MAX_ENTRIES         128
 
+// =============================================================================
+// Stats History
+// =============================================================================
+
+/**
+ * @brief History ring lengths per resolution (buckets, per channel)
+ *
+ * Raw: last 64 readings. 1 s: last minute. 10 s: last 10 minutes.
+ * 1 min: last hour. 16 bytes per bucket, 3 channels: ~12 KB total.
+ */
+#define STATS_HISTORY_RAW_LENGTH    64
+#define STATS_HISTORY_1S_LENGTH     60
+#define STATS_HISTORY_10S_LENGTH    60
+#define STATS_HISTORY_1MIN_LENGTH   60
+#define STATS_HISTORY_TOTAL_LENGTH  (STATS_HISTORY_RAW_LENGTH + STATS_HISTORY_1S_LENGTH + \
+                                     STATS_HISTORY_10S_LENGTH + STATS_HISTORY_1MIN_LENGTH)
+
+/**
+ * @brief Longest current-reading interval integrated into energy (ms)
+ */
+#define STATS_ENERGY_MAX_GAP_MS     1000
+
+// =============================================================================
+// Energy Meter
+// =============================================================================
+
+/**
+ * @brief Usable pack capacity (mAh), the 100% of the state of charge
+ */
+#define BATT_CAPACITY_MAH           10000
+
+/**
+ * @brief Resting pack voltage taken as full (V), 6S at 4.2 V per cell
+ *
+ * The state of charge starts from the first battery reading, placed
+ * linearly between the stop threshold (0%) and this voltage (100%).
+ */
+#define BATT_FULL_VOLTAGE           25.2f
+
+/**
+ * @brief Time constant of the rolling battery power average (ms)
+ */
+#define ENERGY_POWER_WINDOW_MS      30000
+
+/**
+ * @brief Below this average power (mW) no ride time is estimated
+ */
+#define ENERGY_MIN_POWER_MW         5000
+
+/**
+ * @brief Lifetime totals are written to NVS at most this often (ms)...
+ */
+#define ENERGY_SAVE_INTERVAL_MS     300000
+
+/**
+ * @brief ...and only once they have moved by this much (mAh)
+ */
+#define ENERGY_SAVE_MIN_MAH         50
+
+// =============================================================================
+// Battery Load Compensation
+// =============================================================================
+
+/**
+ * @brief Pack internal resistance before any throttle step is seen (mOhm)
+ *
+ * Cells, wiring, connectors and shunt. The estimate is learned from then
+ * on; this only sets where it starts.
+ */
+#define BATT_RESISTANCE_MOHM        40
+
+/**
+ * @brief Plausible range of the learned resistance (mOhm)
+ *
+ * A step whose own slope falls outside is dropped as an outlier.
+ */
+#define BATT_RESISTANCE_MIN_MOHM    5
+#define BATT_RESISTANCE_MAX_MOHM    300
+
+/**
+ * @brief Smallest current change regressed as a throttle step (mA)
+ */
+#define BATT_STEP_MIN_MA            10000
+
+/**
+ * @brief Largest change between two sensor ticks still counted as steady (mA)
+ */
+#define BATT_STEP_STEADY_MA         2000
+
+/**
+ * @brief Current must stay steady this long before a point is taken (ms)
+ */
+#define BATT_STEP_SETTLE_MS         300
+
+/**
+ * @brief Longest time between the two ends of a step (ms)
+ *
+ * Bounds how far the open-circuit voltage can drift under the step.
+ */
+#define BATT_STEP_MAX_SPAN_MS       5000
+
+/**
+ * @brief Steps the regression remembers (exponential forgetting)
+ */
+#define BATT_STEP_MEMORY            8
+
+/**
+ * @brief Learned steps needed before the levels are compensated at all
+ *
+ * Until then the configured resistance is only a guess, and the levels
+ * stay on the terminal voltage.
+ */
+#define BATT_COMP_MIN_STEPS         3
+
+/**
+ * @brief Most the compensation may add to the terminal voltage (mV)
+ *
+ * 120 A through 30 mOhm sags 3.6 V. A spike times an overestimated
+ * resistance must not lift an empty pack over the STOP threshold.
+ */
+#define BATT_COMP_MAX_SAG_MV        4000
+
+/**
+ * @brief Classify battery levels on the inferred open-circuit voltage (1) or the terminal voltage (0)
+ */
+#define BATT_COMPENSATION_DEFAULT   1
+
 // =============================================================================
 // Task Timing
 // =============================================================================
@@ -217,6 +444,101 @@
  */
 #define TASK_IO_PERIOD_MS       20
 
+/**
+ * @brief ProtectionTask period (ms) - continuous ADC drain + fast overcurrent trip
+ */
+#define TASK_PROTECTION_PERIOD_MS   5
+
+/**
+ * @brief CliTask polling period (ms) - human typing speed is the bottleneck
+ */
+#define TASK_CLI_PERIOD_MS      50
+
+/**
+ * @brief OtaTask polling period (ms) - responsive enough for OTA discovery and transfer
+ */
+#define TASK_OTA_PERIOD_MS      50
+
+/**
+ * @brief Timestamp each hop of the control path (button edge / sensor sample -> PWM write)
+ *
+ * 1 = per-hop latency histograms behind the CLI 'latency' command (MoaLatencyTrace.h),
+ * 0 = compiled out.
+ */
+#ifndef MOA_LATENCY_TRACE
+#define MOA_LATENCY_TRACE       1
+#endif
+
+// =============================================================================
+// State Machine
+// =============================================================================
+
+/**
+ * @brief State machine engine used by MoaStateMachineWrapper
+ *
+ * 0 = MoaStateMachine with one MoaState subclass per state (heap, virtual calls),
+ * 1 = MoaStateTable constexpr transition table (no heap, direct lookup).
+ * Both behave identically (host test test_state_table).
+ */
+#ifndef MOA_STATE_MACHINE_TABLE
+#define MOA_STATE_MACHINE_TABLE 0
+#endif
+
+// =============================================================================
+// Jetson Link
+// =============================================================================
+
+/**
+ * @brief UART port of the Jetson link (UART0 stays the console and CLI)
+ */
+#define MOA_LINK_UART_NUM       1
+
+/**
+ * @brief Jetson link baud rate (8N1): a 10-byte throttle frame takes ~110 µs
+ */
+#define MOA_LINK_BAUD           921600
+
+/**
+ * @brief UART driver ring buffers (bytes)
+ */
+#define MOA_LINK_RX_BUFFER      512
+#define MOA_LINK_TX_BUFFER      256
+
+/**
+ * @brief UART driver event queue depth
+ */
+#define MOA_LINK_EVENT_DEPTH    16
+
+/**
+ * @brief RX idle time that ends a burst and raises UART_DATA (symbol times, ~12 µs each)
+ */
+#define MOA_LINK_RX_TIMEOUT     2
+
+/**
+ * @brief Link watchdog: throttle is dropped if no setpoint arrives for this long (ms)
+ */
+#define MOA_LINK_WATCHDOG_MS    500
+
+// =============================================================================
+// Telemetry Stream
+// =============================================================================
+
+/**
+ * @brief Telemetry batch period (ms): 5 batches/s of ~12 readings; 0 = off
+ */
+#define TELEMETRY_PERIOD_MS     200
+
+/**
+ * @brief Telemetry sink: 0 = Jetson link (UART), 1 = UDP (needs WiFi, Config mode)
+ */
+#define TELEMETRY_SINK_DEFAULT  0
+
+/**
+ * @brief UDP destination (empty host = UDP sink disabled)
+ */
+#define TELEMETRY_UDP_HOST      ""
+#define TELEMETRY_UDP_PORT      5005
+
 // =============================================================================
 // ESC Configuration
 // =============================================================================
@@ -241,11 +563,50 @@
  */
 #define ESC_MAX_THROTTLE        1023
 
+/**
+ * @brief ESC PWM resolution (bits) - the ESP32-C3 LEDC maximum at 50 Hz
+ *
+ * 1.22 µs per count, 819 counts between ESC_PULSE_MIN_US and ESC_PULSE_MAX_US.
+ */
+#define ESC_PWM_RESOLUTION      14
+
+/**
+ * @brief Resolution (bits) of the throttle duties in the config and ESCController API
+ *
+ * Throttle levels stay in 10-bit counts (servo range ~51-102, NVS compatible);
+ * ESCController scales them to ESC_PWM_RESOLUTION and ramps in full resolution.
+ */
+#define ESC_THROTTLE_BITS       10
+
+/**
+ * @brief ESC ramp step period (µs) - one PWM frame, the rate LEDC latches a new duty
+ */
+#define ESC_RAMP_TICK_US        (1000000UL / ESC_PWM_FREQUENCY)
+
 /**
  * @brief ESC ramp rate (% per second)
  */
 #define ESC_RAMP_RATE           200.0f
 
+/**
+ * @brief Default ramp shape for every throttle button (0 = linear, 1 = S-curve, 2 = exponential)
+ */
+#define ESC_RAMP_SHAPE_DEFAULT  0
+
+/**
+ * @brief Exponential ramp curvature c in e^(c*t) (higher = softer start)
+ */
+#define ESC_RAMP_CURVATURE      3.0f
+
+/**
+ * @brief Accepted curvature range
+ * Below the minimum the curve is a line; at 10 the ramp has covered ~5 %
+ * of the move at 70 % of its time, beyond that it holds the start and
+ * jumps at the end (e^c overflows a float past ~88)
+ */
+#define ESC_RAMP_CURVATURE_MIN  0.01f
+#define ESC_RAMP_CURVATURE_MAX  10.0f
+
 // =============================================================================
 // Timer IDs
 // =============================================================================
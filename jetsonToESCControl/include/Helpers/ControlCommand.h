@@ -7,7 +7,7 @@
 
 #pragma once
 
-#include "Arduino.h"
+#include <stdint.h>
 
 // =============================================================================
 // Control Type Identifiers (controlType field)
@@ -18,6 +18,7 @@
 #define CONTROL_TYPE_BATTERY     102
 #define CONTROL_TYPE_CURRENT     103
 #define CONTROL_TYPE_BUTTON      104
+#define CONTROL_TYPE_REMOTE      105
 
 // =============================================================================
 // Temperature Command Types (commandType field)
@@ -53,6 +54,14 @@
 #define COMMAND_BUTTON_75       4
 #define COMMAND_BUTTON_100      5
 
+// =============================================================================
+// Remote Command Types (commandType field, Jetson link)
+// =============================================================================
+
+#define COMMAND_REMOTE_ARM      1
+#define COMMAND_REMOTE_DISARM   2
+#define COMMAND_REMOTE_THROTTLE 3
+
 // =============================================================================
 // Button Event Types (value field)
 // =============================================================================
@@ -69,11 +78,113 @@
 /**
  * @brief Event structure for inter-task communication
  * 
- * Used by all producer classes to push events to the FreeRTOS queue.
+ * Used by all producer classes to push events to the event channel.
  * ControlTask receives these events and routes them to the state machine.
+ *
+ * Packed into 4 bytes so the queues hold and copy a third of what three
+ * ints did. The payload is raw: producers build events and states read
+ * them through the typed views below, never through payload directly.
  */
 struct ControlCommand {
-    int controlType;   ///< Producer identifier (CONTROL_TYPE_*)
-    int commandType;   ///< Event type or ID within producer (COMMAND_*)
-    int value;         ///< Measured value or event data
+    uint8_t controlType;   ///< Producer identifier (CONTROL_TYPE_*)
+    uint8_t commandType;   ///< Event type or ID within producer (COMMAND_*, timer ID)
+    uint16_t payload;      ///< Producer-specific value, see the typed views
+};
+
+static_assert(sizeof(ControlCommand) == 4, "ControlCommand must stay 4 bytes");
+
+// =============================================================================
+// Typed Event Views
+// =============================================================================
+
+/**
+ * @brief Common part of the typed views: one per controlType
+ *
+ * A view converts implicitly to the ControlCommand it wraps, so it can be
+ * pushed as is. Building a view from a received ControlCommand is explicit
+ * and must only follow a check of controlType (MoaStateMachineWrapper).
+ */
+template <uint8_t TYPE>
+class MoaEventView {
+public:
+    operator const ControlCommand&() const { return _cmd; }
+
+protected:
+    explicit MoaEventView(const ControlCommand& cmd) : _cmd(cmd) {}
+    MoaEventView(uint8_t commandType, uint16_t payload) : _cmd{TYPE, commandType, payload} {}
+
+    ControlCommand _cmd;
+};
+
+/**
+ * @brief Temperature threshold crossing (payload: averaged temperature x10 in °C)
+ */
+class TempEvent : public MoaEventView<CONTROL_TYPE_TEMPERATURE> {
+public:
+    explicit TempEvent(const ControlCommand& cmd) : MoaEventView(cmd) {}
+    TempEvent(uint8_t command, int16_t deciCelsius)
+        : MoaEventView(command, static_cast<uint16_t>(deciCelsius)) {}
+
+    uint8_t getCommand() const { return _cmd.commandType; }     ///< COMMAND_TEMP_*
+    int16_t getDeciCelsius() const { return static_cast<int16_t>(_cmd.payload); }
+};
+
+/**
+ * @brief Battery level change (payload: averaged pack voltage in mV)
+ */
+class BattEvent : public MoaEventView<CONTROL_TYPE_BATTERY> {
+public:
+    explicit BattEvent(const ControlCommand& cmd) : MoaEventView(cmd) {}
+    BattEvent(uint8_t level, uint16_t millivolts) : MoaEventView(level, millivolts) {}
+
+    uint8_t getLevel() const { return _cmd.commandType; }       ///< COMMAND_BATT_LEVEL_*
+    uint16_t getMillivolts() const { return _cmd.payload; }
+};
+
+/**
+ * @brief Current threshold crossing (payload: averaged current x10 in A, signed)
+ */
+class CurrentEvent : public MoaEventView<CONTROL_TYPE_CURRENT> {
+public:
+    explicit CurrentEvent(const ControlCommand& cmd) : MoaEventView(cmd) {}
+    CurrentEvent(uint8_t command, int16_t deciAmps)
+        : MoaEventView(command, static_cast<uint16_t>(deciAmps)) {}
+
+    uint8_t getCommand() const { return _cmd.commandType; }     ///< COMMAND_CURRENT_*
+    int16_t getDeciAmps() const { return static_cast<int16_t>(_cmd.payload); }
+};
+
+/**
+ * @brief Button gesture (commandType: button, payload: BUTTON_EVENT_*)
+ */
+class ButtonEvent : public MoaEventView<CONTROL_TYPE_BUTTON> {
+public:
+    explicit ButtonEvent(const ControlCommand& cmd) : MoaEventView(cmd) {}
+    ButtonEvent(uint8_t buttonId, uint8_t eventType) : MoaEventView(buttonId, eventType) {}
+
+    uint8_t getButtonId() const { return _cmd.commandType; }    ///< COMMAND_BUTTON_*
+    uint8_t getEventType() const { return static_cast<uint8_t>(_cmd.payload); }  ///< BUTTON_EVENT_*
+};
+
+/**
+ * @brief Timer expiry (commandType: timer ID, no payload)
+ */
+class TimerEvent : public MoaEventView<CONTROL_TYPE_TIMER> {
+public:
+    explicit TimerEvent(const ControlCommand& cmd) : MoaEventView(cmd) {}
+    explicit TimerEvent(uint8_t timerId) : MoaEventView(timerId, 0) {}
+
+    uint8_t getTimerId() const { return _cmd.commandType; }     ///< TIMER_ID_*
+};
+
+/**
+ * @brief Request from the Jetson link (commandType: COMMAND_REMOTE_*, payload: 10-bit duty)
+ */
+class RemoteEvent : public MoaEventView<CONTROL_TYPE_REMOTE> {
+public:
+    explicit RemoteEvent(const ControlCommand& cmd) : MoaEventView(cmd) {}
+    RemoteEvent(uint8_t command, uint16_t duty) : MoaEventView(command, duty) {}
+
+    uint8_t getCommand() const { return _cmd.commandType; }     ///< COMMAND_REMOTE_*
+    uint16_t getDuty() const { return _cmd.payload; }           ///< Throttle only, 0 = stop
 };
@@ -0,0 +1,220 @@
+/**
+ * @file MoaAdcSampler.h
+ * @brief Continuous ADC acquisition with oversampling and decimation
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * MoaAdcSampler drains an IAdcSampleSource (DMA on the ESP32-C3), splits the
+ * interleaved conversions per pin, and decimates each channel by boxcar
+ * averaging a configurable number of raw conversions into one output
+ * sample. Sensor controls then pull whole blocks of decimated samples per
+ * SensorTask tick instead of doing one blocking analogRead() each.
+ *
+ * A MoaOvercurrentTrip can be attached to a channel; it sees every raw
+ * conversion before decimation, which is what gives the fast protection
+ * path its latency.
+ *
+ * Free of Arduino/FreeRTOS dependencies so the block path can be unit
+ * tested on the host (see test/native/test_adc_sampler).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "IAdcSampleSource.h"
+#include "MoaOvercurrentTrip.h"
+
+/**
+ * @brief Maximum number of pins the sampler can scan
+ */
+#define MOA_ADC_MAX_CHANNELS 4
+
+/**
+ * @brief Decimated samples buffered per channel between two takeBlock() calls
+ * @note Must be a power of two (ring indices are free-running counters)
+ */
+#define MOA_ADC_BLOCK_CAPACITY 32
+
+/**
+ * @brief Raw conversions drained from the source per read() call
+ */
+#define MOA_ADC_READ_CHUNK 64
+
+/**
+ * @brief Maximum oversampling factor (raw conversions per output sample)
+ */
+#define MOA_ADC_MAX_OVERSAMPLING 64
+
+/**
+ * @brief Block-based ADC sampler with per-channel decimation
+ *
+ * ## Usage Example
+ * @code
+ * EspAdcDmaSource source;
+ * MoaAdcSampler sampler(&source);
+ * int8_t currentSlot = sampler.addChannel(PIN_CURRENT_SENSE);
+ * sampler.setSampleRate(10000);     // 10 kHz total, 5 kHz per pin
+ * sampler.setOversampling(16);      // ~312 Hz decimated per pin
+ * sampler.begin();
+ *
+ * // In ProtectionTask, every few ms:
+ * sampler.poll();
+ *
+ * // In SensorTask, once per tick:
+ * uint16_t block[MOA_ADC_BLOCK_CAPACITY];
+ * size_t n = sampler.takeBlock(currentSlot, block, MOA_ADC_BLOCK_CAPACITY);
+ * @endcode
+ *
+ * @note poll() (producer) and takeBlock() (consumer) may run in different
+ *       tasks: each channel ring is single-producer/single-consumer and
+ *       lock-free. Only one task may call poll().
+ */
+class MoaAdcSampler {
+public:
+    /**
+     * @brief Construct a new MoaAdcSampler
+     * @param source Sample source (not owned; may be set later with setSource())
+     */
+    explicit MoaAdcSampler(IAdcSampleSource* source = nullptr);
+
+    /**
+     * @brief Inject the sample source backend
+     * @param source Pointer to the source (not owned). Must be called before begin().
+     */
+    void setSource(IAdcSampleSource* source);
+
+    /**
+     * @brief Register a pin to be scanned
+     * @param pin GPIO pin (must be ADC-capable on the target)
+     * @return Channel slot used by takeBlock(), or -1 if full or already running
+     */
+    int8_t addChannel(uint8_t pin);
+
+    /**
+     * @brief Attach a trip comparator to a channel
+     * 
+     * Every raw conversion of the channel is fed to the trip in poll(),
+     * before decimation.
+     * 
+     * @param slot Channel slot returned by addChannel()
+     * @param trip Comparator (not owned), or nullptr to detach
+     */
+    void setTripMonitor(uint8_t slot, MoaOvercurrentTrip* trip);
+
+    /**
+     * @brief Set the total conversion rate across all channels
+     * @param sampleRateHz Conversions per second
+     */
+    void setSampleRate(uint32_t sampleRateHz);
+
+    /**
+     * @brief Set the number of raw conversions averaged into one output sample
+     * @param factor Oversampling factor (1 to MOA_ADC_MAX_OVERSAMPLING)
+     */
+    void setOversampling(uint8_t factor);
+
+    /**
+     * @brief Get the oversampling factor
+     * @return uint8_t Raw conversions per output sample
+     */
+    uint8_t getOversampling() const;
+
+    /**
+     * @brief Start the source with the registered channels
+     * @return true if acquisition is running
+     */
+    bool begin();
+
+    /**
+     * @brief Stop the source
+     */
+    void stop();
+
+    /**
+     * @brief Check if acquisition is running
+     * @return true between a successful begin() and stop()
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Drain the source, run the trip monitors and decimate into the per-channel blocks
+     * @return Number of raw conversions consumed
+     */
+    size_t poll();
+
+    /**
+     * @brief Move the buffered decimated samples of one channel to the caller
+     * @param slot Channel slot returned by addChannel()
+     * @param out Destination array (oldest sample first)
+     * @param maxCount Capacity of out
+     * @return Number of samples written
+     */
+    size_t takeBlock(uint8_t slot, uint16_t* out, size_t maxCount);
+
+    /**
+     * @brief Number of decimated samples discarded because the block was full
+     * 
+     * Overruns are accounted when the consumer calls takeBlock().
+     * 
+     * @param slot Channel slot
+     * @return uint32_t Overrun count since begin()
+     */
+    uint32_t getOverrunCount(uint8_t slot) const;
+
+    /**
+     * @brief Number of raw conversions received for a channel
+     * @param slot Channel slot
+     * @return uint32_t Raw sample count since begin()
+     */
+    uint32_t getRawSampleCount(uint8_t slot) const;
+
+    /**
+     * @brief Get the number of registered channels
+     * @return uint8_t Channel count
+     */
+    uint8_t getChannelCount() const;
+
+private:
+    /**
+     * @brief Per-channel decimator state and output ring
+     */
+    struct Channel {
+        uint8_t pin;                             ///< GPIO pin
+        uint32_t accumulator;                    ///< Sum of raw conversions in the current window
+        uint8_t accumulated;                     ///< Raw conversions in the current window
+        uint16_t block[MOA_ADC_BLOCK_CAPACITY];  ///< Ring of decimated samples
+        std::atomic<uint32_t> written;           ///< Samples pushed (producer-owned counter)
+        uint32_t read;                           ///< Samples consumed (consumer-owned counter)
+        uint32_t overruns;                       ///< Decimated samples dropped (ring full)
+        uint32_t rawCount;                       ///< Raw conversions received
+        MoaOvercurrentTrip* trip;                ///< Optional per-sample comparator (not owned)
+    };
+
+    IAdcSampleSource* _source;                   ///< Injected backend (not owned)
+    Channel _channels[MOA_ADC_MAX_CHANNELS];     ///< Registered channels
+    uint8_t _numChannels;                        ///< Number of registered channels
+    uint8_t _oversampling;                       ///< Raw conversions per output sample
+    uint32_t _sampleRateHz;                      ///< Total conversion rate
+    bool _running;                               ///< Acquisition running
+
+    /**
+     * @brief Feed one raw conversion into its channel's decimator
+     * @param sample Raw conversion from the source
+     */
+    void accept(const MoaAdcRawSample& sample);
+
+    /**
+     * @brief Append a decimated sample to a channel ring (overwrites the oldest if full)
+     * @param ch Channel state
+     * @param value Decimated sample
+     */
+    void pushDecimated(Channel& ch, uint16_t value);
+
+    /**
+     * @brief Reset a channel's decimator and ring
+     * @param ch Channel state
+     */
+    static void resetChannel(Channel& ch);
+};
@@ -0,0 +1,21 @@
+/**
+ * @file MoaBattLevel.h
+ * @brief Battery level enumeration
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Shared by MoaBattControl (producer), the LED indicators and the state
+ * machine actions; kept free of Arduino dependencies.
+ */
+
+#pragma once
+
+/**
+ * @brief Battery level state enumeration
+ */
+enum class MoaBattLevel {
+    BATT_STOP,    ///< Battery below stop threshold (critical)
+    BATT_LOW,     ///< Battery below low threshold (warning)
+    BATT_MEDIUM,  ///< Battery between low and high thresholds
+    BATT_HIGH     ///< Battery above high threshold (fully charged)
+};
@@ -0,0 +1,139 @@
+/**
+ * @file MoaBattResistance.h
+ * @brief Online estimate of the pack internal resistance
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Learns the pack resistance from throttle steps and infers the
+ * open-circuit voltage (OCV = V + I x R) the battery levels are judged on,
+ * so full throttle sag no longer reads as an empty pack.
+ *
+ * A step is two settled (voltage, current) points, taken once the current
+ * has held within BATT_STEP_STEADY_MA for BATT_STEP_SETTLE_MS, at least
+ * BATT_STEP_MIN_MA apart and at most BATT_STEP_MAX_SPAN_MS apart. Over so
+ * short a span the OCV barely moves, so dV = -R x dI; the steps are
+ * regressed through the origin (least squares, big steps weigh most) with
+ * exponential forgetting over BATT_STEP_MEMORY steps. The configured
+ * resistance seeds the sums as one minimum step, so the estimate starts
+ * there and moves as steps arrive.
+ *
+ * openCircuitMv() adds nothing until BATT_COMP_MIN_STEPS steps have been
+ * learned, and never more than the maximum sag (BATT_COMP_MAX_SAG_MV by
+ * default), so a bad estimate cannot hide an empty pack.
+ *
+ * Integer only (mV, mA, ms; 64-bit sums). Not thread-safe except for
+ * setInitialResistance() and the getters: owned and fed by MoaBattControl
+ * in SensorTask. Free of Arduino/FreeRTOS dependencies (see
+ * test/native/test_batt_resistance).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include "Constants.h"
+
+/**
+ * @brief Internal resistance estimator
+ *
+ * ## Usage Example
+ * @code
+ * MoaBattResistance resistance;
+ * resistance.setInitialResistance(40);            // mOhm, from the config
+ * resistance.update(terminalMv, currentMa, now);  // every sensor tick
+ * int32_t ocvMv = resistance.openCircuitMv(terminalMv, currentMa);
+ * @endcode
+ */
+class MoaBattResistance {
+public:
+    MoaBattResistance();
+
+    /**
+     * @brief Forget every step and restart from the initial resistance
+     */
+    void reset();
+
+    /**
+     * @brief Starting resistance, clamped to the plausible range; any task
+     *
+     * A changed value resets the estimate on the next update().
+     *
+     * @param milliohm Resistance before any step (mOhm)
+     */
+    void setInitialResistance(uint32_t milliohm);
+
+    /**
+     * @brief Most openCircuitMv() may add to the terminal voltage; any task
+     * @param millivolts Maximum sag compensated (mV)
+     */
+    void setMaxSag(uint32_t millivolts);
+
+    /**
+     * @brief Get the maximum sag compensated; any task
+     * @return uint32_t Maximum sag (mV)
+     */
+    uint32_t getMaxSag() const;
+
+    /**
+     * @brief Check whether enough steps were learned to compensate
+     * @return true once BATT_COMP_MIN_STEPS steps have been regressed
+     */
+    bool isLearned() const;
+
+    /**
+     * @brief Feed one (voltage, current) point
+     * @param voltageMv Terminal voltage (mV)
+     * @param currentMa Battery current (mA, positive = discharge)
+     * @param nowMs Sample time (ms)
+     * @return true if the point closed a step that was regressed
+     */
+    bool update(int32_t voltageMv, int32_t currentMa, uint32_t nowMs);
+
+    /**
+     * @brief Open-circuit voltage behind a terminal reading
+     * @param voltageMv Terminal voltage (mV)
+     * @param currentMa Battery current (mA)
+     * @return int32_t voltageMv + currentMa x R, the added part limited to
+     *         the maximum sag; voltageMv until isLearned() (mV)
+     */
+    int32_t openCircuitMv(int32_t voltageMv, int32_t currentMa) const;
+
+    /**
+     * @brief Current estimate; any task
+     * @return uint32_t Resistance (mOhm)
+     */
+    uint32_t getResistanceMilliohm() const;
+
+    /**
+     * @brief Steps regressed since reset(); any task
+     */
+    uint32_t getStepCount() const;
+
+    /**
+     * @brief Steps dropped as outliers since reset(); any task
+     */
+    uint32_t getRejectedCount() const;
+
+private:
+    std::atomic<uint32_t> _requestedMohm;   ///< Set by setInitialResistance()
+    uint32_t _initialMohm;                  ///< In use since the last reset()
+    std::atomic<uint32_t> _maxSagMv;        ///< Set by setMaxSag()
+
+    int64_t _sumDiDi;           ///< sum of dI x dI (mA^2)
+    int64_t _sumDiDv;           ///< sum of dI x dV (mA x mV)
+
+    int32_t _lastMa;            ///< Previous tick's current
+    uint32_t _steadySinceMs;    ///< Start of the current steady run
+    bool _haveLast;
+
+    int32_t _refMv;             ///< Last settled point
+    int32_t _refMa;
+    uint32_t _refMs;
+    bool _haveRef;
+
+    std::atomic<uint32_t> _resistanceMohm;
+    std::atomic<uint32_t> _steps;
+    std::atomic<uint32_t> _rejected;
+
+    void addStep(int32_t dv, int32_t di);
+};
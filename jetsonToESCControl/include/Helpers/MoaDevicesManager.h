@@ -15,17 +15,20 @@
 #include "MoaLedControl.h"
 #include "ESCController.h"
 #include "MoaFlashLog.h"
-#include "MoaTimer.h"
+#include "MoaTimerService.h"
 #include "MoaBattControl.h"  // For MoaBattLevel enum
 #include "ConfigManager.h"
 #include "MoaWiFiManager.h"
 #include "MoaOTAManager.h"
+#include "MoaOvercurrentTrip.h"
+#include "IMoaActions.h"
 
 /**
  * @brief Output device facade
  * 
  * Provides high-level methods for controlling outputs, abstracting
- * the underlying device implementations from the state machine.
+ * the underlying device implementations from the state machine
+ * (through IMoaActions).
  * 
  * ## Usage
  * @code
@@ -37,7 +40,7 @@
  * devices.indicateOverheat(true);
  * @endcode
  */
-class MoaDevicesManager {
+class MoaDevicesManager : public IMoaActions {
 public:
     /**
      * @brief Construct a new MoaDevicesManager
@@ -55,54 +58,75 @@ public:
     /**
      * @brief Destructor
      */
-    ~MoaDevicesManager();
+    ~MoaDevicesManager() override;
 
     // === ESC Control ===
 
     /**
      * @brief Set throttle level by raw duty cycle
      * @param duty 10-bit duty cycle value (clamped to servo range)
+     * @param shape Ramp shape towards it
      */
-    void setThrottleLevel(uint16_t duty);
+    void setThrottleLevel(uint16_t duty, MoaRampShape shape = MoaRampShape::LINEAR);
 
     /**
      * @brief Stop the motor immediately
      */
-    void stopMotor();
+    void stopMotor() override;
 
     /**
      * @brief Arm the ESC
      */
     void armESC();
 
-    /**
-     * @brief Tick the ESC ramp, call periodically from IOTask
-     */
-    void updateESC();
-
     /**
      * @brief Engage throttle: set level and start appropriate timer
      * @param commandType Button command (COMMAND_BUTTON_25..COMMAND_BUTTON_100)
      */
-    void engageThrottle(uint8_t commandType);
+    void engageThrottle(uint8_t commandType) override;
 
     /**
      * @brief Disengage throttle: stop all throttle timers and motor
      */
-    void disengageThrottle();
+    void disengageThrottle() override;
 
     /**
      * @brief Handle full throttle step-down to 75%% with its own timer
      */
-    void handleThrottleStepDown();
+    void handleThrottleStepDown() override;
+
+    /**
+     * @brief Throttle setpoint from the Jetson link, guarded by the link watchdog
+     * 
+     * Each setpoint restarts TIMER_ID_THROTTLE with MOA_LINK_WATCHDOG_MS, so
+     * the board falls back to Idle if the host stops streaming.
+     * @param duty 10-bit duty cycle value (clamped to servo range)
+     */
+    void setRemoteThrottle(uint16_t duty) override;
+
+    // === Fast Overcurrent Protection ===
+
+    /**
+     * @brief Set the fast overcurrent trip used by the protection path
+     * @param trip Comparator (not owned), or nullptr if not used
+     */
+    void setOvercurrentTrip(MoaOvercurrentTrip* trip);
+
+    /**
+     * @brief Re-arm the fast overcurrent trip and release the ESC latch
+     * 
+     * Called once the averaged current is back to normal. The motor stays
+     * stopped until the next throttle command.
+     */
+    void resetOvercurrentTrip();
 
     // === Timer Management ===
 
     /**
-     * @brief Set the event queue for timer events
-     * @param queue FreeRTOS queue handle (must be set before using timers)
+     * @brief Set the event channel for timer events and start the timer wheel
+     * @param queue Event channel (must be set before using timers)
      */
-    void setEventQueue(QueueHandle_t queue);
+    void setEventQueue(MoaEventChannel* queue);
 
     /**
      * @brief Start or restart a timer by ID
@@ -132,29 +156,29 @@ public:
      * @brief Show battery level on LEDs
      * @param level Battery level (HIGH, MEDIUM, LOW)
      */
-    void showBatteryLevel(MoaBattLevel level);
+    void showBatteryLevel(MoaBattLevel level) override;
 
     /**
      * @brief Indicate overheat condition (blinks temp LED)
      * @param active True to blink overheat LED, false to turn off
      */
-    void indicateOverheat(bool active);
+    void indicateOverheat(bool active) override;
 
     /**
      * @brief Indicate overcurrent condition (blinks overcurrent LED)
      * @param active True to blink overcurrent LED, false to restore locked/unlocked state
      */
-    void indicateOvercurrent(bool active);
+    void indicateOvercurrent(bool active) override;
 
     /**
      * @brief Show board locked state (overcurrent LED solid ON)
      */
-    void showBoardLocked();
+    void showBoardLocked() override;
 
     /**
      * @brief Show board unlocked state (overcurrent LED OFF)
      */
-    void showBoardUnlocked();
+    void showBoardUnlocked() override;
 
     /**
      * @brief Clear all warning LEDs
@@ -164,24 +188,24 @@ public:
     /**
      * @brief Enter config mode indication (all LEDs blinking)
      */
-    void enterConfigMode();
+    void enterConfigMode() override;
 
     /**
      * @brief Exit config mode indication
      */
-    void exitConfigMode();
+    void exitConfigMode() override;
 
     // === OTA Control ===
 
     /**
      * @brief Connect WiFi STA and start OTA (enter config state)
      */
-    void startOTA();
+    void startOTA() override;
 
     /**
      * @brief Stop OTA and disconnect WiFi STA (exit config state)
      */
-    void stopOTA();
+    void stopOTA() override;
 
     /**
      * @brief Turn all LEDs off
@@ -191,12 +215,12 @@ public:
     /**
      * @brief Do a wave pattern on all LEDs (welcome animation)
      */
-    void waveAllLeds(bool fast=false);
+    void waveAllLeds(bool fast=false) override;
 
     /**
      * @brief Re-apply cached LED indicator state (battery, temp, overcurrent)
      */
-    void refreshLedIndicators();
+    void refreshLedIndicators() override;
 
     // === Logging ===
 
@@ -204,7 +228,7 @@ public:
      * @brief Log a system event
      * @param code System event code
      */
-    void logSystem(uint8_t code);
+    void logSystem(uint8_t code) override;
 
     /**
      * @brief Log a button event
@@ -258,8 +282,9 @@ private:
     ConfigManager& _config;
     MoaWiFiManager& _wifiManager;
     MoaOTAManager& _otaManager;
-    QueueHandle_t _eventQueue;
-    MoaTimer* _timers[MOA_TIMER_MAX_INSTANCES];
+    MoaEventChannel* _eventQueue;
+    MoaTimerService _timers;
+    MoaOvercurrentTrip* _overcurrentTrip;
 
     MoaBattLevel _lastBattLevel;
     bool _lastOverheat;
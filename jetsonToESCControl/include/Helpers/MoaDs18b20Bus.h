@@ -0,0 +1,270 @@
+/**
+ * @file MoaDs18b20Bus.h
+ * @brief DS18B20 probes on one 1-Wire bus: cached ROMs, addressed reads
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * begin() searches the bus once and caches up to DS18B20_SEARCH_MAX ROM
+ * codes (CRC-checked, DS18B20/DS1822 family), binds the roles (ESC, motor,
+ * battery) to them, detects parasite power and sets each probe's
+ * resolution in its scratchpad (RAM only, no EEPROM write). From then on
+ * every probe is addressed by its ROM: no search per reading, no waiting
+ * on the slowest resolution.
+ *
+ * A role is bound to the ROM code configured for it (setRoleRom(), kept in
+ * NVS and assigned with CLI 'probes assign'), never to a position in the
+ * search order, which follows the ROM bits and not the wiring. The only
+ * fallback is a bus with exactly one probe and no ROM configured for any
+ * role: it serves the ESC role. A configured ROM that is not found leaves its role unbound
+ * (isMissing()); an unbound role never produces a reading.
+ *
+ * poll() runs at most one bus transaction per call, in this order:
+ * 1. read the scratchpad of a probe whose conversion time has elapsed
+ *    (round-robin, CRC and config byte checked);
+ * 2. write a changed resolution to an idle probe;
+ * 3. start conversions: broadcast (one Skip ROM Convert T for every probe,
+ *    once all have been read) or staggered (a Match ROM Convert T for the
+ *    next idle probe, so each probe runs at the rate of its resolution).
+ * A parasite-powered bus is held high during a conversion, so there the
+ * bus stays quiet until it is done and staggered mode converts one probe
+ * at a time.
+ *
+ * Readings are integer centi-degC (1/16 degC steps from the probe). A probe
+ * that does not answer or fails the CRC reports
+ * TEMP_PROBE_DISCONNECTED_C x 100 and is counted as an error.
+ *
+ * Not thread-safe except for setMode(), setResolution() and the getters:
+ * owned and polled by Ds18b20TemperatureSensor in SensorTask. Free of
+ * Arduino/FreeRTOS dependencies (see test/native/test_ds18b20_bus).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "Constants.h"
+#include "IOneWireBus.h"
+
+/**
+ * @brief DS18B20 function commands and scratchpad layout
+ */
+#define DS18B20_CMD_CONVERT         0x44
+#define DS18B20_CMD_READ_SCRATCH    0xBE
+#define DS18B20_CMD_WRITE_SCRATCH   0x4E
+#define DS18B20_CMD_READ_POWER      0xB4
+#define DS18B20_FAMILY              0x28
+#define DS1822_FAMILY               0x22
+#define DS18B20_SCRATCH_BYTES       9
+
+/**
+ * @brief Most ROM codes begin() keeps from the search (assigned or not)
+ */
+#define DS18B20_SEARCH_MAX          8
+
+/**
+ * @brief Conversion start policy
+ */
+enum class MoaProbeMode : uint8_t {
+    BROADCAST = 0,  ///< All probes at once (Skip ROM), restarted when all are read
+    STAGGERED = 1   ///< Each probe on its own (Match ROM), restarted when read
+};
+
+/**
+ * @brief Dallas/Maxim CRC-8 (x^8 + x^5 + x^4 + 1), as in ROM codes and scratchpads
+ */
+uint8_t moaOneWireCrc8(const uint8_t* data, size_t length);
+
+/**
+ * @brief Conversion time of a DS18B20 at a resolution
+ * @param bits 9..12 (clamped)
+ * @return uint32_t Milliseconds (94, 188, 375, 750)
+ */
+uint32_t moaDs18b20ConversionMs(uint8_t bits);
+
+/**
+ * @brief Decode a scratchpad
+ *
+ * The bits below the resolution in the config byte are undefined and
+ * dropped.
+ *
+ * @param scratch 9 scratchpad bytes
+ * @param centiC Receives the temperature (centi-degC), untouched if invalid
+ * @return true if the CRC and the config byte are valid
+ */
+bool moaDs18b20Decode(const uint8_t scratch[DS18B20_SCRATCH_BYTES], int32_t* centiC);
+
+/**
+ * @brief Name of a probe role ("esc", "motor", "battery"; "?" if out of range)
+ */
+const char* moaProbeRoleName(uint8_t role);
+
+/**
+ * @brief Manager of the DS18B20 probes on one bus
+ *
+ * ## Usage Example
+ * @code
+ * GpioOneWireBus wire(PIN_TEMP_SENSE);
+ * MoaDs18b20Bus probes(&wire);
+ * probes.setRoleRom(TEMP_PROBE_ESC, config.tempProbeRoms[TEMP_PROBE_ESC]);
+ * probes.setResolution(TEMP_PROBE_ESC, 10);
+ * probes.begin();                                 // Search once, bind the roles
+ *
+ * // Every SensorTask cycle:
+ * probes.poll(millis());                          // At most one transaction
+ * int32_t centiC;
+ * if (probes.takeReading(TEMP_PROBE_ESC, &centiC)) {
+ *     // Fresh ESC reading
+ * }
+ * @endcode
+ */
+class MoaDs18b20Bus {
+public:
+    /**
+     * @param bus 1-Wire bus backend (not owned)
+     */
+    explicit MoaDs18b20Bus(IOneWireBus* bus);
+
+    /**
+     * @brief ROM code a role is bound to by the next begin()
+     * @param role TEMP_PROBE_ESC, TEMP_PROBE_MOTOR or TEMP_PROBE_BATTERY
+     * @param rom ROM code, or nullptr / all zeros for none
+     */
+    void setRoleRom(uint8_t role, const uint8_t* rom);
+
+    /**
+     * @brief ROM code configured for a role (nullptr if none)
+     */
+    const uint8_t* getRoleRom(uint8_t role) const;
+
+    /**
+     * @brief Search the bus, cache the ROMs, bind the roles, write the resolutions
+     * @return uint8_t Number of roles bound to a probe (0..TEMP_PROBE_MAX_COUNT)
+     */
+    uint8_t begin();
+
+    /**
+     * @brief Advance the schedule by at most one bus transaction
+     * @param nowMs Current time (ms)
+     * @return true if a probe was read (successfully or not)
+     */
+    bool poll(uint32_t nowMs);
+
+    /**
+     * @brief Take a probe's reading if one arrived since the last take
+     * @param probe Probe role
+     * @param centiC Receives the temperature (centi-degC), or
+     *               TEMP_PROBE_DISCONNECTED_C x 100 after a failed read
+     * @return true once per completed read
+     */
+    bool takeReading(uint8_t probe, int32_t* centiC);
+
+    /**
+     * @brief Conversion start policy; any task, applied by the next poll()
+     */
+    void setMode(MoaProbeMode mode);
+    MoaProbeMode getMode() const;
+
+    /**
+     * @brief Probe resolution; any task, written to the probe by poll()
+     *        once it is idle (before begin(): written by begin())
+     * @param probe Probe role (0..TEMP_PROBE_MAX_COUNT-1)
+     * @param bits 9..12 (clamped)
+     */
+    void setResolution(uint8_t probe, uint8_t bits);
+
+    /**
+     * @brief Resolution requested for a probe (bits)
+     */
+    uint8_t getResolution(uint8_t probe) const;
+
+    /**
+     * @brief Number of roles bound to a probe by begin()
+     */
+    uint8_t getProbeCount() const;
+
+    /**
+     * @brief ROM code a role is bound to (nullptr if unbound)
+     */
+    const uint8_t* getRom(uint8_t probe) const;
+
+    /**
+     * @brief true if the role's configured ROM was not found by begin()
+     */
+    bool isMissing(uint8_t probe) const;
+
+    /**
+     * @brief Number of probes the search found, assigned or not
+     */
+    uint8_t getFoundCount() const;
+
+    /**
+     * @brief ROM code of a found probe, in search order (nullptr if out of range)
+     */
+    const uint8_t* getFoundRom(uint8_t index) const;
+
+    /**
+     * @brief Role a found probe is bound to
+     * @return int8_t TEMP_PROBE_*, or -1 if unassigned
+     */
+    int8_t getFoundRole(uint8_t index) const;
+
+    /**
+     * @brief true if a probe draws parasite power
+     */
+    bool isParasite() const;
+
+    /**
+     * @brief Last reading of a probe (centi-degC, may be the disconnected value)
+     */
+    int32_t getLastCentiC(uint8_t probe) const;
+
+    /**
+     * @brief Successful reads of a probe
+     */
+    uint32_t getReadCount(uint8_t probe) const;
+
+    /**
+     * @brief Failed reads of a probe (no presence, bad CRC or config)
+     */
+    uint32_t getErrorCount(uint8_t probe) const;
+
+    /**
+     * @brief Bus transactions since begin(), its own included (ROM search excluded)
+     */
+    uint32_t getTransactionCount() const;
+
+private:
+    IOneWireBus* _bus;                              ///< Bus backend (not owned)
+    uint8_t _count;                                 ///< Roles bound
+    uint8_t _bound;                                 ///< Bit per role: bound to a found probe
+    uint8_t _missing;                               ///< Bit per role: configured ROM not found
+    uint8_t _configured;                            ///< Bit per role: ROM configured
+    uint8_t _roleRoms[TEMP_PROBE_MAX_COUNT][ONEWIRE_ROM_BYTES];  ///< Configured ROMs
+    uint8_t _roms[TEMP_PROBE_MAX_COUNT][ONEWIRE_ROM_BYTES];      ///< Bound ROMs
+    uint8_t _foundCount;                            ///< Probes found by the search
+    uint8_t _found[DS18B20_SEARCH_MAX][ONEWIRE_ROM_BYTES];
+    int8_t _foundRole[DS18B20_SEARCH_MAX];          ///< Role per found probe, -1 if none
+    uint8_t _alarms[TEMP_PROBE_MAX_COUNT][2];       ///< TH, TL kept when writing the config
+    uint8_t _bits[TEMP_PROBE_MAX_COUNT];            ///< Resolution the probe runs at
+    uint32_t _startMs[TEMP_PROBE_MAX_COUNT];        ///< Conversion start
+    uint8_t _converting;                            ///< Bit per probe
+    uint8_t _fresh;                                 ///< Bit per probe: reading not yet taken
+    uint8_t _nextRead;                              ///< Round-robin start for reads (role)
+    uint8_t _nextStart;                             ///< Round-robin start for staggered conversions (role)
+    bool _parasite;
+
+    std::atomic<uint8_t> _mode;
+    std::atomic<uint8_t> _requestedBits[TEMP_PROBE_MAX_COUNT];
+    std::atomic<int32_t> _lastCentiC[TEMP_PROBE_MAX_COUNT];
+    std::atomic<uint32_t> _reads[TEMP_PROBE_MAX_COUNT];
+    std::atomic<uint32_t> _errors[TEMP_PROBE_MAX_COUNT];
+    std::atomic<uint32_t> _transactions;
+
+    bool isBound(uint8_t probe) const;
+    void bind(uint8_t probe, uint8_t found);
+    bool isDue(uint8_t probe, uint32_t nowMs) const;
+    void readProbe(uint8_t probe);
+    bool writeConfig(uint8_t probe, uint8_t bits);
+    bool startConversion(const uint8_t* rom);
+};
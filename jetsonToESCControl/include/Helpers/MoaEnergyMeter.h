@@ -0,0 +1,139 @@
+/**
+ * @file MoaEnergyMeter.h
+ * @brief Coulomb counter and energy integrator for the battery
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Integrates the battery current over each real interval between two
+ * current readings (trapezoid on the current, latest battery voltage) into
+ * charge (mAh) and energy (mWh), for the session and on top of a lifetime
+ * base loaded from NVS. A rolling power average gives the remaining ride
+ * time; the charge drawn, against the pack capacity, gives a state of
+ * charge that does not sag under load the way the voltage does.
+ *
+ * Integer only: the accumulators are 64-bit in the sensor units (A x10,
+ * mV, ms), divided down when a report is read. Not thread-safe except for
+ * setBattery(): owned and fed by StatsTask through MoaStatsAggregator,
+ * which publishes the MoaEnergyReport to other tasks. Free of
+ * Arduino/FreeRTOS dependencies (see test/native/test_energy_meter).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include "Constants.h"
+#include "StatsReading.h"
+
+/**
+ * @brief socPermille before the first battery reading
+ */
+#define MOA_ENERGY_SOC_UNKNOWN      0xFFFF
+
+/**
+ * @brief remainingS when no ride time can be estimated (idle, no SoC yet)
+ */
+#define MOA_ENERGY_TIME_UNKNOWN     0xFFFFFFFFUL
+
+/**
+ * @brief Energy figures published to other tasks
+ */
+struct MoaEnergyReport {
+    int32_t sessionMah;         ///< Charge drawn since boot (mAh, negative = net regen)
+    int32_t sessionMwh;         ///< Energy drawn since boot (mWh)
+    int32_t lifetimeMah;        ///< Lifetime base + session (mAh)
+    int32_t lifetimeMwh;        ///< Lifetime base + session (mWh)
+    int32_t avgPowerMw;         ///< Rolling battery power (mW, ENERGY_POWER_WINDOW_MS)
+    uint16_t socPermille;       ///< State of charge 0-1000, or MOA_ENERGY_SOC_UNKNOWN
+    uint16_t reserved;          ///< Padding
+    uint32_t remainingS;        ///< Ride time left at avgPowerMw, or MOA_ENERGY_TIME_UNKNOWN
+    uint32_t integratedMs;      ///< Time covered by the integration (gaps excluded)
+};
+
+/**
+ * @brief Fixed-point coulomb counter
+ *
+ * ## Usage Example
+ * @code
+ * MoaEnergyMeter meter;
+ * meter.setBattery(10000, 25200, 18900);
+ * meter.setLifetime(config.energyLifetimeMah, config.energyLifetimeMwh);
+ * meter.add(reading);                          // every StatsReading
+ *
+ * MoaEnergyReport report = meter.getReport();
+ * if (meter.isSaveDue(now)) { save(report.lifetimeMah, ...); meter.markSaved(now); }
+ * @endcode
+ */
+class MoaEnergyMeter {
+public:
+    MoaEnergyMeter();
+
+    /**
+     * @brief Start a new session (the lifetime base is kept)
+     */
+    void reset();
+
+    /**
+     * @brief Pack model for the state of charge; any task
+     * @param capacityMah Usable capacity (100%)
+     * @param fullMv Resting voltage taken as 100%
+     * @param emptyMv Voltage taken as 0%
+     */
+    void setBattery(uint32_t capacityMah, uint16_t fullMv, uint16_t emptyMv);
+
+    /**
+     * @brief Lifetime totals before this session (from NVS)
+     */
+    void setLifetime(int32_t mah, int32_t mwh);
+
+    /**
+     * @brief Integrate one reading
+     *
+     * Battery readings update the voltage (the first one sets the initial
+     * state of charge); each current reading closes an interval since the
+     * previous one. Intervals longer than STATS_ENERGY_MAX_GAP_MS (stalled
+     * producer) are skipped. Other types are ignored.
+     */
+    void add(const StatsReading& reading);
+
+    MoaEnergyReport getReport() const;
+
+    /**
+     * @brief Lifetime totals should be written to NVS
+     *
+     * True once ENERGY_SAVE_INTERVAL_MS have passed since the last save
+     * and the charge has moved by ENERGY_SAVE_MIN_MAH, so a ride costs a
+     * handful of flash writes.
+     *
+     * @param nowMs Current time (ms)
+     */
+    bool isSaveDue(uint32_t nowMs) const;
+
+    /**
+     * @brief Record that the current lifetime totals were saved
+     */
+    void markSaved(uint32_t nowMs);
+
+private:
+    std::atomic<uint32_t> _capacityMah;
+    std::atomic<uint32_t> _fullMv;
+    std::atomic<uint32_t> _emptyMv;
+
+    int32_t _baseMah;
+    int32_t _baseMwh;
+
+    int64_t _chargeAcc;         ///< (A x10, sum of both ends) x ms
+    int64_t _energyAcc;         ///< (A x10, sum of both ends) x mV x ms
+    int64_t _avgPowerMw16;      ///< Rolling power, mW x 16
+    uint32_t _integratedMs;
+
+    int32_t _battMv;
+    int32_t _lastCurrentX10;
+    uint32_t _lastCurrentMs;
+    bool _haveBatt;
+    bool _haveCurrent;
+    uint16_t _initialSoc;       ///< Permille, from the first battery reading
+
+    int32_t _savedMah;          ///< sessionMah at the last save
+    uint32_t _savedMs;
+};
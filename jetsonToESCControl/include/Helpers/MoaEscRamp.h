@@ -0,0 +1,174 @@
+/**
+ * @file MoaEscRamp.h
+ * @brief Shaped ESC duty ramp in PWM counts, stepped by a fixed-period timer
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Holds the duty currently on the wire and walks it to a target in a given
+ * number of steps. Each step recomputes the duty from the start point
+ * (from + delta * shape(k / steps)), so rounding never accumulates and the
+ * last step lands exactly on the target. A new target starts from the
+ * duty reached so far: reversing mid-ramp never jumps.
+ *
+ * The shape comes from a MoaRampProfile: linear (exact integer
+ * interpolation), S-curve (smootherstep: zero speed and acceleration at
+ * both ends, so the jerk stays bounded) or exponential (soft start, firm
+ * finish). Curved shapes are tabulated once, when the config is applied,
+ * into MOA_RAMP_PROFILE_SEGMENTS + 1 Q15 points; a step is then one table
+ * interpolation, the same cost whatever the shape.
+ *
+ * Works in raw PWM counts at the ESC resolution (14 bits at 50 Hz: 819
+ * counts between 1 ms and 2 ms instead of 51 at 10 bits). ESCController
+ * steps it from an esp_timer every ESC_RAMP_TICK_US, independent of task
+ * scheduling. Free of Arduino/FreeRTOS dependencies so the ramp shape can
+ * be checked against a recorded PWM sink on the host (see
+ * test/native/test_esc_ramp).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "Constants.h"
+
+/**
+ * @brief Number of segments in a ramp profile table (table has one more point)
+ */
+#define MOA_RAMP_PROFILE_SEGMENTS   32
+
+/**
+ * @brief Ramp shapes (stored in NVS: do not renumber)
+ */
+enum class MoaRampShape : uint8_t {
+    LINEAR = 0,     ///< Constant rate
+    SCURVE = 1,     ///< Smootherstep: eases in and out, bounded jerk
+    EXPO = 2,       ///< Exponential: slow start, fast finish (curvature set by config)
+};
+
+#define MOA_RAMP_SHAPE_COUNT    3
+
+/**
+ * @brief Ramp progress curve, tabulated in Q15 (0 = start, 32768 = target)
+ *
+ * Built outside the ramp timer (config apply); lookups are integer only.
+ */
+class MoaRampProfile {
+public:
+    /**
+     * @brief Linear profile
+     */
+    MoaRampProfile();
+
+    /**
+     * @brief Tabulate a shape
+     * @param shape Curve to tabulate
+     * @param curvature Exponent for EXPO (e^(c*t)), clamped by clampCurvature();
+     *        at the minimum it falls back to linear
+     */
+    void build(MoaRampShape shape, float curvature);
+
+    MoaRampShape getShape() const;
+    bool isLinear() const;
+
+    /**
+     * @brief Progress after a number of steps
+     * @param done Steps taken (<= steps)
+     * @param steps Steps of the whole ramp (> 0)
+     * @return Fraction of the move in Q15 (32768 at done == steps)
+     */
+    uint16_t at(uint16_t done, uint16_t steps) const;
+
+    /**
+     * @brief Short shape name for logs and the CLI
+     */
+    static const char* shapeName(MoaRampShape shape);
+
+    /**
+     * @brief Clamp an EXPO curvature to ESC_RAMP_CURVATURE_MIN..MAX (NaN to the minimum)
+     */
+    static float clampCurvature(float curvature);
+
+    static const uint16_t ONE = 32768;     ///< Q15 1.0
+
+private:
+    MoaRampShape _shape;
+    uint16_t _table[MOA_RAMP_PROFILE_SEGMENTS + 1];    ///< Q15 progress at i / SEGMENTS
+};
+
+/**
+ * @brief Shaped duty ramp (not thread-safe: the owner serializes access)
+ *
+ * ## Usage
+ * @code
+ * MoaEscRamp ramp(819);
+ * MoaRampProfile scurve;
+ * scurve.build(MoaRampShape::SCURVE, 0.0f);
+ * ramp.start(1228, MoaEscRamp::stepsFor(819, 1228, 819, 1638, 200.0f, 20000), &scurve);
+ *
+ * // Every ESC_RAMP_TICK_US:
+ * if (ramp.step()) {
+ *     ledcWrite(channel, ramp.getDuty());
+ * }
+ * @endcode
+ */
+class MoaEscRamp {
+public:
+    /**
+     * @param duty Initial duty (PWM counts)
+     */
+    explicit MoaEscRamp(uint16_t duty = 0);
+
+    /**
+     * @brief Jump to a duty and cancel any ramp in progress
+     */
+    void reset(uint16_t duty);
+
+    /**
+     * @brief Ramp from the current duty to a target
+     * @param target Target duty (PWM counts)
+     * @param steps Number of step() calls to reach it (0 is taken as 1)
+     * @param profile Shape of the move (not owned, must outlive the ramp); nullptr = linear
+     * @return false if already at the target (nothing to do)
+     */
+    bool start(uint16_t target, uint16_t steps, const MoaRampProfile* profile = nullptr);
+
+    /**
+     * @brief Advance one step
+     * @return true if the duty changed and must be written
+     */
+    bool step();
+
+    bool isActive() const;
+    uint16_t getDuty() const;
+    uint16_t getTarget() const;
+
+    /**
+     * @brief Steps left until the target (0 when idle)
+     */
+    uint16_t getStepsLeft() const;
+
+    /**
+     * @brief Steps for a move at a given rate
+     *
+     * The rate is the average over the move: curved shapes peak faster
+     * (S-curve 1.875x) but take the same time as the linear ramp.
+     *
+     * @param from Start duty (PWM counts)
+     * @param to Target duty (PWM counts)
+     * @param minDuty Duty at 0 % throttle
+     * @param maxDuty Duty at 100 % throttle
+     * @param ratePercentPerSec Throttle change per second (%/s)
+     * @param tickUs Time between two step() calls (µs)
+     * @return Number of steps, at least 1
+     */
+    static uint16_t stepsFor(uint16_t from, uint16_t to, uint16_t minDuty, uint16_t maxDuty,
+                             float ratePercentPerSec, uint32_t tickUs);
+
+private:
+    uint16_t _duty;         ///< Duty on the wire
+    uint16_t _from;         ///< Duty when the ramp started
+    uint16_t _target;       ///< Duty at the last step
+    uint16_t _steps;        ///< Steps of the current ramp
+    uint16_t _done;         ///< Steps taken so far
+    const MoaRampProfile* _profile;     ///< Shape of the current ramp (nullptr = linear)
+    bool _active;
+};
@@ -0,0 +1,88 @@
+/**
+ * @file MoaEventChannel.h
+ * @brief Control event channel between the producers and ControlTask
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Replaces the single FIFO (xQueueCreate of ControlCommand) with a
+ * MoaEventQueue: safety events are served before button and timer events,
+ * repeated sensor events are coalesced, and every drop is counted per
+ * producer instead of vanishing in xQueueSend(..., 0).
+ *
+ * push() never blocks: it updates the queue under a short critical
+ * section and gives a binary wake-up semaphore. receive() pops the
+ * highest-priority event and only waits on the semaphore when both lanes
+ * are empty, so coalesced or superseded entries never leave it out of
+ * step with the queue.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "ControlCommand.h"
+#include "MoaEventQueue.h"
+
+/**
+ * @brief Per-producer counters and lane depths
+ */
+struct MoaEventChannelStats {
+    MoaEventCounters sources[MOA_EVENT_SOURCE_COUNT];
+    uint8_t pending[MOA_EVENT_LANE_COUNT];
+    uint8_t highWater[MOA_EVENT_LANE_COUNT];
+};
+
+/**
+ * @brief Multi-producer, single-consumer control event channel
+ *
+ * ## Usage
+ * @code
+ * MoaEventChannel events;
+ * events.begin();
+ *
+ * events.push(cmd);                            // Any producer task
+ *
+ * ControlCommand cmd;
+ * if (events.receive(cmd, portMAX_DELAY)) {    // ControlTask
+ *     handleEvent(cmd);
+ * }
+ * @endcode
+ */
+class MoaEventChannel {
+public:
+    MoaEventChannel();
+
+    /**
+     * @brief Create the wake-up semaphore (before ControlTask starts)
+     * @return false if it could not be allocated
+     */
+    bool begin();
+
+    /**
+     * @brief Queue, coalesce or (lane full) drop an event, never blocks
+     * @return false if the event was dropped
+     */
+    bool push(const ControlCommand& cmd);
+
+    /**
+     * @brief Wait for the highest-priority pending event
+     * @return false on timeout
+     */
+    bool receive(ControlCommand& cmd, TickType_t ticksToWait);
+
+    /**
+     * @brief Snapshot of the counters
+     */
+    void getStats(MoaEventChannelStats& stats) const;
+
+    /**
+     * @brief Clear the counters and high-water marks
+     */
+    void resetStats();
+
+private:
+    MoaEventQueue _queue;
+    mutable portMUX_TYPE _mux;
+    SemaphoreHandle_t _ready;           ///< Given when an entry is queued
+};
@@ -0,0 +1,182 @@
+/**
+ * @file MoaEventQueue.h
+ * @brief Two-lane ControlCommand queue: safety events first, redundant sensor events coalesced
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Events are sorted into two fixed rings:
+ * - safety lane: every current event, battery STOP, temperature
+ *   crossings and remote DISARM. Always served first, and UI traffic
+ *   cannot fill it;
+ * - normal lane: buttons, timers, the other battery levels and the other
+ *   remote commands.
+ *
+ * Sensor producers report state transitions, so only their latest pending
+ * state matters; the same goes for remote throttle setpoints. Such an
+ * event identical in type to the newest pending event of the same
+ * producer updates that entry's value in place. A
+ * safety event also removes the producer's older normal-lane events: they
+ * would otherwise be served after it and restore a stale state (battery
+ * LOW after STOP).
+ *
+ * Within a lane, events keep their arrival order. Every push is counted
+ * per producer as queued, coalesced or dropped (lane full), along with the
+ * pending entries a safety event superseded.
+ *
+ * Not thread-safe and free of Arduino/FreeRTOS dependencies:
+ * MoaEventChannel adds the lock and the blocking receive, and the logic
+ * is tested on the host (see test/native/test_event_queue).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "ControlCommand.h"
+
+/**
+ * @brief Safety lane depth
+ */
+#define MOA_EVENT_SAFETY_DEPTH  8
+
+/**
+ * @brief Normal lane depth
+ */
+#define MOA_EVENT_NORMAL_DEPTH  16
+
+/**
+ * @brief Lanes, in service order
+ */
+enum MoaEventLane : uint8_t {
+    MOA_EVENT_LANE_SAFETY = 0,
+    MOA_EVENT_LANE_NORMAL,
+    MOA_EVENT_LANE_COUNT
+};
+
+/**
+ * @brief Producers, for per-source counters (controlType order)
+ */
+enum MoaEventSource : uint8_t {
+    MOA_EVENT_SOURCE_TIMER = 0,
+    MOA_EVENT_SOURCE_TEMPERATURE,
+    MOA_EVENT_SOURCE_BATTERY,
+    MOA_EVENT_SOURCE_CURRENT,
+    MOA_EVENT_SOURCE_BUTTON,
+    MOA_EVENT_SOURCE_REMOTE,
+    MOA_EVENT_SOURCE_OTHER,
+    MOA_EVENT_SOURCE_COUNT
+};
+
+/**
+ * @brief Outcome of a push
+ */
+enum MoaEventPushResult : uint8_t {
+    MOA_EVENT_QUEUED = 0,       ///< New entry
+    MOA_EVENT_COALESCED,        ///< Merged into a pending entry
+    MOA_EVENT_DROPPED           ///< Lane full
+};
+
+/**
+ * @brief Per-producer push counters
+ */
+struct MoaEventCounters {
+    uint32_t queued;
+    uint32_t coalesced;         ///< Merged into a pending entry
+    uint32_t superseded;        ///< Pending entries removed by a later safety event
+    uint32_t dropped;
+};
+
+/**
+ * @brief Two-lane event queue (single lock held by the owner)
+ *
+ * ## Usage
+ * @code
+ * MoaEventQueue queue;
+ * queue.push(cmd);                 // Producers
+ *
+ * ControlCommand next;
+ * while (queue.pop(next)) {        // Consumer: safety lane first
+ *     handle(next);
+ * }
+ * @endcode
+ */
+class MoaEventQueue {
+public:
+    MoaEventQueue();
+
+    /**
+     * @brief Queue or coalesce an event
+     */
+    MoaEventPushResult push(const ControlCommand& cmd);
+
+    /**
+     * @brief Take the oldest event of the highest-priority non-empty lane
+     * @return false if both lanes are empty
+     */
+    bool pop(ControlCommand& cmd);
+
+    /**
+     * @brief Pending events in a lane
+     */
+    uint8_t size(MoaEventLane lane) const;
+
+    /**
+     * @brief Pending events in both lanes
+     */
+    uint8_t size() const;
+
+    /**
+     * @brief Most events a lane has held at once since the last resetCounters()
+     */
+    uint8_t getHighWater(MoaEventLane lane) const;
+
+    const MoaEventCounters& getCounters(MoaEventSource source) const;
+
+    /**
+     * @brief Clear counters and high-water marks (pending events are kept)
+     */
+    void resetCounters();
+
+    /**
+     * @brief Lane an event goes to
+     */
+    static MoaEventLane laneOf(const ControlCommand& cmd);
+
+    /**
+     * @brief Producer of an event
+     */
+    static MoaEventSource sourceOf(const ControlCommand& cmd);
+
+    /**
+     * @brief true for sensor producers (temperature, battery, current)
+     */
+    static bool isCoalescable(const ControlCommand& cmd);
+
+    static const char* getSourceName(MoaEventSource source);
+
+private:
+    struct Lane {
+        ControlCommand* items;
+        uint8_t capacity;
+        uint8_t head;           ///< Oldest entry
+        uint8_t count;
+        uint8_t highWater;
+    };
+
+    ControlCommand _safetyItems[MOA_EVENT_SAFETY_DEPTH];
+    ControlCommand _normalItems[MOA_EVENT_NORMAL_DEPTH];
+    Lane _lanes[MOA_EVENT_LANE_COUNT];
+    MoaEventCounters _counters[MOA_EVENT_SOURCE_COUNT];
+
+    ControlCommand& at(Lane& lane, uint8_t index);
+
+    /**
+     * @brief Index (oldest = 0) of the newest entry from a producer, -1 if none
+     */
+    int newestFrom(Lane& lane, int controlType);
+
+    /**
+     * @brief Remove every entry from a producer, keeping the others in order
+     * @return Entries removed
+     */
+    uint8_t removeFrom(Lane& lane, int controlType);
+};
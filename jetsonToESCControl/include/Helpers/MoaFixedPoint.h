@@ -0,0 +1,95 @@
+/**
+ * @file MoaFixedPoint.h
+ * @brief Q16.16 linear conversion from raw ADC codes to integer units
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * The ESP32-C3 RISC-V core has no FPU, so every float division in the
+ * per-sample sensor path is a soft-float library call. Sensor calibration
+ * (reference voltage, ADC resolution, sensitivity, zero offset, divider
+ * ratio) is a linear map from raw code to engineering units, so it is
+ * folded once - when the configuration is applied - into an integer
+ * multiplier and offset. The per-sample cost is then one 32x32->64
+ * multiply, an add and a shift.
+ *
+ * Header-only and free of Arduino/FreeRTOS dependencies so it can be unit
+ * tested on the host (see test/native/test_fixed_point).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * @brief Fractional bits of the conversion gain
+ */
+#define MOA_FIXED_FRAC_BITS 16
+
+/**
+ * @brief Linear map y = raw * gain + offset with a Q16.16 gain
+ *
+ * Output units are whatever the gain and offset were folded for (mA, mV,
+ * ...). The offset is kept in output units rather than Q16.16 so that
+ * large offsets (e.g. -250000 mA for a mid-rail Hall sensor) fit in 32 bits.
+ *
+ * ## Usage Example
+ * @code
+ * // ACS759-200B on a 12-bit, 3.3 V ADC: mA = raw * 122.1 - 250000
+ * MoaFixedScale scale = MoaFixedScale::fromFloat(3300.0f / (4095.0f * 0.0066f),
+ *                                                -1.65f / 0.0066f * 1000.0f);
+ * int32_t mA = scale.apply(raw);
+ * @endcode
+ */
+struct MoaFixedScale {
+    int32_t gain;    ///< Output units per raw code, Q16.16
+    int32_t offset;  ///< Output units added after scaling
+
+    /**
+     * @brief Fold a float gain/offset into fixed point (configuration time only)
+     * @param gainPerCode Output units per raw code (|gain| < 32768)
+     * @param offsetUnits Output units at raw code 0
+     * @return MoaFixedScale Folded scale
+     */
+    static MoaFixedScale fromFloat(float gainPerCode, float offsetUnits) {
+        MoaFixedScale s;
+        s.gain = static_cast<int32_t>(lroundf(gainPerCode * static_cast<float>(1L << MOA_FIXED_FRAC_BITS)));
+        s.offset = static_cast<int32_t>(lroundf(offsetUnits));
+        return s;
+    }
+
+    /**
+     * @brief Convert a raw code (rounded to the nearest output unit)
+     * @param raw Raw ADC code
+     * @return int32_t Value in output units
+     */
+    int32_t apply(int32_t raw) const {
+        int64_t scaled = static_cast<int64_t>(raw) * gain + (1L << (MOA_FIXED_FRAC_BITS - 1));
+        return static_cast<int32_t>(scaled >> MOA_FIXED_FRAC_BITS) + offset;
+    }
+};
+
+/**
+ * @brief Integer division rounded half away from zero
+ *
+ * Used to derive the coarser event/stats units (A x10, degC x10) from the
+ * mA / centi-degC values without going through float.
+ *
+ * @param value Numerator
+ * @param divisor Positive divisor
+ * @return int32_t Rounded quotient
+ */
+inline int32_t moaDivRound(int32_t value, int32_t divisor) {
+    return (value >= 0) ? (value + divisor / 2) / divisor
+                        : (value - divisor / 2) / divisor;
+}
+
+/**
+ * @brief Convert a float quantity to integer units (configuration time only)
+ * @param value Value in base units (A, V, degC)
+ * @param unitsPerBase Scale to the integer unit (e.g. 1000 for mA)
+ * @return int32_t Rounded value in integer units
+ */
+inline int32_t moaToFixedUnits(float value, int32_t unitsPerBase) {
+    return static_cast<int32_t>(lroundf(value * static_cast<float>(unitsPerBase)));
+}
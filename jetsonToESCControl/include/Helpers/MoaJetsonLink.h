@@ -0,0 +1,108 @@
+/**
+ * @file MoaJetsonLink.h
+ * @brief Jetson companion link on a dedicated UART (framed binary protocol)
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Runs the MoaLinkSession over the ESP-IDF UART driver on
+ * MOA_LINK_UART_NUM. The driver's RX interrupt fills its ring buffer and
+ * posts a UART_DATA event when the line goes idle for MOA_LINK_RX_TIMEOUT
+ * symbols, so LinkTask sleeps on the event queue and wakes once per
+ * burst: no polling, and a throttle frame reaches ControlTask about
+ * 150 µs after its last byte.
+ *
+ * Requests become RemoteEvent pushes on the control event channel; the
+ * state machine decides what they do (arm from Init, throttle only once
+ * armed, disarm from anywhere). The ACK only says the request was queued.
+ * Telemetry is answered here from the stats aggregator snapshot and the
+ * ESC, without going through ControlTask. As a telemetry sink it also
+ * carries the TelemetryTask batches as MOA_LINK_MSG_STREAM frames.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "driver/uart.h"
+#include "MoaLinkProtocol.h"
+#include "MoaTelemetry.h"
+#include "MoaEventChannel.h"
+#include "MoaStatsAggregator.h"
+#include "ESCController.h"
+#include "MoaStateMachineWrapper.h"
+
+/**
+ * @brief Jetson link: UART driver, session and event channel glue
+ *
+ * ## Usage
+ * @code
+ * MoaJetsonLink link(events, esc, stats, stateMachine);
+ * link.begin();                           // Before LinkTask starts
+ *
+ * uart_event_t event;
+ * for (;;) {                              // LinkTask
+ *     if (link.waitEvent(event, portMAX_DELAY)) {
+ *         link.handleEvent(event);
+ *     }
+ * }
+ * @endcode
+ */
+class MoaJetsonLink : public IMoaLinkHandler, public IMoaTelemetrySink {
+public:
+    MoaJetsonLink(MoaEventChannel& events, ESCController& esc, MoaStatsAggregator& stats,
+                  MoaStateMachineWrapper& stateMachine);
+
+    /**
+     * @brief Install the UART driver with its event queue
+     * @return false if the driver could not be installed (the link stays down)
+     */
+    bool begin();
+
+    /**
+     * @brief Wait for the next UART driver event
+     * @param event Receives the event
+     * @param ticksToWait Longest wait (also slept when the link is down)
+     * @return true if an event arrived
+     */
+    bool waitEvent(uart_event_t& event, TickType_t ticksToWait);
+
+    /**
+     * @brief Process a UART event: decode received bytes, recover from overflow
+     */
+    void handleEvent(const uart_event_t& event);
+
+    /**
+     * @brief Link counters (protocol plus driver overflows)
+     */
+    MoaLinkStats getStats() const;
+
+    /**
+     * @brief UART events lost to a full RX buffer or FIFO
+     */
+    uint32_t getDriverOverflows() const;
+
+    void resetStats();
+
+    // === IMoaLinkHandler ===
+    uint8_t onThrottle(uint16_t duty) override;
+    uint8_t onArm() override;
+    uint8_t onDisarm() override;
+    void onTelemetry(MoaLinkTelemetry& out) override;
+    void writeLink(const uint8_t* data, size_t length) override;
+
+    // === IMoaTelemetrySink ===
+    bool sendTelemetry(const uint8_t* payload, size_t length) override;
+
+private:
+    MoaEventChannel& _events;
+    ESCController& _esc;
+    MoaStatsAggregator& _stats;
+    MoaStateMachineWrapper& _stateMachine;
+    MoaLinkSession _session;
+    QueueHandle_t _uartEvents;
+    uint32_t _driverOverflows;
+    uint8_t _streamSeq;                     ///< Seq of the next MOA_LINK_MSG_STREAM frame
+
+    uint8_t push(uint8_t command, uint16_t duty);
+};
@@ -0,0 +1,185 @@
+/**
+ * @file MoaLatencyTrace.h
+ * @brief Hop-by-hop latency of the control path, from input to PWM write
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Follows one input at a time through the firmware and timestamps every
+ * hop it passes, with esp_timer_get_time() (1 us):
+ *
+ *   button edge (ISR) -> processInterrupt -> push -+
+ *   sensor sample (SensorTask) -----------> push -+-> ControlTask receive
+ *   Jetson link frame (LinkTask) ---------> push -+
+ *       -> state handler -> setThrottleDuty -> first PWM write (first ramp step)
+ *   ADC drain (ProtectionTask) -> fast trip PWM write
+ *
+ * The time since the previous hop goes into that hop's histogram, the time
+ * since the origin into the origin's histogram when the PWM write closes
+ * the chain. Inputs that lead to no PWM write (a release edge, an event
+ * the state ignores) are dropped where they stop, and an input arriving
+ * while another is being followed is not traced - the histograms are a
+ * sample of the traffic, not a count of it.
+ *
+ * Every call is a few loads and stores behind a try-lock, safe from the
+ * button ISR and from any task; a call that finds the lock taken is
+ * skipped. The class itself takes timestamps as arguments and is free of
+ * Arduino/FreeRTOS dependencies (see test/native/test_latency_trace); the
+ * MOA_LATENCY_* macros add the clock and compile out with
+ * MOA_LATENCY_TRACE = 0.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include "Constants.h"
+
+/**
+ * @brief Histogram buckets: 0 us, then powers of two up to >= 2^(N-2) us
+ */
+#define MOA_LATENCY_BUCKETS     20
+
+/**
+ * @brief A chain still open after this long is abandoned by the next input (us)
+ */
+#define MOA_LATENCY_STALE_US    500000UL
+
+/**
+ * @brief Hops in path order; the first four are chain origins
+ */
+enum MoaLatencyHop : uint8_t {
+    MOA_HOP_BUTTON_EDGE = 0,    ///< MCP23018 INTA ISR (origin)
+    MOA_HOP_SENSOR_SAMPLE,      ///< SensorTask cycle start (origin)
+    MOA_HOP_ADC_DRAIN,          ///< ProtectionTask drain start (origin)
+    MOA_HOP_LINK_FRAME,         ///< Jetson link throttle frame decoded (origin)
+    MOA_HOP_PROCESS,            ///< MoaButtonControl::processInterrupt() in IOTask
+    MOA_HOP_PUSH,               ///< Event queued for ControlTask
+    MOA_HOP_RECEIVE,            ///< ControlTask dequeued an event
+    MOA_HOP_STATE,              ///< State machine handler entered
+    MOA_HOP_SET_DUTY,           ///< ESCController::setThrottleDuty()
+    MOA_HOP_PWM,                ///< ledcWrite() to the ESC (chain end)
+    MOA_HOP_COUNT,
+    MOA_HOP_ANY = MOA_HOP_COUNT ///< Any origin (mark() / release() filter)
+};
+
+/**
+ * @brief Log2 latency histogram with min / max / mean
+ */
+struct MoaLatencyHistogram {
+    uint32_t buckets[MOA_LATENCY_BUCKETS];  ///< [0] = 0 us, [b] = [2^(b-1), 2^b) us, last open-ended
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint64_t totalUs;
+
+    void clear();
+    void add(uint32_t us);
+    uint32_t meanUs() const;
+
+    /**
+     * @brief Upper bound of the given percentile (bucket resolution, capped at maxUs)
+     * @param percent 1..100
+     */
+    uint32_t percentileUs(uint8_t percent) const;
+
+    /**
+     * @brief First latency past a bucket (us), UINT32_MAX for the last one
+     */
+    static uint32_t bucketLimitUs(uint8_t bucket);
+};
+
+/**
+ * @brief Follows one input through the control path at a time
+ *
+ * ## Usage
+ * @code
+ * MOA_LATENCY_BEGIN(MOA_HOP_BUTTON_EDGE);                      // ISR
+ * MOA_LATENCY_MARK(MOA_HOP_PROCESS);                           // each hop
+ * MOA_LATENCY_RELEASE(MOA_HOP_BUTTON_EDGE, MOA_HOP_PUSH);      // no event? drop
+ *
+ * MoaLatencyHistogram h;
+ * if (g_moaLatencyTrace.getHistogram(MOA_HOP_PWM, h)) { ... }  // CLI
+ * @endcode
+ */
+class MoaLatencyTrace {
+public:
+    MoaLatencyTrace();
+
+    /**
+     * @brief Start following an input, unless one is already in flight
+     * @param origin MOA_HOP_BUTTON_EDGE, MOA_HOP_SENSOR_SAMPLE, MOA_HOP_ADC_DRAIN or MOA_HOP_LINK_FRAME
+     */
+    void begin(MoaLatencyHop origin, uint32_t nowUs);
+
+    /**
+     * @brief Record a hop of the chain in flight
+     *
+     * Ignored when no chain is in flight, when it started at a different
+     * origin than `from`, or when it already passed this hop. MOA_HOP_PWM
+     * closes the chain.
+     */
+    void mark(MoaLatencyHop hop, uint32_t nowUs, MoaLatencyHop from = MOA_HOP_ANY);
+
+    /**
+     * @brief Drop the chain from `origin` if it has not reached `needed`
+     *
+     * Called where an input may stop without a PWM write.
+     */
+    void release(MoaLatencyHop origin, MoaLatencyHop needed);
+
+    /**
+     * @brief Copy a histogram: per hop, or end-to-end for an origin
+     * @return false if the trace was busy (retry)
+     */
+    bool getHistogram(MoaLatencyHop hop, MoaLatencyHistogram& out) const;
+
+    /**
+     * @brief Chains followed to a PWM write / dropped after their first hop, since reset
+     */
+    uint32_t getCompletedCount() const;
+    uint32_t getDroppedCount() const;
+
+    /**
+     * @brief Clear every histogram and the chain in flight
+     * @return false if the trace was busy (retry)
+     */
+    bool reset();
+
+    /**
+     * @brief Short name for the CLI ("edge", "process", ...)
+     */
+    static const char* getHopName(MoaLatencyHop hop);
+
+private:
+    mutable std::atomic_flag _busy;             ///< Try-lock, ISR safe
+    bool _active;                               ///< A chain is in flight
+    MoaLatencyHop _origin;
+    MoaLatencyHop _lastHop;
+    uint32_t _originUs;
+    uint32_t _lastUs;
+    uint32_t _completed;
+    uint32_t _dropped;
+    MoaLatencyHistogram _histograms[MOA_HOP_COUNT];  ///< Origins hold end-to-end latency
+
+    bool tryLock() const;
+    void unlock() const;
+};
+
+/**
+ * @brief The firmware's trace (ISR access, like g_moaButtonControlInstance)
+ */
+extern MoaLatencyTrace g_moaLatencyTrace;
+
+#if MOA_LATENCY_TRACE
+#include "esp_timer.h"
+#define MOA_LATENCY_NOW()                   static_cast<uint32_t>(esp_timer_get_time())
+#define MOA_LATENCY_BEGIN(origin)           g_moaLatencyTrace.begin((origin), MOA_LATENCY_NOW())
+#define MOA_LATENCY_MARK(hop)               g_moaLatencyTrace.mark((hop), MOA_LATENCY_NOW())
+#define MOA_LATENCY_MARK_FROM(origin, hop)  g_moaLatencyTrace.mark((hop), MOA_LATENCY_NOW(), (origin))
+#define MOA_LATENCY_RELEASE(origin, needed) g_moaLatencyTrace.release((origin), (needed))
+#else
+#define MOA_LATENCY_BEGIN(origin)           ((void)0)
+#define MOA_LATENCY_MARK(hop)               ((void)0)
+#define MOA_LATENCY_MARK_FROM(origin, hop)  ((void)0)
+#define MOA_LATENCY_RELEASE(origin, needed) ((void)0)
+#endif
@@ -0,0 +1,251 @@
+/**
+ * @file MoaLinkProtocol.h
+ * @brief Framed binary protocol of the Jetson companion link (COBS, CRC16, sequence numbers)
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Every frame is COBS-encoded and followed by a 0x00 delimiter, so the
+ * receiver resynchronises on the next zero after any line error. Decoded,
+ * a frame is:
+ *
+ *   seq (1) | type (1) | payload (0..MOA_LINK_MAX_PAYLOAD) | crc16 (2, LE)
+ *
+ * crc16 is CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over seq..payload.
+ * The host numbers its requests and the board answers each one with the
+ * request's seq. A request repeated with the same seq and type (a retry
+ * after a lost reply) is answered again but not executed twice, unless it
+ * was turned away BUSY: then the retry is executed.
+ *
+ * | Request (host -> board) | Payload          | Reply                         |
+ * |-------------------------|------------------|-------------------------------|
+ * | MOA_LINK_MSG_PING       | -                | ACK                           |
+ * | MOA_LINK_MSG_THROTTLE   | u16 duty, 10-bit | ACK                           |
+ * | MOA_LINK_MSG_ARM        | -                | ACK                           |
+ * | MOA_LINK_MSG_DISARM     | -                | ACK                           |
+ * | MOA_LINK_MSG_TELEMETRY  | -                | TELEMETRY (MoaLinkTelemetry)  |
+ *
+ * The board also sends MOA_LINK_MSG_STREAM frames unprompted: batches of
+ * sensor readings (MoaTelemetry.h) numbered by their own seq counter, so
+ * a gap shows a lost batch. They are never ACKed.
+ *
+ * Multi-byte fields are little-endian, as on both ends. Free of
+ * Arduino/FreeRTOS dependencies: MoaJetsonLink feeds it from the UART
+ * driver, the host test from a pseudo-terminal (test/native/test_link_protocol).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Largest payload of a frame (bytes)
+ */
+#define MOA_LINK_MAX_PAYLOAD    64
+
+/**
+ * @brief Largest decoded frame: seq, type, payload, crc16
+ */
+#define MOA_LINK_MAX_FRAME      (2 + MOA_LINK_MAX_PAYLOAD + 2)
+
+/**
+ * @brief Largest frame on the wire: COBS overhead byte plus the delimiter
+ */
+#define MOA_LINK_MAX_ENCODED    (MOA_LINK_MAX_FRAME + 2)
+
+// =============================================================================
+// Message types
+// =============================================================================
+
+#define MOA_LINK_MSG_PING       0x01
+#define MOA_LINK_MSG_THROTTLE   0x02
+#define MOA_LINK_MSG_ARM        0x03
+#define MOA_LINK_MSG_DISARM     0x04
+#define MOA_LINK_MSG_TELEMETRY  0x05
+
+#define MOA_LINK_REPLY          0x80    ///< Set in every board -> host type
+#define MOA_LINK_MSG_ACK        (MOA_LINK_REPLY | 0x00)
+#define MOA_LINK_MSG_TELEMETRY_REPLY (MOA_LINK_REPLY | MOA_LINK_MSG_TELEMETRY)
+#define MOA_LINK_MSG_STREAM     (MOA_LINK_REPLY | 0x06)     ///< Telemetry batch, unsolicited
+
+// =============================================================================
+// ACK status (payload of MOA_LINK_MSG_ACK)
+// =============================================================================
+
+#define MOA_LINK_STATUS_OK          0   ///< Accepted (queued to the state machine)
+#define MOA_LINK_STATUS_BUSY        1   ///< Event channel full, retry (same seq: executed again)
+#define MOA_LINK_STATUS_BAD_LENGTH  2   ///< Payload size does not match the type
+#define MOA_LINK_STATUS_UNKNOWN     3   ///< Unknown message type
+
+// =============================================================================
+// Telemetry
+// =============================================================================
+
+#define MOA_LINK_FLAG_TRIPPED   0x01    ///< Fast overcurrent latch set
+#define MOA_LINK_FLAG_RAMPING   0x02    ///< ESC ramp in progress
+
+/**
+ * @brief Payload of MOA_LINK_MSG_TELEMETRY_REPLY
+ */
+struct __attribute__((packed)) MoaLinkTelemetry {
+    uint8_t state;              ///< MoaStateId
+    uint8_t flags;              ///< MOA_LINK_FLAG_*
+    uint16_t escDuty;           ///< Duty on the wire (PWM counts, ESC_PWM_RESOLUTION)
+    uint16_t battMillivolts;    ///< Averaged pack voltage
+    int16_t currentDeciAmps;    ///< Averaged current x10
+    int16_t tempDeciCelsius;    ///< Averaged temperature x10
+    uint32_t uptimeMs;
+};
+
+static_assert(sizeof(MoaLinkTelemetry) == 14, "MoaLinkTelemetry is part of the wire format");
+
+/**
+ * @brief One decoded frame
+ */
+struct MoaLinkFrame {
+    uint8_t seq;
+    uint8_t type;                           ///< MOA_LINK_MSG_*
+    uint8_t length;                         ///< Payload bytes
+    uint8_t payload[MOA_LINK_MAX_PAYLOAD];
+};
+
+/**
+ * @brief Link counters since boot or the last reset
+ */
+struct MoaLinkStats {
+    uint32_t frames;            ///< Valid frames received
+    uint32_t crcErrors;         ///< Frames dropped on a CRC mismatch
+    uint32_t framingErrors;     ///< Frames dropped on bad COBS or a short frame
+    uint32_t overruns;          ///< Frames dropped for being too long
+    uint32_t duplicates;        ///< Retries answered without executing
+    uint32_t seqGaps;           ///< Requests whose seq skipped at least one number
+    uint32_t rejected;          ///< Requests answered with a non-OK status
+};
+
+/**
+ * @brief Frame encoding: CRC16 and COBS (stateless)
+ */
+class MoaLinkCodec {
+public:
+    /**
+     * @brief CRC-16/CCITT-FALSE
+     */
+    static uint16_t crc16(const uint8_t* data, size_t length);
+
+    /**
+     * @brief COBS-encode a block (no delimiter)
+     * @param out At least length + length / 254 + 1 bytes
+     * @return Encoded size
+     */
+    static size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out);
+
+    /**
+     * @brief Decode a COBS block (without its delimiter)
+     * @param out At least length bytes
+     * @return Decoded size, 0 if the block is not valid COBS
+     */
+    static size_t cobsDecode(const uint8_t* in, size_t length, uint8_t* out);
+
+    /**
+     * @brief Build a complete frame, delimiter included
+     * @param out Output buffer (MOA_LINK_MAX_ENCODED is always enough)
+     * @return Bytes to send, 0 if the payload or the buffer is too large
+     */
+    static size_t encodeFrame(uint8_t seq, uint8_t type, const uint8_t* payload, uint8_t length,
+                              uint8_t* out, size_t capacity);
+};
+
+/**
+ * @brief Reassembles frames from a byte stream
+ *
+ * Bytes are pushed as they arrive; a frame is checked when its delimiter
+ * comes in. A bad frame is counted and dropped, the next one is unaffected.
+ */
+class MoaLinkDecoder {
+public:
+    MoaLinkDecoder();
+
+    /**
+     * @brief Drop a partly received frame
+     */
+    void reset();
+
+    /**
+     * @brief Feed one byte
+     * @param frame Filled when the byte completes a valid frame
+     * @return true if frame holds a new frame
+     */
+    bool push(uint8_t byte, MoaLinkFrame& frame);
+
+    uint32_t getCrcErrors() const;
+    uint32_t getFramingErrors() const;
+    uint32_t getOverruns() const;
+    void resetCounters();
+
+private:
+    uint8_t _buffer[MOA_LINK_MAX_ENCODED];  ///< Encoded bytes since the last delimiter
+    size_t _length;
+    bool _overrun;                          ///< Frame too long: skip to the next delimiter
+    uint32_t _crcErrors;
+    uint32_t _framingErrors;
+    uint32_t _overruns;
+};
+
+/**
+ * @brief What the board does with requests (implemented by MoaJetsonLink)
+ */
+class IMoaLinkHandler {
+public:
+    virtual ~IMoaLinkHandler() {}
+
+    /**
+     * @brief Throttle setpoint
+     * @param duty 10-bit duty (0 = stop)
+     * @return MOA_LINK_STATUS_*
+     */
+    virtual uint8_t onThrottle(uint16_t duty) = 0;
+    virtual uint8_t onArm() = 0;
+    virtual uint8_t onDisarm() = 0;
+    virtual void onTelemetry(MoaLinkTelemetry& out) = 0;
+
+    /**
+     * @brief Send encoded bytes to the host
+     */
+    virtual void writeLink(const uint8_t* data, size_t length) = 0;
+};
+
+/**
+ * @brief Board side of the link: decode, deduplicate, dispatch, reply
+ *
+ * ## Usage
+ * @code
+ * MoaLinkSession session(handler);
+ * // For each chunk read from the UART:
+ * session.receive(buffer, length);
+ * @endcode
+ */
+class MoaLinkSession {
+public:
+    explicit MoaLinkSession(IMoaLinkHandler& handler);
+
+    /**
+     * @brief Process received bytes (any chunking); replies go to handler.writeLink()
+     */
+    void receive(const uint8_t* data, size_t length);
+
+    MoaLinkStats getStats() const;
+    void resetStats();
+
+private:
+    IMoaLinkHandler& _handler;
+    MoaLinkDecoder _decoder;
+    MoaLinkStats _stats;        ///< Session counters (decoder errors are added in getStats())
+    bool _hasLast;              ///< A request has been executed
+    uint8_t _lastSeq;
+    uint8_t _lastType;
+    uint8_t _lastStatus;
+
+    void handle(const MoaLinkFrame& frame);
+    uint8_t execute(const MoaLinkFrame& frame);
+    void reply(uint8_t seq, uint8_t type, const uint8_t* payload, uint8_t length);
+};
@@ -0,0 +1,98 @@
+/**
+ * @file MoaLogCodes.h
+ * @brief Event type and code catalogue for MoaFlashLog entries
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Shared by MoaFlashLog (producer) and MoaLogExporter (verbose names), and
+ * free of Arduino dependencies so the exporter can be tested on the host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Log event types (categories)
+ */
+enum MoaLogType : uint8_t {
+    LOG_TYPE_SYSTEM     = 0x00,   ///< System events (boot, shutdown, config)
+    LOG_TYPE_BUTTON     = 0x10,   ///< Button events
+    LOG_TYPE_TEMP       = 0x20,   ///< Temperature events
+    LOG_TYPE_BATT       = 0x30,   ///< Battery events
+    LOG_TYPE_CURRENT    = 0x40,   ///< Current events
+    LOG_TYPE_STATE      = 0x50,   ///< State machine transitions
+    LOG_TYPE_ERROR      = 0xF0    ///< Errors and failures
+};
+
+/**
+ * @brief System event codes (LOG_TYPE_SYSTEM)
+ */
+enum MoaLogSystemCode : uint8_t {
+    LOG_SYS_BOOT            = 0x01,   ///< System boot
+    LOG_SYS_SHUTDOWN        = 0x02,   ///< Graceful shutdown
+    LOG_SYS_CONFIG_ENTER    = 0x03,   ///< Entered config mode
+    LOG_SYS_CONFIG_EXIT     = 0x04,   ///< Exited config mode
+    LOG_SYS_WATCHDOG_RESET  = 0x05    ///< Watchdog triggered reset
+};
+
+/**
+ * @brief Button event codes (LOG_TYPE_BUTTON)
+ */
+enum MoaLogButtonCode : uint8_t {
+    LOG_BTN_STOP_PRESS      = 0x01,
+    LOG_BTN_STOP_LONG       = 0x02,
+    LOG_BTN_25_PRESS        = 0x03,
+    LOG_BTN_50_PRESS        = 0x04,
+    LOG_BTN_75_PRESS        = 0x05,
+    LOG_BTN_100_PRESS       = 0x06
+};
+
+/**
+ * @brief Temperature event codes (LOG_TYPE_TEMP)
+ */
+enum MoaLogTempCode : uint8_t {
+    LOG_TEMP_CROSSED_ABOVE  = 0x01,   ///< Temperature crossed above threshold
+    LOG_TEMP_CROSSED_BELOW  = 0x02,   ///< Temperature crossed below threshold
+    LOG_TEMP_OVERHEAT       = 0x03    ///< Critical overheat (immediate flush)
+};
+
+/**
+ * @brief Battery event codes (LOG_TYPE_BATT)
+ */
+enum MoaLogBattCode : uint8_t {
+    LOG_BATT_HIGH           = 0x01,
+    LOG_BATT_MEDIUM         = 0x02,
+    LOG_BATT_LOW            = 0x03    ///< Critical low battery (immediate flush)
+};
+
+/**
+ * @brief Current event codes (LOG_TYPE_CURRENT)
+ */
+enum MoaLogCurrentCode : uint8_t {
+    LOG_CURRENT_NORMAL      = 0x01,
+    LOG_CURRENT_OVERCURRENT = 0x02,   ///< Critical overcurrent (immediate flush)
+    LOG_CURRENT_REVERSE     = 0x03    ///< Critical reverse overcurrent (immediate flush)
+};
+
+/**
+ * @brief State machine event codes (LOG_TYPE_STATE)
+ */
+enum MoaLogStateCode : uint8_t {
+    LOG_STATE_TO_INIT       = 0x01,
+    LOG_STATE_TO_IDLE       = 0x02,
+    LOG_STATE_TO_SURFING    = 0x03,
+    LOG_STATE_TO_OVERHEAT   = 0x04,
+    LOG_STATE_TO_OVERCURRENT= 0x05,
+    LOG_STATE_TO_BATT_LOW   = 0x06
+};
+
+/**
+ * @brief Error event codes (LOG_TYPE_ERROR)
+ */
+enum MoaLogErrorCode : uint8_t {
+    LOG_ERR_I2C_FAIL        = 0x01,   ///< I2C communication failure
+    LOG_ERR_SENSOR_FAIL     = 0x02,   ///< Sensor read failure
+    LOG_ERR_FLASH_FAIL      = 0x03,   ///< Flash write failure
+    LOG_ERR_QUEUE_FULL      = 0x04    ///< Event queue overflow
+};
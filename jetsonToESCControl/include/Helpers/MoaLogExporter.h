@@ -0,0 +1,181 @@
+/**
+ * @file MoaLogExporter.h
+ * @brief Streaming, allocation-free export of log entries
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Formats log entries as JSON, CSV or a compact binary form into a
+ * fixed-size chunk buffer and hands each full chunk to an ILogSink. Peak
+ * memory is the exporter itself (~150 bytes) whatever the log size, and
+ * nothing is allocated on the heap.
+ *
+ * The JSON output is byte-for-byte the document the previous String-based
+ * MoaFlashLog::toJson() / toJsonVerbose() produced.
+ *
+ * ## Binary Format (little-endian)
+ * | Field   | Size        | Description                                  |
+ * |---------|-------------|----------------------------------------------|
+ * | header  | 12 bytes    | MoaLogExportHeader (magic, version, count)   |
+ * | entries | count × 8   | MoaLogEntry, oldest first                    |
+ * | crc     | 2 bytes     | CRC-16/CCITT-FALSE of the entry bytes        |
+ *
+ * Free of Arduino dependencies so it can be unit tested on the host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ILogSink.h"
+#include "MoaLogJournal.h"
+
+/**
+ * @brief Bytes buffered before each sink write
+ */
+#ifndef MOA_LOG_EXPORT_CHUNK_SIZE
+#define MOA_LOG_EXPORT_CHUNK_SIZE 128
+#endif
+
+/**
+ * @brief Binary export magic ("MOAX" little-endian)
+ */
+#define MOA_LOG_EXPORT_MAGIC 0x58414F4DUL
+
+/**
+ * @brief Binary export format version
+ */
+#define MOA_LOG_EXPORT_VERSION 1
+
+/**
+ * @brief Export output format
+ */
+enum class MoaLogExportFormat : uint8_t {
+    JSON,           ///< {"count":N,"entries":[{"t":..,"type":..,"code":..,"val":..},..]}
+    JSON_VERBOSE,   ///< Same with type/code names instead of numbers
+    CSV,            ///< t,type,code,val,type_name,code_name (one row per entry)
+    BINARY          ///< MoaLogExportHeader + raw entries + CRC16
+};
+
+/**
+ * @brief Binary export header (12 bytes)
+ */
+struct MoaLogExportHeader {
+    uint32_t magic;         ///< MOA_LOG_EXPORT_MAGIC
+    uint8_t version;        ///< MOA_LOG_EXPORT_VERSION
+    uint8_t entrySize;      ///< sizeof(MoaLogEntry)
+    uint16_t reserved;      ///< Zero
+    uint32_t count;         ///< Number of entries that follow
+} __attribute__((packed));
+
+/**
+ * @brief Chunked log formatter
+ *
+ * Call begin() with the number of entries, add() each entry oldest first,
+ * then end(). Exactly `count` entries must be added.
+ *
+ * ## Usage Example
+ * @code
+ * MoaLogExporter exporter(sink, MoaLogExportFormat::JSON);
+ * exporter.begin(count);
+ * for (size_t i = 0; i < count; i++) exporter.add(entries[i]);
+ * bool ok = exporter.end();
+ * @endcode
+ */
+class MoaLogExporter {
+public:
+    /**
+     * @brief Construct an exporter
+     * @param sink Destination (not owned)
+     * @param format Output format
+     */
+    MoaLogExporter(ILogSink& sink, MoaLogExportFormat format);
+
+    /**
+     * @brief Write the document header
+     * @param count Number of entries that will be added
+     */
+    void begin(uint32_t count);
+
+    /**
+     * @brief Format one entry
+     * @param entry Entry (oldest first)
+     */
+    void add(const MoaLogEntry& entry);
+
+    /**
+     * @brief Write the document trailer and flush the last chunk
+     * @return true if the sink accepted every byte
+     */
+    bool end();
+
+    /**
+     * @brief True once the sink has refused a chunk (further output is dropped)
+     */
+    bool hasFailed() const;
+
+    /**
+     * @brief Bytes accepted by the sink so far
+     */
+    uint32_t getBytesWritten() const;
+
+    /**
+     * @brief Export a contiguous array of entries in one call
+     * @param sink Destination
+     * @param format Output format
+     * @param entries Entries, oldest first
+     * @param count Number of entries
+     * @return true if the sink accepted every byte
+     */
+    static bool exportEntries(ILogSink& sink, MoaLogExportFormat format,
+                              const MoaLogEntry* entries, size_t count);
+
+    /**
+     * @brief Name of an event type (MoaLogType)
+     * @param type Event type
+     * @return const char* Type name, "UNKNOWN" if not catalogued
+     */
+    static const char* getTypeName(uint8_t type);
+
+    /**
+     * @brief Name of an event code within its type
+     * @param type Event type
+     * @param code Event code
+     * @return const char* Code name, "?" if not catalogued
+     */
+    static const char* getCodeName(uint8_t type, uint8_t code);
+
+private:
+    ILogSink& _sink;
+    MoaLogExportFormat _format;
+    uint8_t _buffer[MOA_LOG_EXPORT_CHUNK_SIZE];    ///< Pending chunk
+    size_t _fill;                                  ///< Bytes in _buffer
+    uint32_t _index;                               ///< Entries added
+    uint32_t _bytesWritten;                        ///< Bytes accepted by the sink
+    uint16_t _crc;                                 ///< Running CRC (binary format)
+    bool _failed;                                  ///< Sink refused a chunk
+
+    /**
+     * @brief Append bytes, handing full chunks to the sink
+     */
+    void put(const void* data, size_t length);
+
+    /**
+     * @brief Append a NUL-terminated string
+     */
+    void putString(const char* text);
+
+    /**
+     * @brief Append a signed decimal number
+     */
+    void putNumber(int32_t value);
+
+    /**
+     * @brief Append an unsigned decimal number
+     */
+    void putUnsigned(uint32_t value);
+
+    /**
+     * @brief Hand the buffered chunk to the sink
+     */
+    void flushChunk();
+};
@@ -0,0 +1,213 @@
+/**
+ * @file MoaLogJournal.h
+ * @brief Segmented, append-only on-flash format for MoaFlashLog
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * The log is stored as MOA_LOG_SEGMENT_COUNT segment files used as a ring.
+ * Each segment starts with a CRC-protected header carrying a monotonically
+ * increasing sequence number, followed by fixed-size records that each
+ * carry their own CRC. A flush appends only the new records (10 bytes per
+ * event) to the newest segment; when it is full, the oldest segment is
+ * recreated as the next one. Nothing already on flash is ever rewritten,
+ * so a power cut can at worst tear the records being appended.
+ *
+ * On boot, begin() scans the segment headers, orders the valid segments by
+ * sequence and validates records up to the first bad CRC or short record.
+ * A segment with a torn tail is sealed; the next append opens a fresh one.
+ *
+ * ## Segment File Format (/moa_log.N)
+ * | Field      | Size     | Description                                  |
+ * |------------|----------|----------------------------------------------|
+ * | header     | 16 bytes | MoaLogSegmentHeader (magic, sequence, CRC16) |
+ * | record 0.. | 10 bytes | MoaLogEntry + CRC16 (seeded with sequence)   |
+ *
+ * Free of Arduino dependencies so it can be unit tested on the host
+ * against SimulatedLogStorage (see test/native/test_log_journal).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ILogStorage.h"
+
+/**
+ * @brief Number of segment files in the ring
+ */
+#define MOA_LOG_SEGMENT_COUNT 4
+
+/**
+ * @brief Records per segment (3 full segments keep >= 192 entries)
+ */
+#define MOA_LOG_SEGMENT_RECORDS 64
+
+/**
+ * @brief Segment header magic ("MOAL" little-endian)
+ */
+#define MOA_LOG_SEGMENT_MAGIC 0x4C414F4DUL
+
+/**
+ * @brief On-flash format version
+ */
+#define MOA_LOG_FORMAT_VERSION 1
+
+/**
+ * @brief Default segment path prefix (segments are "<base>.0" .. "<base>.N")
+ */
+#define MOA_LOG_DEFAULT_BASENAME "/moa_log"
+
+/**
+ * @brief Log entry structure (8 bytes)
+ */
+struct MoaLogEntry {
+    uint32_t timestamp;    ///< millis() at event time
+    uint8_t type;          ///< Event type (MoaLogType)
+    uint8_t code;          ///< Event code within type
+    int16_t value;         ///< Associated value
+} __attribute__((packed));
+
+/**
+ * @brief Segment header (16 bytes)
+ */
+struct MoaLogSegmentHeader {
+    uint32_t magic;            ///< MOA_LOG_SEGMENT_MAGIC
+    uint8_t version;           ///< MOA_LOG_FORMAT_VERSION
+    uint8_t recordSize;        ///< sizeof(MoaLogRecord)
+    uint16_t recordsPerSegment;///< MOA_LOG_SEGMENT_RECORDS when written
+    uint32_t sequence;         ///< Segment sequence (newest = highest)
+    uint16_t reserved;         ///< Zero
+    uint16_t crc;              ///< CRC16 of the preceding 14 bytes
+} __attribute__((packed));
+
+/**
+ * @brief On-flash record (10 bytes)
+ */
+struct MoaLogRecord {
+    MoaLogEntry entry;         ///< Logged event
+    uint16_t crc;              ///< CRC16 of entry, seeded with the segment sequence
+} __attribute__((packed));
+
+/**
+ * @brief Append-only segmented log store
+ *
+ * ## Usage Example
+ * @code
+ * LittleFsLogStorage storage;
+ * MoaLogJournal journal(&storage);
+ * journal.begin();                          // scan + recover
+ * journal.append(newEntries, count);        // only the new records hit flash
+ * size_t n = journal.readNewest(buf, 128);  // oldest-first
+ * @endcode
+ */
+class MoaLogJournal {
+public:
+    /**
+     * @brief Construct a journal on a storage backend
+     * @param storage Storage backend (not owned)
+     * @param basePath Segment path prefix
+     */
+    MoaLogJournal(ILogStorage* storage, const char* basePath = MOA_LOG_DEFAULT_BASENAME);
+
+    /**
+     * @brief Mount the storage and recover the segment ring
+     * @return true if the storage is usable (an empty or corrupt log still succeeds)
+     */
+    bool begin();
+
+    /**
+     * @brief Append entries, rotating segments as they fill
+     *
+     * @param entries Entries in chronological order
+     * @param count Number of entries
+     * @return size_t Entries committed to flash (< count on a write failure)
+     */
+    size_t append(const MoaLogEntry* entries, size_t count);
+
+    /**
+     * @brief Read the newest entries on flash, oldest first
+     * @param out Destination
+     * @param maxEntries Capacity of out
+     * @return size_t Entries read
+     */
+    size_t readNewest(MoaLogEntry* out, size_t maxEntries);
+
+    /**
+     * @brief Delete all segments
+     * @return true if every segment file was removed
+     */
+    bool clear();
+
+    /**
+     * @brief Valid records currently on flash
+     * @return uint32_t Record count across all segments
+     */
+    uint32_t getRecordCount() const;
+
+    /**
+     * @brief Valid segments currently on flash
+     * @return uint8_t Segment count
+     */
+    uint8_t getSegmentCount() const;
+
+    /**
+     * @brief Bytes written to storage since construction
+     * @return uint32_t Header and record bytes
+     */
+    uint32_t getBytesWritten() const;
+
+    /**
+     * @brief Records dropped by recovery (bad CRC or torn tail)
+     * @return uint32_t Discarded records, counting a partial record as one
+     */
+    uint32_t getDiscardedRecords() const;
+
+    /**
+     * @brief CRC-16/CCITT-FALSE
+     * @param data Bytes
+     * @param length Number of bytes
+     * @param seed Initial value
+     * @return uint16_t CRC
+     */
+    static uint16_t crc16(const uint8_t* data, size_t length, uint16_t seed = 0xFFFF);
+
+private:
+    /**
+     * @brief RAM view of one segment slot
+     */
+    struct Segment {
+        bool valid;          ///< Header is valid
+        bool sealed;         ///< Torn tail or write failure - no more appends
+        uint16_t records;    ///< Valid records
+        uint32_t sequence;   ///< Header sequence
+    };
+
+    ILogStorage* _storage;
+    const char* _basePath;
+    Segment _segments[MOA_LOG_SEGMENT_COUNT];
+    int8_t _current;             ///< Slot being appended to, -1 if none
+    uint32_t _bytesWritten;
+    uint32_t _discarded;
+    char _path[32];              ///< Scratch for segment paths
+
+    /**
+     * @brief Build the path of a segment slot into _path
+     */
+    const char* pathFor(uint8_t slot);
+
+    /**
+     * @brief Seed for record CRCs of a segment
+     */
+    static uint16_t recordSeed(uint32_t sequence);
+
+    /**
+     * @brief Validate one slot's header and records
+     */
+    void scanSegment(uint8_t slot);
+
+    /**
+     * @brief Start the next segment over the oldest slot
+     * @return true if the new header was written
+     */
+    bool rotate();
+};
@@ -16,10 +16,12 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
 
 #include "PinMapping.h"
 #include "Constants.h"
 #include "ControlCommand.h"
+#include "MoaEventChannel.h"
 
 #include "MoaMcpDevice.h"
 #include "MoaTempControl.h"
@@ -27,25 +29,28 @@
 #include "Ds18b20TemperatureSensor.h"
 #include "MoaBattControl.h"
 #include "MoaCurrentControl.h"
+#include "MoaAdcSampler.h"
+#include "EspAdcDmaSource.h"
 #include "MoaButtonControl.h"
 #include "MoaLedControl.h"
 #include "MoaFlashLog.h"
+#include "LittleFsLogStorage.h"
 #include "ESCController.h"
 
 #include "MoaDevicesManager.h"
 #include "MoaStateMachineWrapper.h"
 #include "MoaStatsAggregator.h"
+#include "MoaTaskProfiler.h"
+#include "MoaTaskMonitor.h"
 #include "ConfigManager.h"
 #include "UartCli.h"
 #include "MoaWiFiManager.h"
 #include "MoaOTAManager.h"
+#include "MoaJetsonLink.h"
+#include "MoaTelemetry.h"
+#include "MoaTelemetryUdpSink.h"
 #include "StatsReading.h"
 
-/**
- * @brief Event queue size (number of ControlCommand items)
- */
-#define EVENT_QUEUE_SIZE 16
-
 /**
  * @brief Stats queue size (number of StatsReading items)
  */
@@ -54,22 +59,28 @@
 /**
  * @brief Task stack sizes in bytes
  */
+#define TASK_STACK_PROTECTION 3072
 #define TASK_STACK_SENSOR   4096
 #define TASK_STACK_IO       4096
 #define TASK_STACK_CONTROL  4096
-#define TASK_STACK_STATS    2048
+#define TASK_STACK_STATS    3072
 #define TASK_STACK_CLI      3072
 #define TASK_STACK_OTA      4096
+#define TASK_STACK_LINK     3072
+#define TASK_STACK_TELEMETRY 3072
 
 /**
  * @brief Task priorities (higher = more priority)
  */
+#define TASK_PRIORITY_PROTECTION 4
 #define TASK_PRIORITY_SENSOR    3
 #define TASK_PRIORITY_IO        2
 #define TASK_PRIORITY_CONTROL   2
 #define TASK_PRIORITY_STATS     1
 #define TASK_PRIORITY_CLI       1
 #define TASK_PRIORITY_OTA       1
+#define TASK_PRIORITY_LINK      3
+#define TASK_PRIORITY_TELEMETRY 1
 
 /**
  * @brief Central coordinator for Moa ESC Controller
@@ -118,10 +129,10 @@ public:
     // === Accessors for FreeRTOS tasks ===
 
     /**
-     * @brief Get the event queue handle
-     * @return QueueHandle_t Event queue
+     * @brief Get the control event channel
+     * @return MoaEventChannel& Events for ControlTask
      */
-    QueueHandle_t getEventQueue();
+    MoaEventChannel& getEventChannel();
 
     /**
      * @brief Get reference to temperature control
@@ -141,6 +152,12 @@ public:
      */
     MoaCurrentControl& getCurrentControl();
 
+    /**
+     * @brief Get reference to the continuous ADC sampler
+     * @return MoaAdcSampler& Block sampler feeding current and battery sensing
+     */
+    MoaAdcSampler& getAdcSampler();
+
     /**
      * @brief Get reference to button control
      * @return MoaButtonControl& Button input producer
@@ -171,6 +188,12 @@ public:
      */
     QueueHandle_t getStatsQueue();
 
+    /**
+     * @brief Get reference to the configuration
+     * @return ConfigManager& Live settings
+     */
+    ConfigManager& getConfig();
+
     /**
      * @brief Get reference to stats aggregator
      * @return MoaStatsAggregator& Stats aggregator
@@ -183,6 +206,12 @@ public:
      */
     MoaDevicesManager& getDevicesManager();
 
+    /**
+     * @brief Get reference to the task profiler
+     * @return MoaTaskProfiler& Loop timing recorder for every task
+     */
+    MoaTaskProfiler& getTaskProfiler();
+
     /**
      * @brief Get reference to UART CLI
      * @return UartCli& UART command-line interface
@@ -195,16 +224,44 @@ public:
      */
     MoaOTAManager& getOTAManager();
 
+    /**
+     * @brief Get reference to the Jetson link
+     * @return MoaJetsonLink& Framed binary link on MOA_LINK_UART_NUM
+     */
+    MoaJetsonLink& getJetsonLink();
+
+    /**
+     * @brief Get reference to the telemetry stream
+     * @return MoaTelemetryStream& Batches fed by StatsTask, drained by TelemetryTask
+     */
+    MoaTelemetryStream& getTelemetryStream();
+
+    /**
+     * @brief Get the semaphore StatsTask gives when a telemetry batch is sealed
+     * @return SemaphoreHandle_t Binary semaphore taken by TelemetryTask
+     */
+    SemaphoreHandle_t getTelemetrySignal();
+
+    /**
+     * @brief Get the telemetry sink selected by the config (tlm_sink)
+     * @return IMoaTelemetrySink& Jetson link or UDP
+     */
+    IMoaTelemetrySink& getTelemetrySink();
+
 private:
     // === FreeRTOS resources ===
-    QueueHandle_t _eventQueue;
+    MoaEventChannel _eventChannel;
     QueueHandle_t _statsQueue;
+    SemaphoreHandle_t _telemetrySignal;
+    TaskHandle_t _protectionTaskHandle;
     TaskHandle_t _sensorTaskHandle;
     TaskHandle_t _ioTaskHandle;
     TaskHandle_t _controlTaskHandle;
     TaskHandle_t _statsTaskHandle;
     TaskHandle_t _cliTaskHandle;
     TaskHandle_t _otaTaskHandle;
+    TaskHandle_t _linkTaskHandle;
+    TaskHandle_t _telemetryTaskHandle;
 
     // === Hardware instances ===
     MoaMcpDevice _mcpDevice;
@@ -213,8 +270,11 @@ private:
     MoaTempControl _tempControl;
     MoaBattControl _battControl;
     MoaCurrentControl _currentControl;
+    EspAdcDmaSource _adcSource;
+    MoaAdcSampler _adcSampler;
     MoaButtonControl _buttonControl;
     MoaLedControl _ledControl;
+    LittleFsLogStorage _logStorage;
     MoaFlashLog _flashLog;
     ESCController _escController;
 
@@ -225,6 +285,11 @@ private:
     MoaDevicesManager _devicesManager;
     MoaStateMachineWrapper _stateMachine;
     MoaStatsAggregator _statsAggregator;
+    MoaJetsonLink _jetsonLink;
+    MoaTelemetryStream _telemetryStream;
+    MoaTelemetryUdpSink _telemetryUdpSink;
+    MoaTaskProfiler _taskProfiler;
+    MoaTaskMonitor _taskMonitor;
     UartCli _uartCli;
 
     /**
@@ -237,6 +302,19 @@ private:
      */
     void initHardware();
 
+    /**
+     * @brief Start continuous ADC sampling and attach it to current/battery sensing
+     */
+    void initAdcSampling();
+
+    /**
+     * @brief Fast overcurrent trip handler: cut the ESC, then notify ControlTask
+     * @param direction +1 overcurrent, -1 reverse overcurrent
+     * @param rawAdc Raw ADC code that tripped
+     * @param context MoaMainUnit instance
+     */
+    static void onFastTrip(int8_t direction, uint16_t rawAdc, void* context);
+
     /**
      * @brief Apply configuration from ConfigManager (NVS with Constants.h fallback)
      */
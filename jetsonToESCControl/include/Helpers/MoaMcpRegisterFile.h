@@ -0,0 +1,182 @@
+/**
+ * @file MoaMcpRegisterFile.h
+ * @brief Shadowed MCP23018 register file with batched I2C writes
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Keeps two copies of the MCP23018 register map: the configuration the
+ * firmware wants and what is known to be on the device. Setters only touch
+ * the wanted copy; commit() then writes the span of registers that differ
+ * in a single sequential-address burst, and nothing at all when they match.
+ * Input registers (INTF, INTCAP, GPIO) are never cached and are read with
+ * burst reads.
+ *
+ * Relies on IOCON.BANK = 0 and IOCON.SEQOP = 0 (power-on defaults), so the
+ * register pointer auto-increments through the whole map; set() keeps both
+ * bits cleared.
+ *
+ * Free of Arduino dependencies so it can be unit tested on the host
+ * against SimulatedMcp23018 (see test/native/test_mcp_register_file).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "II2cBus.h"
+
+/**
+ * @brief MCP23018 registers (IOCON.BANK = 0 addressing)
+ */
+#define MCP23018_REG_IODIRA   0x00   ///< Direction (1 = input)
+#define MCP23018_REG_IODIRB   0x01
+#define MCP23018_REG_IPOLA    0x02   ///< Input polarity
+#define MCP23018_REG_IPOLB    0x03
+#define MCP23018_REG_GPINTENA 0x04   ///< Interrupt-on-change enable
+#define MCP23018_REG_GPINTENB 0x05
+#define MCP23018_REG_DEFVALA  0x06   ///< Interrupt compare value
+#define MCP23018_REG_DEFVALB  0x07
+#define MCP23018_REG_INTCONA  0x08   ///< Interrupt control (0 = on change)
+#define MCP23018_REG_INTCONB  0x09
+#define MCP23018_REG_IOCON    0x0A   ///< Configuration (mirrored at 0x0B)
+#define MCP23018_REG_IOCON2   0x0B
+#define MCP23018_REG_GPPUA    0x0C   ///< Pull-up enable
+#define MCP23018_REG_GPPUB    0x0D
+#define MCP23018_REG_INTFA    0x0E   ///< Interrupt flags (read-only)
+#define MCP23018_REG_INTFB    0x0F
+#define MCP23018_REG_INTCAPA  0x10   ///< Interrupt capture (read-only)
+#define MCP23018_REG_INTCAPB  0x11
+#define MCP23018_REG_GPIOA    0x12   ///< Port levels
+#define MCP23018_REG_GPIOB    0x13
+#define MCP23018_REG_OLATA    0x14   ///< Output latches
+#define MCP23018_REG_OLATB    0x15
+#define MCP23018_REG_COUNT    0x16
+
+/**
+ * @brief IOCON bits the register file depends on staying cleared
+ */
+#define MCP23018_IOCON_BANK   0x80
+#define MCP23018_IOCON_SEQOP  0x20
+
+/**
+ * @brief Cached, batched MCP23018 register access (not thread-safe)
+ *
+ * ## Usage Example
+ * @code
+ * MoaMcpRegisterFile regs(&bus, 0x20);
+ * regs.begin();                                          // 1 burst read
+ * regs.setBits(MCP23018_REG_IODIRA, 0x3E, 0x3E);         // inputs
+ * regs.setBits(MCP23018_REG_GPPUA, 0x3E, 0x3E);          // pull-ups
+ * regs.commit();                                         // 1 burst write
+ * regs.set(MCP23018_REG_OLATB, leds);
+ * regs.commit();                                         // 0 or 1 write
+ * @endcode
+ */
+class MoaMcpRegisterFile {
+public:
+    /**
+     * @param bus I2C bus (not owned)
+     * @param address 7-bit device address
+     */
+    MoaMcpRegisterFile(II2cBus* bus, uint8_t address);
+
+    /**
+     * @brief Read the whole register map into both copies
+     * @return true if the device answered
+     */
+    bool begin();
+
+    /**
+     * @brief The device was reset: assume power-on values on the device
+     *
+     * The wanted configuration is kept, so the next commit() restores it.
+     */
+    void resetToPowerOn();
+
+    /**
+     * @brief Forget what is on the device (next commit() rewrites everything)
+     */
+    void invalidate();
+
+    /**
+     * @brief Wanted value of a register
+     */
+    uint8_t get(uint8_t reg) const;
+
+    /**
+     * @brief Set the wanted value of a writable register
+     * @param reg Register (IODIR..GPPU or OLAT)
+     * @param value New value
+     */
+    void set(uint8_t reg, uint8_t value);
+
+    /**
+     * @brief Replace some bits of the wanted value
+     * @param reg Register
+     * @param mask Bits to change
+     * @param bits New values of those bits
+     */
+    void setBits(uint8_t reg, uint8_t mask, uint8_t bits);
+
+    /**
+     * @brief Write every register that differs from the device
+     *
+     * Configuration registers (IODIR..GPPU) and output latches (OLAT) are
+     * written as at most one burst each; a commit with nothing to change
+     * does no bus traffic.
+     *
+     * @return true if nothing was pending or every write was acknowledged
+     */
+    bool commit();
+
+    /**
+     * @brief Read consecutive registers from the device in one transaction
+     * @param reg First register
+     * @param out Destination
+     * @param count Number of registers
+     * @return true on success
+     */
+    bool read(uint8_t reg, uint8_t* out, size_t count);
+
+    /**
+     * @brief Bus transactions issued (reads and writes, including failed)
+     */
+    uint32_t getTransactionCount() const;
+
+    /**
+     * @brief Register bytes transferred (excluding address/pointer bytes)
+     */
+    uint32_t getBytesTransferred() const;
+
+    /**
+     * @brief commit() calls that had nothing to write
+     */
+    uint32_t getSkippedWrites() const;
+
+    /**
+     * @brief Transactions that were not acknowledged
+     */
+    uint32_t getErrorCount() const;
+
+    /**
+     * @brief Power-on value of a register
+     */
+    static uint8_t powerOnValue(uint8_t reg);
+
+private:
+    II2cBus* _bus;
+    uint8_t _address;
+    uint8_t _wanted[MCP23018_REG_COUNT];   ///< Configuration the firmware wants
+    uint8_t _device[MCP23018_REG_COUNT];   ///< Last value known on the device
+    uint32_t _unknown;                     ///< Bit per register: device value unknown
+    uint32_t _transactions;
+    uint32_t _bytes;
+    uint32_t _skipped;
+    uint32_t _errors;
+
+    /**
+     * @brief Write the differing span of [first, last] as one burst
+     * @return true if nothing differed or the write was acknowledged
+     */
+    bool commitRange(uint8_t first, uint8_t last, bool& wrote);
+};
@@ -0,0 +1,199 @@
+/**
+ * @file MoaMovingAverage.h
+ * @brief Statically allocated O(1) moving-window average filter
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Shared averaging engine for MoaTempControl, MoaBattControl and
+ * MoaCurrentControl. Replaces the per-class heap-allocated float buffers
+ * that were rescanned on every sample.
+ *
+ * The filter keeps a running sum alongside the circular buffer, so each
+ * push() costs one subtraction and one addition regardless of the window
+ * size. Integer sample types use a wider accumulator and are exact. Float
+ * sample types accumulate rounding error over time, so the running sum is
+ * recomputed from the buffer every ResyncPeriod pushes (amortised O(1)).
+ *
+ * Header-only and free of Arduino/FreeRTOS dependencies so it can be unit
+ * tested on the host (see test/native/test_moving_average).
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Accumulator selection per sample type
+ *
+ * Exact types never need drift correction; float sums are resynchronised
+ * periodically.
+ */
+template <typename T>
+struct MoaAverageTraits;
+
+template <>
+struct MoaAverageTraits<float> {
+    typedef float Accumulator;
+    static const bool kExact = false;
+};
+
+template <>
+struct MoaAverageTraits<int16_t> {
+    typedef int32_t Accumulator;
+    static const bool kExact = true;
+};
+
+template <>
+struct MoaAverageTraits<int32_t> {
+    typedef int64_t Accumulator;
+    static const bool kExact = true;
+};
+
+/**
+ * @brief Moving-window average with a compile-time capacity
+ *
+ * @tparam T Sample type (float, int16_t or int32_t)
+ * @tparam Capacity Maximum window size (storage is sized at compile time)
+ * @tparam ResyncPeriod Number of pushes between drift corrections (float only)
+ *
+ * The active window can be shrunk at runtime with setWindow() (1..Capacity),
+ * which keeps the existing setNumSamples() API of the sensor controls.
+ * Until the window has been filled once, average() returns the mean of the
+ * samples received so far.
+ *
+ * ## Usage Example
+ * @code
+ * MoaMovingAverage<float, 32> filter(10);  // 10-sample window, 32 max
+ * filter.push(21.5f);
+ * if (filter.isFull()) {
+ *     float avg = filter.average();
+ * }
+ * @endcode
+ */
+template <typename T, uint8_t Capacity, uint16_t ResyncPeriod = 256>
+class MoaMovingAverage {
+public:
+    typedef typename MoaAverageTraits<T>::Accumulator Accumulator;
+
+    /**
+     * @brief Construct a filter with the given active window
+     * @param window Number of samples to average (clamped to 1..Capacity)
+     */
+    explicit MoaMovingAverage(uint8_t window = Capacity) {
+        setWindow(window);
+    }
+
+    /**
+     * @brief Change the active window size
+     * @param window Number of samples (clamped to 1..Capacity)
+     * @note This resets the filter
+     */
+    void setWindow(uint8_t window) {
+        if (window < 1) {
+            window = 1;
+        } else if (window > Capacity) {
+            window = Capacity;
+        }
+        _window = window;
+        reset();
+    }
+
+    /**
+     * @brief Get the active window size
+     * @return uint8_t Number of samples averaged
+     */
+    uint8_t window() const {
+        return _window;
+    }
+
+    /**
+     * @brief Discard all samples
+     */
+    void reset() {
+        for (uint8_t i = 0; i < Capacity; i++) {
+            _samples[i] = T();
+        }
+        _sum = Accumulator();
+        _index = 0;
+        _count = 0;
+        _pushesSinceResync = 0;
+    }
+
+    /**
+     * @brief Add a sample, evicting the oldest one once the window is full
+     * @param sample New sample value
+     */
+    void push(T sample) {
+        if (_count < _window) {
+            _count++;
+        } else {
+            _sum -= static_cast<Accumulator>(_samples[_index]);
+        }
+        _samples[_index] = sample;
+        _sum += static_cast<Accumulator>(sample);
+
+        _index++;
+        if (_index >= _window) {
+            _index = 0;
+        }
+
+        if (!MoaAverageTraits<T>::kExact && ++_pushesSinceResync >= ResyncPeriod) {
+            resync();
+        }
+    }
+
+    /**
+     * @brief Get the mean of the samples currently in the window
+     * @return T Average, or zero if no samples have been pushed
+     */
+    T average() const {
+        if (_count == 0) {
+            return T();
+        }
+        return static_cast<T>(_sum / static_cast<Accumulator>(_count));
+    }
+
+    /**
+     * @brief Get the running sum of the samples in the window
+     * @return Accumulator Sum of the samples
+     */
+    Accumulator sum() const {
+        return _sum;
+    }
+
+    /**
+     * @brief Get the number of valid samples in the window
+     * @return uint8_t Sample count (0..window())
+     */
+    uint8_t count() const {
+        return _count;
+    }
+
+    /**
+     * @brief Check if the window has been filled at least once
+     * @return true if count() == window()
+     */
+    bool isFull() const {
+        return _count >= _window;
+    }
+
+private:
+    T _samples[Capacity];          ///< Circular sample buffer (static storage)
+    Accumulator _sum;              ///< Running sum of the valid samples
+    uint8_t _window;               ///< Active window size
+    uint8_t _index;                ///< Next write position
+    uint8_t _count;                ///< Number of valid samples
+    uint16_t _pushesSinceResync;   ///< Pushes since the last drift correction
+
+    /**
+     * @brief Recompute the running sum from the buffer (drift correction)
+     */
+    void resync() {
+        Accumulator sum = Accumulator();
+        for (uint8_t i = 0; i < _count; i++) {
+            sum += static_cast<Accumulator>(_samples[i]);
+        }
+        _sum = sum;
+        _pushesSinceResync = 0;
+    }
+};
@@ -0,0 +1,66 @@
+/**
+ * @file MoaNtcTable.h
+ * @brief Compile-time NTC lookup table: ADC millivolts to centi-degC
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * The Beta equation needs a logarithm and two float divisions per read,
+ * all soft-float on the ESP32-C3. The thermistor parameters are fixed at
+ * build time (NTC_* in Constants.h), so the equation is evaluated by the
+ * compiler instead: one entry every NTC_LUT_STEP_MV from 0 to
+ * NTC_ADC_VREF_MV, in centi-degC, generated by C++11 constexpr recursion
+ * and placed in flash. A read is then a shift, a mask and one linear
+ * interpolation.
+ *
+ * Divider: NTC_REFERENCE_RESISTANCE from the reference to the pin, the NTC
+ * from the pin to ground (R = Rref x V / (Vref - V), the divider the
+ * NTC_Thermistor library assumed).
+ * Entries are clamped to MOA_NTC_MIN_CC..MOA_NTC_MAX_CC, outside the range
+ * MoaTempControl accepts, so an open or shorted sensor is still rejected.
+ *
+ * Free of Arduino/FreeRTOS dependencies (see test/native/test_ntc_table).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Constants.h"
+
+/**
+ * @brief Fractional bits of the lookup input (mV x 16)
+ */
+#define MOA_NTC_MV_FRAC_BITS    4
+
+/**
+ * @brief Clamp of the table entries (centi-degC): open / shorted sensor
+ */
+#define MOA_NTC_MIN_CC          (-6000)
+#define MOA_NTC_MAX_CC          20000
+
+/**
+ * @brief Number of table entries (0 mV up to and past the reference)
+ */
+#define MOA_NTC_TABLE_SIZE      (NTC_ADC_VREF_MV / NTC_LUT_STEP_MV + 2)
+
+/**
+ * @brief Convert an ADC reading to temperature
+ *
+ * ## Usage Example
+ * @code
+ * uint32_t sum = 0;
+ * for (int i = 0; i < 16; i++) sum += analogReadMilliVolts(pin);
+ * int32_t centiC = moaNtcCentiCelsius(sum);    // 16 reads: mV x 16
+ * @endcode
+ *
+ * @param millivoltsQ4 Pin voltage in mV x 16 (clamped to NTC_ADC_VREF_MV)
+ * @return int32_t Temperature in centi-degC
+ */
+int32_t moaNtcCentiCelsius(uint32_t millivoltsQ4);
+
+/**
+ * @brief Table entry (host tests)
+ * @param index 0..MOA_NTC_TABLE_SIZE-1, at index x NTC_LUT_STEP_MV
+ * @return int16_t Temperature in centi-degC
+ */
+int16_t moaNtcTableEntry(size_t index);
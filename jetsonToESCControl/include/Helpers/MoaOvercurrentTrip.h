@@ -0,0 +1,185 @@
+/**
+ * @file MoaOvercurrentTrip.h
+ * @brief Per-sample overcurrent comparator with blanking and count-to-trip
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Fast protection path for the motor current. MoaAdcSampler feeds every raw
+ * conversion of the current channel into feed() as it drains the DMA
+ * buffer, so a sustained excursion is caught within a few samples instead
+ * of after the moving average, the 50 ms SensorTask tick and the event
+ * queue. The comparator works on raw ADC codes (thresholds are converted
+ * once by MoaCurrentControl) so the per-sample cost is two compares.
+ *
+ * When the trip fires, the handler is called synchronously from feed() -
+ * it is expected to cut the ESC output directly and only then notify the
+ * state machine. The trip latches until arm() is called.
+ *
+ * Free of Arduino/FreeRTOS dependencies so it can be unit tested on the
+ * host (see test/native/test_overcurrent_trip).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * @brief Trip handler callback
+ * @param direction +1 for overcurrent, -1 for reverse overcurrent
+ * @param rawAdc Raw ADC code of the sample that tripped
+ * @param context User pointer passed to setTripHandler()
+ */
+typedef void (*MoaTripHandler)(int8_t direction, uint16_t rawAdc, void* context);
+
+/**
+ * @brief Latching overcurrent comparator on raw ADC samples
+ *
+ * ## Usage Example
+ * @code
+ * MoaOvercurrentTrip trip;
+ * trip.setThresholds(3600, 0);       // Raw codes; 0 disables the reverse side
+ * trip.setBlankingSamples(50);       // Ignore 10 ms of inrush at 5 kHz
+ * trip.setTripCount(4);              // 4 consecutive samples to trip
+ * trip.setTripHandler(onTrip, &esc);
+ * trip.arm();
+ *
+ * // Per conversion (done by MoaAdcSampler):
+ * trip.feed(raw);
+ * @endcode
+ */
+class MoaOvercurrentTrip {
+public:
+    /**
+     * @brief Construct a disarmed trip (call arm() to enable)
+     */
+    MoaOvercurrentTrip();
+
+    /**
+     * @brief Set the trip thresholds in raw ADC codes
+     * @param highRaw Trip when a sample is >= highRaw (0 disables)
+     * @param lowRaw Trip when a sample is <= lowRaw (0 disables)
+     */
+    void setThresholds(uint16_t highRaw, uint16_t lowRaw);
+
+    /**
+     * @brief Get the positive trip threshold
+     * @return uint16_t Raw code (0 if disabled)
+     */
+    uint16_t getHighThreshold() const;
+
+    /**
+     * @brief Get the reverse trip threshold
+     * @return uint16_t Raw code (0 if disabled)
+     */
+    uint16_t getLowThreshold() const;
+
+    /**
+     * @brief Set the number of samples ignored after arm() or blank()
+     * @param samples Blanking window in samples
+     */
+    void setBlankingSamples(uint16_t samples);
+
+    /**
+     * @brief Get the blanking window
+     * @return uint16_t Blanking window in samples
+     */
+    uint16_t getBlankingSamples() const;
+
+    /**
+     * @brief Set the number of consecutive out-of-range samples needed to trip
+     * @param count Count-to-trip (minimum 1)
+     */
+    void setTripCount(uint8_t count);
+
+    /**
+     * @brief Get the count-to-trip
+     * @return uint8_t Consecutive samples needed to trip
+     */
+    uint8_t getTripCount() const;
+
+    /**
+     * @brief Set the handler called when the trip fires
+     * @param handler Callback (called from the context that calls feed())
+     * @param context User pointer passed to the handler
+     */
+    void setTripHandler(MoaTripHandler handler, void* context);
+
+    /**
+     * @brief Clear the latch and start a new blanking window
+     */
+    void arm();
+
+    /**
+     * @brief Disable the comparator until the next arm()
+     */
+    void disarm();
+
+    /**
+     * @brief Restart the blanking window without clearing the latch
+     *
+     * Used when the motor is (re)started to ride through inrush current.
+     */
+    void blank();
+
+    /**
+     * @brief Run the comparator on one raw sample
+     * @param rawAdc Raw ADC code
+     * @return true if this sample tripped the protection
+     */
+    bool feed(uint16_t rawAdc);
+
+    /**
+     * @brief Check if the trip has fired since the last arm()
+     * @return true if latched
+     */
+    bool isTripped() const;
+
+    /**
+     * @brief Check if the comparator is armed
+     * @return true between arm() and disarm()
+     */
+    bool isArmed() const;
+
+    /**
+     * @brief Get the direction of the last trip
+     * @return int8_t +1 overcurrent, -1 reverse, 0 if never tripped
+     */
+    int8_t getTripDirection() const;
+
+    /**
+     * @brief Get the raw code of the sample that caused the last trip
+     * @return uint16_t Raw ADC code
+     */
+    uint16_t getTripRaw() const;
+
+    /**
+     * @brief Get the number of trips since construction
+     * @return uint32_t Trip count
+     */
+    uint32_t getTripTotal() const;
+
+private:
+    uint16_t _highRaw;                   ///< Positive trip threshold (0 = disabled)
+    uint16_t _lowRaw;                    ///< Reverse trip threshold (0 = disabled)
+    uint16_t _blankingSamples;           ///< Blanking window length
+    uint8_t _tripCount;                  ///< Consecutive samples needed to trip
+    MoaTripHandler _handler;             ///< Trip callback
+    void* _handlerContext;               ///< Trip callback context
+
+    std::atomic<bool> _armed;            ///< Comparator enabled
+    std::atomic<bool> _tripped;          ///< Latched trip flag
+    std::atomic<uint16_t> _blankRemaining; ///< Samples left in the blanking window
+    uint8_t _overCount;                  ///< Consecutive samples above highRaw
+    uint8_t _underCount;                 ///< Consecutive samples below lowRaw
+    int8_t _tripDirection;               ///< Direction of the last trip
+    uint16_t _tripRaw;                   ///< Raw code of the last tripping sample
+    uint32_t _tripTotal;                 ///< Trips since construction
+
+    /**
+     * @brief Latch the trip and call the handler
+     * @param direction +1 or -1
+     * @param rawAdc Tripping sample
+     */
+    void trip(int8_t direction, uint16_t rawAdc);
+};
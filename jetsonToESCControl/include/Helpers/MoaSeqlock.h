@@ -0,0 +1,142 @@
+/**
+ * @file MoaSeqlock.h
+ * @brief Double-buffered sequence lock for single-writer, multi-reader data
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Publishes a trivially copyable value from one writer task to any number
+ * of readers without a mutex. The writer never blocks; readers never see a
+ * torn copy. Used by MoaStatsAggregator for the latest readings and the
+ * history summary.
+ *
+ * Header-only and free of Arduino/FreeRTOS dependencies so it can be
+ * stress tested on the host (see test/native/test_stats_aggregator).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+/**
+ * @brief Double-buffered seqlock around a trivially copyable T
+ *
+ * The sequence counter is odd while a write is in progress and each write
+ * goes to the buffer that is not currently published (version n lives in
+ * buffer n & 1). A reader copies the published buffer and re-checks the
+ * counter; it only retries if the writer started a second write into that
+ * same buffer during the copy. A reader that preempts the writer mid-write
+ * therefore still completes on the first pass - it never spins waiting
+ * for a lower-priority writer.
+ *
+ * The payload is held in relaxed atomic words so the race is well-defined
+ * in C++ (on the ESP32-C3 these compile to plain 32-bit loads and stores).
+ *
+ * @tparam T Published type (trivially copyable)
+ */
+template <typename T>
+class MoaSeqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "MoaSeqlock needs a trivially copyable type");
+
+public:
+    /**
+     * @brief Construct with a zeroed value published as version 0
+     */
+    MoaSeqlock() : _sequence(0), _readRetries(0) {
+        reset();
+    }
+
+    /**
+     * @brief Publish a zeroed value and restart the version count
+     *
+     * Must not run concurrently with write().
+     */
+    void reset() {
+        for (uint8_t b = 0; b < 2; b++) {
+            for (size_t i = 0; i < WORDS; i++) {
+                _words[b][i].store(0, std::memory_order_relaxed);
+            }
+        }
+        _readRetries.store(0, std::memory_order_relaxed);
+        _sequence.store(0, std::memory_order_release);
+    }
+
+    /**
+     * @brief Publish a new value (single writer only, never blocks)
+     * @param value Value to publish
+     */
+    void write(const T& value) {
+        uint32_t words[WORDS] = {};
+        memcpy(words, &value, sizeof(T));
+
+        uint32_t seq = _sequence.load(std::memory_order_relaxed);
+        uint8_t target = static_cast<uint8_t>(((seq >> 1) + 1) & 1);
+
+        _sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < WORDS; i++) {
+            _words[target][i].store(words[i], std::memory_order_relaxed);
+        }
+
+        _sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copy the latest published value (lock-free, any task)
+     * @return T Consistent copy
+     */
+    T read() const {
+        uint32_t words[WORDS];
+
+        for (;;) {
+            uint32_t begin = _sequence.load(std::memory_order_acquire);
+            // Last completed version; a write in progress targets the other buffer
+            uint32_t base = begin & ~1u;
+            uint8_t source = static_cast<uint8_t>((base >> 1) & 1);
+
+            for (size_t i = 0; i < WORDS; i++) {
+                words[i] = _words[source][i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint32_t end = _sequence.load(std::memory_order_relaxed);
+
+            // The source buffer is only rewritten once the write after next starts
+            if (end - base < 3) {
+                break;
+            }
+            _readRetries.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        T value;
+        memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    /**
+     * @brief Number of values published since construction/reset()
+     * @return uint32_t Completed write() calls
+     */
+    uint32_t getVersion() const {
+        return _sequence.load(std::memory_order_acquire) >> 1;
+    }
+
+    /**
+     * @brief Number of reader retries caused by concurrent writes
+     * @return uint32_t Total retries across all readers
+     */
+    uint32_t getReadRetries() const {
+        return _readRetries.load(std::memory_order_relaxed);
+    }
+
+private:
+    static const size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    std::atomic<uint32_t> _sequence;                    ///< Odd while a write is in progress
+    std::atomic<uint32_t> _words[2][WORDS];             ///< Double-buffered payload
+    mutable std::atomic<uint32_t> _readRetries;         ///< Reader retry counter
+};
@@ -3,22 +3,33 @@
  * @brief Centralized stats storage for telemetry and monitoring
  * @author Oscar Martinez
  * @date 2025-02-03
- * 
+ *
  * MoaStatsAggregator provides a single source of truth for current device
  * readings. It consumes StatsReading messages from the stats queue and
  * provides thread-safe access to the latest values.
+ *
+ * The snapshot is published through a double-buffered sequence lock
+ * (MoaSeqlock) instead of a mutex: the single writer (StatsTask) never
+ * blocks, and readers (CLI, telemetry) never see a torn or zeroed reading.
+ * Each reading is also rolled up into a MoaStatsHistory, whose session
+ * figures and newest closed buckets are published the same way, and
+ * battery and current readings feed a MoaEnergyMeter (charge, energy,
+ * state of charge, ride time), whose report is published too. Free of
+ * Arduino/FreeRTOS dependencies so it can be stress tested on the host
+ * (see test/native/test_stats_aggregator).
  */
 
 #pragma once
 
-#include <Arduino.h>
-#include "freertos/FreeRTOS.h"
-#include "freertos/semphr.h"
+#include <stdint.h>
 #include "StatsReading.h"
+#include "MoaSeqlock.h"
+#include "MoaStatsHistory.h"
+#include "MoaEnergyMeter.h"
 
 /**
  * @brief Snapshot of all current stats
- * 
+ *
  * Returned by getSnapshot() for atomic access to all readings.
  */
 struct StatsSnapshot {
@@ -28,25 +39,36 @@ struct StatsSnapshot {
     uint32_t tempTimestamp;     ///< Last temperature update (millis)
     uint32_t battTimestamp;     ///< Last battery update (millis)
     uint32_t currentTimestamp;  ///< Last current update (millis)
+    int16_t motorTempX10;       ///< Motor probe temperature in °C × 10 (DS18B20 bus)
+    int16_t batteryTempX10;     ///< Battery probe temperature in °C × 10 (DS18B20 bus)
+    uint32_t motorTempTimestamp;    ///< Last motor probe update (millis), 0 = none
+    uint32_t batteryTempTimestamp;  ///< Last battery probe update (millis), 0 = none
 };
 
 /**
  * @brief Centralized stats aggregator for telemetry
- * 
- * Stores the latest sensor readings and provides thread-safe access
+ *
+ * Stores the latest sensor readings and provides lock-free access
  * for telemetry consumers (webserver, serial logging, etc.).
- * 
+ *
+ * ## Concurrency
+ * Exactly one task may call update() (StatsTask). Any number of tasks may
+ * call getSnapshot(), getSummary() and the getters concurrently. A reader
+ * that preempts StatsTask mid-update still completes on its first pass
+ * (see MoaSeqlock). getHistory() exposes the full rings and is only safe
+ * from the StatsTask context.
+ *
  * ## Usage
  * @code
  * MoaStatsAggregator stats;
  * stats.begin();
- * 
+ *
  * // In StatsTask:
  * StatsReading reading;
  * if (xQueueReceive(statsQueue, &reading, portMAX_DELAY)) {
  *     stats.update(reading);
  * }
- * 
+ *
  * // In telemetry consumer:
  * StatsSnapshot snapshot = stats.getSnapshot();
  * float temp = snapshot.temperatureX10 / 10.0f;
@@ -60,53 +82,121 @@ public:
     MoaStatsAggregator();
 
     /**
-     * @brief Destructor
-     */
-    ~MoaStatsAggregator();
-
-    /**
-     * @brief Initialize the aggregator (creates mutex)
+     * @brief Initialize the aggregator (clears readings and history)
+     *
+     * Must not run concurrently with update().
      */
     void begin();
 
     /**
      * @brief Update stats with a new reading
-     * 
+     *
      * Called by StatsTask when a reading arrives from the queue.
-     * Thread-safe.
-     * 
+     * Single writer only; never blocks.
+     *
      * @param reading The stats reading to process
      */
     void update(const StatsReading& reading);
 
     /**
      * @brief Get a snapshot of all current stats
-     * 
-     * Returns an atomic copy of all readings. Thread-safe.
-     * 
+     *
+     * Returns a consistent copy of all readings. Lock-free and safe
+     * from any task, including one that preempted StatsTask mid-update.
+     *
      * @return StatsSnapshot Current stats values
      */
-    StatsSnapshot getSnapshot();
+    StatsSnapshot getSnapshot() const;
 
     /**
      * @brief Get current temperature (×10)
      * @return int16_t Temperature in °C × 10
      */
-    int16_t getTemperatureX10();
+    int16_t getTemperatureX10() const;
 
     /**
      * @brief Get current battery voltage in millivolts
      * @return int16_t Voltage in mV
      */
-    int16_t getBatteryVoltageMv();
+    int16_t getBatteryVoltageMv() const;
 
     /**
      * @brief Get current current reading (×10)
      * @return int16_t Current in A × 10
      */
-    int16_t getCurrentX10();
+    int16_t getCurrentX10() const;
+
+    /**
+     * @brief Get the published history summary
+     *
+     * Session min/max/mean per channel, the newest closed 1 s / 10 s /
+     * 1 min bucket per channel, and energy used. Lock-free, any task.
+     *
+     * @return StatsHistorySummary Current summary
+     */
+    StatsHistorySummary getSummary() const;
+
+    /**
+     * @brief Full history rings (StatsTask context only)
+     * @return const MoaStatsHistory& History owned by the aggregator
+     */
+    const MoaStatsHistory& getHistory() const;
+
+    /**
+     * @brief Get the published energy report
+     *
+     * Session and lifetime charge/energy, rolling power, state of charge
+     * and remaining ride time. Lock-free, any task.
+     *
+     * @return MoaEnergyReport Current report
+     */
+    MoaEnergyReport getEnergy() const;
+
+    /**
+     * @brief Pack model for the state of charge (any task, e.g. CLI apply)
+     * @param capacityMah Usable capacity (mAh)
+     * @param fullMv Resting voltage taken as 100% (mV)
+     * @param emptyMv Voltage taken as 0% (mV)
+     */
+    void setBattery(uint32_t capacityMah, uint16_t fullMv, uint16_t emptyMv);
+
+    /**
+     * @brief Lifetime totals loaded from NVS (before StatsTask starts)
+     */
+    void setEnergyLifetime(int32_t mah, int32_t mwh);
+
+    /**
+     * @brief Lifetime totals are due for an NVS write (StatsTask context only)
+     * @param nowMs Current time (ms)
+     */
+    bool isEnergySaveDue(uint32_t nowMs) const;
+
+    /**
+     * @brief Record an NVS write of the lifetime totals (StatsTask context only)
+     */
+    void markEnergySaved(uint32_t nowMs);
+
+    /**
+     * @brief Number of snapshots published since begin()
+     * @return uint32_t Completed update() calls
+     */
+    uint32_t getUpdateCount() const;
+
+    /**
+     * @brief Number of reader retries caused by a concurrent update()
+     *
+     * Diagnostic only; a retry needs two update() calls to complete
+     * during a single copy.
+     *
+     * @return uint32_t Total retries across all readers
+     */
+    uint32_t getReadRetries() const;
 
 private:
-    SemaphoreHandle_t _mutex;
-    StatsSnapshot _stats;
+    StatsSnapshot _stats;                           ///< Writer-private working copy
+    MoaStatsHistory _history;                       ///< Rollup rings (writer-owned)
+    MoaSeqlock<StatsSnapshot> _snapshot;            ///< Published latest readings
+    MoaSeqlock<StatsHistorySummary> _summary;       ///< Published history summary
+    MoaEnergyMeter _energy;                         ///< Coulomb counter (writer-owned)
+    MoaSeqlock<MoaEnergyReport> _energyReport;      ///< Published energy report
 };
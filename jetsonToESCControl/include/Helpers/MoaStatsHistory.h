@@ -0,0 +1,219 @@
+/**
+ * @file MoaStatsHistory.h
+ * @brief Fixed-size multi-resolution history rings with min/max/mean rollups
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Keeps, per stats channel (temperature, battery, current), a ring of raw
+ * readings and rings of closed 1 s, 10 s and 1 min buckets. Each bucket
+ * holds min/max/sum/count and is updated incrementally as StatsReadings
+ * arrive, so session figures (peak current, mean temperature) are O(1)
+ * and never need a walk of the flash log. Energy is not integrated here:
+ * MoaEnergyMeter is the single integrator, and MoaStatsAggregator copies
+ * its session figure into the published summary.
+ *
+ * All storage is static (see STATS_HISTORY_*_LENGTH); getMemoryBytes()
+ * reports the footprint. Not thread-safe: owned and fed by StatsTask
+ * through MoaStatsAggregator, which publishes a StatsHistorySummary to
+ * other tasks. Free of Arduino/FreeRTOS dependencies so the rollup math
+ * can be unit tested on the host (see test/native/test_stats_history).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Constants.h"
+#include "StatsReading.h"
+
+/**
+ * @brief Number of stats channels (index = STATS_TYPE_* - 1)
+ */
+#define STATS_CHANNEL_COUNT 3
+
+/**
+ * @brief History resolutions
+ */
+enum StatsResolution : uint8_t {
+    STATS_RES_RAW = 0,   ///< Every reading
+    STATS_RES_1S,        ///< 1 s buckets
+    STATS_RES_10S,       ///< 10 s buckets
+    STATS_RES_1MIN,      ///< 1 min buckets
+    STATS_RES_COUNT
+};
+
+/**
+ * @brief One rollup bucket (values in the channel's stats units)
+ */
+struct StatsBucket {
+    uint32_t startMs;   ///< Bucket start (aligned to the resolution), or reading time for raw
+    int32_t sum;        ///< Sum of readings
+    int16_t min;        ///< Minimum reading
+    int16_t max;        ///< Maximum reading
+    uint16_t count;     ///< Number of readings (0 = empty)
+    uint16_t reserved;  ///< Padding
+
+    /**
+     * @brief Mean of the readings, rounded (0 if empty)
+     * @return int16_t Mean value
+     */
+    int16_t mean() const;
+};
+
+/**
+ * @brief Whole-session figures for one channel
+ */
+struct StatsSessionChannel {
+    int16_t min;        ///< Session minimum
+    int16_t max;        ///< Session maximum
+    int16_t mean;       ///< Session mean (rounded)
+    uint16_t reserved;  ///< Padding
+    uint32_t count;     ///< Readings since reset
+};
+
+/**
+ * @brief Compact view published to other tasks by MoaStatsAggregator
+ */
+struct StatsHistorySummary {
+    StatsSessionChannel session[STATS_CHANNEL_COUNT];              ///< Session figures per channel
+    StatsBucket lastClosed[STATS_CHANNEL_COUNT][STATS_RES_COUNT - 1]; ///< Newest closed 1 s / 10 s / 1 min bucket
+    int32_t energyMwh;          ///< Session energy from MoaEnergyMeter (mWh, negative = net regen; 0 from getSummary())
+    uint32_t sessionStartMs;    ///< Timestamp of the first reading since reset
+};
+
+/**
+ * @brief Multi-resolution rollup engine
+ *
+ * ## Usage Example
+ * @code
+ * MoaStatsHistory history;
+ * history.add(reading);                               // from StatsTask
+ *
+ * int16_t peak = history.getSession(STATS_TYPE_CURRENT).max;   // A x10
+ * StatsBucket b;
+ * if (history.getBucket(STATS_TYPE_TEMPERATURE, STATS_RES_1MIN, 0, &b)) {
+ *     // b.min / b.max / b.mean() over the last complete minute
+ * }
+ * @endcode
+ */
+class MoaStatsHistory {
+public:
+    /**
+     * @brief Construct an empty history
+     */
+    MoaStatsHistory();
+
+    /**
+     * @brief Drop all history and session figures
+     */
+    void reset();
+
+    /**
+     * @brief Add one reading to every resolution of its channel
+     *
+     * Unknown stats types are ignored. A timed bucket is closed into its
+     * ring by the first reading that falls in a later period; periods with
+     * no readings leave no bucket (check startMs for gaps).
+     *
+     * @param reading Stats reading
+     */
+    void add(const StatsReading& reading);
+
+    /**
+     * @brief Number of closed buckets held for a channel/resolution
+     * @param statsType STATS_TYPE_*
+     * @param resolution StatsResolution
+     * @return uint16_t Buckets available (<= ring length)
+     */
+    uint16_t getCount(uint8_t statsType, uint8_t resolution) const;
+
+    /**
+     * @brief Read a closed bucket
+     * @param statsType STATS_TYPE_*
+     * @param resolution StatsResolution
+     * @param age 0 = newest, getCount() - 1 = oldest
+     * @param out Destination
+     * @return true if the bucket exists
+     */
+    bool getBucket(uint8_t statsType, uint8_t resolution, uint16_t age, StatsBucket* out) const;
+
+    /**
+     * @brief The bucket still being filled for a timed resolution
+     * @param statsType STATS_TYPE_*
+     * @param resolution STATS_RES_1S / _10S / _1MIN
+     * @param out Destination (count 0 if nothing yet)
+     * @return true if the arguments are valid
+     */
+    bool getOpenBucket(uint8_t statsType, uint8_t resolution, StatsBucket* out) const;
+
+    /**
+     * @brief Whole-session figures for a channel
+     * @param statsType STATS_TYPE_*
+     * @return StatsSessionChannel Min/max/mean/count (zeros if invalid or empty)
+     */
+    StatsSessionChannel getSession(uint8_t statsType) const;
+
+    /**
+     * @brief Fill the compact summary published to other tasks
+     * @param out Destination
+     */
+    void getSummary(StatsHistorySummary* out) const;
+
+    /**
+     * @brief Static RAM used by one history instance
+     * @return size_t Bytes
+     */
+    static size_t getMemoryBytes();
+
+    /**
+     * @brief Ring length of a resolution
+     * @param resolution StatsResolution
+     * @return uint16_t Number of buckets kept (0 if invalid)
+     */
+    static uint16_t getLength(uint8_t resolution);
+
+    /**
+     * @brief Bucket period of a resolution
+     * @param resolution StatsResolution
+     * @return uint32_t Period in ms (0 for raw or invalid)
+     */
+    static uint32_t getPeriodMs(uint8_t resolution);
+
+private:
+    /**
+     * @brief Per channel/resolution ring bookkeeping
+     */
+    struct Ring {
+        uint16_t head;      ///< Next write position
+        uint16_t count;     ///< Closed buckets held
+        StatsBucket open;   ///< Bucket being filled (timed resolutions)
+    };
+
+    /**
+     * @brief Whole-session accumulator for a channel
+     */
+    struct Session {
+        int64_t sum;
+        uint32_t count;
+        int16_t min;
+        int16_t max;
+    };
+
+    /**
+     * @brief Map STATS_TYPE_* to a channel index
+     * @return int8_t Index, or -1 if unknown
+     */
+    static int8_t channelIndex(uint8_t statsType);
+
+    /**
+     * @brief Push a closed bucket into a ring
+     */
+    void push(uint8_t channel, uint8_t resolution, const StatsBucket& bucket);
+
+    StatsBucket _buckets[STATS_CHANNEL_COUNT][STATS_HISTORY_TOTAL_LENGTH];  ///< All rings, flat per channel
+    Ring _rings[STATS_CHANNEL_COUNT][STATS_RES_COUNT];  ///< Ring state per channel/resolution
+    Session _session[STATS_CHANNEL_COUNT];              ///< Session accumulators
+
+    bool _started;              ///< A reading has arrived since reset
+    uint32_t _sessionStartMs;   ///< First reading timestamp
+};
@@ -0,0 +1,86 @@
+/**
+ * @file MoaTaskMonitor.h
+ * @brief FreeRTOS side of the task profiler: stack high-water marks and CPU share
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Holds the task handles created by MoaMainUnit and completes the
+ * MoaTaskProfiler loop timing with what only FreeRTOS knows:
+ * - the lowest free stack each task has seen (uxTaskGetStackHighWaterMark,
+ *   in bytes on ESP-IDF);
+ * - the CPU share since the last reset, from the FreeRTOS run-time
+ *   counters when the build enables them (configGENERATE_RUN_TIME_STATS
+ *   and configUSE_TRACE_FACILITY), otherwise from the loop busy time the
+ *   tasks report themselves.
+ *
+ * Sampling is on demand (CLI 'perf'); nothing runs in the background.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "MoaTaskProfiler.h"
+
+/**
+ * @brief 1 when per-task FreeRTOS run-time counters are available
+ */
+#if defined(configGENERATE_RUN_TIME_STATS) && (configGENERATE_RUN_TIME_STATS == 1) && \
+    defined(configUSE_TRACE_FACILITY) && (configUSE_TRACE_FACILITY == 1)
+#define MOA_PERF_RUN_TIME_STATS 1
+#else
+#define MOA_PERF_RUN_TIME_STATS 0
+#endif
+
+/**
+ * @brief Samples stack and CPU figures for the profiled tasks
+ *
+ * ## Usage
+ * @code
+ * xTaskCreatePinnedToCore(SensorTask, ..., &handle, 0);
+ * monitor.setHandle(MOA_PERF_SENSOR, handle);
+ *
+ * MoaTaskPerf perf[MOA_PERF_TASK_COUNT];
+ * monitor.sampleAll(perf);                     // CLI
+ * @endcode
+ */
+class MoaTaskMonitor {
+public:
+    /**
+     * @brief Construct a monitor
+     * @param profiler Loop timing of the same tasks
+     */
+    explicit MoaTaskMonitor(MoaTaskProfiler& profiler);
+
+    /**
+     * @brief Attach the handle of a created task
+     */
+    void setHandle(MoaPerfTask task, TaskHandle_t handle);
+
+    /**
+     * @brief Loop timing, stack high-water mark and CPU share of every task
+     * @param out MOA_PERF_TASK_COUNT rows, in MoaPerfTask order
+     */
+    void sampleAll(MoaTaskPerf* out);
+
+    /**
+     * @brief Restart loop timing and the CPU share window
+     */
+    void reset();
+
+    /**
+     * @brief Where the CPU share comes from ("run-time stats" / "loop busy time")
+     */
+    static const char* getCpuSource();
+
+private:
+    MoaTaskProfiler& _profiler;
+    TaskHandle_t _handles[MOA_PERF_TASK_COUNT];
+#if MOA_PERF_RUN_TIME_STATS
+    uint32_t _runTimeBase[MOA_PERF_TASK_COUNT];     ///< Task counters at reset()
+    uint32_t _totalRunTimeBase;                     ///< Run-time clock at reset()
+
+    uint32_t getRunTime(MoaPerfTask task) const;
+#endif
+};
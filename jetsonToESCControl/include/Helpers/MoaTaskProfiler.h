@@ -0,0 +1,222 @@
+/**
+ * @file MoaTaskProfiler.h
+ * @brief Per-task loop period, jitter and busy time, plus the binary perf record
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Every task loop calls loopStart() when it wakes (periodic tasks) or
+ * when its event arrives (ControlTask, StatsTask) and loopEnd() before it
+ * blocks again. From those two timestamps the profiler keeps, per task:
+ * - the period between wake-ups (min / mean / max) against the intended
+ *   TASK_*_PERIOD_MS, and how many were late by more than
+ *   MOA_PERF_LATE_PERCENT;
+ * - the busy time of one loop (max) and in total, which gives the CPU
+ *   share when FreeRTOS run-time stats are not compiled in.
+ *
+ * Each task is the only writer of its own slot and publishes it through a
+ * MoaSeqlock, so readers (CLI, telemetry) never block a task. Stack
+ * high-water marks and run-time counters are sampled on demand by
+ * MoaTaskMonitor, which owns the task handles.
+ *
+ * ## Binary Record (little-endian)
+ * | Field   | Size         | Description                                   |
+ * |---------|--------------|-----------------------------------------------|
+ * | header  | 12 bytes     | MoaPerfRecordHeader (magic, version, count)   |
+ * | tasks   | count × 32   | MoaPerfTaskEntry, in MoaPerfTask order        |
+ * | crc     | 2 bytes      | CRC-16/CCITT-FALSE of header and entries      |
+ *
+ * Free of Arduino/FreeRTOS dependencies so it can be unit tested on the
+ * host (see test/native/test_task_profiler).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "MoaSeqlock.h"
+
+/**
+ * @brief A period this much over the intended one counts as late (%)
+ */
+#define MOA_PERF_LATE_PERCENT   50
+
+/**
+ * @brief Binary record magic ("MOAP" little-endian)
+ */
+#define MOA_PERF_RECORD_MAGIC   0x50414F4DUL
+
+/**
+ * @brief Binary record format version
+ */
+#define MOA_PERF_RECORD_VERSION 1
+
+/**
+ * @brief Stack free / CPU share not available
+ */
+#define MOA_PERF_UNKNOWN        0xFFFF
+
+/**
+ * @brief Profiled tasks, in MoaMainUnit::createTasks() order
+ */
+enum MoaPerfTask : uint8_t {
+    MOA_PERF_PROTECTION = 0,
+    MOA_PERF_SENSOR,
+    MOA_PERF_IO,
+    MOA_PERF_CONTROL,
+    MOA_PERF_STATS,
+    MOA_PERF_CLI,
+    MOA_PERF_OTA,
+    MOA_PERF_LINK,
+    MOA_PERF_TELEMETRY,
+    MOA_PERF_TASK_COUNT
+};
+
+/**
+ * @brief Loop timing of one task since boot or the last reset
+ */
+struct MoaLoopTiming {
+    uint32_t loops;             ///< loopStart() calls
+    uint32_t periods;           ///< Periods measured (loops - 1)
+    uint32_t firstStartUs;      ///< First loopStart()
+    uint32_t lastStartUs;       ///< Latest loopStart()
+    uint32_t lastEndUs;         ///< Latest loopEnd()
+    uint32_t minPeriodUs;
+    uint32_t maxPeriodUs;
+    uint32_t lateCount;         ///< Periods over target + MOA_PERF_LATE_PERCENT
+    uint32_t maxBusyUs;         ///< Longest loopStart() -> loopEnd()
+    uint64_t totalPeriodUs;
+    uint64_t busyUs;            ///< Sum of loopStart() -> loopEnd()
+
+    uint32_t meanPeriodUs() const;
+
+    /**
+     * @brief Largest distance of a period from the target (us)
+     * @param targetUs Intended period, 0 for event-driven tasks (returns 0)
+     */
+    uint32_t maxJitterUs(uint32_t targetUs) const;
+
+    /**
+     * @brief Busy time over the time covered by the loops (per mille)
+     */
+    uint16_t busyPermille() const;
+};
+
+/**
+ * @brief Everything known about one task, as shown by CLI 'perf'
+ */
+struct MoaTaskPerf {
+    const char* name;           ///< Short name ("sensor", "io", ...)
+    uint32_t stackBytes;        ///< Stack given to xTaskCreate
+    uint32_t periodMs;          ///< Intended period, 0 = event-driven
+    uint16_t stackFreeBytes;    ///< Lowest free stack seen, MOA_PERF_UNKNOWN if not sampled
+    uint16_t cpuPermille;       ///< CPU share, MOA_PERF_UNKNOWN if not sampled
+    MoaLoopTiming timing;
+};
+
+/**
+ * @brief Binary record header (12 bytes)
+ */
+struct MoaPerfRecordHeader {
+    uint32_t magic;             ///< MOA_PERF_RECORD_MAGIC
+    uint8_t version;            ///< MOA_PERF_RECORD_VERSION
+    uint8_t taskCount;          ///< Entries that follow
+    uint8_t entrySize;          ///< sizeof(MoaPerfTaskEntry)
+    uint8_t reserved;           ///< Zero
+    uint32_t uptimeMs;          ///< millis() when the record was packed
+} __attribute__((packed));
+
+/**
+ * @brief Binary record entry for one task (32 bytes)
+ */
+struct MoaPerfTaskEntry {
+    uint16_t stackBytes;
+    uint16_t stackFreeBytes;    ///< MOA_PERF_UNKNOWN if not sampled
+    uint16_t cpuPermille;       ///< MOA_PERF_UNKNOWN if not sampled
+    uint16_t periodMs;          ///< 0 = event-driven
+    uint32_t loops;
+    uint32_t meanPeriodUs;
+    uint32_t minPeriodUs;       ///< 0 if fewer than two loops
+    uint32_t maxPeriodUs;
+    uint32_t maxBusyUs;
+    uint32_t lateCount;
+} __attribute__((packed));
+
+/**
+ * @brief Complete binary record (302 bytes)
+ */
+struct MoaPerfRecord {
+    MoaPerfRecordHeader header;
+    MoaPerfTaskEntry tasks[MOA_PERF_TASK_COUNT];
+    uint16_t crc;
+} __attribute__((packed));
+
+/**
+ * @brief Loop timing for every task, one writer per slot
+ *
+ * ## Usage
+ * @code
+ * profiler.configure(MOA_PERF_SENSOR, "sensor", TASK_STACK_SENSOR, TASK_SENSOR_PERIOD_MS);
+ *
+ * for (;;) {                                   // SensorTask
+ *     profiler.loopStart(MOA_PERF_SENSOR, micros());
+ *     ...
+ *     profiler.loopEnd(MOA_PERF_SENSOR, micros());
+ *     vTaskDelay(pdMS_TO_TICKS(TASK_SENSOR_PERIOD_MS));
+ * }
+ * @endcode
+ */
+class MoaTaskProfiler {
+public:
+    MoaTaskProfiler();
+
+    /**
+     * @brief Describe a task (before it starts)
+     * @param name Short name, must outlive the profiler
+     * @param stackBytes Stack size passed to xTaskCreate
+     * @param periodMs Intended period, 0 for event-driven tasks
+     */
+    void configure(MoaPerfTask task, const char* name, uint32_t stackBytes, uint32_t periodMs);
+
+    /**
+     * @brief The task woke up / its event arrived (owning task only)
+     */
+    void loopStart(MoaPerfTask task, uint32_t nowUs);
+
+    /**
+     * @brief The task is about to block again; publishes the slot (owning task only)
+     */
+    void loopEnd(MoaPerfTask task, uint32_t nowUs);
+
+    /**
+     * @brief Latest published timing (any task)
+     */
+    MoaLoopTiming getTiming(MoaPerfTask task) const;
+
+    /**
+     * @brief Static part of a task's MoaTaskPerf plus its timing; stack and CPU unknown
+     */
+    MoaTaskPerf getPerf(MoaPerfTask task) const;
+
+    /**
+     * @brief Clear every task's timing; each task restarts at its next loopStart()
+     */
+    void requestReset();
+
+    /**
+     * @brief Pack a record of MOA_PERF_TASK_COUNT rows
+     */
+    static void packRecord(const MoaTaskPerf* perf, uint32_t uptimeMs, MoaPerfRecord& out);
+
+private:
+    struct Slot {
+        const char* name;
+        uint32_t stackBytes;
+        uint32_t periodMs;
+        MoaLoopTiming working;                  ///< Owning task's copy
+        MoaSeqlock<MoaLoopTiming> published;
+        std::atomic<bool> resetRequested;
+    };
+
+    Slot _slots[MOA_PERF_TASK_COUNT];
+};
@@ -0,0 +1,208 @@
+/**
+ * @file MoaTelemetry.h
+ * @brief Binary telemetry stream: delta-encoded StatsReading batches
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * StatsTask offers every StatsReading to a MoaTelemetryStream, which packs
+ * them into a batch and seals the batch once per telemetry period (or when
+ * it is full) into a small frame ring. A sender (TelemetryTask) takes the
+ * sealed frames and hands them to a sink: the Jetson link or UDP.
+ *
+ * Batch payload (little-endian):
+ *
+ *   version (1) | baseTimestamp (4, ms) | count (1) | records...
+ *
+ * Each record is a head byte, an optional timestamp extension and the value:
+ *
+ *   head = statsType (bits 0-1) | dt (bits 2-7)
+ *   dt < 63: timestamp = previous + dt (ms), else varint(dt) follows
+ *   varint(zigzag(value - previous value of the same type in this batch))
+ *
+ * The first record's timestamp is relative to baseTimestamp, and the first
+ * value of each type is relative to 0, so every batch decodes on its own:
+ * a lost frame loses its readings and nothing else. Sensor values move by
+ * a few LSB per sample, so a reading takes 2 bytes instead of the 12 of a
+ * StatsReading.
+ *
+ * Free of Arduino/FreeRTOS dependencies: the decoder is the host side of
+ * the format (see test/native/test_telemetry).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "StatsReading.h"
+
+/**
+ * @brief Payload format version (first byte of a batch)
+ */
+#define MOA_TELEMETRY_VERSION       1
+
+/**
+ * @brief Largest batch payload (bytes); fits one Jetson link frame
+ */
+#define MOA_TELEMETRY_MAX_PAYLOAD   64
+
+/**
+ * @brief Batch header: version, base timestamp, count
+ */
+#define MOA_TELEMETRY_HEADER_BYTES  6
+
+/**
+ * @brief Largest record: head, 5-byte timestamp varint, 5-byte value varint
+ */
+#define MOA_TELEMETRY_MAX_RECORD    11
+
+/**
+ * @brief Sealed batches waiting for the sender
+ */
+#define MOA_TELEMETRY_RING_FRAMES   8
+
+/**
+ * @brief Packs StatsReadings into one batch payload
+ *
+ * ## Usage
+ * @code
+ * MoaTelemetryEncoder encoder;
+ * encoder.begin(millis());
+ * while (encoder.add(reading)) { ... }
+ * send(encoder.data(), encoder.length());
+ * @endcode
+ */
+class MoaTelemetryEncoder {
+public:
+    MoaTelemetryEncoder();
+
+    /**
+     * @brief Start an empty batch
+     * @param baseTimestamp Timestamp the first record is relative to (ms)
+     */
+    void begin(uint32_t baseTimestamp);
+
+    /**
+     * @brief Append a reading
+     * @return false if the batch has no room for a worst-case record (not appended)
+     */
+    bool add(const StatsReading& reading);
+
+    const uint8_t* data() const;
+    size_t length() const;
+    uint8_t count() const;
+
+private:
+    uint8_t _buffer[MOA_TELEMETRY_MAX_PAYLOAD];
+    size_t _length;
+    uint8_t _count;
+    uint32_t _lastTimestamp;
+    int32_t _lastValue[4];                  ///< Per statsType (1..3), 0 at batch start
+
+    void putVarint(uint32_t value);
+};
+
+/**
+ * @brief Host side: unpacks a batch payload back into StatsReadings
+ */
+class MoaTelemetryDecoder {
+public:
+    /**
+     * @brief Decode one batch
+     * @param out Receives the readings, oldest first
+     * @param maxReadings Capacity of out
+     * @return Number of readings, or -1 if the payload is malformed or does not fit
+     */
+    static int decode(const uint8_t* payload, size_t length, StatsReading* out, size_t maxReadings);
+};
+
+/**
+ * @brief Telemetry counters since boot or the last reset
+ */
+struct MoaTelemetryStats {
+    uint32_t readings;          ///< Readings packed into batches
+    uint32_t frames;            ///< Batches sealed into the ring
+    uint32_t bytes;             ///< Payload bytes sealed
+    uint32_t droppedFrames;     ///< Batches lost to a full ring (sender behind)
+    uint32_t sinkErrors;        ///< Batches the sink refused (reported by the sender)
+};
+
+/**
+ * @brief One sealed batch
+ */
+struct MoaTelemetryFrame {
+    uint8_t length;
+    uint8_t payload[MOA_TELEMETRY_MAX_PAYLOAD];
+};
+
+/**
+ * @brief Where the sender delivers batches (Jetson link or UDP)
+ */
+class IMoaTelemetrySink {
+public:
+    virtual ~IMoaTelemetrySink() {}
+
+    /**
+     * @brief Send one batch payload
+     * @return false if the batch was not sent (link down, buffer full)
+     */
+    virtual bool sendTelemetry(const uint8_t* payload, size_t length) = 0;
+};
+
+/**
+ * @brief Batching and hand-off between StatsTask and the sender
+ *
+ * offer() is the producer side (StatsTask only) and never blocks: when
+ * the ring is full the sealed batch is dropped and counted, so a slow or
+ * absent sink costs readings, not StatsTask time. take() is the consumer
+ * side (the sender only). Single producer, single consumer, no lock.
+ */
+class MoaTelemetryStream {
+public:
+    MoaTelemetryStream();
+
+    /**
+     * @brief Batch period (ms); 0 turns the stream off
+     *
+     * Takes effect at the next batch.
+     */
+    void setPeriod(uint32_t periodMs);
+    uint32_t getPeriod() const;
+
+    /**
+     * @brief Add a reading to the open batch (producer)
+     * @return true if a batch was sealed into the ring: wake the sender
+     */
+    bool offer(const StatsReading& reading);
+
+    /**
+     * @brief Oldest sealed batch (consumer)
+     * @return false if the ring is empty
+     */
+    bool take(MoaTelemetryFrame& frame);
+
+    /**
+     * @brief Count a batch the sink refused (consumer)
+     */
+    void reportSinkError();
+
+    MoaTelemetryStats getStats() const;
+    void resetStats();
+
+private:
+    MoaTelemetryEncoder _encoder;
+    std::atomic<uint32_t> _periodMs;
+    bool _open;                             ///< A batch has been started
+    uint32_t _batchStart;                   ///< Timestamp of the batch's first reading
+
+    MoaTelemetryFrame _ring[MOA_TELEMETRY_RING_FRAMES];
+    std::atomic<uint32_t> _written;         ///< Frames sealed (producer-owned counter)
+    std::atomic<uint32_t> _read;            ///< Frames taken (consumer-owned counter)
+
+    MoaTelemetryStats _stats;
+
+    /**
+     * @brief Move the open batch into the ring, or drop it if the ring is full
+     */
+    bool seal();
+};
@@ -0,0 +1,33 @@
+/**
+ * @file MoaTelemetryUdpSink.h
+ * @brief Telemetry sink sending each batch as one UDP datagram
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Only works while the WiFi STA is up (Config mode); otherwise every batch
+ * is refused and counted as a sink error. The payload is the bare batch
+ * (MoaTelemetry.h): a datagram needs no framing or CRC.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include "MoaTelemetry.h"
+#include "ConfigManager.h"
+#include "MoaWiFiManager.h"
+
+/**
+ * @brief UDP telemetry sink (destination from ConfigManager tlm_host/tlm_port)
+ */
+class MoaTelemetryUdpSink : public IMoaTelemetrySink {
+public:
+    MoaTelemetryUdpSink(ConfigManager& config, MoaWiFiManager& wifi);
+
+    bool sendTelemetry(const uint8_t* payload, size_t length) override;
+
+private:
+    ConfigManager& _config;
+    MoaWiFiManager& _wifi;
+    WiFiUDP _udp;
+};
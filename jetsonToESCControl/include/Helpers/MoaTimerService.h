@@ -0,0 +1,100 @@
+/**
+ * @file MoaTimerService.h
+ * @brief Timer events for the event queue, driven by one FreeRTOS tick
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Replaces one FreeRTOS software timer per timer ID. A single auto-reload
+ * xTimer advances a MoaTimerWheel every MOA_TIMER_TICK_MS; the timers that
+ * expire on a tick are posted together as TimerEvents once the wheel is
+ * released.
+ *
+ * start(), stop() and reset() are O(1) updates of the wheel under a short
+ * critical section: no timer-service command queue, no blocking, no heap.
+ * Delays are rounded up to whole ticks from the last tick, so a timer
+ * never fires early and at most one tick late.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/timers.h"
+#include "ControlCommand.h"
+#include "MoaEventChannel.h"
+#include "MoaTimerWheel.h"
+
+/**
+ * @brief Wheel resolution (ms)
+ */
+#define MOA_TIMER_TICK_MS   10
+
+/**
+ * @brief Timer events for the event queue
+ *
+ * ## Usage
+ * @code
+ * MoaTimerService timers;
+ * timers.begin(&events);
+ * timers.start(TIMER_ID_FULL_THROTTLE, 5000);
+ *
+ * // In ControlTask:
+ * // if (cmd.controlType == CONTROL_TYPE_TIMER &&
+ * //     TimerEvent(cmd).getTimerId() == TIMER_ID_FULL_THROTTLE) { ... }
+ * @endcode
+ */
+class MoaTimerService {
+public:
+    MoaTimerService();
+
+    /**
+     * @brief Create and start the tick timer
+     * @param eventQueue Channel to post expirations to
+     * @return false if the tick timer could not be created or started
+     */
+    bool begin(MoaEventChannel* eventQueue);
+
+    /**
+     * @brief Start or restart a timer
+     * @param timerId Timer ID (< MOA_TIMER_WHEEL_CAPACITY)
+     * @param durationMs Time until expiry (ms)
+     * @param autoReload Repeat every durationMs until stopped
+     * @return false if the ID is invalid or begin() has not run
+     */
+    bool start(uint8_t timerId, uint32_t durationMs, bool autoReload = false);
+
+    /**
+     * @brief Stop a timer (safe if it is not running)
+     * @return false if the ID is invalid
+     */
+    bool stop(uint8_t timerId);
+
+    /**
+     * @brief Restart a timer with the duration of its last start()
+     * @return false if the timer was never started
+     */
+    bool reset(uint8_t timerId);
+
+    bool isRunning(uint8_t timerId) const;
+
+    /**
+     * @brief Expirations dropped because the normal event lane was full
+     */
+    uint32_t getDroppedEvents() const;
+
+private:
+    MoaTimerWheel _wheel;
+    mutable portMUX_TYPE _mux;
+    TimerHandle_t _tickTimer;
+    MoaEventChannel* _eventQueue;
+    TickType_t _lastTickAt;             ///< FreeRTOS tick of the last wheel tick
+    uint32_t _droppedEvents;
+
+    /**
+     * @brief Delay in wheel ticks so the timer expires no earlier than durationMs from now
+     */
+    uint32_t toWheelTicks(uint32_t durationMs) const;
+
+    static void tickCallback(TimerHandle_t xTimer);
+    void onTick();
+};
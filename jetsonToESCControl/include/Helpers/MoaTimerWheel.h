@@ -0,0 +1,137 @@
+/**
+ * @file MoaTimerWheel.h
+ * @brief Hierarchical timer wheel with statically allocated timers
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Four wheels of 64 slots each, covering 2^24 ticks (46 h at 10 ms). A
+ * timer goes into the finest wheel that can hold its expiry; when a wheel
+ * wraps, the next slot of the coarser wheel is spread back over the finer
+ * ones ("cascade"). Each timer is a fixed node linked into one slot by
+ * index, so start(), stop() and restart() are O(1) and never allocate;
+ * tick() touches one slot plus, every 64 ticks, one cascade.
+ *
+ * The wheel counts abstract ticks and knows nothing about the clock or
+ * the event queue: MoaTimerService drives it from a single FreeRTOS tick
+ * and turns expirations into CONTROL_TYPE_TIMER events. Free of
+ * Arduino/FreeRTOS dependencies so it can be run in virtual time on the
+ * host (see test/native/test_timer_wheel).
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Timers available (IDs 0..N-1)
+ */
+#define MOA_TIMER_WHEEL_CAPACITY    16
+
+/**
+ * @brief Slots per wheel, as a power of two
+ */
+#define MOA_TIMER_WHEEL_BITS        6
+#define MOA_TIMER_WHEEL_SLOTS       (1U << MOA_TIMER_WHEEL_BITS)
+
+/**
+ * @brief Number of wheels
+ */
+#define MOA_TIMER_WHEEL_LEVELS      4
+
+/**
+ * @brief Longest delay or period (ticks); longer ones are clamped
+ */
+#define MOA_TIMER_WHEEL_MAX_TICKS   ((1UL << (MOA_TIMER_WHEEL_BITS * MOA_TIMER_WHEEL_LEVELS)) - 1)
+
+/**
+ * @brief Timer wheel (not thread-safe: the owner serializes access)
+ *
+ * ## Usage
+ * @code
+ * MoaTimerWheel wheel;
+ * wheel.start(TIMER_ID_THROTTLE, 24000);           // One-shot, 24000 ticks
+ * wheel.start(TIMER_ID_BLINK, 50, 50);             // Every 50 ticks
+ *
+ * uint8_t expired[MOA_TIMER_WHEEL_CAPACITY];
+ * uint8_t n = wheel.tick(expired);                 // Once per tick
+ * @endcode
+ */
+class MoaTimerWheel {
+public:
+    /**
+     * @brief Construct an empty wheel
+     * @param now Initial tick count (tests start near the 32-bit wrap)
+     */
+    explicit MoaTimerWheel(uint32_t now = 0);
+
+    /**
+     * @brief Arm a timer, replacing any pending expiry
+     * @param id Timer ID (< MOA_TIMER_WHEEL_CAPACITY)
+     * @param delayTicks Ticks until the first expiry (1..MOA_TIMER_WHEEL_MAX_TICKS)
+     * @param periodTicks Re-arm interval after each expiry, 0 = one-shot
+     * @return false if the ID is out of range
+     */
+    bool start(uint8_t id, uint32_t delayTicks, uint32_t periodTicks = 0);
+
+    /**
+     * @brief Disarm a timer
+     * @return true if it was running
+     */
+    bool stop(uint8_t id);
+
+    /**
+     * @brief Arm a timer again with the delay and period of its last start()
+     * @return false if the timer was never started
+     */
+    bool restart(uint8_t id);
+
+    bool isRunning(uint8_t id) const;
+
+    /**
+     * @brief Ticks until the timer expires, 0 if it is not running
+     */
+    uint32_t getRemainingTicks(uint8_t id) const;
+
+    /**
+     * @brief Advance one tick
+     * @param expired Receives the IDs that expired on this tick, in start order
+     *        within a slot (room for MOA_TIMER_WHEEL_CAPACITY)
+     * @return Number of IDs written
+     */
+    uint8_t tick(uint8_t* expired);
+
+    /**
+     * @brief Ticks processed since construction (wraps)
+     */
+    uint32_t getNow() const;
+
+    /**
+     * @brief Timers currently running
+     */
+    uint8_t getActiveCount() const;
+
+private:
+    static const uint8_t NONE = 0xFF;
+    static const uint16_t UNLINKED = 0xFFFF;
+
+    struct Node {
+        uint32_t expires;       ///< Absolute tick
+        uint32_t delay;         ///< Last start() delay (restart())
+        uint32_t period;        ///< 0 = one-shot
+        uint16_t bucket;        ///< level * SLOTS + slot, UNLINKED if not running
+        uint8_t prev;
+        uint8_t next;
+        bool started;           ///< start() was called at least once
+    };
+
+    uint32_t _now;
+    uint8_t _active;
+    Node _nodes[MOA_TIMER_WHEEL_CAPACITY];
+    uint8_t _heads[MOA_TIMER_WHEEL_LEVELS * MOA_TIMER_WHEEL_SLOTS];   ///< First node per slot
+    uint8_t _tails[MOA_TIMER_WHEEL_LEVELS * MOA_TIMER_WHEEL_SLOTS];   ///< Last node per slot (FIFO)
+
+    void link(uint8_t id);
+    void unlink(uint8_t id);
+    uint8_t detach(uint16_t bucket);
+    void cascade(uint8_t level);
+};
@@ -14,6 +14,7 @@
  * - Current Sensor: ACS759-200B (Hall effect, analog)
  * - Battery Monitoring: Voltage divider (analog)
  * - ESC Control: PWM output
+ * - Jetson companion: UART1 (framed binary link)
  */
 
 #pragma once
@@ -82,6 +83,16 @@
  */
 #define PIN_UART_RX             GPIO_NUM_21
 
+/**
+ * @brief Jetson link TX (UART1, to the Jetson RX)
+ */
+#define PIN_LINK_TX             GPIO_NUM_5
+
+/**
+ * @brief Jetson link RX (UART1, from the Jetson TX)
+ */
+#define PIN_LINK_RX             GPIO_NUM_6
+
 // =============================================================================
 // MCP23018 I2C Configuration
 // =============================================================================
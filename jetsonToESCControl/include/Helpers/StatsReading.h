@@ -11,7 +11,7 @@
 
 #pragma once
 
-#include <Arduino.h>
+#include <stdint.h>
 
 /**
  * @brief Stats type identifiers
@@ -19,6 +19,8 @@
 #define STATS_TYPE_TEMPERATURE  1
 #define STATS_TYPE_BATTERY      2
 #define STATS_TYPE_CURRENT      3
+#define STATS_TYPE_TEMP_MOTOR   4   ///< Motor DS18B20 probe, degC x 10 (snapshot only)
+#define STATS_TYPE_TEMP_BATTERY 5   ///< Battery DS18B20 probe, degC x 10 (snapshot only)
 
 /**
  * @brief Stats reading structure for telemetry
@@ -21,7 +21,14 @@
 class MoaBattControl;
 class MoaCurrentControl;
 class MoaTempControl;
+class MoaDs18b20Bus;
 class ESCController;
+class MoaStatsAggregator;
+class MoaMcpDevice;
+class MoaTaskMonitor;
+class MoaEventChannel;
+class MoaJetsonLink;
+class MoaTelemetryStream;
 
 /**
  * @brief Maximum input line length
@@ -42,11 +49,21 @@ public:
      * @param batt Reference to battery control (for hot-reload)
      * @param current Reference to current control (for hot-reload)
      * @param temp Reference to temperature control (for hot-reload)
+     * @param probes Reference to the DS18B20 probe bus (for 'probes', hot-reload)
      * @param esc Reference to ESC controller (for hot-reload)
+     * @param stats Reference to stats aggregator (for 'stats')
+     * @param mcp Reference to the MCP23018 (I2C traffic in 'stats')
+     * @param tasks Reference to the task monitor (for 'perf')
+     * @param events Reference to the control event channel (for 'events')
+     * @param link Reference to the Jetson link (for 'link')
+     * @param telemetry Reference to the telemetry stream (for 'telemetry', hot-reload)
      */
     UartCli(ConfigManager& config, MoaBattControl& batt,
             MoaCurrentControl& current, MoaTempControl& temp,
-            ESCController& esc);
+            MoaDs18b20Bus& probes, ESCController& esc, MoaStatsAggregator& stats,
+            MoaMcpDevice& mcp, MoaTaskMonitor& tasks,
+            MoaEventChannel& events, MoaJetsonLink& link,
+            MoaTelemetryStream& telemetry);
 
     /**
      * @brief Initialize the CLI (prints welcome banner)
@@ -64,7 +81,14 @@ private:
     MoaBattControl& _batt;
     MoaCurrentControl& _current;
     MoaTempControl& _temp;
+    MoaDs18b20Bus& _probes;
     ESCController& _esc;
+    MoaStatsAggregator& _stats;
+    MoaMcpDevice& _mcp;
+    MoaTaskMonitor& _tasks;
+    MoaEventChannel& _events;
+    MoaJetsonLink& _link;
+    MoaTelemetryStream& _telemetry;
 
     char _lineBuf[UART_CLI_MAX_LINE];
     uint8_t _linePos;
@@ -90,6 +114,59 @@ private:
      */
     void handleDump();
 
+    /**
+     * @brief Print live readings and session history summary
+     */
+    void handleStats();
+
+    /**
+     * @brief Print (or clear) the control path latency histograms
+     */
+    void handleLatency(bool reset);
+
+    /**
+     * @brief Print per-task stack, CPU and loop jitter; 'reset' clears, 'hex' dumps the binary record
+     */
+    void handlePerf(const char* arg);
+
+    /**
+     * @brief Print (or clear) the per-producer event counters
+     */
+    void handleEvents(bool reset);
+
+    /**
+     * @brief Print (or clear) the Jetson link frame and error counters
+     */
+    void handleLink(bool reset);
+
+    /**
+     * @brief Print (or clear) the telemetry stream counters
+     */
+    void handleTelemetry(bool reset);
+
+    /**
+     * @brief Print charge, energy, state of charge and ride time
+     */
+    void handleEnergy();
+
+    /**
+     * @brief Print the DS18B20 probes: role, ROM, resolution, last reading, counters
+     */
+    void handleProbes();
+
+    /**
+     * @brief Store found probe #index as the ROM of a role and save (bound at next boot)
+     * @param index Index in the 'probes' found list
+     * @param roleName esc, motor or battery
+     */
+    void handleProbeAssign(const char* index, const char* roleName);
+
+    /**
+     * @brief Forget the ROM of a role and save
+     * @param roleName esc, motor or battery
+     */
+    void handleProbeClear(const char* roleName);
+
     /**
      * @brief Print help text
      */
@@ -5,11 +5,12 @@
 class BatteryLowState : public MoaState{
     MoaStateMachine& _moaMachine;
 public:
-    BatteryLowState(MoaStateMachine& moaMachine, MoaDevicesManager& devices);
+    BatteryLowState(MoaStateMachine& moaMachine, IMoaActions& devices);
     void onEnter() override;
-    void buttonClick(ControlCommand command) override;
-    void overcurrentDetected(ControlCommand command) override;
-    void temperatureCrossedLimit(ControlCommand command) override;
-    void batteryLevelCrossedLimit(ControlCommand command) override;
-    void timerExpired(ControlCommand command) override;
+    void buttonClick(ButtonEvent command) override;
+    void overcurrentDetected(CurrentEvent command) override;
+    void temperatureCrossedLimit(TempEvent command) override;
+    void batteryLevelCrossedLimit(BattEvent command) override;
+    void timerExpired(TimerEvent command) override;
+    void remoteCommand(RemoteEvent command) override;
 };
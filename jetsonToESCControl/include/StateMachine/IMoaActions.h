@@ -0,0 +1,49 @@
+/**
+ * @file IMoaActions.h
+ * @brief Outputs the state machine may drive
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * The subset of MoaDevicesManager used by state handlers and entry
+ * actions. Both state machine engines (MoaStateMachine and MoaStateTable)
+ * talk to this interface only, so they can run on the host against a
+ * recording double.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "MoaBattLevel.h"
+
+/**
+ * @brief State machine outputs (ESC, LEDs, OTA, log)
+ */
+class IMoaActions {
+public:
+    virtual ~IMoaActions() {}
+
+    // === ESC ===
+    virtual void stopMotor() = 0;
+    virtual void engageThrottle(uint8_t commandType) = 0;
+    virtual void disengageThrottle() = 0;
+    virtual void handleThrottleStepDown() = 0;
+    virtual void setRemoteThrottle(uint16_t duty) = 0;
+
+    // === LED indicators ===
+    virtual void showBatteryLevel(MoaBattLevel level) = 0;
+    virtual void indicateOverheat(bool active) = 0;
+    virtual void indicateOvercurrent(bool active) = 0;
+    virtual void showBoardLocked() = 0;
+    virtual void showBoardUnlocked() = 0;
+    virtual void enterConfigMode() = 0;
+    virtual void exitConfigMode() = 0;
+    virtual void waveAllLeds(bool fast = false) = 0;
+    virtual void refreshLedIndicators() = 0;
+
+    // === OTA ===
+    virtual void startOTA() = 0;
+    virtual void stopOTA() = 0;
+
+    // === Logging ===
+    virtual void logSystem(uint8_t code) = 0;
+};
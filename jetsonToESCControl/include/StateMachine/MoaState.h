@@ -1,18 +1,19 @@
 #pragma once
 
 #include "ControlCommand.h"
-#include "MoaDevicesManager.h"
+#include "IMoaActions.h"
 
 class MoaState{
 protected:
-    MoaDevicesManager& _devices;
+    IMoaActions& _devices;
 public:
-    MoaState(MoaDevicesManager& devices) : _devices(devices) {}
+    MoaState(IMoaActions& devices) : _devices(devices) {}
     virtual ~MoaState(){}
     virtual void onEnter() = 0;
-    virtual void buttonClick(ControlCommand command) = 0;
-    virtual void overcurrentDetected(ControlCommand command) = 0;
-    virtual void temperatureCrossedLimit(ControlCommand command) = 0;
-    virtual void batteryLevelCrossedLimit(ControlCommand command) = 0;  
-    virtual void timerExpired(ControlCommand command) = 0;
+    virtual void buttonClick(ButtonEvent command) = 0;
+    virtual void overcurrentDetected(CurrentEvent command) = 0;
+    virtual void temperatureCrossedLimit(TempEvent command) = 0;
+    virtual void batteryLevelCrossedLimit(BattEvent command) = 0;  
+    virtual void timerExpired(TimerEvent command) = 0;
+    virtual void remoteCommand(RemoteEvent command) = 0;
 };
\ No newline at end of file
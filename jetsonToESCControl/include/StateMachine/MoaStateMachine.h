@@ -1,7 +1,8 @@
 #pragma once
 
 #include "MoaState.h"
-#include "MoaDevicesManager.h"
+#include "IMoaActions.h"
+#include "MoaStateTable.h"
 
 class MoaStateMachine{
     MoaState* _state;
@@ -13,13 +14,18 @@ class MoaStateMachine{
     MoaState* _batteryLowState;
     MoaState* _configState;
 public:
-    MoaStateMachine(MoaDevicesManager& devices);
-    void buttonClick(ControlCommand command);
-    void overcurrentDetected(ControlCommand command);
-    void temperatureCrossedLimit(ControlCommand command);
-    void batteryLevelCrossedLimit(ControlCommand command);
-    void timerExpired(ControlCommand command);
+    MoaStateMachine(IMoaActions& devices);
+    ~MoaStateMachine();
+    void buttonClick(ButtonEvent command);
+    void overcurrentDetected(CurrentEvent command);
+    void temperatureCrossedLimit(TempEvent command);
+    void batteryLevelCrossedLimit(BattEvent command);
+    void timerExpired(TimerEvent command);
+    void remoteCommand(RemoteEvent command);
     void setState(MoaState* state);
+    MoaState* getState();
+    const char* getStateName() const;
+    MoaStateId getStateId() const;
     MoaState* getInitState();
     MoaState* getIdleState();
     MoaState* getSurfingState();
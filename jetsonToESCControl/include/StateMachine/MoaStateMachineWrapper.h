@@ -13,13 +13,16 @@
 #include <Arduino.h>
 #include "ControlCommand.h"
 #include "MoaDevicesManager.h"
+#include "Constants.h"
 #include "StateMachine/MoaStateMachine.h"
+#include "StateMachine/MoaStateTable.h"
 
 /**
  * @brief Wrapper that adapts control events to the state machine
  * 
  * Wraps the MoaStateMachine and adapts ControlCommand events to state machine methods.
  * Handles event-specific logic like LED updates and logging before delegating to the state machine.
+ * The engine (MoaState classes or MoaStateTable) is chosen with MOA_STATE_MACHINE_TABLE.
  * 
  * ## Usage
  * @code
@@ -28,7 +31,7 @@
  * 
  * // In ControlTask:
  * ControlCommand cmd;
- * if (xQueueReceive(queue, &cmd, portMAX_DELAY)) {
+ * if (events.receive(cmd, portMAX_DELAY)) {
  *     wrapper.handleEvent(cmd);
  * }
  * @endcode
@@ -57,42 +60,64 @@ public:
      * 
      * Routes the event to the appropriate state machine method based
      * on controlType, logs the event, and updates devices as needed.
+     * This is the one place a ControlCommand becomes a typed view.
      * 
      * @param cmd The control command to handle
      */
     void handleEvent(ControlCommand cmd);
 
+    /**
+     * @brief Name of the current state ("Idle", "Surfing", ...)
+     * @return const char* Same names for both engines
+     */
+    const char* getStateName() const;
+
+    /**
+     * @brief Id of the current state (same ids for both engines)
+     */
+    MoaStateId getStateId() const;
+
 private:
+#if MOA_STATE_MACHINE_TABLE
+    MoaStateTable _stateMachine;
+#else
     MoaStateMachine _stateMachine;
+#endif
     MoaDevicesManager& _devices;
 
     /**
      * @brief Handle timer event
-     * @param cmd Control command with timer info
+     * @param event Typed timer event
      */
-    void handleTimerEvent(ControlCommand& cmd);
+    void handleTimerEvent(const TimerEvent& event);
 
     /**
      * @brief Handle temperature event
-     * @param cmd Control command with temperature info
+     * @param event Typed temperature event
      */
-    void handleTemperatureEvent(ControlCommand& cmd);
+    void handleTemperatureEvent(const TempEvent& event);
 
     /**
      * @brief Handle battery event
-     * @param cmd Control command with battery info
+     * @param event Typed battery event
      */
-    void handleBatteryEvent(ControlCommand& cmd);
+    void handleBatteryEvent(const BattEvent& event);
 
     /**
      * @brief Handle current event
-     * @param cmd Control command with current info
+     * @param event Typed current event
      */
-    void handleCurrentEvent(ControlCommand& cmd);
+    void handleCurrentEvent(const CurrentEvent& event);
 
     /**
      * @brief Handle button event
-     * @param cmd Control command with button info
+     * @param event Typed button event
+     */
+    void handleButtonEvent(const ButtonEvent& event);
+
+    /**
+     * @brief Handle Jetson link event
+     * @param event Typed remote event
      */
-    void handleButtonEvent(ControlCommand& cmd);
+    void handleRemoteEvent(const RemoteEvent& event);
 };
@@ -0,0 +1,132 @@
+/**
+ * @file MoaStateTable.h
+ * @brief Table-driven state machine engine
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Alternative to MoaStateMachine + MoaState subclasses. States, events,
+ * guards and actions are rows of one constexpr transition table; a
+ * compile-time index maps (state, event) straight to its rows, so a
+ * dispatch is one lookup plus at most a couple of guard calls, with no
+ * virtual calls and no heap. The table is checked by static_asserts in
+ * MoaStateTable.cpp: rows must be grouped by state and event, an
+ * unguarded row may not hide a later one, and transitions that break the
+ * safety rules (throttle only from Idle, Config only from Init) do not
+ * compile.
+ *
+ * Behaviour matches the seven MoaState classes one for one; the host test
+ * test_state_table drives both engines with the same events and compares
+ * every output. Selected with MOA_STATE_MACHINE_TABLE in Constants.h.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ControlCommand.h"
+#include "IMoaActions.h"
+
+/**
+ * @brief State identifiers (table row order)
+ */
+enum class MoaStateId : uint8_t {
+    INIT,
+    IDLE,
+    SURFING,
+    OVER_HEATING,
+    OVER_CURRENT,
+    BATTERY_LOW,
+    CONFIG,
+    COUNT,
+    NONE = 0xFF     ///< Transition target: stay, no entry action
+};
+
+/**
+ * @brief Event identifiers, one per controlType routed by the wrapper
+ */
+enum class MoaEventId : uint8_t {
+    BUTTON,         ///< CONTROL_TYPE_BUTTON
+    CURRENT,        ///< CONTROL_TYPE_CURRENT
+    TEMPERATURE,    ///< CONTROL_TYPE_TEMPERATURE
+    BATTERY,        ///< CONTROL_TYPE_BATTERY
+    TIMER,          ///< CONTROL_TYPE_TIMER
+    REMOTE,         ///< CONTROL_TYPE_REMOTE
+    COUNT
+};
+
+typedef bool (*MoaGuardFn)(const ControlCommand& command);
+typedef void (*MoaActionFn)(IMoaActions& actions, const ControlCommand& command);
+typedef void (*MoaEntryFn)(IMoaActions& actions);
+
+/**
+ * @brief One row of the transition table
+ *
+ * Rows for the same state and event are tried in order; the first whose
+ * guard passes is taken: its action runs, then the target's entry action.
+ */
+struct MoaTransition {
+    MoaStateId from;        ///< Current state
+    MoaEventId event;       ///< Triggering event
+    MoaGuardFn guard;       ///< Condition on the command (nullptr = always)
+    MoaActionFn action;     ///< Transition action (nullptr = none)
+    MoaStateId to;          ///< Target state (MoaStateId::NONE = stay)
+};
+
+/**
+ * @brief State machine driven by a constexpr transition table
+ *
+ * ## Usage
+ * @code
+ * MoaStateTable machine(devicesManager);
+ * machine.start();                    // Enter Init, run its entry action
+ * machine.buttonClick(cmd);           // Or dispatch(MoaEventId::BUTTON, cmd)
+ * @endcode
+ */
+class MoaStateTable {
+public:
+    /**
+     * @param actions Outputs driven by transitions and entry actions
+     */
+    explicit MoaStateTable(IMoaActions& actions);
+
+    /**
+     * @brief Enter the initial state (runs the Init entry action)
+     */
+    void start();
+
+    /**
+     * @brief Run one event through the table
+     * @param event Event identifier
+     * @param command Event (guards read it through the typed view of the event)
+     * @return true if a transition row was taken
+     */
+    bool dispatch(MoaEventId event, const ControlCommand& command);
+
+    void buttonClick(ButtonEvent command);
+    void overcurrentDetected(CurrentEvent command);
+    void temperatureCrossedLimit(TempEvent command);
+    void batteryLevelCrossedLimit(BattEvent command);
+    void timerExpired(TimerEvent command);
+    void remoteCommand(RemoteEvent command);
+
+    /**
+     * @brief Current state
+     */
+    MoaStateId getState() const;
+
+    /**
+     * @brief Printable state name ("Init", "Idle", ...)
+     */
+    static const char* getStateName(MoaStateId state);
+
+    /**
+     * @brief Number of rows in the transition table
+     */
+    static size_t getTransitionCount();
+
+private:
+    IMoaActions& _actions;  ///< Outputs
+    MoaStateId _state;      ///< Current state
+
+    void enter(MoaStateId state);
+};
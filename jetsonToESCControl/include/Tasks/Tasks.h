@@ -19,12 +19,24 @@
  * @brief Sensor monitoring task
  * 
  * Periodically calls update() on temperature, battery, and current
- * sensor producers. Runs at TASK_PERIOD_SENSOR_MS interval.
+ * sensor producers. Runs at TASK_PERIOD_SENSOR_MS interval. Current and
+ * battery consume the blocks decimated by ProtectionTask.
  * 
  * @param pvParameters Pointer to MoaMainUnit instance
  */
 void SensorTask(void* pvParameters);
 
+/**
+ * @brief Protection task
+ * 
+ * Drains the continuous ADC every TASK_PROTECTION_PERIOD_MS, running the
+ * per-sample fast overcurrent trip on the current channel. Highest
+ * priority task so a trip is never delayed by sensor or control work.
+ * 
+ * @param pvParameters Pointer to MoaMainUnit instance
+ */
+void ProtectionTask(void* pvParameters);
+
 /**
  * @brief I/O handling task
  * 
@@ -72,3 +84,23 @@ void CliTask(void* pvParameters);
  * @param pvParameters Pointer to MoaMainUnit instance
  */
 void OtaTask(void* pvParameters);
+
+/**
+ * @brief Jetson link task (event-driven)
+ * 
+ * Blocks on the UART driver event queue and feeds received bursts to
+ * the link session, which queues remote events and writes the replies.
+ * 
+ * @param pvParameters Pointer to MoaMainUnit instance
+ */
+void LinkTask(void* pvParameters);
+
+/**
+ * @brief Telemetry sender task (event-driven)
+ * 
+ * Woken by StatsTask whenever a telemetry batch is sealed; sends every
+ * pending batch to the configured sink (Jetson link or UDP).
+ * 
+ * @param pvParameters Pointer to MoaMainUnit instance
+ */
+void TelemetryTask(void* pvParameters);
@@ -0,0 +1,289 @@
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the arduino-esp32 core used by the firmware
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Part of the simulated HAL (sim env). Time comes from MoaSimKernel
+ * (virtual), pins, analog inputs and LEDC channels from MoaSimBoard.
+ * Serial writes to stdout; its receive side is fed by the board's
+ * scenario. Only the API surface the firmware uses is provided.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/timers.h"
+
+using std::abs;
+using std::isinf;
+using std::isnan;
+using std::max;
+using std::min;
+
+#define IRAM_ATTR
+#define PROGMEM
+#define F(string_literal) (string_literal)
+
+// =============================================================================
+// Pins (values as in esp32-hal-gpio.h)
+// =============================================================================
+
+#define LOW             0x0
+#define HIGH            0x1
+
+#define INPUT           0x01
+#define OUTPUT          0x03
+#define PULLUP          0x04
+#define INPUT_PULLUP    0x05
+#define PULLDOWN        0x08
+#define INPUT_PULLDOWN  0x09
+#define OPEN_DRAIN      0x10
+
+#define RISING          0x01
+#define FALLING         0x02
+#define CHANGE          0x03
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+static inline int digitalPinToInterrupt(uint8_t pin) {
+    return pin;
+}
+
+/**
+ * @brief ADC1 channel of a pin (ESP32-C3: GPIO0-4), -1 if none
+ */
+static inline int8_t digitalPinToAnalogChannel(uint8_t pin) {
+    return (pin <= 4) ? static_cast<int8_t>(pin) : -1;
+}
+
+uint16_t analogRead(uint8_t pin);
+uint32_t analogReadMilliVolts(uint8_t pin);
+void analogReadResolution(uint8_t bits);
+
+// =============================================================================
+// LEDC PWM
+// =============================================================================
+
+double ledcSetup(uint8_t channel, double freq, uint8_t resolution_bits);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcWrite(uint8_t channel, uint32_t duty);
+uint32_t ledcRead(uint8_t channel);
+
+// =============================================================================
+// Time (virtual)
+// =============================================================================
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+// =============================================================================
+// String
+// =============================================================================
+
+/**
+ * @brief Arduino String on top of std::string
+ */
+class String {
+public:
+    String() {}
+    String(const char* text) : _s(text != nullptr ? text : "") {}
+    String(const std::string& text) : _s(text) {}
+    String(char c) : _s(1, c) {}
+    String(int value) : _s(std::to_string(value)) {}
+    String(unsigned int value) : _s(std::to_string(value)) {}
+    String(long value) : _s(std::to_string(value)) {}
+    String(unsigned long value) : _s(std::to_string(value)) {}
+    String(float value, unsigned int decimals = 2) { format(value, decimals); }
+    String(double value, unsigned int decimals = 2) { format(value, decimals); }
+
+    const char* c_str() const { return _s.c_str(); }
+    unsigned int length() const { return static_cast<unsigned int>(_s.size()); }
+    bool isEmpty() const { return _s.empty(); }
+    char operator[](unsigned int index) const { return index < _s.size() ? _s[index] : '\0'; }
+
+    String& operator+=(const String& rhs) { _s += rhs._s; return *this; }
+    String& operator+=(const char* rhs) { _s += rhs; return *this; }
+    String& operator+=(char rhs) { _s += rhs; return *this; }
+    friend String operator+(String lhs, const String& rhs) { lhs += rhs; return lhs; }
+    friend String operator+(String lhs, const char* rhs) { lhs += rhs; return lhs; }
+    bool operator==(const String& rhs) const { return _s == rhs._s; }
+    bool operator==(const char* rhs) const { return _s == rhs; }
+    bool operator!=(const String& rhs) const { return _s != rhs._s; }
+    bool operator!=(const char* rhs) const { return _s != rhs; }
+
+    bool equals(const String& rhs) const { return _s == rhs._s; }
+    bool equalsIgnoreCase(const String& rhs) const { return strcasecmp(c_str(), rhs.c_str()) == 0; }
+    bool startsWith(const String& prefix) const { return _s.compare(0, prefix._s.size(), prefix._s) == 0; }
+    int indexOf(char c, unsigned int from = 0) const {
+        size_t pos = _s.find(c, from);
+        return pos == std::string::npos ? -1 : static_cast<int>(pos);
+    }
+    String substring(unsigned int from) const { return from < _s.size() ? String(_s.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        return from < to && from < _s.size() ? String(_s.substr(from, to - from)) : String();
+    }
+    void trim() {
+        size_t first = _s.find_first_not_of(" \t\r\n");
+        size_t last = _s.find_last_not_of(" \t\r\n");
+        _s = (first == std::string::npos) ? std::string() : _s.substr(first, last - first + 1);
+    }
+    void toLowerCase() { for (char& c : _s) c = static_cast<char>(tolower(static_cast<unsigned char>(c))); }
+    long toInt() const { return strtol(_s.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(_s.c_str(), nullptr); }
+
+private:
+    std::string _s;
+
+    void format(double value, unsigned int decimals) {
+        char buffer[48];
+        snprintf(buffer, sizeof(buffer), "%.*f", static_cast<int>(decimals), value);
+        _s = buffer;
+    }
+};
+
+// =============================================================================
+// Print / Stream / Serial
+// =============================================================================
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+/**
+ * @brief Arduino Print: formatting on top of write()
+ */
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size-- > 0) {
+            n += write(*buffer++);
+        }
+        return n;
+    }
+
+    size_t write(const char* text) {
+        return (text != nullptr) ? write(reinterpret_cast<const uint8_t*>(text), strlen(text)) : 0;
+    }
+
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    size_t print(const char* text) { return write(text); }
+    size_t print(const String& text) { return write(text.c_str()); }
+    size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+    size_t print(unsigned char value, int base = DEC) { return printNumber(value, base); }
+    size_t print(int value, int base = DEC) { return printSigned(value, base); }
+    size_t print(unsigned int value, int base = DEC) { return printNumber(value, base); }
+    size_t print(long value, int base = DEC) { return printSigned(value, base); }
+    size_t print(unsigned long value, int base = DEC) { return printNumber(value, base); }
+    size_t print(long long value, int base = DEC) { return printSigned(value, base); }
+    size_t print(unsigned long long value, int base = DEC) { return printNumber(value, base); }
+    size_t print(double value, int digits = 2) { return printf("%.*f", digits, value); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T& value) { size_t n = print(value); return n + println(); }
+    template <typename T>
+    size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+
+private:
+    size_t printSigned(long long value, int base) {
+        if (base == DEC && value < 0) {
+            return print('-') + printNumber(static_cast<unsigned long long>(-(value + 1)) + 1, base);
+        }
+        return printNumber(static_cast<unsigned long long>(value), base);
+    }
+
+    size_t printNumber(unsigned long long value, int base) {
+        char buffer[8 * sizeof(value) + 1];
+        char* p = &buffer[sizeof(buffer) - 1];
+        *p = '\0';
+        if (base < 2) {
+            base = 10;
+        }
+        do {
+            int digit = static_cast<int>(value % base);
+            *--p = static_cast<char>(digit < 10 ? '0' + digit : 'A' + digit - 10);
+            value /= base;
+        } while (value > 0);
+        return write(p);
+    }
+};
+
+/**
+ * @brief Arduino Stream: Print plus a receive side
+ */
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+/**
+ * @brief Serial port: TX to stdout (or a capture buffer), RX from injected text
+ */
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void end() {}
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    int availableForWrite() override { return 256; }
+    void flush() override;
+
+    int available() override { return static_cast<int>(_rx.size() - _rxPos); }
+    int read() override { return _rxPos < _rx.size() ? static_cast<uint8_t>(_rx[_rxPos++]) : -1; }
+    int peek() override { return _rxPos < _rx.size() ? static_cast<uint8_t>(_rx[_rxPos]) : -1; }
+
+    /**
+     * @brief Queue bytes for the firmware to read (host / scenario side)
+     */
+    void inject(const char* text);
+
+    /**
+     * @brief Redirect TX into a buffer instead of stdout (nullptr = stdout)
+     */
+    void setCapture(std::string* capture) { _capture = capture; }
+
+private:
+    std::string _rx;
+    size_t _rxPos = 0;
+    std::string* _capture = nullptr;
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,51 @@
+/**
+ * @file ArduinoOTA.h
+ * @brief Host stand-in for the arduino-esp32 ArduinoOTA service
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Part of the simulated HAL (sim env). Callbacks are stored but no update
+ * ever arrives.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+
+#define U_FLASH     0
+#define U_SPIFFS    100
+
+typedef enum {
+    OTA_AUTH_ERROR,
+    OTA_BEGIN_ERROR,
+    OTA_CONNECT_ERROR,
+    OTA_RECEIVE_ERROR,
+    OTA_END_ERROR
+} ota_error_t;
+
+class ArduinoOTAClass {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+    typedef std::function<void(ota_error_t)> THandlerFunction_Error;
+    typedef std::function<void(unsigned int, unsigned int)> THandlerFunction_Progress;
+
+    ArduinoOTAClass& setHostname(const char* hostname) { (void)hostname; return *this; }
+    ArduinoOTAClass& onStart(THandlerFunction fn) { _start = fn; return *this; }
+    ArduinoOTAClass& onEnd(THandlerFunction fn) { _end = fn; return *this; }
+    ArduinoOTAClass& onProgress(THandlerFunction_Progress fn) { _progress = fn; return *this; }
+    ArduinoOTAClass& onError(THandlerFunction_Error fn) { _error = fn; return *this; }
+
+    void begin() {}
+    void end() {}
+    void handle() {}
+    int getCommand() const { return U_FLASH; }
+
+private:
+    THandlerFunction _start;
+    THandlerFunction _end;
+    THandlerFunction_Progress _progress;
+    THandlerFunction_Error _error;
+};
+
+extern ArduinoOTAClass ArduinoOTA;
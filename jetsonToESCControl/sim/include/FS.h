@@ -0,0 +1,87 @@
+/**
+ * @file FS.h
+ * @brief Host stand-in for the arduino-esp32 file system API
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Part of the simulated HAL (sim env). Files live in memory for the
+ * lifetime of the process, so a run starts from an empty flash.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+
+namespace fs {
+
+/**
+ * @brief Contents of one simulated file
+ */
+typedef std::shared_ptr<std::string> FileData;
+
+/**
+ * @brief Open file handle (read, write or append)
+ */
+class File {
+public:
+    File() : _position(0), _writable(false) {}
+    File(FileData data, bool writable, bool append)
+        : _data(data), _position(append ? data->size() : 0), _writable(writable) {}
+
+    explicit operator bool() const { return static_cast<bool>(_data); }
+
+    size_t size() const { return _data ? _data->size() : 0; }
+    size_t position() const { return _position; }
+
+    bool seek(uint32_t position) {
+        if (!_data || position > _data->size()) {
+            return false;
+        }
+        _position = position;
+        return true;
+    }
+
+    size_t read(uint8_t* buffer, size_t length) {
+        if (!_data || _position >= _data->size()) {
+            return 0;
+        }
+        size_t n = std::min(length, _data->size() - _position);
+        memcpy(buffer, _data->data() + _position, n);
+        _position += n;
+        return n;
+    }
+
+    size_t write(const uint8_t* buffer, size_t length) {
+        if (!_data || !_writable) {
+            return 0;
+        }
+        _data->replace(_position, std::min(length, _data->size() - _position),
+                       reinterpret_cast<const char*>(buffer), length);
+        _position += length;
+        return length;
+    }
+
+    void close() { _data.reset(); }
+
+private:
+    FileData _data;
+    size_t _position;
+    bool _writable;
+};
+
+/**
+ * @brief File system: path -> contents
+ */
+class FS {
+public:
+    File open(const char* path, const char* mode = "r");
+    bool exists(const char* path);
+    bool remove(const char* path);
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
@@ -0,0 +1,32 @@
+/**
+ * @file LittleFS.h
+ * @brief Host stand-in for the arduino-esp32 LittleFS partition
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Part of the simulated HAL (sim env): an in-memory FS that always mounts.
+ */
+
+#pragma once
+
+#include "FS.h"
+
+namespace fs {
+
+class LittleFSFS : public FS {
+public:
+    bool begin(bool formatOnFail = false, const char* basePath = "/littlefs",
+               uint8_t maxOpenFiles = 10, const char* partitionLabel = "spiffs") {
+        (void)formatOnFail;
+        (void)basePath;
+        (void)maxOpenFiles;
+        (void)partitionLabel;
+        return true;
+    }
+
+    void end() {}
+};
+
+} // namespace fs
+
+extern fs::LittleFSFS LittleFS;
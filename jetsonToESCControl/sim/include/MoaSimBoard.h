@@ -0,0 +1,270 @@
+/**
+ * @file MoaSimBoard.h
+ * @brief Simulated Moa controller board behind the host HAL
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Wires the HAL stand-ins to models of the real hardware, using the pin
+ * assignments from PinMapping.h:
+ * - I2C bus with the MCP23018 (SimulatedMcp23018); buttons pull Port A
+ *   inputs low, INTA drives PIN_I2C_INT_A and fires its interrupt handler,
+ *   PIN_I2C_RESET low resets the expander.
+ * - Analog inputs from MoaSimPlant: battery divider on PIN_BATT_LEVEL_SENSE,
+ *   hall sensor on PIN_CURRENT_SENSE, NTC divider (NTC_* constants) on
+ *   PIN_TEMP_SENSE, for analogRead(), analogReadMilliVolts() and the
+ *   continuous (DMA) ADC driver. Conversions carry a few LSB of
+ *   deterministic noise.
+ * - LEDC channel on PIN_ESC_PWM: the pulse width sets the motor throttle.
+ * - 1-Wire bus on PIN_TEMP_SENSE (SimulatedDs18b20Bus) with the ESC, motor
+ *   and battery DS18B20 probes: the ESC probe reads the plant temperature,
+ *   the others a share of its rise above the water. provisionProbes() stores
+ *   their ROMs as the roles, as the installer does with 'probes assign'.
+ * - UART driver ports (the Jetson link): scenario bytes arrive after their
+ *   wire time, written bytes are captured.
+ *
+ * Scenario actions are scheduled on the virtual clock with schedule() and
+ * run as interrupts would, between task executions.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <string>
+#include <vector>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "MoaSimKernel.h"
+#include "MoaSimPlant.h"
+#include "SimulatedMcp23018.h"
+#include "SimulatedDs18b20Bus.h"
+
+class ConfigManager;
+
+#define MOA_SIM_PIN_COUNT       22
+#define MOA_SIM_LEDC_CHANNELS   6
+#define MOA_SIM_UART_PORTS      2
+
+/**
+ * @brief Plant integration step (us)
+ */
+#define MOA_SIM_PLANT_STEP_US   1000
+
+/**
+ * @brief Default ADC noise amplitude (+/- LSB)
+ */
+#define MOA_SIM_ADC_NOISE_LSB   2
+
+/**
+ * @brief ADC full-scale voltage assumed by the firmware (V)
+ */
+#define MOA_SIM_ADC_VREF        3.3f
+
+/**
+ * @brief Share of the ESC temperature rise above the water seen by the
+ *        motor and battery probes
+ */
+#define MOA_SIM_MOTOR_PROBE_RISE    0.6f
+#define MOA_SIM_BATTERY_PROBE_RISE  0.2f
+
+/**
+ * @brief The board: pins, buses and plant on one virtual clock
+ */
+class MoaSimBoard : public IMoaSimDevice {
+public:
+    static MoaSimBoard& instance();
+
+    // === Scenario (host and scheduled actions) ===
+
+    /**
+     * @brief Run an action at a virtual time (us since boot)
+     *
+     * Actions due at the same time run in scheduling order.
+     */
+    void schedule(uint64_t atUs, std::function<void()> action);
+
+    /**
+     * @brief Press / release a button on MCP23018 Port A (MCP_PIN_BUTTON_*)
+     */
+    void pressButton(uint8_t mcpPin);
+    void releaseButton(uint8_t mcpPin);
+
+    /**
+     * @brief MCP pin of a button by label ("stop", "25", "50", "75", "100"), -1 if unknown
+     */
+    static int buttonPin(const std::string& name);
+
+    /**
+     * @brief Type text into the serial port
+     */
+    void sendSerial(const char* text);
+
+    /**
+     * @brief Put bytes on the RX line of a UART driver port
+     *
+     * They reach the driver after their wire time (10 bits a byte at the
+     * configured baud rate, after any bytes still on the line) plus the RX
+     * timeout, as one UART_DATA event.
+     */
+    void sendUart(uint8_t port, const uint8_t* data, size_t length);
+
+    /**
+     * @brief Bytes the firmware wrote to a UART driver port since the last call
+     */
+    std::vector<uint8_t> takeUartOutput(uint8_t port);
+
+    /**
+     * @brief ADC noise amplitude (+/- LSB) and generator seed
+     */
+    void setAdcNoise(uint16_t amplitudeLsb, uint32_t seed);
+
+    MoaSimPlant& getPlant();
+    SimulatedMcp23018& getMcp();
+
+    /**
+     * @brief Save the ESC, motor and battery probe ROMs (TEMP_PROBE_* order)
+     *        as the configured roles; call before boot
+     */
+    void provisionProbes(ConfigManager& config);
+
+    /**
+     * @brief Duty written to the LEDC channel driving PIN_ESC_PWM
+     */
+    uint32_t getEscDuty() const;
+
+    /**
+     * @brief ESC pulse width (us), 0 before the channel is set up
+     */
+    float getEscPulseUs() const;
+
+    /**
+     * @brief MCP23018 Port B output latch (LEDs)
+     */
+    uint8_t getLedOutputs() const;
+
+    // === HAL backend (firmware side) ===
+
+    void pinMode(uint8_t pin, uint8_t mode);
+    void digitalWrite(uint8_t pin, uint8_t level);
+    int digitalRead(uint8_t pin);
+    void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+    void detachInterrupt(uint8_t pin);
+
+    uint16_t analogRead(uint8_t pin);
+    uint32_t analogReadMilliVolts(uint8_t pin);
+    void setAnalogResolution(uint8_t bits);
+
+    double ledcSetup(uint8_t channel, double frequency, uint8_t bits);
+    void ledcAttachPin(uint8_t pin, uint8_t channel);
+    void ledcWrite(uint8_t channel, uint32_t duty);
+    uint32_t ledcRead(uint8_t channel) const;
+
+    /**
+     * @brief I2C transfers (0 = ACK, 2 = address NACK)
+     */
+    uint8_t i2cWrite(uint8_t address, const uint8_t* data, size_t length);
+    uint8_t i2cRead(uint8_t address, uint8_t reg, uint8_t* data, size_t length);
+
+    /**
+     * @brief Continuous ADC: start over ADC1 channels at a sample rate;
+     *        results become readable a frame (frameBytes) at a time
+     */
+    void adcStart(const uint8_t* channels, uint8_t count, uint32_t sampleRateHz, uint32_t storeBytes,
+                  uint32_t frameBytes);
+    void adcStop();
+
+    /**
+     * @brief Drain converted results in driver format
+     * @param overrun Set when conversions were lost since the last drain
+     * @return Bytes written (multiple of 4)
+     */
+    uint32_t adcRead(uint8_t* buffer, uint32_t maxBytes, bool& overrun);
+
+    /**
+     * @brief UART driver: install with an event queue, line settings, data
+     */
+    bool uartInstall(uint8_t port, size_t rxBytes, QueueHandle_t events);
+    void uartUninstall(uint8_t port);
+    void uartSetBaud(uint8_t port, uint32_t baud);
+    void uartSetRxTimeout(uint8_t port, uint8_t symbols);
+    size_t uartRead(uint8_t port, uint8_t* buffer, size_t maxBytes);
+    void uartWrite(uint8_t port, const uint8_t* data, size_t length);
+    void uartFlushInput(uint8_t port);
+    size_t uartBuffered(uint8_t port) const;
+
+    /**
+     * @brief The 1-Wire bus, its probes brought up to the present plant state
+     */
+    SimulatedDs18b20Bus& oneWire();
+
+    // === IMoaSimDevice ===
+    uint64_t nextEventUs() const override;
+    void advance(uint64_t nowUs) override;
+
+private:
+    struct ScheduledAction {
+        uint64_t atUs;
+        uint64_t seq;
+        std::function<void()> action;
+    };
+
+    struct LedcChannel {
+        double frequency;
+        uint8_t bits;
+        uint32_t duty;
+        int8_t pin;
+    };
+
+    struct UartPort {
+        bool installed;
+        QueueHandle_t events;                       ///< Driver event queue (uart_event_t)
+        size_t rxCapacity;
+        std::vector<uint8_t> rx;                    ///< RX ring contents, oldest first
+        std::vector<uint8_t> tx;                    ///< Written, not yet taken
+        uint32_t baud;
+        uint8_t timeoutSymbols;
+        uint64_t lineFreeUs;                        ///< End of the last burst on the RX line
+    };
+
+    MoaSimBoard();
+
+    SimulatedMcp23018 _mcp;
+    SimulatedDs18b20Bus _oneWire;
+    MoaSimPlant _plant;
+    uint64_t _plantUs;                              ///< Time the plant was integrated to
+
+    std::vector<ScheduledAction> _actions;          ///< Sorted by (atUs, seq)
+    uint64_t _actionSeq;
+
+    uint8_t _pinModes[MOA_SIM_PIN_COUNT];
+    uint8_t _outputs[MOA_SIM_PIN_COUNT];
+    void (*_isr[MOA_SIM_PIN_COUNT])();
+    int _isrMode[MOA_SIM_PIN_COUNT];
+    int _intaLevel;                                 ///< Last level seen on PIN_I2C_INT_A
+    uint8_t _buttonLevels;                          ///< Port A input levels
+
+    uint8_t _analogBits;
+    uint16_t _noiseLsb;
+    uint32_t _noiseState;
+
+    LedcChannel _ledc[MOA_SIM_LEDC_CHANNELS];
+    UartPort _uart[MOA_SIM_UART_PORTS];
+
+    bool _adcRunning;
+    std::vector<uint8_t> _adcPattern;               ///< ADC1 channels, conversion order
+    uint32_t _adcRateHz;
+    uint32_t _adcStoreConversions;
+    uint32_t _adcFrameConversions;
+    uint64_t _adcLastUs;
+    uint64_t _adcRemainder;                         ///< Sub-conversion time carried over (us * Hz)
+    uint32_t _adcPending;                           ///< Converted, not yet read
+    size_t _adcNext;                                ///< Pattern index of the oldest pending conversion
+
+    void syncPlant();
+    void uartDeliver(uint8_t port, const std::vector<uint8_t>& bytes);
+    void updateInterruptLine();
+    float pinVoltage(uint8_t pin) const;
+    uint16_t convert(uint8_t pin, uint8_t bits);
+    int32_t nextNoise();
+};
@@ -0,0 +1,128 @@
+/**
+ * @file MoaSimKernel.h
+ * @brief Deterministic FreeRTOS scheduler on host threads, in virtual time
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Backs the freertos/ header stand-ins of the sim env. Every task gets a host
+ * thread, but a single baton decides which one runs: the highest-priority
+ * ready task, FIFO within a priority, as on the single-core ESP32-C3. A
+ * task keeps the baton until it blocks (delay, queue, semaphore) or wakes a
+ * higher-priority task, so task code takes no virtual time. When every task
+ * is blocked the clock jumps to the next wake-up, timer expiry or device
+ * event, which makes a run independent of host load and repeatable to the
+ * microsecond.
+ *
+ * The thread that calls boot() and run() is the host: it owns the baton
+ * whenever the simulation is paused and may then inspect or poke firmware
+ * state freely.
+ *
+ * @note A task that spins on millis() without blocking never lets virtual
+ *       time advance; busy waits must use delayMicroseconds().
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Hardware model driven by the kernel clock
+ */
+class IMoaSimDevice {
+public:
+    virtual ~IMoaSimDevice() {}
+
+    /**
+     * @brief Virtual time of the next scheduled device event (UINT64_MAX = none)
+     */
+    virtual uint64_t nextEventUs() const = 0;
+
+    /**
+     * @brief Run device events due at or before nowUs (interrupt context)
+     */
+    virtual void advance(uint64_t nowUs) = 0;
+};
+
+/**
+ * @brief Host-side control of the simulated scheduler
+ *
+ * ## Usage
+ * @code
+ * MoaSimKernel& kernel = MoaSimKernel::instance();
+ * kernel.boot(setup, loop);           // Arduino loopTask + timer service
+ * kernel.run(10000000);               // 10 s of virtual time
+ * @endcode
+ */
+class MoaSimKernel {
+public:
+    static MoaSimKernel& instance();
+
+    /**
+     * @brief Create the timer service and the Arduino loopTask
+     *
+     * loopTask (priority 1) calls setupFn once, then loopFn every tick.
+     */
+    void boot(void (*setupFn)(), void (*loopFn)());
+
+    /**
+     * @brief Let the tasks run for durationUs of virtual time (host only)
+     *
+     * Returns once every task is blocked past the end of the window.
+     */
+    void run(uint64_t durationUs);
+
+    /**
+     * @brief Virtual time since boot in microseconds
+     */
+    uint64_t nowUs() const;
+
+    /**
+     * @brief Burn virtual time in the running task (delayMicroseconds)
+     */
+    void busyWaitUs(uint32_t us);
+
+    /**
+     * @brief Run an interrupt handler
+     *
+     * Called from a task, switches to a higher-priority task it woke on
+     * return, like portYIELD_FROM_ISR.
+     */
+    void runIsr(void (*isr)());
+
+    /**
+     * @brief True while an interrupt handler or device event is running
+     */
+    bool inIsr() const;
+
+    /**
+     * @brief Attach the board model whose events share the clock
+     */
+    void setDevice(IMoaSimDevice* device);
+
+    /**
+     * @brief Call hook(context) on every scheduling decision (nullptr = none)
+     *
+     * Runs in the scheduler with the clock at the time of the decision and
+     * no task executing, so it may read firmware state that only changes
+     * while a task holds the baton (observers, tracing).
+     */
+    void setSwitchHook(void (*hook)(void*), void* context);
+
+    /**
+     * @brief Live (not deleted) tasks
+     */
+    uint32_t getTaskCount() const;
+
+    /**
+     * @brief Baton hand-overs since boot
+     */
+    uint64_t getContextSwitches() const;
+
+    /**
+     * @brief Name of the running task ("host" while paused)
+     */
+    const char* getCurrentTaskName() const;
+
+private:
+    MoaSimKernel() {}
+};
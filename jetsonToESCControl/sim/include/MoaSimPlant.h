@@ -0,0 +1,132 @@
+/**
+ * @file MoaSimPlant.h
+ * @brief Physical model behind the simulated sensors: motor, battery, heat
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * First-order models, stepped at a fixed rate by MoaSimBoard:
+ * - Motor current follows throttle^2 * MOA_SIM_MOTOR_MAX_CURRENT_A with a
+ *   MOA_SIM_MOTOR_TIME_CONSTANT_S lag, plus an injectable extra load.
+ * - Battery voltage is open-circuit voltage (linear in state of charge)
+ *   minus the I*R sag; charge is drawn by the current.
+ * - ESC temperature relaxes towards water temperature plus an I^2 heating
+ *   term with MOA_SIM_THERMAL_TIME_CONSTANT_S.
+ *
+ * For trace replay the model can be overridden by measured values
+ * (setMeasured()): the sensors then read the recording while the throttle
+ * is still tracked for reporting.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Motor current at full throttle (A)
+ */
+#define MOA_SIM_MOTOR_MAX_CURRENT_A     120.0f
+
+/**
+ * @brief Motor current response time constant (s)
+ */
+#define MOA_SIM_MOTOR_TIME_CONSTANT_S   0.15f
+
+/**
+ * @brief Battery capacity (Ah)
+ */
+#define MOA_SIM_BATTERY_CAPACITY_AH     10.0f
+
+/**
+ * @brief Open-circuit voltage at 100% / 0% charge (6S LiPo)
+ */
+#define MOA_SIM_BATTERY_FULL_V          25.2f
+#define MOA_SIM_BATTERY_EMPTY_V         19.8f
+
+/**
+ * @brief Battery internal resistance (ohm)
+ */
+#define MOA_SIM_BATTERY_RESISTANCE_OHM  0.03f
+
+/**
+ * @brief Steady-state temperature rise per A^2 of current (degC)
+ * @note 120 A continuous settles ~50 degC above water temperature
+ */
+#define MOA_SIM_HEATING_C_PER_A2        0.0035f
+
+/**
+ * @brief ESC thermal time constant (s)
+ */
+#define MOA_SIM_THERMAL_TIME_CONSTANT_S 60.0f
+
+/**
+ * @brief Default water temperature (degC)
+ */
+#define MOA_SIM_WATER_TEMP_C            20.0f
+
+/**
+ * @brief Motor, battery and thermal state
+ */
+class MoaSimPlant {
+public:
+    MoaSimPlant();
+
+    /**
+     * @brief Integrate the model over dtSeconds
+     */
+    void step(float dtSeconds);
+
+    /**
+     * @brief Throttle demand from the ESC pulse (0..1)
+     */
+    void setThrottle(float fraction);
+
+    /**
+     * @brief Current added on top of the motor (fault injection, A)
+     */
+    void setExtraCurrent(float amps);
+
+    void setStateOfCharge(float fraction);
+    void setWaterTemperature(float celsius);
+    void setTemperature(float celsius);
+
+    /**
+     * @brief Replace the model outputs with a recorded sample (held until the next one)
+     */
+    void setMeasured(float amps, float volts, float celsius);
+
+    /**
+     * @brief Return to the model
+     */
+    void clearMeasured();
+
+    bool isMeasured() const;
+
+    float getThrottle() const;
+    float getMotorCurrent() const;
+
+    /**
+     * @brief Current through the sensor: motor plus extra load (A)
+     */
+    float getCurrent() const;
+
+    /**
+     * @brief Terminal voltage under the present load (V)
+     */
+    float getBatteryVoltage() const;
+
+    float getStateOfCharge() const;
+    float getTemperature() const;
+    float getWaterTemperature() const;
+
+private:
+    float _throttle;            ///< Demand (0..1)
+    float _motorCurrent;        ///< Motor current (A)
+    float _extraCurrent;        ///< Injected load (A)
+    float _stateOfCharge;       ///< 0..1
+    float _waterTemperature;    ///< degC
+    float _temperature;         ///< ESC temperature (degC)
+    bool _measured;             ///< Sensors read the recorded values below
+    float _measuredCurrent;     ///< A
+    float _measuredVoltage;     ///< V
+    float _measuredTemperature; ///< degC
+};
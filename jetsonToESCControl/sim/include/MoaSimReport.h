@@ -0,0 +1,86 @@
+/**
+ * @file MoaSimReport.h
+ * @brief Timeline of firmware decisions during a simulated run
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Watches the firmware from the kernel's switch hook and records one line
+ * per observable decision, stamped with virtual ms:
+ *   <ms> state <name>                  state machine transition
+ *   <ms> duty <n>                      ESC duty written to the LEDC channel
+ *   <ms> log <type> <code> <value>     flash log entry (hex type/code)
+ *
+ * The text depends only on the inputs, so a replayed trace can be diffed
+ * against a golden report: a tuning change (ramp rate, hysteresis) shows
+ * up as exactly the lines it moves.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+class MoaStateMachineWrapper;
+class MoaFlashLog;
+class MoaSimBoard;
+
+/**
+ * @brief Differences listed by MoaSimReport::diff() before it stops
+ */
+#define MOA_SIM_REPORT_DIFF_LINES   5
+
+/**
+ * @brief Recorder for state, duty and log changes
+ */
+class MoaSimReport {
+public:
+    MoaSimReport(MoaStateMachineWrapper& stateMachine, MoaFlashLog& flashLog, MoaSimBoard& board);
+
+    /**
+     * @brief Start recording on every scheduling decision of MoaSimKernel
+     */
+    void attach();
+
+    /**
+     * @brief Stop recording
+     */
+    void detach();
+
+    /**
+     * @brief Record whatever changed since the last call
+     */
+    void sample();
+
+    /**
+     * @brief Report text, one newline-terminated line per change
+     */
+    const std::string& getText() const;
+
+    uint32_t getTransitionCount() const;
+    uint32_t getDutyChangeCount() const;
+    uint32_t getLogEntryCount() const;
+
+    /**
+     * @brief Compare two reports line by line
+     * @param differences Set to the first MOA_SIM_REPORT_DIFF_LINES mismatches
+     * @return true if identical
+     */
+    static bool diff(const std::string& expected, const std::string& actual, std::string& differences);
+
+private:
+    MoaStateMachineWrapper& _stateMachine;
+    MoaFlashLog& _flashLog;
+    MoaSimBoard& _board;
+
+    std::string _text;
+    const char* _lastState;         ///< Name last reported (nullptr = none yet)
+    uint32_t _lastDuty;
+    uint32_t _loggedSeen;           ///< MoaFlashLog::getLoggedCount() already reported
+    uint32_t _transitions;
+    uint32_t _dutyChanges;
+    uint32_t _logEntries;
+
+    void append(uint64_t ms, const char* format, ...) __attribute__((format(printf, 3, 4)));
+    static void onSwitch(void* context);
+};
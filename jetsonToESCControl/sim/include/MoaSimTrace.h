@@ -0,0 +1,92 @@
+/**
+ * @file MoaSimTrace.h
+ * @brief Recorded ride trace played back on the simulated board
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * A trace is CSV, one row per line, rows in time order ('#' starts a
+ * comment, time in ms since boot):
+ *   s,<ms>,<A>,<V>,<degC>                        sensor sample
+ *   b,<ms>,<stop|25|50|75|100>,<down|up>         button edge
+ *
+ * Samples replace the plant model (MoaSimPlant::setMeasured()) and hold
+ * until the next one, so the firmware's ADC and temperature paths read the
+ * recording through the same conversions as on the board. Rows are fed
+ * one at a time from a chained board action rather than queued up front,
+ * which keeps long traces cheap.
+ *
+ * ## Usage
+ * @code
+ * MoaSimTrace trace;
+ * std::string error;
+ * if (trace.load(file, error)) {
+ *     trace.play(MoaSimBoard::instance());
+ *     kernel.run(trace.getEndUs());
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <istream>
+#include <string>
+#include <vector>
+
+class MoaSimBoard;
+
+/**
+ * @brief Time the replay keeps running after the last row (ms)
+ */
+#define MOA_SIM_TRACE_TAIL_MS   1000
+
+/**
+ * @brief Parsed trace and its playback cursor
+ */
+class MoaSimTrace {
+public:
+    MoaSimTrace();
+
+    /**
+     * @brief Parse a trace
+     * @param error Set to "line N: ..." on failure
+     * @return false on a malformed or out-of-order row
+     */
+    bool load(std::istream& in, std::string& error);
+
+    /**
+     * @brief Start feeding rows to the board (call once, before running)
+     * @note The trace must outlive the run
+     */
+    void play(MoaSimBoard& board);
+
+    /**
+     * @brief Virtual time the replay ends: last row plus MOA_SIM_TRACE_TAIL_MS
+     */
+    uint64_t getEndUs() const;
+
+    size_t getSampleCount() const;
+    size_t getButtonCount() const;
+
+private:
+    struct Row {
+        uint64_t atUs;
+        bool sample;            ///< Sample row, otherwise a button edge
+        float current;          ///< A
+        float voltage;          ///< V
+        float temperature;      ///< degC
+        uint8_t mcpPin;
+        bool pressed;
+    };
+
+    std::vector<Row> _rows;
+    size_t _next;               ///< First row not yet applied
+    size_t _samples;
+    MoaSimBoard* _board;
+
+    /**
+     * @brief Apply the rows due now and schedule the next batch
+     */
+    void feed();
+};
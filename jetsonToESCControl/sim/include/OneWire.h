@@ -0,0 +1,47 @@
+/**
+ * @file OneWire.h
+ * @brief Host stand-in for the OneWire bus library
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Part of the simulated HAL (sim env). The byte-level calls go to the
+ * board's SimulatedDs18b20Bus, which holds the DS18B20 probes.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "MoaSimBoard.h"
+
+class OneWire {
+public:
+    explicit OneWire(uint8_t pin) : _pin(pin) {}
+    uint8_t getPin() const { return _pin; }
+
+    uint8_t reset() { return bus().reset() ? 1 : 0; }
+    void select(const uint8_t rom[8]) { bus().select(rom); }
+    void skip() { bus().skip(); }
+    void write(uint8_t v, uint8_t power = 0) { bus().write(v, power != 0); }
+    void write_bytes(const uint8_t* buf, uint16_t count, bool power = false) {
+        for (uint16_t i = 0; i < count; i++) {
+            bus().write(buf[i], power);
+        }
+    }
+    uint8_t read() { return bus().read(); }
+    void read_bytes(uint8_t* buf, uint16_t count) {
+        for (uint16_t i = 0; i < count; i++) {
+            buf[i] = bus().read();
+        }
+    }
+    void depower() {}
+    void reset_search() { bus().resetSearch(); }
+    bool search(uint8_t* newAddr, bool searchMode = true) {
+        (void)searchMode;
+        return bus().search(newAddr);
+    }
+
+private:
+    uint8_t _pin;
+
+    static SimulatedDs18b20Bus& bus() { return MoaSimBoard::instance().oneWire(); }
+};
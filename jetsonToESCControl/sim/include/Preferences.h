@@ -0,0 +1,53 @@
+/**
+ * @file Preferences.h
+ * @brief Host stand-in for the arduino-esp32 NVS Preferences
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Part of the simulated HAL (sim env). Namespaces live in memory for the
+ * lifetime of the process, so a run starts from factory defaults. put*()
+ * returns the bytes stored (0 when opened read-only), as on the target.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <string>
+
+class Preferences {
+public:
+    Preferences() : _open(false), _readOnly(true) {}
+    ~Preferences() { end(); }
+
+    bool begin(const char* name, bool readOnly = false, const char* partitionLabel = nullptr);
+    void end();
+
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putUChar(const char* key, uint8_t value);
+    size_t putUShort(const char* key, uint16_t value);
+    size_t putLong(const char* key, int32_t value);
+    size_t putULong(const char* key, uint32_t value);
+    size_t putFloat(const char* key, float value);
+    size_t putString(const char* key, const char* value);
+    size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+    size_t putBytes(const char* key, const void* value, size_t length);
+
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0);
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0);
+    int32_t getLong(const char* key, int32_t defaultValue = 0);
+    uint32_t getULong(const char* key, uint32_t defaultValue = 0);
+    float getFloat(const char* key, float defaultValue = NAN);
+    String getString(const char* key, const String& defaultValue = String());
+    size_t getBytes(const char* key, void* buffer, size_t length);
+
+private:
+    std::string _name;
+    bool _open;
+    bool _readOnly;
+
+    size_t put(const char* key, const void* value, size_t length);
+    bool get(const char* key, void* value, size_t length);
+};
@@ -0,0 +1,103 @@
+/**
+ * @file WiFi.h
+ * @brief Host stand-in for the arduino-esp32 WiFi station
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Part of the simulated HAL (sim env). There is no access point in range:
+ * scans find nothing and begin() never connects, so the firmware takes its
+ * connect-timeout path in virtual time.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} wifi_mode_t;
+
+typedef enum {
+    WIFI_POWER_19_5dBm = 78,
+    WIFI_POWER_8_5dBm = 34,
+    WIFI_POWER_2dBm = 8
+} wifi_power_t;
+
+/**
+ * @brief IPv4 address
+ */
+class IPAddress {
+public:
+    IPAddress() : _address(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : _address(static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8)
+                 | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24)) {}
+
+    bool operator==(const IPAddress& rhs) const { return _address == rhs._address; }
+    bool operator!=(const IPAddress& rhs) const { return _address != rhs._address; }
+
+    String toString() const {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u",
+                 _address & 0xFF, (_address >> 8) & 0xFF, (_address >> 16) & 0xFF, _address >> 24);
+        return String(buffer);
+    }
+
+private:
+    uint32_t _address;
+};
+
+class WiFiClass {
+public:
+    WiFiClass() : _mode(WIFI_OFF), _status(WL_IDLE_STATUS) {}
+
+    bool mode(wifi_mode_t mode) { _mode = mode; return true; }
+    wifi_mode_t getMode() const { return _mode; }
+
+    bool disconnect(bool wifiOff = false, bool eraseAp = false) {
+        (void)eraseAp;
+        _status = WL_IDLE_STATUS;
+        if (wifiOff) {
+            _mode = WIFI_OFF;
+        }
+        return true;
+    }
+
+    bool setTxPower(wifi_power_t power) { (void)power; return true; }
+
+    int16_t scanNetworks(bool async = false, bool showHidden = false) {
+        (void)async;
+        (void)showHidden;
+        return 0;
+    }
+
+    wl_status_t begin(const char* ssid, const char* passphrase = nullptr) {
+        (void)ssid;
+        (void)passphrase;
+        _status = WL_NO_SSID_AVAIL;
+        return _status;
+    }
+
+    wl_status_t status() const { return _status; }
+    IPAddress localIP() const { return IPAddress(); }
+    int8_t RSSI() const { return 0; }
+
+private:
+    wifi_mode_t _mode;
+    wl_status_t _status;
+};
+
+extern WiFiClass WiFi;
@@ -0,0 +1,20 @@
+/**
+ * @file WiFiUdp.h
+ * @brief Host stand-in for the arduino-esp32 WiFiUDP
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Part of the simulated HAL (sim env). The simulated station never
+ * connects, so no packet can be sent.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+class WiFiUDP {
+public:
+    int beginPacket(const char* host, uint16_t port) { (void)host; (void)port; return 0; }
+    size_t write(const uint8_t* buffer, size_t size) { (void)buffer; (void)size; return 0; }
+    int endPacket() { return 0; }
+};
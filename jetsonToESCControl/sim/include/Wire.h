@@ -0,0 +1,54 @@
+/**
+ * @file Wire.h
+ * @brief Host stand-in for the arduino-esp32 TwoWire (I2C master)
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Part of the simulated HAL (sim env). Transactions are delivered to the
+ * devices on MoaSimBoard's I2C bus (the MCP23018 model). A pointer-only
+ * write ended with a repeated start is merged with the following
+ * requestFrom() into one register read, as it is on the wire.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#define I2C_BUFFER_LENGTH 128
+
+/**
+ * @brief I2C master on the simulated bus
+ */
+class TwoWire : public Stream {
+public:
+    explicit TwoWire(uint8_t busNum);
+
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    bool end();
+    bool setClock(uint32_t frequency);
+    uint32_t getClock();
+
+    void beginTransmission(uint8_t address);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true);
+
+    size_t write(uint8_t data) override;
+    size_t write(const uint8_t* data, size_t quantity) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int peek() override;
+
+private:
+    uint8_t _busNum;
+    uint32_t _frequency;
+    uint8_t _txAddress;
+    uint8_t _txBuffer[I2C_BUFFER_LENGTH];
+    size_t _txLength;
+    uint8_t _rxBuffer[I2C_BUFFER_LENGTH];
+    size_t _rxLength;
+    size_t _rxIndex;
+    int _pendingRegister;           ///< Register pointer set by a pointer-only write (-1 = none)
+};
+
+extern TwoWire Wire;
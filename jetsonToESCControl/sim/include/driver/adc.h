@@ -0,0 +1,89 @@
+/**
+ * @file adc.h
+ * @brief Host stand-in for the ESP-IDF 4.4 continuous ADC driver (ESP32-C3)
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Part of the simulated HAL (sim env). Conversions are produced at
+ * sample_freq_hz of virtual time from the MoaSimBoard analog model and
+ * kept in a store of max_store_buf_size bytes; a read that finds the
+ * store overrun returns ESP_ERR_INVALID_STATE, as the IDF driver does.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#define SOC_ADC_PATT_LEN_MAX        24
+#define SOC_ADC_DIGI_MAX_BITWIDTH   12
+#define SOC_ADC_DIGI_RESULT_BYTES   4
+
+typedef enum {
+    ADC_UNIT_1 = 1,
+    ADC_UNIT_2 = 2
+} adc_unit_t;
+
+typedef enum {
+    ADC_ATTEN_DB_0 = 0,
+    ADC_ATTEN_DB_2_5 = 1,
+    ADC_ATTEN_DB_6 = 2,
+    ADC_ATTEN_DB_11 = 3
+} adc_atten_t;
+
+typedef enum {
+    ADC_CONV_SINGLE_UNIT_1 = 1,
+    ADC_CONV_SINGLE_UNIT_2 = 2,
+    ADC_CONV_BOTH_UNIT = 3,
+    ADC_CONV_ALTER_UNIT = 7
+} adc_digi_convert_mode_t;
+
+typedef enum {
+    ADC_DIGI_OUTPUT_FORMAT_TYPE1,
+    ADC_DIGI_OUTPUT_FORMAT_TYPE2
+} adc_digi_output_format_t;
+
+typedef struct {
+    uint32_t max_store_buf_size;
+    uint32_t conv_num_each_intr;
+    uint32_t adc1_chan_mask;
+    uint32_t adc2_chan_mask;
+} adc_digi_init_config_t;
+
+typedef struct {
+    uint8_t atten;
+    uint8_t channel;
+    uint8_t unit;
+    uint8_t bit_width;
+} adc_digi_pattern_config_t;
+
+typedef struct {
+    bool conv_limit_en;
+    uint32_t conv_limit_num;
+    uint32_t pattern_num;
+    adc_digi_pattern_config_t* adc_pattern;
+    uint32_t sample_freq_hz;
+    adc_digi_convert_mode_t conv_mode;
+    adc_digi_output_format_t format;
+} adc_digi_configuration_t;
+
+typedef struct {
+    union {
+        struct {
+            uint32_t data:      12;
+            uint32_t reserved12: 1;
+            uint32_t channel:    3;
+            uint32_t unit:       1;
+            uint32_t reserved17_31: 15;
+        } type2;
+        uint32_t val;
+    };
+} adc_digi_output_data_t;
+
+esp_err_t adc_digi_initialize(const adc_digi_init_config_t* init_config);
+esp_err_t adc_digi_deinitialize(void);
+esp_err_t adc_digi_controller_configure(const adc_digi_configuration_t* config);
+esp_err_t adc_digi_start(void);
+esp_err_t adc_digi_stop(void);
+esp_err_t adc_digi_read_bytes(uint8_t* buf, uint32_t length_max, uint32_t* out_length, uint32_t timeout_ms);
@@ -0,0 +1,59 @@
+/**
+ * @file esp_log.h
+ * @brief Host stand-in for the ESP-IDF logging macros
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Lets firmware sources that only log (state machine, helpers) build in
+ * the native environment. Messages are discarded; arguments are still
+ * type-checked against the format string.
+ *
+ * In the sim env (MOA_SIM) messages are printed in the ESP-IDF layout,
+ * "W (1234) Tag: text", stamped with virtual milliseconds, and filtered
+ * by esp_log_level_set().
+ */
+
+#pragma once
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+#ifdef MOA_SIM
+
+/**
+ * @brief Set the log level for a tag ("*" = default for all tags)
+ */
+void esp_log_level_set(const char* tag, esp_log_level_t level);
+
+void moaSimLogWrite(esp_log_level_t level, const char* tag, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define ESP_LOGE(tag, format, ...) moaSimLogWrite(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) moaSimLogWrite(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) moaSimLogWrite(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) moaSimLogWrite(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) moaSimLogWrite(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
+
+#else
+
+static inline void moaSimLogDiscard(const char* tag, const char* format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static inline void moaSimLogDiscard(const char* tag, const char* format, ...) {
+    (void)tag;
+    (void)format;
+}
+
+#define ESP_LOGE(tag, format, ...) moaSimLogDiscard(tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) moaSimLogDiscard(tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) moaSimLogDiscard(tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) moaSimLogDiscard(tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) moaSimLogDiscard(tag, format, ##__VA_ARGS__)
+
+#endif
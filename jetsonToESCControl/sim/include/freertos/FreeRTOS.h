@@ -0,0 +1,52 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host stand-in for the FreeRTOS base types and configuration
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Part of the simulated HAL (sim env). Types and constants follow the
+ * ESP-IDF port: 1 kHz tick, 25 priorities, timer service at priority 1.
+ * The kernel behind task.h, queue.h, semphr.h and timers.h is
+ * sim/src/MoaSimKernel.cpp.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define configTICK_RATE_HZ          1000
+#define configMAX_PRIORITIES        25
+#define configTIMER_TASK_PRIORITY   1
+#define tskIDLE_PRIORITY            0
+
+#define portMAX_DELAY       ((TickType_t)0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS  ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(xTimeInMs) \
+    ((TickType_t)(((uint64_t)(xTimeInMs) * (uint64_t)configTICK_RATE_HZ) / (uint64_t)1000U))
+
+#define pdFALSE             ((BaseType_t)0)
+#define pdTRUE              ((BaseType_t)1)
+#define pdFAIL              (pdFALSE)
+#define pdPASS              (pdTRUE)
+#define errQUEUE_EMPTY      ((BaseType_t)0)
+#define errQUEUE_FULL       ((BaseType_t)0)
+
+// Tasks only give up the CPU inside kernel calls, so critical sections
+// have nothing to exclude in the simulation.
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED    0
+#define portENTER_CRITICAL(mux)         ((void)(mux))
+#define portEXIT_CRITICAL(mux)          ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux)     ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux)      ((void)(mux))
+#define taskENTER_CRITICAL(mux)         ((void)(mux))
+#define taskEXIT_CRITICAL(mux)          ((void)(mux))
+
+// Interrupts return through the simulated kernel, which switches to a
+// higher-priority task they woke on its own.
+#define portYIELD_FROM_ISR(...)         ((void)0)
@@ -0,0 +1,40 @@
+/**
+ * @file queue.h
+ * @brief Host stand-in for the FreeRTOS queue API
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Part of the simulated HAL (sim env). Blocked senders and receivers are
+ * woken highest priority first, FIFO within a priority, as in FreeRTOS.
+ */
+
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef struct QueueDefinition* QueueHandle_t;
+
+#define queueSEND_TO_BACK   ((BaseType_t)0)
+#define queueSEND_TO_FRONT  ((BaseType_t)1)
+#define queueOVERWRITE      ((BaseType_t)2)
+
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize);
+void vQueueDelete(QueueHandle_t xQueue);
+BaseType_t xQueueGenericSend(QueueHandle_t xQueue, const void* pvItemToQueue, TickType_t xTicksToWait,
+                             BaseType_t xCopyPosition);
+BaseType_t xQueueGenericSendFromISR(QueueHandle_t xQueue, const void* pvItemToQueue,
+                                    BaseType_t* pxHigherPriorityTaskWoken, BaseType_t xCopyPosition);
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void* pvBuffer, TickType_t xTicksToWait);
+BaseType_t xQueueReceiveFromISR(QueueHandle_t xQueue, void* pvBuffer, BaseType_t* pxHigherPriorityTaskWoken);
+BaseType_t xQueuePeek(QueueHandle_t xQueue, void* pvBuffer, TickType_t xTicksToWait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t xQueue);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t xQueue);
+BaseType_t xQueueReset(QueueHandle_t xQueue);
+
+#define xQueueSend(q, item, ticks)          xQueueGenericSend((q), (item), (ticks), queueSEND_TO_BACK)
+#define xQueueSendToBack(q, item, ticks)    xQueueGenericSend((q), (item), (ticks), queueSEND_TO_BACK)
+#define xQueueSendToFront(q, item, ticks)   xQueueGenericSend((q), (item), (ticks), queueSEND_TO_FRONT)
+#define xQueueOverwrite(q, item)            xQueueGenericSend((q), (item), 0, queueOVERWRITE)
+#define xQueueSendFromISR(q, item, woken)        xQueueGenericSendFromISR((q), (item), (woken), queueSEND_TO_BACK)
+#define xQueueSendToBackFromISR(q, item, woken)  xQueueGenericSendFromISR((q), (item), (woken), queueSEND_TO_BACK)
+#define xQueueSendToFrontFromISR(q, item, woken) xQueueGenericSendFromISR((q), (item), (woken), queueSEND_TO_FRONT)
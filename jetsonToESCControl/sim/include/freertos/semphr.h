@@ -0,0 +1,26 @@
+/**
+ * @file semphr.h
+ * @brief Host stand-in for the FreeRTOS semaphore API
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Part of the simulated HAL (sim env). Semaphores are queues of empty
+ * items, as in FreeRTOS. Mutex priority inheritance is not modelled.
+ */
+
+#pragma once
+
+#include "queue.h"
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount);
+
+#define xSemaphoreTake(sem, ticks)          xQueueReceive((sem), NULL, (ticks))
+#define xSemaphoreTakeFromISR(sem, woken)   xQueueReceiveFromISR((sem), NULL, (woken))
+#define xSemaphoreGive(sem)                 xQueueGenericSend((sem), NULL, 0, queueSEND_TO_BACK)
+#define xSemaphoreGiveFromISR(sem, woken)   xQueueGenericSendFromISR((sem), NULL, (woken), queueSEND_TO_BACK)
+#define uxSemaphoreGetCount(sem)            uxQueueMessagesWaiting(sem)
+#define vSemaphoreDelete(sem)               vQueueDelete(sem)
@@ -0,0 +1,47 @@
+/**
+ * @file task.h
+ * @brief Host stand-in for the FreeRTOS task API
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Part of the simulated HAL (sim env). Each task runs on its own host
+ * thread, but only one thread runs at a time: see MoaSimKernel.h.
+ */
+
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef struct tskTaskControlBlock* TaskHandle_t;
+typedef void (*TaskFunction_t)(void* pvParameters);
+
+#define tskNO_AFFINITY  ((BaseType_t)0x7FFFFFFF)
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t pvTaskCode, const char* pcName, uint32_t usStackDepth,
+                                   void* pvParameters, UBaseType_t uxPriority,
+                                   TaskHandle_t* pxCreatedTask, BaseType_t xCoreID);
+
+static inline BaseType_t xTaskCreate(TaskFunction_t pvTaskCode, const char* pcName, uint32_t usStackDepth,
+                                     void* pvParameters, UBaseType_t uxPriority, TaskHandle_t* pxCreatedTask) {
+    return xTaskCreatePinnedToCore(pvTaskCode, pcName, usStackDepth, pvParameters, uxPriority,
+                                   pxCreatedTask, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t xTaskToDelete);
+void vTaskDelay(TickType_t xTicksToDelay);
+BaseType_t xTaskDelayUntil(TickType_t* pxPreviousWakeTime, TickType_t xTimeIncrement);
+
+static inline void vTaskDelayUntil(TickType_t* pxPreviousWakeTime, TickType_t xTimeIncrement) {
+    (void)xTaskDelayUntil(pxPreviousWakeTime, xTimeIncrement);
+}
+
+TickType_t xTaskGetTickCount(void);
+TickType_t xTaskGetTickCountFromISR(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+char* pcTaskGetName(TaskHandle_t xTaskToQuery);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t xTask);
+
+// Host threads have no measurable stack: the whole depth is reported free.
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask);
+
+#define taskYIELD()     vTaskDelay(0)
@@ -0,0 +1,35 @@
+/**
+ * @file timers.h
+ * @brief Host stand-in for the FreeRTOS software timer API
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Part of the simulated HAL (sim env). Callbacks run in the "Tmr Svc"
+ * task at configTIMER_TASK_PRIORITY, like the FreeRTOS timer daemon.
+ * Commands take effect immediately instead of going through a command
+ * queue, so xTicksToWait is ignored.
+ */
+
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef struct tmrTimerControl* TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t xTimer);
+
+TimerHandle_t xTimerCreate(const char* pcTimerName, TickType_t xTimerPeriodInTicks, UBaseType_t uxAutoReload,
+                           void* pvTimerID, TimerCallbackFunction_t pxCallbackFunction);
+BaseType_t xTimerStart(TimerHandle_t xTimer, TickType_t xTicksToWait);
+BaseType_t xTimerStop(TimerHandle_t xTimer, TickType_t xTicksToWait);
+BaseType_t xTimerReset(TimerHandle_t xTimer, TickType_t xTicksToWait);
+BaseType_t xTimerChangePeriod(TimerHandle_t xTimer, TickType_t xNewPeriod, TickType_t xTicksToWait);
+BaseType_t xTimerDelete(TimerHandle_t xTimer, TickType_t xTicksToWait);
+BaseType_t xTimerIsTimerActive(TimerHandle_t xTimer);
+TickType_t xTimerGetPeriod(TimerHandle_t xTimer);
+void* pvTimerGetTimerID(TimerHandle_t xTimer);
+void vTimerSetTimerID(TimerHandle_t xTimer, void* pvNewID);
+const char* pcTimerGetName(TimerHandle_t xTimer);
+
+#define xTimerStartFromISR(t, woken)    ((void)(woken), xTimerStart((t), 0))
+#define xTimerStopFromISR(t, woken)     ((void)(woken), xTimerStop((t), 0))
+#define xTimerResetFromISR(t, woken)    ((void)(woken), xTimerReset((t), 0))
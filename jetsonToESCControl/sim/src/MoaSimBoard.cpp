@@ -0,0 +1,523 @@
+/**
+ * @file MoaSimBoard.cpp
+ * @brief Implementation of the MoaSimBoard class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaSimBoard.h"
+#include <Arduino.h>
+#include <math.h>
+#include <string.h>
+#include "driver/adc.h"
+#include "driver/uart.h"
+#include "PinMapping.h"
+#include "Constants.h"
+#include "ConfigManager.h"
+
+MoaSimBoard& MoaSimBoard::instance() {
+    // Never destroyed: firmware statics still talk to the board during exit
+    static MoaSimBoard* board = new MoaSimBoard();
+    return *board;
+}
+
+MoaSimBoard::MoaSimBoard()
+    : _mcp(MCP23018_I2C_ADDR)
+    , _plantUs(0)
+    , _actionSeq(0)
+    , _intaLevel(HIGH)
+    , _buttonLevels(0xFF)
+    , _analogBits(12)
+    , _noiseLsb(MOA_SIM_ADC_NOISE_LSB)
+    , _noiseState(1)
+    , _adcRunning(false)
+    , _adcRateHz(0)
+    , _adcStoreConversions(0)
+    , _adcFrameConversions(1)
+    , _adcLastUs(0)
+    , _adcRemainder(0)
+    , _adcPending(0)
+    , _adcNext(0)
+{
+    for (uint8_t pin = 0; pin < MOA_SIM_PIN_COUNT; pin++) {
+        _pinModes[pin] = INPUT;
+        _outputs[pin] = LOW;
+        _isr[pin] = nullptr;
+        _isrMode[pin] = 0;
+    }
+    for (uint8_t channel = 0; channel < MOA_SIM_LEDC_CHANNELS; channel++) {
+        _ledc[channel].frequency = 0.0;
+        _ledc[channel].bits = 0;
+        _ledc[channel].duty = 0;
+        _ledc[channel].pin = -1;
+    }
+    for (uint8_t port = 0; port < MOA_SIM_UART_PORTS; port++) {
+        _uart[port].installed = false;
+        _uart[port].events = nullptr;
+        _uart[port].rxCapacity = 0;
+        _uart[port].baud = 115200;
+        _uart[port].timeoutSymbols = 10;
+        _uart[port].lineFreeUs = 0;
+    }
+    for (uint8_t probe = 0; probe < TEMP_PROBE_MAX_COUNT; probe++) {
+        _oneWire.addProbe(0x1000 + probe);
+    }
+    MoaSimKernel::instance().setDevice(this);
+}
+
+// =============================================================================
+// Scenario
+// =============================================================================
+
+void MoaSimBoard::schedule(uint64_t atUs, std::function<void()> action) {
+    ScheduledAction entry = { atUs, ++_actionSeq, std::move(action) };
+    std::vector<ScheduledAction>::iterator it = _actions.begin();
+    while (it != _actions.end() && it->atUs <= atUs) {
+        ++it;
+    }
+    _actions.insert(it, std::move(entry));
+}
+
+void MoaSimBoard::pressButton(uint8_t mcpPin) {
+    _buttonLevels &= static_cast<uint8_t>(~(1 << mcpPin));    // Active LOW
+    _mcp.setInputs(0, _buttonLevels);
+    updateInterruptLine();
+}
+
+void MoaSimBoard::releaseButton(uint8_t mcpPin) {
+    _buttonLevels |= static_cast<uint8_t>(1 << mcpPin);
+    _mcp.setInputs(0, _buttonLevels);
+    updateInterruptLine();
+}
+
+int MoaSimBoard::buttonPin(const std::string& name) {
+    if (name == "stop") return MCP_PIN_BUTTON_STOP;
+    if (name == "25")   return MCP_PIN_BUTTON_25;
+    if (name == "50")   return MCP_PIN_BUTTON_50;
+    if (name == "75")   return MCP_PIN_BUTTON_75;
+    if (name == "100")  return MCP_PIN_BUTTON_100;
+    return -1;
+}
+
+void MoaSimBoard::sendSerial(const char* text) {
+    Serial.inject(text);
+}
+
+void MoaSimBoard::sendUart(uint8_t port, const uint8_t* data, size_t length) {
+    if (port >= MOA_SIM_UART_PORTS || length == 0) {
+        return;
+    }
+    UartPort& uart = _uart[port];
+    uint64_t now = MoaSimKernel::instance().nowUs();
+    uint64_t start = (uart.lineFreeUs > now) ? uart.lineFreeUs : now;
+    uint64_t wireUs = (static_cast<uint64_t>(length) * 10 * 1000000ULL + uart.baud - 1) / uart.baud;
+    uint64_t timeoutUs = (static_cast<uint64_t>(uart.timeoutSymbols) * 10 * 1000000ULL + uart.baud - 1) / uart.baud;
+    uart.lineFreeUs = start + wireUs;
+
+    std::vector<uint8_t> bytes(data, data + length);
+    schedule(uart.lineFreeUs + timeoutUs, [this, port, bytes]() { uartDeliver(port, bytes); });
+}
+
+std::vector<uint8_t> MoaSimBoard::takeUartOutput(uint8_t port) {
+    std::vector<uint8_t> out;
+    if (port < MOA_SIM_UART_PORTS) {
+        out.swap(_uart[port].tx);
+    }
+    return out;
+}
+
+void MoaSimBoard::setAdcNoise(uint16_t amplitudeLsb, uint32_t seed) {
+    _noiseLsb = amplitudeLsb;
+    _noiseState = (seed != 0) ? seed : 1;
+}
+
+MoaSimPlant& MoaSimBoard::getPlant() {
+    syncPlant();    // Changes made by the caller apply from now on
+    return _plant;
+}
+
+SimulatedMcp23018& MoaSimBoard::getMcp() {
+    return _mcp;
+}
+
+void MoaSimBoard::provisionProbes(ConfigManager& config) {
+    for (uint8_t role = 0; role < TEMP_PROBE_MAX_COUNT; role++) {
+        memcpy(config.tempProbeRoms[role], _oneWire.getRom(role), ONEWIRE_ROM_BYTES);
+    }
+    config.save();
+}
+
+uint32_t MoaSimBoard::getEscDuty() const {
+    for (uint8_t channel = 0; channel < MOA_SIM_LEDC_CHANNELS; channel++) {
+        if (_ledc[channel].pin == PIN_ESC_PWM) {
+            return _ledc[channel].duty;
+        }
+    }
+    return 0;
+}
+
+float MoaSimBoard::getEscPulseUs() const {
+    for (uint8_t channel = 0; channel < MOA_SIM_LEDC_CHANNELS; channel++) {
+        const LedcChannel& ledc = _ledc[channel];
+        if (ledc.pin == PIN_ESC_PWM && ledc.frequency > 0.0) {
+            return static_cast<float>(ledc.duty * 1000000.0 / ledc.frequency / (1UL << ledc.bits));
+        }
+    }
+    return 0.0f;
+}
+
+uint8_t MoaSimBoard::getLedOutputs() const {
+    return _mcp.peek(MCP23018_REG_OLATB);
+}
+
+// =============================================================================
+// Pins
+// =============================================================================
+
+void MoaSimBoard::pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < MOA_SIM_PIN_COUNT) {
+        _pinModes[pin] = mode;
+    }
+}
+
+void MoaSimBoard::digitalWrite(uint8_t pin, uint8_t level) {
+    if (pin >= MOA_SIM_PIN_COUNT) {
+        return;
+    }
+    _outputs[pin] = level ? HIGH : LOW;
+    if (pin == PIN_I2C_RESET && level == LOW) {
+        _mcp.powerOnReset();
+        updateInterruptLine();
+    }
+}
+
+int MoaSimBoard::digitalRead(uint8_t pin) {
+    if (pin == PIN_I2C_INT_A) {
+        return _mcp.isInterruptAsserted(0) ? LOW : HIGH;
+    }
+    if (pin >= MOA_SIM_PIN_COUNT) {
+        return LOW;
+    }
+    if (_pinModes[pin] == OUTPUT) {
+        return _outputs[pin];
+    }
+    return (_pinModes[pin] & PULLUP) ? HIGH : LOW;
+}
+
+void MoaSimBoard::attachInterrupt(uint8_t pin, void (*isr)(), int mode) {
+    if (pin < MOA_SIM_PIN_COUNT) {
+        _isr[pin] = isr;
+        _isrMode[pin] = mode;
+    }
+    _intaLevel = digitalRead(PIN_I2C_INT_A);
+}
+
+void MoaSimBoard::detachInterrupt(uint8_t pin) {
+    if (pin < MOA_SIM_PIN_COUNT) {
+        _isr[pin] = nullptr;
+    }
+}
+
+void MoaSimBoard::updateInterruptLine() {
+    int level = digitalRead(PIN_I2C_INT_A);
+    if (level == _intaLevel) {
+        return;
+    }
+    _intaLevel = level;
+
+    void (*isr)() = _isr[PIN_I2C_INT_A];
+    int mode = _isrMode[PIN_I2C_INT_A];
+    bool fire = (mode == CHANGE)
+             || (mode == FALLING && level == LOW)
+             || (mode == RISING && level == HIGH);
+    if (isr != nullptr && fire) {
+        MoaSimKernel::instance().runIsr(isr);
+    }
+}
+
+// =============================================================================
+// Analog
+// =============================================================================
+
+void MoaSimBoard::syncPlant() {
+    uint64_t now = MoaSimKernel::instance().nowUs();
+    while (_plantUs + MOA_SIM_PLANT_STEP_US <= now) {
+        _plant.step(MOA_SIM_PLANT_STEP_US / 1000000.0f);
+        _plantUs += MOA_SIM_PLANT_STEP_US;
+    }
+}
+
+float MoaSimBoard::pinVoltage(uint8_t pin) const {
+    if (pin == PIN_BATT_LEVEL_SENSE) {
+        return _plant.getBatteryVoltage() / BATT_DIVIDER_RATIO;
+    }
+    if (pin == PIN_CURRENT_SENSE) {
+        return CURRENT_SENSOR_OFFSET + _plant.getCurrent() * CURRENT_SENSOR_SENSITIVITY;
+    }
+    if (pin == PIN_TEMP_SENSE) {
+        // NTC to ground under NTC_REFERENCE_RESISTANCE from the reference
+        float kelvin = _plant.getTemperature() + 273.15f;
+        float ntc = NTC_NOMINAL_RESISTANCE *
+                    expf(NTC_BETA_COEFFICIENT * (1.0f / kelvin - 1.0f / (NTC_NOMINAL_TEMP_C + 273.15f)));
+        return NTC_ADC_VREF_MV / 1000.0f * ntc / (ntc + NTC_REFERENCE_RESISTANCE);
+    }
+    return 0.0f;
+}
+
+int32_t MoaSimBoard::nextNoise() {
+    if (_noiseLsb == 0) {
+        return 0;
+    }
+    _noiseState ^= _noiseState << 13;      // xorshift32
+    _noiseState ^= _noiseState >> 17;
+    _noiseState ^= _noiseState << 5;
+    return static_cast<int32_t>(_noiseState % (2U * _noiseLsb + 1U)) - _noiseLsb;
+}
+
+uint16_t MoaSimBoard::convert(uint8_t pin, uint8_t bits) {
+    int32_t maxRaw = (1 << bits) - 1;
+    int32_t raw = static_cast<int32_t>(lroundf(pinVoltage(pin) / MOA_SIM_ADC_VREF * maxRaw)) + nextNoise();
+    if (raw < 0) {
+        raw = 0;
+    } else if (raw > maxRaw) {
+        raw = maxRaw;
+    }
+    return static_cast<uint16_t>(raw);
+}
+
+uint16_t MoaSimBoard::analogRead(uint8_t pin) {
+    syncPlant();
+    return convert(pin, _analogBits);
+}
+
+uint32_t MoaSimBoard::analogReadMilliVolts(uint8_t pin) {
+    syncPlant();
+    int32_t mv = static_cast<int32_t>(lroundf(pinVoltage(pin) * 1000.0f)) + nextNoise();
+    return (mv > 0) ? static_cast<uint32_t>(mv) : 0;
+}
+
+void MoaSimBoard::setAnalogResolution(uint8_t bits) {
+    _analogBits = (bits >= 9 && bits <= 12) ? bits : 12;
+}
+
+SimulatedDs18b20Bus& MoaSimBoard::oneWire() {
+    syncPlant();
+    _oneWire.setNowMs(static_cast<uint32_t>(MoaSimKernel::instance().nowUs() / 1000));
+    float esc = _plant.getTemperature();
+    float rise = esc - _plant.getWaterTemperature();
+    _oneWire.setTemperature(TEMP_PROBE_ESC, esc);
+    _oneWire.setTemperature(TEMP_PROBE_MOTOR, _plant.getWaterTemperature() + rise * MOA_SIM_MOTOR_PROBE_RISE);
+    _oneWire.setTemperature(TEMP_PROBE_BATTERY, _plant.getWaterTemperature() + rise * MOA_SIM_BATTERY_PROBE_RISE);
+    return _oneWire;
+}
+
+void MoaSimBoard::adcStart(const uint8_t* channels, uint8_t count, uint32_t sampleRateHz, uint32_t storeBytes,
+                           uint32_t frameBytes) {
+    _adcPattern.assign(channels, channels + count);
+    _adcRateHz = sampleRateHz;
+    _adcStoreConversions = storeBytes / SOC_ADC_DIGI_RESULT_BYTES;
+    _adcFrameConversions = std::max<uint32_t>(frameBytes / SOC_ADC_DIGI_RESULT_BYTES, 1);
+    _adcLastUs = MoaSimKernel::instance().nowUs();
+    _adcRemainder = 0;
+    _adcPending = 0;
+    _adcNext = 0;
+    _adcRunning = count > 0 && sampleRateHz > 0;
+}
+
+void MoaSimBoard::adcStop() {
+    _adcRunning = false;
+}
+
+uint32_t MoaSimBoard::adcRead(uint8_t* buffer, uint32_t maxBytes, bool& overrun) {
+    overrun = false;
+    if (!_adcRunning) {
+        return 0;
+    }
+    syncPlant();
+
+    uint64_t now = MoaSimKernel::instance().nowUs();
+    uint64_t elapsed = (now - _adcLastUs) * _adcRateHz + _adcRemainder;
+    _adcLastUs = now;
+    _adcRemainder = elapsed % 1000000ULL;
+    uint64_t pending = _adcPending + elapsed / 1000000ULL;
+
+    // Store full: the oldest conversions are lost
+    if (pending > _adcStoreConversions) {
+        uint64_t lost = pending - _adcStoreConversions;
+        _adcNext = static_cast<size_t>((_adcNext + lost) % _adcPattern.size());
+        pending = _adcStoreConversions;
+        overrun = true;
+    }
+
+    // Only completed DMA frames have been handed to the driver
+    uint64_t framed = pending - pending % _adcFrameConversions;
+    uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(framed, maxBytes / SOC_ADC_DIGI_RESULT_BYTES));
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t channel = _adcPattern[_adcNext];
+        _adcNext = (_adcNext + 1) % _adcPattern.size();
+
+        adc_digi_output_data_t result;
+        result.val = 0;
+        result.type2.data = convert(channel, SOC_ADC_DIGI_MAX_BITWIDTH);    // ADC1 channel n is GPIOn
+        result.type2.channel = channel;
+        result.type2.unit = 0;
+        memcpy(&buffer[i * SOC_ADC_DIGI_RESULT_BYTES], &result, SOC_ADC_DIGI_RESULT_BYTES);
+    }
+    _adcPending = static_cast<uint32_t>(pending - count);
+    return count * SOC_ADC_DIGI_RESULT_BYTES;
+}
+
+// =============================================================================
+// LEDC
+// =============================================================================
+
+double MoaSimBoard::ledcSetup(uint8_t channel, double frequency, uint8_t bits) {
+    if (channel >= MOA_SIM_LEDC_CHANNELS) {
+        return 0.0;
+    }
+    _ledc[channel].frequency = frequency;
+    _ledc[channel].bits = bits;
+    return frequency;
+}
+
+void MoaSimBoard::ledcAttachPin(uint8_t pin, uint8_t channel) {
+    if (channel < MOA_SIM_LEDC_CHANNELS) {
+        _ledc[channel].pin = static_cast<int8_t>(pin);
+    }
+}
+
+void MoaSimBoard::ledcWrite(uint8_t channel, uint32_t duty) {
+    if (channel >= MOA_SIM_LEDC_CHANNELS) {
+        return;
+    }
+    syncPlant();
+    _ledc[channel].duty = duty;
+    if (_ledc[channel].pin == PIN_ESC_PWM) {
+        float pulseUs = getEscPulseUs();
+        _plant.setThrottle((pulseUs - ESC_PULSE_MIN_US) / (ESC_PULSE_MAX_US - ESC_PULSE_MIN_US));
+    }
+}
+
+uint32_t MoaSimBoard::ledcRead(uint8_t channel) const {
+    return (channel < MOA_SIM_LEDC_CHANNELS) ? _ledc[channel].duty : 0;
+}
+
+// =============================================================================
+// I2C
+// =============================================================================
+
+uint8_t MoaSimBoard::i2cWrite(uint8_t address, const uint8_t* data, size_t length) {
+    bool ack;
+    if (length == 0) {
+        ack = address == MCP23018_I2C_ADDR;    // Address-only probe
+    } else {
+        ack = _mcp.writeRegisters(address, data[0], data + 1, length - 1);
+    }
+    updateInterruptLine();
+    return ack ? 0 : 2;
+}
+
+uint8_t MoaSimBoard::i2cRead(uint8_t address, uint8_t reg, uint8_t* data, size_t length) {
+    bool ack = _mcp.readRegisters(address, reg, data, length);
+    updateInterruptLine();
+    return ack ? 0 : 2;
+}
+
+// =============================================================================
+// IMoaSimDevice
+// =============================================================================
+
+// =============================================================================
+// UART driver
+// =============================================================================
+
+bool MoaSimBoard::uartInstall(uint8_t port, size_t rxBytes, QueueHandle_t events) {
+    if (port >= MOA_SIM_UART_PORTS || _uart[port].installed) {
+        return false;
+    }
+    _uart[port].installed = true;
+    _uart[port].events = events;
+    _uart[port].rxCapacity = rxBytes;
+    _uart[port].rx.clear();
+    _uart[port].tx.clear();
+    return true;
+}
+
+void MoaSimBoard::uartUninstall(uint8_t port) {
+    if (port < MOA_SIM_UART_PORTS) {
+        _uart[port].installed = false;
+        _uart[port].events = nullptr;
+        _uart[port].rx.clear();
+    }
+}
+
+void MoaSimBoard::uartSetBaud(uint8_t port, uint32_t baud) {
+    if (port < MOA_SIM_UART_PORTS && baud > 0) {
+        _uart[port].baud = baud;
+    }
+}
+
+void MoaSimBoard::uartSetRxTimeout(uint8_t port, uint8_t symbols) {
+    if (port < MOA_SIM_UART_PORTS) {
+        _uart[port].timeoutSymbols = symbols;
+    }
+}
+
+size_t MoaSimBoard::uartRead(uint8_t port, uint8_t* buffer, size_t maxBytes) {
+    if (port >= MOA_SIM_UART_PORTS) {
+        return 0;
+    }
+    std::vector<uint8_t>& rx = _uart[port].rx;
+    size_t count = (rx.size() < maxBytes) ? rx.size() : maxBytes;
+    memcpy(buffer, rx.data(), count);
+    rx.erase(rx.begin(), rx.begin() + static_cast<std::ptrdiff_t>(count));
+    return count;
+}
+
+void MoaSimBoard::uartWrite(uint8_t port, const uint8_t* data, size_t length) {
+    if (port < MOA_SIM_UART_PORTS) {
+        _uart[port].tx.insert(_uart[port].tx.end(), data, data + length);
+    }
+}
+
+void MoaSimBoard::uartFlushInput(uint8_t port) {
+    if (port < MOA_SIM_UART_PORTS) {
+        _uart[port].rx.clear();
+    }
+}
+
+size_t MoaSimBoard::uartBuffered(uint8_t port) const {
+    return (port < MOA_SIM_UART_PORTS) ? _uart[port].rx.size() : 0;
+}
+
+void MoaSimBoard::uartDeliver(uint8_t port, const std::vector<uint8_t>& bytes) {
+    UartPort& uart = _uart[port];
+    if (!uart.installed) {
+        return;                                     // No driver: the bytes are lost on the line
+    }
+
+    uart_event_t event = {};
+    if (uart.rx.size() + bytes.size() > uart.rxCapacity) {
+        event.type = UART_BUFFER_FULL;
+    } else {
+        uart.rx.insert(uart.rx.end(), bytes.begin(), bytes.end());
+        event.type = UART_DATA;
+        event.size = bytes.size();
+        event.timeout_flag = true;
+    }
+    if (uart.events != nullptr) {
+        xQueueSendFromISR(uart.events, &event, nullptr);
+    }
+}
+
+uint64_t MoaSimBoard::nextEventUs() const {
+    return _actions.empty() ? UINT64_MAX : _actions.front().atUs;
+}
+
+void MoaSimBoard::advance(uint64_t nowUs) {
+    while (!_actions.empty() && _actions.front().atUs <= nowUs) {
+        std::function<void()> action = std::move(_actions.front().action);
+        _actions.erase(_actions.begin());
+        action();
+    }
+}
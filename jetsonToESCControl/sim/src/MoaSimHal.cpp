@@ -0,0 +1,478 @@
+/**
+ * @file MoaSimHal.cpp
+ * @brief Arduino, Wire, network, ESP-IDF and logging stand-ins of the sim env
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Thin forwarding layer: time comes from MoaSimKernel, every hardware
+ * access goes to MoaSimBoard.
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <WiFi.h>
+#include <ArduinoOTA.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include "esp_log.h"
+#include "driver/adc.h"
+#include "driver/uart.h"
+#include "MoaSimBoard.h"
+#include "MoaSimKernel.h"
+
+// =============================================================================
+// Arduino core
+// =============================================================================
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    MoaSimBoard::instance().pinMode(pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    MoaSimBoard::instance().digitalWrite(pin, val);
+}
+
+int digitalRead(uint8_t pin) {
+    return MoaSimBoard::instance().digitalRead(pin);
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode) {
+    MoaSimBoard::instance().attachInterrupt(pin, isr, mode);
+}
+
+void detachInterrupt(uint8_t pin) {
+    MoaSimBoard::instance().detachInterrupt(pin);
+}
+
+uint16_t analogRead(uint8_t pin) {
+    return MoaSimBoard::instance().analogRead(pin);
+}
+
+uint32_t analogReadMilliVolts(uint8_t pin) {
+    return MoaSimBoard::instance().analogReadMilliVolts(pin);
+}
+
+void analogReadResolution(uint8_t bits) {
+    MoaSimBoard::instance().setAnalogResolution(bits);
+}
+
+double ledcSetup(uint8_t channel, double freq, uint8_t resolution_bits) {
+    return MoaSimBoard::instance().ledcSetup(channel, freq, resolution_bits);
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {
+    MoaSimBoard::instance().ledcAttachPin(pin, channel);
+}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    MoaSimBoard::instance().ledcWrite(channel, duty);
+}
+
+uint32_t ledcRead(uint8_t channel) {
+    return MoaSimBoard::instance().ledcRead(channel);
+}
+
+unsigned long millis() {
+    return static_cast<unsigned long>(MoaSimKernel::instance().nowUs() / 1000ULL);
+}
+
+unsigned long micros() {
+    return static_cast<unsigned long>(MoaSimKernel::instance().nowUs());
+}
+
+void delay(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+    MoaSimKernel::instance().busyWaitUs(us);
+}
+
+size_t Print::printf(const char* format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) {
+        return 0;
+    }
+    if (static_cast<size_t>(length) < sizeof(buffer)) {
+        return write(reinterpret_cast<const uint8_t*>(buffer), length);
+    }
+
+    std::string text(length + 1, '\0');
+    va_start(args, format);
+    vsnprintf(&text[0], text.size(), format, args);
+    va_end(args);
+    return write(reinterpret_cast<const uint8_t*>(text.data()), length);
+}
+
+HardwareSerial Serial;
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    if (_capture != nullptr) {
+        _capture->append(reinterpret_cast<const char*>(buffer), size);
+    } else {
+        fwrite(buffer, 1, size, stdout);
+    }
+    return size;
+}
+
+void HardwareSerial::flush() {
+    if (_capture == nullptr) {
+        fflush(stdout);
+    }
+}
+
+void HardwareSerial::inject(const char* text) {
+    if (_rxPos == _rx.size()) {
+        _rx.clear();
+        _rxPos = 0;
+    }
+    _rx += text;
+}
+
+// =============================================================================
+// Wire
+// =============================================================================
+
+TwoWire Wire(0);
+
+TwoWire::TwoWire(uint8_t busNum)
+    : _busNum(busNum)
+    , _frequency(100000)
+    , _txAddress(0)
+    , _txLength(0)
+    , _rxLength(0)
+    , _rxIndex(0)
+    , _pendingRegister(-1)
+{
+}
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+    (void)sda;
+    (void)scl;
+    if (frequency != 0) {
+        _frequency = frequency;
+    }
+    return true;
+}
+
+bool TwoWire::end() {
+    return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency) {
+    _frequency = frequency;
+    return true;
+}
+
+uint32_t TwoWire::getClock() {
+    return _frequency;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    _txAddress = address;
+    _txLength = 0;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    MoaSimBoard& board = MoaSimBoard::instance();
+    if (!sendStop && _txLength == 1) {
+        // Register pointer for the read that follows the repeated start
+        _pendingRegister = _txBuffer[0];
+        return (board.i2cWrite(_txAddress, nullptr, 0) == 0) ? 0 : 2;
+    }
+    _pendingRegister = -1;
+    return board.i2cWrite(_txAddress, _txBuffer, _txLength);
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool sendStop) {
+    (void)sendStop;
+    _rxIndex = 0;
+    _rxLength = 0;
+    if (_pendingRegister < 0 || quantity > I2C_BUFFER_LENGTH) {
+        return 0;
+    }
+    uint8_t reg = static_cast<uint8_t>(_pendingRegister);
+    _pendingRegister = -1;
+    if (MoaSimBoard::instance().i2cRead(address, reg, _rxBuffer, quantity) != 0) {
+        return 0;
+    }
+    _rxLength = quantity;
+    return quantity;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (_txLength >= I2C_BUFFER_LENGTH) {
+        return 0;
+    }
+    _txBuffer[_txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t quantity) {
+    size_t n = 0;
+    while (n < quantity && write(data[n]) == 1) {
+        n++;
+    }
+    return n;
+}
+
+int TwoWire::available() {
+    return static_cast<int>(_rxLength - _rxIndex);
+}
+
+int TwoWire::read() {
+    return (_rxIndex < _rxLength) ? _rxBuffer[_rxIndex++] : -1;
+}
+
+int TwoWire::peek() {
+    return (_rxIndex < _rxLength) ? _rxBuffer[_rxIndex] : -1;
+}
+
+// =============================================================================
+// Network (no access point in range)
+// =============================================================================
+
+WiFiClass WiFi;
+ArduinoOTAClass ArduinoOTA;
+
+// =============================================================================
+// ESP-IDF
+// =============================================================================
+
+int64_t esp_timer_get_time(void) {
+    return static_cast<int64_t>(MoaSimKernel::instance().nowUs());
+}
+
+const char* esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK:                return "ESP_OK";
+        case ESP_FAIL:              return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:        return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:  return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:     return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT:       return "ESP_ERR_TIMEOUT";
+        default:                    return "UNKNOWN ERROR";
+    }
+}
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode) {
+    MoaSimBoard::instance().pinMode(static_cast<uint8_t>(gpio_num), (mode == GPIO_MODE_OUTPUT) ? OUTPUT : INPUT);
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_pull_mode(gpio_num_t gpio_num, gpio_pull_mode_t pull) {
+    (void)gpio_num;
+    (void)pull;
+    return ESP_OK;
+}
+
+/**
+ * @brief Continuous ADC driver state between initialize and deinitialize
+ */
+static struct {
+    bool initialized;
+    bool running;
+    uint32_t storeBytes;
+    uint32_t frameBytes;
+    uint8_t channels[SOC_ADC_PATT_LEN_MAX];
+    uint8_t channelCount;
+    uint32_t sampleRateHz;
+} adcDriver;
+
+esp_err_t adc_digi_initialize(const adc_digi_init_config_t* init_config) {
+    if (init_config == nullptr || init_config->max_store_buf_size < SOC_ADC_DIGI_RESULT_BYTES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (adcDriver.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    adcDriver.initialized = true;
+    adcDriver.storeBytes = init_config->max_store_buf_size;
+    adcDriver.frameBytes = init_config->conv_num_each_intr;
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_deinitialize(void) {
+    if (!adcDriver.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (adcDriver.running) {
+        adc_digi_stop();
+    }
+    adcDriver.initialized = false;
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_controller_configure(const adc_digi_configuration_t* config) {
+    if (config == nullptr || config->pattern_num == 0 || config->pattern_num > SOC_ADC_PATT_LEN_MAX
+        || config->format != ADC_DIGI_OUTPUT_FORMAT_TYPE2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (uint32_t i = 0; i < config->pattern_num; i++) {
+        adcDriver.channels[i] = config->adc_pattern[i].channel;
+    }
+    adcDriver.channelCount = static_cast<uint8_t>(config->pattern_num);
+    adcDriver.sampleRateHz = config->sample_freq_hz;
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_start(void) {
+    if (!adcDriver.initialized || adcDriver.channelCount == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    MoaSimBoard::instance().adcStart(adcDriver.channels, adcDriver.channelCount,
+                                     adcDriver.sampleRateHz, adcDriver.storeBytes, adcDriver.frameBytes);
+    adcDriver.running = true;
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_stop(void) {
+    MoaSimBoard::instance().adcStop();
+    adcDriver.running = false;
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_read_bytes(uint8_t* buf, uint32_t length_max, uint32_t* out_length, uint32_t timeout_ms) {
+    (void)timeout_ms;                       // Never blocks: the firmware polls
+    *out_length = 0;
+    if (!adcDriver.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    bool overrun = false;
+    *out_length = MoaSimBoard::instance().adcRead(buf, length_max, overrun);
+    if (overrun) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return (*out_length == 0) ? ESP_ERR_TIMEOUT : ESP_OK;
+}
+
+esp_err_t uart_driver_install(uart_port_t uart_num, int rx_buffer_size, int tx_buffer_size,
+                              int queue_size, QueueHandle_t* uart_queue, int intr_alloc_flags) {
+    (void)tx_buffer_size;                   // Writes complete at once
+    (void)intr_alloc_flags;
+    if (uart_num >= UART_NUM_MAX || rx_buffer_size <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    QueueHandle_t events = nullptr;
+    if (queue_size > 0 && uart_queue != nullptr) {
+        events = xQueueCreate(queue_size, sizeof(uart_event_t));
+        *uart_queue = events;
+    }
+    if (!MoaSimBoard::instance().uartInstall(static_cast<uint8_t>(uart_num), rx_buffer_size, events)) {
+        if (events != nullptr) {
+            vQueueDelete(events);
+        }
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t uart_driver_delete(uart_port_t uart_num) {
+    MoaSimBoard::instance().uartUninstall(static_cast<uint8_t>(uart_num));
+    return ESP_OK;
+}
+
+esp_err_t uart_param_config(uart_port_t uart_num, const uart_config_t* uart_config) {
+    if (uart_num >= UART_NUM_MAX || uart_config == nullptr || uart_config->baud_rate <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    MoaSimBoard::instance().uartSetBaud(static_cast<uint8_t>(uart_num), static_cast<uint32_t>(uart_config->baud_rate));
+    return ESP_OK;
+}
+
+esp_err_t uart_set_pin(uart_port_t uart_num, int tx_io_num, int rx_io_num, int rts_io_num, int cts_io_num) {
+    (void)tx_io_num;
+    (void)rx_io_num;
+    (void)rts_io_num;
+    (void)cts_io_num;
+    return (uart_num < UART_NUM_MAX) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t uart_set_rx_timeout(uart_port_t uart_num, const uint8_t tout_thresh) {
+    if (uart_num >= UART_NUM_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    MoaSimBoard::instance().uartSetRxTimeout(static_cast<uint8_t>(uart_num), tout_thresh);
+    return ESP_OK;
+}
+
+esp_err_t uart_set_rx_full_threshold(uart_port_t uart_num, int threshold) {
+    (void)threshold;                        // Bursts are delivered whole
+    return (uart_num < UART_NUM_MAX) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+int uart_read_bytes(uart_port_t uart_num, void* buf, uint32_t length, TickType_t ticks_to_wait) {
+    (void)ticks_to_wait;                    // Called after a UART_DATA event: never waits
+    if (uart_num >= UART_NUM_MAX) {
+        return -1;
+    }
+    return static_cast<int>(MoaSimBoard::instance().uartRead(static_cast<uint8_t>(uart_num),
+                                                             static_cast<uint8_t*>(buf), length));
+}
+
+int uart_write_bytes(uart_port_t uart_num, const void* src, size_t size) {
+    if (uart_num >= UART_NUM_MAX) {
+        return -1;
+    }
+    MoaSimBoard::instance().uartWrite(static_cast<uint8_t>(uart_num), static_cast<const uint8_t*>(src), size);
+    return static_cast<int>(size);
+}
+
+esp_err_t uart_flush_input(uart_port_t uart_num) {
+    MoaSimBoard::instance().uartFlushInput(static_cast<uint8_t>(uart_num));
+    return ESP_OK;
+}
+
+esp_err_t uart_get_buffered_data_len(uart_port_t uart_num, size_t* size) {
+    *size = MoaSimBoard::instance().uartBuffered(static_cast<uint8_t>(uart_num));
+    return ESP_OK;
+}
+
+// =============================================================================
+// Logging
+// =============================================================================
+
+static std::mutex logMutex;
+static std::map<std::string, esp_log_level_t> logLevels;
+static esp_log_level_t logDefault = ESP_LOG_ERROR;     // CORE_DEBUG_LEVEL=1, as the firmware builds
+
+void esp_log_level_set(const char* tag, esp_log_level_t level) {
+    std::lock_guard<std::mutex> lock(logMutex);
+    if (strcmp(tag, "*") == 0) {
+        logDefault = level;
+        logLevels.clear();
+    } else {
+        logLevels[tag] = level;
+    }
+}
+
+void moaSimLogWrite(esp_log_level_t level, const char* tag, const char* format, ...) {
+    static const char LETTERS[] = "NEWIDV";
+    {
+        std::lock_guard<std::mutex> lock(logMutex);
+        std::map<std::string, esp_log_level_t>::const_iterator it = logLevels.find(tag);
+        esp_log_level_t threshold = (it != logLevels.end()) ? it->second : logDefault;
+        if (level > threshold) {
+            return;
+        }
+    }
+
+    char message[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    fprintf(stdout, "%c (%lu) %s: %s\n", LETTERS[level], millis(), tag, message);
+}
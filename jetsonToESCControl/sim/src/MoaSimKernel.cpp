@@ -0,0 +1,939 @@
+/**
+ * @file MoaSimKernel.cpp
+ * @brief Implementation of the simulated FreeRTOS kernel
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * All kernel state is only touched by the thread holding the baton, so the
+ * mutex below guards nothing but the hand-over itself.
+ */
+
+#include "MoaSimKernel.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/timers.h"
+#include "esp_timer.h"
+
+#include <string.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const uint64_t NEVER = UINT64_MAX;
+static const uint64_t US_PER_TICK = 1000000ULL / configTICK_RATE_HZ;
+
+struct SimWaitList;
+
+struct tskTaskControlBlock {
+    enum class State : uint8_t { READY, BLOCKED, DELETED };
+
+    std::string name;
+    TaskFunction_t entry;
+    void* params;
+    UBaseType_t priority;
+    uint32_t stackDepth;        ///< As passed to xTaskCreate (bytes on ESP-IDF)
+    State state;
+    uint64_t readySeq;          ///< FIFO order within a priority
+    uint64_t wakeUs;            ///< Timeout while blocked (NEVER = none)
+    SimWaitList* waitingOn;     ///< Queue wait list while blocked
+    bool timedOut;
+    std::condition_variable turn;
+};
+
+struct SimWaitList {
+    std::vector<TaskHandle_t> tasks;   ///< In blocking order
+};
+
+struct QueueDefinition {
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    std::deque<std::vector<uint8_t>> items;
+    SimWaitList receivers;
+    SimWaitList senders;
+};
+
+struct tmrTimerControl {
+    std::string name;
+    TickType_t period;
+    bool autoReload;
+    void* id;
+    TimerCallbackFunction_t callback;
+    bool active;
+    bool deleted;
+    uint64_t expiryUs;
+    uint64_t seq;               ///< Orders timers expiring on the same tick
+};
+
+struct esp_timer {
+    std::string name;
+    esp_timer_cb_t callback;
+    void* arg;
+    uint64_t periodUs;          ///< 0 = one-shot
+    bool active;
+    bool deleted;
+    uint64_t expiryUs;
+    uint64_t seq;               ///< Orders timers expiring at the same time
+};
+
+/**
+ * @brief Priority of the esp_timer task on ESP-IDF (ESP_TASK_TIMER_PRIO)
+ */
+static const UBaseType_t ESP_TIMER_TASK_PRIORITY = 22;
+
+/**
+ * @brief Thrown by vTaskDelete(NULL) to unwind the calling task's thread
+ */
+struct SimTaskExit {};
+
+struct SimState {
+    std::mutex lock;
+    tskTaskControlBlock host;
+    TaskHandle_t current = &host;
+    std::vector<TaskHandle_t> tasks;
+    std::vector<TimerHandle_t> timers;
+    SimWaitList timerWake;
+    std::vector<esp_timer_handle_t> espTimers;
+    SimWaitList espTimerWake;
+    IMoaSimDevice* device = nullptr;
+    void (*switchHook)(void*) = nullptr;
+    void* switchHookContext = nullptr;
+    uint64_t nowUs = 0;
+    uint64_t runUntilUs = 0;
+    uint64_t seq = 0;
+    uint64_t switches = 0;
+    int isrDepth = 0;
+    bool scheduling = false;
+    void (*setupFn)() = nullptr;
+    void (*loopFn)() = nullptr;
+
+    SimState() {
+        host.name = "host";
+        host.entry = nullptr;
+        host.params = nullptr;
+        host.priority = 0;
+        host.stackDepth = 0;
+        host.state = tskTaskControlBlock::State::READY;
+        host.readySeq = 0;
+        host.wakeUs = NEVER;
+        host.waitingOn = nullptr;
+        host.timedOut = false;
+    }
+};
+
+// Never destroyed: parked task threads still wait on its condition variables at exit
+static SimState& sim() {
+    static SimState* state = new SimState();
+    return *state;
+}
+
+// =============================================================================
+// Scheduler core
+// =============================================================================
+
+static bool inTaskContext() {
+    SimState& s = sim();
+    return s.isrDepth == 0 && s.current != &s.host;
+}
+
+static void detachWait(TaskHandle_t task) {
+    if (task->waitingOn != nullptr) {
+        std::vector<TaskHandle_t>& list = task->waitingOn->tasks;
+        list.erase(std::remove(list.begin(), list.end(), task), list.end());
+        task->waitingOn = nullptr;
+    }
+}
+
+static void makeReady(TaskHandle_t task) {
+    detachWait(task);
+    task->state = tskTaskControlBlock::State::READY;
+    task->wakeUs = NEVER;
+    task->readySeq = ++sim().seq;
+}
+
+static TaskHandle_t highestReady() {
+    TaskHandle_t best = nullptr;
+    for (TaskHandle_t task : sim().tasks) {
+        if (task->state != tskTaskControlBlock::State::READY) {
+            continue;
+        }
+        if (best == nullptr || task->priority > best->priority
+            || (task->priority == best->priority && task->readySeq < best->readySeq)) {
+            best = task;
+        }
+    }
+    return best;
+}
+
+static uint64_t nextDueUs() {
+    SimState& s = sim();
+    uint64_t due = (s.device != nullptr) ? s.device->nextEventUs() : NEVER;
+    for (TaskHandle_t task : s.tasks) {
+        if (task->state == tskTaskControlBlock::State::BLOCKED && task->wakeUs < due) {
+            due = task->wakeUs;
+        }
+    }
+    return due;
+}
+
+/**
+ * @brief Wake timed-out tasks and run device events due by now
+ */
+static void serviceDue() {
+    SimState& s = sim();
+    for (TaskHandle_t task : s.tasks) {
+        if (task->state == tskTaskControlBlock::State::BLOCKED && task->wakeUs <= s.nowUs) {
+            task->timedOut = true;
+            makeReady(task);
+        }
+    }
+    if (s.device != nullptr && s.device->nextEventUs() <= s.nowUs) {
+        s.isrDepth++;
+        s.device->advance(s.nowUs);
+        s.isrDepth--;
+    }
+}
+
+/**
+ * @brief Next baton holder, advancing the clock while nothing is ready
+ */
+static TaskHandle_t pickNext() {
+    SimState& s = sim();
+    s.scheduling = true;
+    if (s.switchHook != nullptr) {
+        s.switchHook(s.switchHookContext);
+    }
+    TaskHandle_t next = nullptr;
+    while (next == nullptr) {
+        serviceDue();
+        next = highestReady();
+        if (next != nullptr) {
+            break;
+        }
+        uint64_t due = nextDueUs();
+        if (due > s.runUntilUs) {
+            s.nowUs = std::max(s.nowUs, s.runUntilUs);
+            next = &s.host;
+            break;
+        }
+        s.nowUs = std::max(s.nowUs, due);
+    }
+    s.scheduling = false;
+    return next;
+}
+
+static void switchTo(TaskHandle_t next) {
+    SimState& s = sim();
+    TaskHandle_t self = s.current;
+    if (next == self) {
+        return;
+    }
+    std::unique_lock<std::mutex> lk(s.lock);
+    s.current = next;
+    s.switches++;
+    next->turn.notify_one();
+    self->turn.wait(lk, [&] { return s.current == self; });
+}
+
+static void reschedule() {
+    switchTo(pickNext());
+}
+
+/**
+ * @brief Hand the CPU to a task that just became ready, if it outranks us
+ */
+static void preemptFor(TaskHandle_t woken) {
+    SimState& s = sim();
+    if (woken != nullptr && inTaskContext() && !s.scheduling && woken->priority > s.current->priority) {
+        reschedule();
+    }
+}
+
+/**
+ * @brief Block the running task until woken or until deadlineUs
+ * @return false on timeout (or when called from the host or an ISR)
+ */
+static bool blockOn(SimWaitList* list, uint64_t deadlineUs) {
+    SimState& s = sim();
+    if (!inTaskContext()) {
+        return false;
+    }
+    TaskHandle_t self = s.current;
+    self->state = tskTaskControlBlock::State::BLOCKED;
+    self->wakeUs = deadlineUs;
+    self->timedOut = false;
+    if (list != nullptr) {
+        list->tasks.push_back(self);
+        self->waitingOn = list;
+    }
+    reschedule();
+    return !self->timedOut;
+}
+
+/**
+ * @brief Ready the highest-priority waiter (FIFO within a priority)
+ */
+static TaskHandle_t wakeOne(SimWaitList& list) {
+    TaskHandle_t best = nullptr;
+    for (TaskHandle_t task : list.tasks) {
+        if (best == nullptr || task->priority > best->priority) {
+            best = task;
+        }
+    }
+    if (best != nullptr) {
+        makeReady(best);
+    }
+    return best;
+}
+
+static uint64_t tickDeadlineUs(TickType_t ticks) {
+    if (ticks == portMAX_DELAY) {
+        return NEVER;
+    }
+    return (sim().nowUs / US_PER_TICK + ticks) * US_PER_TICK;
+}
+
+static void taskMain(TaskHandle_t self) {
+    SimState& s = sim();
+    {
+        std::unique_lock<std::mutex> lk(s.lock);
+        self->turn.wait(lk, [&] { return s.current == self; });
+    }
+    try {
+        self->entry(self->params);
+    } catch (const SimTaskExit&) {
+    }
+
+    // Returning from a task function is vTaskDelete(NULL)
+    detachWait(self);
+    self->state = tskTaskControlBlock::State::DELETED;
+    s.tasks.erase(std::remove(s.tasks.begin(), s.tasks.end(), self), s.tasks.end());
+    TaskHandle_t next = pickNext();
+    std::lock_guard<std::mutex> lk(s.lock);
+    s.current = next;
+    s.switches++;
+    next->turn.notify_one();
+}
+
+// =============================================================================
+// Timer service
+// =============================================================================
+
+static TimerHandle_t earliestTimer() {
+    TimerHandle_t best = nullptr;
+    for (TimerHandle_t timer : sim().timers) {
+        if (!timer->active || timer->deleted) {
+            continue;
+        }
+        if (best == nullptr || timer->expiryUs < best->expiryUs
+            || (timer->expiryUs == best->expiryUs && timer->seq < best->seq)) {
+            best = timer;
+        }
+    }
+    return best;
+}
+
+static void timerServiceTask(void* pvParameters) {
+    (void)pvParameters;
+    SimState& s = sim();
+    for (;;) {
+        TimerHandle_t timer = earliestTimer();
+        while (timer != nullptr && timer->expiryUs <= s.nowUs) {
+            if (timer->autoReload) {
+                timer->expiryUs += static_cast<uint64_t>(timer->period) * US_PER_TICK;
+                timer->seq = ++s.seq;
+            } else {
+                timer->active = false;
+            }
+            timer->callback(timer);
+            timer = earliestTimer();
+        }
+
+        for (size_t i = 0; i < s.timers.size();) {
+            if (s.timers[i]->deleted) {
+                delete s.timers[i];
+                s.timers.erase(s.timers.begin() + i);
+            } else {
+                i++;
+            }
+        }
+
+        timer = earliestTimer();
+        blockOn(&s.timerWake, (timer != nullptr) ? timer->expiryUs : NEVER);
+    }
+}
+
+static void kickTimerService() {
+    TaskHandle_t daemon = wakeOne(sim().timerWake);
+    preemptFor(daemon);
+}
+
+static BaseType_t armTimer(TimerHandle_t timer) {
+    if (timer == nullptr || timer->deleted) {
+        return pdFAIL;
+    }
+    SimState& s = sim();
+    TickType_t period = (timer->period > 0) ? timer->period : 1;
+    timer->expiryUs = (s.nowUs / US_PER_TICK + period) * US_PER_TICK;
+    timer->seq = ++s.seq;
+    timer->active = true;
+    kickTimerService();
+    return pdPASS;
+}
+
+// =============================================================================
+// esp_timer task
+// =============================================================================
+
+static esp_timer_handle_t earliestEspTimer() {
+    esp_timer_handle_t best = nullptr;
+    for (esp_timer_handle_t timer : sim().espTimers) {
+        if (!timer->active || timer->deleted) {
+            continue;
+        }
+        if (best == nullptr || timer->expiryUs < best->expiryUs
+            || (timer->expiryUs == best->expiryUs && timer->seq < best->seq)) {
+            best = timer;
+        }
+    }
+    return best;
+}
+
+static void espTimerTask(void* pvParameters) {
+    (void)pvParameters;
+    SimState& s = sim();
+    for (;;) {
+        esp_timer_handle_t timer = earliestEspTimer();
+        while (timer != nullptr && timer->expiryUs <= s.nowUs) {
+            if (timer->periodUs > 0) {
+                timer->expiryUs += timer->periodUs;
+                timer->seq = ++s.seq;
+            } else {
+                timer->active = false;
+            }
+            timer->callback(timer->arg);
+            timer = earliestEspTimer();
+        }
+
+        for (size_t i = 0; i < s.espTimers.size();) {
+            if (s.espTimers[i]->deleted) {
+                delete s.espTimers[i];
+                s.espTimers.erase(s.espTimers.begin() + i);
+            } else {
+                i++;
+            }
+        }
+
+        timer = earliestEspTimer();
+        blockOn(&s.espTimerWake, (timer != nullptr) ? timer->expiryUs : NEVER);
+    }
+}
+
+static esp_err_t armEspTimer(esp_timer_handle_t timer, uint64_t delayUs, uint64_t periodUs) {
+    if (timer == nullptr || timer->deleted) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (timer->active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    SimState& s = sim();
+    timer->periodUs = periodUs;
+    timer->expiryUs = s.nowUs + delayUs;
+    timer->seq = ++s.seq;
+    timer->active = true;
+    preemptFor(wakeOne(s.espTimerWake));
+    return ESP_OK;
+}
+
+// =============================================================================
+// Arduino loopTask
+// =============================================================================
+
+static void loopTask(void* pvParameters) {
+    (void)pvParameters;
+    SimState& s = sim();
+    if (s.setupFn != nullptr) {
+        s.setupFn();
+    }
+    for (;;) {
+        if (s.loopFn != nullptr) {
+            s.loopFn();
+        }
+        vTaskDelay(1);  // Stands in for the idle time an empty loop() spins through
+    }
+}
+
+// =============================================================================
+// MoaSimKernel
+// =============================================================================
+
+MoaSimKernel& MoaSimKernel::instance() {
+    static MoaSimKernel* kernel = new MoaSimKernel();
+    return *kernel;
+}
+
+void MoaSimKernel::boot(void (*setupFn)(), void (*loopFn)()) {
+    SimState& s = sim();
+    s.setupFn = setupFn;
+    s.loopFn = loopFn;
+    xTaskCreate(timerServiceTask, "Tmr Svc", 4096, nullptr, configTIMER_TASK_PRIORITY, nullptr);
+    xTaskCreate(espTimerTask, "esp_timer", 4096, nullptr, ESP_TIMER_TASK_PRIORITY, nullptr);
+    xTaskCreate(loopTask, "loopTask", 8192, nullptr, 1, nullptr);
+}
+
+void MoaSimKernel::run(uint64_t durationUs) {
+    SimState& s = sim();
+    if (s.current != &s.host) {
+        return;
+    }
+    s.runUntilUs = s.nowUs + durationUs;
+    reschedule();
+}
+
+uint64_t MoaSimKernel::nowUs() const {
+    return sim().nowUs;
+}
+
+void MoaSimKernel::busyWaitUs(uint32_t us) {
+    sim().nowUs += us;
+}
+
+void MoaSimKernel::runIsr(void (*isr)()) {
+    SimState& s = sim();
+    s.isrDepth++;
+    isr();
+    s.isrDepth--;
+    preemptFor(highestReady());
+}
+
+bool MoaSimKernel::inIsr() const {
+    return sim().isrDepth > 0;
+}
+
+void MoaSimKernel::setDevice(IMoaSimDevice* device) {
+    sim().device = device;
+}
+
+void MoaSimKernel::setSwitchHook(void (*hook)(void*), void* context) {
+    SimState& s = sim();
+    s.switchHook = hook;
+    s.switchHookContext = context;
+}
+
+uint32_t MoaSimKernel::getTaskCount() const {
+    return static_cast<uint32_t>(sim().tasks.size());
+}
+
+uint64_t MoaSimKernel::getContextSwitches() const {
+    return sim().switches;
+}
+
+const char* MoaSimKernel::getCurrentTaskName() const {
+    return sim().current->name.c_str();
+}
+
+// =============================================================================
+// task.h
+// =============================================================================
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t pvTaskCode, const char* pcName, uint32_t usStackDepth,
+                                   void* pvParameters, UBaseType_t uxPriority,
+                                   TaskHandle_t* pxCreatedTask, BaseType_t xCoreID) {
+    (void)xCoreID;
+    SimState& s = sim();
+    TaskHandle_t task = new tskTaskControlBlock();
+    task->name = (pcName != nullptr) ? pcName : "";
+    task->entry = pvTaskCode;
+    task->params = pvParameters;
+    task->priority = std::min<UBaseType_t>(uxPriority, configMAX_PRIORITIES - 1);
+    task->stackDepth = usStackDepth;
+    task->waitingOn = nullptr;
+    task->timedOut = false;
+    makeReady(task);
+    s.tasks.push_back(task);
+    std::thread(taskMain, task).detach();
+
+    if (pxCreatedTask != nullptr) {
+        *pxCreatedTask = task;
+    }
+    preemptFor(task);
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t xTaskToDelete) {
+    SimState& s = sim();
+    if (xTaskToDelete == nullptr || xTaskToDelete == s.current) {
+        if (inTaskContext()) {
+            throw SimTaskExit();
+        }
+        return;
+    }
+    // The victim's thread stays parked for good
+    detachWait(xTaskToDelete);
+    xTaskToDelete->state = tskTaskControlBlock::State::DELETED;
+    s.tasks.erase(std::remove(s.tasks.begin(), s.tasks.end(), xTaskToDelete), s.tasks.end());
+}
+
+void vTaskDelay(TickType_t xTicksToDelay) {
+    SimState& s = sim();
+    if (!inTaskContext()) {
+        return;
+    }
+    if (xTicksToDelay == 0) {
+        s.current->readySeq = ++s.seq;  // Yield to tasks of the same priority
+        reschedule();
+        return;
+    }
+    blockOn(nullptr, tickDeadlineUs(xTicksToDelay));
+}
+
+BaseType_t xTaskDelayUntil(TickType_t* pxPreviousWakeTime, TickType_t xTimeIncrement) {
+    TickType_t wake = *pxPreviousWakeTime + xTimeIncrement;
+    *pxPreviousWakeTime = wake;
+    if (wake <= xTaskGetTickCount()) {
+        return pdFALSE;  // Already late: no delay
+    }
+    blockOn(nullptr, static_cast<uint64_t>(wake) * US_PER_TICK);
+    return pdTRUE;
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return static_cast<TickType_t>(sim().nowUs / US_PER_TICK);
+}
+
+TickType_t xTaskGetTickCountFromISR(void) {
+    return xTaskGetTickCount();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    SimState& s = sim();
+    return (s.current != &s.host) ? s.current : nullptr;
+}
+
+char* pcTaskGetName(TaskHandle_t xTaskToQuery) {
+    SimState& s = sim();
+    TaskHandle_t task = (xTaskToQuery != nullptr) ? xTaskToQuery : s.current;
+    return &task->name[0];
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t xTask) {
+    SimState& s = sim();
+    return ((xTask != nullptr) ? xTask : s.current)->priority;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask) {
+    SimState& s = sim();
+    return ((xTask != nullptr) ? xTask : s.current)->stackDepth;
+}
+
+// =============================================================================
+// queue.h / semphr.h
+// =============================================================================
+
+static QueueHandle_t createQueue(UBaseType_t length, UBaseType_t itemSize, UBaseType_t initialItems) {
+    QueueHandle_t queue = new QueueDefinition();
+    queue->length = length;
+    queue->itemSize = itemSize;
+    for (UBaseType_t i = 0; i < initialItems; i++) {
+        queue->items.push_back(std::vector<uint8_t>());
+    }
+    return queue;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize) {
+    if (uxQueueLength == 0) {
+        return nullptr;
+    }
+    return createQueue(uxQueueLength, uxItemSize, 0);
+}
+
+void vQueueDelete(QueueHandle_t xQueue) {
+    if (xQueue == nullptr) {
+        return;
+    }
+    for (TaskHandle_t task : xQueue->receivers.tasks) {
+        task->waitingOn = nullptr;
+    }
+    for (TaskHandle_t task : xQueue->senders.tasks) {
+        task->waitingOn = nullptr;
+    }
+    delete xQueue;
+}
+
+static bool tryPush(QueueHandle_t queue, const void* item, BaseType_t position) {
+    if (queue->items.size() >= queue->length) {
+        if (position != queueOVERWRITE) {
+            return false;
+        }
+        queue->items.pop_back();
+    }
+    std::vector<uint8_t> copy(queue->itemSize);
+    if (queue->itemSize > 0 && item != nullptr) {
+        memcpy(copy.data(), item, queue->itemSize);
+    }
+    if (position == queueSEND_TO_FRONT) {
+        queue->items.push_front(std::move(copy));
+    } else {
+        queue->items.push_back(std::move(copy));
+    }
+    return true;
+}
+
+static bool tryPop(QueueHandle_t queue, void* buffer, bool remove) {
+    if (queue->items.empty()) {
+        return false;
+    }
+    if (queue->itemSize > 0 && buffer != nullptr) {
+        memcpy(buffer, queue->items.front().data(), queue->itemSize);
+    }
+    if (remove) {
+        queue->items.pop_front();
+    }
+    return true;
+}
+
+static void reportWoken(TaskHandle_t woken, BaseType_t* pxHigherPriorityTaskWoken) {
+    SimState& s = sim();
+    if (pxHigherPriorityTaskWoken != nullptr && woken != nullptr && woken->priority > s.current->priority) {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+}
+
+BaseType_t xQueueGenericSend(QueueHandle_t xQueue, const void* pvItemToQueue, TickType_t xTicksToWait,
+                             BaseType_t xCopyPosition) {
+    if (xQueue == nullptr) {
+        return errQUEUE_FULL;
+    }
+    uint64_t deadline = tickDeadlineUs(xTicksToWait);
+    for (;;) {
+        if (tryPush(xQueue, pvItemToQueue, xCopyPosition)) {
+            preemptFor(wakeOne(xQueue->receivers));
+            return pdPASS;
+        }
+        if (xTicksToWait == 0 || !blockOn(&xQueue->senders, deadline)) {
+            return errQUEUE_FULL;
+        }
+    }
+}
+
+BaseType_t xQueueGenericSendFromISR(QueueHandle_t xQueue, const void* pvItemToQueue,
+                                    BaseType_t* pxHigherPriorityTaskWoken, BaseType_t xCopyPosition) {
+    if (xQueue == nullptr || !tryPush(xQueue, pvItemToQueue, xCopyPosition)) {
+        return errQUEUE_FULL;
+    }
+    reportWoken(wakeOne(xQueue->receivers), pxHigherPriorityTaskWoken);
+    return pdPASS;
+}
+
+static BaseType_t receive(QueueHandle_t queue, void* buffer, TickType_t ticks, bool remove) {
+    if (queue == nullptr) {
+        return errQUEUE_EMPTY;
+    }
+    uint64_t deadline = tickDeadlineUs(ticks);
+    for (;;) {
+        if (tryPop(queue, buffer, remove)) {
+            if (remove) {
+                preemptFor(wakeOne(queue->senders));
+            }
+            return pdPASS;
+        }
+        if (ticks == 0 || !blockOn(&queue->receivers, deadline)) {
+            return errQUEUE_EMPTY;
+        }
+    }
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void* pvBuffer, TickType_t xTicksToWait) {
+    return receive(xQueue, pvBuffer, xTicksToWait, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t xQueue, void* pvBuffer, TickType_t xTicksToWait) {
+    return receive(xQueue, pvBuffer, xTicksToWait, false);
+}
+
+BaseType_t xQueueReceiveFromISR(QueueHandle_t xQueue, void* pvBuffer, BaseType_t* pxHigherPriorityTaskWoken) {
+    if (xQueue == nullptr || !tryPop(xQueue, pvBuffer, true)) {
+        return errQUEUE_EMPTY;
+    }
+    reportWoken(wakeOne(xQueue->senders), pxHigherPriorityTaskWoken);
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t xQueue) {
+    return (xQueue != nullptr) ? static_cast<UBaseType_t>(xQueue->items.size()) : 0;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t xQueue) {
+    return (xQueue != nullptr) ? xQueue->length - static_cast<UBaseType_t>(xQueue->items.size()) : 0;
+}
+
+BaseType_t xQueueReset(QueueHandle_t xQueue) {
+    if (xQueue == nullptr) {
+        return pdFAIL;
+    }
+    xQueue->items.clear();
+    preemptFor(wakeOne(xQueue->senders));
+    return pdPASS;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    return createQueue(1, 0, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return createQueue(1, 0, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount) {
+    if (uxMaxCount == 0 || uxInitialCount > uxMaxCount) {
+        return nullptr;
+    }
+    return createQueue(uxMaxCount, 0, uxInitialCount);
+}
+
+// =============================================================================
+// timers.h
+// =============================================================================
+
+TimerHandle_t xTimerCreate(const char* pcTimerName, TickType_t xTimerPeriodInTicks, UBaseType_t uxAutoReload,
+                           void* pvTimerID, TimerCallbackFunction_t pxCallbackFunction) {
+    if (xTimerPeriodInTicks == 0 || pxCallbackFunction == nullptr) {
+        return nullptr;
+    }
+    TimerHandle_t timer = new tmrTimerControl();
+    timer->name = (pcTimerName != nullptr) ? pcTimerName : "";
+    timer->period = xTimerPeriodInTicks;
+    timer->autoReload = uxAutoReload != pdFALSE;
+    timer->id = pvTimerID;
+    timer->callback = pxCallbackFunction;
+    timer->active = false;
+    timer->deleted = false;
+    timer->expiryUs = NEVER;
+    timer->seq = 0;
+    sim().timers.push_back(timer);
+    return timer;
+}
+
+BaseType_t xTimerStart(TimerHandle_t xTimer, TickType_t xTicksToWait) {
+    (void)xTicksToWait;
+    return armTimer(xTimer);
+}
+
+BaseType_t xTimerReset(TimerHandle_t xTimer, TickType_t xTicksToWait) {
+    (void)xTicksToWait;
+    return armTimer(xTimer);
+}
+
+BaseType_t xTimerStop(TimerHandle_t xTimer, TickType_t xTicksToWait) {
+    (void)xTicksToWait;
+    if (xTimer == nullptr || xTimer->deleted) {
+        return pdFAIL;
+    }
+    xTimer->active = false;
+    return pdPASS;
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t xTimer, TickType_t xNewPeriod, TickType_t xTicksToWait) {
+    (void)xTicksToWait;
+    if (xTimer == nullptr || xTimer->deleted || xNewPeriod == 0) {
+        return pdFAIL;
+    }
+    xTimer->period = xNewPeriod;
+    return armTimer(xTimer);  // Changing the period also starts the timer
+}
+
+BaseType_t xTimerDelete(TimerHandle_t xTimer, TickType_t xTicksToWait) {
+    (void)xTicksToWait;
+    if (xTimer == nullptr || xTimer->deleted) {
+        return pdFAIL;
+    }
+    xTimer->active = false;
+    xTimer->deleted = true;  // Freed by the timer service
+    kickTimerService();
+    return pdPASS;
+}
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t xTimer) {
+    return (xTimer != nullptr && xTimer->active && !xTimer->deleted) ? pdTRUE : pdFALSE;
+}
+
+TickType_t xTimerGetPeriod(TimerHandle_t xTimer) {
+    return xTimer->period;
+}
+
+void* pvTimerGetTimerID(TimerHandle_t xTimer) {
+    return xTimer->id;
+}
+
+void vTimerSetTimerID(TimerHandle_t xTimer, void* pvNewID) {
+    xTimer->id = pvNewID;
+}
+
+const char* pcTimerGetName(TimerHandle_t xTimer) {
+    return xTimer->name.c_str();
+}
+
+// =============================================================================
+// esp_timer.h
+// =============================================================================
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* create_args, esp_timer_handle_t* out_handle) {
+    if (create_args == nullptr || create_args->callback == nullptr || out_handle == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_timer_handle_t timer = new esp_timer();
+    timer->name = (create_args->name != nullptr) ? create_args->name : "";
+    timer->callback = create_args->callback;
+    timer->arg = create_args->arg;
+    timer->periodUs = 0;
+    timer->active = false;
+    timer->deleted = false;
+    timer->expiryUs = NEVER;
+    timer->seq = 0;
+    sim().espTimers.push_back(timer);
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+    return armEspTimer(timer, timeout_us, 0);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period) {
+    if (period == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return armEspTimer(timer, period, period);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    if (timer == nullptr || timer->deleted) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!timer->active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->active = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    if (timer == nullptr || timer->deleted) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (timer->active) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->deleted = true;  // Freed by the esp_timer task
+    preemptFor(wakeOne(sim().espTimerWake));
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer) {
+    return timer != nullptr && timer->active && !timer->deleted;
+}
@@ -0,0 +1,353 @@
+/**
+ * @file MoaSimMain.cpp
+ * @brief Entry point of the sim env: the whole firmware as a host process
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Boots main.cpp's setup()/loop() on MoaSimKernel, plays a scenario on
+ * MoaSimBoard and prints a board status line at a fixed virtual period.
+ * stdout (firmware log, Serial, status) depends only on the scenario and
+ * seed; the wall-clock summary goes to stderr.
+ *
+ * Run with: pio run -e sim && .pio/build/sim/program [options]
+ *   --seconds N      virtual run time (default: length of the scenario)
+ *   --script FILE    scenario file instead of the built-in ride
+ *   --log e|w|i|d|v  firmware log level (default e)
+ *   --status-ms N    status line period (default 1000, 0 = off)
+ *   --seed N         ADC noise seed
+ *   --replay TRACE   play a recorded ride (MoaSimTrace.h) instead of a scenario
+ *   --report FILE    write the replay report (MoaSimReport.h)
+ *   --golden FILE    compare the replay report, exit 1 on a difference
+ *   --set KEY=VALUE  CLI setting applied at boot (repeatable), e.g. esc_ramp=50
+ *
+ * A replay keeps stdout to the report summary: Serial is discarded, the
+ * status line is off and the log defaults to none.
+ *
+ * Scenario lines (time in ms, '#' starts a comment):
+ *   <ms> press <stop|25|50|75|100> [holdMs]
+ *   <ms> serial <text>          (a newline is appended)
+ *   <ms> current <A>            extra load on the current sensor
+ *   <ms> water <degC>
+ *   <ms> soc <0..1>
+ *   <ms> end
+ */
+
+#if !defined(UNIT_TEST) && !defined(PIO_UNIT_TESTING)   // Test programs bring their own main()
+
+#include <Arduino.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "esp_log.h"
+#include <vector>
+#include "MoaMainUnit.h"
+#include "MoaSimBoard.h"
+#include "MoaSimKernel.h"
+#include "MoaSimReport.h"
+#include "MoaSimTrace.h"
+#include "PinMapping.h"
+
+void setup();
+void loop();
+
+extern MoaMainUnit mainUnit;
+
+static const uint32_t DEFAULT_PRESS_MS = 150;
+
+/**
+ * @brief Built-in ride: unlock, cruise, boost, overcurrent spike, stats dump
+ */
+static const char* DEFAULT_SCENARIO =
+    "1000 press stop 2500\n"
+    "5000 press 25\n"
+    "20000 press 50\n"
+    "35000 press stop\n"
+    "40000 press 100\n"
+    "60000 current 180\n"
+    "60030 current 0\n"
+    "70000 serial stats\n"
+    "75000 end\n";
+
+/**
+ * @brief Schedule a scenario on the board
+ * @return End time in us (last event, or the "end" line), 0 on a parse error
+ */
+static uint64_t loadScenario(std::istream& in) {
+    MoaSimBoard& board = MoaSimBoard::instance();
+    uint64_t endUs = 0;
+    uint64_t lastUs = 0;
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(in, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        std::istringstream fields(line);
+        uint64_t atMs;
+        std::string verb;
+        if (!(fields >> atMs)) {
+            continue;                                   // Blank line
+        }
+        fields >> verb;
+        uint64_t atUs = atMs * 1000ULL;
+
+        if (verb == "press") {
+            std::string name;
+            uint32_t holdMs;
+            fields >> name;
+            if (!(fields >> holdMs)) {
+                holdMs = DEFAULT_PRESS_MS;
+            }
+            int pin = MoaSimBoard::buttonPin(name);
+            if (pin < 0) {
+                fprintf(stderr, "line %d: unknown button '%s'\n", lineNumber, name.c_str());
+                return 0;
+            }
+            board.schedule(atUs, [pin]() { MoaSimBoard::instance().pressButton(static_cast<uint8_t>(pin)); });
+            board.schedule(atUs + holdMs * 1000ULL, [pin]() { MoaSimBoard::instance().releaseButton(static_cast<uint8_t>(pin)); });
+            atUs += holdMs * 1000ULL;
+        } else if (verb == "serial") {
+            std::string text;
+            std::getline(fields >> std::ws, text);
+            text += "\n";
+            board.schedule(atUs, [text]() { MoaSimBoard::instance().sendSerial(text.c_str()); });
+        } else if (verb == "current" || verb == "water" || verb == "soc") {
+            float value;
+            if (!(fields >> value)) {
+                fprintf(stderr, "line %d: missing value\n", lineNumber);
+                return 0;
+            }
+            if (verb == "current") {
+                board.schedule(atUs, [value]() { MoaSimBoard::instance().getPlant().setExtraCurrent(value); });
+            } else if (verb == "water") {
+                board.schedule(atUs, [value]() { MoaSimBoard::instance().getPlant().setWaterTemperature(value); });
+            } else {
+                board.schedule(atUs, [value]() { MoaSimBoard::instance().getPlant().setStateOfCharge(value); });
+            }
+        } else if (verb == "end") {
+            endUs = atUs;
+        } else {
+            fprintf(stderr, "line %d: unknown action '%s'\n", lineNumber, verb.c_str());
+            return 0;
+        }
+        lastUs = std::max(lastUs, atUs);
+    }
+    return (endUs != 0) ? endUs : lastUs + 1000000ULL;
+}
+
+static esp_log_level_t logLevel(char letter) {
+    switch (letter) {
+        case 'n': return ESP_LOG_NONE;
+        case 'w': return ESP_LOG_WARN;
+        case 'i': return ESP_LOG_INFO;
+        case 'd': return ESP_LOG_DEBUG;
+        case 'v': return ESP_LOG_VERBOSE;
+        default:  return ESP_LOG_ERROR;
+    }
+}
+
+static void printStatus() {
+    MoaSimBoard& board = MoaSimBoard::instance();
+    MoaSimPlant& plant = board.getPlant();
+    printf("[sim %8.3f s] duty=%3u pulse=%4.0fus I=%6.1fA V=%5.2fV T=%5.1fC leds=0x%02X\n",
+           MoaSimKernel::instance().nowUs() / 1e6,
+           board.getEscDuty(), board.getEscPulseUs(), plant.getCurrent(),
+           plant.getBatteryVoltage(), plant.getTemperature(), board.getLedOutputs());
+}
+
+static bool readFile(const char* path, std::string& text) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    text = buffer.str();
+    return true;
+}
+
+/**
+ * @brief Play a trace with the report attached
+ * @return Process exit code
+ */
+static int replay(const char* tracePath, const char* reportPath, const char* goldenPath, double seconds) {
+    MoaSimKernel& kernel = MoaSimKernel::instance();
+    MoaSimBoard& board = MoaSimBoard::instance();
+
+    std::ifstream file(tracePath);
+    if (!file) {
+        fprintf(stderr, "cannot open %s\n", tracePath);
+        return 2;
+    }
+    MoaSimTrace trace;
+    std::string error;
+    if (!trace.load(file, error)) {
+        fprintf(stderr, "%s: %s\n", tracePath, error.c_str());
+        return 2;
+    }
+    std::string golden;
+    if (goldenPath != nullptr && !readFile(goldenPath, golden)) {
+        fprintf(stderr, "cannot open %s\n", goldenPath);
+        return 2;
+    }
+    uint64_t endUs = (seconds > 0.0) ? static_cast<uint64_t>(seconds * 1e6) : trace.getEndUs();
+
+    std::string serial;
+    Serial.setCapture(&serial);
+    MoaSimReport report(mainUnit.getStateMachine(), mainUnit.getFlashLog(), board);
+    report.attach();
+    trace.play(board);
+
+    std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+    board.provisionProbes(mainUnit.getConfig());
+    kernel.boot(setup, loop);
+    kernel.run(endUs);
+    report.detach();
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    // A mistyped --set only shows on the discarded console
+    size_t err = serial.find("ERR:");
+    if (err != std::string::npos) {
+        fprintf(stderr, "%s\n", serial.substr(err, serial.find('\n', err) - err).c_str());
+    }
+
+    printf("replay: %zu samples, %zu button edges, %u transitions, %u duty changes, %u log entries\n",
+           trace.getSampleCount(), trace.getButtonCount(), report.getTransitionCount(),
+           report.getDutyChangeCount(), report.getLogEntryCount());
+    if (reportPath != nullptr) {
+        std::ofstream out(reportPath);
+        out << report.getText();
+    }
+
+    int status = 0;
+    if (goldenPath != nullptr) {
+        std::string differences;
+        if (MoaSimReport::diff(golden, report.getText(), differences)) {
+            printf("replay: matches %s\n", goldenPath);
+        } else {
+            printf("replay: differs from %s\n%s", goldenPath, differences.c_str());
+            status = 1;
+        }
+    }
+    fflush(stdout);
+
+    double virtualS = kernel.nowUs() / 1e6;
+    fprintf(stderr, "sim: %.3f s virtual in %.3f s wall (x%.0f)\n",
+            virtualS, wallS, (wallS > 0.0) ? virtualS / wallS : 0.0);
+    return status;
+}
+
+int main(int argc, char** argv) {
+    double seconds = 0.0;
+    const char* scriptPath = nullptr;
+    char logLetter = 'e';
+    bool logLetterSet = false;
+    uint32_t statusMs = 1000;
+    uint32_t seed = 1;
+    const char* tracePath = nullptr;
+    const char* reportPath = nullptr;
+    const char* goldenPath = nullptr;
+    std::vector<std::string> settings;
+
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (option == "--seconds" && hasValue) {
+            seconds = atof(argv[++i]);
+        } else if (option == "--script" && hasValue) {
+            scriptPath = argv[++i];
+        } else if (option == "--log" && hasValue) {
+            logLetter = argv[++i][0];
+            logLetterSet = true;
+        } else if (option == "--status-ms" && hasValue) {
+            statusMs = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (option == "--seed" && hasValue) {
+            seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (option == "--replay" && hasValue) {
+            tracePath = argv[++i];
+        } else if (option == "--report" && hasValue) {
+            reportPath = argv[++i];
+        } else if (option == "--golden" && hasValue) {
+            goldenPath = argv[++i];
+        } else if (option == "--set" && hasValue && strchr(argv[i + 1], '=') != nullptr) {
+            settings.push_back(argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--seconds N] [--script FILE] [--log e|w|i|d|v] "
+                            "[--status-ms N] [--seed N]\n"
+                            "       %s --replay TRACE [--report FILE] [--golden FILE] "
+                            "[--set KEY=VALUE]... [--seconds N] [--log e|w|i|d|v] [--seed N]\n",
+                    argv[0], argv[0]);
+            return 2;
+        }
+    }
+
+    if (tracePath != nullptr && !logLetterSet) {
+        logLetter = 'n';
+    }
+    esp_log_level_set("*", logLevel(logLetter));
+    MoaSimBoard& board = MoaSimBoard::instance();
+    board.setAdcNoise(MOA_SIM_ADC_NOISE_LSB, seed);
+
+    // Typed before the CLI task starts, read once it does
+    for (std::string setting : settings) {
+        setting[setting.find('=')] = ' ';
+        board.sendSerial(("set " + setting + "\n").c_str());
+    }
+    if (!settings.empty()) {
+        board.sendSerial("apply\n");
+    }
+
+    if (tracePath != nullptr) {
+        int status = replay(tracePath, reportPath, goldenPath, seconds);
+        _Exit(status);
+    }
+
+    uint64_t endUs;
+    if (scriptPath != nullptr) {
+        std::ifstream script(scriptPath);
+        if (!script) {
+            fprintf(stderr, "cannot open %s\n", scriptPath);
+            return 2;
+        }
+        endUs = loadScenario(script);
+    } else {
+        std::istringstream script(DEFAULT_SCENARIO);
+        endUs = loadScenario(script);
+    }
+    if (endUs == 0) {
+        return 2;
+    }
+    if (seconds > 0.0) {
+        endUs = static_cast<uint64_t>(seconds * 1e6);
+    }
+
+    MoaSimKernel& kernel = MoaSimKernel::instance();
+    std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+    board.provisionProbes(mainUnit.getConfig());
+    kernel.boot(setup, loop);
+
+    uint64_t stepUs = (statusMs > 0) ? statusMs * 1000ULL : endUs;
+    while (kernel.nowUs() < endUs) {
+        kernel.run(std::min(stepUs - kernel.nowUs() % stepUs, endUs - kernel.nowUs()));
+        if (statusMs > 0) {
+            printStatus();
+        }
+    }
+    fflush(stdout);
+
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    double virtualS = kernel.nowUs() / 1e6;
+    fprintf(stderr, "sim: %.3f s virtual in %.3f s wall (x%.0f), %u tasks, %llu context switches, %u I2C transactions\n",
+            virtualS, wallS, (wallS > 0.0) ? virtualS / wallS : 0.0, kernel.getTaskCount(),
+            static_cast<unsigned long long>(kernel.getContextSwitches()),
+            board.getMcp().getTransactions());
+
+    // Task threads stay parked on the baton; leave without unwinding them
+    _Exit(0);
+}
+
+#endif
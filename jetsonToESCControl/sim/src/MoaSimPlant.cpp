@@ -0,0 +1,112 @@
+/**
+ * @file MoaSimPlant.cpp
+ * @brief Implementation of the MoaSimPlant class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaSimPlant.h"
+
+MoaSimPlant::MoaSimPlant()
+    : _throttle(0.0f)
+    , _motorCurrent(0.0f)
+    , _extraCurrent(0.0f)
+    , _stateOfCharge(1.0f)
+    , _waterTemperature(MOA_SIM_WATER_TEMP_C)
+    , _temperature(MOA_SIM_WATER_TEMP_C)
+    , _measured(false)
+    , _measuredCurrent(0.0f)
+    , _measuredVoltage(0.0f)
+    , _measuredTemperature(0.0f)
+{
+}
+
+void MoaSimPlant::step(float dtSeconds) {
+    float target = _throttle * _throttle * MOA_SIM_MOTOR_MAX_CURRENT_A;
+    _motorCurrent += (target - _motorCurrent) * (dtSeconds / MOA_SIM_MOTOR_TIME_CONSTANT_S);
+
+    float current = getCurrent();
+    _stateOfCharge -= current * dtSeconds / (MOA_SIM_BATTERY_CAPACITY_AH * 3600.0f);
+    if (_stateOfCharge < 0.0f) {
+        _stateOfCharge = 0.0f;
+    } else if (_stateOfCharge > 1.0f) {
+        _stateOfCharge = 1.0f;
+    }
+
+    float settled = _waterTemperature + current * current * MOA_SIM_HEATING_C_PER_A2;
+    _temperature += (settled - _temperature) * (dtSeconds / MOA_SIM_THERMAL_TIME_CONSTANT_S);
+}
+
+void MoaSimPlant::setThrottle(float fraction) {
+    _throttle = (fraction < 0.0f) ? 0.0f : (fraction > 1.0f ? 1.0f : fraction);
+}
+
+void MoaSimPlant::setExtraCurrent(float amps) {
+    _extraCurrent = amps;
+}
+
+void MoaSimPlant::setStateOfCharge(float fraction) {
+    _stateOfCharge = (fraction < 0.0f) ? 0.0f : (fraction > 1.0f ? 1.0f : fraction);
+}
+
+void MoaSimPlant::setWaterTemperature(float celsius) {
+    _waterTemperature = celsius;
+}
+
+void MoaSimPlant::setTemperature(float celsius) {
+    _temperature = celsius;
+}
+
+void MoaSimPlant::setMeasured(float amps, float volts, float celsius) {
+    _measured = true;
+    _measuredCurrent = amps;
+    _measuredVoltage = volts;
+    _measuredTemperature = celsius;
+}
+
+void MoaSimPlant::clearMeasured() {
+    _measured = false;
+}
+
+bool MoaSimPlant::isMeasured() const {
+    return _measured;
+}
+
+float MoaSimPlant::getThrottle() const {
+    return _throttle;
+}
+
+float MoaSimPlant::getMotorCurrent() const {
+    return _motorCurrent;
+}
+
+float MoaSimPlant::getCurrent() const {
+    if (_measured) {
+        return _measuredCurrent;
+    }
+    return _motorCurrent + _extraCurrent;
+}
+
+float MoaSimPlant::getBatteryVoltage() const {
+    if (_measured) {
+        return _measuredVoltage;
+    }
+    float openCircuit = MOA_SIM_BATTERY_EMPTY_V
+                      + (MOA_SIM_BATTERY_FULL_V - MOA_SIM_BATTERY_EMPTY_V) * _stateOfCharge;
+    return openCircuit - getCurrent() * MOA_SIM_BATTERY_RESISTANCE_OHM;
+}
+
+float MoaSimPlant::getStateOfCharge() const {
+    return _stateOfCharge;
+}
+
+float MoaSimPlant::getTemperature() const {
+    if (_measured) {
+        return _measuredTemperature;
+    }
+    return _temperature;
+}
+
+float MoaSimPlant::getWaterTemperature() const {
+    return _waterTemperature;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file MoaSimReport.cpp
+ * @brief Implementation of the MoaSimReport class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaSimReport.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <sstream>
+#include "MoaSimBoard.h"
+#include "MoaSimKernel.h"
+#include "MoaFlashLog.h"
+#include "StateMachine/MoaStateMachineWrapper.h"
+
+MoaSimReport::MoaSimReport(MoaStateMachineWrapper& stateMachine, MoaFlashLog& flashLog, MoaSimBoard& board)
+    : _stateMachine(stateMachine)
+    , _flashLog(flashLog)
+    , _board(board)
+    , _lastState(nullptr)
+    , _lastDuty(0)
+    , _loggedSeen(0)
+    , _transitions(0)
+    , _dutyChanges(0)
+    , _logEntries(0)
+{
+}
+
+void MoaSimReport::attach() {
+    MoaSimKernel::instance().setSwitchHook(onSwitch, this);
+}
+
+void MoaSimReport::detach() {
+    MoaSimKernel::instance().setSwitchHook(nullptr, nullptr);
+}
+
+void MoaSimReport::onSwitch(void* context) {
+    static_cast<MoaSimReport*>(context)->sample();
+}
+
+void MoaSimReport::sample() {
+    uint64_t nowMs = MoaSimKernel::instance().nowUs() / 1000ULL;
+
+    const char* state = _stateMachine.getStateName();
+    if (_lastState == nullptr || strcmp(state, _lastState) != 0) {
+        if (_lastState != nullptr) {
+            _transitions++;
+        }
+        _lastState = state;
+        append(nowMs, "state %s", state);
+    }
+
+    uint32_t duty = _board.getEscDuty();
+    if (duty != _lastDuty) {
+        _lastDuty = duty;
+        _dutyChanges++;
+        append(nowMs, "duty %u", (unsigned)duty);
+    }
+
+    uint32_t logged = _flashLog.getLoggedCount();
+    if (logged != _loggedSeen) {
+        size_t available = _flashLog.getEntryCount();
+        size_t fresh = std::min<size_t>(logged - _loggedSeen, available);
+        _loggedSeen = logged;
+        for (size_t i = available - fresh; i < available; i++) {
+            MoaLogEntry entry;
+            if (_flashLog.readEntry(i, entry)) {
+                _logEntries++;
+                append(entry.timestamp, "log 0x%02X 0x%02X %d",
+                       (unsigned)entry.type, (unsigned)entry.code, (int)entry.value);
+            }
+        }
+    }
+}
+
+void MoaSimReport::append(uint64_t ms, const char* format, ...) {
+    char buffer[96];
+    int n = snprintf(buffer, sizeof(buffer), "%llu ", (unsigned long long)ms);
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer + n, sizeof(buffer) - n, format, args);
+    va_end(args);
+    _text += buffer;
+    _text += '\n';
+}
+
+const std::string& MoaSimReport::getText() const {
+    return _text;
+}
+
+uint32_t MoaSimReport::getTransitionCount() const {
+    return _transitions;
+}
+
+uint32_t MoaSimReport::getDutyChangeCount() const {
+    return _dutyChanges;
+}
+
+uint32_t MoaSimReport::getLogEntryCount() const {
+    return _logEntries;
+}
+
+bool MoaSimReport::diff(const std::string& expected, const std::string& actual, std::string& differences) {
+    std::istringstream left(expected);
+    std::istringstream right(actual);
+    std::string want;
+    std::string got;
+    int lineNumber = 0;
+    int mismatches = 0;
+    differences.clear();
+
+    while (true) {
+        bool hasWant = static_cast<bool>(std::getline(left, want));
+        bool hasGot = static_cast<bool>(std::getline(right, got));
+        if (!hasWant && !hasGot) {
+            break;
+        }
+        lineNumber++;
+        if (hasWant && hasGot && want == got) {
+            continue;
+        }
+        if (++mismatches > MOA_SIM_REPORT_DIFF_LINES) {
+            differences += "...\n";
+            break;
+        }
+        differences += "line " + std::to_string(lineNumber) + ":\n";
+        differences += "  - " + (hasWant ? want : std::string("<end>")) + "\n";
+        differences += "  + " + (hasGot ? got : std::string("<end>")) + "\n";
+    }
+    return mismatches == 0;
+}
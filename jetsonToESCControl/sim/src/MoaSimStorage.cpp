@@ -0,0 +1,193 @@
+/**
+ * @file MoaSimStorage.cpp
+ * @brief In-memory LittleFS and NVS of the sim env
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include <LittleFS.h>
+#include <Preferences.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// =============================================================================
+// LittleFS
+// =============================================================================
+
+fs::LittleFSFS LittleFS;
+
+static std::mutex fsMutex;
+static std::map<std::string, fs::FileData> fsFiles;
+
+namespace fs {
+
+File FS::open(const char* path, const char* mode) {
+    std::lock_guard<std::mutex> lock(fsMutex);
+    std::map<std::string, FileData>::iterator it = fsFiles.find(path);
+
+    if (mode[0] == 'r') {
+        return (it != fsFiles.end()) ? File(it->second, false, false) : File();
+    }
+    if (it == fsFiles.end()) {
+        it = fsFiles.insert(std::make_pair(std::string(path), std::make_shared<std::string>())).first;
+    } else if (mode[0] == 'w') {
+        it->second = std::make_shared<std::string>();   // Open handles keep the old contents
+    }
+    return File(it->second, true, mode[0] == 'a');
+}
+
+bool FS::exists(const char* path) {
+    std::lock_guard<std::mutex> lock(fsMutex);
+    return fsFiles.count(path) != 0;
+}
+
+bool FS::remove(const char* path) {
+    std::lock_guard<std::mutex> lock(fsMutex);
+    return fsFiles.erase(path) != 0;
+}
+
+} // namespace fs
+
+// =============================================================================
+// Preferences (NVS)
+// =============================================================================
+
+static std::mutex nvsMutex;
+static std::map<std::string, std::map<std::string, std::vector<uint8_t>>> nvsNamespaces;
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partitionLabel) {
+    (void)partitionLabel;
+    if (_open || name == nullptr || strlen(name) > 15) {
+        return false;
+    }
+    _name = name;
+    _readOnly = readOnly;
+    _open = true;
+    return true;
+}
+
+void Preferences::end() {
+    _open = false;
+}
+
+bool Preferences::clear() {
+    if (!_open || _readOnly) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    nvsNamespaces[_name].clear();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!_open || _readOnly) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    return nvsNamespaces[_name].erase(key) != 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    if (!_open) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    return nvsNamespaces[_name].count(key) != 0;
+}
+
+size_t Preferences::put(const char* key, const void* value, size_t length) {
+    if (!_open || _readOnly || key == nullptr || strlen(key) > 15) {
+        return 0;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(value);
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    nvsNamespaces[_name][key].assign(bytes, bytes + length);
+    return length;
+}
+
+bool Preferences::get(const char* key, void* value, size_t length) {
+    if (!_open) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    std::map<std::string, std::vector<uint8_t>>& entries = nvsNamespaces[_name];
+    std::map<std::string, std::vector<uint8_t>>::const_iterator it = entries.find(key);
+    if (it == entries.end() || it->second.size() != length) {
+        return false;
+    }
+    memcpy(value, it->second.data(), length);
+    return true;
+}
+
+size_t Preferences::putUChar(const char* key, uint8_t value) {
+    return put(key, &value, sizeof(value));
+}
+
+size_t Preferences::putUShort(const char* key, uint16_t value) {
+    return put(key, &value, sizeof(value));
+}
+
+size_t Preferences::putLong(const char* key, int32_t value) {
+    return put(key, &value, sizeof(value));
+}
+
+size_t Preferences::putULong(const char* key, uint32_t value) {
+    return put(key, &value, sizeof(value));
+}
+
+size_t Preferences::putFloat(const char* key, float value) {
+    return put(key, &value, sizeof(value));
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+    size_t length = strlen(value);
+    return (put(key, value, length) == length) ? length : 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+    return put(key, value, length);
+}
+
+uint8_t Preferences::getUChar(const char* key, uint8_t defaultValue) {
+    uint8_t value = defaultValue;
+    return get(key, &value, sizeof(value)) ? value : defaultValue;
+}
+
+uint16_t Preferences::getUShort(const char* key, uint16_t defaultValue) {
+    uint16_t value = defaultValue;
+    return get(key, &value, sizeof(value)) ? value : defaultValue;
+}
+
+int32_t Preferences::getLong(const char* key, int32_t defaultValue) {
+    int32_t value = defaultValue;
+    return get(key, &value, sizeof(value)) ? value : defaultValue;
+}
+
+uint32_t Preferences::getULong(const char* key, uint32_t defaultValue) {
+    uint32_t value = defaultValue;
+    return get(key, &value, sizeof(value)) ? value : defaultValue;
+}
+
+float Preferences::getFloat(const char* key, float defaultValue) {
+    float value = defaultValue;
+    return get(key, &value, sizeof(value)) ? value : defaultValue;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t length) {
+    return get(key, buffer, length) ? length : 0;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    if (!_open) {
+        return defaultValue;
+    }
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    std::map<std::string, std::vector<uint8_t>>& entries = nvsNamespaces[_name];
+    std::map<std::string, std::vector<uint8_t>>::const_iterator it = entries.find(key);
+    if (it == entries.end()) {
+        return defaultValue;
+    }
+    return String(std::string(it->second.begin(), it->second.end()));
+}
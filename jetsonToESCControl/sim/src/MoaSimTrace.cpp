@@ -0,0 +1,134 @@
+/**
+ * @file MoaSimTrace.cpp
+ * @brief Implementation of the MoaSimTrace class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaSimTrace.h"
+#include <stdlib.h>
+#include <sstream>
+#include "MoaSimBoard.h"
+
+static std::vector<std::string> splitFields(const std::string& line) {
+    std::vector<std::string> fields;
+    std::istringstream in(line);
+    std::string field;
+    while (std::getline(in, field, ',')) {
+        size_t first = field.find_first_not_of(" \t\r");
+        size_t last = field.find_last_not_of(" \t\r");
+        fields.push_back((first == std::string::npos) ? std::string() : field.substr(first, last - first + 1));
+    }
+    return fields;
+}
+
+static bool parseNumber(const std::string& text, double& value) {
+    char* end = nullptr;
+    value = strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0';
+}
+
+MoaSimTrace::MoaSimTrace()
+    : _next(0)
+    , _samples(0)
+    , _board(nullptr)
+{
+}
+
+bool MoaSimTrace::load(std::istream& in, std::string& error) {
+    _rows.clear();
+    _next = 0;
+    _samples = 0;
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        std::vector<std::string> fields = splitFields(line);
+        if (fields.empty() || (fields.size() == 1 && fields[0].empty())) {
+            continue;                                   // Blank line
+        }
+
+        Row row = {};
+        double ms;
+        if (fields.size() < 2 || !parseNumber(fields[1], ms) || ms < 0.0) {
+            error = "line " + std::to_string(lineNumber) + ": bad time";
+            return false;
+        }
+        row.atUs = static_cast<uint64_t>(ms * 1000.0 + 0.5);
+        if (!_rows.empty() && row.atUs < _rows.back().atUs) {
+            error = "line " + std::to_string(lineNumber) + ": rows out of order";
+            return false;
+        }
+
+        if (fields[0] == "s" && fields.size() == 5) {
+            double current, voltage, temperature;
+            if (!parseNumber(fields[2], current) || !parseNumber(fields[3], voltage)
+                || !parseNumber(fields[4], temperature)) {
+                error = "line " + std::to_string(lineNumber) + ": bad sample";
+                return false;
+            }
+            row.sample = true;
+            row.current = static_cast<float>(current);
+            row.voltage = static_cast<float>(voltage);
+            row.temperature = static_cast<float>(temperature);
+            _samples++;
+        } else if (fields[0] == "b" && fields.size() == 4) {
+            int pin = MoaSimBoard::buttonPin(fields[2]);
+            if (pin < 0 || (fields[3] != "down" && fields[3] != "up")) {
+                error = "line " + std::to_string(lineNumber) + ": bad button row";
+                return false;
+            }
+            row.sample = false;
+            row.mcpPin = static_cast<uint8_t>(pin);
+            row.pressed = (fields[3] == "down");
+        } else {
+            error = "line " + std::to_string(lineNumber) + ": unknown row '" + fields[0] + "'";
+            return false;
+        }
+        _rows.push_back(row);
+    }
+    return true;
+}
+
+void MoaSimTrace::play(MoaSimBoard& board) {
+    _board = &board;
+    _next = 0;
+    if (!_rows.empty()) {
+        board.schedule(_rows[0].atUs, [this]() { feed(); });
+    }
+}
+
+void MoaSimTrace::feed() {
+    uint64_t nowUs = _rows[_next].atUs;
+    while (_next < _rows.size() && _rows[_next].atUs == nowUs) {
+        const Row& row = _rows[_next++];
+        if (row.sample) {
+            _board->getPlant().setMeasured(row.current, row.voltage, row.temperature);
+        } else if (row.pressed) {
+            _board->pressButton(row.mcpPin);
+        } else {
+            _board->releaseButton(row.mcpPin);
+        }
+    }
+    if (_next < _rows.size()) {
+        _board->schedule(_rows[_next].atUs, [this]() { feed(); });
+    }
+}
+
+uint64_t MoaSimTrace::getEndUs() const {
+    uint64_t lastUs = _rows.empty() ? 0 : _rows.back().atUs;
+    return lastUs + MOA_SIM_TRACE_TAIL_MS * 1000ULL;
+}
+
+size_t MoaSimTrace::getSampleCount() const {
+    return _samples;
+}
+
+size_t MoaSimTrace::getButtonCount() const {
+    return _rows.size() - _samples;
+}
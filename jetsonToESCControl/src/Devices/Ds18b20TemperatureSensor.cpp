@@ -6,46 +6,89 @@
  */
 
 #include "Ds18b20TemperatureSensor.h"
+#include "StatsReading.h"
+#include "MoaFixedPoint.h"
 #include "esp_log.h"
 
 static const char* TAG = "Ds18b20Sensor";
 
 Ds18b20TemperatureSensor::Ds18b20TemperatureSensor(uint8_t pin)
-    : _oneWire(pin)
-    , _sensors(&_oneWire)
-    , _convState(ConvState::IDLE)
-    , _convRequestTime(0)
-    , _convDelayMs(750)
+    : _wire(pin)
+    , _probes(&_wire)
+    , _statsQueue(nullptr)
 {
 }
 
 void Ds18b20TemperatureSensor::begin() {
-    _sensors.begin();
-    _sensors.setWaitForConversion(false);
-    _convDelayMs = _sensors.millisToWaitForConversion();
-    ESP_LOGI(TAG, "DS18B20 begin, devices=%d, convMs=%d",
-             _sensors.getDeviceCount(), _convDelayMs);
+    uint8_t count = _probes.begin();
+    uint8_t found = _probes.getFoundCount();
+    ESP_LOGI(TAG, "DS18B20 begin, found=%d, bound=%d, parasite=%d, mode=%s",
+             found, count, _probes.isParasite() ? 1 : 0,
+             _probes.getMode() == MoaProbeMode::BROADCAST ? "broadcast" : "staggered");
+
+    for (uint8_t role = 0; role < TEMP_PROBE_MAX_COUNT; role++) {
+        const uint8_t* rom = _probes.getRom(role);
+        if (rom != nullptr) {
+            ESP_LOGI(TAG, "  %s: %02X%02X%02X%02X%02X%02X%02X%02X, %d bits", moaProbeRoleName(role),
+                     rom[0], rom[1], rom[2], rom[3], rom[4], rom[5], rom[6], rom[7],
+                     _probes.getResolution(role));
+        }
+        if (_probes.isMissing(role)) {
+            const uint8_t* want = _probes.getRoleRom(role);
+            ESP_LOGE(TAG, "  %s: configured probe %02X%02X%02X%02X%02X%02X%02X%02X NOT FOUND on the bus, no readings",
+                     moaProbeRoleName(role), want[0], want[1], want[2], want[3], want[4], want[5],
+                     want[6], want[7]);
+        }
+    }
+
+    for (uint8_t i = 0; i < found; i++) {
+        if (_probes.getFoundRole(i) < 0) {
+            const uint8_t* rom = _probes.getFoundRom(i);
+            ESP_LOGW(TAG, "  #%d %02X%02X%02X%02X%02X%02X%02X%02X has no role ('probes assign %d <role>')",
+                     i, rom[0], rom[1], rom[2], rom[3], rom[4], rom[5], rom[6], rom[7], i);
+        }
+    }
+    if (_probes.getRom(TEMP_PROBE_ESC) == nullptr) {
+        ESP_LOGE(TAG, "No ESC temperature probe bound: over-temperature protection has no input");
+    }
 }
 
 bool Ds18b20TemperatureSensor::readCelsius(float& outCelsius) {
-    switch (_convState) {
-        case ConvState::IDLE:
-            // Start a non-blocking conversion request
-            _sensors.requestTemperatures();
-            _convRequestTime = millis();
-            _convState = ConvState::WAITING;
-            return false;  // Not ready yet, come back next call
-
-        case ConvState::WAITING:
-            // Check if conversion time has elapsed
-            if ((millis() - _convRequestTime) < _convDelayMs) {
-                return false;  // Not ready yet
-            }
-            // Conversion done — read result and fall through
-            _convState = ConvState::IDLE;
-            break;
+    _probes.poll(millis());
+
+    int32_t centiC;
+    if (_probes.takeReading(TEMP_PROBE_MOTOR, &centiC)) {
+        pushStatsReading(STATS_TYPE_TEMP_MOTOR, centiC);
+    }
+    if (_probes.takeReading(TEMP_PROBE_BATTERY, &centiC)) {
+        pushStatsReading(STATS_TYPE_TEMP_BATTERY, centiC);
+    }
+    if (!_probes.takeReading(TEMP_PROBE_ESC, &centiC)) {
+        return false;  // Not ready yet, come back next call
     }
 
-    outCelsius = _sensors.getTempCByIndex(0);
+    outCelsius = centiC / 100.0f;
     return true;
 }
+
+void Ds18b20TemperatureSensor::setStatsQueue(QueueHandle_t statsQueue) {
+    _statsQueue = statsQueue;
+}
+
+MoaDs18b20Bus& Ds18b20TemperatureSensor::getBus() {
+    return _probes;
+}
+
+void Ds18b20TemperatureSensor::pushStatsReading(uint8_t statsType, int32_t centiC) {
+    // A lost probe is visible in CLI 'probes', not as -127 degC in the stats
+    if (_statsQueue == nullptr || centiC == TEMP_PROBE_DISCONNECTED_C * 100) {
+        return;
+    }
+
+    StatsReading reading;
+    reading.statsType = statsType;
+    reading.value = moaDivRound(centiC, 10);
+    reading.timestamp = millis();
+
+    xQueueSend(_statsQueue, &reading, 0);  // Don't block if queue is full
+}
@@ -7,6 +7,7 @@
 
 #include "ESCController.h"
 #include "esp_log.h"
+#include "MoaLatencyTrace.h"
 
 static const char* TAG = "ESC";
 
@@ -14,144 +15,210 @@ ESCController::ESCController(uint8_t pin, uint8_t channel, uint16_t frequency){
     _pin = pin;
     _channel = channel;
     _frequency = frequency;
-    _resolution = 10;
+    _resolution = ESC_PWM_RESOLUTION;
     uint32_t periodUs = 1000000UL / _frequency;  // 20000µs at 50Hz
-    uint16_t maxDuty = (1 << _resolution) - 1;    // 1023 for 10-bit
-    _minThrottle = (uint16_t)((uint32_t)ESC_PULSE_MIN_US * maxDuty / periodUs);  // ~51 for 1ms
-    _maxThrottle = (uint16_t)((uint32_t)ESC_PULSE_MAX_US * maxDuty / periodUs);  // ~102 for 2ms
-    _currentThrottle = _minThrottle;
-    _targetThrottle = _minThrottle;
-    _throttle = _minThrottle;
-    _rampTime = 10;
-    _rampStep = 1;
-    _ramping = false;
+    uint32_t maxCount = (1UL << _resolution) - 1; // 16383 for 14-bit
+    _minDuty = (uint16_t)((uint32_t)ESC_PULSE_MIN_US * maxCount / periodUs);  // ~819 for 1ms
+    _maxDuty = (uint16_t)((uint32_t)ESC_PULSE_MAX_US * maxCount / periodUs);  // ~1638 for 2ms
+    _ramp.reset(_minDuty);
     _rampRate = ESC_RAMP_RATE;
-    _tickPeriodMs = TASK_IO_PERIOD_MS;
+    _rampCurvature = ESC_RAMP_CURVATURE;
+    for(uint8_t i = 0; i < MOA_RAMP_SHAPE_COUNT; i++){
+        _profiles[i].build(static_cast<MoaRampShape>(i), _rampCurvature);
+    }
+    _rampTimer = nullptr;
+    _mux = portMUX_INITIALIZER_UNLOCKED;
+    _tripped = false;
 }
 
 void ESCController::begin(){
     ledcSetup(_channel, _frequency, _resolution);
     ledcAttachPin(_pin, _channel);
-    ESP_LOGI(TAG, "ESC begin (pin=%d, ch=%d, freq=%d, res=%d)", _pin, _channel, _frequency, _resolution);
+
+    esp_timer_create_args_t args = {};
+    args.callback = rampTimerCallback;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "EscRamp";
+    if(esp_timer_create(&args, &_rampTimer) != ESP_OK){
+        _rampTimer = nullptr;
+        ESP_LOGE(TAG, "Failed to create ramp timer, throttle changes will not ramp");
+    }
+
+    ESP_LOGI(TAG, "ESC begin (pin=%d, ch=%d, freq=%d, res=%d, duty=%d-%d)", _pin, _channel, _frequency, _resolution, _minDuty, _maxDuty);
     stop();
 }
 
-void ESCController::writeThrottle(){
-    ESP_LOGD(TAG, "ESC writeThrottle (duty=%d, min=%d, max=%d)", _throttle, _minThrottle, _maxThrottle);
-    ledcWrite(_channel, _throttle);
+void ESCController::writeDuty(uint16_t duty){
+    ESP_LOGD(TAG, "ESC writeDuty (duty=%d, min=%d, max=%d)", duty, _minDuty, _maxDuty);
+    ledcWrite(_channel, _tripped ? _minDuty : duty);
+    MOA_LATENCY_MARK(MOA_HOP_PWM);
+    // A trip may have preempted the write above; make sure it wins
+    if(_tripped){
+        ledcWrite(_channel, _minDuty);
+    }
 }
 
 void ESCController::stop(){
     ESP_LOGI(TAG, "ESC stop");
-    _ramping = false;
-    setThrottle(_minThrottle);
+    setThrottle(0);
 }
 
-void ESCController::updateThrottle(){
-    if(!_ramping){
-        return;
+void ESCController::trip(){
+    _tripped = true;
+    ledcWrite(_channel, _minDuty);
+    MOA_LATENCY_MARK_FROM(MOA_HOP_ADC_DRAIN, MOA_HOP_PWM);
+    portENTER_CRITICAL(&_mux);
+    _ramp.reset(_minDuty);      // The ramp timer stops itself on its next tick
+    portEXIT_CRITICAL(&_mux);
+    ESP_LOGW(TAG, "ESC protection trip");
+}
+
+void ESCController::clearTrip(){
+    if(_tripped){
+        ESP_LOGI(TAG, "ESC protection trip cleared");
     }
+    _tripped = false;
+}
 
-    if(_rampStep > 0){
-        _currentThrottle += _rampStep;
-        if(_currentThrottle >= _targetThrottle){
-            _currentThrottle = _targetThrottle;
-            _ramping = false;
-            ESP_LOGI(TAG, "Ramp complete (throttle=%d)", _currentThrottle);
+bool ESCController::isTripped() const{
+    return _tripped;
+}
+
+void ESCController::rampTimerCallback(void* arg){
+    static_cast<ESCController*>(arg)->rampTick();
+}
+
+void ESCController::rampTick(){
+    portENTER_CRITICAL(&_mux);
+    bool changed = _ramp.step();
+    bool active = _ramp.isActive();
+    uint16_t duty = _ramp.getDuty();
+    portEXIT_CRITICAL(&_mux);
+
+    if(changed){
+        writeDuty(duty);
+    }
+    if(!active){
+        if(_rampTimer != nullptr){
+            esp_timer_stop(_rampTimer);
         }
-    } else if(_rampStep < 0){
-        _currentThrottle += _rampStep;
-        if(_currentThrottle <= _targetThrottle){
-            _currentThrottle = _targetThrottle;
-            _ramping = false;
-            ESP_LOGI(TAG, "Ramp complete (throttle=%d)", _currentThrottle);
+        if(changed){
+            ESP_LOGI(TAG, "Ramp complete (duty=%d)", duty);
         }
-    } else {
-        _currentThrottle = _targetThrottle;
-        _ramping = false;
     }
-
-    _throttle = _currentThrottle;
-    writeThrottle();
 }
 
 bool ESCController::isRamping() const{
-    return _ramping;
+    return _ramp.isActive();
+}
+
+bool ESCController::isStopped() const{
+    return !_ramp.isActive() && _ramp.getDuty() <= _minDuty;
+}
+
+uint16_t ESCController::toDuty(uint16_t throttle) const{
+    uint32_t duty = (uint32_t)throttle << (ESC_PWM_RESOLUTION - ESC_THROTTLE_BITS);
+    if(duty < _minDuty){
+        return _minDuty;
+    }
+    if(duty > _maxDuty){
+        return _maxDuty;
+    }
+    return (uint16_t)duty;
 }
 
 void ESCController::setThrottle(uint16_t throttle){
-    if(throttle < _minThrottle){
-        _throttle = _minThrottle;
-    } else if(throttle > _maxThrottle){
-        _throttle = _maxThrottle;
-    } else {
-        _throttle = throttle;
+    uint16_t duty = toDuty(throttle);
+    if(_rampTimer != nullptr){
+        esp_timer_stop(_rampTimer);
     }
-    _currentThrottle = _throttle;
-    writeThrottle();
+    portENTER_CRITICAL(&_mux);
+    _ramp.reset(duty);
+    portEXIT_CRITICAL(&_mux);
+    writeDuty(duty);
 }
 
 uint16_t ESCController::getCurrentThrottle() const{
-    return _currentThrottle;
+    const uint8_t shift = ESC_PWM_RESOLUTION - ESC_THROTTLE_BITS;
+    return (uint16_t)((_ramp.getDuty() + (1U << (shift - 1))) >> shift);
 }
 
-void ESCController::setThrottlePercent(uint8_t percent){
+uint16_t ESCController::getCurrentDuty() const{
+    return _ramp.getDuty();
+}
+
+void ESCController::setThrottlePercent(uint8_t percent, MoaRampShape shape){
     if (percent > 100) {
         percent = 100;
     }
-    uint16_t range = _maxThrottle - _minThrottle;
-    uint16_t targetDuty = _minThrottle + (uint16_t)((uint32_t)percent * range / 100);
-    float currentPercent = (float)(_currentThrottle - _minThrottle) * 100.0f / range;
-    float deltaPercent = abs((float)percent - currentPercent);
-    uint16_t rampSteps = (uint16_t)(deltaPercent * 1000.0f / (_rampRate * _tickPeriodMs));
-    if (rampSteps < 1) rampSteps = 1;
+    uint16_t targetDuty = _minDuty + (uint16_t)((uint32_t)percent * (_maxDuty - _minDuty) / 100);
+    uint16_t rampSteps = MoaEscRamp::stepsFor(_ramp.getDuty(), targetDuty, _minDuty, _maxDuty, _rampRate, ESC_RAMP_TICK_US);
 
-    ESP_LOGI(TAG, "Throttle ramp to %d%% (duty=%d, range=%d-%d, steps=%d)", percent, targetDuty, _minThrottle, _maxThrottle, rampSteps);
-    setRampThrottle(rampSteps, targetDuty);
+    ESP_LOGI(TAG, "Throttle ramp to %d%% (duty=%d, range=%d-%d, steps=%d, %s)", percent, targetDuty, _minDuty, _maxDuty, rampSteps, MoaRampProfile::shapeName(shape));
+    startRamp(targetDuty, rampSteps, shape);
 }
 
-void ESCController::setThrottleDuty(uint16_t duty){
-    if (duty < _minThrottle) duty = _minThrottle;
-    if (duty > _maxThrottle) duty = _maxThrottle;
-
-    uint16_t range = _maxThrottle - _minThrottle;
-    float currentPercent = (float)(_currentThrottle - _minThrottle) * 100.0f / range;
-    float targetPercent  = (float)(duty - _minThrottle) * 100.0f / range;
-    float deltaPercent   = abs(targetPercent - currentPercent);
-    uint16_t rampSteps   = (uint16_t)(deltaPercent * 1000.0f / (_rampRate * _tickPeriodMs));
-    if (rampSteps < 1) rampSteps = 1;
+void ESCController::setThrottleDuty(uint16_t duty, MoaRampShape shape){
+    MOA_LATENCY_MARK(MOA_HOP_SET_DUTY);
+    uint16_t targetDuty = toDuty(duty);
+    uint16_t rampSteps = MoaEscRamp::stepsFor(_ramp.getDuty(), targetDuty, _minDuty, _maxDuty, _rampRate, ESC_RAMP_TICK_US);
 
-    ESP_LOGI(TAG, "Throttle ramp to duty=%d (range=%d-%d, steps=%d)", duty, _minThrottle, _maxThrottle, rampSteps);
-    setRampThrottle(rampSteps, duty);
+    ESP_LOGI(TAG, "Throttle ramp to duty=%d (range=%d-%d, steps=%d, %s)", targetDuty, _minDuty, _maxDuty, rampSteps, MoaRampProfile::shapeName(shape));
+    startRamp(targetDuty, rampSteps, shape);
 }
 
 void ESCController::setRampRate(float ratePercentPerSec){
     _rampRate = (ratePercentPerSec > 0) ? ratePercentPerSec : 1.0f;
 }
 
-void ESCController::setTickPeriod(uint16_t periodMs){
-    _tickPeriodMs = (periodMs > 0) ? periodMs : 1;
+void ESCController::setRampCurvature(float curvature){
+    if(curvature == _rampCurvature){
+        return;
+    }
+    _rampCurvature = curvature;
+
+    // Tabulate outside the lock; a running EXPO ramp switches curve between two steps
+    MoaRampProfile expo;
+    expo.build(MoaRampShape::EXPO, curvature);
+    portENTER_CRITICAL(&_mux);
+    _profiles[static_cast<uint8_t>(MoaRampShape::EXPO)] = expo;
+    portEXIT_CRITICAL(&_mux);
 }
 
 void ESCController::setRampThrottle(uint16_t rampTime, uint16_t targetThrottle){
-    ESP_LOGI(TAG, "Ramp set: target=%d, time=%d, current=%d", targetThrottle, rampTime, _currentThrottle);
-    _targetThrottle = targetThrottle;
-    
-    if(_targetThrottle > _maxThrottle){
-        _targetThrottle = _maxThrottle;
+    startRamp(toDuty(targetThrottle), rampTime);
+}
+
+void ESCController::startRamp(uint16_t targetDuty, uint16_t steps, MoaRampShape shape){
+    ESP_LOGI(TAG, "Ramp set: target=%d, steps=%d, current=%d", targetDuty, steps, _ramp.getDuty());
+    uint8_t profile = static_cast<uint8_t>(shape);
+    if(profile >= MOA_RAMP_SHAPE_COUNT){
+        profile = static_cast<uint8_t>(MoaRampShape::LINEAR);
+    }
+
+    // Restart the step clock from this command: steps stay ESC_RAMP_TICK_US apart
+    if(_rampTimer != nullptr){
+        esp_timer_stop(_rampTimer);
     }
-    
-    if(_targetThrottle == _currentThrottle){
-        _ramping = false;
+    portENTER_CRITICAL(&_mux);
+    bool started = _ramp.start(targetDuty, steps, &_profiles[profile]);
+    portEXIT_CRITICAL(&_mux);
+
+    if(!started){
+        MOA_LATENCY_RELEASE(MOA_HOP_ANY, MOA_HOP_PWM);     // Nothing to write
         return;
     }
-    
-    _rampTime = (rampTime > 0) ? rampTime : 1;
-    _rampStep = (int16_t)(_targetThrottle - _currentThrottle) / (int16_t)_rampTime;
-    
-    if(_rampStep == 0){
-        _rampStep = (_targetThrottle > _currentThrottle) ? 1 : -1;
+
+    rampTick();
+    if(_ramp.isActive()){
+        if(_rampTimer == nullptr || esp_timer_start_periodic(_rampTimer, ESC_RAMP_TICK_US) != ESP_OK){
+            // No step clock: go straight to the target rather than stall mid-ramp
+            ESP_LOGW(TAG, "Ramp timer unavailable, jumping to duty=%d", targetDuty);
+            portENTER_CRITICAL(&_mux);
+            _ramp.reset(targetDuty);
+            portEXIT_CRITICAL(&_mux);
+            writeDuty(targetDuty);
+        }
     }
-    
-    _ramping = true;
-}
\ No newline at end of file
+}
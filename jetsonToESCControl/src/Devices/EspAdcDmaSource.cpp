@@ -0,0 +1,149 @@
+/**
+ * @file EspAdcDmaSource.cpp
+ * @brief Implementation of EspAdcDmaSource (ESP-IDF 4.4 adc_digi API)
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "EspAdcDmaSource.h"
+#include "driver/adc.h"
+#include "esp_log.h"
+
+static const char* TAG = "AdcDma";
+
+EspAdcDmaSource::EspAdcDmaSource()
+    : _running(false)
+    , _overflows(0)
+{
+    for (uint8_t i = 0; i < 8; i++) {
+        _channelToPin[i] = -1;
+    }
+}
+
+EspAdcDmaSource::~EspAdcDmaSource() {
+    stop();
+}
+
+bool EspAdcDmaSource::begin(const uint8_t* pins, uint8_t numPins, uint32_t sampleRateHz) {
+    if (_running) {
+        stop();
+    }
+    if (numPins == 0 || numPins > MAX_PINS) {
+        ESP_LOGE(TAG, "Invalid pin count %d", numPins);
+        return false;
+    }
+
+    static adc_digi_pattern_config_t pattern[SOC_ADC_PATT_LEN_MAX];
+    uint16_t adc1Mask = 0;
+
+    for (uint8_t i = 0; i < 8; i++) {
+        _channelToPin[i] = -1;
+    }
+
+    for (uint8_t i = 0; i < numPins; i++) {
+        int8_t channel = digitalPinToAnalogChannel(pins[i]);
+        if (channel < 0 || channel >= 8) {
+            // ADC2 channels are encoded as 10+ by the Arduino core
+            ESP_LOGE(TAG, "Pin %d is not an ADC1 pin", pins[i]);
+            return false;
+        }
+        adc1Mask |= (1 << channel);
+        _channelToPin[channel] = static_cast<int8_t>(pins[i]);
+
+        pattern[i].atten = ADC_ATTEN_DB_11;
+        pattern[i].channel = channel;
+        pattern[i].unit = 0;  // ADC1
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+
+    adc_digi_init_config_t initConfig = {};
+    initConfig.max_store_buf_size = ESP_ADC_DMA_STORE_BYTES;
+    initConfig.conv_num_each_intr = ESP_ADC_DMA_FRAME_BYTES;
+    initConfig.adc1_chan_mask = adc1Mask;
+    initConfig.adc2_chan_mask = 0;
+
+    esp_err_t err = adc_digi_initialize(&initConfig);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "adc_digi_initialize failed: %s", esp_err_to_name(err));
+        return false;
+    }
+
+    adc_digi_configuration_t digiConfig = {};
+    digiConfig.conv_limit_en = false;
+    digiConfig.conv_limit_num = 250;
+    digiConfig.pattern_num = numPins;
+    digiConfig.adc_pattern = pattern;
+    digiConfig.sample_freq_hz = sampleRateHz;
+    digiConfig.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    digiConfig.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+
+    err = adc_digi_controller_configure(&digiConfig);
+    if (err == ESP_OK) {
+        err = adc_digi_start();
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "ADC continuous start failed: %s", esp_err_to_name(err));
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    _overflows = 0;
+    _running = true;
+    ESP_LOGI(TAG, "ADC continuous mode started (pins=%d, rate=%luHz, mask=0x%02x)",
+             numPins, sampleRateHz, adc1Mask);
+    return true;
+}
+
+void EspAdcDmaSource::stop() {
+    if (!_running) {
+        return;
+    }
+    adc_digi_stop();
+    adc_digi_deinitialize();
+    _running = false;
+    ESP_LOGI(TAG, "ADC continuous mode stopped");
+}
+
+size_t EspAdcDmaSource::read(MoaAdcRawSample* out, size_t maxSamples) {
+    if (!_running || maxSamples == 0) {
+        return 0;
+    }
+
+    uint8_t buffer[ESP_ADC_DMA_READ_BYTES];
+    uint32_t maxBytes = maxSamples * SOC_ADC_DIGI_RESULT_BYTES;
+    if (maxBytes > sizeof(buffer)) {
+        maxBytes = sizeof(buffer);
+    }
+
+    uint32_t length = 0;
+    esp_err_t err = adc_digi_read_bytes(buffer, maxBytes, &length, 0);  // Never block
+    if (err == ESP_ERR_TIMEOUT) {
+        return 0;
+    }
+    if (err == ESP_ERR_INVALID_STATE) {
+        // Driver store overflowed since the last read; data returned is still valid
+        _overflows++;
+    } else if (err != ESP_OK) {
+        return 0;
+    }
+
+    size_t count = 0;
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= length; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        const adc_digi_output_data_t* result = reinterpret_cast<const adc_digi_output_data_t*>(&buffer[i]);
+        if (result->type2.unit != 0 || result->type2.channel >= 8) {
+            continue;
+        }
+        int8_t pin = _channelToPin[result->type2.channel];
+        if (pin < 0) {
+            continue;
+        }
+        out[count].pin = static_cast<uint8_t>(pin);
+        out[count].raw = static_cast<uint16_t>(result->type2.data);
+        count++;
+    }
+    return count;
+}
+
+uint32_t EspAdcDmaSource::getOverflowCount() const {
+    return _overflows;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file GpioOneWireBus.cpp
+ * @brief Implementation of the GpioOneWireBus class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "GpioOneWireBus.h"
+
+GpioOneWireBus::GpioOneWireBus(uint8_t pin)
+    : _oneWire(pin)
+{
+}
+
+void GpioOneWireBus::resetSearch() {
+    _oneWire.reset_search();
+}
+
+bool GpioOneWireBus::search(uint8_t rom[ONEWIRE_ROM_BYTES]) {
+    return _oneWire.search(rom);
+}
+
+bool GpioOneWireBus::transaction(const uint8_t* rom, uint8_t command,
+                                 const uint8_t* tx, size_t txLength,
+                                 uint8_t* rx, size_t rxLength, bool strongPullup) {
+    if (_oneWire.reset() == 0) {
+        return false;                               // No presence pulse
+    }
+    if (rom != nullptr) {
+        _oneWire.select(rom);
+    } else {
+        _oneWire.skip();
+    }
+    bool lastIsCommand = (txLength == 0 && rxLength == 0);
+    _oneWire.write(command, (strongPullup && lastIsCommand) ? 1 : 0);
+    if (txLength > 0) {
+        _oneWire.write_bytes(tx, static_cast<uint16_t>(txLength), strongPullup && rxLength == 0);
+    }
+    if (rxLength > 0) {
+        _oneWire.read_bytes(rx, static_cast<uint16_t>(rxLength));
+    }
+    return true;
+}
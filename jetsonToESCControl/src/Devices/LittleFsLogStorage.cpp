@@ -0,0 +1,95 @@
+/**
+ * @file LittleFsLogStorage.cpp
+ * @brief Implementation of the LittleFsLogStorage class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "LittleFsLogStorage.h"
+#include <LittleFS.h>
+#include "esp_log.h"
+
+static const char* TAG = "LogStorage";
+
+LittleFsLogStorage::LittleFsLogStorage()
+    : _mounted(false)
+{
+}
+
+bool LittleFsLogStorage::begin() {
+    if (_mounted) {
+        return true;
+    }
+    if (!LittleFS.begin(true)) {  // true = format if mount fails
+        ESP_LOGE(TAG, "LittleFS mount failed!");
+        return false;
+    }
+    ESP_LOGD(TAG, "LittleFS mounted");
+    _mounted = true;
+    return true;
+}
+
+int32_t LittleFsLogStorage::size(const char* path) {
+    if (!_mounted || !LittleFS.exists(path)) {
+        return -1;
+    }
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        return -1;
+    }
+    int32_t bytes = static_cast<int32_t>(file.size());
+    file.close();
+    return bytes;
+}
+
+size_t LittleFsLogStorage::read(const char* path, uint32_t offset, uint8_t* buffer, size_t length) {
+    if (!_mounted) {
+        return 0;
+    }
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        return 0;
+    }
+    size_t bytes = 0;
+    if (file.seek(offset)) {
+        bytes = file.read(buffer, length);
+    }
+    file.close();
+    return bytes;
+}
+
+size_t LittleFsLogStorage::append(const char* path, const uint8_t* data, size_t length) {
+    if (!_mounted) {
+        return 0;
+    }
+    File file = LittleFS.open(path, "a");
+    if (!file) {
+        return 0;
+    }
+    size_t bytes = file.write(data, length);
+    file.close();
+    return bytes;
+}
+
+bool LittleFsLogStorage::create(const char* path, const uint8_t* data, size_t length) {
+    if (!_mounted) {
+        return false;
+    }
+    File file = LittleFS.open(path, "w");
+    if (!file) {
+        return false;
+    }
+    size_t bytes = file.write(data, length);
+    file.close();
+    return bytes == length;
+}
+
+bool LittleFsLogStorage::remove(const char* path) {
+    if (!_mounted) {
+        return false;
+    }
+    if (!LittleFS.exists(path)) {
+        return true;
+    }
+    return LittleFS.remove(path);
+}
@@ -7,10 +7,11 @@
 
 #include "MoaBattControl.h"
 #include "esp_log.h"
+#include "MoaLatencyTrace.h"
 
 static const char* TAG = "Batt";
 
-MoaBattControl::MoaBattControl(QueueHandle_t eventQueue, uint8_t adcPin,
+MoaBattControl::MoaBattControl(MoaEventChannel* eventQueue, uint8_t adcPin,
                                uint8_t numSamples)
     : _eventQueue(eventQueue)
     , _statsQueue(nullptr)
@@ -22,28 +23,32 @@ MoaBattControl::MoaBattControl(QueueHandle_t eventQueue, uint8_t adcPin,
     , _stopThreshold(3.0f)
     , _highThreshold(4.0f)
     , _hysteresis(0.1f)
+    , _scale()
+    , _lowMv(0)
+    , _stopMv(0)
+    , _highMv(0)
+    , _hysteresisMv(0)
     , _rawAdc(0)
-    , _currentVoltage(0.0f)
+    , _currentMv(0)
     , _level(MoaBattLevel::BATT_MEDIUM)
-    , _samples(nullptr)
-    , _numSamples(0)
-    , _sampleIndex(0)
-    , _sampleCount(0)
-    , _averagedVoltage(0.0f)
+    , _filter(numSamples)
+    , _averagedMv(0)
     , _updateCount(0)
+    , _adcSampler(nullptr)
+    , _adcSlot(0)
     , _lowConfirmMs(MOA_BATT_LOW_CONFIRM_MS)
     , _stopConfirmMs(MOA_BATT_STOP_CONFIRM_MS)
     , _belowLowSinceMs(UINT32_MAX)
     , _belowStopSinceMs(UINT32_MAX)
+    , _resistance()
+    , _compensate(BATT_COMPENSATION_DEFAULT != 0)
+    , _loadMa(0)
+    , _loadFilter(numSamples)
+    , _averagedLoadMa(0)
+    , _openCircuitMv(0)
 {
-    setNumSamples(numSamples);
-}
-
-MoaBattControl::~MoaBattControl() {
-    if (_samples != nullptr) {
-        delete[] _samples;
-        _samples = nullptr;
-    }
+    updateScale();
+    updateThresholds();
 }
 
 void MoaBattControl::begin() {
@@ -53,11 +58,42 @@ void MoaBattControl::begin() {
 }
 
 void MoaBattControl::update() {
-    _rawAdc = analogRead(_adcPin);
-    _currentVoltage = adcToVoltage(_rawAdc);
-    
-    // Add sample to circular buffer and update average
-    addSample(_currentVoltage);
+    uint16_t block[MOA_ADC_BLOCK_CAPACITY];
+    size_t count;
+
+    if (_adcSampler != nullptr) {
+        // Continuous mode: consume everything decimated since the last tick
+        count = _adcSampler->takeBlock(_adcSlot, block, MOA_ADC_BLOCK_CAPACITY);
+        if (count == 0) {
+            return;  // No new data yet
+        }
+    } else {
+        block[0] = analogRead(_adcPin);
+        count = 1;
+    }
+
+    processBlock(block, count);
+}
+
+void MoaBattControl::processBlock(const uint16_t* rawSamples, size_t count) {
+    if (rawSamples == nullptr || count == 0) {
+        return;
+    }
+
+    // Feed every sample of the block through the moving-window filter
+    // (integer only: the calibration is already folded into _scale)
+    for (size_t i = 0; i < count; i++) {
+        _rawAdc = rawSamples[i];
+        _currentMv = _scale.apply(_rawAdc);
+        addSample(_currentMv);
+        _loadFilter.push(_loadMa);  // Same window as the voltage
+    }
+    _averagedLoadMa = _loadFilter.average();
+
+    // Learn R from throttle steps; the levels below see through the sag
+    _resistance.update(_averagedMv, _averagedLoadMa, millis());
+    _openCircuitMv = _resistance.openCircuitMv(_averagedMv, _averagedLoadMa);
+    int32_t levelMv = _compensate.load(std::memory_order_relaxed) ? _openCircuitMv : _averagedMv;
     
     // Periodic log (1 in 100 readings, ~5s at 50ms task period)
     if (++_updateCount % 100 == 0) {
@@ -65,9 +101,9 @@ void MoaBattControl::update() {
             (_level == MoaBattLevel::BATT_STOP) ? "STOP" :
             (_level == MoaBattLevel::BATT_LOW) ? "LOW" :
             (_level == MoaBattLevel::BATT_MEDIUM) ? "MED" : "HIGH";
-        ESP_LOGI(TAG, "V=%.3fV avg=%.3fV raw=%d level=%s",
-                 _currentVoltage, _averagedVoltage, _rawAdc,
-                 levelStr);
+        ESP_LOGI(TAG, "V=%.3fV avg=%.3fV ocv=%.3fV R=%lumOhm raw=%d level=%s",
+                 getCurrentVoltage(), getAveragedVoltage(), _openCircuitMv / 1000.0f,
+                 (unsigned long)_resistance.getResistanceMilliohm(), _rawAdc, levelStr);
     }
     
     // Push stats reading to telemetry queue
@@ -79,12 +115,12 @@ void MoaBattControl::update() {
     }
     
     // Calculate thresholds with hysteresis based on current state
-    float stopThreshUp = _stopThreshold + _hysteresis;
-    float stopThreshDown = _stopThreshold;
-    float lowThreshUp = _lowThreshold + _hysteresis;
-    float lowThreshDown = _lowThreshold;
-    float highThreshUp = _highThreshold;
-    float highThreshDown = _highThreshold - _hysteresis;
+    int32_t stopThreshUp = _stopMv + _hysteresisMv;
+    int32_t stopThreshDown = _stopMv;
+    int32_t lowThreshUp = _lowMv + _hysteresisMv;
+    int32_t lowThreshDown = _lowMv;
+    int32_t highThreshUp = _highMv;
+    int32_t highThreshDown = _highMv - _hysteresisMv;
     uint32_t nowMs = millis();
     
     // Check for state transitions and push events
@@ -93,7 +129,7 @@ void MoaBattControl::update() {
     switch (_level) {
         case MoaBattLevel::BATT_STOP:
             // From STOP, can only go to LOW (crossing up above stop threshold)
-            if (_averagedVoltage >= stopThreshUp) {
+            if (levelMv >= stopThreshUp) {
                 _level = MoaBattLevel::BATT_LOW;
             }
             _belowStopSinceMs = UINT32_MAX;
@@ -102,11 +138,11 @@ void MoaBattControl::update() {
 
         case MoaBattLevel::BATT_LOW:
             // From LOW, can go to STOP or MEDIUM
-            if (isBelowThresholdForDuration(_averagedVoltage, stopThreshDown,
+            if (isBelowThresholdForDuration(levelMv, stopThreshDown,
                                             _stopConfirmMs, nowMs,
                                             _belowStopSinceMs)) {
                 _level = MoaBattLevel::BATT_STOP;
-            } else if (_averagedVoltage >= lowThreshUp) {
+            } else if (levelMv >= lowThreshUp) {
                 _level = MoaBattLevel::BATT_MEDIUM;
                 _belowStopSinceMs = UINT32_MAX;
             }
@@ -115,11 +151,11 @@ void MoaBattControl::update() {
             
         case MoaBattLevel::BATT_MEDIUM:
             // From MEDIUM, can go to LOW or HIGH
-            if (isBelowThresholdForDuration(_averagedVoltage, lowThreshDown,
+            if (isBelowThresholdForDuration(levelMv, lowThreshDown,
                                             _lowConfirmMs, nowMs,
                                             _belowLowSinceMs)) {
                 _level = MoaBattLevel::BATT_LOW;
-            } else if (_averagedVoltage >= highThreshUp) {
+            } else if (levelMv >= highThreshUp) {
                 _level = MoaBattLevel::BATT_HIGH;
                 _belowLowSinceMs = UINT32_MAX;
             }
@@ -128,7 +164,7 @@ void MoaBattControl::update() {
             
         case MoaBattLevel::BATT_HIGH:
             // From HIGH, can only go to MEDIUM (crossing down below high threshold)
-            if (_averagedVoltage <= highThreshDown) {
+            if (levelMv <= highThreshDown) {
                 _level = MoaBattLevel::BATT_MEDIUM;
             }
             _belowStopSinceMs = UINT32_MAX;
@@ -140,29 +176,29 @@ void MoaBattControl::update() {
     if (_level != previousLevel) {
         switch (_level) {
             case MoaBattLevel::BATT_STOP:
-                ESP_LOGW(TAG, "Level -> STOP (avg=%.3fV, threshold=%.3fV)", _averagedVoltage, _stopThreshold);
+                ESP_LOGW(TAG, "Level -> STOP (avg=%.3fV, ocv=%.3fV, threshold=%.3fV)", getAveragedVoltage(), _openCircuitMv / 1000.0f, _stopThreshold);
                 pushBattEvent(COMMAND_BATT_LEVEL_STOP);
                 break;
             case MoaBattLevel::BATT_LOW:
-                ESP_LOGW(TAG, "Level -> LOW (avg=%.3fV, threshold=%.3fV)", _averagedVoltage, _lowThreshold);
+                ESP_LOGW(TAG, "Level -> LOW (avg=%.3fV, ocv=%.3fV, threshold=%.3fV)", getAveragedVoltage(), _openCircuitMv / 1000.0f, _lowThreshold);
                 pushBattEvent(COMMAND_BATT_LEVEL_LOW);
                 break;
             case MoaBattLevel::BATT_MEDIUM:
-                ESP_LOGI(TAG, "Level -> MEDIUM (avg=%.3fV)", _averagedVoltage);
+                ESP_LOGI(TAG, "Level -> MEDIUM (avg=%.3fV)", getAveragedVoltage());
                 pushBattEvent(COMMAND_BATT_LEVEL_MEDIUM);
                 break;
             case MoaBattLevel::BATT_HIGH:
-                ESP_LOGI(TAG, "Level -> HIGH (avg=%.3fV)", _averagedVoltage);
+                ESP_LOGI(TAG, "Level -> HIGH (avg=%.3fV)", getAveragedVoltage());
                 pushBattEvent(COMMAND_BATT_LEVEL_HIGH);
                 break;
         }
     }
 }
 
-bool MoaBattControl::isBelowThresholdForDuration(float voltage, float threshold,
+bool MoaBattControl::isBelowThresholdForDuration(int32_t voltageMv, int32_t thresholdMv,
                                                  uint32_t confirmMs, uint32_t nowMs,
                                                  uint32_t& sinceMs) {
-    if (voltage > threshold) {
+    if (voltageMv > thresholdMv) {
         sinceMs = UINT32_MAX;
         return false;
     }
@@ -177,6 +213,7 @@ bool MoaBattControl::isBelowThresholdForDuration(float voltage, float threshold,
 
 void MoaBattControl::setDividerRatio(float ratio) {
     _dividerRatio = (ratio >= 1.0f) ? ratio : 1.0f;
+    updateScale();
 }
 
 float MoaBattControl::getDividerRatio() const {
@@ -185,6 +222,7 @@ float MoaBattControl::getDividerRatio() const {
 
 void MoaBattControl::setReferenceVoltage(float voltage) {
     _referenceVoltage = (voltage > 0.0f) ? voltage : 3.3f;
+    updateScale();
 }
 
 float MoaBattControl::getReferenceVoltage() const {
@@ -193,6 +231,7 @@ float MoaBattControl::getReferenceVoltage() const {
 
 void MoaBattControl::setLowThreshold(float voltage) {
     _lowThreshold = voltage;
+    updateThresholds();
 }
 
 float MoaBattControl::getLowThreshold() const {
@@ -201,6 +240,7 @@ float MoaBattControl::getLowThreshold() const {
 
 void MoaBattControl::setStopThreshold(float voltage) {
     _stopThreshold = voltage;
+    updateThresholds();
 }
 
 float MoaBattControl::getStopThreshold() const {
@@ -209,6 +249,7 @@ float MoaBattControl::getStopThreshold() const {
 
 void MoaBattControl::setHighThreshold(float voltage) {
     _highThreshold = voltage;
+    updateThresholds();
 }
 
 float MoaBattControl::getHighThreshold() const {
@@ -217,22 +258,59 @@ float MoaBattControl::getHighThreshold() const {
 
 void MoaBattControl::setHysteresis(float hysteresis) {
     _hysteresis = (hysteresis >= 0.0f) ? hysteresis : 0.0f;
+    updateThresholds();
 }
 
 float MoaBattControl::getHysteresis() const {
     return _hysteresis;
 }
 
+void MoaBattControl::setLoadCompensation(bool enabled) {
+    _compensate.store(enabled, std::memory_order_relaxed);
+}
+
+bool MoaBattControl::isLoadCompensated() const {
+    return _compensate.load(std::memory_order_relaxed);
+}
+
+void MoaBattControl::setInitialResistance(uint32_t milliohm) {
+    _resistance.setInitialResistance(milliohm);
+}
+
+void MoaBattControl::setMaxSag(uint32_t millivolts) {
+    _resistance.setMaxSag(millivolts);
+}
+
+void MoaBattControl::setLoadCurrent(int32_t currentMa) {
+    _loadMa = currentMa;
+}
+
+const MoaBattResistance& MoaBattControl::getResistance() const {
+    return _resistance;
+}
+
+int32_t MoaBattControl::getOpenCircuitVoltageMv() const {
+    return _openCircuitMv;
+}
+
 uint16_t MoaBattControl::getRawAdc() const {
     return _rawAdc;
 }
 
 float MoaBattControl::getCurrentVoltage() const {
-    return _currentVoltage;
+    return _currentMv / 1000.0f;
 }
 
 float MoaBattControl::getAveragedVoltage() const {
-    return _averagedVoltage;
+    return _averagedMv / 1000.0f;
+}
+
+int32_t MoaBattControl::getCurrentVoltageMv() const {
+    return _currentMv;
+}
+
+int32_t MoaBattControl::getAveragedVoltageMv() const {
+    return _averagedMv;
 }
 
 MoaBattLevel MoaBattControl::getLevel() const {
@@ -240,88 +318,48 @@ MoaBattLevel MoaBattControl::getLevel() const {
 }
 
 bool MoaBattControl::isAveragingReady() const {
-    return _sampleCount >= _numSamples;
+    return _filter.isFull();
 }
 
 void MoaBattControl::setNumSamples(uint8_t numSamples) {
-    // Clamp to valid range
-    if (numSamples < 1) {
-        numSamples = 1;
-    } else if (numSamples > MOA_BATT_MAX_SAMPLES) {
-        numSamples = MOA_BATT_MAX_SAMPLES;
-    }
-    
-    // Free existing buffer if any
-    if (_samples != nullptr) {
-        delete[] _samples;
-    }
-    
-    // Allocate new buffer
-    _numSamples = numSamples;
-    _samples = new float[_numSamples];
-    
-    // Reset buffer state
-    _sampleIndex = 0;
-    _sampleCount = 0;
-    _averagedVoltage = 0.0f;
-    
-    // Initialize buffer to zero
-    for (uint8_t i = 0; i < _numSamples; i++) {
-        _samples[i] = 0.0f;
-    }
+    // Clamped to 1..MOA_BATT_MAX_SAMPLES by the filter; resets the window
+    _filter.setWindow(numSamples);
+    _loadFilter.setWindow(numSamples);
+    _averagedMv = 0;
+    _averagedLoadMa = 0;
 }
 
 uint8_t MoaBattControl::getNumSamples() const {
-    return _numSamples;
+    return _filter.window();
 }
 
 void MoaBattControl::setAdcResolution(uint8_t bits) {
     _adcResolution = bits;
     analogReadResolution(_adcResolution);
+    updateScale();
 }
 
 uint8_t MoaBattControl::getAdcResolution() const {
     return _adcResolution;
 }
 
-void MoaBattControl::addSample(float voltage) {
-    if (_samples == nullptr) {
-        return;
-    }
-    
-    // Add sample to circular buffer
-    _samples[_sampleIndex] = voltage;
-    _sampleIndex = (_sampleIndex + 1) % _numSamples;
-    
-    // Track how many samples we have
-    if (_sampleCount < _numSamples) {
-        _sampleCount++;
-    }
-    
-    // Update cached average
-    _averagedVoltage = calculateAverage();
+void MoaBattControl::addSample(int32_t voltageMv) {
+    _filter.push(voltageMv);
+    _averagedMv = _filter.average();
 }
 
-float MoaBattControl::calculateAverage() const {
-    if (_sampleCount == 0 || _samples == nullptr) {
-        return 0.0f;
-    }
-    
-    float sum = 0.0f;
-    for (uint8_t i = 0; i < _sampleCount; i++) {
-        sum += _samples[i];
-    }
-    
-    return sum / static_cast<float>(_sampleCount);
+void MoaBattControl::updateScale() {
+    // Vbatt = raw / maxAdc * Vref * dividerRatio
+    float maxAdcValue = static_cast<float>((1 << _adcResolution) - 1);
+    float mvPerCode = _referenceVoltage * _dividerRatio * 1000.0f / maxAdcValue;
+    _scale = MoaFixedScale::fromFloat(mvPerCode, 0.0f);
 }
 
-float MoaBattControl::adcToVoltage(uint16_t rawAdc) const {
-    // Convert ADC reading to voltage at ADC pin
-    float maxAdcValue = static_cast<float>((1 << _adcResolution) - 1);
-    float adcVoltage = (static_cast<float>(rawAdc) / maxAdcValue) * _referenceVoltage;
-    
-    // Apply voltage divider ratio to get actual battery voltage
-    return adcVoltage * _dividerRatio;
+void MoaBattControl::updateThresholds() {
+    _lowMv = moaToFixedUnits(_lowThreshold, 1000);
+    _stopMv = moaToFixedUnits(_stopThreshold, 1000);
+    _highMv = moaToFixedUnits(_highThreshold, 1000);
+    _hysteresisMv = moaToFixedUnits(_hysteresis, 1000);
 }
 
 void MoaBattControl::pushBattEvent(int commandType) {
@@ -329,16 +367,14 @@ void MoaBattControl::pushBattEvent(int commandType) {
         return;
     }
 
-    ControlCommand cmd;
-    cmd.controlType = CONTROL_TYPE_BATTERY;
-    cmd.commandType = commandType;
-    // Send voltage as int in millivolts (e.g., 3.85V = 3850)
-    cmd.value = static_cast<int>(_averagedVoltage * 1000.0f);
+    // Send the measured (terminal) voltage in millivolts (e.g., 3.85V = 3850)
+    BattEvent event(static_cast<uint8_t>(commandType), static_cast<uint16_t>(_averagedMv));
 
-    xQueueSend(_eventQueue, &cmd, 0);  // Don't block if queue is full
+    MOA_LATENCY_MARK_FROM(MOA_HOP_SENSOR_SAMPLE, MOA_HOP_PUSH);
+    _eventQueue->push(event);  // Never blocks; drops are counted per producer
 }
 
-void MoaBattControl::setEventQueue(QueueHandle_t eventQueue) {
+void MoaBattControl::setEventQueue(MoaEventChannel* eventQueue) {
     _eventQueue = eventQueue;
 }
 
@@ -346,6 +382,11 @@ void MoaBattControl::setStatsQueue(QueueHandle_t statsQueue) {
     _statsQueue = statsQueue;
 }
 
+void MoaBattControl::setAdcSampler(MoaAdcSampler* sampler, uint8_t slot) {
+    _adcSampler = sampler;
+    _adcSlot = slot;
+}
+
 void MoaBattControl::pushStatsReading() {
     if (_statsQueue == nullptr) {
         return;
@@ -353,7 +394,7 @@ void MoaBattControl::pushStatsReading() {
 
     StatsReading reading;
     reading.statsType = STATS_TYPE_BATTERY;
-    reading.value = static_cast<int32_t>(_averagedVoltage * 1000.0f);  // millivolts
+    reading.value = _averagedMv;  // millivolts
     reading.timestamp = millis();
 
     xQueueSend(_statsQueue, &reading, 0);  // Don't block if queue is full
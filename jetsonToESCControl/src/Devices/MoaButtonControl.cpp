@@ -7,6 +7,7 @@
 
 #include "MoaButtonControl.h"
 #include "esp_log.h"
+#include "MoaLatencyTrace.h"
 
 static const char* TAG = "Button";
 
@@ -20,7 +21,7 @@ void IRAM_ATTR moaButtonControlISR() {
     }
 }
 
-MoaButtonControl::MoaButtonControl(QueueHandle_t eventQueue, MoaMcpDevice& mcpDevice, uint8_t intPin)
+MoaButtonControl::MoaButtonControl(MoaEventChannel* eventQueue, MoaMcpDevice& mcpDevice, uint8_t intPin)
     : _eventQueue(eventQueue)
     , _mcpDevice(mcpDevice)
     , _intPin(intPin)
@@ -77,20 +78,20 @@ void MoaButtonControl::begin(bool useInterrupt) {
 }
 
 void IRAM_ATTR MoaButtonControl::handleInterrupt() {
+    MOA_LATENCY_BEGIN(MOA_HOP_BUTTON_EDGE);
     _interruptPending = true;
 }
 
 void MoaButtonControl::processInterrupt() {
     _interruptPending = false;
+    MOA_LATENCY_MARK_FROM(MOA_HOP_BUTTON_EDGE, MOA_HOP_PROCESS);
     
     uint32_t now = millis();
     
-    // Read INTCAPA to see what triggered the interrupt
-    _mcpDevice.readInterruptCapturePortA();
-    
-    // Read current GPIO state — this is what matters for detecting
-    // press/release AND it fully clears the MCP23018 interrupt
-    uint8_t currentState = _mcpDevice.readPortA();
+    // INTCAPA (what triggered the interrupt) and current GPIO state in one
+    // I2C burst. The current state is what matters for detecting
+    // press/release, and reading GPIOA fully clears the MCP23018 interrupt
+    uint8_t currentState = _mcpDevice.readInterruptStatePortA();
     
     // Process each button using current state
     for (uint8_t i = 0; i < MOA_BUTTON_COUNT; i++) {
@@ -107,6 +108,9 @@ void MoaButtonControl::processInterrupt() {
     }
     
     _lastRawState = currentState;
+
+    // Release edges and debounced glitches end here
+    MOA_LATENCY_RELEASE(MOA_HOP_BUTTON_EDGE, MOA_HOP_PUSH);
 }
 
 void MoaButtonControl::processButtonFromInterrupt(uint8_t index, bool isPressed, uint32_t now) {
@@ -340,7 +344,7 @@ uint8_t MoaButtonControl::commandIdToIndex(uint8_t commandId) const {
     return commandId - COMMAND_BUTTON_STOP;
 }
 
-void MoaButtonControl::setEventQueue(QueueHandle_t eventQueue) {
+void MoaButtonControl::setEventQueue(MoaEventChannel* eventQueue) {
     _eventQueue = eventQueue;
 }
 
@@ -349,10 +353,8 @@ void MoaButtonControl::pushButtonEvent(uint8_t commandId, uint8_t eventType) {
         return;
     }
 
-    ControlCommand cmd;
-    cmd.controlType = CONTROL_TYPE_BUTTON;
-    cmd.commandType = commandId;
-    cmd.value = eventType;
+    ButtonEvent event(commandId, eventType);
 
-    xQueueSend(_eventQueue, &cmd, 0);  // Don't block if queue is full
+    MOA_LATENCY_MARK_FROM(MOA_HOP_BUTTON_EDGE, MOA_HOP_PUSH);
+    _eventQueue->push(event);  // Never blocks; drops are counted per producer
 }
@@ -6,11 +6,13 @@
  */
 
 #include "MoaCurrentControl.h"
+#include "Constants.h"
 #include "esp_log.h"
+#include "MoaLatencyTrace.h"
 
 static const char* TAG = "Current";
 
-MoaCurrentControl::MoaCurrentControl(QueueHandle_t eventQueue, uint8_t adcPin,
+MoaCurrentControl::MoaCurrentControl(MoaEventChannel* eventQueue, uint8_t adcPin,
                                      uint8_t numSamples)
     : _eventQueue(eventQueue)
     , _statsQueue(nullptr)
@@ -22,25 +24,26 @@ MoaCurrentControl::MoaCurrentControl(QueueHandle_t eventQueue, uint8_t adcPin,
     , _overcurrentThreshold(150.0f)   // Default 150A
     , _reverseOvercurrentThreshold(-150.0f)
     , _hysteresis(5.0f)               // Default 5A hysteresis
+    , _scale()
+    , _overcurrentMa(0)
+    , _reverseOvercurrentMa(0)
+    , _hysteresisMa(0)
     , _rawAdc(0)
-    , _adcVoltage(0.0f)
-    , _currentReading(0.0f)
+    , _currentMa(0)
     , _state(MoaCurrentState::NORMAL)
-    , _samples(nullptr)
-    , _numSamples(0)
-    , _sampleIndex(0)
-    , _sampleCount(0)
-    , _averagedCurrent(0.0f)
+    , _filter(numSamples)
+    , _averagedMa(0)
     , _updateCount(0)
+    , _adcSampler(nullptr)
+    , _adcSlot(0)
+    , _fastTrip()
+    , _fastTripThreshold(CURRENT_FAST_TRIP_THRESHOLD)
+    , _fastTripReverseThreshold(CURRENT_FAST_TRIP_REVERSE)
 {
-    setNumSamples(numSamples);
-}
-
-MoaCurrentControl::~MoaCurrentControl() {
-    if (_samples != nullptr) {
-        delete[] _samples;
-        _samples = nullptr;
-    }
+    _fastTrip.setBlankingSamples(CURRENT_FAST_TRIP_BLANKING_SAMPLES);
+    _fastTrip.setTripCount(CURRENT_FAST_TRIP_COUNT);
+    updateScale();
+    updateThresholds();
 }
 
 void MoaCurrentControl::begin() {
@@ -52,17 +55,41 @@ void MoaCurrentControl::begin() {
 }
 
 void MoaCurrentControl::update() {
-    //_rawAdc = analogRead(_adcPin);
-    _rawAdc = 2048;
-    _currentReading = adcToCurrent(_rawAdc);
-    
-    // Add sample to circular buffer and update average
-    addSample(_currentReading);
+    uint16_t block[MOA_ADC_BLOCK_CAPACITY];
+    size_t count;
+
+    if (_adcSampler != nullptr) {
+        // Continuous mode: consume everything decimated since the last tick
+        count = _adcSampler->takeBlock(_adcSlot, block, MOA_ADC_BLOCK_CAPACITY);
+        if (count == 0) {
+            return;  // No new data yet
+        }
+    } else {
+        //block[0] = analogRead(_adcPin);
+        block[0] = 2048;
+        count = 1;
+    }
+
+    processBlock(block, count);
+}
+
+void MoaCurrentControl::processBlock(const uint16_t* rawSamples, size_t count) {
+    if (rawSamples == nullptr || count == 0) {
+        return;
+    }
+
+    // Feed every sample of the block through the moving-window filter
+    // (integer only: the calibration is already folded into _scale)
+    for (size_t i = 0; i < count; i++) {
+        _rawAdc = rawSamples[i];
+        _currentMa = _scale.apply(_rawAdc);
+        addSample(_currentMa);
+    }
     
     // Periodic log (1 in 100 readings, ~5s at 50ms task period)
     if (++_updateCount % 100 == 0) {
         ESP_LOGI(TAG, "I=%.1fA avg=%.1fA raw=%d state=%s",
-                 _currentReading, _averagedCurrent, _rawAdc,
+                 getCurrentReading(), getAveragedCurrent(), _rawAdc,
                  _state == MoaCurrentState::NORMAL ? "NORMAL" :
                  _state == MoaCurrentState::OVERCURRENT ? "OVER" : "REVERSE");
     }
@@ -70,16 +97,26 @@ void MoaCurrentControl::update() {
     // Push stats reading to telemetry queue
     pushStatsReading();
     
+    // The fast path already cut the ESC and notified the state machine:
+    // mirror it here so the averaged path reports NORMAL once current drops
+    if (_fastTrip.isTripped() && _state == MoaCurrentState::NORMAL) {
+        _state = (_fastTrip.getTripDirection() > 0) ? MoaCurrentState::OVERCURRENT
+                                                    : MoaCurrentState::REVERSE_OVERCURRENT;
+        ESP_LOGW(TAG, "State -> %s (fast trip, raw=%d)",
+                 _state == MoaCurrentState::OVERCURRENT ? "OVERCURRENT" : "REVERSE_OVERCURRENT",
+                 _fastTrip.getTripRaw());
+    }
+
     // Only check thresholds if we have enough samples for valid averaging
     if (!isAveragingReady()) {
         return;
     }
     
     // Calculate thresholds with hysteresis based on current state
-    float overcurrentUp = _overcurrentThreshold;
-    float overcurrentDown = _overcurrentThreshold - _hysteresis;
-    float reverseUp = _reverseOvercurrentThreshold + _hysteresis;
-    float reverseDown = _reverseOvercurrentThreshold;
+    int32_t overcurrentUp = _overcurrentMa;
+    int32_t overcurrentDown = _overcurrentMa - _hysteresisMa;
+    int32_t reverseUp = _reverseOvercurrentMa + _hysteresisMa;
+    int32_t reverseDown = _reverseOvercurrentMa;
     
     // Check for state transitions and push events
     MoaCurrentState previousState = _state;
@@ -87,23 +124,23 @@ void MoaCurrentControl::update() {
     switch (_state) {
         case MoaCurrentState::NORMAL:
             // From NORMAL, can go to OVERCURRENT or REVERSE_OVERCURRENT
-            if (_averagedCurrent >= overcurrentUp) {
+            if (_averagedMa >= overcurrentUp) {
                 _state = MoaCurrentState::OVERCURRENT;
-            } else if (_averagedCurrent <= reverseDown) {
+            } else if (_averagedMa <= reverseDown) {
                 _state = MoaCurrentState::REVERSE_OVERCURRENT;
             }
             break;
             
         case MoaCurrentState::OVERCURRENT:
             // From OVERCURRENT, can only go back to NORMAL
-            if (_averagedCurrent <= overcurrentDown) {
+            if (_averagedMa <= overcurrentDown) {
                 _state = MoaCurrentState::NORMAL;
             }
             break;
             
         case MoaCurrentState::REVERSE_OVERCURRENT:
             // From REVERSE_OVERCURRENT, can only go back to NORMAL
-            if (_averagedCurrent >= reverseUp) {
+            if (_averagedMa >= reverseUp) {
                 _state = MoaCurrentState::NORMAL;
             }
             break;
@@ -113,15 +150,15 @@ void MoaCurrentControl::update() {
     if (_state != previousState) {
         switch (_state) {
             case MoaCurrentState::NORMAL:
-                ESP_LOGI(TAG, "State -> NORMAL (avg=%.1fA)", _averagedCurrent);
+                ESP_LOGI(TAG, "State -> NORMAL (avg=%.1fA)", getAveragedCurrent());
                 pushCurrentEvent(COMMAND_CURRENT_NORMAL);
                 break;
             case MoaCurrentState::OVERCURRENT:
-                ESP_LOGW(TAG, "State -> OVERCURRENT (avg=%.1fA, threshold=%.1fA)", _averagedCurrent, _overcurrentThreshold);
+                ESP_LOGW(TAG, "State -> OVERCURRENT (avg=%.1fA, threshold=%.1fA)", getAveragedCurrent(), _overcurrentThreshold);
                 pushCurrentEvent(COMMAND_CURRENT_OVERCURRENT);
                 break;
             case MoaCurrentState::REVERSE_OVERCURRENT:
-                ESP_LOGW(TAG, "State -> REVERSE_OVERCURRENT (avg=%.1fA, threshold=%.1fA)", _averagedCurrent, _reverseOvercurrentThreshold);
+                ESP_LOGW(TAG, "State -> REVERSE_OVERCURRENT (avg=%.1fA, threshold=%.1fA)", getAveragedCurrent(), _reverseOvercurrentThreshold);
                 pushCurrentEvent(COMMAND_CURRENT_REVERSE_OVERCURRENT);
                 break;
         }
@@ -130,6 +167,7 @@ void MoaCurrentControl::update() {
 
 void MoaCurrentControl::setSensitivity(float sensitivity) {
     _sensitivity = (sensitivity > 0.0f) ? sensitivity : 0.0066f;
+    updateScale();
 }
 
 float MoaCurrentControl::getSensitivity() const {
@@ -138,6 +176,7 @@ float MoaCurrentControl::getSensitivity() const {
 
 void MoaCurrentControl::setZeroOffset(float offset) {
     _zeroOffset = offset;
+    updateScale();
 }
 
 float MoaCurrentControl::getZeroOffset() const {
@@ -146,6 +185,7 @@ float MoaCurrentControl::getZeroOffset() const {
 
 void MoaCurrentControl::setReferenceVoltage(float voltage) {
     _referenceVoltage = (voltage > 0.0f) ? voltage : 3.3f;
+    updateScale();
 }
 
 float MoaCurrentControl::getReferenceVoltage() const {
@@ -154,6 +194,7 @@ float MoaCurrentControl::getReferenceVoltage() const {
 
 void MoaCurrentControl::setOvercurrentThreshold(float current) {
     _overcurrentThreshold = current;
+    updateThresholds();
 }
 
 float MoaCurrentControl::getOvercurrentThreshold() const {
@@ -162,6 +203,7 @@ float MoaCurrentControl::getOvercurrentThreshold() const {
 
 void MoaCurrentControl::setReverseOvercurrentThreshold(float current) {
     _reverseOvercurrentThreshold = current;
+    updateThresholds();
 }
 
 float MoaCurrentControl::getReverseOvercurrentThreshold() const {
@@ -170,6 +212,7 @@ float MoaCurrentControl::getReverseOvercurrentThreshold() const {
 
 void MoaCurrentControl::setHysteresis(float hysteresis) {
     _hysteresis = (hysteresis >= 0.0f) ? hysteresis : 0.0f;
+    updateThresholds();
 }
 
 float MoaCurrentControl::getHysteresis() const {
@@ -181,15 +224,24 @@ uint16_t MoaCurrentControl::getRawAdc() const {
 }
 
 float MoaCurrentControl::getAdcVoltage() const {
-    return _adcVoltage;
+    float maxAdcValue = static_cast<float>((1 << _adcResolution) - 1);
+    return (static_cast<float>(_rawAdc) / maxAdcValue) * _referenceVoltage;
 }
 
 float MoaCurrentControl::getCurrentReading() const {
-    return _currentReading;
+    return _currentMa / 1000.0f;
 }
 
 float MoaCurrentControl::getAveragedCurrent() const {
-    return _averagedCurrent;
+    return _averagedMa / 1000.0f;
+}
+
+int32_t MoaCurrentControl::getCurrentMa() const {
+    return _currentMa;
+}
+
+int32_t MoaCurrentControl::getAveragedCurrentMa() const {
+    return _averagedMa;
 }
 
 MoaCurrentState MoaCurrentControl::getState() const {
@@ -197,90 +249,66 @@ MoaCurrentState MoaCurrentControl::getState() const {
 }
 
 bool MoaCurrentControl::isAveragingReady() const {
-    return _sampleCount >= _numSamples;
+    return _filter.isFull();
 }
 
 void MoaCurrentControl::setNumSamples(uint8_t numSamples) {
-    // Clamp to valid range
-    if (numSamples < 1) {
-        numSamples = 1;
-    } else if (numSamples > MOA_CURRENT_MAX_SAMPLES) {
-        numSamples = MOA_CURRENT_MAX_SAMPLES;
-    }
-    
-    // Free existing buffer if any
-    if (_samples != nullptr) {
-        delete[] _samples;
-    }
-    
-    // Allocate new buffer
-    _numSamples = numSamples;
-    _samples = new float[_numSamples];
-    
-    // Reset buffer state
-    _sampleIndex = 0;
-    _sampleCount = 0;
-    _averagedCurrent = 0.0f;
-    
-    // Initialize buffer to zero
-    for (uint8_t i = 0; i < _numSamples; i++) {
-        _samples[i] = 0.0f;
-    }
+    // Clamped to 1..MOA_CURRENT_MAX_SAMPLES by the filter; resets the window
+    _filter.setWindow(numSamples);
+    _averagedMa = 0;
 }
 
 uint8_t MoaCurrentControl::getNumSamples() const {
-    return _numSamples;
+    return _filter.window();
 }
 
 void MoaCurrentControl::setAdcResolution(uint8_t bits) {
     _adcResolution = bits;
     analogReadResolution(_adcResolution);
+    updateScale();
 }
 
 uint8_t MoaCurrentControl::getAdcResolution() const {
     return _adcResolution;
 }
 
-void MoaCurrentControl::addSample(float current) {
-    if (_samples == nullptr) {
-        return;
-    }
-    
-    // Add sample to circular buffer
-    _samples[_sampleIndex] = current;
-    _sampleIndex = (_sampleIndex + 1) % _numSamples;
-    
-    // Track how many samples we have
-    if (_sampleCount < _numSamples) {
-        _sampleCount++;
-    }
-    
-    // Update cached average
-    _averagedCurrent = calculateAverage();
+void MoaCurrentControl::addSample(int32_t currentMa) {
+    _filter.push(currentMa);
+    _averagedMa = _filter.average();
 }
 
-float MoaCurrentControl::calculateAverage() const {
-    if (_sampleCount == 0 || _samples == nullptr) {
-        return 0.0f;
-    }
-    
-    float sum = 0.0f;
-    for (uint8_t i = 0; i < _sampleCount; i++) {
-        sum += _samples[i];
-    }
-    
-    return sum / static_cast<float>(_sampleCount);
+void MoaCurrentControl::updateScale() {
+    // Current = (Vadc - Voffset) / Sensitivity, with Vadc = raw / maxAdc * Vref
+    // Positive current when Vadc > Voffset, negative when Vadc < Voffset
+    float maxAdcValue = static_cast<float>((1 << _adcResolution) - 1);
+    float maPerCode = _referenceVoltage * 1000.0f / (maxAdcValue * _sensitivity);
+    float maAtZero = -_zeroOffset * 1000.0f / _sensitivity;
+    _scale = MoaFixedScale::fromFloat(maPerCode, maAtZero);
+
+    updateFastTripThresholds();
+}
+
+void MoaCurrentControl::updateThresholds() {
+    _overcurrentMa = moaToFixedUnits(_overcurrentThreshold, 1000);
+    _reverseOvercurrentMa = moaToFixedUnits(_reverseOvercurrentThreshold, 1000);
+    _hysteresisMa = moaToFixedUnits(_hysteresis, 1000);
 }
 
-float MoaCurrentControl::adcToCurrent(uint16_t rawAdc) {
-    // Convert ADC reading to voltage at ADC pin
+int32_t MoaCurrentControl::rawToMilliamps(uint16_t rawAdc) const {
+    return _scale.apply(rawAdc);
+}
+
+uint16_t MoaCurrentControl::currentToRaw(float current) const {
+    // Inverse of the raw -> current map: Vadc = Voffset + I * Sensitivity
     float maxAdcValue = static_cast<float>((1 << _adcResolution) - 1);
-    _adcVoltage = (static_cast<float>(rawAdc) / maxAdcValue) * _referenceVoltage;
-    
-    // Convert voltage to current using sensitivity and offset
-    // Current = (Vadc - Voffset) / Sensitivity
-    // Positive current when Vadc > Voffset, negative when Vadc < Voffset
-    return (_adcVoltage - _zeroOffset) / _sensitivity;
+    float raw = (_zeroOffset + current * _sensitivity) / _referenceVoltage * maxAdcValue;
+    if (raw < 0.0f) {
+        return 0;
+    }
+    if (raw > maxAdcValue) {
+        return static_cast<uint16_t>(maxAdcValue);
+    }
+    return static_cast<uint16_t>(raw + 0.5f);
 }
 
 void MoaCurrentControl::pushCurrentEvent(int commandType) {
@@ -288,16 +316,14 @@ void MoaCurrentControl::pushCurrentEvent(int commandType) {
         return;
     }
 
-    ControlCommand cmd;
-    cmd.controlType = CONTROL_TYPE_CURRENT;
-    cmd.commandType = commandType;
-    // Send current as int (x10 for one decimal precision, e.g., 125.5A = 1255)
-    cmd.value = static_cast<int>(_averagedCurrent * 10.0f);
+    // Send current x10 for one decimal precision, e.g., 125.5A = 1255
+    CurrentEvent event(static_cast<uint8_t>(commandType), static_cast<int16_t>(moaDivRound(_averagedMa, 100)));
 
-    xQueueSend(_eventQueue, &cmd, 0);  // Don't block if queue is full
+    MOA_LATENCY_MARK_FROM(MOA_HOP_SENSOR_SAMPLE, MOA_HOP_PUSH);
+    _eventQueue->push(event);  // Never blocks; drops are counted per producer
 }
 
-void MoaCurrentControl::setEventQueue(QueueHandle_t eventQueue) {
+void MoaCurrentControl::setEventQueue(MoaEventChannel* eventQueue) {
     _eventQueue = eventQueue;
 }
 
@@ -305,6 +331,52 @@ void MoaCurrentControl::setStatsQueue(QueueHandle_t statsQueue) {
     _statsQueue = statsQueue;
 }
 
+void MoaCurrentControl::setAdcSampler(MoaAdcSampler* sampler, uint8_t slot) {
+    _adcSampler = sampler;
+    _adcSlot = slot;
+}
+
+MoaOvercurrentTrip& MoaCurrentControl::getFastTrip() {
+    return _fastTrip;
+}
+
+void MoaCurrentControl::setFastTripThreshold(float current) {
+    _fastTripThreshold = current;
+    updateFastTripThresholds();
+}
+
+float MoaCurrentControl::getFastTripThreshold() const {
+    return _fastTripThreshold;
+}
+
+void MoaCurrentControl::setFastTripReverseThreshold(float current) {
+    _fastTripReverseThreshold = current;
+    updateFastTripThresholds();
+}
+
+float MoaCurrentControl::getFastTripReverseThreshold() const {
+    return _fastTripReverseThreshold;
+}
+
+void MoaCurrentControl::updateFastTripThresholds() {
+    // Raw code 0 disables a side of the comparator; keep enabled sides >= 1
+    uint16_t highRaw = 0;
+    uint16_t lowRaw = 0;
+    if (_fastTripThreshold > 0.0f) {
+        highRaw = currentToRaw(_fastTripThreshold);
+        if (highRaw == 0) {
+            highRaw = 1;
+        }
+    }
+    if (_fastTripReverseThreshold < 0.0f) {
+        lowRaw = currentToRaw(_fastTripReverseThreshold);
+        if (lowRaw == 0) {
+            lowRaw = 1;
+        }
+    }
+    _fastTrip.setThresholds(highRaw, lowRaw);
+}
+
 void MoaCurrentControl::pushStatsReading() {
     if (_statsQueue == nullptr) {
         return;
@@ -312,7 +384,7 @@ void MoaCurrentControl::pushStatsReading() {
 
     StatsReading reading;
     reading.statsType = STATS_TYPE_CURRENT;
-    reading.value = static_cast<int32_t>(_averagedCurrent * 10.0f);  // x10 for precision
+    reading.value = moaDivRound(_averagedMa, 100);  // x10 for precision
     reading.timestamp = millis();
 
     xQueueSend(_statsQueue, &reading, 0);  // Don't block if queue is full
@@ -10,16 +10,19 @@
 
 static const char* TAG = "FlashLog";
 
-MoaFlashLog::MoaFlashLog(const char* filename)
-    : _filename(filename)
+MoaFlashLog::MoaFlashLog(ILogStorage* storage, const char* basePath)
+    : _storage(storage)
+    , _journal(storage, basePath)
     , _flushIntervalMs(MOA_LOG_DEFAULT_FLUSH_INTERVAL_MS)
     , _lastFlushTime(0)
     , _initialized(false)
     , _entryCount(0)
     , _writeIndex(0)
     , _oldestIndex(0)
+    , _unsavedCount(0)
     , _ramBufferCount(0)
     , _dirty(false)
+    , _loggedCount(0)
 {
     memset(_entries, 0, sizeof(_entries));
     memset(_ramBuffer, 0, sizeof(_ramBuffer));
@@ -32,23 +35,28 @@ MoaFlashLog::~MoaFlashLog() {
 }
 
 bool MoaFlashLog::begin() {
-    if (!LittleFS.begin(true)) {  // true = format if mount fails
-        ESP_LOGE(TAG, "LittleFS mount failed!");
+    if (!_journal.begin()) {
+        ESP_LOGE(TAG, "Log storage unavailable!");
         return false;
     }
-    ESP_LOGD(TAG, "LittleFS mounted");
     
-    _initialized = loadFromFlash();
-    if (!_initialized) {
-        // No existing log or read error - start fresh
+    if (_journal.getDiscardedRecords() > 0) {
+        ESP_LOGW(TAG, "Dropped %lu torn/corrupt log records", _journal.getDiscardedRecords());
+    }
+    
+    importLegacyLog();
+    
+    if (!loadFromFlash()) {
+        // No existing log - start fresh
         _entryCount = 0;
         _writeIndex = 0;
         _oldestIndex = 0;
-        _initialized = true;
         ESP_LOGD(TAG, "Starting fresh log");
     } else {
-        ESP_LOGD(TAG, "Loaded %d entries from flash", _entryCount);
+        ESP_LOGD(TAG, "Loaded %d entries from %u segments", _entryCount, _journal.getSegmentCount());
     }
+    _unsavedCount = 0;
+    _initialized = true;
     
     _lastFlushTime = millis();
     return _initialized;
@@ -84,6 +92,7 @@ void MoaFlashLog::log(uint8_t type, uint8_t code, int16_t value, bool critical)
     entry.type = type;
     entry.code = code;
     entry.value = value;
+    _loggedCount++;
     
     // Add to RAM buffer
     if (_ramBufferCount < MOA_LOG_RAM_BUFFER_SIZE) {
@@ -146,13 +155,14 @@ void MoaFlashLog::flush() {
     // First flush RAM buffer to circular buffer
     flushRamBuffer();
     
-    // Then save to flash
+    // Then append the new entries to flash
+    size_t pending = _unsavedCount;
     if (saveToFlash()) {
         _dirty = false;
         _lastFlushTime = millis();
-        ESP_LOGD(TAG, "Flushed %d entries to flash", _entryCount);
+        ESP_LOGD(TAG, "Flushed %d new entries to flash", pending);
     } else {
-        ESP_LOGE(TAG, "Flash write failed!");
+        ESP_LOGE(TAG, "Flash write failed! (%d entries pending)", _unsavedCount);
     }
 }
 
@@ -160,15 +170,16 @@ void MoaFlashLog::clear() {
     _entryCount = 0;
     _writeIndex = 0;
     _oldestIndex = 0;
+    _unsavedCount = 0;
     _ramBufferCount = 0;
     _dirty = true;
     
     memset(_entries, 0, sizeof(_entries));
     memset(_ramBuffer, 0, sizeof(_ramBuffer));
     
-    // Delete file
+    // Delete segments
     if (_initialized) {
-        LittleFS.remove(_filename);
+        _journal.clear();
         _dirty = false;
     }
 }
@@ -197,62 +208,23 @@ bool MoaFlashLog::readEntry(size_t index, MoaLogEntry& entry) const {
     return true;
 }
 
-String MoaFlashLog::toJson() const {
-    String json = "{\"count\":";
-    json += String(getEntryCount());
-    json += ",\"entries\":[";
-    
+bool MoaFlashLog::exportTo(ILogSink& sink, MoaLogExportFormat format) const {
     size_t totalCount = getEntryCount();
+    MoaLogExporter exporter(sink, format);
     MoaLogEntry entry;
     
-    for (size_t i = 0; i < totalCount; i++) {
+    exporter.begin(totalCount);
+    for (size_t i = 0; i < totalCount && !exporter.hasFailed(); i++) {
         if (readEntry(i, entry)) {
-            if (i > 0) {
-                json += ",";
-            }
-            json += "{\"t\":";
-            json += String(entry.timestamp);
-            json += ",\"type\":";
-            json += String(entry.type);
-            json += ",\"code\":";
-            json += String(entry.code);
-            json += ",\"val\":";
-            json += String(entry.value);
-            json += "}";
+            exporter.add(entry);
         }
     }
     
-    json += "]}";
-    return json;
-}
-
-String MoaFlashLog::toJsonVerbose() const {
-    String json = "{\"count\":";
-    json += String(getEntryCount());
-    json += ",\"entries\":[";
-    
-    size_t totalCount = getEntryCount();
-    MoaLogEntry entry;
-    
-    for (size_t i = 0; i < totalCount; i++) {
-        if (readEntry(i, entry)) {
-            if (i > 0) {
-                json += ",";
-            }
-            json += "{\"t\":";
-            json += String(entry.timestamp);
-            json += ",\"type\":\"";
-            json += getTypeName(entry.type);
-            json += "\",\"code\":\"";
-            json += getCodeName(entry.type, entry.code);
-            json += "\",\"val\":";
-            json += String(entry.value);
-            json += "}";
-        }
+    if (!exporter.end()) {
+        ESP_LOGW(TAG, "Log export aborted by sink after %lu bytes", exporter.getBytesWritten());
+        return false;
     }
-    
-    json += "]}";
-    return json;
+    return true;
 }
 
 void MoaFlashLog::dumpToSerial() const {
@@ -270,9 +242,9 @@ void MoaFlashLog::dumpToSerial() const {
             Serial.print("] t=");
             Serial.print(entry.timestamp);
             Serial.print(" type=");
-            Serial.print(getTypeName(entry.type));
+            Serial.print(MoaLogExporter::getTypeName(entry.type));
             Serial.print(" code=");
-            Serial.print(getCodeName(entry.type, entry.code));
+            Serial.print(MoaLogExporter::getCodeName(entry.type, entry.code));
             Serial.print(" val=");
             Serial.println(entry.value);
         }
@@ -282,73 +254,84 @@ void MoaFlashLog::dumpToSerial() const {
 }
 
 bool MoaFlashLog::loadFromFlash() {
-    if (!LittleFS.exists(_filename)) {
-        return false;
-    }
-    
-    File file = LittleFS.open(_filename, "r");
-    if (!file) {
-        return false;
-    }
-    
-    // Read header: entryCount (2 bytes) + oldestIndex (2 bytes)
-    uint16_t count = 0;
-    uint16_t oldest = 0;
-    
-    if (file.read((uint8_t*)&count, 2) != 2 ||
-        file.read((uint8_t*)&oldest, 2) != 2) {
-        file.close();
-        return false;
-    }
-    
-    // Validate
-    if (count > MOA_LOG_MAX_ENTRIES || oldest >= MOA_LOG_MAX_ENTRIES) {
-        file.close();
-        return false;
-    }
-    
-    // Read entries
-    size_t bytesRead = file.read((uint8_t*)_entries, sizeof(_entries));
-    file.close();
-    
-    if (bytesRead != sizeof(_entries)) {
-        return false;
-    }
+    size_t count = _journal.readNewest(_entries, MOA_LOG_MAX_ENTRIES);
     
     _entryCount = count;
-    _oldestIndex = oldest;
-    _writeIndex = (_oldestIndex + _entryCount) % MOA_LOG_MAX_ENTRIES;
+    _oldestIndex = 0;
+    _writeIndex = count % MOA_LOG_MAX_ENTRIES;
     
-    return true;
+    return count > 0;
 }
 
 bool MoaFlashLog::saveToFlash() {
-    File file = LittleFS.open(_filename, "w");
-    if (!file) {
-        return false;
+    // Unsaved entries are the newest ones: at most two contiguous spans of the ring
+    while (_unsavedCount > 0) {
+        size_t start = (_writeIndex + MOA_LOG_MAX_ENTRIES - _unsavedCount) % MOA_LOG_MAX_ENTRIES;
+        size_t span = MOA_LOG_MAX_ENTRIES - start;
+        if (span > _unsavedCount) {
+            span = _unsavedCount;
+        }
+        
+        size_t written = _journal.append(&_entries[start], span);
+        _unsavedCount -= written;
+        if (written < span) {
+            return false;
+        }
     }
     
-    // Write header: entryCount (2 bytes) + oldestIndex (2 bytes)
-    uint16_t count = static_cast<uint16_t>(_entryCount);
-    uint16_t oldest = static_cast<uint16_t>(_oldestIndex);
+    return true;
+}
+
+void MoaFlashLog::importLegacyLog() {
+    const uint32_t legacySize = 4 + MOA_LOG_MAX_ENTRIES * MOA_LOG_ENTRY_SIZE;
     
-    if (file.write((uint8_t*)&count, 2) != 2 ||
-        file.write((uint8_t*)&oldest, 2) != 2) {
-        file.close();
-        return false;
+    if (_storage->size(MOA_LOG_LEGACY_FILENAME) != static_cast<int32_t>(legacySize)) {
+        return;
     }
     
-    // Write entries
-    size_t bytesWritten = file.write((uint8_t*)_entries, sizeof(_entries));
-    file.close();
+    if (_journal.getRecordCount() == 0) {
+        // Header: entryCount (2 bytes) + oldestIndex (2 bytes), then the full ring.
+        // The RAM ring is used as scratch; loadFromFlash() refills it afterwards.
+        uint16_t header[2] = {0, 0};
+        _storage->read(MOA_LOG_LEGACY_FILENAME, 0, reinterpret_cast<uint8_t*>(header), sizeof(header));
+        uint16_t count = header[0];
+        uint16_t oldest = header[1];
+        
+        if (count <= MOA_LOG_MAX_ENTRIES && oldest < MOA_LOG_MAX_ENTRIES &&
+            _storage->read(MOA_LOG_LEGACY_FILENAME, 4, reinterpret_cast<uint8_t*>(_entries), sizeof(_entries)) == sizeof(_entries)) {
+            size_t firstSpan = MOA_LOG_MAX_ENTRIES - oldest;
+            if (firstSpan > count) {
+                firstSpan = count;
+            }
+            size_t written = _journal.append(&_entries[oldest], firstSpan);
+            written += _journal.append(&_entries[0], count - firstSpan);
+            if (written != count) {
+                ESP_LOGE(TAG, "Legacy log import failed (%d of %u entries)", written, count);
+                return;
+            }
+            ESP_LOGI(TAG, "Imported %u entries from %s", count, MOA_LOG_LEGACY_FILENAME);
+        }
+    }
     
-    return bytesWritten == sizeof(_entries);
+    _storage->remove(MOA_LOG_LEGACY_FILENAME);
+}
+
+uint32_t MoaFlashLog::getFlashBytesWritten() const {
+    return _journal.getBytesWritten();
+}
+
+uint32_t MoaFlashLog::getLoggedCount() const {
+    return _loggedCount;
 }
 
 void MoaFlashLog::addEntry(const MoaLogEntry& entry) {
     _entries[_writeIndex] = entry;
     _writeIndex = (_writeIndex + 1) % MOA_LOG_MAX_ENTRIES;
     
+    if (_unsavedCount < MOA_LOG_MAX_ENTRIES) {
+        _unsavedCount++;
+    }
+    
     if (_entryCount < MOA_LOG_MAX_ENTRIES) {
         _entryCount++;
     } else {
@@ -363,81 +346,3 @@ void MoaFlashLog::flushRamBuffer() {
     }
     _ramBufferCount = 0;
 }
-
-const char* MoaFlashLog::getTypeName(uint8_t type) const {
-    switch (type) {
-        case LOG_TYPE_SYSTEM:  return "SYSTEM";
-        case LOG_TYPE_BUTTON:  return "BUTTON";
-        case LOG_TYPE_TEMP:    return "TEMP";
-        case LOG_TYPE_BATT:    return "BATT";
-        case LOG_TYPE_CURRENT: return "CURRENT";
-        case LOG_TYPE_STATE:   return "STATE";
-        case LOG_TYPE_ERROR:   return "ERROR";
-        default:               return "UNKNOWN";
-    }
-}
-
-const char* MoaFlashLog::getCodeName(uint8_t type, uint8_t code) const {
-    switch (type) {
-        case LOG_TYPE_SYSTEM:
-            switch (code) {
-                case LOG_SYS_BOOT:           return "BOOT";
-                case LOG_SYS_SHUTDOWN:       return "SHUTDOWN";
-                case LOG_SYS_CONFIG_ENTER:   return "CONFIG_ENTER";
-                case LOG_SYS_CONFIG_EXIT:    return "CONFIG_EXIT";
-                case LOG_SYS_WATCHDOG_RESET: return "WATCHDOG";
-                default:                     return "?";
-            }
-        case LOG_TYPE_BUTTON:
-            switch (code) {
-                case LOG_BTN_STOP_PRESS:     return "STOP";
-                case LOG_BTN_STOP_LONG:      return "STOP_LONG";
-                case LOG_BTN_25_PRESS:       return "25%";
-                case LOG_BTN_50_PRESS:       return "50%";
-                case LOG_BTN_75_PRESS:       return "75%";
-                case LOG_BTN_100_PRESS:      return "100%";
-                default:                     return "?";
-            }
-        case LOG_TYPE_TEMP:
-            switch (code) {
-                case LOG_TEMP_CROSSED_ABOVE: return "ABOVE";
-                case LOG_TEMP_CROSSED_BELOW: return "BELOW";
-                case LOG_TEMP_OVERHEAT:      return "OVERHEAT";
-                default:                     return "?";
-            }
-        case LOG_TYPE_BATT:
-            switch (code) {
-                case LOG_BATT_HIGH:          return "HIGH";
-                case LOG_BATT_MEDIUM:        return "MEDIUM";
-                case LOG_BATT_LOW:           return "LOW";
-                default:                     return "?";
-            }
-        case LOG_TYPE_CURRENT:
-            switch (code) {
-                case LOG_CURRENT_NORMAL:     return "NORMAL";
-                case LOG_CURRENT_OVERCURRENT:return "OVERCURRENT";
-                case LOG_CURRENT_REVERSE:    return "REVERSE";
-                default:                     return "?";
-            }
-        case LOG_TYPE_STATE:
-            switch (code) {
-                case LOG_STATE_TO_INIT:      return "INIT";
-                case LOG_STATE_TO_IDLE:      return "IDLE";
-                case LOG_STATE_TO_SURFING:   return "SURFING";
-                case LOG_STATE_TO_OVERHEAT:  return "OVERHEAT";
-                case LOG_STATE_TO_OVERCURRENT:return "OVERCURRENT";
-                case LOG_STATE_TO_BATT_LOW:  return "BATT_LOW";
-                default:                     return "?";
-            }
-        case LOG_TYPE_ERROR:
-            switch (code) {
-                case LOG_ERR_I2C_FAIL:       return "I2C_FAIL";
-                case LOG_ERR_SENSOR_FAIL:    return "SENSOR_FAIL";
-                case LOG_ERR_FLASH_FAIL:     return "FLASH_FAIL";
-                case LOG_ERR_QUEUE_FULL:     return "QUEUE_FULL";
-                default:                     return "?";
-            }
-        default:
-            return "?";
-    }
-}
@@ -11,10 +11,15 @@
 static const char* TAG = "MCP";
 
 MoaMcpDevice::MoaMcpDevice(uint8_t i2cAddr)
-    : _i2cAddr(i2cAddr)
+    : _bus(&Wire)
+    , _regs(&_bus, i2cAddr)
+    , _i2cAddr(i2cAddr)
     , _mutexTimeoutMs(MOA_MCP_MUTEX_TIMEOUT_MS)
     , _initialized(false)
     , _resetPin(PIN_I2C_RESET)
+    , _rateWindowStartMs(0)
+    , _rateWindowCount(0)
+    , _transactionsPerSecond(0)
 {
     _mutex = xSemaphoreCreateMutex();
 }
@@ -43,7 +48,11 @@ bool MoaMcpDevice::recover(TwoWire* wire) {
         return false;
     }
     
-    _initialized = _mcp.begin_I2C(_i2cAddr, wire);
+    // Device is back at power-on values; probe it, then restore the configuration
+    _bus.setWire(wire);
+    _regs.resetToPowerOn();
+    uint8_t iocon = 0;
+    _initialized = _regs.read(MCP23018_REG_IOCON, &iocon, 1) && _regs.commit();
     ESP_LOGI(TAG, "Recovery %s", _initialized ? "succeeded" : "FAILED");
     
     releaseMutex();
@@ -55,13 +64,29 @@ uint8_t MoaMcpDevice::readInterruptCapturePortA() {
         return 0;
     }
     
-    // Read INTCAPA via our custom Adafruit_MCP23X18 method
-    uint8_t value = _mcp.readIntCapA();
+    uint8_t value = 0;
+    _regs.read(MCP23018_REG_INTCAPA, &value, 1);
     
     releaseMutex();
     return value;
 }
 
+uint8_t MoaMcpDevice::readInterruptStatePortA(uint8_t* captured) {
+    if (!acquireMutex()) {
+        return 0;
+    }
+    
+    // INTCAPA, INTCAPB, GPIOA in one burst; reading GPIOA clears the interrupt
+    uint8_t values[3] = {0, 0, 0};
+    _regs.read(MCP23018_REG_INTCAPA, values, sizeof(values));
+    
+    releaseMutex();
+    if (captured != nullptr) {
+        *captured = values[0];
+    }
+    return values[2];
+}
+
 bool MoaMcpDevice::isInterruptActive(uint8_t intPin) {
     // Check if the interrupt pin is still asserted (LOW)
     return digitalRead(intPin) == LOW;
@@ -82,10 +107,14 @@ bool MoaMcpDevice::begin(TwoWire* wire) {
         return false;
     }
     
-    _initialized = _mcp.begin_I2C(_i2cAddr, wire);
+    // One burst read of the whole register map both probes the device and seeds the shadow
+    _bus.setWire(wire);
+    _initialized = _regs.begin();
     ESP_LOGI(TAG, "MCP23018 begin: %s (addr=0x%02X)", _initialized ? "OK" : "FAILED", _i2cAddr);
     
     releaseMutex();
+    _rateWindowStartMs = millis();
+    _rateWindowCount = _regs.getTransactionCount();
     return _initialized;
 }
 
@@ -97,8 +126,8 @@ SemaphoreHandle_t MoaMcpDevice::getMutex() {
     return _mutex;
 }
 
-Adafruit_MCP23X18& MoaMcpDevice::getMcp() {
-    return _mcp;
+MoaMcpRegisterFile& MoaMcpDevice::getRegisters() {
+    return _regs;
 }
 
 void MoaMcpDevice::setMutexTimeout(uint32_t timeoutMs) {
@@ -110,14 +139,7 @@ uint32_t MoaMcpDevice::getMutexTimeout() const {
 }
 
 uint8_t MoaMcpDevice::readPortA() {
-    if (!acquireMutex()) {
-        return 0;
-    }
-    
-    uint8_t value = _mcp.readGPIOA();
-    
-    releaseMutex();
-    return value;
+    return readPort(0);
 }
 
 void MoaMcpDevice::configurePortA(uint8_t mask, uint8_t mode) {
@@ -125,12 +147,8 @@ void MoaMcpDevice::configurePortA(uint8_t mask, uint8_t mode) {
         return;
     }
     
-    for (uint8_t i = 0; i < 8; i++) {
-        if (mask & (1 << i)) {
-            _mcp.pinMode(i, mode);  // Port A pins are 0-7
-            _mcp.setPullup(i, (mode & PULLUP) != 0);
-        }
-    }
+    stagePinMode(0, mask, mode);
+    _regs.commit();
     
     releaseMutex();
 }
@@ -142,7 +160,9 @@ void MoaMcpDevice::configurePortA(uint8_t mask, uint8_t mode, uint8_t pullupMask
     
     // Build direction byte: 1=input, 0=output for masked pins
     uint8_t dir = (mode == OUTPUT) ? ~mask : mask;
-    _mcp.configGPIOA(dir, pullupMask);
+    _regs.set(MCP23018_REG_IODIRA, dir);
+    _regs.set(MCP23018_REG_GPPUA, pullupMask);
+    _regs.commit();
     
     releaseMutex();
 }
@@ -152,24 +172,17 @@ void MoaMcpDevice::enableInterruptPortA(uint8_t mask, uint8_t defaultValue) {
         return;
     }
     
-    for (uint8_t i = 0; i < 8; i++) {
-        if (mask & (1 << i)) {
-            _mcp.setupInterruptPin(i, CHANGE);
-        }
-    }
+    // GPINTENA..INTCONA go out as one burst
+    _regs.setBits(MCP23018_REG_GPINTENA, mask, mask);
+    _regs.setBits(MCP23018_REG_DEFVALA, mask, defaultValue);
+    _regs.setBits(MCP23018_REG_INTCONA, mask, 0x00);   // Compare against previous value (CHANGE)
+    _regs.commit();
     
     releaseMutex();
 }
 
 uint8_t MoaMcpDevice::readPortB() {
-    if (!acquireMutex()) {
-        return 0;
-    }
-    
-    uint8_t value = _mcp.readGPIOB();
-    
-    releaseMutex();
-    return value;
+    return readPort(1);
 }
 
 void MoaMcpDevice::writePortB(uint8_t value) {
@@ -177,7 +190,8 @@ void MoaMcpDevice::writePortB(uint8_t value) {
         return;
     }
     
-    _mcp.writeGPIOB(value);
+    _regs.set(MCP23018_REG_OLATB, value);
+    _regs.commit();
     
     releaseMutex();
 }
@@ -187,12 +201,8 @@ void MoaMcpDevice::configurePortB(uint8_t mask, uint8_t mode) {
         return;
     }
     
-    for (uint8_t i = 0; i < 8; i++) {
-        if (mask & (1 << i)) {
-            _mcp.pinMode(8 + i, mode);  // Port B pins are 8-15
-            _mcp.setPullup(8 + i, (mode & PULLUP) != 0);
-        }
-    }
+    stagePinMode(1, mask, mode);
+    _regs.commit();
     
     releaseMutex();
 }
@@ -204,7 +214,9 @@ void MoaMcpDevice::configurePortB(uint8_t mask, uint8_t mode, uint8_t pullupMask
     
     // Build direction byte: 1=input, 0=output for masked pins
     uint8_t dir = (mode == OUTPUT) ? ~mask : mask;
-    _mcp.configGPIOB(dir, pullupMask);
+    _regs.set(MCP23018_REG_IODIRB, dir);
+    _regs.set(MCP23018_REG_GPPUB, pullupMask);
+    _regs.commit();
     
     releaseMutex();
 }
@@ -214,8 +226,8 @@ void MoaMcpDevice::setPinMode(uint8_t pin, uint8_t mode) {
         return;
     }
     
-    _mcp.pinMode(pin, mode);
-    _mcp.setPullup(pin, mode == PULLUP);
+    stagePinMode(pin / 8, 1 << (pin % 8), mode);
+    _regs.commit();
     
     releaseMutex();
 }
@@ -225,17 +237,51 @@ void MoaMcpDevice::writePin(uint8_t pin, bool value) {
         return;
     }
     
-    _mcp.digitalWrite(pin, value ? HIGH : LOW);
+    uint8_t bit = 1 << (pin % 8);
+    _regs.setBits(MCP23018_REG_OLATA + pin / 8, bit, value ? bit : 0);
+    _regs.commit();
     
     releaseMutex();
 }
 
 bool MoaMcpDevice::readPin(uint8_t pin) {
+    return (readPort(pin / 8) & (1 << (pin % 8))) != 0;
+}
+
+uint32_t MoaMcpDevice::getTransactionCount() const {
+    return _regs.getTransactionCount();
+}
+
+uint32_t MoaMcpDevice::getTransactionsPerSecond() {
+    uint32_t now = millis();
+    uint32_t elapsed = now - _rateWindowStartMs;
+    
+    if (elapsed >= 1000) {
+        uint32_t count = _regs.getTransactionCount();
+        _transactionsPerSecond = (uint32_t)(((uint64_t)(count - _rateWindowCount) * 1000) / elapsed);
+        _rateWindowStartMs = now;
+        _rateWindowCount = count;
+    }
+    return _transactionsPerSecond;
+}
+
+uint32_t MoaMcpDevice::getSkippedWrites() const {
+    return _regs.getSkippedWrites();
+}
+
+void MoaMcpDevice::stagePinMode(uint8_t port, uint8_t mask, uint8_t mode) {
+    bool pullup = (mode == INPUT_PULLUP) || ((mode & PULLUP) != 0);
+    _regs.setBits(MCP23018_REG_IODIRA + port, mask, (mode == OUTPUT) ? 0x00 : mask);
+    _regs.setBits(MCP23018_REG_GPPUA + port, mask, pullup ? mask : 0x00);
+}
+
+uint8_t MoaMcpDevice::readPort(uint8_t port) {
     if (!acquireMutex()) {
-        return false;
+        return 0;
     }
     
-    bool value = _mcp.digitalRead(pin) == HIGH;
+    uint8_t value = 0;
+    _regs.read(MCP23018_REG_GPIOA + port, &value, 1);
     
     releaseMutex();
     return value;
@@ -7,10 +7,11 @@
 
 #include "MoaTempControl.h"
 #include "esp_log.h"
+#include "MoaLatencyTrace.h"
 
 static const char* TAG = "Temp";
 
-MoaTempControl::MoaTempControl(QueueHandle_t eventQueue, uint8_t pin,
+MoaTempControl::MoaTempControl(MoaEventChannel* eventQueue, uint8_t pin,
                                uint8_t numSamples)
     : _eventQueue(eventQueue)
     , _statsQueue(nullptr)
@@ -19,22 +20,13 @@ MoaTempControl::MoaTempControl(QueueHandle_t eventQueue, uint8_t pin,
     , _targetTemp(0.0f)
     , _currentTemp(0.0f)
     , _hysteresis(0.0f)
+    , _targetCentiC(0)
+    , _hysteresisCentiC(0)
     , _state(MoaTempState::BELOW_TARGET)
-    , _samples(nullptr)
-    , _numSamples(0)
-    , _sampleIndex(0)
-    , _sampleCount(0)
-    , _averagedTemp(0.0f)
+    , _filter(numSamples)
+    , _averagedCentiC(0)
     , _updateCount(0)
 {
-    setNumSamples(numSamples);
-}
-
-MoaTempControl::~MoaTempControl() {
-    if (_samples != nullptr) {
-        delete[] _samples;
-        _samples = nullptr;
-    }
 }
 
 void MoaTempControl::setSensor(ITemperatureSensor* sensor) {
@@ -66,13 +58,13 @@ void MoaTempControl::update() {
         return;
     }
     
-    // Add sample to circular buffer and update average
-    addSample(_currentTemp);
+    // Add sample to circular buffer and update average (the only float op per reading)
+    addSample(moaToFixedUnits(_currentTemp, 100));
     
     // Periodic log (1 in 10 readings)
     if (++_updateCount % 10 == 0) {
         ESP_LOGI(TAG, "T=%.1fC avg=%.1fC state=%s",
-                 _currentTemp, _averagedTemp,
+                 _currentTemp, getAveragedTemp(),
                  _state == MoaTempState::ABOVE_TARGET ? "ABOVE" : "BELOW");
     }
     
@@ -85,25 +77,26 @@ void MoaTempControl::update() {
     }
     
     // Calculate thresholds
-    float upperThreshold = _targetTemp;
-    float lowerThreshold = _targetTemp - _hysteresis;
+    int32_t upperThreshold = _targetCentiC;
+    int32_t lowerThreshold = _targetCentiC - _hysteresisCentiC;
     
     // Check for state transitions and push event
-    if (_state == MoaTempState::BELOW_TARGET && _averagedTemp >= upperThreshold) {
+    if (_state == MoaTempState::BELOW_TARGET && _averagedCentiC >= upperThreshold) {
         // Crossed UP above target
         _state = MoaTempState::ABOVE_TARGET;
-        ESP_LOGW(TAG, "State -> ABOVE_TARGET (avg=%.1fC, target=%.1fC)", _averagedTemp, _targetTemp);
+        ESP_LOGW(TAG, "State -> ABOVE_TARGET (avg=%.1fC, target=%.1fC)", getAveragedTemp(), _targetTemp);
         pushTempEvent(COMMAND_TEMP_CROSSED_ABOVE);
-    } else if (_state == MoaTempState::ABOVE_TARGET && _averagedTemp <= lowerThreshold) {
+    } else if (_state == MoaTempState::ABOVE_TARGET && _averagedCentiC <= lowerThreshold) {
         // Crossed DOWN below (target - hysteresis)
         _state = MoaTempState::BELOW_TARGET;
-        ESP_LOGI(TAG, "State -> BELOW_TARGET (avg=%.1fC, lower=%.1fC)", _averagedTemp, lowerThreshold);
+        ESP_LOGI(TAG, "State -> BELOW_TARGET (avg=%.1fC, lower=%.1fC)", getAveragedTemp(), _targetTemp - _hysteresis);
         pushTempEvent(COMMAND_TEMP_CROSSED_BELOW);
     }
 }
 
 void MoaTempControl::setTargetTemp(float temp) {
     _targetTemp = temp;
+    _targetCentiC = moaToFixedUnits(temp, 100);
 }
 
 float MoaTempControl::getTargetTemp() const {
@@ -112,6 +105,7 @@ float MoaTempControl::getTargetTemp() const {
 
 void MoaTempControl::setHysteresis(float hysteresis) {
     _hysteresis = (hysteresis > 0.0f) ? hysteresis : 0.0f;
+    _hysteresisCentiC = moaToFixedUnits(_hysteresis, 100);
 }
 
 float MoaTempControl::getHysteresis() const {
@@ -123,7 +117,11 @@ float MoaTempControl::getCurrentTemp() const {
 }
 
 float MoaTempControl::getAveragedTemp() const {
-    return _averagedTemp;
+    return _averagedCentiC / 100.0f;
+}
+
+int32_t MoaTempControl::getAveragedTempCentiC() const {
+    return _averagedCentiC;
 }
 
 MoaTempState MoaTempControl::getState() const {
@@ -131,70 +129,22 @@ MoaTempState MoaTempControl::getState() const {
 }
 
 bool MoaTempControl::isAveragingReady() const {
-    return _sampleCount >= _numSamples;
+    return _filter.isFull();
 }
 
 void MoaTempControl::setNumSamples(uint8_t numSamples) {
-    // Clamp to valid range
-    if (numSamples < 1) {
-        numSamples = 1;
-    } else if (numSamples > MOA_TEMP_MAX_SAMPLES) {
-        numSamples = MOA_TEMP_MAX_SAMPLES;
-    }
-    
-    // Free existing buffer if any
-    if (_samples != nullptr) {
-        delete[] _samples;
-    }
-    
-    // Allocate new buffer
-    _numSamples = numSamples;
-    _samples = new float[_numSamples];
-    
-    // Reset buffer state
-    _sampleIndex = 0;
-    _sampleCount = 0;
-    _averagedTemp = 0.0f;
-    
-    // Initialize buffer to zero
-    for (uint8_t i = 0; i < _numSamples; i++) {
-        _samples[i] = 0.0f;
-    }
+    // Clamped to 1..MOA_TEMP_MAX_SAMPLES by the filter; resets the window
+    _filter.setWindow(numSamples);
+    _averagedCentiC = 0;
 }
 
 uint8_t MoaTempControl::getNumSamples() const {
-    return _numSamples;
+    return _filter.window();
 }
 
-void MoaTempControl::addSample(float temp) {
-    if (_samples == nullptr) {
-        return;
-    }
-    
-    // Add sample to circular buffer
-    _samples[_sampleIndex] = temp;
-    _sampleIndex = (_sampleIndex + 1) % _numSamples;
-    
-    // Track how many samples we have
-    if (_sampleCount < _numSamples) {
-        _sampleCount++;
-    }
-    
-    // Update cached average
-    _averagedTemp = calculateAverage();
-}
-
-float MoaTempControl::calculateAverage() const {
-    if (_sampleCount == 0 || _samples == nullptr) {
-        return 0.0f;
-    }
-    
-    float sum = 0.0f;
-    for (uint8_t i = 0; i < _sampleCount; i++) {
-        sum += _samples[i];
-    }
-    
-    return sum / static_cast<float>(_sampleCount);
+void MoaTempControl::addSample(int32_t tempCentiC) {
+    _filter.push(tempCentiC);
+    _averagedCentiC = _filter.average();
 }
 
 void MoaTempControl::pushTempEvent(int commandType) {
@@ -202,16 +152,14 @@ void MoaTempControl::pushTempEvent(int commandType) {
         return;
     }
 
-    ControlCommand cmd;
-    cmd.controlType = CONTROL_TYPE_TEMPERATURE;
-    cmd.commandType = commandType;
-    // Send temperature as int (x10 for one decimal precision, e.g., 25.5°C = 255)
-    cmd.value = static_cast<int>(_averagedTemp * 10.0f);
+    // Send temperature x10 for one decimal precision, e.g., 25.5°C = 255
+    TempEvent event(static_cast<uint8_t>(commandType), static_cast<int16_t>(moaDivRound(_averagedCentiC, 10)));
 
-    xQueueSend(_eventQueue, &cmd, 0);  // Don't block if queue is full
+    MOA_LATENCY_MARK_FROM(MOA_HOP_SENSOR_SAMPLE, MOA_HOP_PUSH);
+    _eventQueue->push(event);  // Never blocks; drops are counted per producer
 }
 
-void MoaTempControl::setEventQueue(QueueHandle_t eventQueue) {
+void MoaTempControl::setEventQueue(MoaEventChannel* eventQueue) {
     _eventQueue = eventQueue;
 }
 
@@ -226,7 +174,7 @@ void MoaTempControl::pushStatsReading() {
 
     StatsReading reading;
     reading.statsType = STATS_TYPE_TEMPERATURE;
-    reading.value = static_cast<int32_t>(_averagedTemp * 10.0f);
+    reading.value = moaDivRound(_averagedCentiC, 10);
     reading.timestamp = millis();
 
     xQueueSend(_statsQueue, &reading, 0);  // Don't block if queue is full
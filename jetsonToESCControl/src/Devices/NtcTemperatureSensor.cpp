@@ -10,50 +10,29 @@
 
 static const char* TAG = "NtcSensor";
 
-NtcTemperatureSensor::NtcTemperatureSensor(uint8_t pin,
-                                           float referenceResistance,
-                                           float nominalResistance,
-                                           float nominalTempC,
-                                           float betaCoefficient,
-                                           uint16_t adcVrefMv)
+NtcTemperatureSensor::NtcTemperatureSensor(uint8_t pin)
     : _pin(pin)
-    , _referenceResistance(referenceResistance)
-    , _nominalResistance(nominalResistance)
-    , _nominalTempC(nominalTempC)
-    , _betaCoefficient(betaCoefficient)
-    , _adcVrefMv(adcVrefMv)
-    , _thermistor(nullptr)
 {
 }
 
-NtcTemperatureSensor::~NtcTemperatureSensor() {
-    if (_thermistor != nullptr) {
-        delete _thermistor;
-        _thermistor = nullptr;
-    }
+void NtcTemperatureSensor::begin() {
+    // analogReadMilliVolts() attaches the pin to the ADC on first use
+    ESP_LOGI(TAG, "NTC sensor begin on pin %d (Rref=%.0f, Rnom=%.0f, Tnom=%.0f, Beta=%.0f, Vref=%umV, %u-entry table)",
+             _pin, NTC_REFERENCE_RESISTANCE, NTC_NOMINAL_RESISTANCE, NTC_NOMINAL_TEMP_C,
+             NTC_BETA_COEFFICIENT, (unsigned)NTC_ADC_VREF_MV, (unsigned)MOA_NTC_TABLE_SIZE);
 }
 
-void NtcTemperatureSensor::begin() {
-    if (_thermistor != nullptr) {
-        delete _thermistor;
+int32_t NtcTemperatureSensor::readCentiCelsius() {
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < NTC_OVERSAMPLING; i++) {
+        sum += analogReadMilliVolts(_pin);
     }
-    _thermistor = new NTC_Thermistor_ESP32(
-        _pin,
-        _referenceResistance,
-        _nominalResistance,
-        _nominalTempC,
-        _betaCoefficient,
-        _adcVrefMv
-    );
-    ESP_LOGI(TAG, "NTC sensor begin on pin %d (Rref=%.0f, Rnom=%.0f, Tnom=%.0f, Beta=%.0f, Vref=%umV)",
-             _pin, _referenceResistance, _nominalResistance, _nominalTempC, _betaCoefficient, _adcVrefMv);
+    // Sum of N reads -> mV x 16 (N is a power of two up to 16)
+    return moaNtcCentiCelsius(sum * ((1U << MOA_NTC_MV_FRAC_BITS) / NTC_OVERSAMPLING));
 }
 
 bool NtcTemperatureSensor::readCelsius(float& outCelsius) {
-    if (_thermistor == nullptr) {
-        return false;
-    }
-    // Single blocking ADC read + math — always ready, no state machine needed.
-    outCelsius = static_cast<float>(_thermistor->readCelsius());
+    // Blocking ADC reads + table lookup — always ready, no state machine needed.
+    outCelsius = readCentiCelsius() / 100.0f;
     return true;
 }
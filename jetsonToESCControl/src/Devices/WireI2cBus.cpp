@@ -0,0 +1,48 @@
+/**
+ * @file WireI2cBus.cpp
+ * @brief Implementation of the WireI2cBus class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "WireI2cBus.h"
+
+WireI2cBus::WireI2cBus(TwoWire* wire)
+    : _wire(wire)
+{
+}
+
+void WireI2cBus::setWire(TwoWire* wire) {
+    _wire = wire;
+}
+
+bool WireI2cBus::writeRegisters(uint8_t address, uint8_t reg, const uint8_t* data, size_t length) {
+    if (_wire == nullptr) {
+        return false;
+    }
+    _wire->beginTransmission(address);
+    _wire->write(reg);
+    if (length > 0 && _wire->write(data, length) != length) {
+        _wire->endTransmission();
+        return false;
+    }
+    return _wire->endTransmission() == 0;
+}
+
+bool WireI2cBus::readRegisters(uint8_t address, uint8_t reg, uint8_t* data, size_t length) {
+    if (_wire == nullptr) {
+        return false;
+    }
+    _wire->beginTransmission(address);
+    _wire->write(reg);
+    if (_wire->endTransmission(false) != 0) {     // Repeated start, keep the bus
+        return false;
+    }
+    if (_wire->requestFrom(address, static_cast<uint8_t>(length)) != length) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        data[i] = static_cast<uint8_t>(_wire->read());
+    }
+    return true;
+}
@@ -9,13 +9,28 @@
 #include "MoaBattControl.h"
 #include "MoaCurrentControl.h"
 #include "MoaTempControl.h"
+#include "MoaDs18b20Bus.h"
 #include "ESCController.h"
+#include "MoaTelemetry.h"
+#include "MoaStatsAggregator.h"
 #include "ControlCommand.h"
 #include "esp_log.h"
+#include <string.h>
 
 static const char* TAG = "Config";
 
-ConfigManager::ConfigManager() {
+/**
+ * @brief NVS keys of the DS18B20 ROM bound to each role
+ */
+static const char* const PROBE_ROM_KEYS[TEMP_PROBE_MAX_COUNT] = {
+    "temp_rom_esc", "temp_rom_mot", "temp_rom_bat"
+};
+
+ConfigManager::ConfigManager()
+    : energyLifetimeMah(0)
+    , energyLifetimeMwh(0)
+{
+    memset(tempProbeRoms, 0, sizeof(tempProbeRoms));  // Wiring, not a setting: kept by reset
     loadDefaults();
 }
 
@@ -35,17 +50,34 @@ void ConfigManager::loadDefaults() {
     escAfterFullThrottle = ESC_AFTER_FULL_THROTTLE_MODE;
     escRampRate     = ESC_RAMP_RATE;
 
+    // Ramp shapes
+    escShape25      = static_cast<MoaRampShape>(ESC_RAMP_SHAPE_DEFAULT);
+    escShape50      = static_cast<MoaRampShape>(ESC_RAMP_SHAPE_DEFAULT);
+    escShape75      = static_cast<MoaRampShape>(ESC_RAMP_SHAPE_DEFAULT);
+    escShape100     = static_cast<MoaRampShape>(ESC_RAMP_SHAPE_DEFAULT);
+    escShapeAfterFullThrottle = static_cast<MoaRampShape>(ESC_RAMP_SHAPE_DEFAULT);
+    escRampCurvature = ESC_RAMP_CURVATURE;
+
     // Battery
     battHigh        = BATT_THRESHOLD_HIGH;
     battMedium      = BATT_THRESHOLD_MEDIUM;
     battLow         = BATT_THRESHOLD_LOW;
     battStop        = BATT_THRESHOLD_STOP;
     battHysteresis  = BATT_HYSTERESIS;
+    battCapacityMah = BATT_CAPACITY_MAH;
+    battFull        = BATT_FULL_VOLTAGE;
+    battCompensation = BATT_COMPENSATION_DEFAULT;
+    battResistanceMohm = BATT_RESISTANCE_MOHM;
+    battMaxSagMv = BATT_COMP_MAX_SAG_MV;
 
     // Temperature
     tempTarget      = TEMP_THRESHOLD_TARGET;
     tempHysteresis  = TEMP_HYSTERESIS;
     tempSensorType  = static_cast<TempSensorType>(TEMP_SENSOR_TYPE_DEFAULT);
+    tempProbeMode   = TEMP_PROBE_MODE_DEFAULT;
+    tempProbeBits[TEMP_PROBE_ESC]     = TEMP_PROBE_RES_ESC;
+    tempProbeBits[TEMP_PROBE_MOTOR]   = TEMP_PROBE_RES_MOTOR;
+    tempProbeBits[TEMP_PROBE_BATTERY] = TEMP_PROBE_RES_BATTERY;
 
     // Current
     currentOvercurrent = CURRENT_THRESHOLD_OVERCURRENT;
@@ -59,6 +91,13 @@ void ConfigManager::loadDefaults() {
     wifiPassword[sizeof(wifiPassword) - 1] = '\0';
     strncpy(otaHostname, OTA_HOSTNAME, sizeof(otaHostname) - 1);
     otaHostname[sizeof(otaHostname) - 1] = '\0';
+
+    // Telemetry
+    telemetryPeriodMs = TELEMETRY_PERIOD_MS;
+    telemetrySink     = TELEMETRY_SINK_DEFAULT;
+    strncpy(telemetryHost, TELEMETRY_UDP_HOST, sizeof(telemetryHost) - 1);
+    telemetryHost[sizeof(telemetryHost) - 1] = '\0';
+    telemetryPort     = TELEMETRY_UDP_PORT;
 }
 
 void ConfigManager::begin() {
@@ -83,17 +122,39 @@ void ConfigManager::begin() {
     escAfterFullThrottle = prefs.getUShort("esc_after", prefs.getUShort("esc_after_full", ESC_AFTER_FULL_THROTTLE_MODE));
     escRampRate      = prefs.getFloat("esc_ramp",    ESC_RAMP_RATE);
 
+    // Ramp shapes
+    escShape25       = loadShape(prefs, "esc_sh25");
+    escShape50       = loadShape(prefs, "esc_sh50");
+    escShape75       = loadShape(prefs, "esc_sh75");
+    escShape100      = loadShape(prefs, "esc_sh100");
+    escShapeAfterFullThrottle = loadShape(prefs, "esc_sh_after");
+    escRampCurvature = MoaRampProfile::clampCurvature(prefs.getFloat("esc_curve", ESC_RAMP_CURVATURE));
+
     // Battery
     battHigh         = prefs.getFloat("batt_high",   BATT_THRESHOLD_HIGH);
     battMedium       = prefs.getFloat("batt_med",    BATT_THRESHOLD_MEDIUM);
     battLow          = prefs.getFloat("batt_low",    BATT_THRESHOLD_LOW);
     battStop         = prefs.getFloat("batt_stop",   BATT_THRESHOLD_STOP);
     battHysteresis   = prefs.getFloat("batt_hyst",   BATT_HYSTERESIS);
+    battCapacityMah  = prefs.getULong("batt_cap",    BATT_CAPACITY_MAH);
+    battFull         = prefs.getFloat("batt_full",   BATT_FULL_VOLTAGE);
+    battCompensation = prefs.getUChar("batt_comp",   BATT_COMPENSATION_DEFAULT);
+    battResistanceMohm = prefs.getUShort("batt_rint", BATT_RESISTANCE_MOHM);
+    battMaxSagMv = prefs.getUShort("batt_sag",   BATT_COMP_MAX_SAG_MV);
 
     // Temperature
     tempTarget       = prefs.getFloat("temp_tgt",    TEMP_THRESHOLD_TARGET);
     tempHysteresis   = prefs.getFloat("temp_hyst",   TEMP_HYSTERESIS);
     tempSensorType   = static_cast<TempSensorType>(prefs.getUChar("temp_sens", TEMP_SENSOR_TYPE_DEFAULT));
+    tempProbeMode    = prefs.getUChar("temp_conv",    TEMP_PROBE_MODE_DEFAULT);
+    tempProbeBits[TEMP_PROBE_ESC]     = prefs.getUChar("temp_res_esc", TEMP_PROBE_RES_ESC);
+    tempProbeBits[TEMP_PROBE_MOTOR]   = prefs.getUChar("temp_res_mot", TEMP_PROBE_RES_MOTOR);
+    tempProbeBits[TEMP_PROBE_BATTERY] = prefs.getUChar("temp_res_bat", TEMP_PROBE_RES_BATTERY);
+    for (uint8_t role = 0; role < TEMP_PROBE_MAX_COUNT; role++) {
+        if (prefs.getBytes(PROBE_ROM_KEYS[role], tempProbeRoms[role], ONEWIRE_ROM_BYTES) != ONEWIRE_ROM_BYTES) {
+            memset(tempProbeRoms[role], 0, ONEWIRE_ROM_BYTES);
+        }
+    }
 
     // Current
     currentOvercurrent = prefs.getFloat("curr_oc",   CURRENT_THRESHOLD_OVERCURRENT);
@@ -111,16 +172,37 @@ void ConfigManager::begin() {
     strncpy(otaHostname, host.c_str(), sizeof(otaHostname) - 1);
     otaHostname[sizeof(otaHostname) - 1] = '\0';
 
+    // Telemetry
+    telemetryPeriodMs = prefs.getUShort("tlm_ms",    TELEMETRY_PERIOD_MS);
+    telemetrySink     = prefs.getUChar("tlm_sink",   TELEMETRY_SINK_DEFAULT);
+    String tlmHost = prefs.getString("tlm_host",     TELEMETRY_UDP_HOST);
+    strncpy(telemetryHost, tlmHost.c_str(), sizeof(telemetryHost) - 1);
+    telemetryHost[sizeof(telemetryHost) - 1] = '\0';
+    telemetryPort     = prefs.getUShort("tlm_port",  TELEMETRY_UDP_PORT);
+
+    // Lifetime energy
+    energyLifetimeMah = prefs.getLong("nrg_mah", 0);
+    energyLifetimeMwh = prefs.getLong("nrg_mwh", 0);
+
     prefs.end();
 
     ESP_LOGI(TAG, "Settings loaded from NVS");
     ESP_LOGD(TAG, "  Batt: high=%.2fV, med=%.2fV, low=%.2fV, stop=%.2fV, hyst=%.2fV", battHigh, battMedium, battLow, battStop, battHysteresis);
     ESP_LOGD(TAG, "  Temp: target=%.1fC, hyst=%.1fC, sensor=%s", tempTarget, tempHysteresis,
              tempSensorType == TempSensorType::NTC ? "NTC" : "DS18B20");
+    ESP_LOGD(TAG, "  Probes: %s, esc=%u motor=%u batt=%u bits",
+             tempProbeMode != 0 ? "staggered" : "broadcast", tempProbeBits[TEMP_PROBE_ESC],
+             tempProbeBits[TEMP_PROBE_MOTOR], tempProbeBits[TEMP_PROBE_BATTERY]);
     ESP_LOGD(TAG, "  Current: OC=%.1fA, rev=%.1fA, hyst=%.1fA", currentOvercurrent, currentReverse, currentHysteresis);
     ESP_LOGD(TAG, "  WiFi: SSID=%s, host=%s", wifiSsid, otaHostname);
+    ESP_LOGD(TAG, "  Telemetry: period=%ums, sink=%s, udp=%s:%u", telemetryPeriodMs,
+             telemetrySink == 1 ? "udp" : "link", telemetryHost, telemetryPort);
     ESP_LOGD(TAG, "  ESC: eco=%u, paddle=%u, break=%u, full=%u, after_full=%u, ramp=%.1f%%/s",
              escEcoMode, escPaddleMode, escBreakingMode, escFullThrottle, escAfterFullThrottle, escRampRate);
+    ESP_LOGD(TAG, "  Shapes: 25=%s, 50=%s, 75=%s, 100=%s, after_full=%s, curve=%.1f",
+             MoaRampProfile::shapeName(escShape25), MoaRampProfile::shapeName(escShape50),
+             MoaRampProfile::shapeName(escShape75), MoaRampProfile::shapeName(escShape100),
+             MoaRampProfile::shapeName(escShapeAfterFullThrottle), escRampCurvature);
     ESP_LOGD(TAG, "  Timers: t25=%lums, t50=%lums, t75=%lums, t100=%lums, t_after_full=%lums",
              escTime25, escTime50, escTime75, escTime100, escTimeAfterFullThrottle);
 }
@@ -149,17 +231,37 @@ bool ConfigManager::save() {
     ok &= (prefs.putUShort("esc_after", escAfterFullThrottle) > 0);
     ok &= (prefs.putFloat("esc_ramp",    escRampRate)      > 0);
 
+    // Ramp shapes
+    ok &= (prefs.putUChar("esc_sh25",    static_cast<uint8_t>(escShape25))  > 0);
+    ok &= (prefs.putUChar("esc_sh50",    static_cast<uint8_t>(escShape50))  > 0);
+    ok &= (prefs.putUChar("esc_sh75",    static_cast<uint8_t>(escShape75))  > 0);
+    ok &= (prefs.putUChar("esc_sh100",   static_cast<uint8_t>(escShape100)) > 0);
+    ok &= (prefs.putUChar("esc_sh_after", static_cast<uint8_t>(escShapeAfterFullThrottle)) > 0);
+    ok &= (prefs.putFloat("esc_curve",   escRampCurvature) > 0);
+
     // Battery
     ok &= (prefs.putFloat("batt_high",   battHigh)         > 0);
     ok &= (prefs.putFloat("batt_med",    battMedium)       > 0);
     ok &= (prefs.putFloat("batt_low",    battLow)          > 0);
     ok &= (prefs.putFloat("batt_stop",   battStop)         > 0);
     ok &= (prefs.putFloat("batt_hyst",   battHysteresis)   > 0);
+    ok &= (prefs.putULong("batt_cap",    battCapacityMah)  > 0);
+    ok &= (prefs.putFloat("batt_full",   battFull)         > 0);
+    ok &= (prefs.putUChar("batt_comp",   battCompensation) > 0);
+    ok &= (prefs.putUShort("batt_rint",  battResistanceMohm) > 0);
+    ok &= (prefs.putUShort("batt_sag",   battMaxSagMv) > 0);
 
     // Temperature
     ok &= (prefs.putFloat("temp_tgt",    tempTarget)       > 0);
     ok &= (prefs.putFloat("temp_hyst",   tempHysteresis)   > 0);
     ok &= (prefs.putUChar("temp_sens",   static_cast<uint8_t>(tempSensorType)) > 0);
+    ok &= (prefs.putUChar("temp_conv",   tempProbeMode)    > 0);
+    ok &= (prefs.putUChar("temp_res_esc", tempProbeBits[TEMP_PROBE_ESC])     > 0);
+    ok &= (prefs.putUChar("temp_res_mot", tempProbeBits[TEMP_PROBE_MOTOR])   > 0);
+    ok &= (prefs.putUChar("temp_res_bat", tempProbeBits[TEMP_PROBE_BATTERY]) > 0);
+    for (uint8_t role = 0; role < TEMP_PROBE_MAX_COUNT; role++) {
+        ok &= (prefs.putBytes(PROBE_ROM_KEYS[role], tempProbeRoms[role], ONEWIRE_ROM_BYTES) > 0);
+    }
 
     // Current
     ok &= (prefs.putFloat("curr_oc",     currentOvercurrent) > 0);
@@ -171,6 +273,12 @@ bool ConfigManager::save() {
     ok &= (prefs.putString("wifi_pass",  wifiPassword) > 0);
     ok &= (prefs.putString("ota_host",   otaHostname)  > 0);
 
+    // Telemetry (an empty host writes 0 bytes, which is not a failure)
+    ok &= (prefs.putUShort("tlm_ms",     telemetryPeriodMs) > 0);
+    ok &= (prefs.putUChar("tlm_sink",    telemetrySink)     > 0);
+    prefs.putString("tlm_host",          telemetryHost);
+    ok &= (prefs.putUShort("tlm_port",   telemetryPort)     > 0);
+
     prefs.end();
 
     if (ok) {
@@ -187,14 +295,41 @@ void ConfigManager::resetToDefaults() {
     ESP_LOGI(TAG, "Settings reset to defaults");
 }
 
+bool ConfigManager::saveEnergy(int32_t mah, int32_t mwh) {
+    Preferences prefs;
+    if (!prefs.begin(CONFIG_NVS_NAMESPACE, false)) {  // read-write
+        ESP_LOGE(TAG, "NVS open for write failed");
+        return false;
+    }
+
+    bool ok = (prefs.putLong("nrg_mah", mah) > 0);
+    ok &= (prefs.putLong("nrg_mwh", mwh) > 0);
+    prefs.end();
+
+    if (ok) {
+        energyLifetimeMah = mah;
+        energyLifetimeMwh = mwh;
+        ESP_LOGD(TAG, "Lifetime energy saved: %ld mAh, %ld mWh", (long)mah, (long)mwh);
+    } else {
+        ESP_LOGE(TAG, "Lifetime energy save failed");
+    }
+    return ok;
+}
+
 void ConfigManager::applyTo(MoaBattControl& batt, MoaCurrentControl& current,
-                            MoaTempControl& temp, ESCController& esc) {
+                            MoaTempControl& temp, MoaDs18b20Bus& probes, ESCController& esc,
+                            MoaTelemetryStream& telemetry, MoaStatsAggregator& stats) {
     // Battery configuration (medium = zone between high and low)
     batt.setDividerRatio(BATT_DIVIDER_RATIO);
     batt.setHighThreshold(battHigh);
     batt.setLowThreshold(battLow);
     batt.setStopThreshold(battStop);
     batt.setHysteresis(battHysteresis);
+    batt.setLoadCompensation(battCompensation != 0);
+    batt.setInitialResistance(battResistanceMohm);
+    batt.setMaxSag(battMaxSagMv);
+    stats.setBattery(battCapacityMah, static_cast<uint16_t>(battFull * 1000.0f + 0.5f),
+                     static_cast<uint16_t>(battStop * 1000.0f + 0.5f));
 
     // Current sensor configuration
     current.setSensitivity(CURRENT_SENSOR_SENSITIVITY);
@@ -202,20 +337,32 @@ void ConfigManager::applyTo(MoaBattControl& batt, MoaCurrentControl& current,
     current.setOvercurrentThreshold(currentOvercurrent);
     current.setReverseOvercurrentThreshold(currentReverse);
     current.setHysteresis(currentHysteresis);
+    current.setFastTripThreshold(CURRENT_FAST_TRIP_THRESHOLD);
+    current.setFastTripReverseThreshold(CURRENT_FAST_TRIP_REVERSE);
+    current.getFastTrip().setBlankingSamples(CURRENT_FAST_TRIP_BLANKING_SAMPLES);
+    current.getFastTrip().setTripCount(CURRENT_FAST_TRIP_COUNT);
 
     // Temperature configuration
     temp.setTargetTemp(tempTarget);
     temp.setHysteresis(tempHysteresis);
+    probes.setMode(tempProbeMode != 0 ? MoaProbeMode::STAGGERED : MoaProbeMode::BROADCAST);
+    for (uint8_t probe = 0; probe < TEMP_PROBE_MAX_COUNT; probe++) {
+        probes.setResolution(probe, tempProbeBits[probe]);
+    }
 
     // ESC configuration
     esc.setRampRate(escRampRate);
+    esc.setRampCurvature(escRampCurvature);
+
+    // Telemetry (the sink and UDP destination are read by TelemetryTask per batch)
+    telemetry.setPeriod(telemetryPeriodMs);
 
     ESP_LOGI(TAG, "Configuration applied to devices");
     ESP_LOGD(TAG, "  Batt: high=%.2fV, med=%.2fV, low=%.2fV, stop=%.2fV, hyst=%.2fV", battHigh, battMedium, battLow, battStop, battHysteresis);
     ESP_LOGD(TAG, "  WiFi: SSID=%s, host=%s", wifiSsid, otaHostname);
     ESP_LOGD(TAG, "  Current: OC=%.1fA, rev=%.1fA, hyst=%.1fA", currentOvercurrent, currentReverse, currentHysteresis);
     ESP_LOGD(TAG, "  Temp: target=%.1fC, hyst=%.1fC", tempTarget, tempHysteresis);
-    ESP_LOGD(TAG, "  ESC ramp: %.1f%%/s", escRampRate);
+    ESP_LOGD(TAG, "  ESC ramp: %.1f%%/s, curve=%.1f", escRampRate, escRampCurvature);
 }
 
 uint16_t ConfigManager::throttleLevel(uint8_t commandType) const {
@@ -237,3 +384,22 @@ uint32_t ConfigManager::throttleTimeout(uint8_t commandType) const {
         default: return 0;
     }
 }
+
+MoaRampShape ConfigManager::throttleShape(uint8_t commandType) const {
+    switch (commandType) {
+        case COMMAND_BUTTON_25:  return escShape25;
+        case COMMAND_BUTTON_50:  return escShape50;
+        case COMMAND_BUTTON_75:  return escShape75;
+        case COMMAND_BUTTON_100: return escShape100;
+        default: return MoaRampShape::LINEAR;
+    }
+}
+
+MoaRampShape ConfigManager::loadShape(Preferences& prefs, const char* key) {
+    uint8_t shape = prefs.getUChar(key, ESC_RAMP_SHAPE_DEFAULT);
+    if (shape >= MOA_RAMP_SHAPE_COUNT) {
+        ESP_LOGW(TAG, "Invalid ramp shape %u for %s, using default", shape, key);
+        shape = ESC_RAMP_SHAPE_DEFAULT;
+    }
+    return static_cast<MoaRampShape>(shape);
+}
@@ -0,0 +1,196 @@
+/**
+ * @file MoaAdcSampler.cpp
+ * @brief Implementation of the MoaAdcSampler class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaAdcSampler.h"
+
+static_assert((MOA_ADC_BLOCK_CAPACITY & (MOA_ADC_BLOCK_CAPACITY - 1)) == 0,
+              "MOA_ADC_BLOCK_CAPACITY must be a power of two");
+
+MoaAdcSampler::MoaAdcSampler(IAdcSampleSource* source)
+    : _source(source)
+    , _numChannels(0)
+    , _oversampling(1)
+    , _sampleRateHz(10000)
+    , _running(false)
+{
+    for (uint8_t i = 0; i < MOA_ADC_MAX_CHANNELS; i++) {
+        resetChannel(_channels[i]);
+        _channels[i].pin = 0;
+        _channels[i].trip = nullptr;
+    }
+}
+
+void MoaAdcSampler::setSource(IAdcSampleSource* source) {
+    _source = source;
+}
+
+int8_t MoaAdcSampler::addChannel(uint8_t pin) {
+    if (_running || _numChannels >= MOA_ADC_MAX_CHANNELS) {
+        return -1;
+    }
+    Channel& ch = _channels[_numChannels];
+    resetChannel(ch);
+    ch.pin = pin;
+    ch.trip = nullptr;
+    return static_cast<int8_t>(_numChannels++);
+}
+
+void MoaAdcSampler::setTripMonitor(uint8_t slot, MoaOvercurrentTrip* trip) {
+    if (slot < _numChannels) {
+        _channels[slot].trip = trip;
+    }
+}
+
+void MoaAdcSampler::setSampleRate(uint32_t sampleRateHz) {
+    _sampleRateHz = (sampleRateHz > 0) ? sampleRateHz : 1;
+}
+
+void MoaAdcSampler::setOversampling(uint8_t factor) {
+    if (factor < 1) {
+        factor = 1;
+    } else if (factor > MOA_ADC_MAX_OVERSAMPLING) {
+        factor = MOA_ADC_MAX_OVERSAMPLING;
+    }
+    _oversampling = factor;
+}
+
+uint8_t MoaAdcSampler::getOversampling() const {
+    return _oversampling;
+}
+
+bool MoaAdcSampler::begin() {
+    if (_source == nullptr || _numChannels == 0) {
+        return false;
+    }
+
+    uint8_t pins[MOA_ADC_MAX_CHANNELS];
+    for (uint8_t i = 0; i < _numChannels; i++) {
+        pins[i] = _channels[i].pin;
+        resetChannel(_channels[i]);
+    }
+
+    _running = _source->begin(pins, _numChannels, _sampleRateHz);
+    return _running;
+}
+
+void MoaAdcSampler::stop() {
+    if (_running && _source != nullptr) {
+        _source->stop();
+    }
+    _running = false;
+}
+
+bool MoaAdcSampler::isRunning() const {
+    return _running;
+}
+
+size_t MoaAdcSampler::poll() {
+    if (!_running) {
+        return 0;
+    }
+
+    MoaAdcRawSample chunk[MOA_ADC_READ_CHUNK];
+    size_t total = 0;
+    size_t n;
+
+    // Drain everything buffered so far; the source never blocks
+    do {
+        n = _source->read(chunk, MOA_ADC_READ_CHUNK);
+        for (size_t i = 0; i < n; i++) {
+            accept(chunk[i]);
+        }
+        total += n;
+    } while (n == MOA_ADC_READ_CHUNK);
+
+    return total;
+}
+
+size_t MoaAdcSampler::takeBlock(uint8_t slot, uint16_t* out, size_t maxCount) {
+    if (slot >= _numChannels || out == nullptr) {
+        return 0;
+    }
+
+    Channel& ch = _channels[slot];
+    size_t n;
+
+    for (;;) {
+        uint32_t written = ch.written.load(std::memory_order_acquire);
+        uint32_t available = written - ch.read;
+        if (available > MOA_ADC_BLOCK_CAPACITY) {
+            // The producer lapped us: the oldest samples were overwritten
+            ch.overruns += available - MOA_ADC_BLOCK_CAPACITY;
+            ch.read = written - MOA_ADC_BLOCK_CAPACITY;
+            available = MOA_ADC_BLOCK_CAPACITY;
+        }
+
+        n = (available < maxCount) ? available : maxCount;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = ch.block[(ch.read + i) % MOA_ADC_BLOCK_CAPACITY];
+        }
+
+        // If poll() preempted the copy and lapped the ring, copy again
+        if (ch.written.load(std::memory_order_acquire) - ch.read <= MOA_ADC_BLOCK_CAPACITY) {
+            break;
+        }
+    }
+
+    ch.read += n;
+    return n;
+}
+
+uint32_t MoaAdcSampler::getOverrunCount(uint8_t slot) const {
+    return (slot < _numChannels) ? _channels[slot].overruns : 0;
+}
+
+uint32_t MoaAdcSampler::getRawSampleCount(uint8_t slot) const {
+    return (slot < _numChannels) ? _channels[slot].rawCount : 0;
+}
+
+uint8_t MoaAdcSampler::getChannelCount() const {
+    return _numChannels;
+}
+
+void MoaAdcSampler::accept(const MoaAdcRawSample& sample) {
+    for (uint8_t i = 0; i < _numChannels; i++) {
+        Channel& ch = _channels[i];
+        if (ch.pin != sample.pin) {
+            continue;
+        }
+
+        ch.rawCount++;
+        if (ch.trip != nullptr) {
+            ch.trip->feed(sample.raw);
+        }
+
+        ch.accumulator += sample.raw;
+        if (++ch.accumulated >= _oversampling) {
+            // Rounded boxcar average of the window
+            uint16_t value = static_cast<uint16_t>((ch.accumulator + _oversampling / 2) / _oversampling);
+            pushDecimated(ch, value);
+            ch.accumulator = 0;
+            ch.accumulated = 0;
+        }
+        return;
+    }
+}
+
+void MoaAdcSampler::pushDecimated(Channel& ch, uint16_t value) {
+    // Always write: when full this overwrites the oldest sample, which the
+    // consumer detects (and counts) from the counter distance in takeBlock()
+    uint32_t written = ch.written.load(std::memory_order_relaxed);
+    ch.block[written % MOA_ADC_BLOCK_CAPACITY] = value;
+    ch.written.store(written + 1, std::memory_order_release);
+}
+
+void MoaAdcSampler::resetChannel(Channel& ch) {
+    ch.accumulator = 0;
+    ch.accumulated = 0;
+    ch.written.store(0, std::memory_order_relaxed);
+    ch.read = 0;
+    ch.overruns = 0;
+    ch.rawCount = 0;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file MoaBattResistance.cpp
+ * @brief Implementation of the MoaBattResistance class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaBattResistance.h"
+
+static uint32_t clampMohm(int64_t milliohm) {
+    if (milliohm < BATT_RESISTANCE_MIN_MOHM) {
+        return BATT_RESISTANCE_MIN_MOHM;
+    }
+    if (milliohm > BATT_RESISTANCE_MAX_MOHM) {
+        return BATT_RESISTANCE_MAX_MOHM;
+    }
+    return static_cast<uint32_t>(milliohm);
+}
+
+static int32_t absDiff(int32_t a, int32_t b) {
+    return (a > b) ? a - b : b - a;
+}
+
+MoaBattResistance::MoaBattResistance()
+    : _requestedMohm(BATT_RESISTANCE_MOHM)
+    , _initialMohm(BATT_RESISTANCE_MOHM)
+    , _maxSagMv(BATT_COMP_MAX_SAG_MV)
+    , _resistanceMohm(BATT_RESISTANCE_MOHM)
+    , _steps(0)
+    , _rejected(0)
+{
+    reset();
+}
+
+void MoaBattResistance::reset() {
+    // The starting value weighs as much as one minimum step
+    _sumDiDi = static_cast<int64_t>(BATT_STEP_MIN_MA) * BATT_STEP_MIN_MA;
+    _sumDiDv = -_sumDiDi * _initialMohm / 1000;
+
+    _lastMa = 0;
+    _steadySinceMs = 0;
+    _haveLast = false;
+    _refMv = 0;
+    _refMa = 0;
+    _refMs = 0;
+    _haveRef = false;
+
+    _resistanceMohm.store(_initialMohm, std::memory_order_relaxed);
+    _steps.store(0, std::memory_order_relaxed);
+    _rejected.store(0, std::memory_order_relaxed);
+}
+
+void MoaBattResistance::setInitialResistance(uint32_t milliohm) {
+    _requestedMohm.store(clampMohm(milliohm), std::memory_order_relaxed);
+}
+
+void MoaBattResistance::setMaxSag(uint32_t millivolts) {
+    _maxSagMv.store(millivolts, std::memory_order_relaxed);
+}
+
+uint32_t MoaBattResistance::getMaxSag() const {
+    return _maxSagMv.load(std::memory_order_relaxed);
+}
+
+bool MoaBattResistance::isLearned() const {
+    return _steps.load(std::memory_order_relaxed) >= BATT_COMP_MIN_STEPS;
+}
+
+bool MoaBattResistance::update(int32_t voltageMv, int32_t currentMa, uint32_t nowMs) {
+    uint32_t requested = _requestedMohm.load(std::memory_order_relaxed);
+    if (requested != _initialMohm) {
+        _initialMohm = requested;
+        reset();
+    }
+
+    if (!_haveLast || absDiff(currentMa, _lastMa) > BATT_STEP_STEADY_MA) {
+        _steadySinceMs = nowMs;  // Still moving
+    }
+    _lastMa = currentMa;
+    _haveLast = true;
+
+    if (nowMs - _steadySinceMs < BATT_STEP_SETTLE_MS) {
+        return false;
+    }
+
+    // Settled: either the far end of a step, or a fresher reference
+    bool stepped = false;
+    if (_haveRef && absDiff(currentMa, _refMa) >= BATT_STEP_MIN_MA &&
+        nowMs - _refMs <= BATT_STEP_MAX_SPAN_MS) {
+        addStep(voltageMv - _refMv, currentMa - _refMa);
+        stepped = true;
+    }
+
+    _refMv = voltageMv;
+    _refMa = currentMa;
+    _refMs = nowMs;
+    _haveRef = true;
+    return stepped;
+}
+
+void MoaBattResistance::addStep(int32_t dv, int32_t di) {
+    // This step alone: R = -dV / dI
+    int64_t stepMohm = -static_cast<int64_t>(dv) * 1000 / di;
+    if (stepMohm < BATT_RESISTANCE_MIN_MOHM || stepMohm > BATT_RESISTANCE_MAX_MOHM) {
+        _rejected.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    _sumDiDi -= _sumDiDi / BATT_STEP_MEMORY;
+    _sumDiDv -= _sumDiDv / BATT_STEP_MEMORY;
+    _sumDiDi += static_cast<int64_t>(di) * di;
+    _sumDiDv += static_cast<int64_t>(di) * dv;
+
+    _resistanceMohm.store(clampMohm(-_sumDiDv * 1000 / _sumDiDi), std::memory_order_relaxed);
+    _steps.fetch_add(1, std::memory_order_relaxed);
+}
+
+int32_t MoaBattResistance::openCircuitMv(int32_t voltageMv, int32_t currentMa) const {
+    if (!isLearned()) {
+        return voltageMv;  // The configured resistance is only a guess
+    }
+
+    int64_t dropMv = static_cast<int64_t>(currentMa) * _resistanceMohm.load(std::memory_order_relaxed) / 1000;
+    int64_t maxMv = _maxSagMv.load(std::memory_order_relaxed);
+    if (dropMv > maxMv) {
+        dropMv = maxMv;
+    } else if (dropMv < -maxMv) {
+        dropMv = -maxMv;  // Regen: the terminal rises, bounded the same way
+    }
+    return voltageMv + static_cast<int32_t>(dropMv);
+}
+
+uint32_t MoaBattResistance::getResistanceMilliohm() const {
+    return _resistanceMohm.load(std::memory_order_relaxed);
+}
+
+uint32_t MoaBattResistance::getStepCount() const {
+    return _steps.load(std::memory_order_relaxed);
+}
+
+uint32_t MoaBattResistance::getRejectedCount() const {
+    return _rejected.load(std::memory_order_relaxed);
+}
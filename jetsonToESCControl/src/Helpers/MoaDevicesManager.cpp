@@ -19,6 +19,7 @@ MoaDevicesManager::MoaDevicesManager(MoaLedControl& leds, ESCController& esc, Mo
     , _wifiManager(wifiManager)
     , _otaManager(otaManager)
     , _eventQueue(nullptr)
+    , _overcurrentTrip(nullptr)
     , _lastBattLevel(MoaBattLevel::BATT_HIGH)
     , _lastOverheat(false)
     , _lastOvercurrent(false)
@@ -26,22 +27,15 @@ MoaDevicesManager::MoaDevicesManager(MoaLedControl& leds, ESCController& esc, Mo
     , _wifiConnectAnimTask(nullptr)
     , _wifiConnectAnimating(false)
 {
-    memset(_timers, 0, sizeof(_timers));
 }
 
 MoaDevicesManager::~MoaDevicesManager() {
-    for (int i = 0; i < MOA_TIMER_MAX_INSTANCES; i++) {
-        if (_timers[i] != nullptr) {
-            delete _timers[i];
-            _timers[i] = nullptr;
-        }
-    }
 }
 
 // === ESC Control ===
 
-void MoaDevicesManager::setThrottleLevel(uint16_t duty) {
-    _esc.setThrottleDuty(duty);
+void MoaDevicesManager::setThrottleLevel(uint16_t duty, MoaRampShape shape) {
+    _esc.setThrottleDuty(duty, shape);
 }
 
 void MoaDevicesManager::stopMotor() {
@@ -54,14 +48,15 @@ void MoaDevicesManager::armESC() {
     _esc.stop();
 }
 
-void MoaDevicesManager::updateESC() {
-    _esc.updateThrottle();
-}
-
 void MoaDevicesManager::engageThrottle(uint8_t commandType) {
     stopTimer(TIMER_ID_THROTTLE);
     stopTimer(TIMER_ID_FULL_THROTTLE);
-    setThrottleLevel(_config.throttleLevel(commandType));
+
+    // Ride through motor start inrush without tripping the fast path
+    if (_overcurrentTrip != nullptr) {
+        _overcurrentTrip->blank();
+    }
+    setThrottleLevel(_config.throttleLevel(commandType), _config.throttleShape(commandType));
 
     if (commandType == COMMAND_BUTTON_100) {
         startTimer(TIMER_ID_FULL_THROTTLE, _config.escTime100);
@@ -80,18 +75,44 @@ void MoaDevicesManager::disengageThrottle() {
 }
 
 void MoaDevicesManager::handleThrottleStepDown() {
-    setThrottleLevel(_config.escAfterFullThrottle);
+    setThrottleLevel(_config.escAfterFullThrottle, _config.escShapeAfterFullThrottle);
     startTimer(TIMER_ID_THROTTLE, _config.escTimeAfterFullThrottle);
 }
 
+void MoaDevicesManager::setRemoteThrottle(uint16_t duty) {
+    stopTimer(TIMER_ID_FULL_THROTTLE);
+
+    // Blank the fast path for a motor start only: setpoints stream in while running
+    if (_overcurrentTrip != nullptr && _esc.isStopped()) {
+        _overcurrentTrip->blank();
+    }
+    setThrottleLevel(duty);
+    startTimer(TIMER_ID_THROTTLE, MOA_LINK_WATCHDOG_MS);
+}
+
+// === Fast Overcurrent Protection ===
+
+void MoaDevicesManager::setOvercurrentTrip(MoaOvercurrentTrip* trip) {
+    _overcurrentTrip = trip;
+}
+
+void MoaDevicesManager::resetOvercurrentTrip() {
+    if (_overcurrentTrip != nullptr && _overcurrentTrip->isTripped()) {
+        ESP_LOGI(TAG, "Fast overcurrent trip re-armed");
+        _overcurrentTrip->arm();
+    }
+    _esc.clearTrip();
+}
+
 // === Timer Management ===
 
-void MoaDevicesManager::setEventQueue(QueueHandle_t queue) {
+void MoaDevicesManager::setEventQueue(MoaEventChannel* queue) {
     _eventQueue = queue;
+    _timers.begin(queue);
 }
 
 bool MoaDevicesManager::startTimer(uint8_t timerId, uint32_t durationMs) {
-    if (timerId >= MOA_TIMER_MAX_INSTANCES) {
+    if (timerId >= MOA_TIMER_WHEEL_CAPACITY) {
         ESP_LOGW(TAG, "startTimer: invalid timerId=%d", timerId);
         return false;
     }
@@ -100,33 +121,20 @@ bool MoaDevicesManager::startTimer(uint8_t timerId, uint32_t durationMs) {
         return false;
     }
 
-    // Lazy-create the timer on first use
-    if (_timers[timerId] == nullptr) {
-        _timers[timerId] = new MoaTimer(_eventQueue, timerId);
-    }
-
-    _timers[timerId]->start(durationMs);
-    return true;
+    return _timers.start(timerId, durationMs);
 }
 
 bool MoaDevicesManager::stopTimer(uint8_t timerId) {
-    if (timerId >= MOA_TIMER_MAX_INSTANCES) {
+    if (timerId >= MOA_TIMER_WHEEL_CAPACITY) {
         ESP_LOGW(TAG, "stopTimer: invalid timerId=%d", timerId);
         return false;
     }
-    if (_timers[timerId] == nullptr) {
-        return true;  // Already stopped/non-existent
-    }
 
-    _timers[timerId]->stop();
-    return true;
+    return _timers.stop(timerId);
 }
 
 bool MoaDevicesManager::isTimerRunning(uint8_t timerId) const {
-    if (timerId >= MOA_TIMER_MAX_INSTANCES || _timers[timerId] == nullptr) {
-        return false;
-    }
-    return _timers[timerId]->isRunning();
+    return _timers.isRunning(timerId);
 }
 
 // === LED Indicators ===
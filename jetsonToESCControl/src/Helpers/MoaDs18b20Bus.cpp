@@ -0,0 +1,385 @@
+/**
+ * @file MoaDs18b20Bus.cpp
+ * @brief Implementation of the MoaDs18b20Bus class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaDs18b20Bus.h"
+#include <string.h>
+
+// Factory alarm thresholds, kept if a probe's scratchpad cannot be read
+static const uint8_t DEFAULT_TH = 0x4B;
+static const uint8_t DEFAULT_TL = 0x46;
+
+static uint8_t clampBits(uint8_t bits) {
+    return (bits < 9) ? 9 : (bits > 12) ? 12 : bits;
+}
+
+uint8_t moaOneWireCrc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t byte = data[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            uint8_t mix = (crc ^ byte) & 0x01;
+            crc >>= 1;
+            if (mix) {
+                crc ^= 0x8C;                        // x^8 + x^5 + x^4 + 1, reflected
+            }
+            byte >>= 1;
+        }
+    }
+    return crc;
+}
+
+uint32_t moaDs18b20ConversionMs(uint8_t bits) {
+    // 750 ms at 12 bits, halved per bit less (93.75 ms rounded up at 9)
+    return (750U >> (12 - clampBits(bits))) + (clampBits(bits) == 9 ? 1 : 0);
+}
+
+bool moaDs18b20Decode(const uint8_t scratch[DS18B20_SCRATCH_BYTES], int32_t* centiC) {
+    if (moaOneWireCrc8(scratch, DS18B20_SCRATCH_BYTES - 1) != scratch[DS18B20_SCRATCH_BYTES - 1]) {
+        return false;
+    }
+    // Config: 0 R1 R0 1 1 1 1 1 (an all-zero scratchpad passes the CRC, not this)
+    if ((scratch[4] & 0x9F) != 0x1F) {
+        return false;
+    }
+    uint8_t bits = static_cast<uint8_t>(9 + ((scratch[4] >> 5) & 0x03));
+    int16_t raw = static_cast<int16_t>((scratch[1] << 8) | scratch[0]);
+    raw = static_cast<int16_t>(raw & ~((1 << (12 - bits)) - 1));
+
+    // 1/16 degC to centi-degC, rounded half away from zero
+    int32_t scaled = static_cast<int32_t>(raw) * 25;
+    *centiC = (scaled + (scaled >= 0 ? 2 : -2)) / 4;
+    return true;
+}
+
+const char* moaProbeRoleName(uint8_t role) {
+    static const char* const names[TEMP_PROBE_MAX_COUNT] = { "esc", "motor", "battery" };
+    return (role < TEMP_PROBE_MAX_COUNT) ? names[role] : "?";
+}
+
+MoaDs18b20Bus::MoaDs18b20Bus(IOneWireBus* bus)
+    : _bus(bus)
+    , _count(0)
+    , _bound(0)
+    , _missing(0)
+    , _configured(0)
+    , _foundCount(0)
+    , _converting(0)
+    , _fresh(0)
+    , _nextRead(0)
+    , _nextStart(0)
+    , _parasite(false)
+    , _mode(TEMP_PROBE_MODE_DEFAULT)
+    , _transactions(0)
+{
+    static const uint8_t defaultBits[TEMP_PROBE_MAX_COUNT] = {
+        TEMP_PROBE_RES_ESC, TEMP_PROBE_RES_MOTOR, TEMP_PROBE_RES_BATTERY
+    };
+    memset(_roleRoms, 0, sizeof(_roleRoms));
+    memset(_roms, 0, sizeof(_roms));
+    memset(_found, 0, sizeof(_found));
+    memset(_foundRole, -1, sizeof(_foundRole));
+    for (uint8_t i = 0; i < TEMP_PROBE_MAX_COUNT; i++) {
+        _alarms[i][0] = DEFAULT_TH;
+        _alarms[i][1] = DEFAULT_TL;
+        _bits[i] = 12;                              // Power-on default
+        _startMs[i] = 0;
+        _requestedBits[i].store(clampBits(defaultBits[i]), std::memory_order_relaxed);
+        _lastCentiC[i].store(TEMP_PROBE_DISCONNECTED_C * 100, std::memory_order_relaxed);
+        _reads[i].store(0, std::memory_order_relaxed);
+        _errors[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void MoaDs18b20Bus::setRoleRom(uint8_t role, const uint8_t* rom) {
+    if (role >= TEMP_PROBE_MAX_COUNT) {
+        return;
+    }
+    static const uint8_t none[ONEWIRE_ROM_BYTES] = { 0 };
+    if (rom == nullptr || memcmp(rom, none, ONEWIRE_ROM_BYTES) == 0) {
+        memset(_roleRoms[role], 0, ONEWIRE_ROM_BYTES);
+        _configured &= static_cast<uint8_t>(~(1U << role));
+        return;
+    }
+    memcpy(_roleRoms[role], rom, ONEWIRE_ROM_BYTES);
+    _configured |= static_cast<uint8_t>(1U << role);
+}
+
+const uint8_t* MoaDs18b20Bus::getRoleRom(uint8_t role) const {
+    return (role < TEMP_PROBE_MAX_COUNT && (_configured & (1U << role))) ? _roleRoms[role] : nullptr;
+}
+
+uint8_t MoaDs18b20Bus::begin() {
+    _count = 0;
+    _bound = 0;
+    _missing = 0;
+    _foundCount = 0;
+    _converting = 0;
+    _fresh = 0;
+    _nextRead = 0;
+    _nextStart = 0;
+    _parasite = false;
+    memset(_foundRole, -1, sizeof(_foundRole));
+    _transactions.store(0, std::memory_order_relaxed);
+    if (_bus == nullptr) {
+        _missing = _configured;
+        return 0;
+    }
+
+    // The only search: every later access is addressed by the cached ROM
+    uint8_t rom[ONEWIRE_ROM_BYTES];
+    _bus->resetSearch();
+    while (_foundCount < DS18B20_SEARCH_MAX && _bus->search(rom)) {
+        if (moaOneWireCrc8(rom, ONEWIRE_ROM_BYTES - 1) != rom[ONEWIRE_ROM_BYTES - 1]) {
+            continue;
+        }
+        if (rom[0] != DS18B20_FAMILY && rom[0] != DS1822_FAMILY) {
+            continue;
+        }
+        memcpy(_found[_foundCount], rom, ONEWIRE_ROM_BYTES);
+        _foundCount++;
+    }
+
+    // Roles follow the configured ROMs, not the search order
+    for (uint8_t role = 0; role < TEMP_PROBE_MAX_COUNT; role++) {
+        if (!(_configured & (1U << role))) {
+            continue;
+        }
+        uint8_t f = 0;
+        while (f < _foundCount && memcmp(_found[f], _roleRoms[role], ONEWIRE_ROM_BYTES) != 0) {
+            f++;
+        }
+        if (f < _foundCount && _foundRole[f] < 0) {
+            bind(role, f);
+        } else {
+            _missing |= static_cast<uint8_t>(1U << role);
+        }
+    }
+
+    // A lone probe on an unconfigured bus can only be the ESC's; once any
+    // ROM is configured an unknown probe is never guessed into a role
+    if (_configured == 0 && _foundCount == 1) {
+        bind(TEMP_PROBE_ESC, 0);
+    }
+    if (_count == 0) {
+        return 0;
+    }
+
+    // Parasite-powered probes pull the read slots low
+    uint8_t power = 0xFF;
+    _transactions.fetch_add(1, std::memory_order_relaxed);
+    _parasite = _bus->transaction(nullptr, DS18B20_CMD_READ_POWER, nullptr, 0, &power, 1, false) &&
+                (power & 0x01) == 0;
+
+    // Keep the alarm thresholds, set the resolution (scratchpad RAM only)
+    for (uint8_t i = 0; i < TEMP_PROBE_MAX_COUNT; i++) {
+        if (!isBound(i)) {
+            continue;
+        }
+        uint8_t scratch[DS18B20_SCRATCH_BYTES];
+        int32_t ignored;
+        _transactions.fetch_add(1, std::memory_order_relaxed);
+        if (_bus->transaction(_roms[i], DS18B20_CMD_READ_SCRATCH, nullptr, 0,
+                              scratch, sizeof(scratch), false) &&
+            moaDs18b20Decode(scratch, &ignored)) {
+            _alarms[i][0] = scratch[2];
+            _alarms[i][1] = scratch[3];
+            _bits[i] = static_cast<uint8_t>(9 + ((scratch[4] >> 5) & 0x03));
+        }
+        uint8_t bits = _requestedBits[i].load(std::memory_order_relaxed);
+        if (bits != _bits[i]) {
+            writeConfig(i, bits);
+        }
+    }
+    return _count;
+}
+
+bool MoaDs18b20Bus::poll(uint32_t nowMs) {
+    if (_count == 0) {
+        return false;
+    }
+
+    // A parasite-powered bus is held high until the conversions are done
+    if (_parasite && _converting != 0) {
+        for (uint8_t i = 0; i < TEMP_PROBE_MAX_COUNT; i++) {
+            if ((_converting & (1U << i)) && !isDue(i, nowMs)) {
+                return false;
+            }
+        }
+    }
+
+    // 1. Read a finished conversion
+    for (uint8_t k = 0; k < TEMP_PROBE_MAX_COUNT; k++) {
+        uint8_t i = static_cast<uint8_t>((_nextRead + k) % TEMP_PROBE_MAX_COUNT);
+        if (isDue(i, nowMs)) {
+            readProbe(i);
+            _nextRead = static_cast<uint8_t>((i + 1) % TEMP_PROBE_MAX_COUNT);
+            return true;
+        }
+    }
+
+    // 2. Apply a resolution change to an idle probe
+    for (uint8_t i = 0; i < TEMP_PROBE_MAX_COUNT; i++) {
+        uint8_t bits = _requestedBits[i].load(std::memory_order_relaxed);
+        if (isBound(i) && !(_converting & (1U << i)) && bits != _bits[i]) {
+            writeConfig(i, bits);
+            return false;
+        }
+    }
+
+    // 3. Start conversions
+    if (static_cast<MoaProbeMode>(_mode.load(std::memory_order_relaxed)) == MoaProbeMode::BROADCAST) {
+        if (_converting == 0) {
+            startConversion(nullptr);
+            for (uint8_t i = 0; i < TEMP_PROBE_MAX_COUNT; i++) {
+                _startMs[i] = nowMs;
+            }
+            _converting = _bound;
+        }
+        return false;
+    }
+
+    if (_parasite && _converting != 0) {
+        return false;                               // One at a time on parasite power
+    }
+    for (uint8_t k = 0; k < TEMP_PROBE_MAX_COUNT; k++) {
+        uint8_t i = static_cast<uint8_t>((_nextStart + k) % TEMP_PROBE_MAX_COUNT);
+        if (isBound(i) && !(_converting & (1U << i))) {
+            // A probe that misses the command still gets its read, which reports it
+            startConversion(_roms[i]);
+            _startMs[i] = nowMs;
+            _converting |= static_cast<uint8_t>(1U << i);
+            _nextStart = static_cast<uint8_t>((i + 1) % TEMP_PROBE_MAX_COUNT);
+            break;
+        }
+    }
+    return false;
+}
+
+bool MoaDs18b20Bus::takeReading(uint8_t probe, int32_t* centiC) {
+    if (!isBound(probe) || !(_fresh & (1U << probe))) {
+        return false;
+    }
+    _fresh &= static_cast<uint8_t>(~(1U << probe));
+    *centiC = _lastCentiC[probe].load(std::memory_order_relaxed);
+    return true;
+}
+
+void MoaDs18b20Bus::setMode(MoaProbeMode mode) {
+    _mode.store(static_cast<uint8_t>(mode), std::memory_order_relaxed);
+}
+
+MoaProbeMode MoaDs18b20Bus::getMode() const {
+    return static_cast<MoaProbeMode>(_mode.load(std::memory_order_relaxed));
+}
+
+void MoaDs18b20Bus::setResolution(uint8_t probe, uint8_t bits) {
+    if (probe < TEMP_PROBE_MAX_COUNT) {
+        _requestedBits[probe].store(clampBits(bits), std::memory_order_relaxed);
+    }
+}
+
+uint8_t MoaDs18b20Bus::getResolution(uint8_t probe) const {
+    return (probe < TEMP_PROBE_MAX_COUNT) ? _requestedBits[probe].load(std::memory_order_relaxed) : 0;
+}
+
+uint8_t MoaDs18b20Bus::getProbeCount() const {
+    return _count;
+}
+
+const uint8_t* MoaDs18b20Bus::getRom(uint8_t probe) const {
+    return isBound(probe) ? _roms[probe] : nullptr;
+}
+
+bool MoaDs18b20Bus::isMissing(uint8_t probe) const {
+    return probe < TEMP_PROBE_MAX_COUNT && (_missing & (1U << probe));
+}
+
+uint8_t MoaDs18b20Bus::getFoundCount() const {
+    return _foundCount;
+}
+
+const uint8_t* MoaDs18b20Bus::getFoundRom(uint8_t index) const {
+    return (index < _foundCount) ? _found[index] : nullptr;
+}
+
+int8_t MoaDs18b20Bus::getFoundRole(uint8_t index) const {
+    return (index < _foundCount) ? _foundRole[index] : -1;
+}
+
+bool MoaDs18b20Bus::isParasite() const {
+    return _parasite;
+}
+
+int32_t MoaDs18b20Bus::getLastCentiC(uint8_t probe) const {
+    return (probe < TEMP_PROBE_MAX_COUNT) ? _lastCentiC[probe].load(std::memory_order_relaxed)
+                                          : TEMP_PROBE_DISCONNECTED_C * 100;
+}
+
+uint32_t MoaDs18b20Bus::getReadCount(uint8_t probe) const {
+    return (probe < TEMP_PROBE_MAX_COUNT) ? _reads[probe].load(std::memory_order_relaxed) : 0;
+}
+
+uint32_t MoaDs18b20Bus::getErrorCount(uint8_t probe) const {
+    return (probe < TEMP_PROBE_MAX_COUNT) ? _errors[probe].load(std::memory_order_relaxed) : 0;
+}
+
+uint32_t MoaDs18b20Bus::getTransactionCount() const {
+    return _transactions.load(std::memory_order_relaxed);
+}
+
+bool MoaDs18b20Bus::isBound(uint8_t probe) const {
+    return probe < TEMP_PROBE_MAX_COUNT && (_bound & (1U << probe));
+}
+
+void MoaDs18b20Bus::bind(uint8_t probe, uint8_t found) {
+    memcpy(_roms[probe], _found[found], ONEWIRE_ROM_BYTES);
+    _foundRole[found] = static_cast<int8_t>(probe);
+    _bound |= static_cast<uint8_t>(1U << probe);
+    _count++;
+}
+
+bool MoaDs18b20Bus::isDue(uint8_t probe, uint32_t nowMs) const {
+    return (_converting & (1U << probe)) &&
+           nowMs - _startMs[probe] >= moaDs18b20ConversionMs(_bits[probe]);
+}
+
+void MoaDs18b20Bus::readProbe(uint8_t probe) {
+    uint8_t scratch[DS18B20_SCRATCH_BYTES];
+    int32_t centiC = TEMP_PROBE_DISCONNECTED_C * 100;
+
+    _transactions.fetch_add(1, std::memory_order_relaxed);
+    if (_bus->transaction(_roms[probe], DS18B20_CMD_READ_SCRATCH, nullptr, 0,
+                          scratch, sizeof(scratch), false) &&
+        moaDs18b20Decode(scratch, &centiC)) {
+        _reads[probe].fetch_add(1, std::memory_order_relaxed);
+    } else {
+        centiC = TEMP_PROBE_DISCONNECTED_C * 100;
+        _errors[probe].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    _lastCentiC[probe].store(centiC, std::memory_order_relaxed);
+    _fresh |= static_cast<uint8_t>(1U << probe);
+    _converting &= static_cast<uint8_t>(~(1U << probe));
+}
+
+bool MoaDs18b20Bus::writeConfig(uint8_t probe, uint8_t bits) {
+    uint8_t data[3] = { _alarms[probe][0], _alarms[probe][1],
+                        static_cast<uint8_t>(((bits - 9) << 5) | 0x1F) };
+    _transactions.fetch_add(1, std::memory_order_relaxed);
+    bool ok = _bus->transaction(_roms[probe], DS18B20_CMD_WRITE_SCRATCH, data, sizeof(data),
+                                nullptr, 0, false);
+    if (!ok) {
+        _errors[probe].fetch_add(1, std::memory_order_relaxed);
+    }
+    _bits[probe] = bits;                            // Not retried: the next read reports a lost probe
+    return ok;
+}
+
+bool MoaDs18b20Bus::startConversion(const uint8_t* rom) {
+    _transactions.fetch_add(1, std::memory_order_relaxed);
+    return _bus->transaction(rom, DS18B20_CMD_CONVERT, nullptr, 0, nullptr, 0, _parasite);
+}
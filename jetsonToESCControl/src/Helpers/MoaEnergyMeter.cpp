@@ -0,0 +1,155 @@
+/**
+ * @file MoaEnergyMeter.cpp
+ * @brief Implementation of the MoaEnergyMeter class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaEnergyMeter.h"
+
+/**
+ * @brief Accumulator units per mAh: (A x10, two ends) x ms
+ *
+ * 1 mAh = 3600000 mA x ms = 36000 (A x10) x ms, doubled by the trapezoid.
+ */
+static const int64_t CHARGE_UNITS_PER_MAH = 72000LL;
+
+/**
+ * @brief Accumulator units per mWh: (A x10, two ends) x mV x ms
+ */
+static const int64_t ENERGY_UNITS_PER_MWH = 72000000LL;
+
+/**
+ * @brief Scale of the rolling power average: 1/16 mW units (4 fractional bits)
+ */
+static const int64_t POWER_SCALE = 1 << 4;
+
+static int32_t divRound64(int64_t value, int64_t divisor) {
+    return static_cast<int32_t>((value >= 0) ? (value + divisor / 2) / divisor
+                                             : (value - divisor / 2) / divisor);
+}
+
+MoaEnergyMeter::MoaEnergyMeter()
+    : _capacityMah(BATT_CAPACITY_MAH)
+    , _fullMv(static_cast<uint32_t>(BATT_FULL_VOLTAGE * 1000.0f + 0.5f))
+    , _emptyMv(static_cast<uint32_t>(BATT_THRESHOLD_STOP * 1000.0f + 0.5f))
+    , _baseMah(0)
+    , _baseMwh(0)
+{
+    reset();
+}
+
+void MoaEnergyMeter::reset() {
+    _chargeAcc = 0;
+    _energyAcc = 0;
+    _avgPowerMw16 = 0;
+    _integratedMs = 0;
+    _battMv = 0;
+    _lastCurrentX10 = 0;
+    _lastCurrentMs = 0;
+    _haveBatt = false;
+    _haveCurrent = false;
+    _initialSoc = 0;
+    _savedMah = 0;
+    _savedMs = 0;
+}
+
+void MoaEnergyMeter::setBattery(uint32_t capacityMah, uint16_t fullMv, uint16_t emptyMv) {
+    _capacityMah.store(capacityMah, std::memory_order_relaxed);
+    _fullMv.store(fullMv, std::memory_order_relaxed);
+    _emptyMv.store(emptyMv, std::memory_order_relaxed);
+}
+
+void MoaEnergyMeter::setLifetime(int32_t mah, int32_t mwh) {
+    _baseMah = mah;
+    _baseMwh = mwh;
+}
+
+void MoaEnergyMeter::add(const StatsReading& reading) {
+    if (reading.statsType == STATS_TYPE_BATTERY) {
+        _battMv = reading.value;
+        if (!_haveBatt) {
+            // Linear between empty and full: a rough start, the counter does the rest
+            int32_t fullMv = static_cast<int32_t>(_fullMv.load(std::memory_order_relaxed));
+            int32_t emptyMv = static_cast<int32_t>(_emptyMv.load(std::memory_order_relaxed));
+            int32_t soc = 0;
+            if (fullMv > emptyMv) {
+                soc = static_cast<int32_t>(static_cast<int64_t>(reading.value - emptyMv) * 1000 / (fullMv - emptyMv));
+            }
+            _initialSoc = static_cast<uint16_t>((soc < 0) ? 0 : (soc > 1000) ? 1000 : soc);
+            _haveBatt = true;
+        }
+        return;
+    }
+    if (reading.statsType != STATS_TYPE_CURRENT) {
+        return;
+    }
+
+    uint32_t t = reading.timestamp;
+    if (_haveCurrent && _haveBatt) {
+        uint32_t dt = t - _lastCurrentMs;
+        if (dt > 0 && dt <= STATS_ENERGY_MAX_GAP_MS) {
+            int64_t sumX10 = static_cast<int64_t>(_lastCurrentX10) + reading.value;
+            _chargeAcc += sumX10 * dt;
+            _energyAcc += sumX10 * _battMv * dt;
+
+            // mW = mV x A = mV x (sum / 2) / 10
+            int64_t powerMw16 = sumX10 * _battMv * POWER_SCALE / 20;
+            if (_integratedMs == 0) {
+                _avgPowerMw16 = powerMw16;
+            } else {
+                uint32_t weight = (dt < ENERGY_POWER_WINDOW_MS) ? dt : ENERGY_POWER_WINDOW_MS;
+                _avgPowerMw16 += (powerMw16 - _avgPowerMw16) * weight / ENERGY_POWER_WINDOW_MS;
+            }
+            _integratedMs += dt;
+        }
+    }
+
+    _lastCurrentX10 = reading.value;
+    _lastCurrentMs = t;
+    _haveCurrent = true;
+}
+
+MoaEnergyReport MoaEnergyMeter::getReport() const {
+    MoaEnergyReport report;
+    report.sessionMah = divRound64(_chargeAcc, CHARGE_UNITS_PER_MAH);
+    report.sessionMwh = divRound64(_energyAcc, ENERGY_UNITS_PER_MWH);
+    report.lifetimeMah = _baseMah + report.sessionMah;
+    report.lifetimeMwh = _baseMwh + report.sessionMwh;
+    report.avgPowerMw = divRound64(_avgPowerMw16, POWER_SCALE);
+    report.reserved = 0;
+    report.integratedMs = _integratedMs;
+    report.socPermille = MOA_ENERGY_SOC_UNKNOWN;
+    report.remainingS = MOA_ENERGY_TIME_UNKNOWN;
+
+    uint32_t capacityMah = _capacityMah.load(std::memory_order_relaxed);
+    if (!_haveBatt || capacityMah == 0) {
+        return report;
+    }
+
+    int64_t soc = _initialSoc - _chargeAcc * 1000 / (CHARGE_UNITS_PER_MAH * capacityMah);
+    soc = (soc < 0) ? 0 : (soc > 1000) ? 1000 : soc;
+    report.socPermille = static_cast<uint16_t>(soc);
+
+    if (report.avgPowerMw >= ENERGY_MIN_POWER_MW) {
+        // Remaining charge at the nominal (mid) voltage, not the sagging one
+        int64_t nominalMv = (static_cast<int64_t>(_fullMv.load(std::memory_order_relaxed)) +
+                             _emptyMv.load(std::memory_order_relaxed)) / 2;
+        int64_t remainingMwh = soc * capacityMah * nominalMv / 1000000;
+        report.remainingS = static_cast<uint32_t>(remainingMwh * 3600 / report.avgPowerMw);
+    }
+    return report;
+}
+
+bool MoaEnergyMeter::isSaveDue(uint32_t nowMs) const {
+    int32_t moved = divRound64(_chargeAcc, CHARGE_UNITS_PER_MAH) - _savedMah;
+    if (moved < 0) {
+        moved = -moved;
+    }
+    return moved >= ENERGY_SAVE_MIN_MAH && nowMs - _savedMs >= ENERGY_SAVE_INTERVAL_MS;
+}
+
+void MoaEnergyMeter::markSaved(uint32_t nowMs) {
+    _savedMah = divRound64(_chargeAcc, CHARGE_UNITS_PER_MAH);
+    _savedMs = nowMs;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file MoaEscRamp.cpp
+ * @brief Implementation of the MoaEscRamp class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaEscRamp.h"
+#include <math.h>
+
+MoaRampProfile::MoaRampProfile() {
+    build(MoaRampShape::LINEAR, 0.0f);
+}
+
+void MoaRampProfile::build(MoaRampShape shape, float curvature) {
+    curvature = clampCurvature(curvature);
+    if (shape == MoaRampShape::EXPO && !(curvature > ESC_RAMP_CURVATURE_MIN)) {
+        shape = MoaRampShape::LINEAR;   // e^(c*t) flattens to a line as c -> 0
+    }
+    _shape = shape;
+
+    float expoScale = (shape == MoaRampShape::EXPO) ? 1.0f / (expf(curvature) - 1.0f) : 0.0f;
+    for (uint8_t i = 0; i <= MOA_RAMP_PROFILE_SEGMENTS; i++) {
+        float t = static_cast<float>(i) / MOA_RAMP_PROFILE_SEGMENTS;
+        float f;
+        switch (shape) {
+            case MoaRampShape::SCURVE:
+                f = t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+                break;
+            case MoaRampShape::EXPO:
+                f = (expf(curvature * t) - 1.0f) * expoScale;
+                break;
+            default:
+                f = t;
+                break;
+        }
+        _table[i] = static_cast<uint16_t>(lroundf(f * ONE));
+    }
+    // Exact end points whatever the float rounding
+    _table[0] = 0;
+    _table[MOA_RAMP_PROFILE_SEGMENTS] = ONE;
+}
+
+MoaRampShape MoaRampProfile::getShape() const {
+    return _shape;
+}
+
+bool MoaRampProfile::isLinear() const {
+    return _shape == MoaRampShape::LINEAR;
+}
+
+uint16_t MoaRampProfile::at(uint16_t done, uint16_t steps) const {
+    if (done >= steps) {
+        return ONE;
+    }
+    // Position in the table with a 10-bit fraction (65535 * 32 * 1024 < 2^31)
+    uint32_t pos = static_cast<uint32_t>(done) * MOA_RAMP_PROFILE_SEGMENTS * 1024 / steps;
+    uint32_t index = pos >> 10;
+    uint32_t frac = pos & 1023;
+    uint32_t a = _table[index];
+    uint32_t b = _table[index + 1];
+    return static_cast<uint16_t>(a + (((b - a) * frac + 512) >> 10));
+}
+
+float MoaRampProfile::clampCurvature(float curvature) {
+    if (!(curvature > ESC_RAMP_CURVATURE_MIN)) {
+        return ESC_RAMP_CURVATURE_MIN;
+    }
+    return (curvature < ESC_RAMP_CURVATURE_MAX) ? curvature : ESC_RAMP_CURVATURE_MAX;
+}
+
+const char* MoaRampProfile::shapeName(MoaRampShape shape) {
+    switch (shape) {
+        case MoaRampShape::LINEAR: return "linear";
+        case MoaRampShape::SCURVE: return "scurve";
+        case MoaRampShape::EXPO:   return "expo";
+        default:                   return "?";
+    }
+}
+
+MoaEscRamp::MoaEscRamp(uint16_t duty)
+    : _duty(duty)
+    , _from(duty)
+    , _target(duty)
+    , _steps(0)
+    , _done(0)
+    , _profile(nullptr)
+    , _active(false)
+{
+}
+
+void MoaEscRamp::reset(uint16_t duty) {
+    _duty = duty;
+    _from = duty;
+    _target = duty;
+    _steps = 0;
+    _done = 0;
+    _profile = nullptr;
+    _active = false;
+}
+
+bool MoaEscRamp::start(uint16_t target, uint16_t steps, const MoaRampProfile* profile) {
+    _from = _duty;
+    _target = target;
+    _steps = (steps > 0) ? steps : 1;
+    _done = 0;
+    _profile = (profile != nullptr && !profile->isLinear()) ? profile : nullptr;
+    _active = (_target != _duty);
+    return _active;
+}
+
+bool MoaEscRamp::step() {
+    if (!_active) {
+        return false;
+    }
+
+    _done++;
+    uint16_t previous = _duty;
+    if (_done >= _steps) {
+        _duty = _target;
+        _active = false;
+    } else if (_profile == nullptr) {
+        int32_t delta = static_cast<int32_t>(_target) - static_cast<int32_t>(_from);
+        _duty = static_cast<uint16_t>(_from + delta * _done / _steps);
+    } else {
+        // |delta| < 2^14 at 14-bit duties and progress <= 2^15: fits in int32
+        int32_t delta = static_cast<int32_t>(_target) - static_cast<int32_t>(_from);
+        int32_t progress = _profile->at(_done, _steps);
+        int32_t half = (delta >= 0) ? (MoaRampProfile::ONE / 2) : -(MoaRampProfile::ONE / 2);
+        _duty = static_cast<uint16_t>(_from + (delta * progress + half) / MoaRampProfile::ONE);
+    }
+    return _duty != previous;
+}
+
+bool MoaEscRamp::isActive() const {
+    return _active;
+}
+
+uint16_t MoaEscRamp::getDuty() const {
+    return _duty;
+}
+
+uint16_t MoaEscRamp::getTarget() const {
+    return _target;
+}
+
+uint16_t MoaEscRamp::getStepsLeft() const {
+    return _active ? static_cast<uint16_t>(_steps - _done) : 0;
+}
+
+uint16_t MoaEscRamp::stepsFor(uint16_t from, uint16_t to, uint16_t minDuty, uint16_t maxDuty,
+                              float ratePercentPerSec, uint32_t tickUs) {
+    if (maxDuty <= minDuty || ratePercentPerSec <= 0.0f || tickUs == 0) {
+        return 1;
+    }
+    uint16_t delta = (to > from) ? (to - from) : (from - to);
+    float deltaPercent = delta * 100.0f / (maxDuty - minDuty);
+    float steps = deltaPercent * 1000000.0f / (ratePercentPerSec * tickUs);
+    if (steps < 1.0f) {
+        return 1;
+    }
+    return (steps > 65535.0f) ? 65535 : static_cast<uint16_t>(steps);
+}
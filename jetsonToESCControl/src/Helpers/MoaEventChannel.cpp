@@ -0,0 +1,82 @@
+/**
+ * @file MoaEventChannel.cpp
+ * @brief Implementation of the MoaEventChannel class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaEventChannel.h"
+#include "esp_log.h"
+
+static const char* TAG = "Events";
+
+MoaEventChannel::MoaEventChannel()
+    : _mux(portMUX_INITIALIZER_UNLOCKED)
+    , _ready(nullptr)
+{
+}
+
+bool MoaEventChannel::begin() {
+    if (_ready != nullptr) {
+        return true;
+    }
+    _ready = xSemaphoreCreateBinary();
+    if (_ready == nullptr) {
+        ESP_LOGE(TAG, "Failed to create event semaphore");
+        return false;
+    }
+    ESP_LOGD(TAG, "Event channel ready (safety=%d, normal=%d)", MOA_EVENT_SAFETY_DEPTH, MOA_EVENT_NORMAL_DEPTH);
+    return true;
+}
+
+bool MoaEventChannel::push(const ControlCommand& cmd) {
+    portENTER_CRITICAL(&_mux);
+    MoaEventPushResult result = _queue.push(cmd);
+    portEXIT_CRITICAL(&_mux);
+
+    if (result == MOA_EVENT_QUEUED && _ready != nullptr) {
+        xSemaphoreGive(_ready);     // Already given if the consumer has not woken yet
+    } else if (result == MOA_EVENT_DROPPED) {
+        ESP_LOGW(TAG, "Dropped event %d/%d (%s lane full)", cmd.controlType, cmd.commandType,
+                 (MoaEventQueue::laneOf(cmd) == MOA_EVENT_LANE_SAFETY) ? "safety" : "normal");
+        return false;
+    }
+    return true;
+}
+
+bool MoaEventChannel::receive(ControlCommand& cmd, TickType_t ticksToWait) {
+    if (_ready == nullptr) {
+        return false;
+    }
+
+    for (;;) {
+        portENTER_CRITICAL(&_mux);
+        bool popped = _queue.pop(cmd);
+        portEXIT_CRITICAL(&_mux);
+        if (popped) {
+            return true;
+        }
+        // A push between the pop and the take leaves the semaphore given: no lost wake-up
+        if (xSemaphoreTake(_ready, ticksToWait) != pdTRUE) {
+            return false;
+        }
+    }
+}
+
+void MoaEventChannel::getStats(MoaEventChannelStats& stats) const {
+    portENTER_CRITICAL(&_mux);
+    for (uint8_t s = 0; s < MOA_EVENT_SOURCE_COUNT; s++) {
+        stats.sources[s] = _queue.getCounters(static_cast<MoaEventSource>(s));
+    }
+    for (uint8_t l = 0; l < MOA_EVENT_LANE_COUNT; l++) {
+        stats.pending[l] = _queue.size(static_cast<MoaEventLane>(l));
+        stats.highWater[l] = _queue.getHighWater(static_cast<MoaEventLane>(l));
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+void MoaEventChannel::resetStats() {
+    portENTER_CRITICAL(&_mux);
+    _queue.resetCounters();
+    portEXIT_CRITICAL(&_mux);
+}
@@ -0,0 +1,154 @@
+/**
+ * @file MoaEventQueue.cpp
+ * @brief Implementation of the MoaEventQueue class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaEventQueue.h"
+#include <string.h>
+
+static const char* const SOURCE_NAMES[MOA_EVENT_SOURCE_COUNT] = {
+    "timer", "temp", "battery", "current", "button", "remote", "other"
+};
+
+MoaEventQueue::MoaEventQueue() {
+    _lanes[MOA_EVENT_LANE_SAFETY].items = _safetyItems;
+    _lanes[MOA_EVENT_LANE_SAFETY].capacity = MOA_EVENT_SAFETY_DEPTH;
+    _lanes[MOA_EVENT_LANE_NORMAL].items = _normalItems;
+    _lanes[MOA_EVENT_LANE_NORMAL].capacity = MOA_EVENT_NORMAL_DEPTH;
+    for (uint8_t l = 0; l < MOA_EVENT_LANE_COUNT; l++) {
+        _lanes[l].head = 0;
+        _lanes[l].count = 0;
+    }
+    resetCounters();
+}
+
+MoaEventPushResult MoaEventQueue::push(const ControlCommand& cmd) {
+    MoaEventCounters& counters = _counters[sourceOf(cmd)];
+    MoaEventLane laneId = laneOf(cmd);
+    Lane& lane = _lanes[laneId];
+
+    // Only the producer's newest entry: merging into an older one would reorder its transitions
+    int newest = isCoalescable(cmd) ? newestFrom(lane, cmd.controlType) : -1;
+    bool coalesce = (newest >= 0) && (at(lane, static_cast<uint8_t>(newest)).commandType == cmd.commandType);
+
+    if (!coalesce && lane.count >= lane.capacity) {
+        counters.dropped++;
+        return MOA_EVENT_DROPPED;
+    }
+
+    if (laneId == MOA_EVENT_LANE_SAFETY) {
+        // Served after this event, the producer's normal-lane entries would restore a stale state
+        counters.superseded += removeFrom(_lanes[MOA_EVENT_LANE_NORMAL], cmd.controlType);
+    }
+
+    if (coalesce) {
+        at(lane, static_cast<uint8_t>(newest)) = cmd;     // Same producer and commandType: only the payload changes
+        counters.coalesced++;
+        return MOA_EVENT_COALESCED;
+    }
+
+    at(lane, lane.count) = cmd;
+    lane.count++;
+    if (lane.count > lane.highWater) {
+        lane.highWater = lane.count;
+    }
+    counters.queued++;
+    return MOA_EVENT_QUEUED;
+}
+
+bool MoaEventQueue::pop(ControlCommand& cmd) {
+    for (uint8_t l = 0; l < MOA_EVENT_LANE_COUNT; l++) {
+        Lane& lane = _lanes[l];
+        if (lane.count > 0) {
+            cmd = lane.items[lane.head];
+            lane.head = static_cast<uint8_t>((lane.head + 1) % lane.capacity);
+            lane.count--;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint8_t MoaEventQueue::size(MoaEventLane lane) const {
+    return (lane < MOA_EVENT_LANE_COUNT) ? _lanes[lane].count : 0;
+}
+
+uint8_t MoaEventQueue::size() const {
+    return static_cast<uint8_t>(_lanes[MOA_EVENT_LANE_SAFETY].count + _lanes[MOA_EVENT_LANE_NORMAL].count);
+}
+
+uint8_t MoaEventQueue::getHighWater(MoaEventLane lane) const {
+    return (lane < MOA_EVENT_LANE_COUNT) ? _lanes[lane].highWater : 0;
+}
+
+const MoaEventCounters& MoaEventQueue::getCounters(MoaEventSource source) const {
+    return _counters[(source < MOA_EVENT_SOURCE_COUNT) ? source : MOA_EVENT_SOURCE_OTHER];
+}
+
+void MoaEventQueue::resetCounters() {
+    memset(_counters, 0, sizeof(_counters));
+    for (uint8_t l = 0; l < MOA_EVENT_LANE_COUNT; l++) {
+        _lanes[l].highWater = _lanes[l].count;
+    }
+}
+
+MoaEventLane MoaEventQueue::laneOf(const ControlCommand& cmd) {
+    switch (cmd.controlType) {
+        case CONTROL_TYPE_CURRENT:
+        case CONTROL_TYPE_TEMPERATURE:
+            return MOA_EVENT_LANE_SAFETY;
+        case CONTROL_TYPE_BATTERY:
+            return (cmd.commandType == COMMAND_BATT_LEVEL_STOP) ? MOA_EVENT_LANE_SAFETY : MOA_EVENT_LANE_NORMAL;
+        case CONTROL_TYPE_REMOTE:
+            return (cmd.commandType == COMMAND_REMOTE_DISARM) ? MOA_EVENT_LANE_SAFETY : MOA_EVENT_LANE_NORMAL;
+        default:
+            return MOA_EVENT_LANE_NORMAL;
+    }
+}
+
+MoaEventSource MoaEventQueue::sourceOf(const ControlCommand& cmd) {
+    if (cmd.controlType < CONTROL_TYPE_TIMER || cmd.controlType > CONTROL_TYPE_REMOTE) {
+        return MOA_EVENT_SOURCE_OTHER;
+    }
+    return static_cast<MoaEventSource>(cmd.controlType - CONTROL_TYPE_TIMER);
+}
+
+bool MoaEventQueue::isCoalescable(const ControlCommand& cmd) {
+    return cmd.controlType == CONTROL_TYPE_TEMPERATURE ||
+           cmd.controlType == CONTROL_TYPE_BATTERY ||
+           cmd.controlType == CONTROL_TYPE_CURRENT ||
+           (cmd.controlType == CONTROL_TYPE_REMOTE && cmd.commandType == COMMAND_REMOTE_THROTTLE);
+}
+
+const char* MoaEventQueue::getSourceName(MoaEventSource source) {
+    return (source < MOA_EVENT_SOURCE_COUNT) ? SOURCE_NAMES[source] : "?";
+}
+
+ControlCommand& MoaEventQueue::at(Lane& lane, uint8_t index) {
+    return lane.items[(lane.head + index) % lane.capacity];
+}
+
+int MoaEventQueue::newestFrom(Lane& lane, int controlType) {
+    for (int i = lane.count - 1; i >= 0; i--) {
+        if (at(lane, static_cast<uint8_t>(i)).controlType == controlType) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+uint8_t MoaEventQueue::removeFrom(Lane& lane, int controlType) {
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < lane.count; i++) {
+        const ControlCommand entry = at(lane, i);
+        if (entry.controlType != controlType) {
+            at(lane, kept) = entry;
+            kept++;
+        }
+    }
+    uint8_t removed = static_cast<uint8_t>(lane.count - kept);
+    lane.count = kept;
+    return removed;
+}
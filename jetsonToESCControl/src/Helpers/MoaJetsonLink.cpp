@@ -0,0 +1,156 @@
+/**
+ * @file MoaJetsonLink.cpp
+ * @brief Implementation of the MoaJetsonLink class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaJetsonLink.h"
+#include "PinMapping.h"
+#include "Constants.h"
+#include "esp_log.h"
+#include "MoaLatencyTrace.h"
+
+static const char* TAG = "JetsonLink";
+
+static_assert(MOA_TELEMETRY_MAX_PAYLOAD <= MOA_LINK_MAX_PAYLOAD, "A telemetry batch must fit one link frame");
+
+static const uart_port_t LINK_PORT = static_cast<uart_port_t>(MOA_LINK_UART_NUM);
+
+MoaJetsonLink::MoaJetsonLink(MoaEventChannel& events, ESCController& esc, MoaStatsAggregator& stats,
+                             MoaStateMachineWrapper& stateMachine)
+    : _events(events)
+    , _esc(esc)
+    , _stats(stats)
+    , _stateMachine(stateMachine)
+    , _session(*this)
+    , _uartEvents(nullptr)
+    , _driverOverflows(0)
+    , _streamSeq(0)
+{
+}
+
+bool MoaJetsonLink::begin() {
+    uart_config_t config = {};
+    config.baud_rate = MOA_LINK_BAUD;
+    config.data_bits = UART_DATA_8_BITS;
+    config.parity = UART_PARITY_DISABLE;
+    config.stop_bits = UART_STOP_BITS_1;
+    config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+    config.source_clk = UART_SCLK_APB;
+
+    esp_err_t err = uart_driver_install(LINK_PORT, MOA_LINK_RX_BUFFER, MOA_LINK_TX_BUFFER,
+                                        MOA_LINK_EVENT_DEPTH, &_uartEvents, 0);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "UART driver install failed: %s", esp_err_to_name(err));
+        _uartEvents = nullptr;
+        return false;
+    }
+    uart_param_config(LINK_PORT, &config);
+    uart_set_pin(LINK_PORT, PIN_LINK_TX, PIN_LINK_RX, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    // Event per idle gap rather than per 120 bytes: a frame is handled as soon as it ends
+    uart_set_rx_timeout(LINK_PORT, MOA_LINK_RX_TIMEOUT);
+
+    ESP_LOGI(TAG, "Jetson link on UART%d (tx=%d, rx=%d, %d baud)", MOA_LINK_UART_NUM, PIN_LINK_TX, PIN_LINK_RX, MOA_LINK_BAUD);
+    return true;
+}
+
+bool MoaJetsonLink::waitEvent(uart_event_t& event, TickType_t ticksToWait) {
+    if (_uartEvents == nullptr) {
+        vTaskDelay(ticksToWait);
+        return false;
+    }
+    return xQueueReceive(_uartEvents, &event, ticksToWait) == pdTRUE;
+}
+
+void MoaJetsonLink::handleEvent(const uart_event_t& event) {
+    switch (event.type) {
+        case UART_DATA: {
+            uint8_t buffer[64];
+            size_t left = event.size;
+            while (left > 0) {
+                int read = uart_read_bytes(LINK_PORT, buffer, (left < sizeof(buffer)) ? left : sizeof(buffer), 0);
+                if (read <= 0) {
+                    break;
+                }
+                _session.receive(buffer, static_cast<size_t>(read));
+                left -= static_cast<size_t>(read);
+            }
+            break;
+        }
+
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL:
+            // Bytes were lost mid-stream: drop what is buffered, the decoder resyncs on the next delimiter
+            _driverOverflows++;
+            uart_flush_input(LINK_PORT);
+            xQueueReset(_uartEvents);
+            ESP_LOGW(TAG, "UART overflow (%d), input flushed", event.type);
+            break;
+
+        default:
+            ESP_LOGD(TAG, "UART event %d", event.type);
+            break;
+    }
+}
+
+MoaLinkStats MoaJetsonLink::getStats() const {
+    return _session.getStats();
+}
+
+uint32_t MoaJetsonLink::getDriverOverflows() const {
+    return _driverOverflows;
+}
+
+void MoaJetsonLink::resetStats() {
+    _session.resetStats();
+    _driverOverflows = 0;
+}
+
+uint8_t MoaJetsonLink::push(uint8_t command, uint16_t duty) {
+    return _events.push(RemoteEvent(command, duty)) ? MOA_LINK_STATUS_OK : MOA_LINK_STATUS_BUSY;
+}
+
+uint8_t MoaJetsonLink::onThrottle(uint16_t duty) {
+    MOA_LATENCY_BEGIN(MOA_HOP_LINK_FRAME);
+    MOA_LATENCY_MARK_FROM(MOA_HOP_LINK_FRAME, MOA_HOP_PUSH);
+    return push(COMMAND_REMOTE_THROTTLE, duty);
+}
+
+uint8_t MoaJetsonLink::onArm() {
+    return push(COMMAND_REMOTE_ARM, 0);
+}
+
+uint8_t MoaJetsonLink::onDisarm() {
+    return push(COMMAND_REMOTE_DISARM, 0);
+}
+
+void MoaJetsonLink::onTelemetry(MoaLinkTelemetry& out) {
+    StatsSnapshot snapshot = _stats.getSnapshot();
+    out.state = static_cast<uint8_t>(_stateMachine.getStateId());
+    out.flags = (_esc.isTripped() ? MOA_LINK_FLAG_TRIPPED : 0) | (_esc.isRamping() ? MOA_LINK_FLAG_RAMPING : 0);
+    out.escDuty = _esc.getCurrentDuty();
+    out.battMillivolts = static_cast<uint16_t>(snapshot.batteryVoltageMv);
+    out.currentDeciAmps = snapshot.currentX10;
+    out.tempDeciCelsius = snapshot.temperatureX10;
+    out.uptimeMs = millis();
+}
+
+void MoaJetsonLink::writeLink(const uint8_t* data, size_t length) {
+    uart_write_bytes(LINK_PORT, data, length);
+}
+
+bool MoaJetsonLink::sendTelemetry(const uint8_t* payload, size_t length) {
+    if (_uartEvents == nullptr) {
+        return false;                       // Driver not installed
+    }
+    uint8_t out[MOA_LINK_MAX_ENCODED];
+    size_t size = MoaLinkCodec::encodeFrame(_streamSeq, MOA_LINK_MSG_STREAM, payload, static_cast<uint8_t>(length),
+                                            out, sizeof(out));
+    if (size == 0) {
+        return false;
+    }
+    _streamSeq++;
+    // One call per frame: the driver's TX lock keeps it whole next to LinkTask replies
+    return uart_write_bytes(LINK_PORT, out, size) == static_cast<int>(size);
+}
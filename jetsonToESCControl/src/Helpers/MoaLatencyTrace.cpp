@@ -0,0 +1,186 @@
+/**
+ * @file MoaLatencyTrace.cpp
+ * @brief Implementation of the MoaLatencyTrace class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaLatencyTrace.h"
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_attr.h"       // begin() runs in the button ISR
+#endif
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+MoaLatencyTrace g_moaLatencyTrace;
+
+// =============================================================================
+// MoaLatencyHistogram
+// =============================================================================
+
+void MoaLatencyHistogram::clear() {
+    memset(buckets, 0, sizeof(buckets));
+    count = 0;
+    minUs = UINT32_MAX;
+    maxUs = 0;
+    totalUs = 0;
+}
+
+void MoaLatencyHistogram::add(uint32_t us) {
+    uint8_t bucket = 0;
+    if (us > 0) {
+        bucket = static_cast<uint8_t>(32 - __builtin_clz(us));
+        if (bucket >= MOA_LATENCY_BUCKETS) {
+            bucket = MOA_LATENCY_BUCKETS - 1;
+        }
+    }
+    buckets[bucket]++;
+    count++;
+    totalUs += us;
+    if (us < minUs) {
+        minUs = us;
+    }
+    if (us > maxUs) {
+        maxUs = us;
+    }
+}
+
+uint32_t MoaLatencyHistogram::meanUs() const {
+    return (count > 0) ? static_cast<uint32_t>(totalUs / count) : 0;
+}
+
+uint32_t MoaLatencyHistogram::percentileUs(uint8_t percent) const {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = (static_cast<uint64_t>(count) * percent + 99) / 100;   // Ceiling
+    uint64_t seen = 0;
+    for (uint8_t b = 0; b < MOA_LATENCY_BUCKETS; b++) {
+        seen += buckets[b];
+        if (seen >= rank) {
+            uint32_t limit = bucketLimitUs(b);
+            return (limit - 1 < maxUs) ? limit - 1 : maxUs;
+        }
+    }
+    return maxUs;
+}
+
+uint32_t MoaLatencyHistogram::bucketLimitUs(uint8_t bucket) {
+    return (bucket < MOA_LATENCY_BUCKETS - 1) ? (1UL << bucket) : UINT32_MAX;
+}
+
+// =============================================================================
+// MoaLatencyTrace
+// =============================================================================
+
+MoaLatencyTrace::MoaLatencyTrace()
+    : _active(false)
+    , _origin(MOA_HOP_BUTTON_EDGE)
+    , _lastHop(MOA_HOP_BUTTON_EDGE)
+    , _originUs(0)
+    , _lastUs(0)
+    , _completed(0)
+    , _dropped(0)
+{
+    _busy.clear();
+    for (uint8_t i = 0; i < MOA_HOP_COUNT; i++) {
+        _histograms[i].clear();
+    }
+}
+
+bool IRAM_ATTR MoaLatencyTrace::tryLock() const {
+    return !_busy.test_and_set(std::memory_order_acquire);
+}
+
+void IRAM_ATTR MoaLatencyTrace::unlock() const {
+    _busy.clear(std::memory_order_release);
+}
+
+void IRAM_ATTR MoaLatencyTrace::begin(MoaLatencyHop origin, uint32_t nowUs) {
+    if (!tryLock()) {
+        return;
+    }
+    if (_active && (nowUs - _originUs) >= MOA_LATENCY_STALE_US) {
+        _active = false;
+        _dropped++;
+    }
+    if (!_active) {
+        _active = true;
+        _origin = origin;
+        _lastHop = origin;
+        _originUs = nowUs;
+        _lastUs = nowUs;
+    }
+    unlock();
+}
+
+void MoaLatencyTrace::mark(MoaLatencyHop hop, uint32_t nowUs, MoaLatencyHop from) {
+    if (!tryLock()) {
+        return;
+    }
+    if (_active && hop > _lastHop && (from == MOA_HOP_ANY || from == _origin)) {
+        _histograms[hop].add(nowUs - _lastUs);
+        _lastHop = hop;
+        _lastUs = nowUs;
+        if (hop == MOA_HOP_PWM) {
+            _histograms[_origin].add(nowUs - _originUs);
+            _completed++;
+            _active = false;
+        }
+    }
+    unlock();
+}
+
+void MoaLatencyTrace::release(MoaLatencyHop origin, MoaLatencyHop needed) {
+    if (!tryLock()) {
+        return;
+    }
+    if (_active && (origin == MOA_HOP_ANY || origin == _origin) && _lastHop < needed) {
+        if (_lastHop != _origin) {
+            _dropped++;                 // Got somewhere; a quiet sensor cycle is not a drop
+        }
+        _active = false;
+    }
+    unlock();
+}
+
+bool MoaLatencyTrace::getHistogram(MoaLatencyHop hop, MoaLatencyHistogram& out) const {
+    if (hop >= MOA_HOP_COUNT || !tryLock()) {
+        return false;
+    }
+    out = _histograms[hop];
+    unlock();
+    return true;
+}
+
+uint32_t MoaLatencyTrace::getCompletedCount() const {
+    return _completed;
+}
+
+uint32_t MoaLatencyTrace::getDroppedCount() const {
+    return _dropped;
+}
+
+bool MoaLatencyTrace::reset() {
+    if (!tryLock()) {
+        return false;
+    }
+    _active = false;
+    _completed = 0;
+    _dropped = 0;
+    for (uint8_t i = 0; i < MOA_HOP_COUNT; i++) {
+        _histograms[i].clear();
+    }
+    unlock();
+    return true;
+}
+
+const char* MoaLatencyTrace::getHopName(MoaLatencyHop hop) {
+    static const char* const names[MOA_HOP_COUNT] = {
+        "edge", "sample", "drain", "link", "process", "push", "receive", "state", "set_duty", "pwm"
+    };
+    return (hop < MOA_HOP_COUNT) ? names[hop] : "?";
+}
@@ -0,0 +1,275 @@
+/**
+ * @file MoaLinkProtocol.cpp
+ * @brief Implementation of the Jetson link framing and session
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaLinkProtocol.h"
+#include <string.h>
+
+// =============================================================================
+// MoaLinkCodec
+// =============================================================================
+
+uint16_t MoaLinkCodec::crc16(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+size_t MoaLinkCodec::cobsEncode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t codeIndex = 0;
+    size_t outIndex = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < length; i++) {
+        if (in[i] == 0) {
+            out[codeIndex] = code;
+            codeIndex = outIndex++;
+            code = 1;
+        } else {
+            out[outIndex++] = in[i];
+            code++;
+            // A full group at the very end needs no empty group after it
+            if (code == 0xFF && i + 1 < length) {
+                out[codeIndex] = code;
+                codeIndex = outIndex++;
+                code = 1;
+            }
+        }
+    }
+    out[codeIndex] = code;
+    return outIndex;
+}
+
+size_t MoaLinkCodec::cobsDecode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t inIndex = 0;
+    size_t outIndex = 0;
+
+    while (inIndex < length) {
+        uint8_t code = in[inIndex++];
+        if (code == 0 || inIndex + code - 1 > length) {
+            return 0;
+        }
+        for (uint8_t i = 1; i < code; i++) {
+            if (in[inIndex] == 0) {
+                return 0;
+            }
+            out[outIndex++] = in[inIndex++];
+        }
+        // A group shorter than 254 data bytes stands for a zero, except at the end
+        if (code != 0xFF && inIndex < length) {
+            out[outIndex++] = 0;
+        }
+    }
+    return outIndex;
+}
+
+size_t MoaLinkCodec::encodeFrame(uint8_t seq, uint8_t type, const uint8_t* payload, uint8_t length,
+                                 uint8_t* out, size_t capacity) {
+    if (length > MOA_LINK_MAX_PAYLOAD || capacity < static_cast<size_t>(length) + 6) {
+        return 0;
+    }
+
+    uint8_t raw[MOA_LINK_MAX_FRAME];
+    raw[0] = seq;
+    raw[1] = type;
+    if (length > 0) {
+        memcpy(&raw[2], payload, length);
+    }
+    uint16_t crc = crc16(raw, 2 + length);
+    raw[2 + length] = static_cast<uint8_t>(crc & 0xFF);
+    raw[3 + length] = static_cast<uint8_t>(crc >> 8);
+
+    size_t encoded = cobsEncode(raw, 4 + length, out);
+    out[encoded++] = 0;
+    return encoded;
+}
+
+// =============================================================================
+// MoaLinkDecoder
+// =============================================================================
+
+MoaLinkDecoder::MoaLinkDecoder()
+    : _length(0)
+    , _overrun(false)
+    , _crcErrors(0)
+    , _framingErrors(0)
+    , _overruns(0)
+{
+}
+
+void MoaLinkDecoder::reset() {
+    _length = 0;
+    _overrun = false;
+}
+
+bool MoaLinkDecoder::push(uint8_t byte, MoaLinkFrame& frame) {
+    if (byte != 0) {
+        if (_length < sizeof(_buffer)) {
+            _buffer[_length++] = byte;
+        } else if (!_overrun) {
+            _overrun = true;
+            _overruns++;
+        }
+        return false;
+    }
+
+    // Delimiter: check what came before it
+    size_t length = _length;
+    bool overrun = _overrun;
+    reset();
+    if (overrun || length == 0) {
+        return false;                       // Dropped already, or idle zeros between frames
+    }
+
+    uint8_t raw[MOA_LINK_MAX_ENCODED];
+    size_t decoded = MoaLinkCodec::cobsDecode(_buffer, length, raw);
+    if (decoded < 4 || decoded > MOA_LINK_MAX_FRAME) {
+        _framingErrors++;
+        return false;
+    }
+    uint16_t crc = static_cast<uint16_t>(raw[decoded - 2] | (raw[decoded - 1] << 8));
+    if (crc != MoaLinkCodec::crc16(raw, decoded - 2)) {
+        _crcErrors++;
+        return false;
+    }
+
+    frame.seq = raw[0];
+    frame.type = raw[1];
+    frame.length = static_cast<uint8_t>(decoded - 4);
+    memcpy(frame.payload, &raw[2], frame.length);
+    return true;
+}
+
+uint32_t MoaLinkDecoder::getCrcErrors() const {
+    return _crcErrors;
+}
+
+uint32_t MoaLinkDecoder::getFramingErrors() const {
+    return _framingErrors;
+}
+
+uint32_t MoaLinkDecoder::getOverruns() const {
+    return _overruns;
+}
+
+void MoaLinkDecoder::resetCounters() {
+    _crcErrors = 0;
+    _framingErrors = 0;
+    _overruns = 0;
+}
+
+// =============================================================================
+// MoaLinkSession
+// =============================================================================
+
+MoaLinkSession::MoaLinkSession(IMoaLinkHandler& handler)
+    : _handler(handler)
+    , _hasLast(false)
+    , _lastSeq(0)
+    , _lastType(0)
+    , _lastStatus(MOA_LINK_STATUS_OK)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void MoaLinkSession::receive(const uint8_t* data, size_t length) {
+    MoaLinkFrame frame;
+    for (size_t i = 0; i < length; i++) {
+        if (_decoder.push(data[i], frame)) {
+            handle(frame);
+        }
+    }
+}
+
+MoaLinkStats MoaLinkSession::getStats() const {
+    MoaLinkStats stats = _stats;
+    stats.crcErrors = _decoder.getCrcErrors();
+    stats.framingErrors = _decoder.getFramingErrors();
+    stats.overruns = _decoder.getOverruns();
+    return stats;
+}
+
+void MoaLinkSession::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+    _decoder.resetCounters();
+}
+
+void MoaLinkSession::handle(const MoaLinkFrame& frame) {
+    _stats.frames++;
+
+    bool repeated = _hasLast && frame.seq == _lastSeq && frame.type == _lastType;
+    if (_hasLast && !repeated && frame.seq != static_cast<uint8_t>(_lastSeq + 1)) {
+        _stats.seqGaps++;
+    }
+
+    if (frame.type == MOA_LINK_MSG_TELEMETRY && frame.length == 0) {
+        // Read-only: a retry simply gets fresh values
+        MoaLinkTelemetry telemetry;
+        memset(&telemetry, 0, sizeof(telemetry));
+        _handler.onTelemetry(telemetry);
+        reply(frame.seq, MOA_LINK_MSG_TELEMETRY_REPLY, reinterpret_cast<const uint8_t*>(&telemetry), sizeof(telemetry));
+        _hasLast = true;
+        _lastSeq = frame.seq;
+        _lastType = frame.type;
+        _lastStatus = MOA_LINK_STATUS_OK;
+        return;
+    }
+
+    uint8_t status;
+    if (repeated && _lastStatus != MOA_LINK_STATUS_BUSY) {
+        _stats.duplicates++;
+        status = _lastStatus;               // Same answer, no second execution
+    } else {
+        // New request, or the retry of one the full event channel turned away
+        status = execute(frame);
+        _hasLast = true;
+        _lastSeq = frame.seq;
+        _lastType = frame.type;
+        _lastStatus = status;
+        if (status != MOA_LINK_STATUS_OK) {
+            _stats.rejected++;
+        }
+    }
+    reply(frame.seq, MOA_LINK_MSG_ACK, &status, 1);
+}
+
+uint8_t MoaLinkSession::execute(const MoaLinkFrame& frame) {
+    switch (frame.type) {
+        case MOA_LINK_MSG_PING:
+            return (frame.length == 0) ? MOA_LINK_STATUS_OK : MOA_LINK_STATUS_BAD_LENGTH;
+
+        case MOA_LINK_MSG_THROTTLE:
+            if (frame.length != 2) {
+                return MOA_LINK_STATUS_BAD_LENGTH;
+            }
+            return _handler.onThrottle(static_cast<uint16_t>(frame.payload[0] | (frame.payload[1] << 8)));
+
+        case MOA_LINK_MSG_ARM:
+            return (frame.length == 0) ? _handler.onArm() : MOA_LINK_STATUS_BAD_LENGTH;
+
+        case MOA_LINK_MSG_DISARM:
+            return (frame.length == 0) ? _handler.onDisarm() : MOA_LINK_STATUS_BAD_LENGTH;
+
+        case MOA_LINK_MSG_TELEMETRY:
+            return MOA_LINK_STATUS_BAD_LENGTH;  // With a payload (the valid request is served in handle())
+
+        default:
+            return MOA_LINK_STATUS_UNKNOWN;
+    }
+}
+
+void MoaLinkSession::reply(uint8_t seq, uint8_t type, const uint8_t* payload, uint8_t length) {
+    uint8_t out[MOA_LINK_MAX_ENCODED];
+    size_t size = MoaLinkCodec::encodeFrame(seq, type, payload, length, out, sizeof(out));
+    if (size > 0) {
+        _handler.writeLink(out, size);
+    }
+}
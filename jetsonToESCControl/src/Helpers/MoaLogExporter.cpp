@@ -0,0 +1,271 @@
+/**
+ * @file MoaLogExporter.cpp
+ * @brief Implementation of the MoaLogExporter class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaLogExporter.h"
+#include "MoaLogCodes.h"
+#include <string.h>
+
+static_assert(sizeof(MoaLogExportHeader) == 12, "MoaLogExportHeader must stay 12 bytes");
+
+MoaLogExporter::MoaLogExporter(ILogSink& sink, MoaLogExportFormat format)
+    : _sink(sink)
+    , _format(format)
+    , _fill(0)
+    , _index(0)
+    , _bytesWritten(0)
+    , _crc(0xFFFF)
+    , _failed(false)
+{
+}
+
+void MoaLogExporter::begin(uint32_t count) {
+    _fill = 0;
+    _index = 0;
+    _bytesWritten = 0;
+    _crc = 0xFFFF;
+    _failed = false;
+
+    switch (_format) {
+        case MoaLogExportFormat::JSON:
+        case MoaLogExportFormat::JSON_VERBOSE:
+            putString("{\"count\":");
+            putUnsigned(count);
+            putString(",\"entries\":[");
+            break;
+
+        case MoaLogExportFormat::CSV:
+            putString("t,type,code,val,type_name,code_name\n");
+            break;
+
+        case MoaLogExportFormat::BINARY: {
+            MoaLogExportHeader header;
+            header.magic = MOA_LOG_EXPORT_MAGIC;
+            header.version = MOA_LOG_EXPORT_VERSION;
+            header.entrySize = sizeof(MoaLogEntry);
+            header.reserved = 0;
+            header.count = count;
+            put(&header, sizeof(header));
+            break;
+        }
+    }
+}
+
+void MoaLogExporter::add(const MoaLogEntry& entry) {
+    switch (_format) {
+        case MoaLogExportFormat::JSON:
+            putString(_index > 0 ? ",{\"t\":" : "{\"t\":");
+            putUnsigned(entry.timestamp);
+            putString(",\"type\":");
+            putUnsigned(entry.type);
+            putString(",\"code\":");
+            putUnsigned(entry.code);
+            putString(",\"val\":");
+            putNumber(entry.value);
+            putString("}");
+            break;
+
+        case MoaLogExportFormat::JSON_VERBOSE:
+            putString(_index > 0 ? ",{\"t\":" : "{\"t\":");
+            putUnsigned(entry.timestamp);
+            putString(",\"type\":\"");
+            putString(getTypeName(entry.type));
+            putString("\",\"code\":\"");
+            putString(getCodeName(entry.type, entry.code));
+            putString("\",\"val\":");
+            putNumber(entry.value);
+            putString("}");
+            break;
+
+        case MoaLogExportFormat::CSV:
+            putUnsigned(entry.timestamp);
+            putString(",");
+            putUnsigned(entry.type);
+            putString(",");
+            putUnsigned(entry.code);
+            putString(",");
+            putNumber(entry.value);
+            putString(",");
+            putString(getTypeName(entry.type));
+            putString(",");
+            putString(getCodeName(entry.type, entry.code));
+            putString("\n");
+            break;
+
+        case MoaLogExportFormat::BINARY:
+            _crc = MoaLogJournal::crc16(reinterpret_cast<const uint8_t*>(&entry), sizeof(entry), _crc);
+            put(&entry, sizeof(entry));
+            break;
+    }
+    _index++;
+}
+
+bool MoaLogExporter::end() {
+    switch (_format) {
+        case MoaLogExportFormat::JSON:
+        case MoaLogExportFormat::JSON_VERBOSE:
+            putString("]}");
+            break;
+
+        case MoaLogExportFormat::CSV:
+            break;
+
+        case MoaLogExportFormat::BINARY:
+            put(&_crc, sizeof(_crc));
+            break;
+    }
+    flushChunk();
+    return !_failed;
+}
+
+bool MoaLogExporter::hasFailed() const {
+    return _failed;
+}
+
+uint32_t MoaLogExporter::getBytesWritten() const {
+    return _bytesWritten;
+}
+
+bool MoaLogExporter::exportEntries(ILogSink& sink, MoaLogExportFormat format,
+                                   const MoaLogEntry* entries, size_t count) {
+    MoaLogExporter exporter(sink, format);
+    exporter.begin(static_cast<uint32_t>(count));
+    for (size_t i = 0; i < count && !exporter.hasFailed(); i++) {
+        exporter.add(entries[i]);
+    }
+    return exporter.end();
+}
+
+void MoaLogExporter::put(const void* data, size_t length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (length > 0) {
+        size_t room = MOA_LOG_EXPORT_CHUNK_SIZE - _fill;
+        size_t n = (length < room) ? length : room;
+        memcpy(&_buffer[_fill], bytes, n);
+        _fill += n;
+        bytes += n;
+        length -= n;
+        if (_fill == MOA_LOG_EXPORT_CHUNK_SIZE) {
+            flushChunk();
+        }
+    }
+}
+
+void MoaLogExporter::putString(const char* text) {
+    put(text, strlen(text));
+}
+
+void MoaLogExporter::putNumber(int32_t value) {
+    if (value < 0) {
+        put("-", 1);
+        putUnsigned(static_cast<uint32_t>(-(static_cast<int64_t>(value))));
+    } else {
+        putUnsigned(static_cast<uint32_t>(value));
+    }
+}
+
+void MoaLogExporter::putUnsigned(uint32_t value) {
+    char digits[10];
+    size_t n = 0;
+    do {
+        digits[sizeof(digits) - 1 - n] = static_cast<char>('0' + value % 10);
+        value /= 10;
+        n++;
+    } while (value > 0);
+    put(&digits[sizeof(digits) - n], n);
+}
+
+void MoaLogExporter::flushChunk() {
+    if (_fill == 0) {
+        return;
+    }
+    if (!_failed) {
+        size_t accepted = _sink.write(_buffer, _fill);
+        _bytesWritten += static_cast<uint32_t>(accepted);
+        if (accepted < _fill) {
+            _failed = true;
+        }
+    }
+    _fill = 0;
+}
+
+const char* MoaLogExporter::getTypeName(uint8_t type) {
+    switch (type) {
+        case LOG_TYPE_SYSTEM:  return "SYSTEM";
+        case LOG_TYPE_BUTTON:  return "BUTTON";
+        case LOG_TYPE_TEMP:    return "TEMP";
+        case LOG_TYPE_BATT:    return "BATT";
+        case LOG_TYPE_CURRENT: return "CURRENT";
+        case LOG_TYPE_STATE:   return "STATE";
+        case LOG_TYPE_ERROR:   return "ERROR";
+        default:               return "UNKNOWN";
+    }
+}
+
+const char* MoaLogExporter::getCodeName(uint8_t type, uint8_t code) {
+    switch (type) {
+        case LOG_TYPE_SYSTEM:
+            switch (code) {
+                case LOG_SYS_BOOT:           return "BOOT";
+                case LOG_SYS_SHUTDOWN:       return "SHUTDOWN";
+                case LOG_SYS_CONFIG_ENTER:   return "CONFIG_ENTER";
+                case LOG_SYS_CONFIG_EXIT:    return "CONFIG_EXIT";
+                case LOG_SYS_WATCHDOG_RESET: return "WATCHDOG";
+                default:                     return "?";
+            }
+        case LOG_TYPE_BUTTON:
+            switch (code) {
+                case LOG_BTN_STOP_PRESS:     return "STOP";
+                case LOG_BTN_STOP_LONG:      return "STOP_LONG";
+                case LOG_BTN_25_PRESS:       return "25%";
+                case LOG_BTN_50_PRESS:       return "50%";
+                case LOG_BTN_75_PRESS:       return "75%";
+                case LOG_BTN_100_PRESS:      return "100%";
+                default:                     return "?";
+            }
+        case LOG_TYPE_TEMP:
+            switch (code) {
+                case LOG_TEMP_CROSSED_ABOVE: return "ABOVE";
+                case LOG_TEMP_CROSSED_BELOW: return "BELOW";
+                case LOG_TEMP_OVERHEAT:      return "OVERHEAT";
+                default:                     return "?";
+            }
+        case LOG_TYPE_BATT:
+            switch (code) {
+                case LOG_BATT_HIGH:          return "HIGH";
+                case LOG_BATT_MEDIUM:        return "MEDIUM";
+                case LOG_BATT_LOW:           return "LOW";
+                default:                     return "?";
+            }
+        case LOG_TYPE_CURRENT:
+            switch (code) {
+                case LOG_CURRENT_NORMAL:     return "NORMAL";
+                case LOG_CURRENT_OVERCURRENT:return "OVERCURRENT";
+                case LOG_CURRENT_REVERSE:    return "REVERSE";
+                default:                     return "?";
+            }
+        case LOG_TYPE_STATE:
+            switch (code) {
+                case LOG_STATE_TO_INIT:      return "INIT";
+                case LOG_STATE_TO_IDLE:      return "IDLE";
+                case LOG_STATE_TO_SURFING:   return "SURFING";
+                case LOG_STATE_TO_OVERHEAT:  return "OVERHEAT";
+                case LOG_STATE_TO_OVERCURRENT:return "OVERCURRENT";
+                case LOG_STATE_TO_BATT_LOW:  return "BATT_LOW";
+                default:                     return "?";
+            }
+        case LOG_TYPE_ERROR:
+            switch (code) {
+                case LOG_ERR_I2C_FAIL:       return "I2C_FAIL";
+                case LOG_ERR_SENSOR_FAIL:    return "SENSOR_FAIL";
+                case LOG_ERR_FLASH_FAIL:     return "FLASH_FAIL";
+                case LOG_ERR_QUEUE_FULL:     return "QUEUE_FULL";
+                default:                     return "?";
+            }
+        default:
+            return "?";
+    }
+}
@@ -0,0 +1,319 @@
+/**
+ * @file MoaLogJournal.cpp
+ * @brief Implementation of the MoaLogJournal class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaLogJournal.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Records processed per storage call when scanning or appending
+ */
+#define MOA_LOG_IO_CHUNK_RECORDS 16
+
+static_assert(sizeof(MoaLogEntry) == 8, "MoaLogEntry must stay 8 bytes");
+static_assert(sizeof(MoaLogRecord) == 10, "MoaLogRecord must stay 10 bytes");
+static_assert(sizeof(MoaLogSegmentHeader) == 16, "MoaLogSegmentHeader must stay 16 bytes");
+
+MoaLogJournal::MoaLogJournal(ILogStorage* storage, const char* basePath)
+    : _storage(storage)
+    , _basePath(basePath)
+    , _current(-1)
+    , _bytesWritten(0)
+    , _discarded(0)
+{
+    memset(_segments, 0, sizeof(_segments));
+    memset(_path, 0, sizeof(_path));
+}
+
+uint16_t MoaLogJournal::crc16(const uint8_t* data, size_t length, uint16_t seed) {
+    uint16_t crc = seed;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                                 : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+uint16_t MoaLogJournal::recordSeed(uint32_t sequence) {
+    // Records from an older use of the same slot never validate
+    return static_cast<uint16_t>(0xFFFF ^ (sequence & 0xFFFF) ^ (sequence >> 16));
+}
+
+const char* MoaLogJournal::pathFor(uint8_t slot) {
+    snprintf(_path, sizeof(_path), "%s.%u", _basePath, static_cast<unsigned>(slot));
+    return _path;
+}
+
+bool MoaLogJournal::begin() {
+    if (_storage == nullptr || !_storage->begin()) {
+        return false;
+    }
+
+    _current = -1;
+    for (uint8_t slot = 0; slot < MOA_LOG_SEGMENT_COUNT; slot++) {
+        scanSegment(slot);
+        if (_segments[slot].valid &&
+            (_current < 0 || _segments[slot].sequence > _segments[_current].sequence)) {
+            _current = static_cast<int8_t>(slot);
+        }
+    }
+    return true;
+}
+
+void MoaLogJournal::scanSegment(uint8_t slot) {
+    Segment& seg = _segments[slot];
+    memset(&seg, 0, sizeof(seg));
+
+    const char* path = pathFor(slot);
+    int32_t size = _storage->size(path);
+    if (size < static_cast<int32_t>(sizeof(MoaLogSegmentHeader))) {
+        return;
+    }
+
+    MoaLogSegmentHeader header;
+    if (_storage->read(path, 0, reinterpret_cast<uint8_t*>(&header), sizeof(header)) != sizeof(header)) {
+        return;
+    }
+    if (header.magic != MOA_LOG_SEGMENT_MAGIC ||
+        header.version != MOA_LOG_FORMAT_VERSION ||
+        header.recordSize != sizeof(MoaLogRecord) ||
+        header.recordsPerSegment != MOA_LOG_SEGMENT_RECORDS ||
+        header.crc != crc16(reinterpret_cast<const uint8_t*>(&header), sizeof(header) - sizeof(header.crc))) {
+        return;
+    }
+
+    seg.valid = true;
+    seg.sequence = header.sequence;
+
+    uint32_t payload = static_cast<uint32_t>(size) - sizeof(MoaLogSegmentHeader);
+    uint32_t stored = payload / sizeof(MoaLogRecord);
+    bool partial = (payload % sizeof(MoaLogRecord)) != 0;
+    if (stored > MOA_LOG_SEGMENT_RECORDS) {
+        stored = MOA_LOG_SEGMENT_RECORDS;
+        partial = true;
+    }
+
+    uint16_t seed = recordSeed(seg.sequence);
+    MoaLogRecord chunk[MOA_LOG_IO_CHUNK_RECORDS];
+    uint32_t good = 0;
+    bool bad = false;
+
+    while (good < stored && !bad) {
+        uint32_t n = stored - good;
+        if (n > MOA_LOG_IO_CHUNK_RECORDS) {
+            n = MOA_LOG_IO_CHUNK_RECORDS;
+        }
+        uint32_t offset = sizeof(MoaLogSegmentHeader) + good * sizeof(MoaLogRecord);
+        size_t bytes = _storage->read(path, offset, reinterpret_cast<uint8_t*>(chunk), n * sizeof(MoaLogRecord));
+        uint32_t got = static_cast<uint32_t>(bytes / sizeof(MoaLogRecord));
+
+        for (uint32_t i = 0; i < got; i++) {
+            if (chunk[i].crc != crc16(reinterpret_cast<const uint8_t*>(&chunk[i].entry), sizeof(MoaLogEntry), seed)) {
+                bad = true;
+                break;
+            }
+            good++;
+        }
+        if (got < n) {
+            bad = true;
+        }
+    }
+
+    seg.records = static_cast<uint16_t>(good);
+    if (good < stored || partial) {
+        // Anything after the first bad record is unreachable; stop appending here
+        seg.sealed = true;
+        _discarded += (stored - good) + (partial ? 1 : 0);
+    }
+}
+
+bool MoaLogJournal::rotate() {
+    uint8_t slot = 0;
+    uint32_t sequence = 1;
+
+    if (_current >= 0) {
+        slot = static_cast<uint8_t>((_current + 1) % MOA_LOG_SEGMENT_COUNT);
+        sequence = _segments[_current].sequence + 1;
+    }
+
+    MoaLogSegmentHeader header;
+    header.magic = MOA_LOG_SEGMENT_MAGIC;
+    header.version = MOA_LOG_FORMAT_VERSION;
+    header.recordSize = sizeof(MoaLogRecord);
+    header.recordsPerSegment = MOA_LOG_SEGMENT_RECORDS;
+    header.sequence = sequence;
+    header.reserved = 0;
+    header.crc = crc16(reinterpret_cast<const uint8_t*>(&header), sizeof(header) - sizeof(header.crc));
+
+    // The slot's previous content (the oldest segment) is gone from here on
+    memset(&_segments[slot], 0, sizeof(Segment));
+
+    bool ok = _storage->create(pathFor(slot), reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+    if (!ok) {
+        return false;
+    }
+    _bytesWritten += sizeof(header);
+
+    _segments[slot].valid = true;
+    _segments[slot].sequence = sequence;
+    _current = static_cast<int8_t>(slot);
+    return true;
+}
+
+size_t MoaLogJournal::append(const MoaLogEntry* entries, size_t count) {
+    if (_storage == nullptr || entries == nullptr) {
+        return 0;
+    }
+
+    size_t done = 0;
+    MoaLogRecord chunk[MOA_LOG_IO_CHUNK_RECORDS];
+
+    while (done < count) {
+        if (_current < 0 || _segments[_current].sealed ||
+            _segments[_current].records >= MOA_LOG_SEGMENT_RECORDS) {
+            if (!rotate()) {
+                break;
+            }
+        }
+
+        Segment& seg = _segments[_current];
+        size_t n = count - done;
+        size_t room = MOA_LOG_SEGMENT_RECORDS - seg.records;
+        if (n > room) n = room;
+        if (n > MOA_LOG_IO_CHUNK_RECORDS) n = MOA_LOG_IO_CHUNK_RECORDS;
+
+        uint16_t seed = recordSeed(seg.sequence);
+        for (size_t i = 0; i < n; i++) {
+            chunk[i].entry = entries[done + i];
+            chunk[i].crc = crc16(reinterpret_cast<const uint8_t*>(&chunk[i].entry), sizeof(MoaLogEntry), seed);
+        }
+
+        size_t bytes = _storage->append(pathFor(static_cast<uint8_t>(_current)),
+                                        reinterpret_cast<const uint8_t*>(chunk), n * sizeof(MoaLogRecord));
+        _bytesWritten += static_cast<uint32_t>(bytes);
+
+        size_t landed = bytes / sizeof(MoaLogRecord);
+        seg.records = static_cast<uint16_t>(seg.records + landed);
+        done += landed;
+
+        if (landed < n) {
+            // Short write: a partial record may follow, so never append after it
+            seg.sealed = true;
+            break;
+        }
+    }
+
+    return done;
+}
+
+size_t MoaLogJournal::readNewest(MoaLogEntry* out, size_t maxEntries) {
+    if (_storage == nullptr || out == nullptr || maxEntries == 0) {
+        return 0;
+    }
+
+    // Valid slots in chronological (sequence) order
+    uint8_t order[MOA_LOG_SEGMENT_COUNT];
+    uint8_t numValid = 0;
+    for (uint8_t slot = 0; slot < MOA_LOG_SEGMENT_COUNT; slot++) {
+        if (!_segments[slot].valid) {
+            continue;
+        }
+        uint8_t pos = numValid++;
+        while (pos > 0 && _segments[order[pos - 1]].sequence > _segments[slot].sequence) {
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+        order[pos] = slot;
+    }
+
+    uint32_t total = getRecordCount();
+    uint32_t skip = (total > maxEntries) ? static_cast<uint32_t>(total - maxEntries) : 0;
+    size_t written = 0;
+    MoaLogRecord chunk[MOA_LOG_IO_CHUNK_RECORDS];
+
+    for (uint8_t k = 0; k < numValid && written < maxEntries; k++) {
+        uint8_t slot = order[k];
+        const Segment& seg = _segments[slot];
+        if (skip >= seg.records) {
+            skip -= seg.records;
+            continue;
+        }
+
+        uint32_t index = skip;
+        skip = 0;
+        uint16_t seed = recordSeed(seg.sequence);
+        const char* path = pathFor(slot);
+
+        while (index < seg.records && written < maxEntries) {
+            uint32_t n = seg.records - index;
+            if (n > MOA_LOG_IO_CHUNK_RECORDS) n = MOA_LOG_IO_CHUNK_RECORDS;
+
+            uint32_t offset = sizeof(MoaLogSegmentHeader) + index * sizeof(MoaLogRecord);
+            size_t bytes = _storage->read(path, offset, reinterpret_cast<uint8_t*>(chunk), n * sizeof(MoaLogRecord));
+            uint32_t got = static_cast<uint32_t>(bytes / sizeof(MoaLogRecord));
+            if (got == 0) {
+                break;
+            }
+
+            for (uint32_t i = 0; i < got && written < maxEntries; i++) {
+                if (chunk[i].crc != crc16(reinterpret_cast<const uint8_t*>(&chunk[i].entry), sizeof(MoaLogEntry), seed)) {
+                    index = seg.records;
+                    break;
+                }
+                out[written++] = chunk[i].entry;
+                index++;
+            }
+        }
+    }
+
+    return written;
+}
+
+bool MoaLogJournal::clear() {
+    if (_storage == nullptr) {
+        return false;
+    }
+
+    bool ok = true;
+    for (uint8_t slot = 0; slot < MOA_LOG_SEGMENT_COUNT; slot++) {
+        ok = _storage->remove(pathFor(slot)) && ok;
+        memset(&_segments[slot], 0, sizeof(Segment));
+    }
+    _current = -1;
+    return ok;
+}
+
+uint32_t MoaLogJournal::getRecordCount() const {
+    uint32_t total = 0;
+    for (uint8_t slot = 0; slot < MOA_LOG_SEGMENT_COUNT; slot++) {
+        if (_segments[slot].valid) {
+            total += _segments[slot].records;
+        }
+    }
+    return total;
+}
+
+uint8_t MoaLogJournal::getSegmentCount() const {
+    uint8_t count = 0;
+    for (uint8_t slot = 0; slot < MOA_LOG_SEGMENT_COUNT; slot++) {
+        if (_segments[slot].valid) {
+            count++;
+        }
+    }
+    return count;
+}
+
+uint32_t MoaLogJournal::getBytesWritten() const {
+    return _bytesWritten;
+}
+
+uint32_t MoaLogJournal::getDiscardedRecords() const {
+    return _discarded;
+}
@@ -12,30 +12,40 @@
 static const char* TAG = "MainUnit";
 
 MoaMainUnit::MoaMainUnit()
-    : _eventQueue(nullptr)
+    : _eventChannel()
     , _statsQueue(nullptr)
+    , _telemetrySignal(nullptr)
+    , _protectionTaskHandle(nullptr)
     , _sensorTaskHandle(nullptr)
     , _ioTaskHandle(nullptr)
     , _controlTaskHandle(nullptr)
     , _statsTaskHandle(nullptr)
     , _cliTaskHandle(nullptr)
     , _otaTaskHandle(nullptr)
+    , _linkTaskHandle(nullptr)
+    , _telemetryTaskHandle(nullptr)
     , _mcpDevice(MCP23018_I2C_ADDR)
-    , _ntcSensor(PIN_TEMP_SENSE, NTC_REFERENCE_RESISTANCE, NTC_NOMINAL_RESISTANCE,
-                 NTC_NOMINAL_TEMP_C, NTC_BETA_COEFFICIENT, NTC_ADC_VREF_MV)
+    , _ntcSensor(PIN_TEMP_SENSE)
     , _ds18b20Sensor(PIN_TEMP_SENSE)
-    , _tempControl(_eventQueue, PIN_TEMP_SENSE)
-    , _battControl(_eventQueue, PIN_BATT_LEVEL_SENSE)
-    , _currentControl(_eventQueue, PIN_CURRENT_SENSE)
-    , _buttonControl(_eventQueue, _mcpDevice, PIN_I2C_INT_A)
+    , _tempControl(&_eventChannel, PIN_TEMP_SENSE)
+    , _battControl(&_eventChannel, PIN_BATT_LEVEL_SENSE)
+    , _currentControl(&_eventChannel, PIN_CURRENT_SENSE)
+    , _adcSource()
+    , _adcSampler(&_adcSource)
+    , _buttonControl(&_eventChannel, _mcpDevice, PIN_I2C_INT_A)
     , _ledControl(_mcpDevice)
-    , _flashLog()
+    , _logStorage()
+    , _flashLog(&_logStorage)
     , _escController(PIN_ESC_PWM, 0, ESC_PWM_FREQUENCY)
     , _wifiManager(_config.wifiSsid, _config.wifiPassword)
     , _otaManager(_wifiManager, _config.otaHostname)
     , _devicesManager(_ledControl, _escController, _flashLog, _config, _wifiManager, _otaManager)
     , _stateMachine(_devicesManager)
-    , _uartCli(_config, _battControl, _currentControl, _tempControl, _escController)
+    , _jetsonLink(_eventChannel, _escController, _statsAggregator, _stateMachine)
+    , _telemetryUdpSink(_config, _wifiManager)
+    , _taskMonitor(_taskProfiler)
+    , _uartCli(_config, _battControl, _currentControl, _tempControl, _ds18b20Sensor.getBus(),
+               _escController, _statsAggregator, _mcpDevice, _taskMonitor, _eventChannel, _jetsonLink, _telemetryStream)
 {
 }
 
@@ -48,13 +58,12 @@ void MoaMainUnit::begin() {
     Serial.begin(115200);
     ESP_LOGI(TAG, "Moa ESC Controller starting...");
 
-    // Create event queue FIRST (producers need it)
-    _eventQueue = xQueueCreate(EVENT_QUEUE_SIZE, sizeof(ControlCommand));
-    if (_eventQueue == nullptr) {
-        ESP_LOGE(TAG, "Failed to create event queue!");
+    // Create event channel FIRST (producers need it)
+    if (!_eventChannel.begin()) {
+        ESP_LOGE(TAG, "Failed to create event channel!");
         return;
     }
-    ESP_LOGD(TAG, "Event queue created (size=%d)", EVENT_QUEUE_SIZE);
+    ESP_LOGD(TAG, "Event channel created (safety=%d, normal=%d)", MOA_EVENT_SAFETY_DEPTH, MOA_EVENT_NORMAL_DEPTH);
 
     // Create stats queue for telemetry
     _statsQueue = xQueueCreate(STATS_QUEUE_SIZE, sizeof(StatsReading));
@@ -64,18 +73,23 @@ void MoaMainUnit::begin() {
     }
     ESP_LOGD(TAG, "Stats queue created (size=%d)", STATS_QUEUE_SIZE);
 
+    // StatsTask -> TelemetryTask wake-up (one give per sealed batch, coalesced)
+    _telemetrySignal = xSemaphoreCreateBinary();
+    if (_telemetrySignal == nullptr) {
+        ESP_LOGE(TAG, "Failed to create telemetry signal!");
+        return;
+    }
+
     // Initialize stats aggregator
     _statsAggregator.begin();
+    ESP_LOGD(TAG, "Stats history: %u bytes", static_cast<unsigned>(MoaStatsHistory::getMemoryBytes()));
 
-    // Set event queue on all producers (queue was nullptr at construction time)
-    _tempControl.setEventQueue(_eventQueue);
-    _battControl.setEventQueue(_eventQueue);
-    _currentControl.setEventQueue(_eventQueue);
-    _buttonControl.setEventQueue(_eventQueue);
-    _devicesManager.setEventQueue(_eventQueue);
+    // Producers got the channel at construction; the timers start with it
+    _devicesManager.setEventQueue(&_eventChannel);
 
     // Set stats queue on sensor producers
     _tempControl.setStatsQueue(_statsQueue);
+    _ds18b20Sensor.setStatsQueue(_statsQueue);       // Motor and battery probes
     _battControl.setStatsQueue(_statsQueue);
     _currentControl.setStatsQueue(_statsQueue);
 
@@ -105,8 +119,8 @@ void MoaMainUnit::begin() {
     ESP_LOGI(TAG, "Moa ESC Controller ready.");
 }
 
-QueueHandle_t MoaMainUnit::getEventQueue() {
-    return _eventQueue;
+MoaEventChannel& MoaMainUnit::getEventChannel() {
+    return _eventChannel;
 }
 
 MoaTempControl& MoaMainUnit::getTempControl() {
@@ -121,6 +135,10 @@ MoaCurrentControl& MoaMainUnit::getCurrentControl() {
     return _currentControl;
 }
 
+MoaAdcSampler& MoaMainUnit::getAdcSampler() {
+    return _adcSampler;
+}
+
 MoaButtonControl& MoaMainUnit::getButtonControl() {
     return _buttonControl;
 }
@@ -141,6 +159,10 @@ QueueHandle_t MoaMainUnit::getStatsQueue() {
     return _statsQueue;
 }
 
+ConfigManager& MoaMainUnit::getConfig() {
+    return _config;
+}
+
 MoaStatsAggregator& MoaMainUnit::getStatsAggregator() {
     return _statsAggregator;
 }
@@ -149,6 +171,10 @@ MoaDevicesManager& MoaMainUnit::getDevicesManager() {
     return _devicesManager;
 }
 
+MoaTaskProfiler& MoaMainUnit::getTaskProfiler() {
+    return _taskProfiler;
+}
+
 UartCli& MoaMainUnit::getUartCli() {
     return _uartCli;
 }
@@ -157,6 +183,25 @@ MoaOTAManager& MoaMainUnit::getOTAManager() {
     return _otaManager;
 }
 
+MoaJetsonLink& MoaMainUnit::getJetsonLink() {
+    return _jetsonLink;
+}
+
+MoaTelemetryStream& MoaMainUnit::getTelemetryStream() {
+    return _telemetryStream;
+}
+
+SemaphoreHandle_t MoaMainUnit::getTelemetrySignal() {
+    return _telemetrySignal;
+}
+
+IMoaTelemetrySink& MoaMainUnit::getTelemetrySink() {
+    if (_config.telemetrySink == 1) {
+        return _telemetryUdpSink;
+    }
+    return _jetsonLink;
+}
+
 void MoaMainUnit::initI2C() {
     Wire.begin(PIN_I2C_SDA, PIN_I2C_SCL);
     ESP_LOGI(TAG, "I2C initialized (SDA=%d, SCL=%d)", PIN_I2C_SDA, PIN_I2C_SCL);
@@ -175,6 +220,10 @@ void MoaMainUnit::initHardware() {
         _tempControl.setSensor(&_ntcSensor);
         ESP_LOGI(TAG, "Temperature sensor backend: NTC");
     } else {
+        // Roles are bound to their ROM codes by the one search in begin()
+        for (uint8_t role = 0; role < TEMP_PROBE_MAX_COUNT; role++) {
+            _ds18b20Sensor.getBus().setRoleRom(role, _config.tempProbeRoms[role]);
+        }
         _tempControl.setSensor(&_ds18b20Sensor);
         ESP_LOGI(TAG, "Temperature sensor backend: DS18B20");
     }
@@ -189,6 +238,9 @@ void MoaMainUnit::initHardware() {
     _currentControl.begin();
     ESP_LOGI(TAG, "Current sensor initialized");
 
+    // Switch current and battery sensing to continuous ADC sampling
+    initAdcSampling();
+
     // Initialize button input with interrupt mode enabled
     _buttonControl.begin(true);  // Interrupt-driven mode
     ESP_LOGI(TAG, "Button input initialized (interrupt mode)");
@@ -209,13 +261,66 @@ void MoaMainUnit::initHardware() {
     ESP_LOGI(TAG, "ESC controller initialized (pin=%d, freq=%d)", PIN_ESC_PWM, ESC_PWM_FREQUENCY);
 }
 
+void MoaMainUnit::initAdcSampling() {
+#if ADC_CONTINUOUS_ENABLED
+    // The NTC backend reads ADC1 with one-shot conversions, which cannot run
+    // alongside the continuous driver: keep one-shot sensing in that case.
+    if (_config.tempSensorType == TempSensorType::NTC) {
+        ESP_LOGW(TAG, "NTC backend selected: continuous ADC disabled, using one-shot reads");
+        return;
+    }
+
+    int8_t currentSlot = _adcSampler.addChannel(PIN_CURRENT_SENSE);
+    int8_t battSlot = _adcSampler.addChannel(PIN_BATT_LEVEL_SENSE);
+    _adcSampler.setSampleRate(ADC_CONTINUOUS_SAMPLE_RATE_HZ);
+    _adcSampler.setOversampling(ADC_OVERSAMPLING_FACTOR);
+
+    if (currentSlot < 0 || battSlot < 0 || !_adcSampler.begin()) {
+        ESP_LOGW(TAG, "Continuous ADC start failed, using one-shot reads");
+        return;
+    }
+
+    _currentControl.setAdcSampler(&_adcSampler, currentSlot);
+    _battControl.setAdcSampler(&_adcSampler, battSlot);
+    ESP_LOGI(TAG, "Continuous ADC sampling started (rate=%dHz, oversampling=%d)",
+             ADC_CONTINUOUS_SAMPLE_RATE_HZ, ADC_OVERSAMPLING_FACTOR);
+
+    // Fast overcurrent path: every raw current conversion goes through the trip
+    MoaOvercurrentTrip& trip = _currentControl.getFastTrip();
+    trip.setTripHandler(onFastTrip, this);
+    _adcSampler.setTripMonitor(currentSlot, &trip);
+    _devicesManager.setOvercurrentTrip(&trip);
+    trip.arm();
+    ESP_LOGI(TAG, "Fast overcurrent trip armed (high=%d, low=%d raw, count=%d, blanking=%d)",
+             trip.getHighThreshold(), trip.getLowThreshold(),
+             trip.getTripCount(), trip.getBlankingSamples());
+#endif
+}
+
+void MoaMainUnit::onFastTrip(int8_t direction, uint16_t rawAdc, void* context) {
+    MoaMainUnit* unit = static_cast<MoaMainUnit*>(context);
+
+    // Cut the motor first - everything else can wait
+    unit->_escController.trip();
+
+    CurrentEvent event((direction > 0) ? COMMAND_CURRENT_OVERCURRENT : COMMAND_CURRENT_REVERSE_OVERCURRENT,
+                       static_cast<int16_t>(moaDivRound(unit->_currentControl.rawToMilliamps(rawAdc), 100)));
+    unit->_eventChannel.push(event);  // Safety lane: ahead of pending button/timer events
+
+    ESP_LOGW(TAG, "Fast overcurrent trip (dir=%d, raw=%d, I=%.1fA)", direction, rawAdc, event.getDeciAmps() / 10.0f);
+}
+
 void MoaMainUnit::applyConfiguration() {
     // NVS settings were already loaded in begin() before initHardware()
     _wifiManager.setCredentials(_config.wifiSsid, _config.wifiPassword);
     _otaManager.setHostname(_config.otaHostname);
 
     // Apply NVS-backed settings to sensor devices and ESC
-    _config.applyTo(_battControl, _currentControl, _tempControl, _escController);
+    _config.applyTo(_battControl, _currentControl, _tempControl, _ds18b20Sensor.getBus(), _escController,
+                    _telemetryStream, _statsAggregator);
+
+    // Lifetime energy carries on from the last NVS save
+    _statsAggregator.setEnergyLifetime(_config.energyLifetimeMah, _config.energyLifetimeMwh);
 
     // Button configuration (not user-tunable, stays hardcoded)
     _buttonControl.setDebounceTime(BUTTON_DEBOUNCE_MS);
@@ -229,6 +334,30 @@ void MoaMainUnit::applyConfiguration() {
 }
 
 void MoaMainUnit::createTasks() {
+    // Describe every task before the first one can run
+    _taskProfiler.configure(MOA_PERF_PROTECTION, "protection", TASK_STACK_PROTECTION, TASK_PROTECTION_PERIOD_MS);
+    _taskProfiler.configure(MOA_PERF_SENSOR, "sensor", TASK_STACK_SENSOR, TASK_SENSOR_PERIOD_MS);
+    _taskProfiler.configure(MOA_PERF_IO, "io", TASK_STACK_IO, TASK_IO_PERIOD_MS);
+    _taskProfiler.configure(MOA_PERF_CONTROL, "control", TASK_STACK_CONTROL, 0);
+    _taskProfiler.configure(MOA_PERF_STATS, "stats", TASK_STACK_STATS, 0);
+    _taskProfiler.configure(MOA_PERF_CLI, "cli", TASK_STACK_CLI, TASK_CLI_PERIOD_MS);
+    _taskProfiler.configure(MOA_PERF_OTA, "ota", TASK_STACK_OTA, TASK_OTA_PERIOD_MS);
+    _taskProfiler.configure(MOA_PERF_LINK, "link", TASK_STACK_LINK, 0);
+    _taskProfiler.configure(MOA_PERF_TELEMETRY, "telemetry", TASK_STACK_TELEMETRY, 0);
+
+    // Create ProtectionTask (highest priority: drains the ADC, fast trip)
+    xTaskCreatePinnedToCore(
+        ProtectionTask,
+        "ProtectionTask",
+        TASK_STACK_PROTECTION,
+        this,
+        TASK_PRIORITY_PROTECTION,
+        &_protectionTaskHandle,
+        0
+    );
+    ESP_LOGI(TAG, "ProtectionTask created (stack=%d, prio=%d)", TASK_STACK_PROTECTION, TASK_PRIORITY_PROTECTION);
+    _taskMonitor.setHandle(MOA_PERF_PROTECTION, _protectionTaskHandle);
+
     // Create SensorTask
     xTaskCreatePinnedToCore(
         SensorTask,
@@ -240,6 +369,7 @@ void MoaMainUnit::createTasks() {
         0  // Core 0 (ESP32-C3 is single-core)
     );
     ESP_LOGI(TAG, "SensorTask created (stack=%d, prio=%d)", TASK_STACK_SENSOR, TASK_PRIORITY_SENSOR);
+    _taskMonitor.setHandle(MOA_PERF_SENSOR, _sensorTaskHandle);
 
     // Create IOTask
     xTaskCreatePinnedToCore(
@@ -252,6 +382,7 @@ void MoaMainUnit::createTasks() {
         0
     );
     ESP_LOGI(TAG, "IOTask created (stack=%d, prio=%d)", TASK_STACK_IO, TASK_PRIORITY_IO);
+    _taskMonitor.setHandle(MOA_PERF_IO, _ioTaskHandle);
 
     // Create ControlTask
     xTaskCreatePinnedToCore(
@@ -264,6 +395,7 @@ void MoaMainUnit::createTasks() {
         0
     );
     ESP_LOGI(TAG, "ControlTask created (stack=%d, prio=%d)", TASK_STACK_CONTROL, TASK_PRIORITY_CONTROL);
+    _taskMonitor.setHandle(MOA_PERF_CONTROL, _controlTaskHandle);
 
     // Create StatsTask
     xTaskCreatePinnedToCore(
@@ -276,6 +408,7 @@ void MoaMainUnit::createTasks() {
         0
     );
     ESP_LOGI(TAG, "StatsTask created (stack=%d, prio=%d)", TASK_STACK_STATS, TASK_PRIORITY_STATS);
+    _taskMonitor.setHandle(MOA_PERF_STATS, _statsTaskHandle);
 
     // Create CliTask
     xTaskCreatePinnedToCore(
@@ -288,6 +421,7 @@ void MoaMainUnit::createTasks() {
         0
     );
     ESP_LOGI(TAG, "CliTask created (stack=%d, prio=%d)", TASK_STACK_CLI, TASK_PRIORITY_CLI);
+    _taskMonitor.setHandle(MOA_PERF_CLI, _cliTaskHandle);
 
     // Create OtaTask
     xTaskCreatePinnedToCore(
@@ -300,4 +434,31 @@ void MoaMainUnit::createTasks() {
         0
     );
     ESP_LOGI(TAG, "OtaTask created (stack=%d, prio=%d)", TASK_STACK_OTA, TASK_PRIORITY_OTA);
+    _taskMonitor.setHandle(MOA_PERF_OTA, _otaTaskHandle);
+
+    // Create LinkTask (above ControlTask: a frame is decoded and queued as soon as it ends)
+    xTaskCreatePinnedToCore(
+        LinkTask,
+        "LinkTask",
+        TASK_STACK_LINK,
+        this,
+        TASK_PRIORITY_LINK,
+        &_linkTaskHandle,
+        0
+    );
+    ESP_LOGI(TAG, "LinkTask created (stack=%d, prio=%d)", TASK_STACK_LINK, TASK_PRIORITY_LINK);
+    _taskMonitor.setHandle(MOA_PERF_LINK, _linkTaskHandle);
+
+    // Create TelemetryTask (lowest priority: woken by StatsTask when a batch is sealed)
+    xTaskCreatePinnedToCore(
+        TelemetryTask,
+        "TelemetryTask",
+        TASK_STACK_TELEMETRY,
+        this,
+        TASK_PRIORITY_TELEMETRY,
+        &_telemetryTaskHandle,
+        0
+    );
+    ESP_LOGI(TAG, "TelemetryTask created (stack=%d, prio=%d)", TASK_STACK_TELEMETRY, TASK_PRIORITY_TELEMETRY);
+    _taskMonitor.setHandle(MOA_PERF_TELEMETRY, _telemetryTaskHandle);
 }
@@ -0,0 +1,161 @@
+/**
+ * @file MoaMcpRegisterFile.cpp
+ * @brief Implementation of the MoaMcpRegisterFile class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaMcpRegisterFile.h"
+#include <string.h>
+
+static_assert(MCP23018_REG_COUNT <= 32, "Unknown-register mask is 32 bits");
+
+MoaMcpRegisterFile::MoaMcpRegisterFile(II2cBus* bus, uint8_t address)
+    : _bus(bus)
+    , _address(address)
+    , _unknown(0)
+    , _transactions(0)
+    , _bytes(0)
+    , _skipped(0)
+    , _errors(0)
+{
+    for (uint8_t reg = 0; reg < MCP23018_REG_COUNT; reg++) {
+        _wanted[reg] = powerOnValue(reg);
+        _device[reg] = _wanted[reg];
+    }
+    invalidate();
+}
+
+uint8_t MoaMcpRegisterFile::powerOnValue(uint8_t reg) {
+    // Only the direction registers come up non-zero (all inputs)
+    return (reg == MCP23018_REG_IODIRA || reg == MCP23018_REG_IODIRB) ? 0xFF : 0x00;
+}
+
+bool MoaMcpRegisterFile::begin() {
+    uint8_t values[MCP23018_REG_COUNT];
+    if (!read(0, values, sizeof(values))) {
+        invalidate();
+        return false;
+    }
+
+    memcpy(_device, values, sizeof(values));
+    memcpy(_wanted, values, sizeof(values));
+    _wanted[MCP23018_REG_IOCON] &= ~(MCP23018_IOCON_BANK | MCP23018_IOCON_SEQOP);
+    _wanted[MCP23018_REG_IOCON2] = _wanted[MCP23018_REG_IOCON];
+    _unknown = 0;
+    return true;
+}
+
+void MoaMcpRegisterFile::resetToPowerOn() {
+    for (uint8_t reg = 0; reg < MCP23018_REG_COUNT; reg++) {
+        _device[reg] = powerOnValue(reg);
+    }
+    _unknown = 0;
+}
+
+void MoaMcpRegisterFile::invalidate() {
+    _unknown = (1UL << MCP23018_REG_COUNT) - 1;
+}
+
+uint8_t MoaMcpRegisterFile::get(uint8_t reg) const {
+    return (reg < MCP23018_REG_COUNT) ? _wanted[reg] : 0;
+}
+
+void MoaMcpRegisterFile::set(uint8_t reg, uint8_t value) {
+    if (reg == MCP23018_REG_GPIOA || reg == MCP23018_REG_GPIOB) {
+        // Writing GPIO writes the output latch
+        reg = static_cast<uint8_t>(reg + (MCP23018_REG_OLATA - MCP23018_REG_GPIOA));
+    }
+
+    if (reg == MCP23018_REG_IOCON || reg == MCP23018_REG_IOCON2) {
+        value &= ~(MCP23018_IOCON_BANK | MCP23018_IOCON_SEQOP);
+        _wanted[MCP23018_REG_IOCON] = value;
+        _wanted[MCP23018_REG_IOCON2] = value;
+    } else if (reg <= MCP23018_REG_GPPUB || reg == MCP23018_REG_OLATA || reg == MCP23018_REG_OLATB) {
+        _wanted[reg] = value;
+    }
+}
+
+void MoaMcpRegisterFile::setBits(uint8_t reg, uint8_t mask, uint8_t bits) {
+    if (reg >= MCP23018_REG_COUNT) {
+        return;
+    }
+    set(reg, static_cast<uint8_t>((get(reg) & ~mask) | (bits & mask)));
+}
+
+bool MoaMcpRegisterFile::commit() {
+    bool wrote = false;
+    bool ok = commitRange(MCP23018_REG_IODIRA, MCP23018_REG_GPPUB, wrote);
+    ok = commitRange(MCP23018_REG_OLATA, MCP23018_REG_OLATB, wrote) && ok;
+
+    if (!wrote) {
+        _skipped++;
+    }
+    return ok;
+}
+
+bool MoaMcpRegisterFile::commitRange(uint8_t first, uint8_t last, bool& wrote) {
+    int16_t lo = -1;
+    int16_t hi = -1;
+    for (uint8_t reg = first; reg <= last; reg++) {
+        bool unknown = (_unknown & (1UL << reg)) != 0;
+        if (unknown || _wanted[reg] != _device[reg]) {
+            if (lo < 0) {
+                lo = reg;
+            }
+            hi = reg;
+        }
+    }
+    if (lo < 0) {
+        return true;
+    }
+
+    // Registers between lo and hi that already match are rewritten unchanged
+    size_t count = static_cast<size_t>(hi - lo + 1);
+    _transactions++;
+    wrote = true;
+    if (_bus == nullptr || !_bus->writeRegisters(_address, static_cast<uint8_t>(lo), &_wanted[lo], count)) {
+        _errors++;
+        for (int16_t reg = lo; reg <= hi; reg++) {
+            _unknown |= (1UL << reg);
+        }
+        return false;
+    }
+
+    _bytes += static_cast<uint32_t>(count);
+    for (int16_t reg = lo; reg <= hi; reg++) {
+        _device[reg] = _wanted[reg];
+        _unknown &= ~(1UL << reg);
+    }
+    return true;
+}
+
+bool MoaMcpRegisterFile::read(uint8_t reg, uint8_t* out, size_t count) {
+    if (out == nullptr || count == 0 || reg + count > MCP23018_REG_COUNT) {
+        return false;
+    }
+
+    _transactions++;
+    if (_bus == nullptr || !_bus->readRegisters(_address, reg, out, count)) {
+        _errors++;
+        return false;
+    }
+    _bytes += static_cast<uint32_t>(count);
+    return true;
+}
+
+uint32_t MoaMcpRegisterFile::getTransactionCount() const {
+    return _transactions;
+}
+
+uint32_t MoaMcpRegisterFile::getBytesTransferred() const {
+    return _bytes;
+}
+
+uint32_t MoaMcpRegisterFile::getSkippedWrites() const {
+    return _skipped;
+}
+
+uint32_t MoaMcpRegisterFile::getErrorCount() const {
+    return _errors;
+}
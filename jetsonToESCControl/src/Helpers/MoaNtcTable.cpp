@@ -0,0 +1,119 @@
+/**
+ * @file MoaNtcTable.cpp
+ * @brief Generation and lookup of the NTC table
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaNtcTable.h"
+
+static_assert((NTC_LUT_STEP_MV & (NTC_LUT_STEP_MV - 1)) == 0, "NTC_LUT_STEP_MV must be a power of two");
+static_assert((NTC_OVERSAMPLING & (NTC_OVERSAMPLING - 1)) == 0 &&
+              NTC_OVERSAMPLING <= (1 << MOA_NTC_MV_FRAC_BITS), "NTC_OVERSAMPLING must be a power of two <= 16");
+
+// =============================================================================
+// Beta equation (C++11 constexpr: recursion instead of loops)
+// =============================================================================
+
+static constexpr double kLn2 = 0.69314718055994530942;
+static constexpr int kLnTerms = 20;
+
+/**
+ * @brief 2 x (z + z^3/3 + z^5/5 + ...), z = (m - 1) / (m + 1)
+ */
+static constexpr double lnSeries(double z2, double term, int n) {
+    return n >= kLnTerms ? 0.0 : term / (2 * n + 1) + lnSeries(z2, term * z2, n + 1);
+}
+
+static constexpr double lnNearOne(double z) {
+    return 2.0 * lnSeries(z * z, z, 0);
+}
+
+/**
+ * @brief Natural logarithm: halve or double into [1, 2), then the series
+ */
+static constexpr double ln(double x) {
+    return x >= 2.0 ? ln(x / 2.0) + kLn2
+         : x < 1.0  ? ln(x * 2.0) - kLn2
+         : lnNearOne((x - 1.0) / (x + 1.0));
+}
+
+static constexpr double betaCelsius(double resistance) {
+    return 1.0 / (1.0 / (NTC_NOMINAL_TEMP_C + 273.15) +
+                  ln(resistance / NTC_NOMINAL_RESISTANCE) / NTC_BETA_COEFFICIENT) - 273.15;
+}
+
+static constexpr double clampCenti(double centi) {
+    return centi < MOA_NTC_MIN_CC ? MOA_NTC_MIN_CC : centi > MOA_NTC_MAX_CC ? MOA_NTC_MAX_CC : centi;
+}
+
+static constexpr int16_t roundCenti(double centi) {
+    return static_cast<int16_t>(centi >= 0.0 ? centi + 0.5 : centi - 0.5);
+}
+
+/**
+ * @brief Entry at millivolts: 0 V is a short (hot), the reference is an open (cold)
+ */
+static constexpr int16_t entryAt(double mv) {
+    return mv <= 0.0 ? MOA_NTC_MAX_CC
+         : mv >= NTC_ADC_VREF_MV ? MOA_NTC_MIN_CC
+         : roundCenti(clampCenti(100.0 * betaCelsius(NTC_REFERENCE_RESISTANCE * mv / (NTC_ADC_VREF_MV - mv))));
+}
+
+// =============================================================================
+// Table
+// =============================================================================
+
+template <size_t... Is>
+struct NtcIndices {};
+
+template <size_t N, size_t... Is>
+struct MakeNtcIndices : MakeNtcIndices<N - 1, N - 1, Is...> {};
+
+template <size_t... Is>
+struct MakeNtcIndices<0, Is...> {
+    typedef NtcIndices<Is...> type;
+};
+
+template <typename Indices>
+struct NtcTable;
+
+template <size_t... Is>
+struct NtcTable<NtcIndices<Is...> > {
+    static constexpr int16_t values[sizeof...(Is)] = { entryAt(static_cast<double>(Is) * NTC_LUT_STEP_MV)... };
+};
+
+template <size_t... Is>
+constexpr int16_t NtcTable<NtcIndices<Is...> >::values[sizeof...(Is)];
+
+typedef NtcTable<MakeNtcIndices<MOA_NTC_TABLE_SIZE>::type> Table;
+
+// Spot checks of the generator: the divider midpoint is the nominal point
+static_assert(NTC_REFERENCE_RESISTANCE != NTC_NOMINAL_RESISTANCE || NTC_ADC_VREF_MV % 2 != 0 ||
+              entryAt(NTC_ADC_VREF_MV / 2) == roundCenti(100.0 * NTC_NOMINAL_TEMP_C),
+              "NTC table: nominal point");
+static_assert(Table::values[0] == MOA_NTC_MAX_CC && Table::values[MOA_NTC_TABLE_SIZE - 1] == MOA_NTC_MIN_CC,
+              "NTC table: ends must read as short / open");
+
+// =============================================================================
+// Lookup
+// =============================================================================
+
+static const uint32_t STEP_SHIFT = MOA_NTC_MV_FRAC_BITS + __builtin_ctz(NTC_LUT_STEP_MV);
+static const uint32_t FRAC_MASK = (1UL << STEP_SHIFT) - 1;
+static const uint32_t MAX_INPUT = static_cast<uint32_t>(NTC_ADC_VREF_MV) << MOA_NTC_MV_FRAC_BITS;
+
+int32_t moaNtcCentiCelsius(uint32_t millivoltsQ4) {
+    if (millivoltsQ4 >= MAX_INPUT) {
+        return MOA_NTC_MIN_CC;
+    }
+    uint32_t index = millivoltsQ4 >> STEP_SHIFT;
+    int32_t frac = static_cast<int32_t>(millivoltsQ4 & FRAC_MASK);
+    int32_t low = Table::values[index];
+    int32_t high = Table::values[index + 1];
+    return low + (((high - low) * frac) >> STEP_SHIFT);
+}
+
+int16_t moaNtcTableEntry(size_t index) {
+    return (index < MOA_NTC_TABLE_SIZE) ? Table::values[index] : MOA_NTC_MIN_CC;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file MoaOvercurrentTrip.cpp
+ * @brief Implementation of the MoaOvercurrentTrip class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaOvercurrentTrip.h"
+
+MoaOvercurrentTrip::MoaOvercurrentTrip()
+    : _highRaw(0)
+    , _lowRaw(0)
+    , _blankingSamples(0)
+    , _tripCount(1)
+    , _handler(nullptr)
+    , _handlerContext(nullptr)
+    , _armed(false)
+    , _tripped(false)
+    , _blankRemaining(0)
+    , _overCount(0)
+    , _underCount(0)
+    , _tripDirection(0)
+    , _tripRaw(0)
+    , _tripTotal(0)
+{
+}
+
+void MoaOvercurrentTrip::setThresholds(uint16_t highRaw, uint16_t lowRaw) {
+    _highRaw = highRaw;
+    _lowRaw = lowRaw;
+}
+
+uint16_t MoaOvercurrentTrip::getHighThreshold() const {
+    return _highRaw;
+}
+
+uint16_t MoaOvercurrentTrip::getLowThreshold() const {
+    return _lowRaw;
+}
+
+void MoaOvercurrentTrip::setBlankingSamples(uint16_t samples) {
+    _blankingSamples = samples;
+}
+
+uint16_t MoaOvercurrentTrip::getBlankingSamples() const {
+    return _blankingSamples;
+}
+
+void MoaOvercurrentTrip::setTripCount(uint8_t count) {
+    _tripCount = (count > 0) ? count : 1;
+}
+
+uint8_t MoaOvercurrentTrip::getTripCount() const {
+    return _tripCount;
+}
+
+void MoaOvercurrentTrip::setTripHandler(MoaTripHandler handler, void* context) {
+    _handler = handler;
+    _handlerContext = context;
+}
+
+void MoaOvercurrentTrip::arm() {
+    _overCount = 0;
+    _underCount = 0;
+    _blankRemaining = _blankingSamples;
+    _tripped = false;
+    _armed = true;
+}
+
+void MoaOvercurrentTrip::disarm() {
+    _armed = false;
+}
+
+void MoaOvercurrentTrip::blank() {
+    _blankRemaining = _blankingSamples;
+}
+
+bool MoaOvercurrentTrip::feed(uint16_t rawAdc) {
+    if (!_armed.load(std::memory_order_relaxed) || _tripped.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    uint16_t blanking = _blankRemaining.load(std::memory_order_relaxed);
+    if (blanking > 0) {
+        _blankRemaining.store(blanking - 1, std::memory_order_relaxed);
+        _overCount = 0;
+        _underCount = 0;
+        return false;
+    }
+
+    // Count consecutive out-of-range samples; any in-range sample resets
+    if (_highRaw != 0 && rawAdc >= _highRaw) {
+        _underCount = 0;
+        if (++_overCount >= _tripCount) {
+            trip(1, rawAdc);
+            return true;
+        }
+    } else if (_lowRaw != 0 && rawAdc <= _lowRaw) {
+        _overCount = 0;
+        if (++_underCount >= _tripCount) {
+            trip(-1, rawAdc);
+            return true;
+        }
+    } else {
+        _overCount = 0;
+        _underCount = 0;
+    }
+    return false;
+}
+
+bool MoaOvercurrentTrip::isTripped() const {
+    return _tripped;
+}
+
+bool MoaOvercurrentTrip::isArmed() const {
+    return _armed;
+}
+
+int8_t MoaOvercurrentTrip::getTripDirection() const {
+    return _tripDirection;
+}
+
+uint16_t MoaOvercurrentTrip::getTripRaw() const {
+    return _tripRaw;
+}
+
+uint32_t MoaOvercurrentTrip::getTripTotal() const {
+    return _tripTotal;
+}
+
+void MoaOvercurrentTrip::trip(int8_t direction, uint16_t rawAdc) {
+    _tripDirection = direction;
+    _tripRaw = rawAdc;
+    _tripTotal++;
+    _tripped = true;
+
+    // The handler cuts the ESC output, then notifies the state machine
+    if (_handler != nullptr) {
+        _handler(direction, rawAdc, _handlerContext);
+    }
+}
@@ -6,102 +6,117 @@
  */
 
 #include "MoaStatsAggregator.h"
-#include "esp_log.h"
+#include <string.h>
 
-static const char* TAG = "Stats";
-
-MoaStatsAggregator::MoaStatsAggregator()
-    : _mutex(nullptr)
-{
-    _stats.temperatureX10 = 0;
-    _stats.batteryVoltageMv = 0;
-    _stats.currentX10 = 0;
-    _stats.tempTimestamp = 0;
-    _stats.battTimestamp = 0;
-    _stats.currentTimestamp = 0;
-}
-
-MoaStatsAggregator::~MoaStatsAggregator() {
-    if (_mutex != nullptr) {
-        vSemaphoreDelete(_mutex);
-        _mutex = nullptr;
-    }
+MoaStatsAggregator::MoaStatsAggregator() {
+    memset(&_stats, 0, sizeof(_stats));
 }
 
 void MoaStatsAggregator::begin() {
-    _mutex = xSemaphoreCreateMutex();
-    ESP_LOGD(TAG, "Stats aggregator initialized");
+    memset(&_stats, 0, sizeof(_stats));
+    _history.reset();
+    _snapshot.reset();
+    _summary.reset();
+    _energy.reset();
+    _energyReport.reset();
 }
 
 void MoaStatsAggregator::update(const StatsReading& reading) {
-    if (_mutex == nullptr) {
-        return;
+    switch (reading.statsType) {
+        case STATS_TYPE_TEMPERATURE:
+            _stats.temperatureX10 = static_cast<int16_t>(reading.value);
+            _stats.tempTimestamp = reading.timestamp;
+            break;
+
+        case STATS_TYPE_BATTERY:
+            _stats.batteryVoltageMv = static_cast<int16_t>(reading.value);
+            _stats.battTimestamp = reading.timestamp;
+            break;
+
+        case STATS_TYPE_CURRENT:
+            _stats.currentX10 = static_cast<int16_t>(reading.value);
+            _stats.currentTimestamp = reading.timestamp;
+            break;
+
+        case STATS_TYPE_TEMP_MOTOR:
+            _stats.motorTempX10 = static_cast<int16_t>(reading.value);
+            _stats.motorTempTimestamp = reading.timestamp;
+            _snapshot.write(_stats);
+            return;                                 // Snapshot only: no history channel
+
+        case STATS_TYPE_TEMP_BATTERY:
+            _stats.batteryTempX10 = static_cast<int16_t>(reading.value);
+            _stats.batteryTempTimestamp = reading.timestamp;
+            _snapshot.write(_stats);
+            return;
+
+        default:
+            return;
     }
 
-    if (xSemaphoreTake(_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        switch (reading.statsType) {
-            case STATS_TYPE_TEMPERATURE:
-                _stats.temperatureX10 = static_cast<int16_t>(reading.value);
-                _stats.tempTimestamp = reading.timestamp;
-                break;
-
-            case STATS_TYPE_BATTERY:
-                _stats.batteryVoltageMv = static_cast<int16_t>(reading.value);
-                _stats.battTimestamp = reading.timestamp;
-                break;
-
-            case STATS_TYPE_CURRENT:
-                _stats.currentX10 = static_cast<int16_t>(reading.value);
-                _stats.currentTimestamp = reading.timestamp;
-                break;
-
-            default:
-                break;
-        }
-        xSemaphoreGive(_mutex);
+    _snapshot.write(_stats);
+
+    if (reading.statsType != STATS_TYPE_TEMPERATURE) {
+        _energy.add(reading);
+        _energyReport.write(_energy.getReport());
     }
+
+    _history.add(reading);
+    StatsHistorySummary summary;
+    _history.getSummary(&summary);
+    summary.energyMwh = _energy.getReport().sessionMwh;  // Single integrator: the energy meter
+    _summary.write(summary);
 }
 
-StatsSnapshot MoaStatsAggregator::getSnapshot() {
-    StatsSnapshot snapshot = {};
+StatsSnapshot MoaStatsAggregator::getSnapshot() const {
+    return _snapshot.read();
+}
 
-    if (_mutex != nullptr && xSemaphoreTake(_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        snapshot = _stats;
-        xSemaphoreGive(_mutex);
-    }
+StatsHistorySummary MoaStatsAggregator::getSummary() const {
+    return _summary.read();
+}
+
+const MoaStatsHistory& MoaStatsAggregator::getHistory() const {
+    return _history;
+}
 
-    return snapshot;
+MoaEnergyReport MoaStatsAggregator::getEnergy() const {
+    return _energyReport.read();
 }
 
-int16_t MoaStatsAggregator::getTemperatureX10() {
-    int16_t value = 0;
+void MoaStatsAggregator::setBattery(uint32_t capacityMah, uint16_t fullMv, uint16_t emptyMv) {
+    _energy.setBattery(capacityMah, fullMv, emptyMv);
+}
 
-    if (_mutex != nullptr && xSemaphoreTake(_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        value = _stats.temperatureX10;
-        xSemaphoreGive(_mutex);
-    }
+void MoaStatsAggregator::setEnergyLifetime(int32_t mah, int32_t mwh) {
+    _energy.setLifetime(mah, mwh);
+    _energyReport.write(_energy.getReport());
+}
 
-    return value;
+bool MoaStatsAggregator::isEnergySaveDue(uint32_t nowMs) const {
+    return _energy.isSaveDue(nowMs);
 }
 
-int16_t MoaStatsAggregator::getBatteryVoltageMv() {
-    int16_t value = 0;
+void MoaStatsAggregator::markEnergySaved(uint32_t nowMs) {
+    _energy.markSaved(nowMs);
+}
 
-    if (_mutex != nullptr && xSemaphoreTake(_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        value = _stats.batteryVoltageMv;
-        xSemaphoreGive(_mutex);
-    }
+int16_t MoaStatsAggregator::getTemperatureX10() const {
+    return getSnapshot().temperatureX10;
+}
 
-    return value;
+int16_t MoaStatsAggregator::getBatteryVoltageMv() const {
+    return getSnapshot().batteryVoltageMv;
 }
 
-int16_t MoaStatsAggregator::getCurrentX10() {
-    int16_t value = 0;
+int16_t MoaStatsAggregator::getCurrentX10() const {
+    return getSnapshot().currentX10;
+}
 
-    if (_mutex != nullptr && xSemaphoreTake(_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        value = _stats.currentX10;
-        xSemaphoreGive(_mutex);
-    }
+uint32_t MoaStatsAggregator::getUpdateCount() const {
+    return _snapshot.getVersion();
+}
 
-    return value;
+uint32_t MoaStatsAggregator::getReadRetries() const {
+    return _snapshot.getReadRetries() + _summary.getReadRetries() + _energyReport.getReadRetries();
 }
@@ -0,0 +1,206 @@
+/**
+ * @file MoaStatsHistory.cpp
+ * @brief Implementation of the MoaStatsHistory class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaStatsHistory.h"
+#include <string.h>
+
+/**
+ * @brief Ring layout inside each channel's flat bucket array
+ */
+static const uint16_t RING_LENGTH[STATS_RES_COUNT] = {
+    STATS_HISTORY_RAW_LENGTH,
+    STATS_HISTORY_1S_LENGTH,
+    STATS_HISTORY_10S_LENGTH,
+    STATS_HISTORY_1MIN_LENGTH
+};
+
+static const uint16_t RING_OFFSET[STATS_RES_COUNT] = {
+    0,
+    STATS_HISTORY_RAW_LENGTH,
+    STATS_HISTORY_RAW_LENGTH + STATS_HISTORY_1S_LENGTH,
+    STATS_HISTORY_RAW_LENGTH + STATS_HISTORY_1S_LENGTH + STATS_HISTORY_10S_LENGTH
+};
+
+static const uint32_t RING_PERIOD_MS[STATS_RES_COUNT] = { 0, 1000, 10000, 60000 };
+
+static int32_t divRound64(int64_t value, int64_t divisor) {
+    return static_cast<int32_t>((value >= 0) ? (value + divisor / 2) / divisor
+                                             : (value - divisor / 2) / divisor);
+}
+
+int16_t StatsBucket::mean() const {
+    if (count == 0) {
+        return 0;
+    }
+    return static_cast<int16_t>(divRound64(sum, count));
+}
+
+MoaStatsHistory::MoaStatsHistory() {
+    reset();
+}
+
+void MoaStatsHistory::reset() {
+    memset(_buckets, 0, sizeof(_buckets));
+    memset(_rings, 0, sizeof(_rings));
+    memset(_session, 0, sizeof(_session));
+    _started = false;
+    _sessionStartMs = 0;
+}
+
+int8_t MoaStatsHistory::channelIndex(uint8_t statsType) {
+    if (statsType < STATS_TYPE_TEMPERATURE || statsType > STATS_TYPE_CURRENT) {
+        return -1;
+    }
+    return static_cast<int8_t>(statsType - STATS_TYPE_TEMPERATURE);
+}
+
+void MoaStatsHistory::add(const StatsReading& reading) {
+    int8_t ch = channelIndex(reading.statsType);
+    if (ch < 0) {
+        return;
+    }
+
+    int16_t value = static_cast<int16_t>(reading.value);
+    uint32_t t = reading.timestamp;
+
+    if (!_started) {
+        _started = true;
+        _sessionStartMs = t;
+    }
+
+    // Session
+    Session& s = _session[ch];
+    if (s.count == 0 || value < s.min) s.min = value;
+    if (s.count == 0 || value > s.max) s.max = value;
+    s.sum += value;
+    s.count++;
+
+    // Raw ring: one single-reading bucket per sample
+    StatsBucket raw;
+    raw.startMs = t;
+    raw.sum = value;
+    raw.min = value;
+    raw.max = value;
+    raw.count = 1;
+    raw.reserved = 0;
+    push(ch, STATS_RES_RAW, raw);
+
+    // Timed rings: fold into the open bucket, close it on a period change
+    for (uint8_t res = STATS_RES_1S; res < STATS_RES_COUNT; res++) {
+        StatsBucket& open = _rings[ch][res].open;
+        uint32_t period = RING_PERIOD_MS[res];
+
+        if (open.count > 0 && t / period > open.startMs / period) {
+            push(ch, res, open);
+            open.count = 0;
+        }
+
+        if (open.count == 0) {
+            open.startMs = t - (t % period);
+            open.sum = 0;
+            open.min = value;
+            open.max = value;
+        }
+
+        if (value < open.min) open.min = value;
+        if (value > open.max) open.max = value;
+        if (open.count < UINT16_MAX) {
+            open.sum += value;
+            open.count++;
+        }
+    }
+}
+
+void MoaStatsHistory::push(uint8_t channel, uint8_t resolution, const StatsBucket& bucket) {
+    Ring& ring = _rings[channel][resolution];
+    uint16_t length = RING_LENGTH[resolution];
+
+    _buckets[channel][RING_OFFSET[resolution] + ring.head] = bucket;
+    ring.head = static_cast<uint16_t>((ring.head + 1) % length);
+    if (ring.count < length) {
+        ring.count++;
+    }
+}
+
+uint16_t MoaStatsHistory::getCount(uint8_t statsType, uint8_t resolution) const {
+    int8_t ch = channelIndex(statsType);
+    if (ch < 0 || resolution >= STATS_RES_COUNT) {
+        return 0;
+    }
+    return _rings[ch][resolution].count;
+}
+
+bool MoaStatsHistory::getBucket(uint8_t statsType, uint8_t resolution, uint16_t age, StatsBucket* out) const {
+    int8_t ch = channelIndex(statsType);
+    if (ch < 0 || resolution >= STATS_RES_COUNT || out == nullptr) {
+        return false;
+    }
+
+    const Ring& ring = _rings[ch][resolution];
+    if (age >= ring.count) {
+        return false;
+    }
+
+    uint16_t length = RING_LENGTH[resolution];
+    uint16_t index = static_cast<uint16_t>((ring.head + length - 1 - age) % length);
+    *out = _buckets[ch][RING_OFFSET[resolution] + index];
+    return true;
+}
+
+bool MoaStatsHistory::getOpenBucket(uint8_t statsType, uint8_t resolution, StatsBucket* out) const {
+    int8_t ch = channelIndex(statsType);
+    if (ch < 0 || resolution == STATS_RES_RAW || resolution >= STATS_RES_COUNT || out == nullptr) {
+        return false;
+    }
+    *out = _rings[ch][resolution].open;
+    return true;
+}
+
+StatsSessionChannel MoaStatsHistory::getSession(uint8_t statsType) const {
+    StatsSessionChannel result;
+    memset(&result, 0, sizeof(result));
+
+    int8_t ch = channelIndex(statsType);
+    if (ch < 0 || _session[ch].count == 0) {
+        return result;
+    }
+
+    const Session& s = _session[ch];
+    result.min = s.min;
+    result.max = s.max;
+    result.mean = static_cast<int16_t>(divRound64(s.sum, s.count));
+    result.count = s.count;
+    return result;
+}
+
+void MoaStatsHistory::getSummary(StatsHistorySummary* out) const {
+    if (out == nullptr) {
+        return;
+    }
+
+    memset(out, 0, sizeof(*out));
+    for (uint8_t ch = 0; ch < STATS_CHANNEL_COUNT; ch++) {
+        uint8_t type = static_cast<uint8_t>(STATS_TYPE_TEMPERATURE + ch);
+        out->session[ch] = getSession(type);
+        for (uint8_t res = STATS_RES_1S; res < STATS_RES_COUNT; res++) {
+            getBucket(type, res, 0, &out->lastClosed[ch][res - STATS_RES_1S]);
+        }
+    }
+    out->sessionStartMs = _sessionStartMs;
+}
+
+size_t MoaStatsHistory::getMemoryBytes() {
+    return sizeof(MoaStatsHistory);
+}
+
+uint16_t MoaStatsHistory::getLength(uint8_t resolution) {
+    return (resolution < STATS_RES_COUNT) ? RING_LENGTH[resolution] : 0;
+}
+
+uint32_t MoaStatsHistory::getPeriodMs(uint8_t resolution) {
+    return (resolution < STATS_RES_COUNT) ? RING_PERIOD_MS[resolution] : 0;
+}
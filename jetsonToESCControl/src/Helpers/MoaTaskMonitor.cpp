@@ -0,0 +1,78 @@
+/**
+ * @file MoaTaskMonitor.cpp
+ * @brief Implementation of the MoaTaskMonitor class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaTaskMonitor.h"
+
+MoaTaskMonitor::MoaTaskMonitor(MoaTaskProfiler& profiler)
+    : _profiler(profiler)
+{
+    for (uint8_t i = 0; i < MOA_PERF_TASK_COUNT; i++) {
+        _handles[i] = nullptr;
+#if MOA_PERF_RUN_TIME_STATS
+        _runTimeBase[i] = 0;
+#endif
+    }
+#if MOA_PERF_RUN_TIME_STATS
+    _totalRunTimeBase = 0;
+#endif
+}
+
+void MoaTaskMonitor::setHandle(MoaPerfTask task, TaskHandle_t handle) {
+    if (task < MOA_PERF_TASK_COUNT) {
+        _handles[task] = handle;
+    }
+}
+
+void MoaTaskMonitor::sampleAll(MoaTaskPerf* out) {
+#if MOA_PERF_RUN_TIME_STATS
+    uint32_t totalRunTime = static_cast<uint32_t>(portGET_RUN_TIME_COUNTER_VALUE()) - _totalRunTimeBase;
+#endif
+
+    for (uint8_t i = 0; i < MOA_PERF_TASK_COUNT; i++) {
+        MoaPerfTask task = static_cast<MoaPerfTask>(i);
+        MoaTaskPerf& perf = out[i];
+        perf = _profiler.getPerf(task);
+
+        if (_handles[i] == nullptr) {
+            continue;
+        }
+
+        UBaseType_t freeBytes = uxTaskGetStackHighWaterMark(_handles[i]);
+        perf.stackFreeBytes = static_cast<uint16_t>((freeBytes < MOA_PERF_UNKNOWN) ? freeBytes : MOA_PERF_UNKNOWN - 1);
+
+#if MOA_PERF_RUN_TIME_STATS
+        if (totalRunTime > 0) {
+            uint64_t permille = static_cast<uint64_t>(getRunTime(task) - _runTimeBase[i]) * 1000ULL / totalRunTime;
+            perf.cpuPermille = static_cast<uint16_t>((permille > 1000) ? 1000 : permille);
+        }
+#else
+        perf.cpuPermille = perf.timing.busyPermille();
+#endif
+    }
+}
+
+void MoaTaskMonitor::reset() {
+    _profiler.requestReset();
+#if MOA_PERF_RUN_TIME_STATS
+    for (uint8_t i = 0; i < MOA_PERF_TASK_COUNT; i++) {
+        _runTimeBase[i] = (_handles[i] != nullptr) ? getRunTime(static_cast<MoaPerfTask>(i)) : 0;
+    }
+    _totalRunTimeBase = static_cast<uint32_t>(portGET_RUN_TIME_COUNTER_VALUE());
+#endif
+}
+
+const char* MoaTaskMonitor::getCpuSource() {
+    return MOA_PERF_RUN_TIME_STATS ? "run-time stats" : "loop busy time";
+}
+
+#if MOA_PERF_RUN_TIME_STATS
+uint32_t MoaTaskMonitor::getRunTime(MoaPerfTask task) const {
+    TaskStatus_t status;
+    vTaskGetInfo(_handles[task], &status, pdFALSE, eInvalid);
+    return static_cast<uint32_t>(status.ulRunTimeCounter);
+}
+#endif
@@ -0,0 +1,166 @@
+/**
+ * @file MoaTaskProfiler.cpp
+ * @brief Implementation of the MoaTaskProfiler class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaTaskProfiler.h"
+#include <string.h>
+#include "MoaLogJournal.h"
+
+// =============================================================================
+// MoaLoopTiming
+// =============================================================================
+
+uint32_t MoaLoopTiming::meanPeriodUs() const {
+    return (periods > 0) ? static_cast<uint32_t>(totalPeriodUs / periods) : 0;
+}
+
+uint32_t MoaLoopTiming::maxJitterUs(uint32_t targetUs) const {
+    if (targetUs == 0 || periods == 0) {
+        return 0;
+    }
+    uint32_t early = (minPeriodUs < targetUs) ? targetUs - minPeriodUs : 0;
+    uint32_t late = (maxPeriodUs > targetUs) ? maxPeriodUs - targetUs : 0;
+    return (early > late) ? early : late;
+}
+
+uint16_t MoaLoopTiming::busyPermille() const {
+    uint32_t coveredUs = lastEndUs - firstStartUs;
+    if (loops == 0 || coveredUs == 0) {
+        return 0;
+    }
+    uint64_t permille = busyUs * 1000ULL / coveredUs;
+    return static_cast<uint16_t>((permille > 1000) ? 1000 : permille);
+}
+
+// =============================================================================
+// MoaTaskProfiler
+// =============================================================================
+
+MoaTaskProfiler::MoaTaskProfiler() {
+    for (uint8_t i = 0; i < MOA_PERF_TASK_COUNT; i++) {
+        _slots[i].name = "?";
+        _slots[i].stackBytes = 0;
+        _slots[i].periodMs = 0;
+        memset(&_slots[i].working, 0, sizeof(MoaLoopTiming));
+        _slots[i].resetRequested.store(false, std::memory_order_relaxed);
+    }
+}
+
+void MoaTaskProfiler::configure(MoaPerfTask task, const char* name, uint32_t stackBytes, uint32_t periodMs) {
+    if (task >= MOA_PERF_TASK_COUNT) {
+        return;
+    }
+    _slots[task].name = name;
+    _slots[task].stackBytes = stackBytes;
+    _slots[task].periodMs = periodMs;
+}
+
+void MoaTaskProfiler::loopStart(MoaPerfTask task, uint32_t nowUs) {
+    if (task >= MOA_PERF_TASK_COUNT) {
+        return;
+    }
+    Slot& slot = _slots[task];
+    MoaLoopTiming& t = slot.working;
+
+    if (slot.resetRequested.exchange(false, std::memory_order_acquire)) {
+        memset(&t, 0, sizeof(MoaLoopTiming));
+    }
+
+    if (t.loops == 0) {
+        t.firstStartUs = nowUs;
+    } else {
+        uint32_t period = nowUs - t.lastStartUs;
+        if (t.periods == 0 || period < t.minPeriodUs) {
+            t.minPeriodUs = period;
+        }
+        if (period > t.maxPeriodUs) {
+            t.maxPeriodUs = period;
+        }
+        uint32_t targetUs = slot.periodMs * 1000UL;
+        if (targetUs > 0 && period > targetUs + targetUs * MOA_PERF_LATE_PERCENT / 100) {
+            t.lateCount++;
+        }
+        t.totalPeriodUs += period;
+        t.periods++;
+    }
+    t.loops++;
+    t.lastStartUs = nowUs;
+}
+
+void MoaTaskProfiler::loopEnd(MoaPerfTask task, uint32_t nowUs) {
+    if (task >= MOA_PERF_TASK_COUNT) {
+        return;
+    }
+    Slot& slot = _slots[task];
+    MoaLoopTiming& t = slot.working;
+    if (t.loops == 0) {
+        return;     // No loopStart() yet
+    }
+
+    uint32_t busy = nowUs - t.lastStartUs;
+    t.busyUs += busy;
+    if (busy > t.maxBusyUs) {
+        t.maxBusyUs = busy;
+    }
+    t.lastEndUs = nowUs;
+    slot.published.write(t);
+}
+
+MoaLoopTiming MoaTaskProfiler::getTiming(MoaPerfTask task) const {
+    if (task >= MOA_PERF_TASK_COUNT) {
+        MoaLoopTiming empty;
+        memset(&empty, 0, sizeof(empty));
+        return empty;
+    }
+    return _slots[task].published.read();
+}
+
+MoaTaskPerf MoaTaskProfiler::getPerf(MoaPerfTask task) const {
+    MoaTaskPerf perf;
+    memset(&perf, 0, sizeof(perf));
+    perf.name = "?";
+    perf.stackFreeBytes = MOA_PERF_UNKNOWN;
+    perf.cpuPermille = MOA_PERF_UNKNOWN;
+    if (task < MOA_PERF_TASK_COUNT) {
+        perf.name = _slots[task].name;
+        perf.stackBytes = _slots[task].stackBytes;
+        perf.periodMs = _slots[task].periodMs;
+        perf.timing = getTiming(task);
+    }
+    return perf;
+}
+
+void MoaTaskProfiler::requestReset() {
+    for (uint8_t i = 0; i < MOA_PERF_TASK_COUNT; i++) {
+        _slots[i].resetRequested.store(true, std::memory_order_release);
+    }
+}
+
+void MoaTaskProfiler::packRecord(const MoaTaskPerf* perf, uint32_t uptimeMs, MoaPerfRecord& out) {
+    memset(&out, 0, sizeof(out));
+    out.header.magic = MOA_PERF_RECORD_MAGIC;
+    out.header.version = MOA_PERF_RECORD_VERSION;
+    out.header.taskCount = MOA_PERF_TASK_COUNT;
+    out.header.entrySize = sizeof(MoaPerfTaskEntry);
+    out.header.uptimeMs = uptimeMs;
+
+    for (uint8_t i = 0; i < MOA_PERF_TASK_COUNT; i++) {
+        const MoaTaskPerf& p = perf[i];
+        MoaPerfTaskEntry& e = out.tasks[i];
+        e.stackBytes = static_cast<uint16_t>(p.stackBytes);
+        e.stackFreeBytes = p.stackFreeBytes;
+        e.cpuPermille = p.cpuPermille;
+        e.periodMs = static_cast<uint16_t>(p.periodMs);
+        e.loops = p.timing.loops;
+        e.meanPeriodUs = p.timing.meanPeriodUs();
+        e.minPeriodUs = p.timing.minPeriodUs;
+        e.maxPeriodUs = p.timing.maxPeriodUs;
+        e.maxBusyUs = p.timing.maxBusyUs;
+        e.lateCount = p.timing.lateCount;
+    }
+
+    out.crc = MoaLogJournal::crc16(reinterpret_cast<const uint8_t*>(&out), offsetof(MoaPerfRecord, crc));
+}
@@ -0,0 +1,238 @@
+/**
+ * @file MoaTelemetry.cpp
+ * @brief Implementation of the telemetry batch codec and stream
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaTelemetry.h"
+#include <string.h>
+
+/**
+ * @brief Head byte dt value meaning "varint timestamp delta follows"
+ */
+static const uint8_t DT_EXTENDED = 0x3F;
+
+static uint32_t zigzag(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+// =============================================================================
+// MoaTelemetryEncoder
+// =============================================================================
+
+MoaTelemetryEncoder::MoaTelemetryEncoder() {
+    begin(0);
+}
+
+void MoaTelemetryEncoder::begin(uint32_t baseTimestamp) {
+    _buffer[0] = MOA_TELEMETRY_VERSION;
+    memcpy(&_buffer[1], &baseTimestamp, sizeof(baseTimestamp));
+    _buffer[5] = 0;
+    _length = MOA_TELEMETRY_HEADER_BYTES;
+    _count = 0;
+    _lastTimestamp = baseTimestamp;
+    memset(_lastValue, 0, sizeof(_lastValue));
+}
+
+bool MoaTelemetryEncoder::add(const StatsReading& reading) {
+    if (reading.statsType < STATS_TYPE_TEMPERATURE || reading.statsType > STATS_TYPE_CURRENT) {
+        return true;                        // Not a telemetry channel: skipped, batch still open
+    }
+    if (_length + MOA_TELEMETRY_MAX_RECORD > sizeof(_buffer) || _count == UINT8_MAX) {
+        return false;
+    }
+
+    uint32_t dt = reading.timestamp - _lastTimestamp;
+    uint8_t headDt = (dt < DT_EXTENDED) ? static_cast<uint8_t>(dt) : DT_EXTENDED;
+    _buffer[_length++] = static_cast<uint8_t>(reading.statsType | (headDt << 2));
+    if (headDt == DT_EXTENDED) {
+        putVarint(dt);
+    }
+    putVarint(zigzag(reading.value - _lastValue[reading.statsType]));
+
+    _lastTimestamp = reading.timestamp;
+    _lastValue[reading.statsType] = reading.value;
+    _buffer[5] = ++_count;
+    return true;
+}
+
+const uint8_t* MoaTelemetryEncoder::data() const {
+    return _buffer;
+}
+
+size_t MoaTelemetryEncoder::length() const {
+    return _length;
+}
+
+uint8_t MoaTelemetryEncoder::count() const {
+    return _count;
+}
+
+void MoaTelemetryEncoder::putVarint(uint32_t value) {
+    while (value >= 0x80) {
+        _buffer[_length++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    _buffer[_length++] = static_cast<uint8_t>(value);
+}
+
+// =============================================================================
+// MoaTelemetryDecoder
+// =============================================================================
+
+/**
+ * @brief Read a varint, at most 5 bytes
+ * @return false if the payload ends inside it or it is too long
+ */
+static bool getVarint(const uint8_t* payload, size_t length, size_t& pos, uint32_t& value) {
+    value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7) {
+        if (pos >= length) {
+            return false;
+        }
+        uint8_t byte = payload[pos++];
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int MoaTelemetryDecoder::decode(const uint8_t* payload, size_t length, StatsReading* out, size_t maxReadings) {
+    if (length < MOA_TELEMETRY_HEADER_BYTES || payload[0] != MOA_TELEMETRY_VERSION) {
+        return -1;
+    }
+    uint32_t timestamp;
+    memcpy(&timestamp, &payload[1], sizeof(timestamp));
+    uint8_t count = payload[5];
+    if (count > maxReadings) {
+        return -1;
+    }
+
+    int32_t lastValue[4] = { 0, 0, 0, 0 };
+    size_t pos = MOA_TELEMETRY_HEADER_BYTES;
+    for (uint8_t i = 0; i < count; i++) {
+        if (pos >= length) {
+            return -1;
+        }
+        uint8_t head = payload[pos++];
+        uint8_t type = head & 0x03;
+        uint32_t dt = head >> 2;
+        if (type == 0) {
+            return -1;
+        }
+        if (dt == DT_EXTENDED && !getVarint(payload, length, pos, dt)) {
+            return -1;
+        }
+        uint32_t delta;
+        if (!getVarint(payload, length, pos, delta)) {
+            return -1;
+        }
+        timestamp += dt;
+        lastValue[type] += unzigzag(delta);
+
+        out[i].statsType = type;
+        out[i].value = lastValue[type];
+        out[i].timestamp = timestamp;
+    }
+    return (pos == length) ? count : -1;
+}
+
+// =============================================================================
+// MoaTelemetryStream
+// =============================================================================
+
+MoaTelemetryStream::MoaTelemetryStream()
+    : _periodMs(0)
+    , _open(false)
+    , _batchStart(0)
+    , _written(0)
+    , _read(0)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void MoaTelemetryStream::setPeriod(uint32_t periodMs) {
+    _periodMs.store(periodMs, std::memory_order_relaxed);
+}
+
+uint32_t MoaTelemetryStream::getPeriod() const {
+    return _periodMs.load(std::memory_order_relaxed);
+}
+
+bool MoaTelemetryStream::offer(const StatsReading& reading) {
+    uint32_t period = _periodMs.load(std::memory_order_relaxed);
+    if (period == 0) {
+        _open = false;                      // Off: the open batch is discarded
+        return false;
+    }
+
+    bool sealed = false;
+    if (_open && reading.timestamp - _batchStart >= period) {
+        sealed = seal();
+    }
+    if (!_open) {
+        _encoder.begin(reading.timestamp);
+        _batchStart = reading.timestamp;
+        _open = true;
+    }
+    if (!_encoder.add(reading)) {
+        // Full before the period ended: ship it early, start the next with this reading
+        sealed |= seal();
+        _encoder.begin(reading.timestamp);
+        _batchStart = reading.timestamp;
+        _open = true;
+        _encoder.add(reading);
+    }
+    _stats.readings++;
+    return sealed;
+}
+
+bool MoaTelemetryStream::take(MoaTelemetryFrame& frame) {
+    uint32_t read = _read.load(std::memory_order_relaxed);
+    if (_written.load(std::memory_order_acquire) == read) {
+        return false;
+    }
+    frame = _ring[read % MOA_TELEMETRY_RING_FRAMES];
+    _read.store(read + 1, std::memory_order_release);
+    return true;
+}
+
+void MoaTelemetryStream::reportSinkError() {
+    _stats.sinkErrors++;
+}
+
+MoaTelemetryStats MoaTelemetryStream::getStats() const {
+    return _stats;
+}
+
+void MoaTelemetryStream::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+bool MoaTelemetryStream::seal() {
+    _open = false;
+    if (_encoder.count() == 0) {
+        return false;
+    }
+
+    uint32_t written = _written.load(std::memory_order_relaxed);
+    if (written - _read.load(std::memory_order_acquire) >= MOA_TELEMETRY_RING_FRAMES) {
+        _stats.droppedFrames++;             // Sender behind: drop rather than wait
+        return false;
+    }
+    MoaTelemetryFrame& frame = _ring[written % MOA_TELEMETRY_RING_FRAMES];
+    frame.length = static_cast<uint8_t>(_encoder.length());
+    memcpy(frame.payload, _encoder.data(), _encoder.length());
+    _written.store(written + 1, std::memory_order_release);
+
+    _stats.frames++;
+    _stats.bytes += frame.length;
+    return true;
+}
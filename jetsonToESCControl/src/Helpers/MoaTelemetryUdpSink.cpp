@@ -0,0 +1,25 @@
+/**
+ * @file MoaTelemetryUdpSink.cpp
+ * @brief Implementation of the MoaTelemetryUdpSink class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaTelemetryUdpSink.h"
+
+MoaTelemetryUdpSink::MoaTelemetryUdpSink(ConfigManager& config, MoaWiFiManager& wifi)
+    : _config(config)
+    , _wifi(wifi)
+{
+}
+
+bool MoaTelemetryUdpSink::sendTelemetry(const uint8_t* payload, size_t length) {
+    if (!_wifi.isRunning() || _config.telemetryHost[0] == '\0') {
+        return false;
+    }
+    if (!_udp.beginPacket(_config.telemetryHost, _config.telemetryPort)) {
+        return false;
+    }
+    _udp.write(payload, length);
+    return _udp.endPacket() == 1;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file MoaTimerService.cpp
+ * @brief Implementation of the MoaTimerService class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaTimerService.h"
+#include "esp_log.h"
+
+static const char* TAG = "Timer";
+
+MoaTimerService::MoaTimerService()
+    : _mux(portMUX_INITIALIZER_UNLOCKED)
+    , _tickTimer(nullptr)
+    , _eventQueue(nullptr)
+    , _lastTickAt(0)
+    , _droppedEvents(0)
+{
+}
+
+bool MoaTimerService::begin(MoaEventChannel* eventQueue) {
+    _eventQueue = eventQueue;
+    if (_tickTimer != nullptr) {
+        return true;
+    }
+
+    _tickTimer = xTimerCreate("MoaTimers", pdMS_TO_TICKS(MOA_TIMER_TICK_MS), pdTRUE,
+                              static_cast<void*>(this), tickCallback);
+    if (_tickTimer == nullptr) {
+        ESP_LOGE(TAG, "Failed to create tick timer");
+        return false;
+    }
+
+    _lastTickAt = xTaskGetTickCount();
+    if (xTimerStart(_tickTimer, portMAX_DELAY) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to start tick timer");
+        return false;
+    }
+    ESP_LOGD(TAG, "Timer wheel started (%d ms tick, %d timers)", MOA_TIMER_TICK_MS, MOA_TIMER_WHEEL_CAPACITY);
+    return true;
+}
+
+bool MoaTimerService::start(uint8_t timerId, uint32_t durationMs, bool autoReload) {
+    if (timerId >= MOA_TIMER_WHEEL_CAPACITY || _tickTimer == nullptr) {
+        return false;
+    }
+    ESP_LOGD(TAG, "Timer %d: start (duration=%lums, autoReload=%s)", timerId,
+             static_cast<unsigned long>(durationMs), autoReload ? "true" : "false");
+
+    uint32_t period = 0;
+    if (autoReload) {
+        period = (durationMs + MOA_TIMER_TICK_MS - 1) / MOA_TIMER_TICK_MS;
+        if (period == 0) {
+            period = 1;
+        }
+    }
+
+    portENTER_CRITICAL(&_mux);
+    bool ok = _wheel.start(timerId, toWheelTicks(durationMs), period);
+    portEXIT_CRITICAL(&_mux);
+    return ok;
+}
+
+bool MoaTimerService::stop(uint8_t timerId) {
+    if (timerId >= MOA_TIMER_WHEEL_CAPACITY) {
+        return false;
+    }
+    ESP_LOGD(TAG, "Timer %d: stop", timerId);
+
+    portENTER_CRITICAL(&_mux);
+    _wheel.stop(timerId);
+    portEXIT_CRITICAL(&_mux);
+    return true;
+}
+
+bool MoaTimerService::reset(uint8_t timerId) {
+    portENTER_CRITICAL(&_mux);
+    bool ok = _wheel.restart(timerId);
+    portEXIT_CRITICAL(&_mux);
+    return ok;
+}
+
+bool MoaTimerService::isRunning(uint8_t timerId) const {
+    portENTER_CRITICAL(&_mux);
+    bool running = _wheel.isRunning(timerId);
+    portEXIT_CRITICAL(&_mux);
+    return running;
+}
+
+uint32_t MoaTimerService::getDroppedEvents() const {
+    return _droppedEvents;
+}
+
+uint32_t MoaTimerService::toWheelTicks(uint32_t durationMs) const {
+    // Wheel tick k lands k * MOA_TIMER_TICK_MS after the last one: count the
+    // part of the current tick already elapsed so the timer is never early
+    uint32_t sinceTickMs = static_cast<uint32_t>(xTaskGetTickCount() - _lastTickAt) * portTICK_PERIOD_MS;
+    if (sinceTickMs > MOA_TIMER_TICK_MS) {
+        sinceTickMs = MOA_TIMER_TICK_MS;
+    }
+    uint64_t totalMs = static_cast<uint64_t>(sinceTickMs) + durationMs;
+    uint64_t ticks = (totalMs + MOA_TIMER_TICK_MS - 1) / MOA_TIMER_TICK_MS;
+    return (ticks > MOA_TIMER_WHEEL_MAX_TICKS) ? MOA_TIMER_WHEEL_MAX_TICKS : static_cast<uint32_t>(ticks);
+}
+
+void MoaTimerService::tickCallback(TimerHandle_t xTimer) {
+    MoaTimerService* instance = static_cast<MoaTimerService*>(pvTimerGetTimerID(xTimer));
+    if (instance != nullptr) {
+        instance->onTick();
+    }
+}
+
+void MoaTimerService::onTick() {
+    uint8_t expired[MOA_TIMER_WHEEL_CAPACITY];
+
+    portENTER_CRITICAL(&_mux);
+    _lastTickAt = xTaskGetTickCount();
+    uint8_t count = _wheel.tick(expired);
+    portEXIT_CRITICAL(&_mux);
+
+    // Post outside the critical section; the timer service task must not block
+    for (uint8_t i = 0; i < count; i++) {
+        ESP_LOGD(TAG, "Timer %d: expired, pushing event", expired[i]);
+        if (_eventQueue == nullptr || !_eventQueue->push(TimerEvent(expired[i]))) {
+            _droppedEvents++;
+            ESP_LOGW(TAG, "Timer %d: event lane full, expiry dropped", expired[i]);
+        }
+    }
+}
@@ -0,0 +1,181 @@
+/**
+ * @file MoaTimerWheel.cpp
+ * @brief Implementation of the MoaTimerWheel class
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaTimerWheel.h"
+#include <string.h>
+
+static const uint32_t SLOT_MASK = MOA_TIMER_WHEEL_SLOTS - 1;
+
+MoaTimerWheel::MoaTimerWheel(uint32_t now)
+    : _now(now)
+    , _active(0)
+{
+    for (uint8_t i = 0; i < MOA_TIMER_WHEEL_CAPACITY; i++) {
+        _nodes[i].expires = 0;
+        _nodes[i].delay = 0;
+        _nodes[i].period = 0;
+        _nodes[i].bucket = UNLINKED;
+        _nodes[i].prev = NONE;
+        _nodes[i].next = NONE;
+        _nodes[i].started = false;
+    }
+    memset(_heads, NONE, sizeof(_heads));
+    memset(_tails, NONE, sizeof(_tails));
+}
+
+bool MoaTimerWheel::start(uint8_t id, uint32_t delayTicks, uint32_t periodTicks) {
+    if (id >= MOA_TIMER_WHEEL_CAPACITY) {
+        return false;
+    }
+    if (delayTicks == 0) {
+        delayTicks = 1;
+    } else if (delayTicks > MOA_TIMER_WHEEL_MAX_TICKS) {
+        delayTicks = MOA_TIMER_WHEEL_MAX_TICKS;
+    }
+    if (periodTicks > MOA_TIMER_WHEEL_MAX_TICKS) {
+        periodTicks = MOA_TIMER_WHEEL_MAX_TICKS;
+    }
+
+    Node& node = _nodes[id];
+    if (node.bucket != UNLINKED) {
+        unlink(id);
+        _active--;
+    }
+    node.expires = _now + delayTicks;
+    node.delay = delayTicks;
+    node.period = periodTicks;
+    node.started = true;
+    link(id);
+    _active++;
+    return true;
+}
+
+bool MoaTimerWheel::stop(uint8_t id) {
+    if (id >= MOA_TIMER_WHEEL_CAPACITY || _nodes[id].bucket == UNLINKED) {
+        return false;
+    }
+    unlink(id);
+    _active--;
+    return true;
+}
+
+bool MoaTimerWheel::restart(uint8_t id) {
+    if (id >= MOA_TIMER_WHEEL_CAPACITY || !_nodes[id].started) {
+        return false;
+    }
+    return start(id, _nodes[id].delay, _nodes[id].period);
+}
+
+bool MoaTimerWheel::isRunning(uint8_t id) const {
+    return id < MOA_TIMER_WHEEL_CAPACITY && _nodes[id].bucket != UNLINKED;
+}
+
+uint32_t MoaTimerWheel::getRemainingTicks(uint8_t id) const {
+    if (!isRunning(id)) {
+        return 0;
+    }
+    return _nodes[id].expires - _now;
+}
+
+uint8_t MoaTimerWheel::tick(uint8_t* expired) {
+    _now++;
+
+    // Refill the finest wheel from the coarser ones each time it wraps
+    if ((_now & SLOT_MASK) == 0) {
+        for (uint8_t level = 1; level < MOA_TIMER_WHEEL_LEVELS; level++) {
+            cascade(level);
+            if (((_now >> (MOA_TIMER_WHEEL_BITS * level)) & SLOT_MASK) != 0) {
+                break;
+            }
+        }
+    }
+
+    uint8_t count = 0;
+    uint8_t id = detach(static_cast<uint16_t>(_now & SLOT_MASK));
+    while (id != NONE) {
+        Node& node = _nodes[id];
+        uint8_t next = node.next;
+        node.bucket = UNLINKED;
+        expired[count++] = id;
+        if (node.period > 0) {
+            node.expires = _now + node.period;
+            link(id);
+        } else {
+            _active--;
+        }
+        id = next;
+    }
+    return count;
+}
+
+uint32_t MoaTimerWheel::getNow() const {
+    return _now;
+}
+
+uint8_t MoaTimerWheel::getActiveCount() const {
+    return _active;
+}
+
+void MoaTimerWheel::link(uint8_t id) {
+    Node& node = _nodes[id];
+    uint32_t delta = node.expires - _now;
+
+    uint8_t level = 0;
+    while (level < MOA_TIMER_WHEEL_LEVELS - 1 &&
+           delta >= (1UL << (MOA_TIMER_WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    uint16_t bucket = static_cast<uint16_t>(level * MOA_TIMER_WHEEL_SLOTS +
+                                            ((node.expires >> (MOA_TIMER_WHEEL_BITS * level)) & SLOT_MASK));
+
+    node.bucket = bucket;
+    node.next = NONE;
+    node.prev = _tails[bucket];
+    if (_tails[bucket] != NONE) {
+        _nodes[_tails[bucket]].next = id;
+    } else {
+        _heads[bucket] = id;
+    }
+    _tails[bucket] = id;
+}
+
+void MoaTimerWheel::unlink(uint8_t id) {
+    Node& node = _nodes[id];
+    uint16_t bucket = node.bucket;
+
+    if (node.prev != NONE) {
+        _nodes[node.prev].next = node.next;
+    } else {
+        _heads[bucket] = node.next;
+    }
+    if (node.next != NONE) {
+        _nodes[node.next].prev = node.prev;
+    } else {
+        _tails[bucket] = node.prev;
+    }
+    node.prev = NONE;
+    node.next = NONE;
+    node.bucket = UNLINKED;
+}
+
+uint8_t MoaTimerWheel::detach(uint16_t bucket) {
+    uint8_t head = _heads[bucket];
+    _heads[bucket] = NONE;
+    _tails[bucket] = NONE;
+    return head;
+}
+
+void MoaTimerWheel::cascade(uint8_t level) {
+    uint16_t bucket = static_cast<uint16_t>(level * MOA_TIMER_WHEEL_SLOTS +
+                                            ((_now >> (MOA_TIMER_WHEEL_BITS * level)) & SLOT_MASK));
+    uint8_t id = detach(bucket);
+    while (id != NONE) {
+        uint8_t next = _nodes[id].next;
+        link(id);       // Lands in a finer wheel: its expiry is now less than one lap away
+        id = next;
+    }
+}
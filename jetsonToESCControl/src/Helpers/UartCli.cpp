@@ -9,20 +9,47 @@
 #include "MoaBattControl.h"
 #include "MoaCurrentControl.h"
 #include "MoaTempControl.h"
+#include "MoaDs18b20Bus.h"
 #include "ESCController.h"
+#include "MoaStatsAggregator.h"
+#include "MoaMcpDevice.h"
+#include "MoaLatencyTrace.h"
+#include "MoaTaskMonitor.h"
+#include "MoaEventChannel.h"
+#include "MoaJetsonLink.h"
+#include "MoaTelemetry.h"
 #include "esp_log.h"
+#include <stdlib.h>
 #include <string.h>
 
 static const char* TAG = "CLI";
 
+/**
+ * @brief Parse a DS18B20 resolution, clamped to 9..12 bits
+ */
+static uint8_t probeBits(const char* value) {
+    int bits = atoi(value);
+    return static_cast<uint8_t>(bits < 9 ? 9 : (bits > 12 ? 12 : bits));
+}
+
 UartCli::UartCli(ConfigManager& config, MoaBattControl& batt,
                  MoaCurrentControl& current, MoaTempControl& temp,
-                 ESCController& esc)
+                 MoaDs18b20Bus& probes, ESCController& esc, MoaStatsAggregator& stats,
+                 MoaMcpDevice& mcp, MoaTaskMonitor& tasks,
+                 MoaEventChannel& events, MoaJetsonLink& link,
+                 MoaTelemetryStream& telemetry)
     : _config(config)
     , _batt(batt)
     , _current(current)
     , _temp(temp)
+    , _probes(probes)
     , _esc(esc)
+    , _stats(stats)
+    , _mcp(mcp)
+    , _tasks(tasks)
+    , _events(events)
+    , _link(link)
+    , _telemetry(telemetry)
     , _linePos(0)
 {
     memset(_lineBuf, 0, sizeof(_lineBuf));
@@ -78,8 +105,9 @@ void UartCli::processLine(const char* line) {
     char cmd[16] = {0};
     char arg1[32] = {0};
     char arg2[32] = {0};
+    char arg3[32] = {0};
 
-    int parsed = sscanf(line, "%15s %31s %31s", cmd, arg1, arg2);
+    int parsed = sscanf(line, "%15s %31s %31s %31s", cmd, arg1, arg2, arg3);
 
     if (strcasecmp(cmd, "help") == 0 || strcmp(cmd, "?") == 0) {
         handleHelp();
@@ -89,6 +117,28 @@ void UartCli::processLine(const char* line) {
         handleSet(arg1, arg2);
     } else if (strcasecmp(cmd, "dump") == 0) {
         handleDump();
+    } else if (strcasecmp(cmd, "stats") == 0) {
+        handleStats();
+    } else if (strcasecmp(cmd, "latency") == 0) {
+        handleLatency(parsed >= 2 && strcasecmp(arg1, "reset") == 0);
+    } else if (strcasecmp(cmd, "perf") == 0) {
+        handlePerf(parsed >= 2 ? arg1 : "");
+    } else if (strcasecmp(cmd, "events") == 0) {
+        handleEvents(parsed >= 2 && strcasecmp(arg1, "reset") == 0);
+    } else if (strcasecmp(cmd, "link") == 0) {
+        handleLink(parsed >= 2 && strcasecmp(arg1, "reset") == 0);
+    } else if (strcasecmp(cmd, "energy") == 0) {
+        handleEnergy();
+    } else if (strcasecmp(cmd, "probes") == 0) {
+        if (parsed >= 4 && strcasecmp(arg1, "assign") == 0) {
+            handleProbeAssign(arg2, arg3);
+        } else if (parsed >= 3 && strcasecmp(arg1, "clear") == 0) {
+            handleProbeClear(arg2);
+        } else {
+            handleProbes();
+        }
+    } else if (strcasecmp(cmd, "telemetry") == 0) {
+        handleTelemetry(parsed >= 2 && strcasecmp(arg1, "reset") == 0);
     } else if (strcasecmp(cmd, "save") == 0) {
         if (_config.save()) {
             Serial.println(F("OK: Settings saved to NVS"));
@@ -150,17 +200,34 @@ void UartCli::handleDump() {
     printSetting("esc_after");
     printSetting("esc_ramp");
 
-    Serial.println(F("--- Battery Thresholds (V) ---"));
+    Serial.println(F("--- Ramp Shapes (0=linear, 1=scurve, 2=expo) ---"));
+    printSetting("esc_sh25");
+    printSetting("esc_sh50");
+    printSetting("esc_sh75");
+    printSetting("esc_sh100");
+    printSetting("esc_sh_after");
+    printSetting("esc_curve");
+
+    Serial.println(F("--- Battery ---"));
     printSetting("batt_high");
     printSetting("batt_med");
     printSetting("batt_low");
     printSetting("batt_stop");
     printSetting("batt_hyst");
+    printSetting("batt_cap");
+    printSetting("batt_full");
+    printSetting("batt_comp");
+    printSetting("batt_rint");
+    printSetting("batt_sag");
 
     Serial.println(F("--- Temperature Thresholds (C) ---"));
     printSetting("temp_tgt");
     printSetting("temp_hyst");
     printSetting("temp_sens");
+    printSetting("temp_conv");
+    printSetting("temp_res_esc");
+    printSetting("temp_res_mot");
+    printSetting("temp_res_bat");
 
     Serial.println(F("--- Current Thresholds (A) ---"));
     printSetting("curr_oc");
@@ -171,6 +238,396 @@ void UartCli::handleDump() {
     printSetting("wifi_ssid");
     printSetting("wifi_pass");
     printSetting("ota_host");
+
+    Serial.println(F("--- Telemetry Stream ---"));
+    printSetting("tlm_ms");
+    printSetting("tlm_sink");
+    printSetting("tlm_host");
+    printSetting("tlm_port");
+}
+
+void UartCli::handleStats() {
+    static const char* const names[STATS_CHANNEL_COUNT] = { "temp", "batt", "current" };
+    static const char* const units[STATS_CHANNEL_COUNT] = { "C x10", "mV", "A x10" };
+    static const char* const windows[STATS_RES_COUNT - 1] = { "1s", "10s", "1min" };
+
+    StatsSnapshot now = _stats.getSnapshot();
+    StatsHistorySummary summary = _stats.getSummary();
+
+    Serial.println(F("--- Live ---"));
+    Serial.printf("  temp=%d (C x10)  batt=%d mV  current=%d (A x10)\n",
+                  now.temperatureX10, now.batteryVoltageMv, now.currentX10);
+    if (now.motorTempTimestamp != 0 || now.batteryTempTimestamp != 0) {
+        Serial.printf("  motor=%d (C x10)  pack=%d (C x10)\n", now.motorTempX10, now.batteryTempX10);
+    }
+
+    Serial.println(F("--- Session (min / max / mean, count) ---"));
+    for (uint8_t ch = 0; ch < STATS_CHANNEL_COUNT; ch++) {
+        const StatsSessionChannel& s = summary.session[ch];
+        Serial.printf("  %-8s %6d / %6d / %6d  n=%lu  (%s)\n", names[ch],
+                      s.min, s.max, s.mean, (unsigned long)s.count, units[ch]);
+    }
+    Serial.printf("  energy   %ld mWh since %lu ms\n",
+                  (long)summary.energyMwh, (unsigned long)summary.sessionStartMs);
+
+    Serial.println(F("--- Last closed bucket (min / max / mean) ---"));
+    for (uint8_t ch = 0; ch < STATS_CHANNEL_COUNT; ch++) {
+        Serial.printf("  %-8s", names[ch]);
+        for (uint8_t w = 0; w < STATS_RES_COUNT - 1; w++) {
+            const StatsBucket& b = summary.lastClosed[ch][w];
+            if (b.count == 0) {
+                Serial.printf("  %s: -", windows[w]);
+            } else {
+                Serial.printf("  %s: %d/%d/%d", windows[w], b.min, b.max, b.mean());
+            }
+        }
+        Serial.println();
+    }
+
+    Serial.printf("  history RAM: %u bytes\n", (unsigned)MoaStatsHistory::getMemoryBytes());
+
+    Serial.println(F("--- I2C (MCP23018) ---"));
+    Serial.printf("  %lu transactions/s  total=%lu  skipped writes=%lu\n",
+                  (unsigned long)_mcp.getTransactionsPerSecond(),
+                  (unsigned long)_mcp.getTransactionCount(),
+                  (unsigned long)_mcp.getSkippedWrites());
+}
+
+#if MOA_LATENCY_TRACE
+/**
+ * @brief Copy a histogram, retrying while a task or the ISR holds the trace
+ */
+static bool readLatency(MoaLatencyHop hop, MoaLatencyHistogram& histogram) {
+    for (uint8_t attempt = 0; attempt < 10; attempt++) {
+        if (g_moaLatencyTrace.getHistogram(hop, histogram)) {
+            return true;
+        }
+        vTaskDelay(1);
+    }
+    return false;
+}
+#endif
+
+void UartCli::handleLatency(bool reset) {
+#if MOA_LATENCY_TRACE
+    if (reset) {
+        bool cleared = false;
+        for (uint8_t attempt = 0; attempt < 10 && !cleared; attempt++) {
+            cleared = g_moaLatencyTrace.reset();
+            if (!cleared) {
+                vTaskDelay(1);
+            }
+        }
+        Serial.println(cleared ? F("OK: Latency histograms cleared") : F("ERR: Trace busy, retry"));
+        return;
+    }
+
+    // Hops in path order, then end-to-end per origin
+    static const MoaLatencyHop rows[] = {
+        MOA_HOP_PROCESS, MOA_HOP_PUSH, MOA_HOP_RECEIVE, MOA_HOP_STATE, MOA_HOP_SET_DUTY, MOA_HOP_PWM,
+        MOA_HOP_BUTTON_EDGE, MOA_HOP_SENSOR_SAMPLE, MOA_HOP_ADC_DRAIN, MOA_HOP_LINK_FRAME
+    };
+    static const uint8_t rowCount = sizeof(rows) / sizeof(rows[0]);
+    MoaLatencyHistogram histograms[rowCount];
+
+    Serial.println(F("--- Latency since previous hop / end-to-end (us) ---"));
+    Serial.printf("  %-12s %6s %7s %7s %7s %7s %7s\n", "hop", "n", "min", "mean", "p50<=", "p99<=", "max");
+    for (uint8_t r = 0; r < rowCount; r++) {
+        MoaLatencyHistogram& h = histograms[r];
+        char name[16];
+        if (rows[r] < MOA_HOP_PROCESS) {
+            snprintf(name, sizeof(name), "%s->pwm", MoaLatencyTrace::getHopName(rows[r]));
+        } else {
+            snprintf(name, sizeof(name), "%s", MoaLatencyTrace::getHopName(rows[r]));
+        }
+        if (!readLatency(rows[r], h)) {
+            h.clear();
+            Serial.printf("  %-12s busy\n", name);
+        } else if (h.count == 0) {
+            Serial.printf("  %-12s %6d\n", name, 0);
+        } else {
+            Serial.printf("  %-12s %6lu %7lu %7lu %7lu %7lu %7lu\n", name, (unsigned long)h.count,
+                          (unsigned long)h.minUs, (unsigned long)h.meanUs(),
+                          (unsigned long)h.percentileUs(50), (unsigned long)h.percentileUs(99),
+                          (unsigned long)h.maxUs);
+        }
+    }
+    Serial.printf("  traced=%lu dropped=%lu (one input followed at a time)\n",
+                  (unsigned long)g_moaLatencyTrace.getCompletedCount(),
+                  (unsigned long)g_moaLatencyTrace.getDroppedCount());
+
+    Serial.println(F("--- Histograms (count per bucket, <N = under N us) ---"));
+    for (uint8_t r = 0; r < rowCount; r++) {
+        const MoaLatencyHistogram& h = histograms[r];
+        if (h.count == 0) {
+            continue;
+        }
+        Serial.printf("  %-8s", MoaLatencyTrace::getHopName(rows[r]));
+        for (uint8_t b = 0; b < MOA_LATENCY_BUCKETS; b++) {
+            if (h.buckets[b] == 0) {
+                continue;
+            }
+            if (b < MOA_LATENCY_BUCKETS - 1) {
+                Serial.printf(" <%lu:%lu", (unsigned long)MoaLatencyHistogram::bucketLimitUs(b),
+                              (unsigned long)h.buckets[b]);
+            } else {
+                Serial.printf(" >=%lu:%lu", (unsigned long)MoaLatencyHistogram::bucketLimitUs(b - 1),
+                              (unsigned long)h.buckets[b]);
+            }
+        }
+        Serial.println();
+    }
+#else
+    (void)reset;
+    Serial.println(F("ERR: Built without MOA_LATENCY_TRACE"));
+#endif
+}
+
+void UartCli::handlePerf(const char* arg) {
+    if (strcasecmp(arg, "reset") == 0) {
+        _tasks.reset();
+        Serial.println(F("OK: Task profile cleared (each task restarts at its next loop)"));
+        return;
+    }
+
+    MoaTaskPerf perf[MOA_PERF_TASK_COUNT];
+    _tasks.sampleAll(perf);
+
+    if (strcasecmp(arg, "hex") == 0) {
+        MoaPerfRecord record;
+        MoaTaskProfiler::packRecord(perf, millis(), record);
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&record);
+        Serial.print(F("PERF "));
+        for (size_t i = 0; i < sizeof(record); i++) {
+            Serial.printf("%02X", bytes[i]);
+        }
+        Serial.println();
+        return;
+    }
+
+    Serial.printf("--- Tasks (bytes; us since 'perf reset'; cpu from %s) ---\n", MoaTaskMonitor::getCpuSource());
+    Serial.printf("  %-10s %5s %5s %5s %5s %7s %7s %7s %7s %7s %7s %5s %7s\n", "task", "stack", "free", "used",
+                  "cpu%", "loops", "target", "mean", "min", "max", "jitter", "late", "busy");
+    for (uint8_t i = 0; i < MOA_PERF_TASK_COUNT; i++) {
+        const MoaTaskPerf& p = perf[i];
+        const MoaLoopTiming& t = p.timing;
+        char freeText[8];
+        char usedText[8];
+        char cpuText[8];
+        char targetText[8];
+        if (p.stackFreeBytes == MOA_PERF_UNKNOWN || p.stackBytes == 0) {
+            snprintf(freeText, sizeof(freeText), "-");
+            snprintf(usedText, sizeof(usedText), "-");
+        } else {
+            uint32_t used = (p.stackFreeBytes < p.stackBytes) ? p.stackBytes - p.stackFreeBytes : 0;
+            snprintf(freeText, sizeof(freeText), "%u", (unsigned)p.stackFreeBytes);
+            snprintf(usedText, sizeof(usedText), "%lu%%", (unsigned long)(used * 100 / p.stackBytes));
+        }
+        if (p.cpuPermille == MOA_PERF_UNKNOWN) {
+            snprintf(cpuText, sizeof(cpuText), "-");
+        } else {
+            snprintf(cpuText, sizeof(cpuText), "%u.%u", (unsigned)(p.cpuPermille / 10), (unsigned)(p.cpuPermille % 10));
+        }
+        if (p.periodMs == 0) {
+            snprintf(targetText, sizeof(targetText), "event");
+        } else {
+            snprintf(targetText, sizeof(targetText), "%lu", (unsigned long)(p.periodMs * 1000UL));
+        }
+        Serial.printf("  %-10s %5lu %5s %5s %5s %7lu %7s %7lu %7lu %7lu %7lu %5lu %7lu\n", p.name,
+                      (unsigned long)p.stackBytes, freeText, usedText, cpuText, (unsigned long)t.loops,
+                      targetText, (unsigned long)t.meanPeriodUs(), (unsigned long)t.minPeriodUs,
+                      (unsigned long)t.maxPeriodUs, (unsigned long)t.maxJitterUs(p.periodMs * 1000UL),
+                      (unsigned long)t.lateCount, (unsigned long)t.maxBusyUs);
+    }
+    Serial.printf("  free = lowest ever; late = period > target + %d%%; busy = longest loop\n",
+                  MOA_PERF_LATE_PERCENT);
+}
+
+void UartCli::handleEvents(bool reset) {
+    if (reset) {
+        _events.resetStats();
+        Serial.println(F("OK: Event counters cleared"));
+        return;
+    }
+
+    MoaEventChannelStats stats;
+    _events.getStats(stats);
+
+    Serial.println(F("--- Control events since 'events reset' ---"));
+    Serial.printf("  %-8s %8s %9s %10s %7s\n", "source", "queued", "coalesced", "superseded", "dropped");
+    for (uint8_t s = 0; s < MOA_EVENT_SOURCE_COUNT; s++) {
+        const MoaEventCounters& c = stats.sources[s];
+        Serial.printf("  %-8s %8lu %9lu %10lu %7lu\n", MoaEventQueue::getSourceName(static_cast<MoaEventSource>(s)),
+                      (unsigned long)c.queued, (unsigned long)c.coalesced,
+                      (unsigned long)c.superseded, (unsigned long)c.dropped);
+    }
+    Serial.printf("  safety lane: %u/%d pending, peak %u\n", (unsigned)stats.pending[MOA_EVENT_LANE_SAFETY],
+                  MOA_EVENT_SAFETY_DEPTH, (unsigned)stats.highWater[MOA_EVENT_LANE_SAFETY]);
+    Serial.printf("  normal lane: %u/%d pending, peak %u\n", (unsigned)stats.pending[MOA_EVENT_LANE_NORMAL],
+                  MOA_EVENT_NORMAL_DEPTH, (unsigned)stats.highWater[MOA_EVENT_LANE_NORMAL]);
+}
+
+void UartCli::handleLink(bool reset) {
+    if (reset) {
+        _link.resetStats();
+        Serial.println(F("OK: Link counters cleared"));
+        return;
+    }
+
+    MoaLinkStats stats = _link.getStats();
+    Serial.printf("--- Jetson link (UART%d, %d baud) ---\n", MOA_LINK_UART_NUM, MOA_LINK_BAUD);
+    Serial.printf("  frames        %lu\n", (unsigned long)stats.frames);
+    Serial.printf("  duplicates    %lu\n", (unsigned long)stats.duplicates);
+    Serial.printf("  seq gaps      %lu\n", (unsigned long)stats.seqGaps);
+    Serial.printf("  rejected      %lu\n", (unsigned long)stats.rejected);
+    Serial.printf("  crc errors    %lu\n", (unsigned long)stats.crcErrors);
+    Serial.printf("  framing       %lu\n", (unsigned long)stats.framingErrors);
+    Serial.printf("  overruns      %lu\n", (unsigned long)stats.overruns);
+    Serial.printf("  uart overflow %lu\n", (unsigned long)_link.getDriverOverflows());
+}
+
+void UartCli::handleTelemetry(bool reset) {
+    if (reset) {
+        _telemetry.resetStats();
+        Serial.println(F("OK: Telemetry counters cleared"));
+        return;
+    }
+
+    MoaTelemetryStats stats = _telemetry.getStats();
+    uint32_t period = _telemetry.getPeriod();
+    if (period == 0) {
+        Serial.println(F("--- Telemetry (off) ---"));
+    } else {
+        Serial.printf("--- Telemetry (%lu ms batches to %s) ---\n", (unsigned long)period,
+                      _config.telemetrySink == 1 ? "udp" : "link");
+    }
+    Serial.printf("  readings      %lu\n", (unsigned long)stats.readings);
+    Serial.printf("  frames        %lu\n", (unsigned long)stats.frames);
+    Serial.printf("  bytes         %lu\n", (unsigned long)stats.bytes);
+    if (stats.readings > 0) {
+        Serial.printf("  bytes/reading %lu.%02lu\n", (unsigned long)(stats.bytes / stats.readings),
+                      (unsigned long)(stats.bytes * 100 / stats.readings % 100));
+    }
+    Serial.printf("  dropped       %lu\n", (unsigned long)stats.droppedFrames);
+    Serial.printf("  sink errors   %lu\n", (unsigned long)stats.sinkErrors);
+}
+
+void UartCli::handleEnergy() {
+    MoaEnergyReport energy = _stats.getEnergy();
+
+    Serial.println(F("--- Energy (session since boot / lifetime) ---"));
+    Serial.printf("  charge   %7ld / %ld mAh\n", (long)energy.sessionMah, (long)energy.lifetimeMah);
+    Serial.printf("  energy   %7ld / %ld mWh\n", (long)energy.sessionMwh, (long)energy.lifetimeMwh);
+    Serial.printf("  power    %7ld mW (rolling %d s)\n", (long)energy.avgPowerMw, ENERGY_POWER_WINDOW_MS / 1000);
+    if (energy.socPermille == MOA_ENERGY_SOC_UNKNOWN) {
+        Serial.println(F("  soc      -"));
+    } else {
+        Serial.printf("  soc      %u.%u %% of %lu mAh\n", (unsigned)(energy.socPermille / 10),
+                      (unsigned)(energy.socPermille % 10), (unsigned long)_config.battCapacityMah);
+    }
+    if (energy.remainingS == MOA_ENERGY_TIME_UNKNOWN) {
+        Serial.println(F("  ride     -"));
+    } else {
+        Serial.printf("  ride     %lu min %02lu s at this power\n", (unsigned long)(energy.remainingS / 60),
+                      (unsigned long)(energy.remainingS % 60));
+    }
+    Serial.printf("  covered  %lu ms\n", (unsigned long)energy.integratedMs);
+
+    const MoaBattResistance& resistance = _batt.getResistance();
+    Serial.printf("  pack R   %lu mOhm (%lu steps, %lu rejected)\n",
+                  (unsigned long)resistance.getResistanceMilliohm(), (unsigned long)resistance.getStepCount(),
+                  (unsigned long)resistance.getRejectedCount());
+    Serial.printf("  ocv      %.2f V (terminal %.2f V), levels on %s\n",
+                  _batt.getOpenCircuitVoltageMv() / 1000.0f, _batt.getAveragedVoltage(),
+                  !_batt.isLoadCompensated() ? "terminal" :
+                  resistance.isLearned() ? "ocv" : "ocv (learning, not compensated yet)");
+}
+
+void UartCli::handleProbes() {
+    Serial.printf("--- DS18B20 probes (%u found, %u bound, %s, %s power) ---\n",
+                  (unsigned)_probes.getFoundCount(), (unsigned)_probes.getProbeCount(),
+                  _probes.getMode() == MoaProbeMode::STAGGERED ? "staggered" : "broadcast",
+                  _probes.isParasite() ? "parasite" : "external");
+    for (uint8_t role = 0; role < TEMP_PROBE_MAX_COUNT; role++) {
+        const uint8_t* rom = _probes.getRom(role);
+        if (rom == nullptr) {
+            const uint8_t* want = _probes.getRoleRom(role);
+            if (want != nullptr) {
+                Serial.printf("  %-8s MISSING %02X%02X%02X%02X%02X%02X%02X%02X\n", moaProbeRoleName(role),
+                              want[0], want[1], want[2], want[3], want[4], want[5], want[6], want[7]);
+            } else {
+                Serial.printf("  %-8s unassigned\n", moaProbeRoleName(role));
+            }
+            continue;
+        }
+        int32_t centiC = _probes.getLastCentiC(role);
+        uint32_t magnitude = static_cast<uint32_t>(centiC < 0 ? -centiC : centiC);
+        Serial.printf("  %-8s %02X%02X%02X%02X%02X%02X%02X%02X  %2u bits  %s%lu.%02lu C  reads=%lu errors=%lu%s\n",
+                      moaProbeRoleName(role), rom[0], rom[1], rom[2], rom[3], rom[4], rom[5], rom[6], rom[7],
+                      (unsigned)_probes.getResolution(role), centiC < 0 ? "-" : "",
+                      (unsigned long)(magnitude / 100), (unsigned long)(magnitude % 100),
+                      (unsigned long)_probes.getReadCount(role), (unsigned long)_probes.getErrorCount(role),
+                      _probes.getRoleRom(role) == nullptr ? "  (only probe, not assigned)" : "");
+    }
+    for (uint8_t i = 0; i < _probes.getFoundCount(); i++) {
+        const uint8_t* rom = _probes.getFoundRom(i);
+        int8_t role = _probes.getFoundRole(i);
+        Serial.printf("  #%u %02X%02X%02X%02X%02X%02X%02X%02X -> %s\n", (unsigned)i,
+                      rom[0], rom[1], rom[2], rom[3], rom[4], rom[5], rom[6], rom[7],
+                      role < 0 ? "-" : moaProbeRoleName(static_cast<uint8_t>(role)));
+    }
+    Serial.printf("  transactions  %lu\n", (unsigned long)_probes.getTransactionCount());
+}
+
+static int8_t parseProbeRole(const char* name) {
+    for (uint8_t role = 0; role < TEMP_PROBE_MAX_COUNT; role++) {
+        if (strcasecmp(name, moaProbeRoleName(role)) == 0) {
+            return static_cast<int8_t>(role);
+        }
+    }
+    return -1;
+}
+
+void UartCli::handleProbeAssign(const char* index, const char* roleName) {
+    char* end = nullptr;
+    unsigned long found = strtoul(index[0] == '#' ? index + 1 : index, &end, 10);
+    int8_t role = parseProbeRole(roleName);
+    if (end == nullptr || *end != '\0' || found >= _probes.getFoundCount()) {
+        Serial.printf("ERR: No probe #%s (see 'probes')\n", index);
+        return;
+    }
+    if (role < 0) {
+        Serial.printf("ERR: Unknown role '%s' (esc, motor, battery)\n", roleName);
+        return;
+    }
+
+    // One ROM per role: a probe moved to a new role leaves its old one
+    const uint8_t* rom = _probes.getFoundRom(static_cast<uint8_t>(found));
+    for (uint8_t r = 0; r < TEMP_PROBE_MAX_COUNT; r++) {
+        if (memcmp(_config.tempProbeRoms[r], rom, ONEWIRE_ROM_BYTES) == 0) {
+            memset(_config.tempProbeRoms[r], 0, ONEWIRE_ROM_BYTES);
+        }
+    }
+    memcpy(_config.tempProbeRoms[role], rom, ONEWIRE_ROM_BYTES);
+    if (_config.save()) {
+        Serial.printf("OK: #%lu is the %s probe, saved (reboot to bind)\n", found, moaProbeRoleName(role));
+    } else {
+        Serial.println(F("ERR: Save failed"));
+    }
+}
+
+void UartCli::handleProbeClear(const char* roleName) {
+    int8_t role = parseProbeRole(roleName);
+    if (role < 0) {
+        Serial.printf("ERR: Unknown role '%s' (esc, motor, battery)\n", roleName);
+        return;
+    }
+    memset(_config.tempProbeRoms[role], 0, ONEWIRE_ROM_BYTES);
+    if (_config.save()) {
+        Serial.printf("OK: %s probe cleared, saved (reboot to unbind)\n", moaProbeRoleName(role));
+    } else {
+        Serial.println(F("ERR: Save failed"));
+    }
 }
 
 void UartCli::handleHelp() {
@@ -179,6 +636,16 @@ void UartCli::handleHelp() {
     Serial.println(F("  get all         Read all settings"));
     Serial.println(F("  set <key> <val> Write a setting (in-memory only)"));
     Serial.println(F("  dump            Print all settings"));
+    Serial.println(F("  stats           Live readings, session history, I2C rate"));
+    Serial.println(F("  latency [reset] Input-to-PWM latency per hop (histograms)"));
+    Serial.println(F("  perf [reset|hex] Task stack, CPU and loop jitter"));
+    Serial.println(F("  events [reset]  Control events per producer (queued/coalesced/dropped)"));
+    Serial.println(F("  link [reset]    Jetson link frames and errors"));
+    Serial.println(F("  telemetry [reset] Telemetry stream batches, drops and sink errors"));
+    Serial.println(F("  energy          Charge, energy, state of charge, ride time, pack R"));
+    Serial.println(F("  probes          DS18B20 probes: role, ROM, resolution, reading, errors"));
+    Serial.println(F("  probes assign <#> <role>  Bind found probe # to esc|motor|battery (saved)"));
+    Serial.println(F("  probes clear <role>       Unassign a role (saved)"));
     Serial.println(F("  save            Persist to NVS"));
     Serial.println(F("  apply           Hot-reload to devices"));
     Serial.println(F("  reset           Restore defaults, save, apply"));
@@ -188,17 +655,27 @@ void UartCli::handleHelp() {
     Serial.println(F("  esc_t25, esc_t50, esc_t75, esc_t100, esc_t_after       (ms)"));
     Serial.println(F("  esc_eco, esc_paddle, esc_break, esc_full, esc_after    (duty 0-1023)"));
     Serial.println(F("  esc_ramp                                           (%/s)"));
+    Serial.println(F("  esc_sh25, esc_sh50, esc_sh75, esc_sh100, esc_sh_after (0=linear, 1=scurve, 2=expo)"));
+    Serial.println(F("  esc_curve                                          (expo curvature 0.01-10)"));
     Serial.println(F("  batt_high, batt_med, batt_low, batt_stop, batt_hyst (V)"));
+    Serial.println(F("  batt_cap (mAh), batt_full (V)                      (state of charge)"));
+    Serial.println(F("  batt_comp (0=terminal, 1=ocv), batt_rint (mOhm)    (load compensation)"));
+    Serial.println(F("  batt_sag                                           (mV, most the compensation adds)"));
     Serial.println(F("  temp_tgt, temp_hyst                                (C)"));
     Serial.println(F("  temp_sens                                          (0=DS18B20, 1=NTC; needs reboot)"));
+    Serial.println(F("  temp_conv                                          (DS18B20: 0=broadcast, 1=staggered)"));
+    Serial.println(F("  temp_res_esc, temp_res_mot, temp_res_bat           (DS18B20 bits 9-12)"));
     Serial.println(F("  curr_oc, curr_rev, curr_hyst                       (A)"));
     Serial.println(F("  wifi_ssid, wifi_pass, ota_host                      (string)"));
+    Serial.println(F("  tlm_ms                                             (batch period ms, 0=off)"));
+    Serial.println(F("  tlm_sink                                           (0=link, 1=udp)"));
+    Serial.println(F("  tlm_host, tlm_port                                 (UDP destination)"));
     Serial.println();
     Serial.println(F("Workflow: set <key> <val> \u2192 apply \u2192 (test) \u2192 save"));
 }
 
 void UartCli::applyConfig() {
-    _config.applyTo(_batt, _current, _temp, _esc);
+    _config.applyTo(_batt, _current, _temp, _probes, _esc, _telemetry, _stats);
 }
 
 bool UartCli::printSetting(const char* key) {
@@ -220,17 +697,34 @@ bool UartCli::printSetting(const char* key) {
     if (strcmp(key, "esc_after_full") == 0) { Serial.printf("  %-12s = %u duty\n", key, _config.escAfterFullThrottle); return true; }
     if (strcmp(key, "esc_ramp") == 0)     { Serial.printf("  %-12s = %.1f %%/s\n", key, _config.escRampRate); return true; }
 
+    // Ramp shapes
+    if (strcmp(key, "esc_sh25") == 0)     { Serial.printf("  %-12s = %u (%s)\n", key, (unsigned)_config.escShape25, MoaRampProfile::shapeName(_config.escShape25)); return true; }
+    if (strcmp(key, "esc_sh50") == 0)     { Serial.printf("  %-12s = %u (%s)\n", key, (unsigned)_config.escShape50, MoaRampProfile::shapeName(_config.escShape50)); return true; }
+    if (strcmp(key, "esc_sh75") == 0)     { Serial.printf("  %-12s = %u (%s)\n", key, (unsigned)_config.escShape75, MoaRampProfile::shapeName(_config.escShape75)); return true; }
+    if (strcmp(key, "esc_sh100") == 0)    { Serial.printf("  %-12s = %u (%s)\n", key, (unsigned)_config.escShape100, MoaRampProfile::shapeName(_config.escShape100)); return true; }
+    if (strcmp(key, "esc_sh_after") == 0) { Serial.printf("  %-12s = %u (%s)\n", key, (unsigned)_config.escShapeAfterFullThrottle, MoaRampProfile::shapeName(_config.escShapeAfterFullThrottle)); return true; }
+    if (strcmp(key, "esc_curve") == 0)    { Serial.printf("  %-12s = %.1f\n", key, _config.escRampCurvature); return true; }
+
     // Battery
     if (strcmp(key, "batt_high") == 0)    { Serial.printf("  %-12s = %.2f V\n", key, _config.battHigh); return true; }
     if (strcmp(key, "batt_med") == 0)     { Serial.printf("  %-12s = %.2f V\n", key, _config.battMedium); return true; }
     if (strcmp(key, "batt_low") == 0)     { Serial.printf("  %-12s = %.2f V\n", key, _config.battLow); return true; }
     if (strcmp(key, "batt_stop") == 0)    { Serial.printf("  %-12s = %.2f V\n", key, _config.battStop); return true; }
     if (strcmp(key, "batt_hyst") == 0)    { Serial.printf("  %-12s = %.2f V\n", key, _config.battHysteresis); return true; }
+    if (strcmp(key, "batt_cap") == 0)     { Serial.printf("  %-12s = %lu mAh\n", key, (unsigned long)_config.battCapacityMah); return true; }
+    if (strcmp(key, "batt_full") == 0)    { Serial.printf("  %-12s = %.2f V\n", key, _config.battFull); return true; }
+    if (strcmp(key, "batt_comp") == 0)    { Serial.printf("  %-12s = %u (%s)\n", key, (unsigned)_config.battCompensation, _config.battCompensation ? "ocv" : "terminal"); return true; }
+    if (strcmp(key, "batt_rint") == 0)    { Serial.printf("  %-12s = %u mOhm\n", key, (unsigned)_config.battResistanceMohm); return true; }
+    if (strcmp(key, "batt_sag") == 0)     { Serial.printf("  %-12s = %u mV\n", key, (unsigned)_config.battMaxSagMv); return true; }
 
     // Temperature
     if (strcmp(key, "temp_tgt") == 0)     { Serial.printf("  %-12s = %.1f C\n", key, _config.tempTarget); return true; }
     if (strcmp(key, "temp_hyst") == 0)    { Serial.printf("  %-12s = %.1f C\n", key, _config.tempHysteresis); return true; }
     if (strcmp(key, "temp_sens") == 0)    { Serial.printf("  %-12s = %u (%s)\n", key, (unsigned)_config.tempSensorType, _config.tempSensorType == TempSensorType::NTC ? "NTC" : "DS18B20"); return true; }
+    if (strcmp(key, "temp_conv") == 0)    { Serial.printf("  %-12s = %u (%s)\n", key, (unsigned)_config.tempProbeMode, _config.tempProbeMode ? "staggered" : "broadcast"); return true; }
+    if (strcmp(key, "temp_res_esc") == 0) { Serial.printf("  %-12s = %u bits\n", key, (unsigned)_config.tempProbeBits[TEMP_PROBE_ESC]); return true; }
+    if (strcmp(key, "temp_res_mot") == 0) { Serial.printf("  %-12s = %u bits\n", key, (unsigned)_config.tempProbeBits[TEMP_PROBE_MOTOR]); return true; }
+    if (strcmp(key, "temp_res_bat") == 0) { Serial.printf("  %-12s = %u bits\n", key, (unsigned)_config.tempProbeBits[TEMP_PROBE_BATTERY]); return true; }
 
     // Current
     if (strcmp(key, "curr_oc") == 0)      { Serial.printf("  %-12s = %.1f A\n", key, _config.currentOvercurrent); return true; }
@@ -242,9 +736,28 @@ bool UartCli::printSetting(const char* key) {
     if (strcmp(key, "wifi_pass") == 0)    { Serial.printf("  %-12s = %s\n", key, _config.wifiPassword); return true; }
     if (strcmp(key, "ota_host") == 0)     { Serial.printf("  %-12s = %s\n", key, _config.otaHostname); return true; }
 
+    // Telemetry stream
+    if (strcmp(key, "tlm_ms") == 0)       { Serial.printf("  %-12s = %u ms\n", key, (unsigned)_config.telemetryPeriodMs); return true; }
+    if (strcmp(key, "tlm_sink") == 0)     { Serial.printf("  %-12s = %u (%s)\n", key, (unsigned)_config.telemetrySink, _config.telemetrySink == 1 ? "udp" : "link"); return true; }
+    if (strcmp(key, "tlm_host") == 0)     { Serial.printf("  %-12s = %s\n", key, _config.telemetryHost); return true; }
+    if (strcmp(key, "tlm_port") == 0)     { Serial.printf("  %-12s = %u\n", key, (unsigned)_config.telemetryPort); return true; }
+
     return false;
 }
 
+/**
+ * @brief Parse a ramp shape given by number or name (unknown = linear)
+ */
+static MoaRampShape parseRampShape(const char* value) {
+    for (uint8_t i = 0; i < MOA_RAMP_SHAPE_COUNT; i++) {
+        if (strcmp(value, MoaRampProfile::shapeName(static_cast<MoaRampShape>(i))) == 0) {
+            return static_cast<MoaRampShape>(i);
+        }
+    }
+    int shape = atoi(value);
+    return (shape > 0 && shape < MOA_RAMP_SHAPE_COUNT) ? static_cast<MoaRampShape>(shape) : MoaRampShape::LINEAR;
+}
+
 bool UartCli::setSetting(const char* key, const char* value) {
     // Surfing timers (uint32_t)
     if (strcmp(key, "esc_t25") == 0)      { _config.escTime25 = strtoul(value, nullptr, 10); return true; }
@@ -264,17 +777,34 @@ bool UartCli::setSetting(const char* key, const char* value) {
     if (strcmp(key, "esc_after_full") == 0) { uint16_t v = (uint16_t)atoi(value); if (v > 1023) v = 1023; _config.escAfterFullThrottle = v; return true; }
     if (strcmp(key, "esc_ramp") == 0)     { _config.escRampRate = atof(value); return true; }
 
+    // Ramp shapes (0-2 or name, anything else is linear)
+    if (strcmp(key, "esc_sh25") == 0)     { _config.escShape25 = parseRampShape(value); return true; }
+    if (strcmp(key, "esc_sh50") == 0)     { _config.escShape50 = parseRampShape(value); return true; }
+    if (strcmp(key, "esc_sh75") == 0)     { _config.escShape75 = parseRampShape(value); return true; }
+    if (strcmp(key, "esc_sh100") == 0)    { _config.escShape100 = parseRampShape(value); return true; }
+    if (strcmp(key, "esc_sh_after") == 0) { _config.escShapeAfterFullThrottle = parseRampShape(value); return true; }
+    if (strcmp(key, "esc_curve") == 0)    { _config.escRampCurvature = MoaRampProfile::clampCurvature(atof(value)); return true; }
+
     // Battery (float)
     if (strcmp(key, "batt_high") == 0)    { _config.battHigh = atof(value); return true; }
     if (strcmp(key, "batt_med") == 0)     { _config.battMedium = atof(value); return true; }
     if (strcmp(key, "batt_low") == 0)     { _config.battLow = atof(value); return true; }
     if (strcmp(key, "batt_stop") == 0)    { _config.battStop = atof(value); return true; }
     if (strcmp(key, "batt_hyst") == 0)    { _config.battHysteresis = atof(value); return true; }
+    if (strcmp(key, "batt_cap") == 0)     { _config.battCapacityMah = strtoul(value, nullptr, 10); return true; }
+    if (strcmp(key, "batt_full") == 0)    { _config.battFull = atof(value); return true; }
+    if (strcmp(key, "batt_comp") == 0)    { _config.battCompensation = (atoi(value) != 0) ? 1 : 0; return true; }
+    if (strcmp(key, "batt_rint") == 0)    { _config.battResistanceMohm = static_cast<uint16_t>(atoi(value)); return true; }
+    if (strcmp(key, "batt_sag") == 0)     { _config.battMaxSagMv = static_cast<uint16_t>(atoi(value)); return true; }
 
     // Temperature (float)
     if (strcmp(key, "temp_tgt") == 0)     { _config.tempTarget = atof(value); return true; }
     if (strcmp(key, "temp_hyst") == 0)    { _config.tempHysteresis = atof(value); return true; }
     if (strcmp(key, "temp_sens") == 0)    { _config.tempSensorType = (atoi(value) != 0) ? TempSensorType::NTC : TempSensorType::DS18B20; return true; }
+    if (strcmp(key, "temp_conv") == 0)    { _config.tempProbeMode = (atoi(value) != 0) ? 1 : 0; return true; }
+    if (strcmp(key, "temp_res_esc") == 0) { _config.tempProbeBits[TEMP_PROBE_ESC] = probeBits(value); return true; }
+    if (strcmp(key, "temp_res_mot") == 0) { _config.tempProbeBits[TEMP_PROBE_MOTOR] = probeBits(value); return true; }
+    if (strcmp(key, "temp_res_bat") == 0) { _config.tempProbeBits[TEMP_PROBE_BATTERY] = probeBits(value); return true; }
 
     // Current (float)
     if (strcmp(key, "curr_oc") == 0)      { _config.currentOvercurrent = atof(value); return true; }
@@ -286,5 +816,11 @@ bool UartCli::setSetting(const char* key, const char* value) {
     if (strcmp(key, "wifi_pass") == 0)    { strncpy(_config.wifiPassword, value, sizeof(_config.wifiPassword) - 1); _config.wifiPassword[sizeof(_config.wifiPassword) - 1] = '\0'; return true; }
     if (strcmp(key, "ota_host") == 0)     { strncpy(_config.otaHostname, value, sizeof(_config.otaHostname) - 1); _config.otaHostname[sizeof(_config.otaHostname) - 1] = '\0'; return true; }
 
+    // Telemetry stream
+    if (strcmp(key, "tlm_ms") == 0)       { _config.telemetryPeriodMs = (uint16_t)atoi(value); return true; }
+    if (strcmp(key, "tlm_sink") == 0)     { _config.telemetrySink = (atoi(value) != 0) ? 1 : 0; return true; }
+    if (strcmp(key, "tlm_host") == 0)     { strncpy(_config.telemetryHost, value, sizeof(_config.telemetryHost) - 1); _config.telemetryHost[sizeof(_config.telemetryHost) - 1] = '\0'; return true; }
+    if (strcmp(key, "tlm_port") == 0)     { _config.telemetryPort = (uint16_t)atoi(value); return true; }
+
     return false;
 }
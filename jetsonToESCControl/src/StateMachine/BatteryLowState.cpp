@@ -1,10 +1,9 @@
-#include "Arduino.h"
 #include "BatteryLowState.h"
 #include "esp_log.h"
 
 static const char* TAG = "BattLowState";
 
-BatteryLowState::BatteryLowState(MoaStateMachine& moaMachine, MoaDevicesManager& devices) : MoaState(devices), _moaMachine(moaMachine) {
+BatteryLowState::BatteryLowState(MoaStateMachine& moaMachine, IMoaActions& devices) : MoaState(devices), _moaMachine(moaMachine) {
 }
 
 void BatteryLowState::onEnter() {
@@ -14,18 +13,18 @@ void BatteryLowState::onEnter() {
     _devices.refreshLedIndicators();
 }
 
-void BatteryLowState::buttonClick(ControlCommand command) {
-    ESP_LOGD(TAG, "buttonClick (cmdType=%d, val=%d)", command.commandType, command.value);
-    if (command.commandType == COMMAND_BUTTON_STOP && command.value == BUTTON_EVENT_LONG_PRESS) {
+void BatteryLowState::buttonClick(ButtonEvent command) {
+    ESP_LOGD(TAG, "buttonClick (cmdType=%d, val=%d)", command.getButtonId(), command.getEventType());
+    if (command.getButtonId() == COMMAND_BUTTON_STOP && command.getEventType() == BUTTON_EVENT_LONG_PRESS) {
         ESP_LOGI(TAG, "Locking board - going to Init State");
         _devices.stopMotor();
         _moaMachine.setState(_moaMachine.getInitState());
     }
 }
 
-void BatteryLowState::overcurrentDetected(ControlCommand command) {
-    ESP_LOGD(TAG, "overcurrentDetected (cmdType=%d, val=%d)", command.commandType, command.value);
-    switch(command.commandType){
+void BatteryLowState::overcurrentDetected(CurrentEvent command) {
+    ESP_LOGD(TAG, "overcurrentDetected (cmdType=%d, val=%d)", command.getCommand(), command.getDeciAmps());
+    switch(command.getCommand()){
         case COMMAND_CURRENT_OVERCURRENT:
             ESP_LOGI(TAG, "Overcurrent detected - going to OverCurrent State");
             _devices.stopMotor();
@@ -34,9 +33,9 @@ void BatteryLowState::overcurrentDetected(ControlCommand command) {
     }
 }
 
-void BatteryLowState::temperatureCrossedLimit(ControlCommand command) {
-    ESP_LOGD(TAG, "temperatureCrossedLimit (cmdType=%d, val=%d)", command.commandType, command.value);
-    switch(command.commandType){
+void BatteryLowState::temperatureCrossedLimit(TempEvent command) {
+    ESP_LOGD(TAG, "temperatureCrossedLimit (cmdType=%d, val=%d)", command.getCommand(), command.getDeciCelsius());
+    switch(command.getCommand()){
         case COMMAND_TEMP_CROSSED_ABOVE:
             ESP_LOGI(TAG, "Temperature high - going to OverHeating State");
             _devices.stopMotor();
@@ -45,9 +44,9 @@ void BatteryLowState::temperatureCrossedLimit(ControlCommand command) {
     }
 }
 
-void BatteryLowState::batteryLevelCrossedLimit(ControlCommand command) {
-    ESP_LOGD(TAG, "batteryLevelCrossedLimit (cmdType=%d, val=%d)", command.commandType, command.value);
-    switch(command.commandType){
+void BatteryLowState::batteryLevelCrossedLimit(BattEvent command) {
+    ESP_LOGD(TAG, "batteryLevelCrossedLimit (cmdType=%d, val=%d)", command.getLevel(), command.getMillivolts());
+    switch(command.getLevel()){
         case COMMAND_BATT_LEVEL_MEDIUM:
         case COMMAND_BATT_LEVEL_HIGH:
             ESP_LOGI(TAG, "Battery recovered - going to Idle State");
@@ -57,6 +56,15 @@ void BatteryLowState::batteryLevelCrossedLimit(ControlCommand command) {
     }
 }
 
-void BatteryLowState::timerExpired(ControlCommand command) {
-    ESP_LOGD(TAG, "timerExpired (cmdType=%d, val=%d)", command.commandType, command.value);
+void BatteryLowState::timerExpired(TimerEvent command) {
+    ESP_LOGD(TAG, "timerExpired (timerId=%d)", command.getTimerId());
+}
+
+void BatteryLowState::remoteCommand(RemoteEvent command) {
+    ESP_LOGD(TAG, "remoteCommand (cmdType=%d, duty=%d)", command.getCommand(), command.getDuty());
+    if (command.getCommand() == COMMAND_REMOTE_DISARM) {
+        ESP_LOGI(TAG, "Remote disarm - going to Init State");
+        _devices.stopMotor();
+        _moaMachine.setState(_moaMachine.getInitState());
+    }
 }
@@ -5,13 +5,13 @@
  * @date 2026-02-27
  */
 
-#include "Arduino.h"
 #include "ConfigState.h"
+#include "MoaLogCodes.h"
 #include "esp_log.h"
 
 static const char* TAG = "ConfigState";
 
-ConfigState::ConfigState(MoaStateMachine& moaMachine, MoaDevicesManager& devices)
+ConfigState::ConfigState(MoaStateMachine& moaMachine, IMoaActions& devices)
     : MoaState(devices)
     , _moaMachine(moaMachine) {
 }
@@ -23,9 +23,9 @@ void ConfigState::onEnter() {
     _devices.logSystem(LOG_SYS_CONFIG_ENTER);
 }
 
-void ConfigState::buttonClick(ControlCommand command) {
-    ESP_LOGD(TAG, "buttonClick (cmdType=%d, val=%d)", command.commandType, command.value);
-    if (command.commandType == COMMAND_BUTTON_STOP && command.value == BUTTON_EVENT_LONG_PRESS) {
+void ConfigState::buttonClick(ButtonEvent command) {
+    ESP_LOGD(TAG, "buttonClick (cmdType=%d, val=%d)", command.getButtonId(), command.getEventType());
+    if (command.getButtonId() == COMMAND_BUTTON_STOP && command.getEventType() == BUTTON_EVENT_LONG_PRESS) {
         ESP_LOGI(TAG, "Exiting Config State");
         _devices.stopOTA();
         _devices.exitConfigMode();
@@ -34,28 +34,39 @@ void ConfigState::buttonClick(ControlCommand command) {
     // Ignore all other buttons (throttle disabled in config)
 }
 
-void ConfigState::overcurrentDetected(ControlCommand command) {
-    ESP_LOGD(TAG, "overcurrentDetected (cmdType=%d, val=%d)", command.commandType, command.value);
+void ConfigState::overcurrentDetected(CurrentEvent command) {
+    ESP_LOGD(TAG, "overcurrentDetected (cmdType=%d, val=%d)", command.getCommand(), command.getDeciAmps());
     _devices.stopOTA();
     _devices.exitConfigMode();
     _moaMachine.setState(_moaMachine.getOverCurrentState());
 }
 
-void ConfigState::temperatureCrossedLimit(ControlCommand command) {
-    ESP_LOGD(TAG, "temperatureCrossedLimit (cmdType=%d, val=%d)", command.commandType, command.value);
+void ConfigState::temperatureCrossedLimit(TempEvent command) {
+    ESP_LOGD(TAG, "temperatureCrossedLimit (cmdType=%d, val=%d)", command.getCommand(), command.getDeciCelsius());
     _devices.stopOTA();
     _devices.exitConfigMode();
     _moaMachine.setState(_moaMachine.getOverHeatingState());
 }
 
-void ConfigState::batteryLevelCrossedLimit(ControlCommand command) {
-    ESP_LOGD(TAG, "batteryLevelCrossedLimit (cmdType=%d, val=%d)", command.commandType, command.value);
+void ConfigState::batteryLevelCrossedLimit(BattEvent command) {
+    ESP_LOGD(TAG, "batteryLevelCrossedLimit (cmdType=%d, val=%d)", command.getLevel(), command.getMillivolts());
     _devices.stopOTA();
     _devices.exitConfigMode();
     _moaMachine.setState(_moaMachine.getBatteryLowState());
 }
 
-void ConfigState::timerExpired(ControlCommand command) {
-    ESP_LOGD(TAG, "timerExpired (cmdType=%d, val=%d)", command.commandType, command.value);
+void ConfigState::timerExpired(TimerEvent command) {
+    ESP_LOGD(TAG, "timerExpired (timerId=%d)", command.getTimerId());
     // Ignored
 }
+
+void ConfigState::remoteCommand(RemoteEvent command) {
+    ESP_LOGD(TAG, "remoteCommand (cmdType=%d, duty=%d)", command.getCommand(), command.getDuty());
+    if (command.getCommand() == COMMAND_REMOTE_DISARM) {
+        ESP_LOGI(TAG, "Exiting Config State");
+        _devices.stopOTA();
+        _devices.exitConfigMode();
+        _moaMachine.setState(_moaMachine.getInitState());
+    }
+    // Arm and throttle stay local-only while OTA may be running
+}
@@ -1,11 +1,10 @@
-#include "Arduino.h"
 #include "IdleState.h"
 #include "Constants.h"
 #include "esp_log.h"
 
 static const char* TAG = "IdleState";
 
-IdleState::IdleState(MoaStateMachine& moaMachine, MoaDevicesManager& devices) : MoaState(devices), _moaMachine(moaMachine) {
+IdleState::IdleState(MoaStateMachine& moaMachine, IMoaActions& devices) : MoaState(devices), _moaMachine(moaMachine) {
 }
 
 void IdleState::onEnter() {
@@ -14,31 +13,44 @@ void IdleState::onEnter() {
     _devices.disengageThrottle();
 }
 
-void IdleState::buttonClick(ControlCommand command) {
-    ESP_LOGD(TAG, "buttonClick (cmdType=%d, val=%d)", command.commandType, command.value);
-    if (command.commandType == COMMAND_BUTTON_STOP && command.value == BUTTON_EVENT_LONG_PRESS) {
+void IdleState::buttonClick(ButtonEvent command) {
+    ESP_LOGD(TAG, "buttonClick (cmdType=%d, val=%d)", command.getButtonId(), command.getEventType());
+    if (command.getButtonId() == COMMAND_BUTTON_STOP && command.getEventType() == BUTTON_EVENT_LONG_PRESS) {
         ESP_LOGI(TAG, "Locking board - going to Init State");
         _devices.disengageThrottle();
         _moaMachine.setState(_moaMachine.getInitState());
-    } else if (command.commandType != COMMAND_BUTTON_STOP && command.value == BUTTON_EVENT_PRESS) {
+    } else if (command.getButtonId() != COMMAND_BUTTON_STOP && command.getEventType() == BUTTON_EVENT_PRESS) {
         ESP_LOGI(TAG, "Going to Surfing State");
-        _devices.engageThrottle(command.commandType);
+        _devices.engageThrottle(command.getButtonId());
         _moaMachine.setState(_moaMachine.getSurfingState());
     }
 }
 
-void IdleState::overcurrentDetected(ControlCommand command) {
-    ESP_LOGD(TAG, "overcurrentDetected (cmdType=%d, val=%d)", command.commandType, command.value);
+void IdleState::overcurrentDetected(CurrentEvent command) {
+    ESP_LOGD(TAG, "overcurrentDetected (cmdType=%d, val=%d)", command.getCommand(), command.getDeciAmps());
 }
 
-void IdleState::temperatureCrossedLimit(ControlCommand command) {
-    ESP_LOGD(TAG, "temperatureCrossedLimit (cmdType=%d, val=%d)", command.commandType, command.value);
+void IdleState::temperatureCrossedLimit(TempEvent command) {
+    ESP_LOGD(TAG, "temperatureCrossedLimit (cmdType=%d, val=%d)", command.getCommand(), command.getDeciCelsius());
 }
 
-void IdleState::batteryLevelCrossedLimit(ControlCommand command) {
-    ESP_LOGD(TAG, "batteryLevelCrossedLimit (cmdType=%d, val=%d)", command.commandType, command.value);
+void IdleState::batteryLevelCrossedLimit(BattEvent command) {
+    ESP_LOGD(TAG, "batteryLevelCrossedLimit (cmdType=%d, val=%d)", command.getLevel(), command.getMillivolts());
 }
 
-void IdleState::timerExpired(ControlCommand command) {
-    ESP_LOGD(TAG, "timerExpired (cmdType=%d, val=%d)", command.commandType, command.value);
+void IdleState::timerExpired(TimerEvent command) {
+    ESP_LOGD(TAG, "timerExpired (timerId=%d)", command.getTimerId());
+}
+
+void IdleState::remoteCommand(RemoteEvent command) {
+    ESP_LOGD(TAG, "remoteCommand (cmdType=%d, duty=%d)", command.getCommand(), command.getDuty());
+    if (command.getCommand() == COMMAND_REMOTE_DISARM) {
+        ESP_LOGI(TAG, "Remote disarm - going to Init State");
+        _devices.disengageThrottle();
+        _moaMachine.setState(_moaMachine.getInitState());
+    } else if (command.getCommand() == COMMAND_REMOTE_THROTTLE && command.getDuty() > 0) {
+        ESP_LOGI(TAG, "Remote throttle - going to Surfing State");
+        _devices.setRemoteThrottle(command.getDuty());
+        _moaMachine.setState(_moaMachine.getSurfingState());
+    }
 }
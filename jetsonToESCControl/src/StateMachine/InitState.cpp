@@ -1,10 +1,9 @@
-#include "Arduino.h"
 #include "InitState.h"
 #include "esp_log.h"
 
 static const char* TAG = "InitState";
 
-InitState::InitState(MoaStateMachine& moaMachine, MoaDevicesManager& devices) : MoaState(devices), _moaMachine(moaMachine) {
+InitState::InitState(MoaStateMachine& moaMachine, IMoaActions& devices) : MoaState(devices), _moaMachine(moaMachine) {
 }
 
 void InitState::onEnter() {
@@ -14,32 +13,43 @@ void InitState::onEnter() {
     _devices.refreshLedIndicators();
 }
 
-void InitState::buttonClick(ControlCommand command) {
-    ESP_LOGD(TAG, "buttonClick (cmdType=%d, val=%d)", command.commandType, command.value);
-    if (command.commandType == COMMAND_BUTTON_STOP && command.value == BUTTON_EVENT_LONG_PRESS) {
+void InitState::buttonClick(ButtonEvent command) {
+    ESP_LOGD(TAG, "buttonClick (cmdType=%d, val=%d)", command.getButtonId(), command.getEventType());
+    if (command.getButtonId() == COMMAND_BUTTON_STOP && command.getEventType() == BUTTON_EVENT_LONG_PRESS) {
         ESP_LOGI(TAG, "Unlocking board - going to Idle State");
         _devices.showBoardUnlocked();
         _devices.waveAllLeds(true);
         _devices.refreshLedIndicators();
         _moaMachine.setState(_moaMachine.getIdleState());
-    } else if (command.commandType == COMMAND_BUTTON_STOP && command.value == BUTTON_EVENT_VERY_LONG_PRESS) {
+    } else if (command.getButtonId() == COMMAND_BUTTON_STOP && command.getEventType() == BUTTON_EVENT_VERY_LONG_PRESS) {
         ESP_LOGI(TAG, "Entering Config State");
         _moaMachine.setState(_moaMachine.getConfigState());
     }
 }
 
-void InitState::overcurrentDetected(ControlCommand command) {
-    ESP_LOGD(TAG, "overcurrentDetected (cmdType=%d, val=%d)", command.commandType, command.value);
+void InitState::overcurrentDetected(CurrentEvent command) {
+    ESP_LOGD(TAG, "overcurrentDetected (cmdType=%d, val=%d)", command.getCommand(), command.getDeciAmps());
 }
 
-void InitState::temperatureCrossedLimit(ControlCommand command) {
-    ESP_LOGD(TAG, "temperatureCrossedLimit (cmdType=%d, val=%d)", command.commandType, command.value);
+void InitState::temperatureCrossedLimit(TempEvent command) {
+    ESP_LOGD(TAG, "temperatureCrossedLimit (cmdType=%d, val=%d)", command.getCommand(), command.getDeciCelsius());
 }
 
-void InitState::batteryLevelCrossedLimit(ControlCommand command) {
-    ESP_LOGD(TAG, "batteryLevelCrossedLimit (cmdType=%d, val=%d)", command.commandType, command.value);
+void InitState::batteryLevelCrossedLimit(BattEvent command) {
+    ESP_LOGD(TAG, "batteryLevelCrossedLimit (cmdType=%d, val=%d)", command.getLevel(), command.getMillivolts());
 }
 
-void InitState::timerExpired(ControlCommand command) {
-    ESP_LOGD(TAG, "timerExpired (cmdType=%d, val=%d)", command.commandType, command.value);
+void InitState::timerExpired(TimerEvent command) {
+    ESP_LOGD(TAG, "timerExpired (timerId=%d)", command.getTimerId());
+}
+
+void InitState::remoteCommand(RemoteEvent command) {
+    ESP_LOGD(TAG, "remoteCommand (cmdType=%d, duty=%d)", command.getCommand(), command.getDuty());
+    if (command.getCommand() == COMMAND_REMOTE_ARM) {
+        ESP_LOGI(TAG, "Remote arm - going to Idle State");
+        _devices.showBoardUnlocked();
+        _devices.waveAllLeds(true);
+        _devices.refreshLedIndicators();
+        _moaMachine.setState(_moaMachine.getIdleState());
+    }
 }
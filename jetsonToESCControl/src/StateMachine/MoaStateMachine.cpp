@@ -1,4 +1,3 @@
-#include "Arduino.h"
 #include "MoaStateMachine.h"
 #include "InitState.h"
 #include "IdleState.h"
@@ -11,7 +10,7 @@
 
 static const char* TAG = "StateMachine";
 
-MoaStateMachine::MoaStateMachine(MoaDevicesManager& devices){
+MoaStateMachine::MoaStateMachine(IMoaActions& devices){
     _initState = new InitState(*this, devices);
     _idleState = new IdleState(*this, devices);
     _surfingState = new SurfingState(*this, devices);
@@ -23,39 +22,70 @@ MoaStateMachine::MoaStateMachine(MoaDevicesManager& devices){
     ESP_LOGI(TAG, "State machine initialized, starting in InitState");
 }
 
-void MoaStateMachine::buttonClick(ControlCommand command){
+MoaStateMachine::~MoaStateMachine(){
+    delete _initState;
+    delete _idleState;
+    delete _surfingState;
+    delete _overHeatingState;
+    delete _overCurrentState;
+    delete _batteryLowState;
+    delete _configState;
+}
+
+void MoaStateMachine::buttonClick(ButtonEvent command){
     _state->buttonClick(command);
 }
 
-void MoaStateMachine::overcurrentDetected(ControlCommand command){
+void MoaStateMachine::overcurrentDetected(CurrentEvent command){
     _state->overcurrentDetected(command);
 }
 
-void MoaStateMachine::temperatureCrossedLimit(ControlCommand command){
+void MoaStateMachine::temperatureCrossedLimit(TempEvent command){
     _state->temperatureCrossedLimit(command);
 }
 
-void MoaStateMachine::batteryLevelCrossedLimit(ControlCommand command){
+void MoaStateMachine::batteryLevelCrossedLimit(BattEvent command){
     _state->batteryLevelCrossedLimit(command);
 }
 
-void MoaStateMachine::timerExpired(ControlCommand command){
+void MoaStateMachine::timerExpired(TimerEvent command){
     _state->timerExpired(command);
 }
 
+void MoaStateMachine::remoteCommand(RemoteEvent command){
+    _state->remoteCommand(command);
+}
+
 void MoaStateMachine::setState(MoaState* state){
-    ESP_LOGI(TAG, "State transition -> %s",
-        (state == _initState) ? "Init" :
-        (state == _idleState) ? "Idle" :
-        (state == _surfingState) ? "Surfing" :
-        (state == _overHeatingState) ? "OverHeating" :
-        (state == _overCurrentState) ? "OverCurrent" :
-        (state == _batteryLowState) ? "BatteryLow" :
-        (state == _configState) ? "Config" : "Unknown");
     _state = state;
+    ESP_LOGI(TAG, "State transition -> %s", getStateName());
     _state->onEnter();
 }
 
+MoaState* MoaStateMachine::getState(){
+    return _state;
+}
+
+const char* MoaStateMachine::getStateName() const{
+    return (_state == _initState) ? "Init" :
+        (_state == _idleState) ? "Idle" :
+        (_state == _surfingState) ? "Surfing" :
+        (_state == _overHeatingState) ? "OverHeating" :
+        (_state == _overCurrentState) ? "OverCurrent" :
+        (_state == _batteryLowState) ? "BatteryLow" :
+        (_state == _configState) ? "Config" : "Unknown";
+}
+
+MoaStateId MoaStateMachine::getStateId() const{
+    return (_state == _initState) ? MoaStateId::INIT :
+        (_state == _idleState) ? MoaStateId::IDLE :
+        (_state == _surfingState) ? MoaStateId::SURFING :
+        (_state == _overHeatingState) ? MoaStateId::OVER_HEATING :
+        (_state == _overCurrentState) ? MoaStateId::OVER_CURRENT :
+        (_state == _batteryLowState) ? MoaStateId::BATTERY_LOW :
+        (_state == _configState) ? MoaStateId::CONFIG : MoaStateId::NONE;
+}
+
 MoaState* MoaStateMachine::getInitState(){
     return _initState;
 }
@@ -7,6 +7,7 @@
 
 #include "MoaStateMachineWrapper.h"
 #include "esp_log.h"
+#include "MoaLatencyTrace.h"
 
 static const char* TAG = "SMWrapper";
 
@@ -21,29 +22,37 @@ MoaStateMachineWrapper::~MoaStateMachineWrapper() {
 
 void MoaStateMachineWrapper::setInitialState() {
     ESP_LOGI(TAG, "Setting initial state");
+#if MOA_STATE_MACHINE_TABLE
+    _stateMachine.start();
+#else
     _stateMachine.setState(_stateMachine.getInitState());
+#endif
 }
 
 void MoaStateMachineWrapper::handleEvent(ControlCommand cmd) {
     switch (cmd.controlType) {
         case CONTROL_TYPE_TIMER:
-            handleTimerEvent(cmd);
+            handleTimerEvent(TimerEvent(cmd));
             break;
             
         case CONTROL_TYPE_TEMPERATURE:
-            handleTemperatureEvent(cmd);
+            handleTemperatureEvent(TempEvent(cmd));
             break;
             
         case CONTROL_TYPE_BATTERY:
-            handleBatteryEvent(cmd);
+            handleBatteryEvent(BattEvent(cmd));
             break;
             
         case CONTROL_TYPE_CURRENT:
-            handleCurrentEvent(cmd);
+            handleCurrentEvent(CurrentEvent(cmd));
             break;
             
         case CONTROL_TYPE_BUTTON:
-            handleButtonEvent(cmd);
+            handleButtonEvent(ButtonEvent(cmd));
+            break;
+
+        case CONTROL_TYPE_REMOTE:
+            handleRemoteEvent(RemoteEvent(cmd));
             break;
             
         default:
@@ -55,41 +64,59 @@ void MoaStateMachineWrapper::handleEvent(ControlCommand cmd) {
     _devices.updateLog();
 }
 
-void MoaStateMachineWrapper::handleTimerEvent(ControlCommand& cmd) {
-    ESP_LOGD(TAG, "Timer event: timerId=%d", cmd.commandType);
-    _stateMachine.timerExpired(cmd);
+const char* MoaStateMachineWrapper::getStateName() const {
+#if MOA_STATE_MACHINE_TABLE
+    return MoaStateTable::getStateName(_stateMachine.getState());
+#else
+    return _stateMachine.getStateName();
+#endif
+}
+
+MoaStateId MoaStateMachineWrapper::getStateId() const {
+#if MOA_STATE_MACHINE_TABLE
+    return _stateMachine.getState();
+#else
+    return _stateMachine.getStateId();
+#endif
+}
+
+void MoaStateMachineWrapper::handleTimerEvent(const TimerEvent& event) {
+    ESP_LOGD(TAG, "Timer event: timerId=%d", event.getTimerId());
+    MOA_LATENCY_MARK(MOA_HOP_STATE);
+    _stateMachine.timerExpired(event);
 }
 
-void MoaStateMachineWrapper::handleTemperatureEvent(ControlCommand& cmd) {
+void MoaStateMachineWrapper::handleTemperatureEvent(const TempEvent& event) {
     ESP_LOGI(TAG, "Temperature event: %s (%.1fC)", 
-        (cmd.commandType == COMMAND_TEMP_CROSSED_ABOVE) ? "ABOVE" : "BELOW", 
-        cmd.value / 10.0f);
+        (event.getCommand() == COMMAND_TEMP_CROSSED_ABOVE) ? "ABOVE" : "BELOW", 
+        event.getDeciCelsius() / 10.0f);
     // Log the event
-    _devices.logTemp(cmd.commandType, static_cast<int16_t>(cmd.value));
+    _devices.logTemp(event.getCommand(), event.getDeciCelsius());
     
     // Update LED indicator based on event type
-    if (cmd.commandType == COMMAND_TEMP_CROSSED_ABOVE) {
+    if (event.getCommand() == COMMAND_TEMP_CROSSED_ABOVE) {
         _devices.indicateOverheat(true);
     } else {
         _devices.indicateOverheat(false);
     }
     
     // Route to state machine
-    _stateMachine.temperatureCrossedLimit(cmd);
+    MOA_LATENCY_MARK(MOA_HOP_STATE);
+    _stateMachine.temperatureCrossedLimit(event);
 }
 
-void MoaStateMachineWrapper::handleBatteryEvent(ControlCommand& cmd) {
+void MoaStateMachineWrapper::handleBatteryEvent(const BattEvent& event) {
     ESP_LOGI(TAG, "Battery event: level=%s (%.3fV)",
-        (cmd.commandType == COMMAND_BATT_LEVEL_HIGH) ? "HIGH" : 
-        (cmd.commandType == COMMAND_BATT_LEVEL_MEDIUM) ? "MEDIUM" :
-        (cmd.commandType == COMMAND_BATT_LEVEL_LOW) ? "LOW" : "STOP",
-        cmd.value / 1000.0f);
+        (event.getLevel() == COMMAND_BATT_LEVEL_HIGH) ? "HIGH" : 
+        (event.getLevel() == COMMAND_BATT_LEVEL_MEDIUM) ? "MEDIUM" :
+        (event.getLevel() == COMMAND_BATT_LEVEL_LOW) ? "LOW" : "STOP",
+        event.getMillivolts() / 1000.0f);
     // Log the event
-    _devices.logBatt(cmd.commandType, static_cast<int16_t>(cmd.value));
+    _devices.logBatt(event.getLevel(), static_cast<int16_t>(event.getMillivolts()));
     
     // Update battery LEDs based on level
     MoaBattLevel level;
-    switch (cmd.commandType) {
+    switch (event.getLevel()) {
         case COMMAND_BATT_LEVEL_HIGH:
             level = MoaBattLevel::BATT_HIGH;
             break;
@@ -107,41 +134,59 @@ void MoaStateMachineWrapper::handleBatteryEvent(ControlCommand& cmd) {
     _devices.showBatteryLevel(level);
     
     // Route to state machine
-    _stateMachine.batteryLevelCrossedLimit(cmd);
+    MOA_LATENCY_MARK(MOA_HOP_STATE);
+    _stateMachine.batteryLevelCrossedLimit(event);
 }
 
-void MoaStateMachineWrapper::handleCurrentEvent(ControlCommand& cmd) {
+void MoaStateMachineWrapper::handleCurrentEvent(const CurrentEvent& event) {
     ESP_LOGI(TAG, "Current event: %s (%.1fA)",
-        (cmd.commandType == COMMAND_CURRENT_NORMAL) ? "NORMAL" : 
-        (cmd.commandType == COMMAND_CURRENT_OVERCURRENT) ? "OVERCURRENT" : "REVERSE",
-        cmd.value / 10.0f);
+        (event.getCommand() == COMMAND_CURRENT_NORMAL) ? "NORMAL" : 
+        (event.getCommand() == COMMAND_CURRENT_OVERCURRENT) ? "OVERCURRENT" : "REVERSE",
+        event.getDeciAmps() / 10.0f);
     // Log the event
-    _devices.logCurrent(cmd.commandType, static_cast<int16_t>(cmd.value));
+    _devices.logCurrent(event.getCommand(), event.getDeciAmps());
     
     // Update LED indicator based on event type
-    if (cmd.commandType == COMMAND_CURRENT_OVERCURRENT || cmd.commandType == COMMAND_CURRENT_REVERSE_OVERCURRENT) {
+    if (event.getCommand() == COMMAND_CURRENT_OVERCURRENT || event.getCommand() == COMMAND_CURRENT_REVERSE_OVERCURRENT) {
         _devices.indicateOvercurrent(true);
     } else {
         _devices.indicateOvercurrent(false);
     }
     
     // Route to state machine
-    _stateMachine.overcurrentDetected(cmd);
+    MOA_LATENCY_MARK(MOA_HOP_STATE);
+    _stateMachine.overcurrentDetected(event);
+
+    // Current is back to normal: release the fast trip latch (motor stays stopped)
+    if (event.getCommand() == COMMAND_CURRENT_NORMAL) {
+        _devices.resetOvercurrentTrip();
+    }
 }
 
-void MoaStateMachineWrapper::handleButtonEvent(ControlCommand& cmd) {
+void MoaStateMachineWrapper::handleButtonEvent(const ButtonEvent& event) {
     ESP_LOGI(TAG, "Button event: cmdId=%d, eventType=%s",
-        cmd.commandType,
-        (cmd.value == BUTTON_EVENT_PRESS) ? "PRESS" :
-        (cmd.value == BUTTON_EVENT_LONG_PRESS) ? "LONG_PRESS" :
-        (cmd.value == BUTTON_EVENT_VERY_LONG_PRESS) ? "VERY_LONG_PRESS" : "RELEASE");
+        event.getButtonId(),
+        (event.getEventType() == BUTTON_EVENT_PRESS) ? "PRESS" :
+        (event.getEventType() == BUTTON_EVENT_LONG_PRESS) ? "LONG_PRESS" :
+        (event.getEventType() == BUTTON_EVENT_VERY_LONG_PRESS) ? "VERY_LONG_PRESS" : "RELEASE");
     // Log the event
-    uint8_t logCode = cmd.commandType;  // COMMAND_BUTTON_STOP=1, etc.
-    if (cmd.value == BUTTON_EVENT_LONG_PRESS) {
+    uint8_t logCode = event.getButtonId();  // COMMAND_BUTTON_STOP=1, etc.
+    if (event.getEventType() == BUTTON_EVENT_LONG_PRESS) {
         logCode = LOG_BTN_STOP_LONG;
     }
     _devices.logButton(logCode);
     
     // Route to state machine (states decide what long/very-long press means)
-    _stateMachine.buttonClick(cmd);
+    MOA_LATENCY_MARK(MOA_HOP_STATE);
+    _stateMachine.buttonClick(event);
+}
+
+void MoaStateMachineWrapper::handleRemoteEvent(const RemoteEvent& event) {
+    ESP_LOGD(TAG, "Remote event: %s (duty=%u)",
+        (event.getCommand() == COMMAND_REMOTE_ARM) ? "ARM" :
+        (event.getCommand() == COMMAND_REMOTE_DISARM) ? "DISARM" : "THROTTLE",
+        event.getDuty());
+    // Setpoints stream at the link rate: not written to the flash log
+    MOA_LATENCY_MARK(MOA_HOP_STATE);
+    _stateMachine.remoteCommand(event);
 }
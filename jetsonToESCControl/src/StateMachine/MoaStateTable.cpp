@@ -0,0 +1,406 @@
+/**
+ * @file MoaStateTable.cpp
+ * @brief Transition table and dispatch for MoaStateTable
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "MoaStateTable.h"
+#include "Constants.h"
+#include "MoaLogCodes.h"
+#include "esp_log.h"
+
+static const char* TAG = "StateTable";
+
+// =============================================================================
+// Guards
+// =============================================================================
+
+// Guards and actions see the raw command of their row's event; each reads
+// it through that event's typed view.
+
+static bool isStopLongPress(const ControlCommand& c) {
+    ButtonEvent b(c);
+    return b.getButtonId() == COMMAND_BUTTON_STOP && b.getEventType() == BUTTON_EVENT_LONG_PRESS;
+}
+
+static bool isStopVeryLongPress(const ControlCommand& c) {
+    ButtonEvent b(c);
+    return b.getButtonId() == COMMAND_BUTTON_STOP && b.getEventType() == BUTTON_EVENT_VERY_LONG_PRESS;
+}
+
+static bool isStopPress(const ControlCommand& c) {
+    ButtonEvent b(c);
+    return b.getButtonId() == COMMAND_BUTTON_STOP && b.getEventType() == BUTTON_EVENT_PRESS;
+}
+
+static bool isThrottlePress(const ControlCommand& c) {
+    ButtonEvent b(c);
+    return b.getButtonId() != COMMAND_BUTTON_STOP && b.getEventType() == BUTTON_EVENT_PRESS;
+}
+
+static bool isOvercurrent(const ControlCommand& c) {
+    return CurrentEvent(c).getCommand() == COMMAND_CURRENT_OVERCURRENT;
+}
+
+static bool isCurrentNormal(const ControlCommand& c) {
+    return CurrentEvent(c).getCommand() == COMMAND_CURRENT_NORMAL;
+}
+
+static bool isTempAbove(const ControlCommand& c) {
+    return TempEvent(c).getCommand() == COMMAND_TEMP_CROSSED_ABOVE;
+}
+
+static bool isTempBelow(const ControlCommand& c) {
+    return TempEvent(c).getCommand() == COMMAND_TEMP_CROSSED_BELOW;
+}
+
+static bool isBattLow(const ControlCommand& c) {
+    return BattEvent(c).getLevel() == COMMAND_BATT_LEVEL_LOW;
+}
+
+static bool isBattLowOrStop(const ControlCommand& c) {
+    uint8_t level = BattEvent(c).getLevel();
+    return level == COMMAND_BATT_LEVEL_LOW || level == COMMAND_BATT_LEVEL_STOP;
+}
+
+static bool isBattRecovered(const ControlCommand& c) {
+    uint8_t level = BattEvent(c).getLevel();
+    return level == COMMAND_BATT_LEVEL_MEDIUM || level == COMMAND_BATT_LEVEL_HIGH;
+}
+
+static bool isThrottleTimer(const ControlCommand& c) {
+    return TimerEvent(c).getTimerId() == TIMER_ID_THROTTLE;
+}
+
+static bool isFullThrottleTimer(const ControlCommand& c) {
+    return TimerEvent(c).getTimerId() == TIMER_ID_FULL_THROTTLE;
+}
+
+static bool isRemoteArm(const ControlCommand& c) {
+    return RemoteEvent(c).getCommand() == COMMAND_REMOTE_ARM;
+}
+
+static bool isRemoteDisarm(const ControlCommand& c) {
+    return RemoteEvent(c).getCommand() == COMMAND_REMOTE_DISARM;
+}
+
+static bool isRemoteThrottle(const ControlCommand& c) {
+    RemoteEvent r(c);
+    return r.getCommand() == COMMAND_REMOTE_THROTTLE && r.getDuty() > 0;
+}
+
+static bool isRemoteStop(const ControlCommand& c) {
+    RemoteEvent r(c);
+    return r.getCommand() == COMMAND_REMOTE_THROTTLE && r.getDuty() == 0;
+}
+
+// =============================================================================
+// Transition actions
+// =============================================================================
+
+static void unlockBoard(IMoaActions& a, const ControlCommand&) {
+    a.showBoardUnlocked();
+    a.waveAllLeds(true);
+    a.refreshLedIndicators();
+}
+
+static void engageThrottle(IMoaActions& a, const ControlCommand& c) {
+    a.engageThrottle(ButtonEvent(c).getButtonId());
+}
+
+static void remoteThrottle(IMoaActions& a, const ControlCommand& c) {
+    a.setRemoteThrottle(RemoteEvent(c).getDuty());
+}
+
+static void disengageThrottle(IMoaActions& a, const ControlCommand&) {
+    a.disengageThrottle();
+}
+
+static void stepDownThrottle(IMoaActions& a, const ControlCommand&) {
+    a.handleThrottleStepDown();
+}
+
+static void stopMotor(IMoaActions& a, const ControlCommand&) {
+    a.stopMotor();
+}
+
+static void leaveConfig(IMoaActions& a, const ControlCommand&) {
+    a.stopOTA();
+    a.exitConfigMode();
+}
+
+static void warnBatteryWhileSurfing(IMoaActions&, const ControlCommand& c) {
+    // No forced stop: the rider decides, the LEDs already show the level
+    ESP_LOGW(TAG, "Battery %s while surfing (no forced stop)",
+        (BattEvent(c).getLevel() == COMMAND_BATT_LEVEL_STOP) ? "critical" : "low");
+}
+
+// =============================================================================
+// Entry actions
+// =============================================================================
+
+static void enterInit(IMoaActions& a) {
+    a.showBoardLocked();
+    a.waveAllLeds(false);
+    a.refreshLedIndicators();
+}
+
+static void enterIdle(IMoaActions& a) {
+    a.showBoardUnlocked();
+    a.disengageThrottle();
+}
+
+static void enterOverHeating(IMoaActions& a) {
+    a.stopMotor();
+    a.indicateOverheat(true);
+    a.refreshLedIndicators();
+}
+
+static void enterOverCurrent(IMoaActions& a) {
+    a.stopMotor();
+    a.indicateOvercurrent(true);
+    a.refreshLedIndicators();
+}
+
+static void enterBatteryLow(IMoaActions& a) {
+    a.stopMotor();
+    a.showBatteryLevel(MoaBattLevel::BATT_LOW);
+    a.refreshLedIndicators();
+}
+
+static void enterConfig(IMoaActions& a) {
+    a.enterConfigMode();
+    a.startOTA();
+    a.logSystem(LOG_SYS_CONFIG_ENTER);
+}
+
+// =============================================================================
+// Tables
+// =============================================================================
+
+typedef MoaStateId S;
+typedef MoaEventId E;
+
+/**
+ * @brief Transition table, grouped by state then event (enum order)
+ */
+static constexpr MoaTransition kTransitions[] = {
+    // from             event            guard                 action                   to
+    { S::INIT,          E::BUTTON,       isStopLongPress,      unlockBoard,             S::IDLE },
+    { S::INIT,          E::BUTTON,       isStopVeryLongPress,  nullptr,                 S::CONFIG },
+    { S::INIT,          E::REMOTE,       isRemoteArm,          unlockBoard,             S::IDLE },
+
+    { S::IDLE,          E::BUTTON,       isStopLongPress,      disengageThrottle,       S::INIT },
+    { S::IDLE,          E::BUTTON,       isThrottlePress,      engageThrottle,          S::SURFING },
+    { S::IDLE,          E::REMOTE,       isRemoteDisarm,       disengageThrottle,       S::INIT },
+    { S::IDLE,          E::REMOTE,       isRemoteThrottle,     remoteThrottle,          S::SURFING },
+
+    { S::SURFING,       E::BUTTON,       isThrottlePress,      engageThrottle,          S::NONE },
+    { S::SURFING,       E::BUTTON,       isStopPress,          disengageThrottle,       S::IDLE },
+    { S::SURFING,       E::CURRENT,      isOvercurrent,        disengageThrottle,       S::OVER_CURRENT },
+    { S::SURFING,       E::TEMPERATURE,  isTempAbove,          disengageThrottle,       S::OVER_HEATING },
+    { S::SURFING,       E::BATTERY,      isBattLowOrStop,      warnBatteryWhileSurfing, S::NONE },
+    { S::SURFING,       E::TIMER,        isThrottleTimer,      disengageThrottle,       S::IDLE },
+    { S::SURFING,       E::TIMER,        isFullThrottleTimer,  stepDownThrottle,        S::NONE },
+    { S::SURFING,       E::REMOTE,       isRemoteThrottle,     remoteThrottle,          S::NONE },
+    { S::SURFING,       E::REMOTE,       isRemoteStop,         disengageThrottle,       S::IDLE },
+    { S::SURFING,       E::REMOTE,       isRemoteDisarm,       disengageThrottle,       S::INIT },
+
+    { S::OVER_HEATING,  E::BUTTON,       isStopLongPress,      stopMotor,               S::INIT },
+    { S::OVER_HEATING,  E::CURRENT,      isOvercurrent,        stopMotor,               S::OVER_CURRENT },
+    { S::OVER_HEATING,  E::TEMPERATURE,  isTempBelow,          stopMotor,               S::IDLE },
+    { S::OVER_HEATING,  E::BATTERY,      isBattLow,            stopMotor,               S::BATTERY_LOW },
+    { S::OVER_HEATING,  E::REMOTE,       isRemoteDisarm,       stopMotor,               S::INIT },
+
+    { S::OVER_CURRENT,  E::BUTTON,       isStopLongPress,      stopMotor,               S::INIT },
+    { S::OVER_CURRENT,  E::CURRENT,      isCurrentNormal,      disengageThrottle,       S::IDLE },
+    { S::OVER_CURRENT,  E::TEMPERATURE,  isTempAbove,          stopMotor,               S::OVER_HEATING },
+    { S::OVER_CURRENT,  E::BATTERY,      isBattLow,            stopMotor,               S::BATTERY_LOW },
+    { S::OVER_CURRENT,  E::REMOTE,       isRemoteDisarm,       stopMotor,               S::INIT },
+
+    { S::BATTERY_LOW,   E::BUTTON,       isStopLongPress,      stopMotor,               S::INIT },
+    { S::BATTERY_LOW,   E::CURRENT,      isOvercurrent,        stopMotor,               S::OVER_CURRENT },
+    { S::BATTERY_LOW,   E::TEMPERATURE,  isTempAbove,          stopMotor,               S::OVER_HEATING },
+    { S::BATTERY_LOW,   E::BATTERY,      isBattRecovered,      stopMotor,               S::IDLE },
+    { S::BATTERY_LOW,   E::REMOTE,       isRemoteDisarm,       stopMotor,               S::INIT },
+
+    // Any sensor event leaves Config (shuts OTA down) for the matching fault state
+    { S::CONFIG,        E::BUTTON,       isStopLongPress,      leaveConfig,             S::INIT },
+    { S::CONFIG,        E::CURRENT,      nullptr,              leaveConfig,             S::OVER_CURRENT },
+    { S::CONFIG,        E::TEMPERATURE,  nullptr,              leaveConfig,             S::OVER_HEATING },
+    { S::CONFIG,        E::BATTERY,      nullptr,              leaveConfig,             S::BATTERY_LOW },
+    { S::CONFIG,        E::REMOTE,       isRemoteDisarm,       leaveConfig,             S::INIT },
+};
+
+/**
+ * @brief Entry action per state (nullptr = none)
+ */
+static const MoaEntryFn kEntryActions[] = {
+    enterInit,          // INIT
+    enterIdle,          // IDLE
+    nullptr,            // SURFING
+    enterOverHeating,   // OVER_HEATING
+    enterOverCurrent,   // OVER_CURRENT
+    enterBatteryLow,    // BATTERY_LOW
+    enterConfig,        // CONFIG
+};
+
+static const char* const kStateNames[] = {
+    "Init", "Idle", "Surfing", "OverHeating", "OverCurrent", "BatteryLow", "Config"
+};
+
+// =============================================================================
+// Compile-time checks (C++11 constexpr: recursion instead of loops)
+// =============================================================================
+
+static constexpr size_t kTransitionCount = sizeof(kTransitions) / sizeof(kTransitions[0]);
+static constexpr uint8_t kStateCount = static_cast<uint8_t>(S::COUNT);
+static constexpr uint8_t kEventCount = static_cast<uint8_t>(E::COUNT);
+
+static constexpr uint8_t slotOf(S state, E event) {
+    return static_cast<uint8_t>(static_cast<uint8_t>(state) * kEventCount + static_cast<uint8_t>(event));
+}
+
+static constexpr uint8_t rowSlot(size_t row) {
+    return slotOf(kTransitions[row].from, kTransitions[row].event);
+}
+
+/**
+ * @brief Safety rules every transition must respect
+ */
+static constexpr bool isLegalTransition(S from, S to) {
+    return to == S::NONE
+        || (to < S::COUNT && from < S::COUNT && to != from
+            && (to != S::SURFING || from == S::IDLE)     // Throttle only from an unlocked, stopped board
+            && (to != S::CONFIG || from == S::INIT));    // OTA only while locked
+}
+
+static constexpr bool rowsGrouped(size_t row = 1) {
+    return row >= kTransitionCount || (rowSlot(row - 1) <= rowSlot(row) && rowsGrouped(row + 1));
+}
+
+static constexpr bool rowsReachable(size_t row = 0) {
+    return row + 1 >= kTransitionCount
+        || (!(kTransitions[row].guard == nullptr && rowSlot(row) == rowSlot(row + 1)) && rowsReachable(row + 1));
+}
+
+static constexpr bool rowsLegal(size_t row = 0) {
+    return row >= kTransitionCount
+        || (isLegalTransition(kTransitions[row].from, kTransitions[row].to) && rowsLegal(row + 1));
+}
+
+static_assert(kTransitionCount < 255, "Row index is 8 bits");
+static_assert(sizeof(kEntryActions) / sizeof(kEntryActions[0]) == kStateCount, "One entry action slot per state");
+static_assert(sizeof(kStateNames) / sizeof(kStateNames[0]) == kStateCount, "One name per state");
+static_assert(rowsGrouped(), "Transition rows must be ordered by state, then event");
+static_assert(rowsReachable(), "An unguarded row hides the rows after it");
+static_assert(rowsLegal(), "Illegal transition in table (Surfing only from Idle, Config only from Init, no self-entry)");
+
+/**
+ * @brief First row at or after a (state, event) slot
+ */
+static constexpr uint8_t firstRow(uint8_t slot, size_t row = 0) {
+    return (row >= kTransitionCount || rowSlot(row) >= slot) ? static_cast<uint8_t>(row) : firstRow(slot, row + 1);
+}
+
+#define MOA_FIRST_ROWS(s) \
+    firstRow((s) * 6 + 0), firstRow((s) * 6 + 1), firstRow((s) * 6 + 2), \
+    firstRow((s) * 6 + 3), firstRow((s) * 6 + 4), firstRow((s) * 6 + 5)
+
+/**
+ * @brief Rows of slot k are kFirstRow[k] .. kFirstRow[k + 1] - 1
+ */
+static constexpr uint8_t kFirstRow[] = {
+    MOA_FIRST_ROWS(0), MOA_FIRST_ROWS(1), MOA_FIRST_ROWS(2), MOA_FIRST_ROWS(3),
+    MOA_FIRST_ROWS(4), MOA_FIRST_ROWS(5), MOA_FIRST_ROWS(6),
+    firstRow(kStateCount * 6)
+};
+
+static_assert(kEventCount == 6, "MOA_FIRST_ROWS expands six events per state");
+static_assert(sizeof(kFirstRow) == kStateCount * kEventCount + 1, "Index covers every (state, event) slot");
+
+// =============================================================================
+// Engine
+// =============================================================================
+
+MoaStateTable::MoaStateTable(IMoaActions& actions)
+    : _actions(actions)
+    , _state(MoaStateId::INIT)
+{
+    ESP_LOGI(TAG, "State table initialized (%u transitions), starting in Init", (unsigned)kTransitionCount);
+}
+
+void MoaStateTable::start() {
+    enter(MoaStateId::INIT);
+}
+
+bool MoaStateTable::dispatch(MoaEventId event, const ControlCommand& command) {
+    if (event >= MoaEventId::COUNT) {
+        return false;
+    }
+
+    uint8_t slot = slotOf(_state, event);
+    for (uint8_t row = kFirstRow[slot]; row < kFirstRow[slot + 1]; row++) {
+        const MoaTransition& t = kTransitions[row];
+        if (t.guard != nullptr && !t.guard(command)) {
+            continue;
+        }
+        if (t.action != nullptr) {
+            t.action(_actions, command);
+        }
+        if (t.to != MoaStateId::NONE) {
+            enter(t.to);
+        }
+        return true;
+    }
+
+    ESP_LOGD(TAG, "%s: event %u ignored (cmdType=%d, payload=%u)",
+        getStateName(_state), (unsigned)event, command.commandType, (unsigned)command.payload);
+    return false;
+}
+
+void MoaStateTable::buttonClick(ButtonEvent command) {
+    dispatch(MoaEventId::BUTTON, command);
+}
+
+void MoaStateTable::overcurrentDetected(CurrentEvent command) {
+    dispatch(MoaEventId::CURRENT, command);
+}
+
+void MoaStateTable::temperatureCrossedLimit(TempEvent command) {
+    dispatch(MoaEventId::TEMPERATURE, command);
+}
+
+void MoaStateTable::batteryLevelCrossedLimit(BattEvent command) {
+    dispatch(MoaEventId::BATTERY, command);
+}
+
+void MoaStateTable::timerExpired(TimerEvent command) {
+    dispatch(MoaEventId::TIMER, command);
+}
+
+void MoaStateTable::remoteCommand(RemoteEvent command) {
+    dispatch(MoaEventId::REMOTE, command);
+}
+
+MoaStateId MoaStateTable::getState() const {
+    return _state;
+}
+
+const char* MoaStateTable::getStateName(MoaStateId state) {
+    return (state < MoaStateId::COUNT) ? kStateNames[static_cast<uint8_t>(state)] : "Unknown";
+}
+
+size_t MoaStateTable::getTransitionCount() {
+    return kTransitionCount;
+}
+
+void MoaStateTable::enter(MoaStateId state) {
+    ESP_LOGI(TAG, "State transition -> %s", getStateName(state));
+    _state = state;
+    MoaEntryFn entry = kEntryActions[static_cast<uint8_t>(state)];
+    if (entry != nullptr) {
+        entry(_actions);
+    }
+}
@@ -1,10 +1,9 @@
-#include "Arduino.h"
 #include "OverCurrentState.h"
 #include "esp_log.h"
 
 static const char* TAG = "OverCurrState";
 
-OverCurrentState::OverCurrentState(MoaStateMachine& moaMachine, MoaDevicesManager& devices) : MoaState(devices), _moaMachine(moaMachine){
+OverCurrentState::OverCurrentState(MoaStateMachine& moaMachine, IMoaActions& devices) : MoaState(devices), _moaMachine(moaMachine){
 }
 
 void OverCurrentState::onEnter() {
@@ -14,18 +13,18 @@ void OverCurrentState::onEnter() {
     _devices.refreshLedIndicators();
 }
 
-void OverCurrentState::buttonClick(ControlCommand command) {
-    ESP_LOGD(TAG, "buttonClick (cmdType=%d, val=%d)", command.commandType, command.value);
-    if (command.commandType == COMMAND_BUTTON_STOP && command.value == BUTTON_EVENT_LONG_PRESS) {
+void OverCurrentState::buttonClick(ButtonEvent command) {
+    ESP_LOGD(TAG, "buttonClick (cmdType=%d, val=%d)", command.getButtonId(), command.getEventType());
+    if (command.getButtonId() == COMMAND_BUTTON_STOP && command.getEventType() == BUTTON_EVENT_LONG_PRESS) {
         ESP_LOGI(TAG, "Locking board - going to Init State");
         _devices.stopMotor();
         _moaMachine.setState(_moaMachine.getInitState());
     }
 }
 
-void OverCurrentState::overcurrentDetected(ControlCommand command) {
-    ESP_LOGD(TAG, "overcurrentDetected (cmdType=%d, val=%d)", command.commandType, command.value);
-    switch(command.commandType){
+void OverCurrentState::overcurrentDetected(CurrentEvent command) {
+    ESP_LOGD(TAG, "overcurrentDetected (cmdType=%d, val=%d)", command.getCommand(), command.getDeciAmps());
+    switch(command.getCommand()){
         case COMMAND_CURRENT_NORMAL:
             _devices.disengageThrottle();
             _moaMachine.setState(_moaMachine.getIdleState());
@@ -33,9 +32,9 @@ void OverCurrentState::overcurrentDetected(ControlCommand command) {
     }
 }
 
-void OverCurrentState::temperatureCrossedLimit(ControlCommand command) {
-    ESP_LOGD(TAG, "temperatureCrossedLimit (cmdType=%d, val=%d)", command.commandType, command.value);
-    switch(command.commandType){
+void OverCurrentState::temperatureCrossedLimit(TempEvent command) {
+    ESP_LOGD(TAG, "temperatureCrossedLimit (cmdType=%d, val=%d)", command.getCommand(), command.getDeciCelsius());
+    switch(command.getCommand()){
         case COMMAND_TEMP_CROSSED_ABOVE:
             ESP_LOGI(TAG, "Temperature high - going to OverHeating State");
             _devices.stopMotor();
@@ -44,9 +43,9 @@ void OverCurrentState::temperatureCrossedLimit(ControlCommand command) {
     }
 }
 
-void OverCurrentState::batteryLevelCrossedLimit(ControlCommand command) {
-    ESP_LOGD(TAG, "batteryLevelCrossedLimit (cmdType=%d, val=%d)", command.commandType, command.value);
-    switch(command.commandType){
+void OverCurrentState::batteryLevelCrossedLimit(BattEvent command) {
+    ESP_LOGD(TAG, "batteryLevelCrossedLimit (cmdType=%d, val=%d)", command.getLevel(), command.getMillivolts());
+    switch(command.getLevel()){
         case COMMAND_BATT_LEVEL_LOW:
             ESP_LOGI(TAG, "Battery low - going to BatteryLow State");
             _devices.stopMotor();
@@ -55,6 +54,15 @@ void OverCurrentState::batteryLevelCrossedLimit(ControlCommand command) {
     }
 }
 
-void OverCurrentState::timerExpired(ControlCommand command) {
-    ESP_LOGD(TAG, "timerExpired (cmdType=%d, val=%d)", command.commandType, command.value);
+void OverCurrentState::timerExpired(TimerEvent command) {
+    ESP_LOGD(TAG, "timerExpired (timerId=%d)", command.getTimerId());
+}
+
+void OverCurrentState::remoteCommand(RemoteEvent command) {
+    ESP_LOGD(TAG, "remoteCommand (cmdType=%d, duty=%d)", command.getCommand(), command.getDuty());
+    if (command.getCommand() == COMMAND_REMOTE_DISARM) {
+        ESP_LOGI(TAG, "Remote disarm - going to Init State");
+        _devices.stopMotor();
+        _moaMachine.setState(_moaMachine.getInitState());
+    }
 }
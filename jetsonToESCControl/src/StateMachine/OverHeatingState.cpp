@@ -1,10 +1,9 @@
-#include "Arduino.h"
 #include "OverHeatingState.h"
 #include "esp_log.h"
 
 static const char* TAG = "OverHeatState";
 
-OverHeatingState::OverHeatingState(MoaStateMachine& moaMachine, MoaDevicesManager& devices) : MoaState(devices), _moaMachine(moaMachine){
+OverHeatingState::OverHeatingState(MoaStateMachine& moaMachine, IMoaActions& devices) : MoaState(devices), _moaMachine(moaMachine){
 }
 
 void OverHeatingState::onEnter() {
@@ -14,18 +13,18 @@ void OverHeatingState::onEnter() {
     _devices.refreshLedIndicators();
 }
 
-void OverHeatingState::buttonClick(ControlCommand command) {
-    ESP_LOGD(TAG, "buttonClick (cmdType=%d, val=%d)", command.commandType, command.value);
-    if (command.commandType == COMMAND_BUTTON_STOP && command.value == BUTTON_EVENT_LONG_PRESS) {
+void OverHeatingState::buttonClick(ButtonEvent command) {
+    ESP_LOGD(TAG, "buttonClick (cmdType=%d, val=%d)", command.getButtonId(), command.getEventType());
+    if (command.getButtonId() == COMMAND_BUTTON_STOP && command.getEventType() == BUTTON_EVENT_LONG_PRESS) {
         ESP_LOGI(TAG, "Locking board - going to Init State");
         _devices.stopMotor();
         _moaMachine.setState(_moaMachine.getInitState());
     }
 }
 
-void OverHeatingState::overcurrentDetected(ControlCommand command) {
-    ESP_LOGD(TAG, "overcurrentDetected (cmdType=%d, val=%d)", command.commandType, command.value);
-    switch(command.commandType){
+void OverHeatingState::overcurrentDetected(CurrentEvent command) {
+    ESP_LOGD(TAG, "overcurrentDetected (cmdType=%d, val=%d)", command.getCommand(), command.getDeciAmps());
+    switch(command.getCommand()){
         case COMMAND_CURRENT_OVERCURRENT:
             ESP_LOGI(TAG, "Overcurrent detected - going to OverCurrent State");
             _devices.stopMotor();
@@ -34,9 +33,9 @@ void OverHeatingState::overcurrentDetected(ControlCommand command) {
     }
 }
 
-void OverHeatingState::temperatureCrossedLimit(ControlCommand command) {
-    ESP_LOGD(TAG, "temperatureCrossedLimit (cmdType=%d, val=%d)", command.commandType, command.value);
-    switch(command.commandType){
+void OverHeatingState::temperatureCrossedLimit(TempEvent command) {
+    ESP_LOGD(TAG, "temperatureCrossedLimit (cmdType=%d, val=%d)", command.getCommand(), command.getDeciCelsius());
+    switch(command.getCommand()){
         case COMMAND_TEMP_CROSSED_BELOW:
             _devices.stopMotor();
             _moaMachine.setState(_moaMachine.getIdleState());
@@ -44,9 +43,9 @@ void OverHeatingState::temperatureCrossedLimit(ControlCommand command) {
     }
 }
 
-void OverHeatingState::batteryLevelCrossedLimit(ControlCommand command) {
-    ESP_LOGD(TAG, "batteryLevelCrossedLimit (cmdType=%d, val=%d)", command.commandType, command.value);
-    switch(command.commandType){
+void OverHeatingState::batteryLevelCrossedLimit(BattEvent command) {
+    ESP_LOGD(TAG, "batteryLevelCrossedLimit (cmdType=%d, val=%d)", command.getLevel(), command.getMillivolts());
+    switch(command.getLevel()){
         case COMMAND_BATT_LEVEL_LOW:
             ESP_LOGI(TAG, "Battery low - going to BatteryLow State");
             _devices.stopMotor();
@@ -55,6 +54,15 @@ void OverHeatingState::batteryLevelCrossedLimit(ControlCommand command) {
     }
 }
 
-void OverHeatingState::timerExpired(ControlCommand command) {
-    ESP_LOGD(TAG, "timerExpired (cmdType=%d, val=%d)", command.commandType, command.value);
+void OverHeatingState::timerExpired(TimerEvent command) {
+    ESP_LOGD(TAG, "timerExpired (timerId=%d)", command.getTimerId());
+}
+
+void OverHeatingState::remoteCommand(RemoteEvent command) {
+    ESP_LOGD(TAG, "remoteCommand (cmdType=%d, duty=%d)", command.getCommand(), command.getDuty());
+    if (command.getCommand() == COMMAND_REMOTE_DISARM) {
+        ESP_LOGI(TAG, "Remote disarm - going to Init State");
+        _devices.stopMotor();
+        _moaMachine.setState(_moaMachine.getInitState());
+    }
 }
@@ -1,33 +1,32 @@
-#include "Arduino.h"
 #include "SurfingState.h"
 #include "Constants.h"
 #include "esp_log.h"
 
 static const char* TAG = "SurfingState";
 
-SurfingState::SurfingState(MoaStateMachine& moaMachine, MoaDevicesManager& devices) : MoaState(devices), _moaMachine(moaMachine){
+SurfingState::SurfingState(MoaStateMachine& moaMachine, IMoaActions& devices) : MoaState(devices), _moaMachine(moaMachine){
 }
 
 void SurfingState::onEnter() {
     ESP_LOGI(TAG, "Entering Surfing State");
 }
 
-void SurfingState::buttonClick(ControlCommand command) {
-    ESP_LOGD(TAG, "buttonClick (cmdType=%d, val=%d)", command.commandType, command.value);
-    if (command.value != BUTTON_EVENT_PRESS) {
+void SurfingState::buttonClick(ButtonEvent command) {
+    ESP_LOGD(TAG, "buttonClick (cmdType=%d, val=%d)", command.getButtonId(), command.getEventType());
+    if (command.getEventType() != BUTTON_EVENT_PRESS) {
         return;
     }
-    if (command.commandType != COMMAND_BUTTON_STOP) {
-        _devices.engageThrottle(command.commandType);
+    if (command.getButtonId() != COMMAND_BUTTON_STOP) {
+        _devices.engageThrottle(command.getButtonId());
     } else {
         _devices.disengageThrottle();
         _moaMachine.setState(_moaMachine.getIdleState());
     }
 }
 
-void SurfingState::overcurrentDetected(ControlCommand command) {
-    ESP_LOGD(TAG, "overcurrentDetected (cmdType=%d, val=%d)", command.commandType, command.value);
-    switch(command.commandType){
+void SurfingState::overcurrentDetected(CurrentEvent command) {
+    ESP_LOGD(TAG, "overcurrentDetected (cmdType=%d, val=%d)", command.getCommand(), command.getDeciAmps());
+    switch(command.getCommand()){
         case COMMAND_CURRENT_OVERCURRENT:
             _devices.disengageThrottle();
             _moaMachine.setState(_moaMachine.getOverCurrentState());
@@ -35,9 +34,9 @@ void SurfingState::overcurrentDetected(ControlCommand command) {
     }
 }
 
-void SurfingState::temperatureCrossedLimit(ControlCommand command) {
-    ESP_LOGD(TAG, "temperatureCrossedLimit (cmdType=%d, val=%d)", command.commandType, command.value);
-    switch(command.commandType){
+void SurfingState::temperatureCrossedLimit(TempEvent command) {
+    ESP_LOGD(TAG, "temperatureCrossedLimit (cmdType=%d, val=%d)", command.getCommand(), command.getDeciCelsius());
+    switch(command.getCommand()){
         case COMMAND_TEMP_CROSSED_ABOVE:
             ESP_LOGI(TAG, "Temperature high - going to Over Heating State");
             _devices.disengageThrottle();
@@ -46,9 +45,9 @@ void SurfingState::temperatureCrossedLimit(ControlCommand command) {
     }
 }
 
-void SurfingState::batteryLevelCrossedLimit(ControlCommand command) {
-    ESP_LOGD(TAG, "batteryLevelCrossedLimit (cmdType=%d, val=%d)", command.commandType, command.value);
-    switch(command.commandType){
+void SurfingState::batteryLevelCrossedLimit(BattEvent command) {
+    ESP_LOGD(TAG, "batteryLevelCrossedLimit (cmdType=%d, val=%d)", command.getLevel(), command.getMillivolts());
+    switch(command.getLevel()){
         case COMMAND_BATT_LEVEL_STOP:
             ESP_LOGI(TAG, "Battery level critical while surfing (no forced stop)");
             break;
@@ -58,14 +57,28 @@ void SurfingState::batteryLevelCrossedLimit(ControlCommand command) {
     }
 }
 
-void SurfingState::timerExpired(ControlCommand command) {
-    ESP_LOGI(TAG, "timerExpired (cmdType=%d, val=%d)", command.commandType, command.value);
-    if (command.commandType == TIMER_ID_THROTTLE) {
+void SurfingState::timerExpired(TimerEvent command) {
+    ESP_LOGI(TAG, "timerExpired (timerId=%d)", command.getTimerId());
+    if (command.getTimerId() == TIMER_ID_THROTTLE) {
         ESP_LOGI(TAG, "Throttle timeout - stopping motor");
         _devices.disengageThrottle();
         _moaMachine.setState(_moaMachine.getIdleState());
-    } else if (command.commandType == TIMER_ID_FULL_THROTTLE) {
+    } else if (command.getTimerId() == TIMER_ID_FULL_THROTTLE) {
         ESP_LOGI(TAG, "Full throttle step-down");
         _devices.handleThrottleStepDown();
     }
 }
+
+void SurfingState::remoteCommand(RemoteEvent command) {
+    ESP_LOGD(TAG, "remoteCommand (cmdType=%d, duty=%d)", command.getCommand(), command.getDuty());
+    if (command.getCommand() == COMMAND_REMOTE_THROTTLE && command.getDuty() > 0) {
+        _devices.setRemoteThrottle(command.getDuty());
+    } else if (command.getCommand() == COMMAND_REMOTE_THROTTLE) {
+        _devices.disengageThrottle();
+        _moaMachine.setState(_moaMachine.getIdleState());
+    } else if (command.getCommand() == COMMAND_REMOTE_DISARM) {
+        ESP_LOGI(TAG, "Remote disarm - going to Init State");
+        _devices.disengageThrottle();
+        _moaMachine.setState(_moaMachine.getInitState());
+    }
+}
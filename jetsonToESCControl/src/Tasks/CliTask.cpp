@@ -11,12 +11,6 @@
 
 static const char* TAG = "CliTask";
 
-/**
- * @brief CLI polling period (ms)
- * Low frequency is fine — human typing speed is the bottleneck.
- */
-#define TASK_CLI_PERIOD_MS 50
-
 void CliTask(void* pvParameters) {
     MoaMainUnit* unit = static_cast<MoaMainUnit*>(pvParameters);
 
@@ -25,7 +19,9 @@ void CliTask(void* pvParameters) {
     unit->getUartCli().begin();
 
     for (;;) {
+        unit->getTaskProfiler().loopStart(MOA_PERF_CLI, micros());
         unit->getUartCli().poll();
+        unit->getTaskProfiler().loopEnd(MOA_PERF_CLI, micros());
         vTaskDelay(pdMS_TO_TICKS(TASK_CLI_PERIOD_MS));
     }
 }
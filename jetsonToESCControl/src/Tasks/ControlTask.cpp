@@ -8,6 +8,7 @@
 #include "Tasks.h"
 #include "MoaMainUnit.h"
 #include "esp_log.h"
+#include "MoaLatencyTrace.h"
 
 static const char* TAG = "ControlTask";
 
@@ -18,11 +19,17 @@ void ControlTask(void* pvParameters) {
     ESP_LOGI(TAG, "ControlTask started");
     
     for (;;) {
-        // Block until an event arrives in the queue
-        if (xQueueReceive(unit->getEventQueue(), &cmd, portMAX_DELAY) == pdTRUE) {
-            ESP_LOGD(TAG, "Event received: controlType=%d, commandType=%d, value=%d", cmd.controlType, cmd.commandType, cmd.value);
+        // Block until an event arrives (safety events first)
+        if (unit->getEventChannel().receive(cmd, portMAX_DELAY)) {
+            unit->getTaskProfiler().loopStart(MOA_PERF_CONTROL, micros());
+            MOA_LATENCY_MARK(MOA_HOP_RECEIVE);
+            ESP_LOGD(TAG, "Event received: controlType=%d, commandType=%d, payload=%u", cmd.controlType, cmd.commandType, (unsigned)cmd.payload);
             // Route event to state machine wrapper
             unit->getStateMachine().handleEvent(cmd);
+
+            // The event left the throttle alone, or stopped the ESC directly
+            MOA_LATENCY_RELEASE(MOA_HOP_ANY, MOA_HOP_SET_DUTY);
+            unit->getTaskProfiler().loopEnd(MOA_PERF_CONTROL, micros());
         }
     }
 }
@@ -23,6 +23,8 @@ void IOTask(void* pvParameters) {
     ESP_LOGI(TAG, "IOTask started");
     
     for (;;) {
+        unit->getTaskProfiler().loopStart(MOA_PERF_IO, micros());
+
         // Process button interrupt if pending
         // This reads INTCAPA, handles debounce, and clears MCP interrupt
         if (unit->getButtonControl().isInterruptPending()) {
@@ -33,12 +35,10 @@ void IOTask(void* pvParameters) {
         // This updates button hold times and fires long-press events
         unit->getButtonControl().checkLongPress();
         
-        // Tick ESC ramp (smooth throttle transitions)
-        unit->getDevicesManager().updateESC();
-        
         // Update LED output (drives blink timing)
         unit->getLedControl().update();
-        
+
+        unit->getTaskProfiler().loopEnd(MOA_PERF_IO, micros());
         vTaskDelay(pdMS_TO_TICKS(TASK_IO_PERIOD_MS));
     }
 }
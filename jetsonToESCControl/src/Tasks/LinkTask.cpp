@@ -0,0 +1,30 @@
+/**
+ * @file LinkTask.cpp
+ * @brief FreeRTOS task for the Jetson link
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "Tasks.h"
+#include "MoaMainUnit.h"
+#include "esp_log.h"
+
+static const char* TAG = "LinkTask";
+
+void LinkTask(void* pvParameters) {
+    MoaMainUnit* unit = static_cast<MoaMainUnit*>(pvParameters);
+    MoaJetsonLink& link = unit->getJetsonLink();
+    uart_event_t event;
+
+    ESP_LOGI(TAG, "LinkTask started");
+    link.begin();
+
+    for (;;) {
+        // Block until the UART driver reports a received burst (line idle)
+        if (link.waitEvent(event, portMAX_DELAY)) {
+            unit->getTaskProfiler().loopStart(MOA_PERF_LINK, micros());
+            link.handleEvent(event);
+            unit->getTaskProfiler().loopEnd(MOA_PERF_LINK, micros());
+        }
+    }
+}
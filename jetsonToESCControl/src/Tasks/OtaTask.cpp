@@ -11,12 +11,6 @@
 
 static const char* TAG = "OtaTask";
 
-/**
- * @brief OTA polling period (ms)
- * Needs to be responsive for OTA discovery and transfer.
- */
-#define TASK_OTA_PERIOD_MS 50
-
 void OtaTask(void* pvParameters) {
     MoaMainUnit* unit = static_cast<MoaMainUnit*>(pvParameters);
 
@@ -24,7 +18,9 @@ void OtaTask(void* pvParameters) {
     // OTA lifecycle controlled by ConfigState - no begin() here
 
     for (;;) {
+        unit->getTaskProfiler().loopStart(MOA_PERF_OTA, micros());
         unit->getOTAManager().handle();
+        unit->getTaskProfiler().loopEnd(MOA_PERF_OTA, micros());
         vTaskDelay(pdMS_TO_TICKS(TASK_OTA_PERIOD_MS));
     }
 }
@@ -0,0 +1,38 @@
+/**
+ * @file ProtectionTask.cpp
+ * @brief FreeRTOS task for continuous ADC draining and fast overcurrent trip
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Drains the DMA ADC every TASK_PROTECTION_PERIOD_MS. While draining,
+ * MoaAdcSampler feeds every raw current conversion to the fast trip
+ * comparator, whose handler cuts the ESC directly - the event queue and
+ * ControlTask are only told afterwards. Decimated blocks are left for
+ * SensorTask to consume at its own pace.
+ */
+
+#include "Tasks.h"
+#include "MoaMainUnit.h"
+#include "esp_log.h"
+#include "MoaLatencyTrace.h"
+
+static const char* TAG = "ProtectionTask";
+
+void ProtectionTask(void* pvParameters) {
+    MoaMainUnit* unit = static_cast<MoaMainUnit*>(pvParameters);
+    TickType_t lastWake = xTaskGetTickCount();
+
+    ESP_LOGI(TAG, "ProtectionTask started");
+
+    for (;;) {
+        unit->getTaskProfiler().loopStart(MOA_PERF_PROTECTION, micros());
+
+        // No-op in one-shot mode (sampler not running)
+        MOA_LATENCY_BEGIN(MOA_HOP_ADC_DRAIN);
+        unit->getAdcSampler().poll();
+        MOA_LATENCY_RELEASE(MOA_HOP_ADC_DRAIN, MOA_HOP_PWM);    // Traced only when it tripped
+        unit->getTaskProfiler().loopEnd(MOA_PERF_PROTECTION, micros());
+
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(TASK_PROTECTION_PERIOD_MS));
+    }
+}
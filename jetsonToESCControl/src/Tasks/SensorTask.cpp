@@ -8,6 +8,7 @@
 #include "Tasks.h"
 #include "MoaMainUnit.h"
 #include "esp_log.h"
+#include "MoaLatencyTrace.h"
 
 static const char* TAG = "SensorTask";
 
@@ -17,12 +18,21 @@ void SensorTask(void* pvParameters) {
     ESP_LOGI(TAG, "SensorTask started");
     
     for (;;) {
+        unit->getTaskProfiler().loopStart(MOA_PERF_SENSOR, micros());
+        MOA_LATENCY_BEGIN(MOA_HOP_SENSOR_SAMPLE);
+
         // Update all sensor producers
         // Each will push events to the queue if thresholds are crossed
+        // Current first: the battery levels are load-compensated with it
         unit->getTempControl().update();
-        unit->getBattControl().update();
         unit->getCurrentControl().update();
-        
+        unit->getBattControl().setLoadCurrent(unit->getCurrentControl().getCurrentMa());
+        unit->getBattControl().update();
+
+        // Traced only when a threshold crossing was queued
+        MOA_LATENCY_RELEASE(MOA_HOP_SENSOR_SAMPLE, MOA_HOP_PUSH);
+
+        unit->getTaskProfiler().loopEnd(MOA_PERF_SENSOR, micros());
         vTaskDelay(pdMS_TO_TICKS(TASK_SENSOR_PERIOD_MS));
     }
 }
@@ -21,9 +21,22 @@ void StatsTask(void* pvParameters) {
     for (;;) {
         // Block until a stats reading arrives in the queue
         if (xQueueReceive(unit->getStatsQueue(), &reading, portMAX_DELAY) == pdTRUE) {
+            unit->getTaskProfiler().loopStart(MOA_PERF_STATS, micros());
             ESP_LOGV(TAG, "Stats reading: type=%d, value=%ld, ts=%lu", reading.statsType, reading.value, reading.timestamp);
             // Update the stats aggregator
-            unit->getStatsAggregator().update(reading);
+            MoaStatsAggregator& stats = unit->getStatsAggregator();
+            stats.update(reading);
+            // Rate-limited NVS write of the lifetime energy totals
+            if (stats.isEnergySaveDue(reading.timestamp)) {
+                MoaEnergyReport energy = stats.getEnergy();
+                unit->getConfig().saveEnergy(energy.lifetimeMah, energy.lifetimeMwh);
+                stats.markEnergySaved(reading.timestamp);
+            }
+            // Batch for the telemetry stream; never waits on the sender
+            if (unit->getTelemetryStream().offer(reading)) {
+                xSemaphoreGive(unit->getTelemetrySignal());
+            }
+            unit->getTaskProfiler().loopEnd(MOA_PERF_STATS, micros());
         }
     }
 }
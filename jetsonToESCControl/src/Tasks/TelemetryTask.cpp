@@ -0,0 +1,35 @@
+/**
+ * @file TelemetryTask.cpp
+ * @brief FreeRTOS task sending telemetry batches to the configured sink
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ */
+
+#include "Tasks.h"
+#include "MoaMainUnit.h"
+#include "esp_log.h"
+
+static const char* TAG = "TelemetryTask";
+
+void TelemetryTask(void* pvParameters) {
+    MoaMainUnit* unit = static_cast<MoaMainUnit*>(pvParameters);
+    MoaTelemetryStream& stream = unit->getTelemetryStream();
+    MoaTelemetryFrame frame;
+
+    ESP_LOGI(TAG, "TelemetryTask started");
+
+    for (;;) {
+        // Block until StatsTask seals a batch
+        if (xSemaphoreTake(unit->getTelemetrySignal(), portMAX_DELAY) == pdTRUE) {
+            unit->getTaskProfiler().loopStart(MOA_PERF_TELEMETRY, micros());
+            // Gives coalesce while we send: drain everything that is pending
+            IMoaTelemetrySink& sink = unit->getTelemetrySink();
+            while (stream.take(frame)) {
+                if (!sink.sendTelemetry(frame.payload, frame.length)) {
+                    stream.reportSinkError();
+                }
+            }
+            unit->getTaskProfiler().loopEnd(MOA_PERF_TELEMETRY, micros());
+        }
+    }
+}
@@ -0,0 +1,189 @@
+/**
+ * @file test_adc_sampler.cpp
+ * @brief Host tests for MoaAdcSampler block processing
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Drives MoaAdcSampler from SimulatedAdcSource to check demultiplexing,
+ * oversampling/decimation and overrun handling without hardware.
+ *
+ * Run with: pio test -e native -f native/test_adc_sampler
+ */
+
+#include <unity.h>
+#include <stdlib.h>
+#include "MoaAdcSampler.h"
+#include "SimulatedAdcSource.h"
+
+static const uint8_t PIN_CURRENT = 3;
+static const uint8_t PIN_BATT = 1;
+
+static SimulatedAdcSource* source;
+static MoaAdcSampler* sampler;
+
+static uint16_t rampWaveform(uint8_t pin, uint32_t index, void* context) {
+    (void)pin;
+    (void)context;
+    return static_cast<uint16_t>(index % 4096);
+}
+
+static uint16_t noisyWaveform(uint8_t pin, uint32_t index, void* context) {
+    (void)pin;
+    (void)index;
+    int base = *static_cast<int*>(context);
+    return static_cast<uint16_t>(base + (rand() % 201) - 100);  // +/-100 codes
+}
+
+void setUp(void) {
+    srand(42);
+    source = new SimulatedAdcSource();
+    sampler = new MoaAdcSampler(source);
+}
+
+void tearDown(void) {
+    delete sampler;
+    delete source;
+}
+
+void test_begin_requires_channels() {
+    TEST_ASSERT_FALSE(sampler->begin());
+    TEST_ASSERT_FALSE(sampler->isRunning());
+}
+
+void test_add_channel_rejected_while_running() {
+    TEST_ASSERT_EQUAL_INT8(0, sampler->addChannel(PIN_CURRENT));
+    TEST_ASSERT_TRUE(sampler->begin());
+    TEST_ASSERT_EQUAL_INT8(-1, sampler->addChannel(PIN_BATT));
+}
+
+void test_demultiplexes_channels() {
+    int8_t cur = sampler->addChannel(PIN_CURRENT);
+    int8_t bat = sampler->addChannel(PIN_BATT);
+    sampler->setOversampling(1);
+    source->setConstant(PIN_CURRENT, 2048);
+    source->setConstant(PIN_BATT, 3100);
+    TEST_ASSERT_TRUE(sampler->begin());
+
+    source->produce(20);
+    TEST_ASSERT_EQUAL(20, sampler->poll());
+
+    uint16_t block[MOA_ADC_BLOCK_CAPACITY];
+    size_t n = sampler->takeBlock(cur, block, MOA_ADC_BLOCK_CAPACITY);
+    TEST_ASSERT_EQUAL(10, n);
+    for (size_t i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL_UINT16(2048, block[i]);
+    }
+    n = sampler->takeBlock(bat, block, MOA_ADC_BLOCK_CAPACITY);
+    TEST_ASSERT_EQUAL(10, n);
+    TEST_ASSERT_EQUAL_UINT16(3100, block[0]);
+
+    // Block is consumed
+    TEST_ASSERT_EQUAL(0, sampler->takeBlock(cur, block, MOA_ADC_BLOCK_CAPACITY));
+}
+
+void test_decimation_averages_windows() {
+    int8_t cur = sampler->addChannel(PIN_CURRENT);
+    sampler->setOversampling(8);
+    source->setWaveform(PIN_CURRENT, rampWaveform);
+    TEST_ASSERT_TRUE(sampler->begin());
+
+    source->produce(8 * 4 + 3);  // 4 full windows + partial
+    sampler->poll();
+
+    uint16_t block[MOA_ADC_BLOCK_CAPACITY];
+    size_t n = sampler->takeBlock(cur, block, MOA_ADC_BLOCK_CAPACITY);
+    TEST_ASSERT_EQUAL(4, n);
+    // Window k holds 8k..8k+7 -> mean 8k+3.5, rounded to 8k+4
+    for (size_t k = 0; k < n; k++) {
+        TEST_ASSERT_EQUAL_UINT16(8 * k + 4, block[k]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(35, sampler->getRawSampleCount(cur));
+}
+
+void test_oversampling_reduces_noise() {
+    int base = 2500;
+    int8_t cur = sampler->addChannel(PIN_CURRENT);
+    sampler->setOversampling(16);
+    source->setWaveform(PIN_CURRENT, noisyWaveform, &base);
+    TEST_ASSERT_TRUE(sampler->begin());
+
+    source->produce(16 * MOA_ADC_BLOCK_CAPACITY);
+    sampler->poll();
+
+    uint16_t block[MOA_ADC_BLOCK_CAPACITY];
+    size_t n = sampler->takeBlock(cur, block, MOA_ADC_BLOCK_CAPACITY);
+    TEST_ASSERT_EQUAL(MOA_ADC_BLOCK_CAPACITY, n);
+    for (size_t i = 0; i < n; i++) {
+        // Raw noise is +/-100; 16x averaging keeps decimated samples well inside
+        TEST_ASSERT_INT_WITHIN(60, base, block[i]);
+    }
+}
+
+void test_overrun_keeps_newest_samples() {
+    int8_t cur = sampler->addChannel(PIN_CURRENT);
+    sampler->setOversampling(1);
+    source->setWaveform(PIN_CURRENT, rampWaveform);
+    TEST_ASSERT_TRUE(sampler->begin());
+
+    source->produce(MOA_ADC_BLOCK_CAPACITY + 10);
+    sampler->poll();
+
+    uint16_t block[MOA_ADC_BLOCK_CAPACITY];
+    size_t n = sampler->takeBlock(cur, block, MOA_ADC_BLOCK_CAPACITY);
+    TEST_ASSERT_EQUAL(MOA_ADC_BLOCK_CAPACITY, n);
+    TEST_ASSERT_EQUAL_UINT16(10, block[0]);
+    TEST_ASSERT_EQUAL_UINT16(MOA_ADC_BLOCK_CAPACITY + 9, block[n - 1]);
+    TEST_ASSERT_EQUAL_UINT32(10, sampler->getOverrunCount(cur));
+}
+
+void test_poll_drains_more_than_one_chunk() {
+    sampler->addChannel(PIN_CURRENT);
+    sampler->addChannel(PIN_BATT);
+    TEST_ASSERT_TRUE(sampler->begin());
+
+    source->produce(MOA_ADC_READ_CHUNK * 5 + 7);
+    TEST_ASSERT_EQUAL(MOA_ADC_READ_CHUNK * 5 + 7, sampler->poll());
+    TEST_ASSERT_EQUAL(0, sampler->poll());
+}
+
+void test_tick_rate_matches_configuration() {
+    int8_t cur = sampler->addChannel(PIN_CURRENT);
+    int8_t bat = sampler->addChannel(PIN_BATT);
+    sampler->setSampleRate(10000);
+    sampler->setOversampling(16);
+    source->setConstant(PIN_CURRENT, 2048);
+    source->setConstant(PIN_BATT, 3000);
+    TEST_ASSERT_TRUE(sampler->begin());
+
+    // One second of 50 ms SensorTask ticks
+    uint16_t block[MOA_ADC_BLOCK_CAPACITY];
+    size_t curTotal = 0;
+    size_t batTotal = 0;
+    for (int tick = 0; tick < 20; tick++) {
+        source->advance(50000);
+        sampler->poll();
+        curTotal += sampler->takeBlock(cur, block, MOA_ADC_BLOCK_CAPACITY);
+        batTotal += sampler->takeBlock(bat, block, MOA_ADC_BLOCK_CAPACITY);
+    }
+
+    // 10 kHz / 2 pins / 16 = 312.5 decimated samples per second per sensor
+    TEST_ASSERT_INT_WITHIN(1, 312, curTotal);
+    TEST_ASSERT_INT_WITHIN(1, 312, batTotal);
+    TEST_ASSERT_EQUAL_UINT32(0, sampler->getOverrunCount(cur));
+    TEST_ASSERT_EQUAL_UINT32(0, source->getOverflowCount());
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_begin_requires_channels);
+    RUN_TEST(test_add_channel_rejected_while_running);
+    RUN_TEST(test_demultiplexes_channels);
+    RUN_TEST(test_decimation_averages_windows);
+    RUN_TEST(test_oversampling_reduces_noise);
+    RUN_TEST(test_overrun_keeps_newest_samples);
+    RUN_TEST(test_poll_drains_more_than_one_chunk);
+    RUN_TEST(test_tick_rate_matches_configuration);
+
+    return UNITY_END();
+}
@@ -0,0 +1,234 @@
+/**
+ * @file test_batt_resistance.cpp
+ * @brief Host tests for the MoaBattResistance estimator
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Rides a synthetic pack (open-circuit voltage falling with the charge
+ * drawn, I x R sag, first-order motor current, optional sensor noise)
+ * through throttle steps at the 50 ms sensor tick and checks that the
+ * resistance is learned, that the inferred open-circuit voltage does not
+ * sag at full throttle, that slow ramps, long transients and glitches
+ * do not pull the estimate, and that the compensation waits for learned
+ * steps and is capped.
+ *
+ * Run with: pio test -e native -f native/test_batt_resistance
+ */
+
+#include <unity.h>
+#include "MoaBattResistance.h"
+
+static const uint32_t TICK_MS = 50;
+
+/**
+ * @brief Synthetic 6S 10 Ah pack behind the estimator
+ */
+struct SyntheticPack {
+    float ocvMv;            ///< Open-circuit voltage
+    float resistanceMohm;   ///< True internal resistance
+    float currentMa;        ///< Motor current (lags the demand)
+    float noiseMv;          ///< Peak voltage noise
+    float noiseMa;          ///< Peak current noise
+    uint32_t nowMs;
+    uint32_t seed;
+    int32_t lastMv;         ///< Last terminal reading fed
+    int32_t lastMa;         ///< Last current reading fed
+};
+
+static SyntheticPack pack;
+static MoaBattResistance* estimator;
+
+static float noise(float peak) {
+    pack.seed = pack.seed * 1664525UL + 1013904223UL;
+    return peak * ((static_cast<int32_t>(pack.seed >> 16) & 0xFFFF) / 32768.0f - 1.0f);
+}
+
+/**
+ * @brief One sensor tick towards demandA (tau 150 ms), fed to the estimator
+ * @return true if a step was regressed
+ */
+static bool tick(float demandA) {
+    pack.currentMa += (demandA * 1000.0f - pack.currentMa) * TICK_MS / 150.0f * 0.9f;
+    // 5.4 V over 10 Ah
+    pack.ocvMv -= pack.currentMa * TICK_MS / 3600000.0f * 0.54f;
+    pack.nowMs += TICK_MS;
+
+    float terminalMv = pack.ocvMv - pack.currentMa * pack.resistanceMohm / 1000.0f;
+    pack.lastMv = static_cast<int32_t>(terminalMv + noise(pack.noiseMv));
+    pack.lastMa = static_cast<int32_t>(pack.currentMa + noise(pack.noiseMa));
+    return estimator->update(pack.lastMv, pack.lastMa, pack.nowMs);
+}
+
+static uint32_t hold(float demandA, uint32_t ms) {
+    uint32_t steps = 0;
+    for (uint32_t t = 0; t < ms; t += TICK_MS) {
+        steps += tick(demandA) ? 1 : 0;
+    }
+    return steps;
+}
+
+/**
+ * @brief Idle, 25 %, idle, 100 %, 50 %, idle: five steps
+ */
+static uint32_t rideSteps() {
+    uint32_t steps = 0;
+    steps += hold(0.5f, 2000);
+    steps += hold(30.0f, 2000);
+    steps += hold(0.5f, 2000);
+    steps += hold(120.0f, 3000);
+    steps += hold(60.0f, 2000);
+    steps += hold(0.5f, 2000);
+    return steps;
+}
+
+void setUp(void) {
+    pack.ocvMv = 23500.0f;
+    pack.resistanceMohm = 30.0f;
+    pack.currentMa = 0.0f;
+    pack.noiseMv = 0.0f;
+    pack.noiseMa = 0.0f;
+    pack.nowMs = 0;
+    pack.seed = 12345;
+    estimator = new MoaBattResistance();
+}
+
+void tearDown(void) {
+    delete estimator;
+}
+
+void test_starts_at_the_initial_resistance() {
+    TEST_ASSERT_EQUAL_UINT32(BATT_RESISTANCE_MOHM, estimator->getResistanceMilliohm());
+    TEST_ASSERT_EQUAL_INT32(24000, estimator->openCircuitMv(24000, 0));
+    // Nothing learned yet: the configured 40 mOhm is not trusted
+    TEST_ASSERT_FALSE(estimator->isLearned());
+    TEST_ASSERT_EQUAL_INT32(24000, estimator->openCircuitMv(24000, 100000));
+}
+
+void test_compensation_waits_for_learned_steps() {
+    hold(0.5f, 2000);
+    hold(30.0f, 2000);
+    hold(0.5f, 2000);
+    TEST_ASSERT_EQUAL_UINT32(BATT_COMP_MIN_STEPS - 1, estimator->getStepCount());
+    TEST_ASSERT_EQUAL_INT32(24000, estimator->openCircuitMv(24000, 100000));
+
+    hold(60.0f, 2000);
+    TEST_ASSERT_TRUE(estimator->isLearned());
+    TEST_ASSERT_INT32_WITHIN(100, 24000 + 3000, estimator->openCircuitMv(24000, 100000));  // 100 A x ~30 mOhm
+}
+
+void test_added_voltage_is_capped() {
+    rideSteps();
+    TEST_ASSERT_TRUE(estimator->isLearned());
+
+    // A 300 A spike through 30 mOhm would add 9 V to an empty pack
+    TEST_ASSERT_EQUAL_INT32(18000 + BATT_COMP_MAX_SAG_MV, estimator->openCircuitMv(18000, 300000));
+    TEST_ASSERT_EQUAL_INT32(26000 - BATT_COMP_MAX_SAG_MV, estimator->openCircuitMv(26000, -300000));
+
+    estimator->setMaxSag(1000);
+    TEST_ASSERT_EQUAL_UINT32(1000, estimator->getMaxSag());
+    TEST_ASSERT_EQUAL_INT32(19000, estimator->openCircuitMv(18000, 300000));
+}
+
+void test_steady_throttle_is_not_a_step() {
+    TEST_ASSERT_EQUAL_UINT32(0, hold(40.0f, 60000));
+    TEST_ASSERT_EQUAL_UINT32(0, estimator->getStepCount());
+    TEST_ASSERT_EQUAL_UINT32(BATT_RESISTANCE_MOHM, estimator->getResistanceMilliohm());
+}
+
+void test_learns_the_resistance_from_throttle_steps() {
+    TEST_ASSERT_EQUAL_UINT32(5, rideSteps());
+    TEST_ASSERT_UINT32_WITHIN(1, 30, estimator->getResistanceMilliohm());
+
+    pack.resistanceMohm = 60.0f;                        // Cold pack
+    for (int i = 0; i < 4; i++) {
+        rideSteps();
+    }
+    TEST_ASSERT_UINT32_WITHIN(2, 60, estimator->getResistanceMilliohm());
+    TEST_ASSERT_EQUAL_UINT32(25, estimator->getStepCount());
+}
+
+void test_open_circuit_voltage_does_not_sag_at_full_throttle() {
+    rideSteps();
+    hold(120.0f, 3000);
+
+    // Terminal reads 3.6 V below the open-circuit voltage
+    TEST_ASSERT_TRUE(pack.ocvMv - pack.lastMv > 3500);
+    TEST_ASSERT_INT32_WITHIN(100, static_cast<int32_t>(pack.ocvMv),
+                             estimator->openCircuitMv(pack.lastMv, pack.lastMa));
+}
+
+void test_noisy_sensors_still_converge() {
+    pack.noiseMv = 40.0f;                               // ADC noise after averaging
+    pack.noiseMa = 800.0f;
+    for (int i = 0; i < 4; i++) {
+        rideSteps();
+    }
+    TEST_ASSERT_TRUE(estimator->getStepCount() >= 15);
+    TEST_ASSERT_UINT32_WITHIN(3, 30, estimator->getResistanceMilliohm());
+}
+
+void test_slow_ramp_is_not_a_step() {
+    hold(0.5f, 2000);
+    for (int a = 1; a <= 100; a++) {                    // 1 A per 100 ms: steady, the reference follows
+        hold(static_cast<float>(a), 100);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, estimator->getStepCount());
+}
+
+void test_step_after_a_long_transient_is_ignored() {
+    hold(0.5f, 2000);
+    for (int i = 0; i < 120; i++) {                     // 6 s of pumping the throttle
+        hold((i & 1) ? 20.0f : 5.0f, TICK_MS);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, hold(60.0f, 2000));     // Too far from the last steady point
+    TEST_ASSERT_EQUAL_UINT32(1, hold(0.5f, 2000));      // The next one counts again
+}
+
+void test_implausible_step_is_rejected() {
+    hold(0.5f, 2000);
+    pack.ocvMv += 2000.0f;                              // Charger plugged in under the step
+    hold(30.0f, 2000);
+    TEST_ASSERT_EQUAL_UINT32(0, estimator->getStepCount());
+    TEST_ASSERT_EQUAL_UINT32(1, estimator->getRejectedCount());
+    TEST_ASSERT_EQUAL_UINT32(BATT_RESISTANCE_MOHM, estimator->getResistanceMilliohm());
+}
+
+void test_drain_during_a_ride_does_not_bias_the_estimate() {
+    for (int i = 0; i < 15; i++) {                      // ~6 min, about half the pack
+        rideSteps();
+        hold(80.0f, 10000);
+    }
+    TEST_ASSERT_TRUE(pack.ocvMv < 21500.0f);
+    TEST_ASSERT_UINT32_WITHIN(2, 30, estimator->getResistanceMilliohm());
+}
+
+void test_initial_resistance_is_clamped_and_restarts() {
+    rideSteps();
+    estimator->setInitialResistance(5000);
+    tick(0.5f);                                         // Taken on the owner's next update
+    TEST_ASSERT_EQUAL_UINT32(BATT_RESISTANCE_MAX_MOHM, estimator->getResistanceMilliohm());
+    TEST_ASSERT_EQUAL_UINT32(0, estimator->getStepCount());
+
+    estimator->setInitialResistance(0);
+    tick(0.5f);
+    TEST_ASSERT_EQUAL_UINT32(BATT_RESISTANCE_MIN_MOHM, estimator->getResistanceMilliohm());
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_starts_at_the_initial_resistance);
+    RUN_TEST(test_compensation_waits_for_learned_steps);
+    RUN_TEST(test_added_voltage_is_capped);
+    RUN_TEST(test_steady_throttle_is_not_a_step);
+    RUN_TEST(test_learns_the_resistance_from_throttle_steps);
+    RUN_TEST(test_open_circuit_voltage_does_not_sag_at_full_throttle);
+    RUN_TEST(test_noisy_sensors_still_converge);
+    RUN_TEST(test_slow_ramp_is_not_a_step);
+    RUN_TEST(test_step_after_a_long_transient_is_ignored);
+    RUN_TEST(test_implausible_step_is_rejected);
+    RUN_TEST(test_drain_during_a_ride_does_not_bias_the_estimate);
+    RUN_TEST(test_initial_resistance_is_clamped_and_restarts);
+
+    return UNITY_END();
+}
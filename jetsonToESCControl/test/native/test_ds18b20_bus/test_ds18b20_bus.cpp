@@ -0,0 +1,364 @@
+/**
+ * @file test_ds18b20_bus.cpp
+ * @brief Host tests for the MoaDs18b20Bus probe manager
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Runs the manager against SimulatedDs18b20Bus at the 50 ms SensorTask
+ * tick: one search at begin(), roles bound by ROM code (not by search
+ * order), the single-probe fallback on an unconfigured bus only, missing
+ * probes, per-probe resolution, staggered and broadcast conversions never
+ * read early, at most one transaction per poll, unplugged probes, CRC
+ * errors and parasite power. Compares the bus
+ * time per reading with the previous search-by-index read of probe 0.
+ *
+ * Run with: pio test -e native -f native/test_ds18b20_bus
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "MoaDs18b20Bus.h"
+#include "SimulatedDs18b20Bus.h"
+
+static const uint32_t TICK_MS = 50;
+
+static SimulatedDs18b20Bus* sim;
+static MoaDs18b20Bus* probes;
+static uint32_t nowMs;
+static uint32_t taken[TEMP_PROBE_MAX_COUNT];
+static int32_t lastTaken[TEMP_PROBE_MAX_COUNT];
+static uint32_t maxTransactionsPerPoll;
+
+/**
+ * @brief Poll every tick for ms, taking every reading
+ */
+static void run(uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += TICK_MS) {
+        nowMs += TICK_MS;
+        sim->setNowMs(nowMs);
+        uint32_t before = sim->getTransactions();
+        probes->poll(nowMs);
+        uint32_t used = sim->getTransactions() - before;
+        if (used > maxTransactionsPerPoll) {
+            maxTransactionsPerPoll = used;
+        }
+        for (uint8_t i = 0; i < TEMP_PROBE_MAX_COUNT; i++) {
+            int32_t centiC;
+            if (probes->takeReading(i, &centiC)) {
+                taken[i]++;
+                lastTaken[i] = centiC;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Plug count probes; with assign, probe i is configured for role i
+ */
+static void plugProbes(uint8_t count, bool parasite, bool assign = true) {
+    for (uint8_t i = 0; i < count; i++) {
+        sim->addProbe(0x1000 + i, parasite);
+        if (assign) {
+            probes->setRoleRom(i, sim->getRom(i));
+        }
+    }
+    sim->setTemperature(0, 41.3f);
+    sim->setTemperature(1, 55.0f);
+    sim->setTemperature(2, -8.2f);
+}
+
+void setUp(void) {
+    sim = new SimulatedDs18b20Bus();
+    probes = new MoaDs18b20Bus(sim);
+    nowMs = 1000;
+    sim->setNowMs(nowMs);
+    for (uint8_t i = 0; i < TEMP_PROBE_MAX_COUNT; i++) {
+        taken[i] = 0;
+        lastTaken[i] = 0;
+    }
+    maxTransactionsPerPoll = 0;
+}
+
+void tearDown(void) {
+    delete probes;
+    delete sim;
+}
+
+void test_crc_and_decode() {
+    // Maxim application note 27 example ROM
+    const uint8_t rom[7] = { 0x02, 0x1C, 0xB8, 0x01, 0x00, 0x00, 0x00 };
+    TEST_ASSERT_EQUAL_HEX8(0xA2, moaOneWireCrc8(rom, sizeof(rom)));
+
+    // -10.125 degC at 12 bits, then at 9 bits (undefined low bits set)
+    uint8_t scratch[9] = { 0x5E, 0xFF, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10, 0x00 };
+    scratch[8] = moaOneWireCrc8(scratch, 8);
+    int32_t centiC = 0;
+    TEST_ASSERT_TRUE(moaDs18b20Decode(scratch, &centiC));
+    TEST_ASSERT_EQUAL_INT32(-1013, centiC);
+
+    scratch[4] = 0x1F;
+    scratch[8] = moaOneWireCrc8(scratch, 8);
+    TEST_ASSERT_TRUE(moaDs18b20Decode(scratch, &centiC));
+    TEST_ASSERT_EQUAL_INT32(-1050, centiC);
+
+    // A line stuck low reads all zeros, which passes the CRC
+    uint8_t zeros[9] = { 0 };
+    TEST_ASSERT_FALSE(moaDs18b20Decode(zeros, &centiC));
+    TEST_ASSERT_EQUAL_UINT32(94, moaDs18b20ConversionMs(9));
+    TEST_ASSERT_EQUAL_UINT32(750, moaDs18b20ConversionMs(12));
+}
+
+void test_begin_searches_once_and_sets_resolutions() {
+    plugProbes(3, false);
+    TEST_ASSERT_EQUAL_UINT8(3, probes->begin());
+    uint32_t searches = sim->getSearches();
+    TEST_ASSERT_FALSE(probes->isParasite());
+    for (uint8_t i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_MEMORY(sim->getRom(i), probes->getRom(i), ONEWIRE_ROM_BYTES);
+    }
+    TEST_ASSERT_EQUAL_UINT8(TEMP_PROBE_RES_ESC, sim->getResolution(TEMP_PROBE_ESC));
+    TEST_ASSERT_EQUAL_UINT8(TEMP_PROBE_RES_MOTOR, sim->getResolution(TEMP_PROBE_MOTOR));
+    TEST_ASSERT_EQUAL_UINT8(TEMP_PROBE_RES_BATTERY, sim->getResolution(TEMP_PROBE_BATTERY));
+
+    run(10000);
+    TEST_ASSERT_EQUAL_UINT32(searches, sim->getSearches());
+    TEST_ASSERT_EQUAL_INT32(4125, lastTaken[0]);        // 41.3 at 0.25 degC steps
+    TEST_ASSERT_EQUAL_INT32(5500, lastTaken[1]);
+    TEST_ASSERT_EQUAL_INT32(-850, lastTaken[2]);        // -8.2 truncated to 0.5 degC steps
+}
+
+void test_roles_follow_the_configured_roms() {
+    plugProbes(3, false, false);
+    probes->setRoleRom(TEMP_PROBE_ESC, sim->getRom(2));
+    probes->setRoleRom(TEMP_PROBE_MOTOR, sim->getRom(0));
+    probes->setRoleRom(TEMP_PROBE_BATTERY, sim->getRom(1));
+    TEST_ASSERT_EQUAL_UINT8(3, probes->begin());
+    TEST_ASSERT_EQUAL_INT8(TEMP_PROBE_MOTOR, probes->getFoundRole(0));
+    TEST_ASSERT_EQUAL_INT8(TEMP_PROBE_ESC, probes->getFoundRole(2));
+    TEST_ASSERT_EQUAL_MEMORY(sim->getRom(2), probes->getRom(TEMP_PROBE_ESC), ONEWIRE_ROM_BYTES);
+
+    run(10000);
+    TEST_ASSERT_EQUAL_INT32(-825, lastTaken[TEMP_PROBE_ESC]);    // Probe 2 at the ESC's 10 bits
+    TEST_ASSERT_EQUAL_INT32(4125, lastTaken[TEMP_PROBE_MOTOR]);
+    TEST_ASSERT_EQUAL_INT32(5500, lastTaken[TEMP_PROBE_BATTERY]);
+}
+
+void test_unassigned_probes_are_not_guessed() {
+    plugProbes(3, false, false);
+    TEST_ASSERT_EQUAL_UINT8(0, probes->begin());
+    TEST_ASSERT_EQUAL_UINT8(3, probes->getFoundCount());
+    TEST_ASSERT_EQUAL_INT8(-1, probes->getFoundRole(0));
+    TEST_ASSERT_TRUE(probes->getRom(TEMP_PROBE_ESC) == nullptr);
+    uint32_t before = sim->getTransactions();
+
+    run(2000);
+    TEST_ASSERT_EQUAL_UINT32(before, sim->getTransactions());
+    TEST_ASSERT_EQUAL_UINT32(0, taken[TEMP_PROBE_ESC] + taken[TEMP_PROBE_MOTOR] + taken[TEMP_PROBE_BATTERY]);
+}
+
+void test_single_probe_falls_back_to_the_esc_role() {
+    plugProbes(1, false, false);
+    TEST_ASSERT_EQUAL_UINT8(1, probes->begin());
+    TEST_ASSERT_EQUAL_INT8(TEMP_PROBE_ESC, probes->getFoundRole(0));
+    TEST_ASSERT_FALSE(probes->isMissing(TEMP_PROBE_ESC));
+    run(2000);
+    TEST_ASSERT_EQUAL_INT32(4125, lastTaken[TEMP_PROBE_ESC]);
+}
+
+void test_lone_probe_is_not_taken_for_a_missing_esc_probe() {
+    plugProbes(1, false, false);                        // Only the battery probe is on the bus
+    uint8_t esc[ONEWIRE_ROM_BYTES];
+    memcpy(esc, sim->getRom(0), ONEWIRE_ROM_BYTES);
+    esc[1] ^= 0x40;                                     // The ESC probe, unplugged
+    esc[7] = moaOneWireCrc8(esc, 7);
+    probes->setRoleRom(TEMP_PROBE_ESC, esc);
+
+    TEST_ASSERT_EQUAL_UINT8(0, probes->begin());
+    TEST_ASSERT_TRUE(probes->isMissing(TEMP_PROBE_ESC));
+    TEST_ASSERT_TRUE(probes->getRom(TEMP_PROBE_ESC) == nullptr);
+    TEST_ASSERT_EQUAL_INT8(-1, probes->getFoundRole(0));
+
+    run(2000);
+    TEST_ASSERT_EQUAL_UINT32(0, taken[TEMP_PROBE_ESC]);
+    TEST_ASSERT_EQUAL_INT32(TEMP_PROBE_DISCONNECTED_C * 100, probes->getLastCentiC(TEMP_PROBE_ESC));
+}
+
+void test_missing_configured_probe_leaves_its_role_unbound() {
+    plugProbes(2, false);
+    uint8_t gone[ONEWIRE_ROM_BYTES];
+    memcpy(gone, sim->getRom(1), ONEWIRE_ROM_BYTES);
+    gone[1] ^= 0x80;                                    // A probe that was replaced
+    gone[7] = moaOneWireCrc8(gone, 7);
+    probes->setRoleRom(TEMP_PROBE_MOTOR, gone);
+
+    TEST_ASSERT_EQUAL_UINT8(1, probes->begin());
+    TEST_ASSERT_TRUE(probes->isMissing(TEMP_PROBE_MOTOR));
+    TEST_ASSERT_TRUE(probes->getRom(TEMP_PROBE_MOTOR) == nullptr);
+    TEST_ASSERT_EQUAL_MEMORY(gone, probes->getRoleRom(TEMP_PROBE_MOTOR), ONEWIRE_ROM_BYTES);
+    TEST_ASSERT_EQUAL_INT8(-1, probes->getFoundRole(1));  // Not moved into the empty role
+
+    run(2000);
+    TEST_ASSERT_EQUAL_INT32(4125, lastTaken[TEMP_PROBE_ESC]);
+    TEST_ASSERT_EQUAL_UINT32(0, taken[TEMP_PROBE_MOTOR]);
+    TEST_ASSERT_EQUAL_INT32(TEMP_PROBE_DISCONNECTED_C * 100, probes->getLastCentiC(TEMP_PROBE_MOTOR));
+
+    probes->setRoleRom(TEMP_PROBE_MOTOR, nullptr);
+    TEST_ASSERT_TRUE(probes->getRoleRom(TEMP_PROBE_MOTOR) == nullptr);
+}
+
+void test_staggered_probes_run_at_their_own_rate() {
+    plugProbes(3, false);
+    probes->setMode(MoaProbeMode::STAGGERED);
+    probes->setResolution(TEMP_PROBE_ESC, 12);
+    probes->setResolution(TEMP_PROBE_BATTERY, 9);
+    probes->begin();
+
+    run(15000);
+    TEST_ASSERT_EQUAL_UINT32(0, sim->getEarlyReads());
+    TEST_ASSERT_EQUAL_UINT32(1, maxTransactionsPerPoll);
+    TEST_ASSERT_UINT32_WITHIN(2, 15000 / 850, taken[0]);      // 750 ms + read + start ticks
+    TEST_ASSERT_TRUE(taken[2] > 2 * taken[0]);
+    TEST_ASSERT_EQUAL_UINT32(taken[0], probes->getReadCount(0));
+    TEST_ASSERT_EQUAL_UINT32(0, probes->getErrorCount(0));
+}
+
+void test_broadcast_converts_every_probe_with_one_command() {
+    plugProbes(3, false);
+    probes->setMode(MoaProbeMode::BROADCAST);
+    probes->begin();
+    uint32_t before = sim->getTransactions();
+
+    run(10000);
+    TEST_ASSERT_EQUAL_UINT32(0, sim->getEarlyReads());
+    TEST_ASSERT_EQUAL_UINT32(1, maxTransactionsPerPoll);
+    TEST_ASSERT_EQUAL_UINT32(sim->getConversions(0), sim->getConversions(2));
+    TEST_ASSERT_UINT32_WITHIN(1, taken[0], taken[2]);
+    // One Convert T plus one read per probe per cycle
+    uint32_t reads = taken[0] + taken[1] + taken[2];
+    TEST_ASSERT_UINT32_WITHIN(2, reads + sim->getConversions(0), sim->getTransactions() - before);
+}
+
+void test_bus_time_per_reading_against_search_by_index() {
+    plugProbes(1, false);
+    probes->setResolution(TEMP_PROBE_ESC, 12);          // As before
+    probes->begin();
+    sim->resetCounters();
+    run(30000);
+    double managedUs = static_cast<double>(sim->getBusMicros()) / taken[0];
+
+    // Previous path: broadcast Convert T, then getTempCByIndex(0) searched
+    // the bus for probe 0 before reading its scratchpad
+    sim->resetCounters();
+    uint8_t rom[ONEWIRE_ROM_BYTES];
+    uint8_t scratch[DS18B20_SCRATCH_BYTES];
+    for (int i = 0; i < 100; i++) {
+        sim->transaction(nullptr, DS18B20_CMD_CONVERT, nullptr, 0, nullptr, 0, false);
+        nowMs += 750;
+        sim->setNowMs(nowMs);
+        sim->resetSearch();
+        sim->search(rom);
+        sim->transaction(rom, DS18B20_CMD_READ_SCRATCH, nullptr, 0, scratch, sizeof(scratch), false);
+    }
+    double legacyUs = sim->getBusMicros() / 100.0;
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "bus time per reading: search by index %.1f ms, cached ROM %.1f ms",
+             legacyUs / 1000.0, managedUs / 1000.0);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(managedUs < legacyUs * 0.75);
+}
+
+void test_unplugged_probe_reports_disconnected_and_recovers() {
+    plugProbes(3, false);
+    probes->begin();
+    run(2000);
+    sim->setConnected(TEMP_PROBE_MOTOR, false);
+    run(2000);
+
+    TEST_ASSERT_EQUAL_INT32(TEMP_PROBE_DISCONNECTED_C * 100, lastTaken[TEMP_PROBE_MOTOR]);
+    TEST_ASSERT_TRUE(probes->getErrorCount(TEMP_PROBE_MOTOR) > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, probes->getErrorCount(TEMP_PROBE_ESC));
+    TEST_ASSERT_EQUAL_INT32(4125, lastTaken[TEMP_PROBE_ESC]);
+
+    sim->setConnected(TEMP_PROBE_MOTOR, true);
+    run(2000);
+    TEST_ASSERT_EQUAL_INT32(5500, lastTaken[TEMP_PROBE_MOTOR]);
+}
+
+void test_crc_error_is_counted_not_reported_as_a_temperature() {
+    plugProbes(1, false);
+    probes->begin();
+    run(1000);
+    uint32_t reads = probes->getReadCount(0);
+    sim->corruptNextRead();
+    run(260);                                           // Just past the next read
+
+    TEST_ASSERT_EQUAL_UINT32(1, probes->getErrorCount(0));
+    TEST_ASSERT_EQUAL_UINT32(reads, probes->getReadCount(0));
+    TEST_ASSERT_EQUAL_INT32(TEMP_PROBE_DISCONNECTED_C * 100, lastTaken[0]);
+    run(1000);
+    TEST_ASSERT_EQUAL_INT32(4125, lastTaken[0]);
+}
+
+void test_parasite_power_keeps_the_bus_quiet_while_converting() {
+    plugProbes(3, true);
+    probes->begin();
+    TEST_ASSERT_TRUE(probes->isParasite());
+
+    run(10000);
+    TEST_ASSERT_EQUAL_UINT32(0, sim->getParasiteFaults());
+    TEST_ASSERT_EQUAL_UINT32(0, sim->getEarlyReads());
+    TEST_ASSERT_TRUE(taken[0] > 5 && taken[1] > 5 && taken[2] > 5);
+
+    probes->setMode(MoaProbeMode::BROADCAST);
+    run(10000);
+    TEST_ASSERT_EQUAL_UINT32(0, sim->getParasiteFaults());
+    TEST_ASSERT_EQUAL_INT32(-850, lastTaken[2]);
+}
+
+void test_resolution_change_is_applied_between_conversions() {
+    plugProbes(3, false);
+    probes->begin();
+    run(1000);
+    probes->setResolution(TEMP_PROBE_BATTERY, 12);
+    probes->setResolution(TEMP_PROBE_ESC, 3);           // Clamped to 9
+    run(1000);
+
+    TEST_ASSERT_EQUAL_UINT8(12, sim->getResolution(TEMP_PROBE_BATTERY));
+    TEST_ASSERT_EQUAL_UINT8(9, sim->getResolution(TEMP_PROBE_ESC));
+    TEST_ASSERT_EQUAL_UINT8(9, probes->getResolution(TEMP_PROBE_ESC));
+    run(2000);
+    TEST_ASSERT_EQUAL_UINT32(0, sim->getEarlyReads());
+    TEST_ASSERT_EQUAL_INT32(-819, lastTaken[2]);        // 1/16 degC at 12 bits
+}
+
+void test_empty_bus_is_idle() {
+    TEST_ASSERT_EQUAL_UINT8(0, probes->begin());
+    run(1000);
+    TEST_ASSERT_EQUAL_UINT32(0, sim->getTransactions());
+    int32_t centiC;
+    TEST_ASSERT_FALSE(probes->takeReading(0, &centiC));
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_crc_and_decode);
+    RUN_TEST(test_begin_searches_once_and_sets_resolutions);
+    RUN_TEST(test_roles_follow_the_configured_roms);
+    RUN_TEST(test_unassigned_probes_are_not_guessed);
+    RUN_TEST(test_single_probe_falls_back_to_the_esc_role);
+    RUN_TEST(test_lone_probe_is_not_taken_for_a_missing_esc_probe);
+    RUN_TEST(test_missing_configured_probe_leaves_its_role_unbound);
+    RUN_TEST(test_staggered_probes_run_at_their_own_rate);
+    RUN_TEST(test_broadcast_converts_every_probe_with_one_command);
+    RUN_TEST(test_bus_time_per_reading_against_search_by_index);
+    RUN_TEST(test_unplugged_probe_reports_disconnected_and_recovers);
+    RUN_TEST(test_crc_error_is_counted_not_reported_as_a_temperature);
+    RUN_TEST(test_parasite_power_keeps_the_bus_quiet_while_converting);
+    RUN_TEST(test_resolution_change_is_applied_between_conversions);
+    RUN_TEST(test_empty_bus_is_idle);
+
+    return UNITY_END();
+}
@@ -0,0 +1,224 @@
+/**
+ * @file test_energy_meter.cpp
+ * @brief Host tests for the MoaEnergyMeter coulomb counter
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Feeds synthetic current profiles (constant, ramp, irregular sampling,
+ * regeneration, stalled producer) and checks charge, energy, state of
+ * charge, the rolling power, the ride time estimate and the NVS write
+ * rate limit.
+ *
+ * Run with: pio test -e native -f native/test_energy_meter
+ */
+
+#include <unity.h>
+#include "MoaEnergyMeter.h"
+
+static MoaEnergyMeter* meter;
+
+static StatsReading makeReading(uint8_t type, int32_t value, uint32_t timestamp) {
+    StatsReading r;
+    r.statsType = type;
+    r.value = value;
+    r.timestamp = timestamp;
+    return r;
+}
+
+static void battery(int32_t mv, uint32_t t) {
+    meter->add(makeReading(STATS_TYPE_BATTERY, mv, t));
+}
+
+static void current(int32_t x10, uint32_t t) {
+    meter->add(makeReading(STATS_TYPE_CURRENT, x10, t));
+}
+
+/**
+ * @brief Constant current from fromMs to toMs (inclusive), one reading per stepMs
+ */
+static void hold(int32_t x10, uint32_t fromMs, uint32_t toMs, uint32_t stepMs) {
+    for (uint32_t t = fromMs; t <= toMs; t += stepMs) {
+        current(x10, t);
+    }
+}
+
+void setUp(void) {
+    meter = new MoaEnergyMeter();
+    meter->setBattery(20000, 25200, 18900);
+}
+
+void tearDown(void) {
+    delete meter;
+}
+
+void test_nothing_before_a_battery_reading() {
+    hold(100, 0, 10000, 50);
+    MoaEnergyReport r = meter->getReport();
+    TEST_ASSERT_EQUAL_INT32(0, r.sessionMah);
+    TEST_ASSERT_EQUAL_UINT32(0, r.integratedMs);
+    TEST_ASSERT_EQUAL_UINT16(MOA_ENERGY_SOC_UNKNOWN, r.socPermille);
+    TEST_ASSERT_EQUAL_UINT32(MOA_ENERGY_TIME_UNKNOWN, r.remainingS);
+}
+
+void test_constant_current_for_one_hour() {
+    battery(25000, 0);
+    hold(100, 0, 3600000, 50);                          // 10 A for 1 h at 25 V
+
+    MoaEnergyReport r = meter->getReport();
+    TEST_ASSERT_EQUAL_UINT32(3600000, r.integratedMs);
+    TEST_ASSERT_EQUAL_INT32(10000, r.sessionMah);
+    TEST_ASSERT_EQUAL_INT32(250000, r.sessionMwh);
+    TEST_ASSERT_EQUAL_INT32(250000, r.avgPowerMw);
+    // 25.0 V starts at 968 permille; 10 Ah of 20 Ah is 500
+    TEST_ASSERT_EQUAL_UINT16(468, r.socPermille);
+}
+
+void test_ramp_is_integrated_as_trapezoids() {
+    battery(25000, 0);
+    for (uint32_t i = 0; i <= 1000; i++) {              // 0 -> 100 A over 36 s
+        current(static_cast<int32_t>(i), i * 36);
+    }
+    MoaEnergyReport r = meter->getReport();
+    TEST_ASSERT_EQUAL_INT32(500, r.sessionMah);         // mean 50 A x 36 s
+    TEST_ASSERT_EQUAL_INT32(12500, r.sessionMwh);
+}
+
+void test_irregular_intervals_use_real_time() {
+    battery(24000, 0);
+    uint32_t t = 0;
+    for (uint32_t i = 0; i < 36000; i++) {              // 20 / 80 ms jitter, 50 ms mean
+        current(200, t);
+        t += (i & 1) ? 80 : 20;
+    }
+    current(200, t);
+    MoaEnergyReport r = meter->getReport();
+    TEST_ASSERT_EQUAL_UINT32(1800000, r.integratedMs);
+    TEST_ASSERT_EQUAL_INT32(10000, r.sessionMah);       // 20 A for 30 min
+    TEST_ASSERT_EQUAL_INT32(240000, r.sessionMwh);
+}
+
+void test_stalled_producer_gap_is_skipped() {
+    battery(25000, 0);
+    hold(360, 0, 10000, 50);                            // 36 A for 10 s = 100 mAh
+    hold(360, 10000 + STATS_ENERGY_MAX_GAP_MS + 1, 30000 + STATS_ENERGY_MAX_GAP_MS + 1, 50);
+    MoaEnergyReport r = meter->getReport();
+    TEST_ASSERT_EQUAL_UINT32(30000, r.integratedMs);
+    TEST_ASSERT_EQUAL_INT32(300, r.sessionMah);
+}
+
+void test_regeneration_counts_back() {
+    battery(25200, 0);
+    hold(1000, 0, 36000, 50);                           // 100 A for 36 s = 1000 mAh
+    hold(-500, 36050, 72050, 50);                       // -50 A for 36 s = -500 mAh
+    MoaEnergyReport r = meter->getReport();
+    TEST_ASSERT_INT32_WITHIN(1, 500, r.sessionMah);
+    TEST_ASSERT_INT32_WITHIN(2, 975, r.socPermille);    // 1000 - 500 mAh / 20 Ah
+}
+
+void test_state_of_charge_is_clamped() {
+    battery(26000, 0);                                  // Above full
+    TEST_ASSERT_EQUAL_UINT16(1000, meter->getReport().socPermille);
+    hold(-1000, 0, 60000, 50);                          // Charging past full
+    TEST_ASSERT_EQUAL_UINT16(1000, meter->getReport().socPermille);
+
+    meter->reset();
+    battery(18000, 0);                                  // Below empty
+    TEST_ASSERT_EQUAL_UINT16(0, meter->getReport().socPermille);
+}
+
+void test_first_battery_reading_sets_soc_under_load_later_readings_do_not() {
+    battery(22050, 0);                                  // Mid-way: 500 permille
+    TEST_ASSERT_EQUAL_UINT16(500, meter->getReport().socPermille);
+    battery(19000, 50);                                 // Sag under load
+    TEST_ASSERT_EQUAL_UINT16(500, meter->getReport().socPermille);
+}
+
+void test_rolling_power_follows_a_step() {
+    battery(25000, 0);
+    hold(0, 0, 10000, 50);
+    TEST_ASSERT_EQUAL_INT32(0, meter->getReport().avgPowerMw);
+
+    hold(200, 10050, 10000 + ENERGY_POWER_WINDOW_MS, 50);   // 500 W for one time constant
+    int32_t afterOneTau = meter->getReport().avgPowerMw;
+    TEST_ASSERT_INT32_WITHIN(15000, 316000, afterOneTau);   // 1 - 1/e
+
+    hold(200, 10050 + ENERGY_POWER_WINDOW_MS, 10000 + 6 * ENERGY_POWER_WINDOW_MS, 50);
+    TEST_ASSERT_INT32_WITHIN(2500, 500000, meter->getReport().avgPowerMw);
+}
+
+void test_ride_time_at_rolling_power() {
+    meter->setBattery(10000, 25200, 18900);
+    battery(25200, 0);
+    hold(200, 0, 600000, 50);                           // 504 W for 10 min
+
+    MoaEnergyReport r = meter->getReport();
+    TEST_ASSERT_EQUAL_INT32(3333, r.sessionMah);
+    TEST_ASSERT_EQUAL_UINT16(667, r.socPermille);
+    TEST_ASSERT_EQUAL_INT32(504000, r.avgPowerMw);
+    // 6.67 Ah at the 22.05 V mid voltage, at 504 W
+    TEST_ASSERT_UINT32_WITHIN(2, 1050, r.remainingS);
+}
+
+void test_no_ride_time_when_idle() {
+    battery(25200, 0);
+    hold(1, 0, 600000, 50);                             // 0.1 A: 2.5 W, below ENERGY_MIN_POWER_MW
+    MoaEnergyReport r = meter->getReport();
+    TEST_ASSERT_TRUE(r.avgPowerMw < ENERGY_MIN_POWER_MW);
+    TEST_ASSERT_EQUAL_UINT32(MOA_ENERGY_TIME_UNKNOWN, r.remainingS);
+}
+
+void test_lifetime_adds_to_the_loaded_base() {
+    meter->setLifetime(123456, 3000000);
+    battery(25000, 0);
+    hold(100, 0, 360000, 50);                           // 1000 mAh, 25000 mWh
+    MoaEnergyReport r = meter->getReport();
+    TEST_ASSERT_EQUAL_INT32(124456, r.lifetimeMah);
+    TEST_ASSERT_EQUAL_INT32(3025000, r.lifetimeMwh);
+
+    meter->reset();                                     // New session, same base
+    TEST_ASSERT_EQUAL_INT32(123456, meter->getReport().lifetimeMah);
+}
+
+void test_saves_are_rate_limited() {
+    battery(25000, 0);
+    uint32_t saves = 0;
+    uint32_t firstSaveMs = 0;
+    for (uint32_t t = 0; t <= 3600000; t += 50) {       // 1 h at 20 A
+        current(200, t);
+        if (meter->isSaveDue(t)) {
+            if (saves == 0) {
+                firstSaveMs = t;
+            }
+            meter->markSaved(t);
+            saves++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(ENERGY_SAVE_INTERVAL_MS, firstSaveMs);
+    TEST_ASSERT_EQUAL_UINT32(3600000 / ENERGY_SAVE_INTERVAL_MS, saves);
+
+    // Parked: nothing moves, nothing is written
+    for (uint32_t t = 3600050; t <= 3600000 + 4 * ENERGY_SAVE_INTERVAL_MS; t += 50) {
+        current(0, t);
+        TEST_ASSERT_FALSE(meter->isSaveDue(t));
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_nothing_before_a_battery_reading);
+    RUN_TEST(test_constant_current_for_one_hour);
+    RUN_TEST(test_ramp_is_integrated_as_trapezoids);
+    RUN_TEST(test_irregular_intervals_use_real_time);
+    RUN_TEST(test_stalled_producer_gap_is_skipped);
+    RUN_TEST(test_regeneration_counts_back);
+    RUN_TEST(test_state_of_charge_is_clamped);
+    RUN_TEST(test_first_battery_reading_sets_soc_under_load_later_readings_do_not);
+    RUN_TEST(test_rolling_power_follows_a_step);
+    RUN_TEST(test_ride_time_at_rolling_power);
+    RUN_TEST(test_no_ride_time_when_idle);
+    RUN_TEST(test_lifetime_adds_to_the_loaded_base);
+    RUN_TEST(test_saves_are_rate_limited);
+
+    return UNITY_END();
+}
@@ -0,0 +1,302 @@
+/**
+ * @file test_esc_ramp.cpp
+ * @brief Host tests for MoaEscRamp and MoaRampProfile (ramp shapes at 14-bit PWM resolution)
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Drives the ramp the way ESCController does - first step when the ramp
+ * starts, then one step per timer tick - into a simulated PWM sink that
+ * records every write with its virtual time. Checks that writes are evenly
+ * spaced, monotonic, land exactly on the target, keep the full-resolution
+ * step size, and that a new target or a trip mid-ramp never jumps. Curved
+ * profiles are checked against their closed form at every step.
+ *
+ * Run with: pio test -e native -f native/test_esc_ramp
+ */
+
+#include <unity.h>
+#include <math.h>
+#include "MoaEscRamp.h"
+
+// 14-bit LEDC at 50 Hz: 1 ms and 2 ms pulses
+#define MIN_DUTY    819
+#define MAX_DUTY    1638
+#define TICK_US     20000
+
+/**
+ * @brief Simulated PWM output: every duty write with its time
+ */
+struct PwmSink {
+    static const uint16_t CAPACITY = 2048;
+    uint32_t timeUs[CAPACITY];
+    uint16_t duty[CAPACITY];
+    uint16_t count;
+
+    void clear() { count = 0; }
+
+    void write(uint32_t t, uint16_t d) {
+        if (count < CAPACITY) {
+            timeUs[count] = t;
+            duty[count] = d;
+            count++;
+        }
+    }
+};
+
+static MoaEscRamp* ramp;
+static PwmSink sink;
+static uint32_t nowUs;
+
+/**
+ * @brief Start a ramp and write its first step now, as ESCController::startRamp()
+ */
+static bool startRamp(uint16_t target, uint16_t steps, const MoaRampProfile* profile = nullptr) {
+    if (!ramp->start(target, steps, profile)) {
+        return false;
+    }
+    if (ramp->step()) {
+        sink.write(nowUs, ramp->getDuty());
+    }
+    return true;
+}
+
+/**
+ * @brief Run the ramp timer for up to n ticks (stops when the ramp is done)
+ */
+static void runTicks(uint32_t n) {
+    for (uint32_t i = 0; i < n && ramp->isActive(); i++) {
+        nowUs += TICK_US;
+        if (ramp->step()) {
+            sink.write(nowUs, ramp->getDuty());
+        }
+    }
+}
+
+void setUp(void) {
+    ramp = new MoaEscRamp(MIN_DUTY);
+    sink.clear();
+    nowUs = 1000;
+}
+
+void tearDown(void) {
+    delete ramp;
+}
+
+void test_full_range_ramp_is_even_and_exact() {
+    uint16_t steps = MoaEscRamp::stepsFor(MIN_DUTY, MAX_DUTY, MIN_DUTY, MAX_DUTY, 200.0f, TICK_US);
+    TEST_ASSERT_EQUAL_UINT16(25, steps);                 // 100 % at 200 %/s = 500 ms = 25 frames
+
+    TEST_ASSERT_TRUE(startRamp(MAX_DUTY, steps));
+    runTicks(1000);
+
+    TEST_ASSERT_FALSE(ramp->isActive());
+    TEST_ASSERT_EQUAL_UINT16(steps, sink.count);
+    TEST_ASSERT_EQUAL_UINT16(MAX_DUTY, sink.duty[sink.count - 1]);
+    TEST_ASSERT_EQUAL_UINT32(1000, sink.timeUs[0]);      // First step with the command
+
+    uint16_t minStep = 0xFFFF;
+    uint16_t maxStep = 0;
+    for (uint16_t i = 1; i < sink.count; i++) {
+        TEST_ASSERT_EQUAL_UINT32(TICK_US, sink.timeUs[i] - sink.timeUs[i - 1]);
+        TEST_ASSERT_TRUE(sink.duty[i] > sink.duty[i - 1]);
+        uint16_t step = sink.duty[i] - sink.duty[i - 1];
+        minStep = (step < minStep) ? step : minStep;
+        maxStep = (step > maxStep) ? step : maxStep;
+    }
+    TEST_ASSERT_TRUE(maxStep - minStep <= 1);            // Linear: no accumulated rounding
+}
+
+void test_slow_ramp_keeps_full_resolution() {
+    // 10 %/s over the whole range: 500 frames, one or two counts (1.2-2.4 µs) each
+    uint16_t steps = MoaEscRamp::stepsFor(MIN_DUTY, MAX_DUTY, MIN_DUTY, MAX_DUTY, 10.0f, TICK_US);
+    TEST_ASSERT_EQUAL_UINT16(500, steps);
+
+    startRamp(MAX_DUTY, steps);
+    runTicks(1000);
+
+    TEST_ASSERT_EQUAL_UINT16(MAX_DUTY, ramp->getDuty());
+    TEST_ASSERT_TRUE(sink.count > 400);                  // At 10 bits there would be 51 distinct duties
+    for (uint16_t i = 1; i < sink.count; i++) {
+        TEST_ASSERT_TRUE(sink.duty[i] - sink.duty[i - 1] <= 2);
+    }
+}
+
+void test_ramp_down_is_monotonic() {
+    ramp->reset(MAX_DUTY);
+    startRamp(MIN_DUTY + 100, 40);
+    runTicks(1000);
+
+    TEST_ASSERT_EQUAL_UINT16(40, sink.count);
+    for (uint16_t i = 1; i < sink.count; i++) {
+        TEST_ASSERT_TRUE(sink.duty[i] < sink.duty[i - 1]);
+    }
+    TEST_ASSERT_EQUAL_UINT16(MIN_DUTY + 100, sink.duty[sink.count - 1]);
+}
+
+void test_new_target_mid_ramp_starts_where_it_is() {
+    startRamp(MAX_DUTY, 20);
+    runTicks(9);                                         // 10 steps taken: half way
+    uint16_t reached = ramp->getDuty();
+    TEST_ASSERT_EQUAL_UINT16(MIN_DUTY + (MAX_DUTY - MIN_DUTY) / 2, reached);
+
+    uint16_t before = sink.count;
+    startRamp(MIN_DUTY, 10);
+    runTicks(100);
+
+    // The first write of the new ramp is one step down from where the old one stood
+    uint16_t firstDown = sink.duty[before];
+    TEST_ASSERT_TRUE(firstDown < reached);
+    TEST_ASSERT_TRUE(reached - firstDown <= (reached - MIN_DUTY) / 10 + 1);
+    TEST_ASSERT_EQUAL_UINT16(MIN_DUTY, ramp->getDuty());
+    TEST_ASSERT_EQUAL_UINT16(before + 10, sink.count);
+}
+
+void test_reset_cancels_ramp() {
+    startRamp(MAX_DUTY, 25);
+    runTicks(5);
+    ramp->reset(MIN_DUTY);                               // Trip or stop
+
+    TEST_ASSERT_FALSE(ramp->isActive());
+    TEST_ASSERT_EQUAL_UINT16(0, ramp->getStepsLeft());
+    TEST_ASSERT_FALSE(ramp->step());
+    TEST_ASSERT_EQUAL_UINT16(MIN_DUTY, ramp->getDuty());
+}
+
+void test_degenerate_ramps() {
+    TEST_ASSERT_FALSE(ramp->start(MIN_DUTY, 10));        // Already there
+    TEST_ASSERT_FALSE(ramp->isActive());
+
+    TEST_ASSERT_TRUE(startRamp(MIN_DUTY + 400, 0));      // 0 steps = one jump
+    TEST_ASSERT_FALSE(ramp->isActive());
+    TEST_ASSERT_EQUAL_UINT16(1, sink.count);
+    TEST_ASSERT_EQUAL_UINT16(MIN_DUTY + 400, sink.duty[0]);
+
+    // More steps than counts: some ticks leave the duty as is and write nothing
+    ramp->reset(MIN_DUTY);
+    sink.clear();
+    startRamp(MIN_DUTY + 10, 50);
+    TEST_ASSERT_EQUAL_UINT16(50 - 1, ramp->getStepsLeft());
+    runTicks(100);
+    TEST_ASSERT_EQUAL_UINT16(10, sink.count);
+    TEST_ASSERT_EQUAL_UINT16(MIN_DUTY + 10, ramp->getDuty());
+}
+
+void test_steps_for_rate() {
+    // Half the range at 200 %/s: 250 ms
+    TEST_ASSERT_EQUAL_UINT16(12, MoaEscRamp::stepsFor(MIN_DUTY, MIN_DUTY + 410, MIN_DUTY, MAX_DUTY, 200.0f, TICK_US));
+    TEST_ASSERT_EQUAL_UINT16(12, MoaEscRamp::stepsFor(MIN_DUTY + 410, MIN_DUTY, MIN_DUTY, MAX_DUTY, 200.0f, TICK_US));
+    TEST_ASSERT_EQUAL_UINT16(1, MoaEscRamp::stepsFor(MIN_DUTY, MIN_DUTY + 1, MIN_DUTY, MAX_DUTY, 200.0f, TICK_US));
+    TEST_ASSERT_EQUAL_UINT16(1, MoaEscRamp::stepsFor(MIN_DUTY, MAX_DUTY, MIN_DUTY, MAX_DUTY, 0.0f, TICK_US));
+    TEST_ASSERT_EQUAL_UINT16(65535, MoaEscRamp::stepsFor(MIN_DUTY, MAX_DUTY, MIN_DUTY, MAX_DUTY, 0.001f, TICK_US));
+}
+
+void test_profile_tables_span_zero_to_one() {
+    for (uint8_t i = 0; i < MOA_RAMP_SHAPE_COUNT; i++) {
+        MoaRampProfile profile;
+        profile.build(static_cast<MoaRampShape>(i), 3.0f);
+        TEST_ASSERT_EQUAL_UINT16(0, profile.at(0, 100));
+        TEST_ASSERT_EQUAL_UINT16(MoaRampProfile::ONE, profile.at(100, 100));
+        uint16_t previous = 0;
+        for (uint16_t k = 1; k <= 1000; k++) {
+            uint16_t progress = profile.at(k, 1000);
+            TEST_ASSERT_TRUE(progress >= previous);
+            previous = progress;
+        }
+    }
+
+    MoaRampProfile flat;
+    flat.build(MoaRampShape::EXPO, 0.0f);                // No curvature: a line
+    TEST_ASSERT_TRUE(flat.isLinear());
+}
+
+void test_scurve_ramp_follows_smootherstep() {
+    MoaRampProfile scurve;
+    scurve.build(MoaRampShape::SCURVE, 0.0f);
+    const uint16_t steps = 50;
+
+    TEST_ASSERT_TRUE(startRamp(MAX_DUTY, steps, &scurve));
+    runTicks(1000);
+
+    TEST_ASSERT_EQUAL_UINT16(MAX_DUTY, ramp->getDuty());
+    TEST_ASSERT_EQUAL_UINT32(1000 + (steps - 1) * TICK_US, nowUs);   // Same duration as linear
+
+    // Every write within a count of the closed form: no accumulated error
+    for (uint16_t i = 0; i < sink.count; i++) {
+        float t = (float)((sink.timeUs[i] - 1000) / TICK_US + 1) / steps;
+        float f = t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+        float expected = MIN_DUTY + f * (MAX_DUTY - MIN_DUTY);
+        TEST_ASSERT_FLOAT_WITHIN(1.0f, expected, (float)sink.duty[i]);
+    }
+
+    // Eases in and out: end steps far smaller than the middle ones
+    uint16_t firstStep = sink.duty[0] - MIN_DUTY;
+    uint16_t lastStep = sink.duty[sink.count - 1] - sink.duty[sink.count - 2];
+    uint16_t midStep = sink.duty[sink.count / 2] - sink.duty[sink.count / 2 - 1];
+    TEST_ASSERT_TRUE(firstStep * 10 < midStep);
+    TEST_ASSERT_TRUE(lastStep * 10 < midStep);
+}
+
+void test_expo_ramp_starts_soft() {
+    MoaRampProfile expo;
+    expo.build(MoaRampShape::EXPO, 3.0f);
+    const uint16_t steps = 40;
+
+    ramp->reset(MAX_DUTY);                               // Ramp down: same shape, mirrored
+    startRamp(MIN_DUTY, steps, &expo);
+    runTicks(1000);
+
+    TEST_ASSERT_EQUAL_UINT16(MIN_DUTY, ramp->getDuty());
+    for (uint16_t i = 1; i < sink.count; i++) {
+        TEST_ASSERT_TRUE(sink.duty[i] < sink.duty[i - 1]);
+        // Each step at least as large as the one before (convex)
+        if (i >= 2) {
+            TEST_ASSERT_TRUE(sink.duty[i - 1] - sink.duty[i] + 1 >= sink.duty[i - 2] - sink.duty[i - 1]);
+        }
+    }
+    float t = 1.0f / steps;
+    float expected = MAX_DUTY - (expf(3.0f * t) - 1.0f) / (expf(3.0f) - 1.0f) * (MAX_DUTY - MIN_DUTY);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, expected, (float)sink.duty[0]);
+}
+
+void test_expo_curvature_is_clamped() {
+    MoaRampProfile capped;
+    capped.build(MoaRampShape::EXPO, ESC_RAMP_CURVATURE_MAX);
+
+    // Too steep: c = 50 holds the start, c = 200 overflows e^c
+    const float steep[] = { 50.0f, 200.0f };
+    for (uint8_t w = 0; w < 2; w++) {
+        MoaRampProfile expo;
+        expo.build(MoaRampShape::EXPO, steep[w]);
+        for (uint16_t k = 0; k <= 33; k++) {
+            TEST_ASSERT_EQUAL_UINT16(capped.at(k, 33), expo.at(k, 33));
+        }
+    }
+
+    MoaRampProfile undefined;
+    undefined.build(MoaRampShape::EXPO, NAN);
+    TEST_ASSERT_TRUE(undefined.isLinear());
+
+    // The last 20 ms tick of a 33-tick ramp moves well under half the range
+    TEST_ASSERT_TRUE(MoaRampProfile::ONE - capped.at(32, 33) < MoaRampProfile::ONE / 2);
+    TEST_ASSERT_TRUE(capped.at(30, 33) > MoaRampProfile::ONE / 50);
+
+    TEST_ASSERT_EQUAL_FLOAT(ESC_RAMP_CURVATURE_MAX, MoaRampProfile::clampCurvature(1e9f));
+    TEST_ASSERT_EQUAL_FLOAT(ESC_RAMP_CURVATURE_MIN, MoaRampProfile::clampCurvature(-3.0f));
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, MoaRampProfile::clampCurvature(3.0f));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_full_range_ramp_is_even_and_exact);
+    RUN_TEST(test_slow_ramp_keeps_full_resolution);
+    RUN_TEST(test_ramp_down_is_monotonic);
+    RUN_TEST(test_new_target_mid_ramp_starts_where_it_is);
+    RUN_TEST(test_reset_cancels_ramp);
+    RUN_TEST(test_degenerate_ramps);
+    RUN_TEST(test_steps_for_rate);
+    RUN_TEST(test_profile_tables_span_zero_to_one);
+    RUN_TEST(test_scurve_ramp_follows_smootherstep);
+    RUN_TEST(test_expo_ramp_starts_soft);
+    RUN_TEST(test_expo_curvature_is_clamped);
+    return UNITY_END();
+}
@@ -0,0 +1,285 @@
+/**
+ * @file test_event_queue.cpp
+ * @brief Host tests for MoaEventQueue (priority lanes, coalescing, drop counters)
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Checks the lane assignment and service order, in-place coalescing of
+ * repeated sensor events, superseding of stale normal-lane events, and a
+ * seeded stress run that floods the queue with button and timer bursts
+ * while a slow consumer drains it: no safety transition may be lost and
+ * every push must be accounted for. Typed event views must round-trip
+ * through the 4-byte ControlCommand.
+ *
+ * Run with: pio test -e native -f native/test_event_queue
+ */
+
+#include <unity.h>
+#include "MoaEventQueue.h"
+
+static MoaEventQueue* queue;
+
+static ControlCommand makeEvent(int controlType, int commandType, int value = 0) {
+    ControlCommand cmd;
+    cmd.controlType = static_cast<uint8_t>(controlType);
+    cmd.commandType = static_cast<uint8_t>(commandType);
+    cmd.payload = static_cast<uint16_t>(value);
+    return cmd;
+}
+
+void setUp(void) {
+    queue = new MoaEventQueue();
+}
+
+void tearDown(void) {
+    delete queue;
+}
+
+void test_lanes() {
+    TEST_ASSERT_EQUAL(MOA_EVENT_LANE_SAFETY, MoaEventQueue::laneOf(makeEvent(CONTROL_TYPE_CURRENT, COMMAND_CURRENT_NORMAL)));
+    TEST_ASSERT_EQUAL(MOA_EVENT_LANE_SAFETY, MoaEventQueue::laneOf(makeEvent(CONTROL_TYPE_TEMPERATURE, COMMAND_TEMP_CROSSED_ABOVE)));
+    TEST_ASSERT_EQUAL(MOA_EVENT_LANE_SAFETY, MoaEventQueue::laneOf(makeEvent(CONTROL_TYPE_BATTERY, COMMAND_BATT_LEVEL_STOP)));
+    TEST_ASSERT_EQUAL(MOA_EVENT_LANE_NORMAL, MoaEventQueue::laneOf(makeEvent(CONTROL_TYPE_BATTERY, COMMAND_BATT_LEVEL_LOW)));
+    TEST_ASSERT_EQUAL(MOA_EVENT_LANE_NORMAL, MoaEventQueue::laneOf(makeEvent(CONTROL_TYPE_BUTTON, COMMAND_BUTTON_50)));
+    TEST_ASSERT_EQUAL(MOA_EVENT_LANE_NORMAL, MoaEventQueue::laneOf(makeEvent(CONTROL_TYPE_TIMER, 0)));
+    TEST_ASSERT_EQUAL(MOA_EVENT_SOURCE_OTHER, MoaEventQueue::sourceOf(makeEvent(7, 1)));
+}
+
+void test_safety_served_first_fifo_within_lane() {
+    queue->push(makeEvent(CONTROL_TYPE_BUTTON, COMMAND_BUTTON_25, BUTTON_EVENT_PRESS));
+    queue->push(makeEvent(CONTROL_TYPE_TIMER, 1));
+    queue->push(makeEvent(CONTROL_TYPE_TEMPERATURE, COMMAND_TEMP_CROSSED_ABOVE, 612));
+    queue->push(makeEvent(CONTROL_TYPE_CURRENT, COMMAND_CURRENT_OVERCURRENT, 1650));
+
+    ControlCommand cmd;
+    TEST_ASSERT_TRUE(queue->pop(cmd));
+    TEST_ASSERT_EQUAL(CONTROL_TYPE_TEMPERATURE, cmd.controlType);
+    TEST_ASSERT_TRUE(queue->pop(cmd));
+    TEST_ASSERT_EQUAL(CONTROL_TYPE_CURRENT, cmd.controlType);
+    TEST_ASSERT_TRUE(queue->pop(cmd));
+    TEST_ASSERT_EQUAL(CONTROL_TYPE_BUTTON, cmd.controlType);
+    TEST_ASSERT_TRUE(queue->pop(cmd));
+    TEST_ASSERT_EQUAL(CONTROL_TYPE_TIMER, cmd.controlType);
+    TEST_ASSERT_FALSE(queue->pop(cmd));
+}
+
+void test_repeated_sensor_event_coalesced_in_place() {
+    queue->push(makeEvent(CONTROL_TYPE_CURRENT, COMMAND_CURRENT_OVERCURRENT, 1600));
+    queue->push(makeEvent(CONTROL_TYPE_TEMPERATURE, COMMAND_TEMP_CROSSED_ABOVE, 600));
+    TEST_ASSERT_EQUAL(MOA_EVENT_COALESCED, queue->push(makeEvent(CONTROL_TYPE_CURRENT, COMMAND_CURRENT_OVERCURRENT, 1700)));
+    TEST_ASSERT_EQUAL_UINT8(2, queue->size());
+
+    ControlCommand cmd;
+    queue->pop(cmd);
+    TEST_ASSERT_EQUAL(CONTROL_TYPE_CURRENT, cmd.controlType);   // Kept its place
+    TEST_ASSERT_EQUAL(1700, CurrentEvent(cmd).getDeciAmps());  // Latest value
+    TEST_ASSERT_EQUAL_UINT32(1, queue->getCounters(MOA_EVENT_SOURCE_CURRENT).queued);
+    TEST_ASSERT_EQUAL_UINT32(1, queue->getCounters(MOA_EVENT_SOURCE_CURRENT).coalesced);
+}
+
+void test_transitions_are_not_coalesced_out_of_order() {
+    // OVER, NORMAL, OVER: merging the last into the first would end on NORMAL
+    queue->push(makeEvent(CONTROL_TYPE_CURRENT, COMMAND_CURRENT_OVERCURRENT));
+    queue->push(makeEvent(CONTROL_TYPE_CURRENT, COMMAND_CURRENT_NORMAL));
+    TEST_ASSERT_EQUAL(MOA_EVENT_QUEUED, queue->push(makeEvent(CONTROL_TYPE_CURRENT, COMMAND_CURRENT_OVERCURRENT)));
+
+    ControlCommand cmd;
+    int last = 0;
+    while (queue->pop(cmd)) {
+        last = cmd.commandType;
+    }
+    TEST_ASSERT_EQUAL(COMMAND_CURRENT_OVERCURRENT, last);
+}
+
+void test_buttons_and_timers_never_coalesced() {
+    queue->push(makeEvent(CONTROL_TYPE_BUTTON, COMMAND_BUTTON_STOP, BUTTON_EVENT_PRESS));
+    TEST_ASSERT_EQUAL(MOA_EVENT_QUEUED, queue->push(makeEvent(CONTROL_TYPE_BUTTON, COMMAND_BUTTON_STOP, BUTTON_EVENT_PRESS)));
+    queue->push(makeEvent(CONTROL_TYPE_TIMER, 0));
+    TEST_ASSERT_EQUAL(MOA_EVENT_QUEUED, queue->push(makeEvent(CONTROL_TYPE_TIMER, 0)));
+    TEST_ASSERT_EQUAL_UINT8(4, queue->size(MOA_EVENT_LANE_NORMAL));
+}
+
+void test_battery_stop_supersedes_pending_levels() {
+    queue->push(makeEvent(CONTROL_TYPE_BATTERY, COMMAND_BATT_LEVEL_MEDIUM));
+    queue->push(makeEvent(CONTROL_TYPE_BUTTON, COMMAND_BUTTON_25, BUTTON_EVENT_PRESS));
+    queue->push(makeEvent(CONTROL_TYPE_BATTERY, COMMAND_BATT_LEVEL_LOW));
+    queue->push(makeEvent(CONTROL_TYPE_BATTERY, COMMAND_BATT_LEVEL_STOP));
+
+    TEST_ASSERT_EQUAL_UINT32(2, queue->getCounters(MOA_EVENT_SOURCE_BATTERY).superseded);
+    ControlCommand cmd;
+    queue->pop(cmd);
+    TEST_ASSERT_EQUAL(COMMAND_BATT_LEVEL_STOP, cmd.commandType);
+    queue->pop(cmd);
+    TEST_ASSERT_EQUAL(CONTROL_TYPE_BUTTON, cmd.controlType);   // Others keep their order
+    TEST_ASSERT_FALSE(queue->pop(cmd));
+}
+
+void test_full_normal_lane_drops_and_counts() {
+    for (uint8_t i = 0; i < MOA_EVENT_NORMAL_DEPTH; i++) {
+        TEST_ASSERT_EQUAL(MOA_EVENT_QUEUED, queue->push(makeEvent(CONTROL_TYPE_BUTTON, COMMAND_BUTTON_50, BUTTON_EVENT_PRESS)));
+    }
+    TEST_ASSERT_EQUAL(MOA_EVENT_DROPPED, queue->push(makeEvent(CONTROL_TYPE_TIMER, 1)));
+    TEST_ASSERT_EQUAL_UINT32(1, queue->getCounters(MOA_EVENT_SOURCE_TIMER).dropped);
+    TEST_ASSERT_EQUAL_UINT8(MOA_EVENT_NORMAL_DEPTH, queue->getHighWater(MOA_EVENT_LANE_NORMAL));
+
+    // UI traffic cannot take the safety lane's room
+    TEST_ASSERT_EQUAL(MOA_EVENT_QUEUED, queue->push(makeEvent(CONTROL_TYPE_CURRENT, COMMAND_CURRENT_OVERCURRENT)));
+
+    queue->resetCounters();
+    TEST_ASSERT_EQUAL_UINT32(0, queue->getCounters(MOA_EVENT_SOURCE_TIMER).dropped);
+    TEST_ASSERT_EQUAL_UINT8(MOA_EVENT_NORMAL_DEPTH, queue->getHighWater(MOA_EVENT_LANE_NORMAL));
+}
+
+void test_typed_views_survive_the_queue() {
+    // Full ranges of the 16-bit payload: negative temperature and current, pack voltage above 32.767 V
+    queue->push(TempEvent(COMMAND_TEMP_CROSSED_BELOW, -125));
+    queue->push(BattEvent(COMMAND_BATT_LEVEL_HIGH, 50400));
+    queue->push(CurrentEvent(COMMAND_CURRENT_REVERSE_OVERCURRENT, -1850));
+    queue->push(ButtonEvent(COMMAND_BUTTON_75, BUTTON_EVENT_VERY_LONG_PRESS));
+    queue->push(TimerEvent(7));
+
+    ControlCommand cmd;
+    TEST_ASSERT_EQUAL_UINT32(4, sizeof(cmd));
+    TEST_ASSERT_TRUE(queue->pop(cmd));
+    TEST_ASSERT_EQUAL(CONTROL_TYPE_TEMPERATURE, cmd.controlType);
+    TEST_ASSERT_EQUAL_INT16(-125, TempEvent(cmd).getDeciCelsius());
+    TEST_ASSERT_TRUE(queue->pop(cmd));
+    TEST_ASSERT_EQUAL(CONTROL_TYPE_CURRENT, cmd.controlType);
+    TEST_ASSERT_EQUAL(COMMAND_CURRENT_REVERSE_OVERCURRENT, CurrentEvent(cmd).getCommand());
+    TEST_ASSERT_EQUAL_INT16(-1850, CurrentEvent(cmd).getDeciAmps());
+    TEST_ASSERT_TRUE(queue->pop(cmd));
+    TEST_ASSERT_EQUAL(CONTROL_TYPE_BATTERY, cmd.controlType);
+    TEST_ASSERT_EQUAL(COMMAND_BATT_LEVEL_HIGH, BattEvent(cmd).getLevel());
+    TEST_ASSERT_EQUAL_UINT16(50400, BattEvent(cmd).getMillivolts());
+    TEST_ASSERT_TRUE(queue->pop(cmd));
+    TEST_ASSERT_EQUAL(COMMAND_BUTTON_75, ButtonEvent(cmd).getButtonId());
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_VERY_LONG_PRESS, ButtonEvent(cmd).getEventType());
+    TEST_ASSERT_TRUE(queue->pop(cmd));
+    TEST_ASSERT_EQUAL(7, TimerEvent(cmd).getTimerId());
+}
+
+void test_remote_setpoints_coalesced_disarm_first() {
+    queue->push(RemoteEvent(COMMAND_REMOTE_ARM, 0));
+    queue->push(RemoteEvent(COMMAND_REMOTE_THROTTLE, 80));
+    TEST_ASSERT_EQUAL(MOA_EVENT_COALESCED, queue->push(RemoteEvent(COMMAND_REMOTE_THROTTLE, 90)));
+    TEST_ASSERT_EQUAL(2, queue->size(MOA_EVENT_LANE_NORMAL));
+
+    ControlCommand cmd;
+    TEST_ASSERT_TRUE(queue->pop(cmd));
+    TEST_ASSERT_EQUAL(COMMAND_REMOTE_ARM, RemoteEvent(cmd).getCommand());
+    TEST_ASSERT_TRUE(queue->pop(cmd));
+    TEST_ASSERT_EQUAL_UINT16(90, RemoteEvent(cmd).getDuty());
+
+    // A disarm jumps the queue and drops the setpoint it overrides
+    queue->push(RemoteEvent(COMMAND_REMOTE_THROTTLE, 95));
+    TEST_ASSERT_EQUAL(MOA_EVENT_LANE_SAFETY, MoaEventQueue::laneOf(RemoteEvent(COMMAND_REMOTE_DISARM, 0)));
+    queue->push(RemoteEvent(COMMAND_REMOTE_DISARM, 0));
+    TEST_ASSERT_EQUAL(1, queue->size());
+    TEST_ASSERT_TRUE(queue->pop(cmd));
+    TEST_ASSERT_EQUAL(COMMAND_REMOTE_DISARM, RemoteEvent(cmd).getCommand());
+    TEST_ASSERT_EQUAL_UINT32(1, queue->getCounters(MOA_EVENT_SOURCE_REMOTE).superseded);
+}
+
+void test_flood_never_loses_safety_events() {
+    // Seeded xorshift so the run is reproducible
+    uint32_t seed = 0x2545F491UL;
+    const int SAFETY_TYPES[][2] = {
+        { CONTROL_TYPE_CURRENT, COMMAND_CURRENT_OVERCURRENT },
+        { CONTROL_TYPE_CURRENT, COMMAND_CURRENT_NORMAL },
+        { CONTROL_TYPE_TEMPERATURE, COMMAND_TEMP_CROSSED_ABOVE },
+        { CONTROL_TYPE_TEMPERATURE, COMMAND_TEMP_CROSSED_BELOW },
+        { CONTROL_TYPE_BATTERY, COMMAND_BATT_LEVEL_STOP },
+    };
+
+    // Last accepted / received sensor command per producer
+    int lastPushed[MOA_EVENT_SOURCE_COUNT] = {0};
+    int lastReceived[MOA_EVENT_SOURCE_COUNT] = {0};
+    uint32_t pushes[MOA_EVENT_SOURCE_COUNT] = {0};
+    uint32_t received = 0;
+    uint32_t safetyPushes = 0;
+
+    for (uint32_t step = 0; step < 200000; step++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+
+        // Bursts of 1..8 UI events per step outrun a consumer that takes one every other step
+        uint8_t burst = 1 + (seed & 7);
+        for (uint8_t b = 0; b < burst; b++) {
+            ControlCommand ui = ((seed >> (8 + b)) & 1)
+                ? makeEvent(CONTROL_TYPE_BUTTON, COMMAND_BUTTON_STOP + (b % 5), BUTTON_EVENT_PRESS)
+                : makeEvent(CONTROL_TYPE_TIMER, b % 2);
+            queue->push(ui);
+            pushes[MoaEventQueue::sourceOf(ui)]++;
+        }
+
+        // A sensor event on one step in four: repeats of the same state and real transitions
+        if (((seed >> 20) & 3) == 0) {
+            const int* type = SAFETY_TYPES[(seed >> 23) % 5];
+            ControlCommand safety = makeEvent(type[0], type[1], static_cast<int>(step));
+            MoaEventSource source = MoaEventQueue::sourceOf(safety);
+            TEST_ASSERT_TRUE(queue->push(safety) != MOA_EVENT_DROPPED);
+            lastPushed[source] = type[1];
+            pushes[source]++;
+            safetyPushes++;
+        }
+        if (((seed >> 26) & 7) == 0) {
+            // Normal lane: may be dropped in the flood, then the previous state stands
+            if (queue->push(makeEvent(CONTROL_TYPE_BATTERY, COMMAND_BATT_LEVEL_LOW)) != MOA_EVENT_DROPPED) {
+                lastPushed[MOA_EVENT_SOURCE_BATTERY] = COMMAND_BATT_LEVEL_LOW;
+            }
+            pushes[MOA_EVENT_SOURCE_BATTERY]++;
+        }
+
+        if (step & 1) {
+            ControlCommand cmd;
+            if (queue->pop(cmd)) {
+                received++;
+                if (MoaEventQueue::isCoalescable(cmd)) {
+                    lastReceived[MoaEventQueue::sourceOf(cmd)] = cmd.commandType;
+                }
+            }
+        }
+    }
+
+    ControlCommand cmd;
+    while (queue->pop(cmd)) {
+        received++;
+        if (MoaEventQueue::isCoalescable(cmd)) {
+            lastReceived[MoaEventQueue::sourceOf(cmd)] = cmd.commandType;
+        }
+    }
+
+    TEST_ASSERT_TRUE(safetyPushes > 40000);
+    uint32_t queued = 0;
+    for (uint8_t s = 0; s < MOA_EVENT_SOURCE_COUNT; s++) {
+        const MoaEventCounters& c = queue->getCounters(static_cast<MoaEventSource>(s));
+        // Every push accounted for
+        TEST_ASSERT_EQUAL_UINT32(pushes[s], c.queued + c.coalesced + c.dropped);
+        queued += c.queued - c.superseded;
+        // The consumer ends on each sensor's last accepted state
+        TEST_ASSERT_EQUAL(lastPushed[s], lastReceived[s]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, queue->getCounters(MOA_EVENT_SOURCE_CURRENT).dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, queue->getCounters(MOA_EVENT_SOURCE_TEMPERATURE).dropped);
+    TEST_ASSERT_TRUE(queue->getCounters(MOA_EVENT_SOURCE_BUTTON).dropped > 0);     // The flood did overflow
+    TEST_ASSERT_EQUAL_UINT32(queued, received);
+    TEST_ASSERT_TRUE(queue->getHighWater(MOA_EVENT_LANE_SAFETY) <= MOA_EVENT_SAFETY_DEPTH);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_lanes);
+    RUN_TEST(test_safety_served_first_fifo_within_lane);
+    RUN_TEST(test_repeated_sensor_event_coalesced_in_place);
+    RUN_TEST(test_transitions_are_not_coalesced_out_of_order);
+    RUN_TEST(test_buttons_and_timers_never_coalesced);
+    RUN_TEST(test_battery_stop_supersedes_pending_levels);
+    RUN_TEST(test_full_normal_lane_drops_and_counts);
+    RUN_TEST(test_typed_views_survive_the_queue);
+    RUN_TEST(test_remote_setpoints_coalesced_disarm_first);
+    RUN_TEST(test_flood_never_loses_safety_events);
+
+    return UNITY_END();
+}
@@ -0,0 +1,158 @@
+/**
+ * @file test_fixed_point.cpp
+ * @brief Host tests and cycle-count benchmark for MoaFixedScale
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Checks the folded integer conversions against the float formulas that
+ * MoaCurrentControl::adcToCurrent() and MoaBattControl::adcToVoltage()
+ * used before, over the whole 12-bit range, and benchmarks both paths.
+ *
+ * The host has an FPU, so the speed-up measured here understates the gain
+ * on the ESP32-C3 (soft-float); see test/test_fixed_point_bench for the
+ * on-target cycle counts.
+ *
+ * Run with: pio test -e native -f native/test_fixed_point
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Constants.h"
+#include "MoaFixedPoint.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t cycleCount() { return __rdtsc(); }
+#else
+#include <chrono>
+static inline uint64_t cycleCount() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+static const float VREF = ADC_REFERENCE_VOLTAGE;
+static const float MAX_ADC = static_cast<float>((1 << ADC_RESOLUTION_BITS) - 1);
+
+/**
+ * @brief Reference: previous MoaCurrentControl::adcToCurrent() (A)
+ */
+static float legacyCurrent(uint16_t raw, float sensitivity, float offset) {
+    float adcVoltage = (static_cast<float>(raw) / MAX_ADC) * VREF;
+    return (adcVoltage - offset) / sensitivity;
+}
+
+/**
+ * @brief Reference: previous MoaBattControl::adcToVoltage() (V)
+ */
+static float legacyVoltage(uint16_t raw, float ratio) {
+    float adcVoltage = (static_cast<float>(raw) / MAX_ADC) * VREF;
+    return adcVoltage * ratio;
+}
+
+static MoaFixedScale currentScale(float sensitivity, float offset) {
+    return MoaFixedScale::fromFloat(VREF * 1000.0f / (MAX_ADC * sensitivity),
+                                    -offset * 1000.0f / sensitivity);
+}
+
+static MoaFixedScale voltageScale(float ratio) {
+    return MoaFixedScale::fromFloat(VREF * ratio * 1000.0f / MAX_ADC, 0.0f);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_current_matches_float_over_full_range() {
+    MoaFixedScale scale = currentScale(CURRENT_SENSOR_SENSITIVITY, CURRENT_SENSOR_OFFSET);
+    for (uint32_t raw = 0; raw <= static_cast<uint32_t>(MAX_ADC); raw++) {
+        float expectedMa = legacyCurrent(raw, CURRENT_SENSOR_SENSITIVITY, CURRENT_SENSOR_OFFSET) * 1000.0f;
+        // Folding rounds the offset to 1 mA and the gain to 2^-16 mA/code
+        TEST_ASSERT_FLOAT_WITHIN(2.0f, expectedMa, static_cast<float>(scale.apply(raw)));
+    }
+}
+
+void test_voltage_matches_float_over_full_range() {
+    MoaFixedScale scale = voltageScale(BATT_DIVIDER_RATIO);
+    for (uint32_t raw = 0; raw <= static_cast<uint32_t>(MAX_ADC); raw++) {
+        float expectedMv = legacyVoltage(raw, BATT_DIVIDER_RATIO) * 1000.0f;
+        TEST_ASSERT_FLOAT_WITHIN(1.0f, expectedMv, static_cast<float>(scale.apply(raw)));
+    }
+}
+
+void test_current_sign_around_zero_offset() {
+    MoaFixedScale scale = currentScale(CURRENT_SENSOR_SENSITIVITY, CURRENT_SENSOR_OFFSET);
+    uint16_t mid = static_cast<uint16_t>(CURRENT_SENSOR_OFFSET / VREF * MAX_ADC + 0.5f);
+    // One code is ~122 mA on the ACS759-200B
+    TEST_ASSERT_INT_WITHIN(122, 0, scale.apply(mid));
+    TEST_ASSERT_TRUE(scale.apply(mid + 10) > 0);
+    TEST_ASSERT_TRUE(scale.apply(mid - 10) < 0);
+}
+
+void test_div_round() {
+    TEST_ASSERT_EQUAL_INT32(1255, moaDivRound(125549, 100));
+    TEST_ASSERT_EQUAL_INT32(1256, moaDivRound(125550, 100));
+    TEST_ASSERT_EQUAL_INT32(-1255, moaDivRound(-125549, 100));
+    TEST_ASSERT_EQUAL_INT32(-1256, moaDivRound(-125550, 100));
+    TEST_ASSERT_EQUAL_INT32(0, moaDivRound(4, 10));
+    TEST_ASSERT_EQUAL_INT32(255, moaDivRound(2550, 10));
+}
+
+void test_to_fixed_units() {
+    TEST_ASSERT_EQUAL_INT32(150000, moaToFixedUnits(150.0f, 1000));
+    TEST_ASSERT_EQUAL_INT32(-150000, moaToFixedUnits(-150.0f, 1000));
+    TEST_ASSERT_EQUAL_INT32(3300, moaToFixedUnits(3.3f, 1000));
+    TEST_ASSERT_EQUAL_INT32(6000, moaToFixedUnits(60.0f, 100));
+}
+
+void test_benchmark_against_float() {
+    const int iterations = 1000000;
+    volatile int32_t isink = 0;
+    volatile float fsink = 0.0f;
+    volatile float sensitivity = CURRENT_SENSOR_SENSITIVITY;  // Keep the divide at runtime
+    volatile float offset = CURRENT_SENSOR_OFFSET;
+
+    MoaFixedScale scale = currentScale(sensitivity, offset);
+
+    // Previous path: float conversion, then "* 10.0f" for the event/stats value
+    uint64_t c0 = cycleCount();
+    for (int i = 0; i < iterations; i++) {
+        float amps = legacyCurrent(static_cast<uint16_t>(i & 0xFFF), sensitivity, offset);
+        fsink = amps;
+        isink = static_cast<int32_t>(amps * 10.0f);
+    }
+    uint64_t c1 = cycleCount();
+    // Fixed-point path: raw -> mA, then mA -> A x10
+    for (int i = 0; i < iterations; i++) {
+        int32_t ma = scale.apply(i & 0xFFF);
+        isink = ma;
+        isink = moaDivRound(ma, 100);
+    }
+    uint64_t c2 = cycleCount();
+    (void)isink;
+    (void)fsink;
+
+    double floatCycles = static_cast<double>(c1 - c0) / iterations;
+    double fixedCycles = static_cast<double>(c2 - c1) / iterations;
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "host: float=%.1f cycles/sample fixed=%.1f cycles/sample (%.1fx)",
+             floatCycles, fixedCycles, floatCycles / fixedCycles);
+    TEST_MESSAGE(msg);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_current_matches_float_over_full_range);
+    RUN_TEST(test_voltage_matches_float_over_full_range);
+    RUN_TEST(test_current_sign_around_zero_offset);
+    RUN_TEST(test_div_round);
+    RUN_TEST(test_to_fixed_units);
+    RUN_TEST(test_benchmark_against_float);
+
+    return UNITY_END();
+}
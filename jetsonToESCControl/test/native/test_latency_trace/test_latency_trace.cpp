@@ -0,0 +1,179 @@
+/**
+ * @file test_latency_trace.cpp
+ * @brief Host tests for MoaLatencyTrace (control path latency histograms)
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Drives the trace with explicit timestamps: histogram bucketing and
+ * percentiles, per-hop and end-to-end recording of a button chain, and the
+ * rules that keep one input in flight at a time (ignored second input,
+ * stale restart, origin-filtered marks and drops).
+ *
+ * Run with: pio test -e native -f native/test_latency_trace
+ */
+
+#include <unity.h>
+#include "MoaLatencyTrace.h"
+
+static MoaLatencyTrace* trace;
+
+static MoaLatencyHistogram histogram(MoaLatencyHop hop) {
+    MoaLatencyHistogram h;
+    TEST_ASSERT_TRUE(trace->getHistogram(hop, h));
+    return h;
+}
+
+/**
+ * @brief Button press to first ramp step, hops at the given times (us)
+ */
+static void runButtonChain(uint32_t startUs) {
+    trace->begin(MOA_HOP_BUTTON_EDGE, startUs);
+    trace->mark(MOA_HOP_PROCESS, startUs + 300, MOA_HOP_BUTTON_EDGE);
+    trace->mark(MOA_HOP_PUSH, startUs + 450, MOA_HOP_BUTTON_EDGE);
+    trace->mark(MOA_HOP_RECEIVE, startUs + 470);
+    trace->mark(MOA_HOP_STATE, startUs + 600);
+    trace->mark(MOA_HOP_SET_DUTY, startUs + 650);
+    trace->mark(MOA_HOP_PWM, startUs + 12650);
+}
+
+void setUp(void) {
+    trace = new MoaLatencyTrace();
+}
+
+void tearDown(void) {
+    delete trace;
+}
+
+void test_histogram_buckets_and_percentiles() {
+    MoaLatencyHistogram h;
+    h.clear();
+    h.add(0);
+    h.add(1);
+    h.add(3);
+    h.add(1000);
+    h.add(0xFFFFFFFFUL);
+
+    TEST_ASSERT_EQUAL_UINT32(5, h.count);
+    TEST_ASSERT_EQUAL_UINT32(1, h.buckets[0]);                          // 0
+    TEST_ASSERT_EQUAL_UINT32(1, h.buckets[1]);                          // [1, 2)
+    TEST_ASSERT_EQUAL_UINT32(1, h.buckets[2]);                          // [2, 4)
+    TEST_ASSERT_EQUAL_UINT32(1, h.buckets[10]);                         // [512, 1024)
+    TEST_ASSERT_EQUAL_UINT32(1, h.buckets[MOA_LATENCY_BUCKETS - 1]);    // Open-ended
+    TEST_ASSERT_EQUAL_UINT32(0, h.minUs);
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFFUL, h.maxUs);
+
+    h.clear();
+    for (uint32_t i = 0; i < 99; i++) {
+        h.add(100);                     // [64, 128)
+    }
+    h.add(5000);                        // [4096, 8192)
+    TEST_ASSERT_EQUAL_UINT32(127, h.percentileUs(50));
+    TEST_ASSERT_EQUAL_UINT32(127, h.percentileUs(99));
+    TEST_ASSERT_EQUAL_UINT32(5000, h.percentileUs(100));  // Capped at max
+    TEST_ASSERT_EQUAL_UINT32(149, h.meanUs());
+}
+
+void test_button_chain_records_each_hop_and_total() {
+    runButtonChain(1000);
+
+    TEST_ASSERT_EQUAL_UINT32(300, histogram(MOA_HOP_PROCESS).maxUs);
+    TEST_ASSERT_EQUAL_UINT32(150, histogram(MOA_HOP_PUSH).maxUs);
+    TEST_ASSERT_EQUAL_UINT32(20, histogram(MOA_HOP_RECEIVE).maxUs);
+    TEST_ASSERT_EQUAL_UINT32(130, histogram(MOA_HOP_STATE).maxUs);
+    TEST_ASSERT_EQUAL_UINT32(50, histogram(MOA_HOP_SET_DUTY).maxUs);
+    TEST_ASSERT_EQUAL_UINT32(12000, histogram(MOA_HOP_PWM).maxUs);
+    TEST_ASSERT_EQUAL_UINT32(1, histogram(MOA_HOP_BUTTON_EDGE).count);
+    TEST_ASSERT_EQUAL_UINT32(12650, histogram(MOA_HOP_BUTTON_EDGE).maxUs);
+    TEST_ASSERT_EQUAL_UINT32(1, trace->getCompletedCount());
+
+    // Later ramp steps are not part of the chain
+    trace->mark(MOA_HOP_PWM, 40000);
+    TEST_ASSERT_EQUAL_UINT32(1, histogram(MOA_HOP_PWM).count);
+}
+
+void test_hops_skipped_or_repeated() {
+    // STOP: the state handler writes the PWM directly, no setThrottleDuty
+    trace->begin(MOA_HOP_SENSOR_SAMPLE, 0);
+    trace->mark(MOA_HOP_PUSH, 100, MOA_HOP_SENSOR_SAMPLE);
+    trace->mark(MOA_HOP_RECEIVE, 200);
+    trace->mark(MOA_HOP_RECEIVE, 250);      // Repeated hop ignored
+    trace->mark(MOA_HOP_PWM, 400);
+
+    TEST_ASSERT_EQUAL_UINT32(1, histogram(MOA_HOP_RECEIVE).count);
+    TEST_ASSERT_EQUAL_UINT32(0, histogram(MOA_HOP_SET_DUTY).count);
+    TEST_ASSERT_EQUAL_UINT32(200, histogram(MOA_HOP_PWM).maxUs);
+    TEST_ASSERT_EQUAL_UINT32(400, histogram(MOA_HOP_SENSOR_SAMPLE).maxUs);
+}
+
+void test_one_input_in_flight() {
+    trace->begin(MOA_HOP_BUTTON_EDGE, 0);
+    trace->begin(MOA_HOP_ADC_DRAIN, 100);                   // Not traced
+    trace->mark(MOA_HOP_PWM, 200, MOA_HOP_ADC_DRAIN);       // Trip write of the untraced drain
+    trace->mark(MOA_HOP_PUSH, 300, MOA_HOP_SENSOR_SAMPLE);  // Another producer's event
+
+    TEST_ASSERT_EQUAL_UINT32(0, histogram(MOA_HOP_PWM).count);
+    TEST_ASSERT_EQUAL_UINT32(0, histogram(MOA_HOP_PUSH).count);
+
+    trace->mark(MOA_HOP_PROCESS, 500, MOA_HOP_BUTTON_EDGE);
+    TEST_ASSERT_EQUAL_UINT32(500, histogram(MOA_HOP_PROCESS).maxUs);
+}
+
+void test_stale_chain_restarted_by_next_input() {
+    trace->begin(MOA_HOP_BUTTON_EDGE, 0);
+    trace->mark(MOA_HOP_PROCESS, 100, MOA_HOP_BUTTON_EDGE);
+    trace->begin(MOA_HOP_BUTTON_EDGE, MOA_LATENCY_STALE_US - 1);    // Still in flight
+    TEST_ASSERT_EQUAL_UINT32(0, trace->getDroppedCount());
+
+    runButtonChain(MOA_LATENCY_STALE_US + 100);
+    TEST_ASSERT_EQUAL_UINT32(1, trace->getDroppedCount());
+    TEST_ASSERT_EQUAL_UINT32(12650, histogram(MOA_HOP_BUTTON_EDGE).maxUs);
+}
+
+void test_release_drops_only_its_origin() {
+    // A quiet sensor cycle ends without counting as a drop
+    trace->begin(MOA_HOP_SENSOR_SAMPLE, 0);
+    trace->release(MOA_HOP_SENSOR_SAMPLE, MOA_HOP_PUSH);
+    TEST_ASSERT_EQUAL_UINT32(0, trace->getDroppedCount());
+
+    // A release edge reaches processInterrupt but pushes nothing
+    trace->begin(MOA_HOP_BUTTON_EDGE, 1000);
+    trace->mark(MOA_HOP_PROCESS, 1200, MOA_HOP_BUTTON_EDGE);
+    trace->release(MOA_HOP_ADC_DRAIN, MOA_HOP_PWM);        // Other origin: kept
+    trace->release(MOA_HOP_BUTTON_EDGE, MOA_HOP_PROCESS);  // Already reached: kept
+    trace->mark(MOA_HOP_PUSH, 1300, MOA_HOP_BUTTON_EDGE);
+    TEST_ASSERT_EQUAL_UINT32(1, histogram(MOA_HOP_PUSH).count);
+
+    trace->release(MOA_HOP_ANY, MOA_HOP_SET_DUTY);         // Event changed nothing
+    TEST_ASSERT_EQUAL_UINT32(1, trace->getDroppedCount());
+
+    // The next input is traced right away
+    runButtonChain(5000);
+    TEST_ASSERT_EQUAL_UINT32(1, trace->getCompletedCount());
+}
+
+void test_reset_clears_histograms() {
+    runButtonChain(0);
+    trace->begin(MOA_HOP_BUTTON_EDGE, 20000);
+    TEST_ASSERT_TRUE(trace->reset());
+
+    TEST_ASSERT_EQUAL_UINT32(0, trace->getCompletedCount());
+    TEST_ASSERT_EQUAL_UINT32(0, histogram(MOA_HOP_PWM).count);
+    TEST_ASSERT_EQUAL_UINT32(0, histogram(MOA_HOP_BUTTON_EDGE).count);
+
+    trace->mark(MOA_HOP_PROCESS, 20100, MOA_HOP_BUTTON_EDGE);     // Chain in flight was cleared too
+    TEST_ASSERT_EQUAL_UINT32(0, histogram(MOA_HOP_PROCESS).count);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_histogram_buckets_and_percentiles);
+    RUN_TEST(test_button_chain_records_each_hop_and_total);
+    RUN_TEST(test_hops_skipped_or_repeated);
+    RUN_TEST(test_one_input_in_flight);
+    RUN_TEST(test_stale_chain_restarted_by_next_input);
+    RUN_TEST(test_release_drops_only_its_origin);
+    RUN_TEST(test_reset_clears_histograms);
+
+    return UNITY_END();
+}
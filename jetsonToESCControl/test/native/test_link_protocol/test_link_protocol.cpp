@@ -0,0 +1,462 @@
+/**
+ * @file test_link_protocol.cpp
+ * @brief Host tests for the Jetson link protocol (CRC, COBS, decoder, session)
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Checks the codec against reference vectors, the decoder's recovery from
+ * corrupt, truncated and over-long frames, and the session's dispatch,
+ * retry deduplication and sequence accounting. The last test runs a
+ * session behind a pseudo-terminal in raw mode, as the host side of the
+ * link would see a serial port.
+ *
+ * Run with: pio test -e native -f native/test_link_protocol
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+#include "MoaLinkProtocol.h"
+#include "MoaEventQueue.h"
+#include "ControlCommand.h"
+
+/**
+ * @brief Handler double: records requests, captures replies
+ */
+class RecordingHandler : public IMoaLinkHandler {
+public:
+    uint32_t throttles = 0;
+    uint16_t lastDuty = 0;
+    uint32_t arms = 0;
+    uint32_t disarms = 0;
+    uint8_t status = MOA_LINK_STATUS_OK;
+    std::vector<uint8_t> written;
+    int fd = -1;                    ///< Write replies here when set (pty test)
+    MoaEventQueue* events = nullptr; ///< Disarms go here when set, BUSY when its lane is full
+
+    uint8_t onThrottle(uint16_t duty) override { throttles++; lastDuty = duty; return status; }
+    uint8_t onArm() override { arms++; return status; }
+    uint8_t onDisarm() override {
+        disarms++;
+        if (events != nullptr) {
+            return (events->push(RemoteEvent(COMMAND_REMOTE_DISARM, 0)) == MOA_EVENT_DROPPED)
+                ? MOA_LINK_STATUS_BUSY : MOA_LINK_STATUS_OK;
+        }
+        return status;
+    }
+
+    void onTelemetry(MoaLinkTelemetry& out) override {
+        memset(&out, 0, sizeof(out));
+        out.state = 2;
+        out.escDuty = 1229;
+        out.battMillivolts = 24150;
+        out.currentDeciAmps = -35;
+        out.uptimeMs = 123456;
+    }
+
+    void writeLink(const uint8_t* data, size_t length) override {
+        if (fd >= 0) {
+            TEST_ASSERT_EQUAL((ssize_t)length, write(fd, data, length));
+        } else {
+            written.insert(written.end(), data, data + length);
+        }
+    }
+};
+
+static RecordingHandler* handler;
+static MoaLinkSession* session;
+
+/**
+ * @brief Encode a request and feed it to the session
+ */
+static void sendFrame(uint8_t seq, uint8_t type, const uint8_t* payload = nullptr, uint8_t length = 0) {
+    uint8_t wire[MOA_LINK_MAX_ENCODED];
+    size_t n = MoaLinkCodec::encodeFrame(seq, type, payload, length, wire, sizeof(wire));
+    TEST_ASSERT_TRUE(n > 0);
+    session->receive(wire, n);
+}
+
+static void sendThrottle(uint8_t seq, uint16_t duty) {
+    uint8_t payload[2] = { static_cast<uint8_t>(duty & 0xFF), static_cast<uint8_t>(duty >> 8) };
+    sendFrame(seq, MOA_LINK_MSG_THROTTLE, payload, 2);
+}
+
+/**
+ * @brief Decode every reply written since the last call
+ */
+static size_t takeReplies(MoaLinkFrame* out, size_t max) {
+    MoaLinkDecoder decoder;
+    size_t n = 0;
+    for (uint8_t b : handler->written) {
+        if (n < max && decoder.push(b, out[n])) {
+            n++;
+        }
+    }
+    handler->written.clear();
+    return n;
+}
+
+void setUp(void) {
+    handler = new RecordingHandler();
+    session = new MoaLinkSession(*handler);
+}
+
+void tearDown(void) {
+    delete session;
+    delete handler;
+}
+
+// =============================================================================
+// Codec
+// =============================================================================
+
+void test_crc16_reference_vector(void) {
+    const uint8_t check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, MoaLinkCodec::crc16(check, sizeof(check)));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, MoaLinkCodec::crc16(check, 0));
+}
+
+void test_cobs_vectors_round_trip(void) {
+    struct Vector {
+        uint8_t in[4];
+        size_t inLength;
+        uint8_t out[6];
+        size_t outLength;
+    };
+    static const Vector vectors[] = {
+        { { 0x00 }, 1, { 0x01, 0x01 }, 2 },
+        { { 0x00, 0x00 }, 2, { 0x01, 0x01, 0x01 }, 3 },
+        { { 0x11, 0x22, 0x00, 0x33 }, 4, { 0x03, 0x11, 0x22, 0x02, 0x33 }, 5 },
+        { { 0x11, 0x00, 0x00, 0x00 }, 4, { 0x02, 0x11, 0x01, 0x01, 0x01 }, 5 },
+    };
+    for (const Vector& v : vectors) {
+        uint8_t encoded[8];
+        uint8_t decoded[8];
+        size_t n = MoaLinkCodec::cobsEncode(v.in, v.inLength, encoded);
+        TEST_ASSERT_EQUAL(v.outLength, n);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(v.out, encoded, n);
+        TEST_ASSERT_EQUAL(v.inLength, MoaLinkCodec::cobsDecode(encoded, n, decoded));
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(v.in, decoded, v.inLength);
+    }
+
+    // 254 non-zero bytes fill one block exactly
+    uint8_t block[254];
+    uint8_t encoded[258];
+    uint8_t decoded[258];
+    for (size_t i = 0; i < sizeof(block); i++) {
+        block[i] = static_cast<uint8_t>(i + 1);
+    }
+    size_t n = MoaLinkCodec::cobsEncode(block, sizeof(block), encoded);
+    TEST_ASSERT_EQUAL(255, n);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, encoded[0]);
+    TEST_ASSERT_EQUAL(sizeof(block), MoaLinkCodec::cobsDecode(encoded, n, decoded));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(block, decoded, sizeof(block));
+}
+
+void test_cobs_rejects_invalid_block(void) {
+    const uint8_t zeroInside[] = { 0x03, 0x11, 0x00 };
+    const uint8_t codePastEnd[] = { 0x05, 0x11, 0x22 };
+    uint8_t out[8];
+    TEST_ASSERT_EQUAL(0, MoaLinkCodec::cobsDecode(zeroInside, sizeof(zeroInside), out));
+    TEST_ASSERT_EQUAL(0, MoaLinkCodec::cobsDecode(codePastEnd, sizeof(codePastEnd), out));
+}
+
+void test_encode_frame_limits(void) {
+    uint8_t payload[MOA_LINK_MAX_PAYLOAD + 1] = {};
+    uint8_t wire[MOA_LINK_MAX_ENCODED];
+    size_t n = MoaLinkCodec::encodeFrame(1, MOA_LINK_MSG_PING, payload, MOA_LINK_MAX_PAYLOAD, wire, sizeof(wire));
+    TEST_ASSERT_TRUE(n > 0 && n <= MOA_LINK_MAX_ENCODED);
+    TEST_ASSERT_EQUAL_HEX8(0x00, wire[n - 1]);
+    for (size_t i = 0; i < n - 1; i++) {
+        TEST_ASSERT_TRUE(wire[i] != 0);
+    }
+    TEST_ASSERT_EQUAL(0, MoaLinkCodec::encodeFrame(1, MOA_LINK_MSG_PING, payload, MOA_LINK_MAX_PAYLOAD + 1,
+                                                   wire, sizeof(wire)));
+    TEST_ASSERT_EQUAL(0, MoaLinkCodec::encodeFrame(1, MOA_LINK_MSG_PING, nullptr, 0, wire, 4));
+}
+
+// =============================================================================
+// Decoder
+// =============================================================================
+
+void test_decoder_counts_errors_and_resyncs(void) {
+    MoaLinkDecoder decoder;
+    MoaLinkFrame frame;
+    uint8_t wire[MOA_LINK_MAX_ENCODED];
+    const uint8_t duty[2] = { 0x4C, 0x00 };
+    size_t n = MoaLinkCodec::encodeFrame(7, MOA_LINK_MSG_THROTTLE, duty, 2, wire, sizeof(wire));
+
+    // Flipped payload bit: CRC error
+    wire[3] ^= 0x01;
+    for (size_t i = 0; i < n; i++) {
+        TEST_ASSERT_FALSE(decoder.push(wire[i], frame));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, decoder.getCrcErrors());
+    wire[3] ^= 0x01;
+
+    // Tail of a frame cut off by a reset of the sender, then a good frame
+    TEST_ASSERT_FALSE(decoder.push(0x05, frame));
+    TEST_ASSERT_FALSE(decoder.push(0x11, frame));
+    TEST_ASSERT_FALSE(decoder.push(0x00, frame));
+    TEST_ASSERT_EQUAL_UINT32(1, decoder.getFramingErrors());
+
+    bool got = false;
+    for (size_t i = 0; i < n; i++) {
+        got = decoder.push(wire[i], frame);
+    }
+    TEST_ASSERT_TRUE(got);
+    TEST_ASSERT_EQUAL_UINT8(7, frame.seq);
+    TEST_ASSERT_EQUAL_UINT8(MOA_LINK_MSG_THROTTLE, frame.type);
+    TEST_ASSERT_EQUAL_UINT8(2, frame.length);
+    TEST_ASSERT_EQUAL_HEX8(0x4C, frame.payload[0]);
+
+    // Line noise longer than any frame: one overrun, then back in sync
+    for (int i = 0; i < 3 * MOA_LINK_MAX_ENCODED; i++) {
+        TEST_ASSERT_FALSE(decoder.push(0x55, frame));
+    }
+    TEST_ASSERT_FALSE(decoder.push(0x00, frame));
+    TEST_ASSERT_EQUAL_UINT32(1, decoder.getOverruns());
+    got = false;
+    for (size_t i = 0; i < n; i++) {
+        got = decoder.push(wire[i], frame);
+    }
+    TEST_ASSERT_TRUE(got);
+
+    // Back-to-back delimiters are idle line, not errors
+    TEST_ASSERT_FALSE(decoder.push(0x00, frame));
+    TEST_ASSERT_FALSE(decoder.push(0x00, frame));
+    TEST_ASSERT_EQUAL_UINT32(1, decoder.getFramingErrors());
+}
+
+// =============================================================================
+// Session
+// =============================================================================
+
+void test_session_dispatches_and_acks(void) {
+    MoaLinkFrame replies[4];
+    sendFrame(1, MOA_LINK_MSG_ARM);
+    sendThrottle(2, 77);
+    sendFrame(3, MOA_LINK_MSG_PING);
+    sendFrame(4, MOA_LINK_MSG_DISARM);
+
+    TEST_ASSERT_EQUAL_UINT32(1, handler->arms);
+    TEST_ASSERT_EQUAL_UINT32(1, handler->throttles);
+    TEST_ASSERT_EQUAL_UINT16(77, handler->lastDuty);
+    TEST_ASSERT_EQUAL_UINT32(1, handler->disarms);
+
+    TEST_ASSERT_EQUAL(4, takeReplies(replies, 4));
+    for (uint8_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_UINT8(i + 1, replies[i].seq);
+        TEST_ASSERT_EQUAL_HEX8(MOA_LINK_MSG_ACK, replies[i].type);
+        TEST_ASSERT_EQUAL_UINT8(1, replies[i].length);
+        TEST_ASSERT_EQUAL_UINT8(MOA_LINK_STATUS_OK, replies[i].payload[0]);
+    }
+    MoaLinkStats stats = session->getStats();
+    TEST_ASSERT_EQUAL_UINT32(4, stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.seqGaps);
+}
+
+void test_session_retry_is_not_executed_twice(void) {
+    MoaLinkFrame replies[4];
+    sendThrottle(9, 80);
+    sendThrottle(9, 80);            // Reply lost, host retries
+    handler->status = MOA_LINK_STATUS_BAD_LENGTH;
+    sendThrottle(10, 90);
+    sendThrottle(10, 90);           // Retry answered with the same status
+
+    TEST_ASSERT_EQUAL_UINT32(2, handler->throttles);
+    TEST_ASSERT_EQUAL(4, takeReplies(replies, 4));
+    TEST_ASSERT_EQUAL_UINT8(MOA_LINK_STATUS_OK, replies[1].payload[0]);
+    TEST_ASSERT_EQUAL_UINT8(MOA_LINK_STATUS_BAD_LENGTH, replies[3].payload[0]);
+
+    MoaLinkStats stats = session->getStats();
+    TEST_ASSERT_EQUAL_UINT32(2, stats.duplicates);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rejected);
+}
+
+void test_session_busy_retry_is_executed_again(void) {
+    MoaEventQueue queue;
+    handler->events = &queue;
+    for (uint8_t i = 0; i < MOA_EVENT_SAFETY_DEPTH; i++) {
+        queue.push(RemoteEvent(COMMAND_REMOTE_DISARM, 0));
+    }
+
+    MoaLinkFrame replies[3];
+    sendFrame(7, MOA_LINK_MSG_DISARM);              // Safety lane full
+    ControlCommand served;
+    TEST_ASSERT_TRUE(queue.pop(served));            // ControlTask makes room
+    sendFrame(7, MOA_LINK_MSG_DISARM);              // Host retries the same seq
+    sendFrame(7, MOA_LINK_MSG_DISARM);              // Reply lost: now a real duplicate
+
+    TEST_ASSERT_EQUAL_UINT32(2, handler->disarms);
+    TEST_ASSERT_EQUAL_UINT8(MOA_EVENT_SAFETY_DEPTH, queue.size(MOA_EVENT_LANE_SAFETY));
+    TEST_ASSERT_EQUAL(3, takeReplies(replies, 3));
+    TEST_ASSERT_EQUAL_UINT8(MOA_LINK_STATUS_BUSY, replies[0].payload[0]);
+    TEST_ASSERT_EQUAL_UINT8(MOA_LINK_STATUS_OK, replies[1].payload[0]);
+    TEST_ASSERT_EQUAL_UINT8(MOA_LINK_STATUS_OK, replies[2].payload[0]);
+
+    MoaLinkStats stats = session->getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.duplicates);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.rejected);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.seqGaps);
+}
+
+void test_session_counts_gaps_and_rejects_bad_requests(void) {
+    MoaLinkFrame replies[4];
+    const uint8_t oneByte[1] = { 1 };
+    sendFrame(1, MOA_LINK_MSG_PING);
+    sendFrame(4, MOA_LINK_MSG_PING);                // 2 and 3 lost
+    sendFrame(5, MOA_LINK_MSG_ARM, oneByte, 1);
+    sendFrame(6, 0x42);
+
+    TEST_ASSERT_EQUAL_UINT32(0, handler->arms);
+    TEST_ASSERT_EQUAL(4, takeReplies(replies, 4));
+    TEST_ASSERT_EQUAL_UINT8(MOA_LINK_STATUS_BAD_LENGTH, replies[2].payload[0]);
+    TEST_ASSERT_EQUAL_UINT8(MOA_LINK_STATUS_UNKNOWN, replies[3].payload[0]);
+
+    MoaLinkStats stats = session->getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.seqGaps);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.rejected);
+
+    session->resetStats();
+    stats = session->getStats();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.rejected);
+}
+
+void test_session_telemetry_reply(void) {
+    MoaLinkFrame replies[2];
+    sendFrame(20, MOA_LINK_MSG_TELEMETRY);
+    sendFrame(20, MOA_LINK_MSG_TELEMETRY);          // Polled again: fresh reply, not a duplicate
+
+    TEST_ASSERT_EQUAL(2, takeReplies(replies, 2));
+    TEST_ASSERT_EQUAL_HEX8(MOA_LINK_MSG_TELEMETRY_REPLY, replies[1].type);
+    TEST_ASSERT_EQUAL_UINT8(20, replies[1].seq);
+    TEST_ASSERT_EQUAL_UINT8(sizeof(MoaLinkTelemetry), replies[1].length);
+
+    MoaLinkTelemetry telemetry;
+    memcpy(&telemetry, replies[1].payload, sizeof(telemetry));
+    TEST_ASSERT_EQUAL_UINT8(2, telemetry.state);
+    TEST_ASSERT_EQUAL_UINT16(1229, telemetry.escDuty);
+    TEST_ASSERT_EQUAL_UINT16(24150, telemetry.battMillivolts);
+    TEST_ASSERT_EQUAL_INT16(-35, telemetry.currentDeciAmps);
+    TEST_ASSERT_EQUAL_UINT32(123456, telemetry.uptimeMs);
+    TEST_ASSERT_EQUAL_UINT32(0, session->getStats().duplicates);
+}
+
+void test_session_accepts_any_chunking(void) {
+    uint8_t stream[4 * MOA_LINK_MAX_ENCODED];
+    size_t n = 0;
+    for (uint8_t seq = 1; seq <= 4; seq++) {
+        const uint8_t duty[2] = { static_cast<uint8_t>(60 + seq), 0 };
+        n += MoaLinkCodec::encodeFrame(seq, MOA_LINK_MSG_THROTTLE, duty, 2, stream + n, sizeof(stream) - n);
+    }
+    // One byte at a time, as a slow driver would hand them over
+    for (size_t i = 0; i < n; i++) {
+        session->receive(stream + i, 1);
+    }
+    TEST_ASSERT_EQUAL_UINT32(4, handler->throttles);
+    TEST_ASSERT_EQUAL_UINT16(64, handler->lastDuty);
+}
+
+// =============================================================================
+// Pseudo-terminal loopback
+// =============================================================================
+
+static void makeRaw(int fd) {
+    struct termios tio;
+    TEST_ASSERT_EQUAL(0, tcgetattr(fd, &tio));
+    cfmakeraw(&tio);
+    TEST_ASSERT_EQUAL(0, tcsetattr(fd, TCSANOW, &tio));
+}
+
+/**
+ * @brief Read what is available on fd within timeoutMs
+ */
+static size_t readSome(int fd, uint8_t* buffer, size_t capacity, int timeoutMs) {
+    struct pollfd p = { fd, POLLIN, 0 };
+    if (poll(&p, 1, timeoutMs) <= 0) {
+        return 0;
+    }
+    ssize_t n = read(fd, buffer, capacity);
+    return (n > 0) ? static_cast<size_t>(n) : 0;
+}
+
+void test_session_over_pty(void) {
+    int host = posix_openpt(O_RDWR | O_NOCTTY);
+    if (host < 0) {
+        TEST_IGNORE_MESSAGE("No pseudo-terminal available");
+    }
+    TEST_ASSERT_EQUAL(0, grantpt(host));
+    TEST_ASSERT_EQUAL(0, unlockpt(host));
+    int board = open(ptsname(host), O_RDWR | O_NOCTTY);
+    TEST_ASSERT_TRUE(board >= 0);
+    makeRaw(host);
+    makeRaw(board);
+    handler->fd = board;
+
+    // Host: arm, throttle (0x00 in the payload), telemetry, sent as one write
+    uint8_t out[3 * MOA_LINK_MAX_ENCODED];
+    size_t n = MoaLinkCodec::encodeFrame(1, MOA_LINK_MSG_ARM, nullptr, 0, out, sizeof(out));
+    const uint8_t duty[2] = { 0x00, 0x01 };
+    n += MoaLinkCodec::encodeFrame(2, MOA_LINK_MSG_THROTTLE, duty, 2, out + n, sizeof(out) - n);
+    n += MoaLinkCodec::encodeFrame(3, MOA_LINK_MSG_TELEMETRY, nullptr, 0, out + n, sizeof(out) - n);
+    TEST_ASSERT_EQUAL((ssize_t)n, write(host, out, n));
+
+    // Board: read whatever the tty hands over until the last frame is in
+    uint8_t buffer[64];
+    for (int i = 0; i < 50 && handler->throttles == 0; i++) {
+        size_t got = readSome(board, buffer, sizeof(buffer), 20);
+        session->receive(buffer, got);
+    }
+    for (int i = 0; i < 10; i++) {
+        size_t got = readSome(board, buffer, sizeof(buffer), 5);
+        session->receive(buffer, got);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, handler->arms);
+    TEST_ASSERT_EQUAL_UINT16(0x0100, handler->lastDuty);
+
+    // Host: decode the three replies
+    MoaLinkDecoder decoder;
+    MoaLinkFrame frame;
+    uint8_t types[3] = {};
+    size_t replies = 0;
+    for (int i = 0; i < 50 && replies < 3; i++) {
+        size_t got = readSome(host, buffer, sizeof(buffer), 20);
+        for (size_t b = 0; b < got; b++) {
+            if (decoder.push(buffer[b], frame) && replies < 3) {
+                types[replies++] = frame.type;
+            }
+        }
+    }
+    close(board);
+    close(host);
+
+    TEST_ASSERT_EQUAL(3, replies);
+    TEST_ASSERT_EQUAL_HEX8(MOA_LINK_MSG_ACK, types[0]);
+    TEST_ASSERT_EQUAL_HEX8(MOA_LINK_MSG_ACK, types[1]);
+    TEST_ASSERT_EQUAL_HEX8(MOA_LINK_MSG_TELEMETRY_REPLY, types[2]);
+    TEST_ASSERT_EQUAL_UINT32(0, decoder.getCrcErrors() + decoder.getFramingErrors());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc16_reference_vector);
+    RUN_TEST(test_cobs_vectors_round_trip);
+    RUN_TEST(test_cobs_rejects_invalid_block);
+    RUN_TEST(test_encode_frame_limits);
+    RUN_TEST(test_decoder_counts_errors_and_resyncs);
+    RUN_TEST(test_session_dispatches_and_acks);
+    RUN_TEST(test_session_retry_is_not_executed_twice);
+    RUN_TEST(test_session_busy_retry_is_executed_again);
+    RUN_TEST(test_session_counts_gaps_and_rejects_bad_requests);
+    RUN_TEST(test_session_telemetry_reply);
+    RUN_TEST(test_session_accepts_any_chunking);
+    RUN_TEST(test_session_over_pty);
+    return UNITY_END();
+}
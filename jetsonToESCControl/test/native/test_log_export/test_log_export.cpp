@@ -0,0 +1,402 @@
+/**
+ * @file test_log_export.cpp
+ * @brief Host tests and heap/time benchmark for MoaLogExporter
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Checks that the streamed JSON is byte-identical to the document the old
+ * String-based toJson()/toJsonVerbose() built, plus the CSV and binary
+ * forms, chunk bounds and sink failure handling.
+ *
+ * The benchmark counts heap use through replaced global operator new/delete
+ * and compares the streaming exporter with the previous approach (one
+ * growing string with += appends) for a 128-entry log and a 100k-entry log.
+ * std::string grows geometrically, so the allocation count is a lower bound:
+ * Arduino String reallocates to the exact length on most appends.
+ *
+ * Run with: pio test -e native -f native/test_log_export
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <new>
+#include <string>
+#include "MoaLogExporter.h"
+#include "MoaLogCodes.h"
+
+// ---------------------------------------------------------------------------
+// Heap accounting
+// ---------------------------------------------------------------------------
+
+static size_t heapLive = 0;
+static size_t heapPeak = 0;
+static size_t heapAllocs = 0;
+
+struct alignas(16) HeapTag {
+    size_t size;
+};
+
+void* operator new(size_t size) {
+    HeapTag* tag = static_cast<HeapTag*>(malloc(sizeof(HeapTag) + size));
+    if (tag == nullptr) {
+        throw std::bad_alloc();
+    }
+    tag->size = size;
+    heapLive += size;
+    heapAllocs++;
+    if (heapLive > heapPeak) {
+        heapPeak = heapLive;
+    }
+    return tag + 1;
+}
+
+void operator delete(void* p) noexcept {
+    if (p == nullptr) {
+        return;
+    }
+    HeapTag* tag = static_cast<HeapTag*>(p) - 1;
+    heapLive -= tag->size;
+    free(tag);
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+static void resetHeapPeak() {
+    heapPeak = heapLive;
+    heapAllocs = 0;
+}
+
+// ---------------------------------------------------------------------------
+// Sinks
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Collects the export into a fixed buffer
+ */
+class BufferSink : public ILogSink {
+public:
+    BufferSink() : length(0), calls(0), maxChunk(0), acceptLimit(SIZE_MAX) {}
+
+    size_t write(const uint8_t* data, size_t n) override {
+        calls++;
+        if (n > maxChunk) maxChunk = n;
+        size_t take = n;
+        if (length + take > acceptLimit) {
+            take = (acceptLimit > length) ? acceptLimit - length : 0;
+        }
+        if (length + take > sizeof(data_) - 1) {
+            take = sizeof(data_) - 1 - length;
+        }
+        memcpy(&data_[length], data, take);
+        length += take;
+        return take;
+    }
+
+    const char* text() {
+        data_[length] = '\0';
+        return reinterpret_cast<const char*>(data_);
+    }
+
+    const uint8_t* bytes() const { return data_; }
+
+    size_t length;
+    size_t calls;
+    size_t maxChunk;
+    size_t acceptLimit;     ///< Total bytes accepted before refusing
+
+private:
+    uint8_t data_[64 * 1024 + 1];       ///< + NUL for text()
+};
+
+/**
+ * @brief Discards the export, counting bytes (benchmark)
+ */
+class CountingSink : public ILogSink {
+public:
+    CountingSink() : length(0) {}
+    size_t write(const uint8_t* data, size_t n) override {
+        (void)data;
+        length += n;
+        return n;
+    }
+    size_t length;
+};
+
+// ---------------------------------------------------------------------------
+// Reference: the previous String-based export, on std::string
+// ---------------------------------------------------------------------------
+
+static std::string buildJsonString(const MoaLogEntry* entries, size_t count, bool verbose) {
+    std::string json = "{\"count\":";
+    json += std::to_string(count);
+    json += ",\"entries\":[";
+    for (size_t i = 0; i < count; i++) {
+        const MoaLogEntry& entry = entries[i];
+        if (i > 0) {
+            json += ",";
+        }
+        json += "{\"t\":";
+        json += std::to_string(entry.timestamp);
+        if (verbose) {
+            json += ",\"type\":\"";
+            json += MoaLogExporter::getTypeName(entry.type);
+            json += "\",\"code\":\"";
+            json += MoaLogExporter::getCodeName(entry.type, entry.code);
+            json += "\",\"val\":";
+        } else {
+            json += ",\"type\":";
+            json += std::to_string(entry.type);
+            json += ",\"code\":";
+            json += std::to_string(entry.code);
+            json += ",\"val\":";
+        }
+        json += std::to_string(entry.value);
+        json += "}";
+    }
+    json += "]}";
+    return json;
+}
+
+// ---------------------------------------------------------------------------
+// Fixtures
+// ---------------------------------------------------------------------------
+
+static const uint8_t sampleTypes[][2] = {
+    { LOG_TYPE_SYSTEM, LOG_SYS_BOOT },
+    { LOG_TYPE_BUTTON, LOG_BTN_50_PRESS },
+    { LOG_TYPE_TEMP, LOG_TEMP_CROSSED_ABOVE },
+    { LOG_TYPE_BATT, LOG_BATT_MEDIUM },
+    { LOG_TYPE_CURRENT, LOG_CURRENT_OVERCURRENT },
+    { LOG_TYPE_STATE, LOG_STATE_TO_SURFING },
+    { LOG_TYPE_ERROR, LOG_ERR_I2C_FAIL },
+    { 0x77, 0x09 },                                  // Uncatalogued
+};
+
+static MoaLogEntry makeEntry(uint32_t i) {
+    MoaLogEntry e;
+    const uint8_t* tc = sampleTypes[i % (sizeof(sampleTypes) / sizeof(sampleTypes[0]))];
+    e.timestamp = 1000 + i * 137;
+    e.type = tc[0];
+    e.code = tc[1];
+    e.value = static_cast<int16_t>((i * 389) % 4000) - 2000;
+    return e;
+}
+
+static MoaLogEntry entries128[128];
+static BufferSink* sink;
+
+void setUp(void) {
+    for (uint32_t i = 0; i < 128; i++) {
+        entries128[i] = makeEntry(i);
+    }
+    sink = new BufferSink();
+}
+
+void tearDown(void) {
+    delete sink;
+}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+void test_json_matches_string_builder() {
+    std::string expected = buildJsonString(entries128, 128, false);
+    TEST_ASSERT_TRUE(MoaLogExporter::exportEntries(*sink, MoaLogExportFormat::JSON, entries128, 128));
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), sink->length);
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), sink->text());
+}
+
+void test_verbose_json_matches_string_builder() {
+    std::string expected = buildJsonString(entries128, 128, true);
+    TEST_ASSERT_TRUE(MoaLogExporter::exportEntries(*sink, MoaLogExportFormat::JSON_VERBOSE, entries128, 128));
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), sink->text());
+}
+
+void test_empty_log() {
+    TEST_ASSERT_TRUE(MoaLogExporter::exportEntries(*sink, MoaLogExportFormat::JSON, entries128, 0));
+    TEST_ASSERT_EQUAL_STRING("{\"count\":0,\"entries\":[]}", sink->text());
+}
+
+void test_extreme_values() {
+    MoaLogEntry e[2];
+    e[0].timestamp = 4294967295UL;
+    e[0].type = LOG_TYPE_CURRENT;
+    e[0].code = LOG_CURRENT_REVERSE;
+    e[0].value = -32768;
+    e[1].timestamp = 0;
+    e[1].type = LOG_TYPE_SYSTEM;
+    e[1].code = 0;
+    e[1].value = 32767;
+
+    TEST_ASSERT_TRUE(MoaLogExporter::exportEntries(*sink, MoaLogExportFormat::CSV, e, 2));
+    TEST_ASSERT_EQUAL_STRING(
+        "t,type,code,val,type_name,code_name\n"
+        "4294967295,64,3,-32768,CURRENT,REVERSE\n"
+        "0,0,0,32767,SYSTEM,?\n",
+        sink->text());
+}
+
+void test_csv_has_one_row_per_entry() {
+    TEST_ASSERT_TRUE(MoaLogExporter::exportEntries(*sink, MoaLogExportFormat::CSV, entries128, 128));
+    const char* text = sink->text();
+    size_t lines = 0;
+    for (const char* p = text; *p; p++) {
+        if (*p == '\n') lines++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(129, lines);
+
+    char row[64];
+    snprintf(row, sizeof(row), "\n%u,%u,%u,%d,TEMP,ABOVE\n",
+             static_cast<unsigned>(entries128[2].timestamp), entries128[2].type,
+             entries128[2].code, entries128[2].value);
+    TEST_ASSERT_NOT_NULL(strstr(text, row));
+}
+
+void test_binary_roundtrip() {
+    TEST_ASSERT_TRUE(MoaLogExporter::exportEntries(*sink, MoaLogExportFormat::BINARY, entries128, 128));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(MoaLogExportHeader) + 128 * sizeof(MoaLogEntry) + 2, sink->length);
+
+    MoaLogExportHeader header;
+    memcpy(&header, sink->bytes(), sizeof(header));
+    TEST_ASSERT_EQUAL_HEX32(MOA_LOG_EXPORT_MAGIC, header.magic);
+    TEST_ASSERT_EQUAL_UINT8(MOA_LOG_EXPORT_VERSION, header.version);
+    TEST_ASSERT_EQUAL_UINT8(sizeof(MoaLogEntry), header.entrySize);
+    TEST_ASSERT_EQUAL_UINT32(128, header.count);
+
+    const uint8_t* body = sink->bytes() + sizeof(header);
+    TEST_ASSERT_EQUAL_MEMORY(entries128, body, 128 * sizeof(MoaLogEntry));
+
+    uint16_t crc;
+    memcpy(&crc, body + 128 * sizeof(MoaLogEntry), sizeof(crc));
+    TEST_ASSERT_EQUAL_HEX16(MoaLogJournal::crc16(body, 128 * sizeof(MoaLogEntry)), crc);
+}
+
+void test_chunks_are_bounded() {
+    TEST_ASSERT_TRUE(MoaLogExporter::exportEntries(*sink, MoaLogExportFormat::JSON_VERBOSE, entries128, 128));
+    TEST_ASSERT_EQUAL_UINT32(MOA_LOG_EXPORT_CHUNK_SIZE, sink->maxChunk);
+    // Every chunk but the last is full
+    size_t expectedCalls = (sink->length + MOA_LOG_EXPORT_CHUNK_SIZE - 1) / MOA_LOG_EXPORT_CHUNK_SIZE;
+    TEST_ASSERT_EQUAL_UINT32(expectedCalls, sink->calls);
+}
+
+void test_sink_failure_stops_export() {
+    sink->acceptLimit = 2 * MOA_LOG_EXPORT_CHUNK_SIZE + 10;
+
+    MoaLogExporter exporter(*sink, MoaLogExportFormat::JSON);
+    exporter.begin(128);
+    for (uint32_t i = 0; i < 128; i++) {
+        exporter.add(entries128[i]);
+    }
+    TEST_ASSERT_FALSE(exporter.end());
+    TEST_ASSERT_TRUE(exporter.hasFailed());
+    TEST_ASSERT_EQUAL_UINT32(sink->acceptLimit, exporter.getBytesWritten());
+    // The refused chunk is the last one offered
+    TEST_ASSERT_EQUAL_UINT32(3, sink->calls);
+}
+
+void test_export_does_not_allocate() {
+    resetHeapPeak();
+    size_t live = heapLive;
+    CountingSink counting;
+    MoaLogExporter exporter(counting, MoaLogExportFormat::JSON_VERBOSE);
+    exporter.begin(100000);
+    for (uint32_t i = 0; i < 100000; i++) {
+        exporter.add(makeEntry(i));
+    }
+    TEST_ASSERT_TRUE(exporter.end());
+    TEST_ASSERT_EQUAL_UINT32(0, heapAllocs);
+    TEST_ASSERT_EQUAL_UINT32(live, heapPeak);
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+static void benchmark(uint32_t count, MoaLogExportFormat format, const char* label) {
+    MoaLogEntry* entries = static_cast<MoaLogEntry*>(malloc(count * sizeof(MoaLogEntry)));
+    TEST_ASSERT_NOT_NULL(entries);
+    for (uint32_t i = 0; i < count; i++) {
+        entries[i] = makeEntry(i);
+    }
+    const int reps = (count <= 1024) ? 200 : 3;
+    bool verbose = (format == MoaLogExportFormat::JSON_VERBOSE);
+
+    // Previous approach: build the whole document, then send it
+    resetHeapPeak();
+    size_t base = heapLive;
+    size_t stringBytes = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) {
+        std::string json = buildJsonString(entries, count, verbose);
+        stringBytes = json.size();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    size_t stringPeak = heapPeak - base;
+    size_t stringAllocs = heapAllocs / reps;
+
+    // Streaming exporter
+    resetHeapPeak();
+    base = heapLive;
+    CountingSink counting;
+    auto t2 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) {
+        counting.length = 0;
+        MoaLogExporter::exportEntries(counting, format, entries, count);
+    }
+    auto t3 = std::chrono::steady_clock::now();
+    size_t streamPeak = heapPeak - base;
+    size_t streamAllocs = heapAllocs / reps;
+
+    TEST_ASSERT_EQUAL_UINT32(stringBytes, counting.length);
+    TEST_ASSERT_EQUAL_UINT32(0, streamPeak);
+
+    double stringUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / reps;
+    double streamUs = std::chrono::duration<double, std::micro>(t3 - t2).count() / reps;
+
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "%s, %u entries (%u bytes): string peak heap %u B / %u allocs / %.1f us"
+             " | streaming peak heap %u B / %u allocs / %.1f us (exporter %u B on stack)",
+             label, static_cast<unsigned>(count), static_cast<unsigned>(stringBytes),
+             static_cast<unsigned>(stringPeak), static_cast<unsigned>(stringAllocs), stringUs,
+             static_cast<unsigned>(streamPeak), static_cast<unsigned>(streamAllocs), streamUs,
+             static_cast<unsigned>(sizeof(MoaLogExporter)));
+    TEST_MESSAGE(msg);
+
+    free(entries);
+}
+
+void test_benchmark_full_log() {
+    benchmark(128, MoaLogExportFormat::JSON, "JSON");
+    benchmark(128, MoaLogExportFormat::JSON_VERBOSE, "JSON verbose");
+}
+
+void test_benchmark_large_log() {
+    benchmark(100000, MoaLogExportFormat::JSON, "JSON");
+    benchmark(100000, MoaLogExportFormat::JSON_VERBOSE, "JSON verbose");
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_json_matches_string_builder);
+    RUN_TEST(test_verbose_json_matches_string_builder);
+    RUN_TEST(test_empty_log);
+    RUN_TEST(test_extreme_values);
+    RUN_TEST(test_csv_has_one_row_per_entry);
+    RUN_TEST(test_binary_roundtrip);
+    RUN_TEST(test_chunks_are_bounded);
+    RUN_TEST(test_sink_failure_stops_export);
+    RUN_TEST(test_export_does_not_allocate);
+    RUN_TEST(test_benchmark_full_log);
+    RUN_TEST(test_benchmark_large_log);
+
+    return UNITY_END();
+}
@@ -0,0 +1,304 @@
+/**
+ * @file test_log_journal.cpp
+ * @brief Host tests for the MoaLogJournal append-only flash format
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Runs the journal against SimulatedLogStorage (real files in a temporary
+ * directory) and "reboots" by constructing a new journal on the same
+ * files. Power cuts are injected at every byte offset of a multi-flush,
+ * multi-segment write sequence to check that recovery always yields an
+ * in-order prefix of what was logged and never loses a committed entry.
+ *
+ * Run with: pio test -e native -f native/test_log_journal
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "MoaLogJournal.h"
+#include "SimulatedLogStorage.h"
+
+static char rootDir[64];
+static SimulatedLogStorage* storage;
+
+/**
+ * @brief Deterministic entry for sequence number i
+ */
+static MoaLogEntry entryFor(uint32_t i) {
+    MoaLogEntry e;
+    e.timestamp = 1000 + i * 10;
+    e.type = 0x40;
+    e.code = static_cast<uint8_t>(i & 0xFF);
+    e.value = static_cast<int16_t>(i * 3);
+    return e;
+}
+
+static bool sameEntry(const MoaLogEntry& a, const MoaLogEntry& b) {
+    return a.timestamp == b.timestamp && a.type == b.type && a.code == b.code && a.value == b.value;
+}
+
+static size_t appendRange(MoaLogJournal& journal, uint32_t first, uint32_t count) {
+    MoaLogEntry batch[64];
+    size_t done = 0;
+    while (done < count) {
+        uint32_t n = count - done;
+        if (n > 64) n = 64;
+        for (uint32_t i = 0; i < n; i++) {
+            batch[i] = entryFor(first + done + i);
+        }
+        size_t written = journal.append(batch, n);
+        done += written;
+        if (written < n) {
+            break;
+        }
+    }
+    return done;
+}
+
+/**
+ * @brief Check that the journal holds entries [first, first + count) in order
+ */
+static void assertHolds(MoaLogJournal& journal, uint32_t first, uint32_t count) {
+    static MoaLogEntry out[MOA_LOG_SEGMENT_COUNT * MOA_LOG_SEGMENT_RECORDS];
+    size_t n = journal.readNewest(out, sizeof(out) / sizeof(out[0]));
+    TEST_ASSERT_EQUAL_UINT32(count, n);
+    for (uint32_t i = 0; i < n; i++) {
+        TEST_ASSERT_TRUE(sameEntry(entryFor(first + i), out[i]));
+    }
+}
+
+static void wipe() {
+    MoaLogJournal journal(storage);
+    journal.clear();
+}
+
+void setUp(void) {
+    snprintf(rootDir, sizeof(rootDir), "/tmp/moa_log_XXXXXX");
+    TEST_ASSERT_NOT_NULL(mkdtemp(rootDir));
+    storage = new SimulatedLogStorage(rootDir);
+}
+
+void tearDown(void) {
+    storage->powerCycle();
+    wipe();
+    delete storage;
+    rmdir(rootDir);
+}
+
+void test_empty_log() {
+    MoaLogJournal journal(storage);
+    TEST_ASSERT_TRUE(journal.begin());
+    TEST_ASSERT_EQUAL_UINT32(0, journal.getRecordCount());
+    TEST_ASSERT_EQUAL_UINT8(0, journal.getSegmentCount());
+
+    MoaLogEntry out[4];
+    TEST_ASSERT_EQUAL_UINT32(0, journal.readNewest(out, 4));
+}
+
+void test_entries_survive_reboot() {
+    {
+        MoaLogJournal journal(storage);
+        journal.begin();
+        TEST_ASSERT_EQUAL_UINT32(10, appendRange(journal, 0, 10));
+    }
+    MoaLogJournal rebooted(storage);
+    TEST_ASSERT_TRUE(rebooted.begin());
+    TEST_ASSERT_EQUAL_UINT32(0, rebooted.getDiscardedRecords());
+    assertHolds(rebooted, 0, 10);
+
+    // Appends continue in the same segment after reboot
+    appendRange(rebooted, 10, 5);
+    TEST_ASSERT_EQUAL_UINT8(1, rebooted.getSegmentCount());
+    assertHolds(rebooted, 0, 15);
+}
+
+void test_flush_writes_only_new_records() {
+    MoaLogJournal journal(storage);
+    journal.begin();
+    appendRange(journal, 0, 1);                  // segment header + 1 record
+    storage->resetCounters();
+
+    MoaLogEntry e = entryFor(1);
+    TEST_ASSERT_EQUAL_UINT32(1, journal.append(&e, 1));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(MoaLogRecord), storage->getBytesWritten());
+    TEST_ASSERT_EQUAL_UINT32(1, storage->getWriteCalls());
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "Critical event flush: %u bytes (previous format: %u bytes)",
+             static_cast<unsigned>(storage->getBytesWritten()),
+             static_cast<unsigned>(4 + 128 * sizeof(MoaLogEntry)));
+    TEST_MESSAGE(msg);
+}
+
+void test_segments_rotate_and_keep_newest() {
+    const uint32_t total = 300;
+    MoaLogJournal journal(storage);
+    journal.begin();
+    TEST_ASSERT_EQUAL_UINT32(total, appendRange(journal, 0, total));
+
+    // 300 = 4 full segments + 44: the oldest segment was recycled
+    TEST_ASSERT_EQUAL_UINT8(MOA_LOG_SEGMENT_COUNT, journal.getSegmentCount());
+    uint32_t held = 3 * MOA_LOG_SEGMENT_RECORDS + (total % MOA_LOG_SEGMENT_RECORDS);
+    TEST_ASSERT_EQUAL_UINT32(held, journal.getRecordCount());
+    assertHolds(journal, total - held, held);
+
+    MoaLogJournal rebooted(storage);
+    rebooted.begin();
+    assertHolds(rebooted, total - held, held);
+
+    MoaLogEntry newest[128];
+    TEST_ASSERT_EQUAL_UINT32(128, rebooted.readNewest(newest, 128));
+    TEST_ASSERT_TRUE(sameEntry(entryFor(total - 128), newest[0]));
+    TEST_ASSERT_TRUE(sameEntry(entryFor(total - 1), newest[127]));
+}
+
+void test_torn_record_is_dropped_and_sealed() {
+    {
+        MoaLogJournal journal(storage);
+        journal.begin();
+        appendRange(journal, 0, 5);
+        // Second record of this flush is cut after 5 of its 10 bytes
+        storage->setPowerCutAfter(sizeof(MoaLogRecord) + 5);
+        TEST_ASSERT_EQUAL_UINT32(1, appendRange(journal, 5, 2));
+    }
+    storage->powerCycle();
+
+    MoaLogJournal rebooted(storage);
+    rebooted.begin();
+    TEST_ASSERT_EQUAL_UINT32(1, rebooted.getDiscardedRecords());
+    assertHolds(rebooted, 0, 6);
+
+    // The torn segment is sealed: the next flush opens a new one
+    appendRange(rebooted, 6, 3);
+    TEST_ASSERT_EQUAL_UINT8(2, rebooted.getSegmentCount());
+    assertHolds(rebooted, 0, 9);
+
+    MoaLogJournal again(storage);
+    again.begin();
+    assertHolds(again, 0, 9);
+}
+
+void test_corrupt_record_stops_segment() {
+    {
+        MoaLogJournal journal(storage);
+        journal.begin();
+        appendRange(journal, 0, 8);
+    }
+
+    // Flip one byte of record 3 on "flash"
+    char path[128];
+    snprintf(path, sizeof(path), "%s%s.0", rootDir, MOA_LOG_DEFAULT_BASENAME);
+    FILE* f = fopen(path, "r+b");
+    TEST_ASSERT_NOT_NULL(f);
+    fseek(f, sizeof(MoaLogSegmentHeader) + 3 * sizeof(MoaLogRecord) + 1, SEEK_SET);
+    int c = fgetc(f);
+    fseek(f, -1, SEEK_CUR);
+    fputc(c ^ 0x5A, f);
+    fclose(f);
+
+    MoaLogJournal rebooted(storage);
+    rebooted.begin();
+    TEST_ASSERT_EQUAL_UINT32(5, rebooted.getDiscardedRecords());
+    assertHolds(rebooted, 0, 3);
+}
+
+void test_torn_segment_header_is_ignored() {
+    {
+        MoaLogJournal journal(storage);
+        journal.begin();
+        appendRange(journal, 0, MOA_LOG_SEGMENT_RECORDS);
+        // Rotation to segment 1: header cut after 7 bytes
+        storage->setPowerCutAfter(7);
+        TEST_ASSERT_EQUAL_UINT32(0, appendRange(journal, MOA_LOG_SEGMENT_RECORDS, 1));
+    }
+    storage->powerCycle();
+
+    MoaLogJournal rebooted(storage);
+    rebooted.begin();
+    TEST_ASSERT_EQUAL_UINT8(1, rebooted.getSegmentCount());
+    assertHolds(rebooted, 0, MOA_LOG_SEGMENT_RECORDS);
+
+    appendRange(rebooted, MOA_LOG_SEGMENT_RECORDS, 2);
+    assertHolds(rebooted, 0, MOA_LOG_SEGMENT_RECORDS + 2);
+}
+
+void test_power_cut_at_every_byte() {
+    // Pre-existing log, then 6 flushes of 13 entries each (crosses a rotation)
+    const uint32_t preexisting = 50;
+    const uint32_t flushes = 6;
+    const uint32_t perFlush = 13;
+
+    // Measure the bytes the sequence writes without a fault
+    uint32_t sequenceBytes = 0;
+    {
+        MoaLogJournal journal(storage);
+        journal.begin();
+        appendRange(journal, 0, preexisting);
+        storage->resetCounters();
+        for (uint32_t k = 0; k < flushes; k++) {
+            appendRange(journal, preexisting + k * perFlush, perFlush);
+        }
+        sequenceBytes = storage->getBytesWritten();
+        wipe();
+    }
+
+    uint32_t scenarios = 0;
+    for (uint32_t cut = 0; cut <= sequenceBytes; cut++) {
+        uint32_t committed = preexisting;
+        {
+            MoaLogJournal journal(storage);
+            journal.begin();
+            appendRange(journal, 0, preexisting);
+
+            storage->setPowerCutAfter(cut);
+            for (uint32_t k = 0; k < flushes && !storage->isPowerLost(); k++) {
+                committed += appendRange(journal, committed, perFlush);
+            }
+        }
+        storage->powerCycle();
+
+        // Reboot: an in-order prefix that contains every committed entry
+        MoaLogJournal rebooted(storage);
+        TEST_ASSERT_TRUE(rebooted.begin());
+        TEST_ASSERT_EQUAL_UINT32(committed, rebooted.getRecordCount());
+        assertHolds(rebooted, 0, committed);
+
+        // And the log keeps working
+        TEST_ASSERT_EQUAL_UINT32(4, appendRange(rebooted, committed, 4));
+        MoaLogJournal again(storage);
+        again.begin();
+        assertHolds(again, 0, committed + 4);
+
+        wipe();
+        scenarios++;
+    }
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%u power-cut points over %u bytes: no committed entry lost",
+             static_cast<unsigned>(scenarios), static_cast<unsigned>(sequenceBytes));
+    TEST_MESSAGE(msg);
+}
+
+void test_crc16_reference() {
+    // CRC-16/CCITT-FALSE check value
+    const uint8_t check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, MoaLogJournal::crc16(check, sizeof(check)));
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_empty_log);
+    RUN_TEST(test_entries_survive_reboot);
+    RUN_TEST(test_flush_writes_only_new_records);
+    RUN_TEST(test_segments_rotate_and_keep_newest);
+    RUN_TEST(test_torn_record_is_dropped_and_sealed);
+    RUN_TEST(test_corrupt_record_stops_segment);
+    RUN_TEST(test_torn_segment_header_is_ignored);
+    RUN_TEST(test_power_cut_at_every_byte);
+    RUN_TEST(test_crc16_reference);
+
+    return UNITY_END();
+}
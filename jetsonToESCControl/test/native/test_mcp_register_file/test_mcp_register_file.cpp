@@ -0,0 +1,330 @@
+/**
+ * @file test_mcp_register_file.cpp
+ * @brief Host tests for the MoaMcpRegisterFile MCP23018 shadow
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Drives the register file against SimulatedMcp23018, which counts every
+ * I2C transaction. Checks that unchanged writes are skipped, changed
+ * registers go out as one burst per group, recovery restores the full
+ * configuration and the interrupt-state burst clears the pending flag.
+ * The last test replays boot plus one second of IOTask against a model of
+ * the previous per-pin read-modify-write driver and reports both counts.
+ *
+ * Run with: pio test -e native -f native/test_mcp_register_file
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include "MoaMcpRegisterFile.h"
+#include "SimulatedMcp23018.h"
+
+#define MCP_ADDR        0x20
+#define BUTTON_MASK     0x3E    // Same pins as MOA_BUTTON_MASK
+#define LED_MASK        0x1F    // Same pins as MOA_LED_MASK
+#define IO_PERIOD_MS    20      // TASK_IO_PERIOD_MS
+
+static SimulatedMcp23018* sim;
+static MoaMcpRegisterFile* regs;
+
+void setUp(void) {
+    sim = new SimulatedMcp23018(MCP_ADDR);
+    regs = new MoaMcpRegisterFile(sim, MCP_ADDR);
+}
+
+void tearDown(void) {
+    delete regs;
+    delete sim;
+}
+
+/**
+ * @brief Button and LED configuration as MoaMcpDevice stages it
+ */
+static void stageBoardConfig() {
+    regs->setBits(MCP23018_REG_IODIRA, BUTTON_MASK, BUTTON_MASK);
+    regs->setBits(MCP23018_REG_GPPUA, BUTTON_MASK, BUTTON_MASK);
+    regs->setBits(MCP23018_REG_GPINTENA, BUTTON_MASK, BUTTON_MASK);
+    regs->setBits(MCP23018_REG_DEFVALA, BUTTON_MASK, 0x00);
+    regs->setBits(MCP23018_REG_INTCONA, BUTTON_MASK, 0x00);
+    regs->set(MCP23018_REG_IODIRB, static_cast<uint8_t>(~LED_MASK));
+    regs->set(MCP23018_REG_GPPUB, LED_MASK);
+}
+
+void test_begin_is_one_burst_read(void) {
+    TEST_ASSERT_TRUE(regs->begin());
+    TEST_ASSERT_EQUAL_UINT32(1, sim->getTransactions());
+    TEST_ASSERT_EQUAL_UINT32(1, sim->getReads());
+    TEST_ASSERT_EQUAL_UINT8(0xFF, regs->get(MCP23018_REG_IODIRA));
+
+    MoaMcpRegisterFile wrongAddress(sim, MCP_ADDR + 1);
+    TEST_ASSERT_FALSE(wrongAddress.begin());
+    TEST_ASSERT_EQUAL_UINT32(1, wrongAddress.getErrorCount());
+}
+
+void test_config_commit_is_one_transaction(void) {
+    regs->begin();
+    sim->resetCounters();
+
+    stageBoardConfig();
+    TEST_ASSERT_TRUE(regs->commit());
+    TEST_ASSERT_EQUAL_UINT32(1, sim->getTransactions());
+    TEST_ASSERT_EQUAL_UINT8(BUTTON_MASK, sim->peek(MCP23018_REG_GPINTENA));
+    TEST_ASSERT_EQUAL_UINT8(BUTTON_MASK | 0xC1, sim->peek(MCP23018_REG_IODIRA));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(~LED_MASK), sim->peek(MCP23018_REG_IODIRB));
+    TEST_ASSERT_EQUAL_UINT8(LED_MASK, sim->peek(MCP23018_REG_GPPUB));
+}
+
+void test_unchanged_commit_is_skipped(void) {
+    regs->begin();
+    stageBoardConfig();
+    regs->commit();
+    sim->resetCounters();
+
+    stageBoardConfig();
+    TEST_ASSERT_TRUE(regs->commit());
+    TEST_ASSERT_EQUAL_UINT32(0, sim->getTransactions());
+    TEST_ASSERT_EQUAL_UINT32(1, regs->getSkippedWrites());
+}
+
+void test_output_latch_written_only_on_change(void) {
+    regs->begin();
+    sim->resetCounters();
+
+    regs->set(MCP23018_REG_OLATB, 0x05);
+    regs->commit();
+    regs->set(MCP23018_REG_OLATB, 0x05);
+    regs->commit();
+    regs->set(MCP23018_REG_GPIOB, 0x05);    // GPIO write lands in OLAT
+    regs->commit();
+    TEST_ASSERT_EQUAL_UINT32(1, sim->getWrites());
+    TEST_ASSERT_EQUAL_UINT8(0x05, sim->peek(MCP23018_REG_OLATB));
+
+    regs->set(MCP23018_REG_OLATB, 0x04);
+    regs->commit();
+    TEST_ASSERT_EQUAL_UINT32(2, sim->getWrites());
+    TEST_ASSERT_EQUAL_UINT32(2, regs->getSkippedWrites());
+}
+
+void test_burst_covers_only_changed_span(void) {
+    regs->begin();
+    sim->resetCounters();
+
+    regs->set(MCP23018_REG_GPINTENA, 0x02);
+    regs->set(MCP23018_REG_INTCONA, 0x02);
+    regs->commit();
+
+    TEST_ASSERT_EQUAL_UINT32(1, sim->getWrites());
+    TEST_ASSERT_EQUAL_UINT32(0, sim->getRegisterWrites(MCP23018_REG_IODIRA));
+    TEST_ASSERT_EQUAL_UINT32(1, sim->getRegisterWrites(MCP23018_REG_GPINTENA));
+    TEST_ASSERT_EQUAL_UINT32(1, sim->getRegisterWrites(MCP23018_REG_DEFVALA));
+    TEST_ASSERT_EQUAL_UINT32(1, sim->getRegisterWrites(MCP23018_REG_INTCONA));
+    TEST_ASSERT_EQUAL_UINT32(0, sim->getRegisterWrites(MCP23018_REG_INTCONB));
+    TEST_ASSERT_EQUAL_UINT32(2 + 5, sim->getBusBytes());
+}
+
+void test_config_and_latch_are_two_bursts(void) {
+    regs->begin();
+    sim->resetCounters();
+
+    regs->set(MCP23018_REG_IODIRB, 0x00);
+    regs->set(MCP23018_REG_OLATB, 0x1F);
+    regs->commit();
+    TEST_ASSERT_EQUAL_UINT32(2, sim->getWrites());
+    TEST_ASSERT_EQUAL_UINT32(0, sim->getRegisterWrites(MCP23018_REG_INTFA));
+    TEST_ASSERT_EQUAL_UINT8(0x1F, sim->peek(MCP23018_REG_OLATB));
+}
+
+void test_iocon_is_mirrored_and_mode_bits_masked(void) {
+    regs->begin();
+
+    regs->set(MCP23018_REG_IOCON2, 0x42 | MCP23018_IOCON_BANK | MCP23018_IOCON_SEQOP);
+    TEST_ASSERT_EQUAL_UINT8(0x42, regs->get(MCP23018_REG_IOCON));
+    TEST_ASSERT_EQUAL_UINT8(0x42, regs->get(MCP23018_REG_IOCON2));
+    regs->commit();
+    TEST_ASSERT_EQUAL_UINT8(0x42, sim->peek(MCP23018_REG_IOCON));
+}
+
+void test_failed_write_is_retried(void) {
+    regs->begin();
+    stageBoardConfig();
+    sim->failNext(1);
+    TEST_ASSERT_FALSE(regs->commit());
+    TEST_ASSERT_EQUAL_UINT32(1, regs->getErrorCount());
+    TEST_ASSERT_EQUAL_UINT8(0x00, sim->peek(MCP23018_REG_GPINTENA));
+
+    // Nothing staged since, but the span is unknown and must go out again
+    sim->resetCounters();
+    TEST_ASSERT_TRUE(regs->commit());
+    TEST_ASSERT_EQUAL_UINT32(1, sim->getWrites());
+    TEST_ASSERT_EQUAL_UINT8(BUTTON_MASK, sim->peek(MCP23018_REG_GPINTENA));
+}
+
+void test_recovery_restores_configuration(void) {
+    regs->begin();
+    stageBoardConfig();
+    regs->set(MCP23018_REG_OLATB, 0x0A);
+    regs->commit();
+
+    sim->powerOnReset();
+    regs->resetToPowerOn();
+    TEST_ASSERT_TRUE(regs->commit());
+
+    TEST_ASSERT_EQUAL_UINT8(BUTTON_MASK, sim->peek(MCP23018_REG_GPINTENA));
+    TEST_ASSERT_EQUAL_UINT8(BUTTON_MASK, sim->peek(MCP23018_REG_GPPUA));
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(~LED_MASK), sim->peek(MCP23018_REG_IODIRB));
+    TEST_ASSERT_EQUAL_UINT8(0x0A, sim->peek(MCP23018_REG_OLATB));
+}
+
+void test_interrupt_state_burst_clears_flag(void) {
+    regs->begin();
+    stageBoardConfig();
+    regs->commit();
+
+    sim->setInputs(0, static_cast<uint8_t>(0xFF & ~0x04));    // Press button on pin 2
+    TEST_ASSERT_TRUE(sim->isInterruptAsserted(0));
+
+    sim->resetCounters();
+    uint8_t values[3];
+    TEST_ASSERT_TRUE(regs->read(MCP23018_REG_INTCAPA, values, sizeof(values)));
+    TEST_ASSERT_EQUAL_UINT32(1, sim->getTransactions());
+    TEST_ASSERT_EQUAL_UINT8(0x00, values[0] & 0x04);
+    TEST_ASSERT_EQUAL_UINT8(0x00, values[2] & 0x04);
+    TEST_ASSERT_FALSE(sim->isInterruptAsserted(0));
+
+    TEST_ASSERT_FALSE(regs->read(MCP23018_REG_OLATB, values, 2));    // Past the end
+}
+
+// ============================================================================
+// Previous driver model: one read-modify-write per pin and per register bit
+// ============================================================================
+
+/**
+ * @brief Single-bit register update as the previous bus library did it
+ */
+static void legacyWriteBit(uint8_t reg, uint8_t bit, bool value) {
+    uint8_t current = 0;
+    sim->readRegisters(MCP_ADDR, reg, &current, 1);
+    current = value ? (current | (1 << bit)) : (current & ~(1 << bit));
+    sim->writeRegisters(MCP_ADDR, reg, &current, 1);
+}
+
+static void legacyBoot() {
+    uint8_t value = 0;
+    sim->readRegisters(MCP_ADDR, MCP23018_REG_IOCON, &value, 1);    // Probe
+    for (uint8_t pin = 0; pin < 8; pin++) {
+        if (BUTTON_MASK & (1 << pin)) {
+            // configurePortA: pinMode (direction + pullup), then setPullup again
+            legacyWriteBit(MCP23018_REG_IODIRA, pin, true);
+            legacyWriteBit(MCP23018_REG_GPPUA, pin, true);
+            legacyWriteBit(MCP23018_REG_GPPUA, pin, true);
+        }
+    }
+    for (uint8_t pin = 0; pin < 8; pin++) {
+        if (BUTTON_MASK & (1 << pin)) {
+            // setupInterruptPin(CHANGE): compare mode, default value, enable
+            legacyWriteBit(MCP23018_REG_INTCONA, pin, false);
+            legacyWriteBit(MCP23018_REG_DEFVALA, pin, false);
+            legacyWriteBit(MCP23018_REG_GPINTENA, pin, true);
+        }
+    }
+    for (uint8_t pin = 0; pin < 8; pin++) {
+        if (LED_MASK & (1 << pin)) {
+            legacyWriteBit(MCP23018_REG_IODIRB, pin, false);
+            legacyWriteBit(MCP23018_REG_GPPUB, pin, true);
+        }
+    }
+}
+
+/**
+ * @brief One IOTask cycle: poll buttons, rewrite LEDs, service an interrupt
+ */
+static void legacyCycle(uint8_t leds, bool interrupt) {
+    uint8_t value = 0;
+    sim->readRegisters(MCP_ADDR, MCP23018_REG_GPIOA, &value, 1);
+    sim->writeRegisters(MCP_ADDR, MCP23018_REG_GPIOB, &leds, 1);
+    if (interrupt) {
+        sim->readRegisters(MCP_ADDR, MCP23018_REG_INTCAPA, &value, 1);
+        sim->readRegisters(MCP_ADDR, MCP23018_REG_GPIOA, &value, 1);
+    }
+}
+
+static void shadowBoot() {
+    regs->begin();
+    regs->setBits(MCP23018_REG_IODIRA, BUTTON_MASK, BUTTON_MASK);
+    regs->setBits(MCP23018_REG_GPPUA, BUTTON_MASK, BUTTON_MASK);
+    regs->commit();
+    regs->setBits(MCP23018_REG_GPINTENA, BUTTON_MASK, BUTTON_MASK);
+    regs->setBits(MCP23018_REG_DEFVALA, BUTTON_MASK, 0x00);
+    regs->setBits(MCP23018_REG_INTCONA, BUTTON_MASK, 0x00);
+    regs->commit();
+    regs->set(MCP23018_REG_IODIRB, static_cast<uint8_t>(~LED_MASK));
+    regs->set(MCP23018_REG_GPPUB, LED_MASK);
+    regs->commit();
+}
+
+static void shadowCycle(uint8_t leds, bool interrupt) {
+    uint8_t values[3];
+    regs->read(MCP23018_REG_GPIOA, values, 1);
+    regs->set(MCP23018_REG_OLATB, leds);
+    regs->commit();
+    if (interrupt) {
+        regs->read(MCP23018_REG_INTCAPA, values, sizeof(values));
+    }
+}
+
+/**
+ * @brief Boot plus one second of IOTask with a 500 ms LED blink and two presses
+ */
+template <typename Boot, typename Cycle>
+static void runScenario(Boot boot, Cycle cycle, uint32_t& bootTransactions, uint32_t& runTransactions,
+                        uint32_t& runBytes) {
+    boot();
+    bootTransactions = sim->getTransactions();
+    sim->resetCounters();
+    for (uint32_t t = 0; t < 1000; t += IO_PERIOD_MS) {
+        uint8_t leds = ((t / 500) % 2 == 0) ? 0x01 : 0x00;
+        bool interrupt = (t == 200 || t == 600);
+        cycle(leds, interrupt);
+    }
+    runTransactions = sim->getTransactions();
+    runBytes = sim->getBusBytes();
+}
+
+void test_traffic_against_previous_driver(void) {
+    uint32_t legacyBootTx, legacyRunTx, legacyBytes;
+    runScenario(legacyBoot, legacyCycle, legacyBootTx, legacyRunTx, legacyBytes);
+
+    tearDown();
+    setUp();
+    uint32_t shadowBootTx, shadowRunTx, shadowBytes;
+    runScenario(shadowBoot, shadowCycle, shadowBootTx, shadowRunTx, shadowBytes);
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "boot: %lu -> %lu transactions",
+             (unsigned long)legacyBootTx, (unsigned long)shadowBootTx);
+    TEST_MESSAGE(msg);
+    snprintf(msg, sizeof(msg), "IOTask 1 s @ %d ms: %lu -> %lu transactions/s, %lu -> %lu bus bytes",
+             IO_PERIOD_MS, (unsigned long)legacyRunTx, (unsigned long)shadowRunTx,
+             (unsigned long)legacyBytes, (unsigned long)shadowBytes);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_EQUAL_UINT32(4, shadowBootTx);
+    TEST_ASSERT_TRUE(shadowRunTx * 2 <= legacyRunTx + 4);
+    TEST_ASSERT_TRUE(shadowBootTx * 10 < legacyBootTx);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_begin_is_one_burst_read);
+    RUN_TEST(test_config_commit_is_one_transaction);
+    RUN_TEST(test_unchanged_commit_is_skipped);
+    RUN_TEST(test_output_latch_written_only_on_change);
+    RUN_TEST(test_burst_covers_only_changed_span);
+    RUN_TEST(test_config_and_latch_are_two_bursts);
+    RUN_TEST(test_iocon_is_mirrored_and_mode_bits_masked);
+    RUN_TEST(test_failed_write_is_retried);
+    RUN_TEST(test_recovery_restores_configuration);
+    RUN_TEST(test_interrupt_state_burst_clears_flag);
+    RUN_TEST(test_traffic_against_previous_driver);
+    return UNITY_END();
+}
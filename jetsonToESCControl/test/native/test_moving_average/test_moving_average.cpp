@@ -0,0 +1,198 @@
+/**
+ * @file test_moving_average.cpp
+ * @brief Host tests and micro-benchmark for MoaMovingAverage
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Compares the O(1) running-sum filter against the rescan averaging that
+ * MoaTempControl/MoaBattControl/MoaCurrentControl used before.
+ *
+ * Run with: pio test -e native -f native/test_moving_average
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include "MoaMovingAverage.h"
+
+/**
+ * @brief Reference implementation: the previous per-control averaging
+ *
+ * Heap-allocated circular buffer, full rescan on every sample.
+ */
+class LegacyAverage {
+public:
+    explicit LegacyAverage(uint8_t numSamples)
+        : _numSamples(numSamples), _sampleIndex(0), _sampleCount(0) {
+        _samples = new float[_numSamples];
+        for (uint8_t i = 0; i < _numSamples; i++) {
+            _samples[i] = 0.0f;
+        }
+    }
+
+    ~LegacyAverage() {
+        delete[] _samples;
+    }
+
+    float add(float value) {
+        _samples[_sampleIndex] = value;
+        _sampleIndex = (_sampleIndex + 1) % _numSamples;
+        if (_sampleCount < _numSamples) {
+            _sampleCount++;
+        }
+        float sum = 0.0f;
+        for (uint8_t i = 0; i < _sampleCount; i++) {
+            sum += _samples[i];
+        }
+        return sum / static_cast<float>(_sampleCount);
+    }
+
+    bool isReady() const {
+        return _sampleCount >= _numSamples;
+    }
+
+private:
+    float* _samples;
+    uint8_t _numSamples;
+    uint8_t _sampleIndex;
+    uint8_t _sampleCount;
+};
+
+static float randomSample(float lo, float hi) {
+    return lo + (hi - lo) * (static_cast<float>(rand()) / static_cast<float>(RAND_MAX));
+}
+
+void setUp(void) {
+    srand(1234);
+}
+
+void tearDown(void) {
+}
+
+void test_empty_filter_returns_zero() {
+    MoaMovingAverage<float, 32> filter(10);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, filter.average());
+    TEST_ASSERT_EQUAL_UINT8(0, filter.count());
+    TEST_ASSERT_FALSE(filter.isFull());
+}
+
+void test_window_is_clamped() {
+    MoaMovingAverage<float, 32> filter(0);
+    TEST_ASSERT_EQUAL_UINT8(1, filter.window());
+    filter.setWindow(200);
+    TEST_ASSERT_EQUAL_UINT8(32, filter.window());
+}
+
+void test_partial_window_averages_received_samples() {
+    MoaMovingAverage<float, 32> filter(10);
+    filter.push(10.0f);
+    filter.push(20.0f);
+    TEST_ASSERT_EQUAL_FLOAT(15.0f, filter.average());
+    TEST_ASSERT_FALSE(filter.isFull());
+}
+
+void test_matches_legacy_averaging() {
+    const uint8_t windows[] = {1, 5, 10, 32};
+    for (uint8_t w : windows) {
+        MoaMovingAverage<float, 32> filter(w);
+        LegacyAverage legacy(w);
+        for (int i = 0; i < 5000; i++) {
+            float sample = randomSample(18.0f, 26.0f);
+            filter.push(sample);
+            float expected = legacy.add(sample);
+            TEST_ASSERT_FLOAT_WITHIN(1e-3f, expected, filter.average());
+            TEST_ASSERT_EQUAL(legacy.isReady(), filter.isFull());
+        }
+    }
+}
+
+void test_float_drift_is_corrected() {
+    // Large offsets with small deltas are the worst case for running sums
+    MoaMovingAverage<float, 32> filter(32);
+    LegacyAverage legacy(32);
+    float maxError = 0.0f;
+    for (int i = 0; i < 200000; i++) {
+        float sample = (i % 2 == 0) ? 1000.0f : 0.001f;
+        sample += randomSample(-0.5f, 0.5f);
+        filter.push(sample);
+        float err = fabsf(filter.average() - legacy.add(sample));
+        if (err > maxError) {
+            maxError = err;
+        }
+    }
+    TEST_ASSERT_LESS_THAN(0.01f, maxError);
+}
+
+void test_integer_filter_is_exact() {
+    MoaMovingAverage<int32_t, 16> filter(8);
+    int64_t window[8] = {0};
+    for (int i = 0; i < 10000; i++) {
+        int32_t sample = static_cast<int32_t>(rand() % 200000) - 100000;
+        window[i % 8] = sample;
+        filter.push(sample);
+        if (i >= 7) {
+            int64_t sum = 0;
+            for (int k = 0; k < 8; k++) {
+                sum += window[k];
+            }
+            TEST_ASSERT_EQUAL_INT64(sum, filter.sum());
+        }
+    }
+}
+
+void test_set_window_resets() {
+    MoaMovingAverage<float, 32> filter(4);
+    for (int i = 0; i < 4; i++) {
+        filter.push(5.0f);
+    }
+    TEST_ASSERT_TRUE(filter.isFull());
+    filter.setWindow(6);
+    TEST_ASSERT_EQUAL_UINT8(0, filter.count());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, filter.average());
+}
+
+void test_benchmark_against_legacy() {
+    const int iterations = 2000000;
+    const uint8_t window = 32;
+    volatile float sink = 0.0f;
+
+    MoaMovingAverage<float, 32> filter(window);
+    LegacyAverage legacy(window);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        sink = legacy.add(static_cast<float>(i & 0xFF));
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        filter.push(static_cast<float>(i & 0xFF));
+        sink = filter.average();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    (void)sink;
+
+    double legacyNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+    double filterNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / iterations;
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "window=%u legacy=%.1f ns/sample running-sum=%.1f ns/sample (%.1fx)",
+             window, legacyNs, filterNs, legacyNs / filterNs);
+    TEST_MESSAGE(msg);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_empty_filter_returns_zero);
+    RUN_TEST(test_window_is_clamped);
+    RUN_TEST(test_partial_window_averages_received_samples);
+    RUN_TEST(test_matches_legacy_averaging);
+    RUN_TEST(test_float_drift_is_corrected);
+    RUN_TEST(test_integer_filter_is_exact);
+    RUN_TEST(test_set_window_resets);
+    RUN_TEST(test_benchmark_against_legacy);
+
+    return UNITY_END();
+}
@@ -0,0 +1,180 @@
+/**
+ * @file test_ntc_table.cpp
+ * @brief Host tests and benchmark for the compile-time NTC table
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Checks the table lookup against the Beta equation the NTC_Thermistor
+ * library evaluated on every read (double precision, same divider) from
+ * -40 to 150 degC, the entries against the constexpr generator, the
+ * open/short ends and monotonicity over every input code, and benchmarks
+ * the lookup against the float Beta equation.
+ *
+ * The host has an FPU, so the speed-up measured here understates the gain
+ * on the ESP32-C3 (soft-float logf); see test/test_ntc_bench for the
+ * on-target cycle counts.
+ *
+ * Run with: pio test -e native -f native/test_ntc_table
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include "Constants.h"
+#include "MoaNtcTable.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t cycleCount() { return __rdtsc(); }
+#else
+#include <chrono>
+static inline uint64_t cycleCount() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+static const double T0_K = NTC_NOMINAL_TEMP_C + 273.15;
+
+/**
+ * @brief Reference: Beta equation on the divider voltage (degC)
+ */
+static double betaCelsius(double mv) {
+    double resistance = NTC_REFERENCE_RESISTANCE * mv / (NTC_ADC_VREF_MV - mv);
+    return 1.0 / (1.0 / T0_K + log(resistance / NTC_NOMINAL_RESISTANCE) / NTC_BETA_COEFFICIENT) - 273.15;
+}
+
+/**
+ * @brief Divider voltage at a temperature (mV)
+ */
+static double dividerMv(double celsius) {
+    double resistance = NTC_NOMINAL_RESISTANCE * exp(NTC_BETA_COEFFICIENT * (1.0 / (celsius + 273.15) - 1.0 / T0_K));
+    return NTC_ADC_VREF_MV * resistance / (resistance + NTC_REFERENCE_RESISTANCE);
+}
+
+/**
+ * @brief Previous per-read path: float Beta equation on one millivolt read
+ */
+static float legacyCelsius(uint32_t mv) {
+    float voltage = static_cast<float>(mv);
+    float resistance = NTC_REFERENCE_RESISTANCE / (NTC_ADC_VREF_MV / voltage - 1.0f);
+    return 1.0f / (1.0f / (NTC_NOMINAL_TEMP_C + 273.15f) +
+                   logf(resistance / NTC_NOMINAL_RESISTANCE) / NTC_BETA_COEFFICIENT) - 273.15f;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_matches_the_beta_equation_from_minus_40_to_150() {
+    int32_t worst = 0;
+    double worstAt = 0.0;
+    for (int32_t deci = -400; deci <= 1500; deci++) {
+        double celsius = deci / 10.0;
+        uint32_t q4 = static_cast<uint32_t>(lround(dividerMv(celsius) * (1 << MOA_NTC_MV_FRAC_BITS)));
+        int32_t error = moaNtcCentiCelsius(q4) - static_cast<int32_t>(lround(betaCelsius(q4 / 16.0) * 100.0));
+        if (error < 0) {
+            error = -error;
+        }
+        if (error > worst) {
+            worst = error;
+            worstAt = celsius;
+        }
+    }
+    char msg[80];
+    snprintf(msg, sizeof(msg), "worst interpolation error %.2f degC at %.1f degC", worst / 100.0, worstAt);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(worst <= 25);
+}
+
+void test_entries_match_the_generator() {
+    for (size_t i = 1; i < MOA_NTC_TABLE_SIZE - 1; i++) {
+        double mv = static_cast<double>(i) * NTC_LUT_STEP_MV;
+        if (mv >= NTC_ADC_VREF_MV) {
+            break;
+        }
+        double centi = betaCelsius(mv) * 100.0;
+        if (centi < MOA_NTC_MIN_CC || centi > MOA_NTC_MAX_CC) {
+            continue;                                   // Clamped
+        }
+        TEST_ASSERT_INT32_WITHIN(1, static_cast<int32_t>(lround(centi)), moaNtcTableEntry(i));
+    }
+}
+
+void test_nominal_point_at_the_divider_midpoint() {
+    uint32_t q4 = static_cast<uint32_t>(NTC_ADC_VREF_MV) << (MOA_NTC_MV_FRAC_BITS - 1);
+    TEST_ASSERT_INT32_WITHIN(1, 2500, moaNtcCentiCelsius(q4));
+}
+
+void test_short_and_open_fall_outside_the_valid_range() {
+    TEST_ASSERT_EQUAL_INT32(MOA_NTC_MAX_CC, moaNtcCentiCelsius(0));
+    TEST_ASSERT_EQUAL_INT32(MOA_NTC_MIN_CC, moaNtcCentiCelsius(NTC_ADC_VREF_MV << MOA_NTC_MV_FRAC_BITS));
+    TEST_ASSERT_EQUAL_INT32(MOA_NTC_MIN_CC, moaNtcCentiCelsius(0xFFFFFFFFUL));
+    TEST_ASSERT_TRUE(MOA_NTC_MAX_CC > 15000);           // MoaTempControl rejects > 150 degC
+    TEST_ASSERT_TRUE(MOA_NTC_MIN_CC < -4000);           // ... and < -40 degC
+}
+
+void test_monotonic_over_every_input() {
+    int32_t previous = moaNtcCentiCelsius(0);
+    for (uint32_t q4 = 1; q4 <= (static_cast<uint32_t>(NTC_ADC_VREF_MV) << MOA_NTC_MV_FRAC_BITS); q4++) {
+        int32_t centi = moaNtcCentiCelsius(q4);
+        TEST_ASSERT_TRUE(centi <= previous);
+        previous = centi;
+    }
+}
+
+void test_oversampling_resolves_below_one_millivolt() {
+    // At 80 degC one millivolt is ~0.1 degC; 16 reads split it in sixteenths
+    uint32_t q4 = static_cast<uint32_t>(lround(dividerMv(80.0) * 16.0));
+    int32_t whole = moaNtcCentiCelsius(q4 & ~0xFUL);
+    int32_t half = moaNtcCentiCelsius((q4 & ~0xFUL) + 8);
+    int32_t next = moaNtcCentiCelsius((q4 & ~0xFUL) + 16);
+    TEST_ASSERT_TRUE(whole > half && half > next);
+}
+
+void test_benchmark_against_the_beta_equation() {
+    const int iterations = 1000000;
+    volatile int32_t isink = 0;
+    volatile float fsink = 0.0f;
+
+    // Previous path: one read, float Beta equation, then "* 100" in MoaTempControl
+    uint64_t c0 = cycleCount();
+    for (int i = 0; i < iterations; i++) {
+        float celsius = legacyCelsius(100 + (i & 0xFFF));
+        fsink = celsius;
+        isink = static_cast<int32_t>(celsius * 100.0f);
+    }
+    uint64_t c1 = cycleCount();
+    // Table path: oversampled sum straight to centi-degC
+    for (int i = 0; i < iterations; i++) {
+        isink = moaNtcCentiCelsius((100 + (i & 0xFFF)) << MOA_NTC_MV_FRAC_BITS);
+    }
+    uint64_t c2 = cycleCount();
+    (void)isink;
+    (void)fsink;
+
+    double betaCycles = static_cast<double>(c1 - c0) / iterations;
+    double tableCycles = static_cast<double>(c2 - c1) / iterations;
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "host: beta=%.1f cycles/read table=%.1f cycles/read (%.1fx)",
+             betaCycles, tableCycles, betaCycles / tableCycles);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(tableCycles < betaCycles);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_matches_the_beta_equation_from_minus_40_to_150);
+    RUN_TEST(test_entries_match_the_generator);
+    RUN_TEST(test_nominal_point_at_the_divider_midpoint);
+    RUN_TEST(test_short_and_open_fall_outside_the_valid_range);
+    RUN_TEST(test_monotonic_over_every_input);
+    RUN_TEST(test_oversampling_resolves_below_one_millivolt);
+    RUN_TEST(test_benchmark_against_the_beta_equation);
+
+    return UNITY_END();
+}
@@ -0,0 +1,308 @@
+/**
+ * @file test_overcurrent_trip.cpp
+ * @brief Host tests for the MoaOvercurrentTrip fast protection path
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Checks the comparator (count-to-trip, blanking, latch, reverse side) and
+ * measures the worst-case trip latency of a simulated current step through
+ * SimulatedAdcSource (DMA frames of ADC_DMA_FRAME_CONVERSIONS) ->
+ * MoaAdcSampler -> MoaOvercurrentTrip, with poll() called at the
+ * ProtectionTask period and the step swept across its phases.
+ *
+ * Run with: pio test -e native -f native/test_overcurrent_trip
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include "Constants.h"
+#include "MoaOvercurrentTrip.h"
+#include "MoaAdcSampler.h"
+#include "SimulatedAdcSource.h"
+
+static const uint8_t PIN_CURRENT = 3;
+static const uint8_t PIN_BATT = 1;
+
+/**
+ * @brief ACS759-200B transfer function: I (A) -> 12-bit raw code at 3.3 V
+ */
+static uint16_t ampsToRaw(float amps) {
+    float volts = CURRENT_SENSOR_OFFSET + amps * CURRENT_SENSOR_SENSITIVITY;
+    return static_cast<uint16_t>(volts / 3.3f * 4095.0f + 0.5f);
+}
+
+static MoaOvercurrentTrip* trip;
+
+struct TripRecord {
+    int calls;
+    int8_t direction;
+    uint16_t raw;
+    uint32_t rawSampleCount;   ///< Current-channel conversions seen when the handler ran
+    MoaAdcSampler* sampler;
+    uint8_t slot;
+};
+
+static TripRecord record;
+
+static void onTrip(int8_t direction, uint16_t rawAdc, void* context) {
+    TripRecord* r = static_cast<TripRecord*>(context);
+    r->calls++;
+    r->direction = direction;
+    r->raw = rawAdc;
+    if (r->sampler != nullptr) {
+        r->rawSampleCount = r->sampler->getRawSampleCount(r->slot);
+    }
+}
+
+static void feedRepeated(uint16_t raw, int count) {
+    for (int i = 0; i < count; i++) {
+        trip->feed(raw);
+    }
+}
+
+void setUp(void) {
+    record = TripRecord();
+    trip = new MoaOvercurrentTrip();
+    trip->setThresholds(ampsToRaw(CURRENT_FAST_TRIP_THRESHOLD), 0);
+    trip->setTripCount(4);
+    trip->setTripHandler(onTrip, &record);
+}
+
+void tearDown(void) {
+    delete trip;
+}
+
+void test_disarmed_until_arm() {
+    feedRepeated(4095, 10);
+    TEST_ASSERT_FALSE(trip->isArmed());
+    TEST_ASSERT_FALSE(trip->isTripped());
+    TEST_ASSERT_EQUAL(0, record.calls);
+}
+
+void test_trips_after_count_consecutive_samples() {
+    trip->arm();
+    uint16_t high = ampsToRaw(200.0f);
+
+    TEST_ASSERT_FALSE(trip->feed(high));
+    TEST_ASSERT_FALSE(trip->feed(high));
+    TEST_ASSERT_FALSE(trip->feed(high));
+    TEST_ASSERT_TRUE(trip->feed(high));
+
+    TEST_ASSERT_TRUE(trip->isTripped());
+    TEST_ASSERT_EQUAL(1, record.calls);
+    TEST_ASSERT_EQUAL_INT8(1, record.direction);
+    TEST_ASSERT_EQUAL_UINT16(high, trip->getTripRaw());
+}
+
+void test_isolated_spikes_do_not_trip() {
+    trip->arm();
+    uint16_t high = ampsToRaw(200.0f);
+    uint16_t normal = ampsToRaw(50.0f);
+
+    // Three-sample spikes separated by one normal sample never reach count 4
+    for (int i = 0; i < 100; i++) {
+        feedRepeated(high, 3);
+        trip->feed(normal);
+    }
+    TEST_ASSERT_FALSE(trip->isTripped());
+    TEST_ASSERT_EQUAL(0, record.calls);
+}
+
+void test_blanking_after_arm_and_blank() {
+    trip->setBlankingSamples(50);
+    trip->arm();
+    uint16_t high = ampsToRaw(200.0f);
+
+    feedRepeated(high, 50);
+    TEST_ASSERT_FALSE(trip->isTripped());
+    feedRepeated(high, 4);
+    TEST_ASSERT_TRUE(trip->isTripped());
+
+    // blank() restarts the window once re-armed
+    trip->arm();
+    feedRepeated(high, 40);
+    trip->blank();
+    feedRepeated(high, 50);
+    TEST_ASSERT_FALSE(trip->isTripped());
+    feedRepeated(high, 4);
+    TEST_ASSERT_TRUE(trip->isTripped());
+    TEST_ASSERT_EQUAL_UINT32(2, trip->getTripTotal());
+}
+
+void test_latches_until_rearmed() {
+    trip->arm();
+    feedRepeated(ampsToRaw(200.0f), 20);
+    TEST_ASSERT_EQUAL(1, record.calls);
+
+    feedRepeated(ampsToRaw(0.0f), 20);
+    TEST_ASSERT_TRUE(trip->isTripped());
+
+    trip->arm();
+    TEST_ASSERT_FALSE(trip->isTripped());
+    feedRepeated(ampsToRaw(200.0f), 4);
+    TEST_ASSERT_EQUAL(2, record.calls);
+}
+
+void test_reverse_trip() {
+    trip->setThresholds(ampsToRaw(CURRENT_FAST_TRIP_THRESHOLD), ampsToRaw(-170.0f));
+    trip->arm();
+
+    feedRepeated(ampsToRaw(-200.0f), 4);
+    TEST_ASSERT_TRUE(trip->isTripped());
+    TEST_ASSERT_EQUAL_INT8(-1, record.direction);
+}
+
+void test_zero_threshold_disables_side() {
+    trip->setThresholds(0, 0);
+    trip->arm();
+
+    feedRepeated(4095, 100);
+    feedRepeated(0, 100);
+    TEST_ASSERT_FALSE(trip->isTripped());
+}
+
+void test_disarm_stops_comparator() {
+    trip->arm();
+    trip->disarm();
+    feedRepeated(4095, 10);
+    TEST_ASSERT_FALSE(trip->isTripped());
+    TEST_ASSERT_FALSE(trip->isArmed());
+}
+
+// === Trip latency through the sampler ===
+
+struct StepProfile {
+    uint32_t stepIndex;   ///< Per-pin sample index of the step
+    uint16_t before;
+    uint16_t after;
+};
+
+static uint16_t stepWaveform(uint8_t pin, uint32_t index, void* context) {
+    (void)pin;
+    const StepProfile* p = static_cast<const StepProfile*>(context);
+    return (index < p->stepIndex) ? p->before : p->after;
+}
+
+/**
+ * @brief Run one 40 A -> 250 A step through a framed source and the sampler
+ * @param stepUs Time of the step
+ * @param samplesToTrip Receives the faulty current samples consumed by the trip
+ * @return uint32_t Step to the ProtectionTask poll that tripped (us), 0 if none
+ */
+static uint32_t measureStepLatency(uint32_t stepUs, uint32_t* samplesToTrip) {
+    SimulatedAdcSource source;
+    source.setFrameConversions(ADC_DMA_FRAME_CONVERSIONS);
+    MoaAdcSampler sampler(&source);
+    MoaOvercurrentTrip stepTrip;
+    TripRecord stepRecord = TripRecord();
+
+    int8_t cur = sampler.addChannel(PIN_CURRENT);
+    sampler.addChannel(PIN_BATT);
+    sampler.setSampleRate(ADC_CONTINUOUS_SAMPLE_RATE_HZ);
+    sampler.setOversampling(ADC_OVERSAMPLING_FACTOR);
+
+    stepTrip.setThresholds(ampsToRaw(CURRENT_FAST_TRIP_THRESHOLD), 0);
+    stepTrip.setBlankingSamples(CURRENT_FAST_TRIP_BLANKING_SAMPLES);
+    stepTrip.setTripCount(CURRENT_FAST_TRIP_COUNT);
+    stepTrip.setTripHandler(onTrip, &stepRecord);
+    sampler.setTripMonitor(cur, &stepTrip);
+    stepRecord.sampler = &sampler;
+    stepRecord.slot = static_cast<uint8_t>(cur);
+
+    // First current sample converted at or after the step (one every 1/perPinHz)
+    const uint32_t perPinHz = ADC_CONTINUOUS_SAMPLE_RATE_HZ / 2;
+    StepProfile profile;
+    profile.stepIndex = static_cast<uint32_t>((static_cast<uint64_t>(stepUs) * perPinHz + 999999ULL) / 1000000ULL);
+    profile.before = ampsToRaw(40.0f);
+    profile.after = ampsToRaw(250.0f);
+    source.setWaveform(PIN_CURRENT, stepWaveform, &profile);
+    source.setConstant(PIN_BATT, 3000);
+
+    if (!sampler.begin()) {
+        return 0;
+    }
+    stepTrip.arm();
+
+    // ProtectionTask: poll() every TASK_PROTECTION_PERIOD_MS
+    const uint32_t periodUs = TASK_PROTECTION_PERIOD_MS * 1000;
+    uint32_t nowUs = 0;
+    uint16_t block[MOA_ADC_BLOCK_CAPACITY];
+    while (nowUs < stepUs + 100000 && stepRecord.calls == 0) {
+        source.advance(periodUs);
+        nowUs += periodUs;
+        sampler.poll();
+        sampler.takeBlock(cur, block, MOA_ADC_BLOCK_CAPACITY);
+    }
+    if (stepRecord.calls != 1 || stepRecord.direction != 1) {
+        return 0;
+    }
+    *samplesToTrip = stepRecord.rawSampleCount - profile.stepIndex;
+    return nowUs - stepUs;
+}
+
+void test_step_trip_latency_worst_case() {
+    // Sweep the step over every phase of the poll period against the DMA
+    // frames: they line up again after 80 ms (5 ms x 3.2 ms)
+    const uint32_t periodUs = TASK_PROTECTION_PERIOD_MS * 1000;
+    const uint32_t frameUs = static_cast<uint32_t>(1000000ULL * ADC_DMA_FRAME_CONVERSIONS / ADC_CONTINUOUS_SAMPLE_RATE_HZ);
+    const uint32_t countUs = CURRENT_FAST_TRIP_COUNT * 1000000UL / (ADC_CONTINUOUS_SAMPLE_RATE_HZ / 2);
+
+    uint32_t best = UINT32_MAX;
+    uint32_t worst = 0;
+    uint64_t sum = 0;
+    uint32_t runs = 0;
+    for (uint32_t stepUs = 100000; stepUs < 180000; stepUs += 100) {
+        uint32_t samplesToTrip = 0;
+        uint32_t latencyUs = measureStepLatency(stepUs, &samplesToTrip);
+        TEST_ASSERT_TRUE(latencyUs > 0);
+
+        // Sample domain: the trip fires on exactly the count-th faulty sample
+        TEST_ASSERT_EQUAL_UINT32(CURRENT_FAST_TRIP_COUNT, samplesToTrip);
+
+        best = (latencyUs < best) ? latencyUs : best;
+        worst = (latencyUs > worst) ? latencyUs : worst;
+        sum += latencyUs;
+        runs++;
+    }
+
+    // Wall clock: one poll period, one DMA frame, the count window
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(periodUs + frameUs + countUs, worst);
+    TEST_ASSERT_TRUE(frameUs < periodUs);
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "Step -> trip over %lu phases: best %lu us, mean %lu us, worst %lu us (bound %lu us)",
+             static_cast<unsigned long>(runs), static_cast<unsigned long>(best),
+             static_cast<unsigned long>(sum / runs), static_cast<unsigned long>(worst),
+             static_cast<unsigned long>(periodUs + frameUs + countUs));
+    TEST_MESSAGE(msg);
+}
+
+void test_frames_hold_back_samples() {
+    SimulatedAdcSource source;
+    source.setFrameConversions(ADC_DMA_FRAME_CONVERSIONS);
+    uint8_t pins[2] = { PIN_CURRENT, PIN_BATT };
+    TEST_ASSERT_TRUE(source.begin(pins, 2, ADC_CONTINUOUS_SAMPLE_RATE_HZ));
+
+    MoaAdcRawSample out[64];
+    source.produce(ADC_DMA_FRAME_CONVERSIONS - 1);
+    TEST_ASSERT_EQUAL_UINT32(0, source.read(out, 64));
+    source.produce(1);
+    TEST_ASSERT_EQUAL_UINT32(ADC_DMA_FRAME_CONVERSIONS, source.read(out, 64));
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_disarmed_until_arm);
+    RUN_TEST(test_trips_after_count_consecutive_samples);
+    RUN_TEST(test_isolated_spikes_do_not_trip);
+    RUN_TEST(test_blanking_after_arm_and_blank);
+    RUN_TEST(test_latches_until_rearmed);
+    RUN_TEST(test_reverse_trip);
+    RUN_TEST(test_zero_threshold_disables_side);
+    RUN_TEST(test_disarm_stops_comparator);
+    RUN_TEST(test_frames_hold_back_samples);
+    RUN_TEST(test_step_trip_latency_worst_case);
+
+    return UNITY_END();
+}
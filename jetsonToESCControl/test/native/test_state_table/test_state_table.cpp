@@ -0,0 +1,465 @@
+/**
+ * @file test_state_table.cpp
+ * @brief Host equivalence tests: MoaStateTable against the MoaState classes
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Both engines drive a recording IMoaActions double. For every state and
+ * every event in the alphabet (all six control types, command types and
+ * values including out-of-range ones) the two engines must produce the
+ * same output calls in the same order and land in the same state. Long
+ * pseudo-random event walks are then compared step by step.
+ *
+ * The benchmark reports dispatch cost of both engines and checks that the
+ * table engine never touches the heap (global operator new is counted).
+ *
+ * Run with: pio test -e native -f native/test_state_table
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <new>
+#include "Constants.h"
+#include "MoaLogCodes.h"
+#include "MoaStateMachine.h"
+#include "MoaStateTable.h"
+
+// =============================================================================
+// Heap accounting
+// =============================================================================
+
+static size_t heapAllocs = 0;
+
+void* operator new(size_t size) {
+    heapAllocs++;
+    void* p = malloc(size ? size : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+// =============================================================================
+// Recording outputs
+// =============================================================================
+
+enum ActionOp : uint8_t {
+    OP_STOP_MOTOR, OP_ENGAGE, OP_DISENGAGE, OP_STEP_DOWN, OP_BATT_LEVEL, OP_OVERHEAT,
+    OP_OVERCURRENT, OP_LOCKED, OP_UNLOCKED, OP_CONFIG_ENTER, OP_CONFIG_EXIT, OP_WAVE,
+    OP_REFRESH, OP_OTA_START, OP_OTA_STOP, OP_LOG_SYSTEM, OP_REMOTE_THROTTLE
+};
+
+#define TRACE_MAX 32
+
+/**
+ * @brief IMoaActions double that records calls (fixed buffer, no heap)
+ */
+class RecordingActions : public IMoaActions {
+public:
+    struct Call {
+        uint8_t op;
+        int arg;
+    };
+
+    Call calls[TRACE_MAX];
+    size_t count = 0;
+    size_t total = 0;
+
+    void clear() { count = 0; }
+
+    void stopMotor() override { record(OP_STOP_MOTOR, 0); }
+    void engageThrottle(uint8_t commandType) override { record(OP_ENGAGE, commandType); }
+    void disengageThrottle() override { record(OP_DISENGAGE, 0); }
+    void handleThrottleStepDown() override { record(OP_STEP_DOWN, 0); }
+    void showBatteryLevel(MoaBattLevel level) override { record(OP_BATT_LEVEL, static_cast<int>(level)); }
+    void indicateOverheat(bool active) override { record(OP_OVERHEAT, active); }
+    void indicateOvercurrent(bool active) override { record(OP_OVERCURRENT, active); }
+    void showBoardLocked() override { record(OP_LOCKED, 0); }
+    void showBoardUnlocked() override { record(OP_UNLOCKED, 0); }
+    void enterConfigMode() override { record(OP_CONFIG_ENTER, 0); }
+    void exitConfigMode() override { record(OP_CONFIG_EXIT, 0); }
+    void waveAllLeds(bool fast) override { record(OP_WAVE, fast); }
+    void refreshLedIndicators() override { record(OP_REFRESH, 0); }
+    void startOTA() override { record(OP_OTA_START, 0); }
+    void stopOTA() override { record(OP_OTA_STOP, 0); }
+    void logSystem(uint8_t code) override { record(OP_LOG_SYSTEM, code); }
+    void setRemoteThrottle(uint16_t duty) override { record(OP_REMOTE_THROTTLE, duty); }
+
+private:
+    void record(uint8_t op, int arg) {
+        total++;
+        if (count < TRACE_MAX) {
+            calls[count].op = op;
+            calls[count].arg = arg;
+            count++;
+        }
+    }
+};
+
+// =============================================================================
+// Engines side by side
+// =============================================================================
+
+/**
+ * @brief Route a command by controlType, as MoaStateMachineWrapper does
+ */
+template <typename Engine>
+static void route(Engine& engine, const ControlCommand& cmd) {
+    switch (cmd.controlType) {
+        case CONTROL_TYPE_TIMER:       engine.timerExpired(TimerEvent(cmd)); break;
+        case CONTROL_TYPE_TEMPERATURE: engine.temperatureCrossedLimit(TempEvent(cmd)); break;
+        case CONTROL_TYPE_BATTERY:     engine.batteryLevelCrossedLimit(BattEvent(cmd)); break;
+        case CONTROL_TYPE_CURRENT:     engine.overcurrentDetected(CurrentEvent(cmd)); break;
+        case CONTROL_TYPE_BUTTON:      engine.buttonClick(ButtonEvent(cmd)); break;
+        case CONTROL_TYPE_REMOTE:      engine.remoteCommand(RemoteEvent(cmd)); break;
+        default: break;
+    }
+}
+
+/**
+ * @brief Both engines, each with its own recorder
+ */
+struct Pair {
+    RecordingActions legacyOut;
+    RecordingActions tableOut;
+    MoaStateMachine legacy;
+    MoaStateTable table;
+
+    Pair() : legacy(legacyOut), table(tableOut) {}
+
+    void start() {
+        legacy.setState(legacy.getInitState());
+        table.start();
+    }
+
+    void feed(const ControlCommand& cmd) {
+        route(legacy, cmd);
+        route(table, cmd);
+    }
+
+    void clear() {
+        legacyOut.clear();
+        tableOut.clear();
+    }
+
+    /**
+     * @brief Legacy current state as a MoaStateId
+     */
+    MoaStateId legacyState() {
+        MoaState* s = legacy.getState();
+        if (s == legacy.getInitState()) return MoaStateId::INIT;
+        if (s == legacy.getIdleState()) return MoaStateId::IDLE;
+        if (s == legacy.getSurfingState()) return MoaStateId::SURFING;
+        if (s == legacy.getOverHeatingState()) return MoaStateId::OVER_HEATING;
+        if (s == legacy.getOverCurrentState()) return MoaStateId::OVER_CURRENT;
+        if (s == legacy.getBatteryLowState()) return MoaStateId::BATTERY_LOW;
+        if (s == legacy.getConfigState()) return MoaStateId::CONFIG;
+        return MoaStateId::NONE;
+    }
+
+    /**
+     * @brief True if both engines did the same thing since the last clear()
+     */
+    bool same() {
+        if (legacyState() != table.getState() || legacyOut.count != tableOut.count) {
+            return false;
+        }
+        for (size_t i = 0; i < legacyOut.count; i++) {
+            if (legacyOut.calls[i].op != tableOut.calls[i].op || legacyOut.calls[i].arg != tableOut.calls[i].arg) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+static ControlCommand makeCmd(int controlType, int commandType, int value) {
+    ControlCommand c;
+    c.controlType = static_cast<uint8_t>(controlType);
+    c.commandType = static_cast<uint8_t>(commandType);
+    c.payload = static_cast<uint16_t>(value);
+    return c;
+}
+
+static const ControlCommand STOP_LONG = makeCmd(CONTROL_TYPE_BUTTON, COMMAND_BUTTON_STOP, BUTTON_EVENT_LONG_PRESS);
+static const ControlCommand STOP_VERY_LONG = makeCmd(CONTROL_TYPE_BUTTON, COMMAND_BUTTON_STOP, BUTTON_EVENT_VERY_LONG_PRESS);
+static const ControlCommand THROTTLE_25 = makeCmd(CONTROL_TYPE_BUTTON, COMMAND_BUTTON_25, BUTTON_EVENT_PRESS);
+static const ControlCommand TEMP_ABOVE = makeCmd(CONTROL_TYPE_TEMPERATURE, COMMAND_TEMP_CROSSED_ABOVE, 700);
+static const ControlCommand OVERCURRENT = makeCmd(CONTROL_TYPE_CURRENT, COMMAND_CURRENT_OVERCURRENT, 1900);
+static const ControlCommand BATT_LOW = makeCmd(CONTROL_TYPE_BATTERY, COMMAND_BATT_LEVEL_LOW, 21000);
+
+/**
+ * @brief Drive a freshly started pair into the given state
+ */
+static void driveTo(Pair& p, MoaStateId target) {
+    switch (target) {
+        case MoaStateId::INIT:
+            break;
+        case MoaStateId::IDLE:
+            p.feed(STOP_LONG);
+            break;
+        case MoaStateId::SURFING:
+            p.feed(STOP_LONG);
+            p.feed(THROTTLE_25);
+            break;
+        case MoaStateId::OVER_HEATING:
+            driveTo(p, MoaStateId::SURFING);
+            p.feed(TEMP_ABOVE);
+            break;
+        case MoaStateId::OVER_CURRENT:
+            driveTo(p, MoaStateId::SURFING);
+            p.feed(OVERCURRENT);
+            break;
+        case MoaStateId::BATTERY_LOW:
+            driveTo(p, MoaStateId::OVER_HEATING);
+            p.feed(BATT_LOW);
+            break;
+        case MoaStateId::CONFIG:
+            p.feed(STOP_VERY_LONG);
+            break;
+        default:
+            break;
+    }
+}
+
+// Event alphabet: every control type (plus an unknown one) x command types x values
+static const int kControlTypes[] = {
+    CONTROL_TYPE_TIMER, CONTROL_TYPE_TEMPERATURE, CONTROL_TYPE_BATTERY, CONTROL_TYPE_CURRENT, CONTROL_TYPE_BUTTON,
+    CONTROL_TYPE_REMOTE, 99
+};
+#define CMD_TYPE_MIN   -1
+#define CMD_TYPE_MAX   7
+#define VALUE_MIN      -1
+#define VALUE_MAX      5
+
+static size_t alphabet(ControlCommand* out) {
+    size_t n = 0;
+    for (int ct : kControlTypes) {
+        for (int cmd = CMD_TYPE_MIN; cmd <= CMD_TYPE_MAX; cmd++) {
+            for (int v = VALUE_MIN; v <= VALUE_MAX; v++) {
+                out[n++] = makeCmd(ct, cmd, v);
+            }
+        }
+    }
+    return n;
+}
+
+#define ALPHABET_MAX (7 * (CMD_TYPE_MAX - CMD_TYPE_MIN + 1) * (VALUE_MAX - VALUE_MIN + 1))
+
+static ControlCommand events[ALPHABET_MAX];
+static size_t eventCount;
+
+void setUp(void) {
+    eventCount = alphabet(events);
+}
+
+void tearDown(void) {
+}
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+void test_start_enters_init(void) {
+    Pair p;
+    p.start();
+    TEST_ASSERT_TRUE(p.same());
+    TEST_ASSERT_EQUAL(MoaStateId::INIT, p.table.getState());
+    TEST_ASSERT_EQUAL_UINT32(3, p.tableOut.count);    // locked, wave, refresh
+}
+
+void test_paths_reach_every_state(void) {
+    for (uint8_t s = 0; s < static_cast<uint8_t>(MoaStateId::COUNT); s++) {
+        Pair p;
+        p.start();
+        driveTo(p, static_cast<MoaStateId>(s));
+        TEST_ASSERT_EQUAL_UINT8(s, static_cast<uint8_t>(p.table.getState()));
+        TEST_ASSERT_EQUAL_UINT8(s, static_cast<uint8_t>(p.legacyState()));
+    }
+}
+
+void test_every_state_event_pair_matches(void) {
+    size_t compared = 0;
+    size_t transitions = 0;
+    for (uint8_t s = 0; s < static_cast<uint8_t>(MoaStateId::COUNT); s++) {
+        for (size_t e = 0; e < eventCount; e++) {
+            Pair p;
+            p.start();
+            driveTo(p, static_cast<MoaStateId>(s));
+            p.clear();
+            p.feed(events[e]);
+
+            if (!p.same()) {
+                char msg[128];
+                snprintf(msg, sizeof(msg), "state %s, event {%d,%d,%d}: legacy -> %s, table -> %s",
+                         MoaStateTable::getStateName(static_cast<MoaStateId>(s)),
+                         events[e].controlType, events[e].commandType, (int)events[e].payload,
+                         MoaStateTable::getStateName(p.legacyState()),
+                         MoaStateTable::getStateName(p.table.getState()));
+                TEST_FAIL_MESSAGE(msg);
+            }
+            compared++;
+            if (p.table.getState() != static_cast<MoaStateId>(s)) {
+                transitions++;
+            }
+        }
+    }
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%u (state, event) pairs identical, %u change state",
+             (unsigned)compared, (unsigned)transitions);
+    TEST_MESSAGE(msg);
+}
+
+void test_every_two_event_sequence_matches(void) {
+    // Second-order check: every pair of events from every state
+    size_t compared = 0;
+    for (uint8_t s = 0; s < static_cast<uint8_t>(MoaStateId::COUNT); s++) {
+        for (size_t a = 0; a < eventCount; a++) {
+            if (events[a].controlType == 99) {
+                continue;
+            }
+            for (size_t b = 0; b < eventCount; b++) {
+                Pair q;
+                q.start();
+                driveTo(q, static_cast<MoaStateId>(s));
+                q.feed(events[a]);
+                q.clear();
+                q.feed(events[b]);
+                TEST_ASSERT_TRUE(q.same());
+                compared++;
+            }
+        }
+    }
+    char msg[64];
+    snprintf(msg, sizeof(msg), "%u two-event sequences identical", (unsigned)compared);
+    TEST_MESSAGE(msg);
+}
+
+void test_random_walks_match(void) {
+    // Events weighted towards meaningful commands so every state is visited
+    static const ControlCommand pool[] = {
+        STOP_LONG, STOP_VERY_LONG, THROTTLE_25, TEMP_ABOVE, OVERCURRENT, BATT_LOW,
+        makeCmd(CONTROL_TYPE_BUTTON, COMMAND_BUTTON_STOP, BUTTON_EVENT_PRESS),
+        makeCmd(CONTROL_TYPE_BUTTON, COMMAND_BUTTON_100, BUTTON_EVENT_PRESS),
+        makeCmd(CONTROL_TYPE_BUTTON, COMMAND_BUTTON_50, BUTTON_EVENT_RELEASE),
+        makeCmd(CONTROL_TYPE_TEMPERATURE, COMMAND_TEMP_CROSSED_BELOW, 500),
+        makeCmd(CONTROL_TYPE_CURRENT, COMMAND_CURRENT_NORMAL, 100),
+        makeCmd(CONTROL_TYPE_CURRENT, COMMAND_CURRENT_REVERSE_OVERCURRENT, -900),
+        makeCmd(CONTROL_TYPE_BATTERY, COMMAND_BATT_LEVEL_MEDIUM, 24000),
+        makeCmd(CONTROL_TYPE_BATTERY, COMMAND_BATT_LEVEL_HIGH, 25000),
+        makeCmd(CONTROL_TYPE_BATTERY, COMMAND_BATT_LEVEL_STOP, 20000),
+        makeCmd(CONTROL_TYPE_TIMER, TIMER_ID_THROTTLE, 0),
+        makeCmd(CONTROL_TYPE_TIMER, TIMER_ID_FULL_THROTTLE, 0),
+        makeCmd(CONTROL_TYPE_REMOTE, COMMAND_REMOTE_ARM, 0),
+        makeCmd(CONTROL_TYPE_REMOTE, COMMAND_REMOTE_THROTTLE, 80),
+        makeCmd(CONTROL_TYPE_REMOTE, COMMAND_REMOTE_THROTTLE, 0),
+        makeCmd(CONTROL_TYPE_REMOTE, COMMAND_REMOTE_DISARM, 0),
+    };
+    const size_t poolSize = sizeof(pool) / sizeof(pool[0]);
+
+    uint32_t visited = 0;
+    uint32_t seed = 0x2545F491;
+    for (int walk = 0; walk < 20; walk++) {
+        Pair p;
+        p.start();
+        for (int step = 0; step < 5000; step++) {
+            seed = seed * 1664525u + 1013904223u;
+            p.clear();
+            p.feed(pool[(seed >> 16) % poolSize]);
+            TEST_ASSERT_TRUE(p.same());
+            visited |= 1u << static_cast<uint8_t>(p.table.getState());
+        }
+        TEST_ASSERT_EQUAL_UINT32(p.legacyOut.total, p.tableOut.total);
+    }
+    TEST_ASSERT_EQUAL_HEX32((1u << static_cast<uint8_t>(MoaStateId::COUNT)) - 1, visited);
+}
+
+void test_unmatched_events_are_ignored(void) {
+    RecordingActions out;
+    MoaStateTable table(out);
+    table.start();
+    out.clear();
+
+    TEST_ASSERT_FALSE(table.dispatch(MoaEventId::TIMER, makeCmd(CONTROL_TYPE_TIMER, TIMER_ID_THROTTLE, 0)));
+    TEST_ASSERT_FALSE(table.dispatch(MoaEventId::BUTTON, THROTTLE_25));      // Locked board
+    TEST_ASSERT_FALSE(table.dispatch(MoaEventId::COUNT, STOP_LONG));
+    TEST_ASSERT_EQUAL_UINT32(0, out.count);
+    TEST_ASSERT_EQUAL(MoaStateId::INIT, table.getState());
+
+    TEST_ASSERT_TRUE(table.dispatch(MoaEventId::BUTTON, STOP_LONG));
+    TEST_ASSERT_EQUAL(MoaStateId::IDLE, table.getState());
+    TEST_ASSERT_EQUAL_STRING("Idle", MoaStateTable::getStateName(table.getState()));
+    TEST_ASSERT_EQUAL_STRING("Unknown", MoaStateTable::getStateName(MoaStateId::NONE));
+}
+
+void test_dispatch_cost_and_heap(void) {
+    static const ControlCommand cycle[] = {
+        STOP_LONG, THROTTLE_25, makeCmd(CONTROL_TYPE_TIMER, TIMER_ID_FULL_THROTTLE, 0),
+        makeCmd(CONTROL_TYPE_BATTERY, COMMAND_BATT_LEVEL_MEDIUM, 24000), TEMP_ABOVE,
+        makeCmd(CONTROL_TYPE_TEMPERATURE, COMMAND_TEMP_CROSSED_BELOW, 500), STOP_LONG,
+    };
+    const size_t cycleLen = sizeof(cycle) / sizeof(cycle[0]);
+    const int reps = 200000;
+
+    RecordingActions legacyOut;
+    size_t before = heapAllocs;
+    MoaStateMachine legacy(legacyOut);
+    size_t legacyAllocs = heapAllocs - before;
+    legacy.setState(legacy.getInitState());
+
+    RecordingActions tableOut;
+    before = heapAllocs;
+    MoaStateTable table(tableOut);
+    table.start();
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) {
+        tableOut.clear();
+        route(table, cycle[r % cycleLen]);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    size_t tableAllocs = heapAllocs - before;
+
+    auto t2 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) {
+        legacyOut.clear();
+        route(legacy, cycle[r % cycleLen]);
+    }
+    auto t3 = std::chrono::steady_clock::now();
+
+    double tableNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / reps;
+    double legacyNs = std::chrono::duration<double, std::nano>(t3 - t2).count() / reps;
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "dispatch: MoaState classes %.1f ns/event (%u allocations at construction), "
+             "MoaStateTable %.1f ns/event (%u allocations, %u rows, %u bytes)",
+             legacyNs, (unsigned)legacyAllocs, tableNs, (unsigned)tableAllocs,
+             (unsigned)MoaStateTable::getTransitionCount(),
+             (unsigned)(MoaStateTable::getTransitionCount() * sizeof(MoaTransition)));
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_EQUAL_UINT32(7, legacyAllocs);         // One object per state
+    TEST_ASSERT_EQUAL_UINT32(0, tableAllocs);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_start_enters_init);
+    RUN_TEST(test_paths_reach_every_state);
+    RUN_TEST(test_every_state_event_pair_matches);
+    RUN_TEST(test_every_two_event_sequence_matches);
+    RUN_TEST(test_random_walks_match);
+    RUN_TEST(test_unmatched_events_are_ignored);
+    RUN_TEST(test_dispatch_cost_and_heap);
+    return UNITY_END();
+}
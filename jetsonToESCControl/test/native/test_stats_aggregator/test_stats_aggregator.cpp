@@ -0,0 +1,220 @@
+/**
+ * @file test_stats_aggregator.cpp
+ * @brief Host tests and multi-threaded stress test for MoaStatsAggregator
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * One writer thread plays StatsTask and publishes a reading stream whose
+ * fields are all derived from a single counter; several reader threads
+ * take snapshots concurrently and check that every value still matches
+ * its timestamp and that the three channels are from adjacent updates.
+ * A torn copy breaks one of those invariants.
+ *
+ * Run with: pio test -e native -f native/test_stats_aggregator
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "MoaStatsAggregator.h"
+
+static const uint32_t STRESS_UPDATES = 3000000;
+static const int STRESS_READERS = 3;
+
+static MoaStatsAggregator* stats;
+
+static StatsReading makeReading(uint8_t type, int32_t value, uint32_t timestamp) {
+    StatsReading r;
+    r.statsType = type;
+    r.value = value;
+    r.timestamp = timestamp;
+    return r;
+}
+
+/**
+ * @brief Value published for counter n (wraps inside int16)
+ */
+static int16_t valueFor(uint32_t n) {
+    return static_cast<int16_t>(n & 0x3FFF);
+}
+
+void setUp(void) {
+    stats = new MoaStatsAggregator();
+    stats->begin();
+}
+
+void tearDown(void) {
+    delete stats;
+}
+
+void test_initial_snapshot_is_zero() {
+    StatsSnapshot s = stats->getSnapshot();
+    TEST_ASSERT_EQUAL_INT16(0, s.temperatureX10);
+    TEST_ASSERT_EQUAL_INT16(0, s.batteryVoltageMv);
+    TEST_ASSERT_EQUAL_INT16(0, s.currentX10);
+    TEST_ASSERT_EQUAL_UINT32(0, s.currentTimestamp);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->getUpdateCount());
+}
+
+void test_update_each_channel() {
+    stats->update(makeReading(STATS_TYPE_TEMPERATURE, 255, 100));
+    stats->update(makeReading(STATS_TYPE_BATTERY, 25200, 200));
+    stats->update(makeReading(STATS_TYPE_CURRENT, -1255, 300));
+
+    StatsSnapshot s = stats->getSnapshot();
+    TEST_ASSERT_EQUAL_INT16(255, s.temperatureX10);
+    TEST_ASSERT_EQUAL_INT16(25200, s.batteryVoltageMv);
+    TEST_ASSERT_EQUAL_INT16(-1255, s.currentX10);
+    TEST_ASSERT_EQUAL_UINT32(100, s.tempTimestamp);
+    TEST_ASSERT_EQUAL_UINT32(200, s.battTimestamp);
+    TEST_ASSERT_EQUAL_UINT32(300, s.currentTimestamp);
+
+    TEST_ASSERT_EQUAL_INT16(255, stats->getTemperatureX10());
+    TEST_ASSERT_EQUAL_INT16(25200, stats->getBatteryVoltageMv());
+    TEST_ASSERT_EQUAL_INT16(-1255, stats->getCurrentX10());
+    TEST_ASSERT_EQUAL_UINT32(3, stats->getUpdateCount());
+}
+
+void test_unknown_type_is_ignored() {
+    stats->update(makeReading(STATS_TYPE_CURRENT, 500, 10));
+    stats->update(makeReading(99, 1234, 20));
+
+    TEST_ASSERT_EQUAL_INT16(500, stats->getCurrentX10());
+    TEST_ASSERT_EQUAL_UINT32(1, stats->getUpdateCount());
+}
+
+void test_probe_temperatures_reach_the_snapshot_only() {
+    stats->update(makeReading(STATS_TYPE_TEMP_MOTOR, 412, 100));
+    stats->update(makeReading(STATS_TYPE_TEMP_BATTERY, 287, 150));
+
+    StatsSnapshot s = stats->getSnapshot();
+    TEST_ASSERT_EQUAL_INT16(412, s.motorTempX10);
+    TEST_ASSERT_EQUAL_INT16(287, s.batteryTempX10);
+    TEST_ASSERT_EQUAL_UINT32(100, s.motorTempTimestamp);
+    TEST_ASSERT_EQUAL_UINT32(150, s.batteryTempTimestamp);
+    TEST_ASSERT_EQUAL_INT16(0, s.temperatureX10);       // Not the protected ESC probe
+    TEST_ASSERT_EQUAL_UINT32(2, stats->getUpdateCount());
+    TEST_ASSERT_EQUAL_UINT32(0, stats->getSummary().session[STATS_TYPE_TEMPERATURE - 1].count);
+}
+
+void test_latest_value_wins_across_buffers() {
+    for (uint32_t n = 1; n <= 5; n++) {
+        stats->update(makeReading(STATS_TYPE_BATTERY, 24000 + n, n));
+        TEST_ASSERT_EQUAL_INT16(24000 + n, stats->getBatteryVoltageMv());
+    }
+}
+
+void test_begin_clears() {
+    stats->update(makeReading(STATS_TYPE_TEMPERATURE, 300, 1));
+    stats->begin();
+    TEST_ASSERT_EQUAL_INT16(0, stats->getTemperatureX10());
+    TEST_ASSERT_EQUAL_UINT32(0, stats->getUpdateCount());
+}
+
+void test_summary_tracks_history() {
+    stats->update(makeReading(STATS_TYPE_BATTERY, 25000, 0));
+    stats->update(makeReading(STATS_TYPE_CURRENT, 1200, 0));
+    stats->update(makeReading(STATS_TYPE_CURRENT, 300, 1000));
+
+    StatsHistorySummary summary = stats->getSummary();
+    TEST_ASSERT_EQUAL_INT16(1200, summary.session[STATS_TYPE_CURRENT - 1].max);
+    TEST_ASSERT_EQUAL_UINT32(2, summary.session[STATS_TYPE_CURRENT - 1].count);
+    TEST_ASSERT_EQUAL_INT16(1200, summary.lastClosed[STATS_TYPE_CURRENT - 1][0].mean());
+    // 25 V x (120 + 30) / 2 A x 1 s = 0.52 Wh, from the energy meter
+    TEST_ASSERT_EQUAL_INT32(521, summary.energyMwh);
+    TEST_ASSERT_EQUAL_INT32(stats->getEnergy().sessionMwh, summary.energyMwh);
+    TEST_ASSERT_EQUAL_UINT32(3, stats->getHistory().getCount(STATS_TYPE_CURRENT, STATS_RES_RAW) +
+                                stats->getHistory().getCount(STATS_TYPE_BATTERY, STATS_RES_RAW));
+}
+
+// === Concurrent stress ===
+
+struct ReaderResult {
+    uint32_t reads;
+    uint32_t torn;
+    uint32_t backwards;
+};
+
+static void readerLoop(const std::atomic<bool>* done, ReaderResult* result) {
+    uint32_t lastTemp = 0;
+    while (!done->load(std::memory_order_acquire)) {
+        StatsSnapshot s = stats->getSnapshot();
+        result->reads++;
+
+        // Each value must belong to its own timestamp
+        bool paired = s.temperatureX10 == valueFor(s.tempTimestamp)
+                   && s.batteryVoltageMv == valueFor(s.battTimestamp)
+                   && s.currentX10 == valueFor(s.currentTimestamp);
+
+        // Writer order per counter n is temp, batt, current, so a whole
+        // snapshot spans at most one step: T >= B >= C >= T - 1
+        bool adjacent = s.tempTimestamp >= s.battTimestamp
+                     && s.battTimestamp >= s.currentTimestamp
+                     && s.currentTimestamp + 1 >= s.tempTimestamp;
+
+        if (!paired || !adjacent) {
+            result->torn++;
+        }
+        if (s.tempTimestamp < lastTemp) {
+            result->backwards++;
+        }
+        lastTemp = s.tempTimestamp;
+    }
+}
+
+void test_concurrent_snapshots_are_never_torn() {
+    std::atomic<bool> done(false);
+    std::vector<ReaderResult> results(STRESS_READERS, ReaderResult());
+    std::vector<std::thread> readers;
+
+    for (int i = 0; i < STRESS_READERS; i++) {
+        readers.emplace_back(readerLoop, &done, &results[i]);
+    }
+
+    // StatsTask: a single writer, never blocked by the readers
+    for (uint32_t n = 1; n <= STRESS_UPDATES; n++) {
+        stats->update(makeReading(STATS_TYPE_TEMPERATURE, valueFor(n), n));
+        stats->update(makeReading(STATS_TYPE_BATTERY, valueFor(n), n));
+        stats->update(makeReading(STATS_TYPE_CURRENT, valueFor(n), n));
+    }
+    done.store(true, std::memory_order_release);
+
+    for (std::thread& t : readers) {
+        t.join();
+    }
+
+    uint32_t reads = 0;
+    for (int i = 0; i < STRESS_READERS; i++) {
+        TEST_ASSERT_EQUAL_UINT32(0, results[i].torn);
+        TEST_ASSERT_EQUAL_UINT32(0, results[i].backwards);
+        TEST_ASSERT_TRUE(results[i].reads > 0);
+        reads += results[i].reads;
+    }
+    TEST_ASSERT_EQUAL_UINT32(STRESS_UPDATES * 3, stats->getUpdateCount());
+
+    StatsSnapshot last = stats->getSnapshot();
+    TEST_ASSERT_EQUAL_UINT32(STRESS_UPDATES, last.currentTimestamp);
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%lu updates, %lu snapshots by %d readers, %lu retries, 0 torn",
+             static_cast<unsigned long>(STRESS_UPDATES * 3), static_cast<unsigned long>(reads),
+             STRESS_READERS, static_cast<unsigned long>(stats->getReadRetries()));
+    TEST_MESSAGE(msg);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_initial_snapshot_is_zero);
+    RUN_TEST(test_update_each_channel);
+    RUN_TEST(test_unknown_type_is_ignored);
+    RUN_TEST(test_probe_temperatures_reach_the_snapshot_only);
+    RUN_TEST(test_latest_value_wins_across_buffers);
+    RUN_TEST(test_begin_clears);
+    RUN_TEST(test_summary_tracks_history);
+    RUN_TEST(test_concurrent_snapshots_are_never_torn);
+
+    return UNITY_END();
+}
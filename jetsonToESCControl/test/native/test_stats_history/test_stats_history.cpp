@@ -0,0 +1,229 @@
+/**
+ * @file test_stats_history.cpp
+ * @brief Host tests for the MoaStatsHistory rollup math
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Checks bucket boundaries, min/max/mean rollups at each resolution, ring
+ * wrap-around and session figures. Energy is integrated by MoaEnergyMeter
+ * only (see test_energy_meter); the history leaves the summary field at 0.
+ *
+ * Run with: pio test -e native -f native/test_stats_history
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include "MoaStatsHistory.h"
+
+static MoaStatsHistory* history;
+
+static StatsReading makeReading(uint8_t type, int32_t value, uint32_t timestamp) {
+    StatsReading r;
+    r.statsType = type;
+    r.value = value;
+    r.timestamp = timestamp;
+    return r;
+}
+
+static void add(uint8_t type, int32_t value, uint32_t timestamp) {
+    history->add(makeReading(type, value, timestamp));
+}
+
+void setUp(void) {
+    history = new MoaStatsHistory();
+}
+
+void tearDown(void) {
+    delete history;
+}
+
+void test_empty_history() {
+    StatsBucket b;
+    TEST_ASSERT_EQUAL_UINT16(0, history->getCount(STATS_TYPE_CURRENT, STATS_RES_RAW));
+    TEST_ASSERT_FALSE(history->getBucket(STATS_TYPE_CURRENT, STATS_RES_1S, 0, &b));
+    TEST_ASSERT_EQUAL_UINT32(0, history->getSession(STATS_TYPE_CURRENT).count);
+}
+
+void test_raw_ring_keeps_each_reading() {
+    add(STATS_TYPE_TEMPERATURE, 250, 0);
+    add(STATS_TYPE_TEMPERATURE, 260, 1000);
+
+    StatsBucket b;
+    TEST_ASSERT_EQUAL_UINT16(2, history->getCount(STATS_TYPE_TEMPERATURE, STATS_RES_RAW));
+    TEST_ASSERT_TRUE(history->getBucket(STATS_TYPE_TEMPERATURE, STATS_RES_RAW, 0, &b));
+    TEST_ASSERT_EQUAL_INT16(260, b.mean());
+    TEST_ASSERT_EQUAL_UINT32(1000, b.startMs);
+    TEST_ASSERT_TRUE(history->getBucket(STATS_TYPE_TEMPERATURE, STATS_RES_RAW, 1, &b));
+    TEST_ASSERT_EQUAL_INT16(250, b.mean());
+}
+
+void test_one_second_rollup() {
+    // 1000..1999 ms: 100, 300, 200 -> closed by the reading at 2000
+    add(STATS_TYPE_CURRENT, 100, 1000);
+    add(STATS_TYPE_CURRENT, 300, 1400);
+    add(STATS_TYPE_CURRENT, 200, 1999);
+    TEST_ASSERT_EQUAL_UINT16(0, history->getCount(STATS_TYPE_CURRENT, STATS_RES_1S));
+
+    StatsBucket open;
+    TEST_ASSERT_TRUE(history->getOpenBucket(STATS_TYPE_CURRENT, STATS_RES_1S, &open));
+    TEST_ASSERT_EQUAL_UINT16(3, open.count);
+
+    add(STATS_TYPE_CURRENT, 50, 2000);
+    TEST_ASSERT_EQUAL_UINT16(1, history->getCount(STATS_TYPE_CURRENT, STATS_RES_1S));
+
+    StatsBucket b;
+    TEST_ASSERT_TRUE(history->getBucket(STATS_TYPE_CURRENT, STATS_RES_1S, 0, &b));
+    TEST_ASSERT_EQUAL_UINT32(1000, b.startMs);
+    TEST_ASSERT_EQUAL_INT16(100, b.min);
+    TEST_ASSERT_EQUAL_INT16(300, b.max);
+    TEST_ASSERT_EQUAL_INT16(200, b.mean());
+    TEST_ASSERT_EQUAL_UINT16(3, b.count);
+}
+
+void test_bucket_start_is_aligned() {
+    add(STATS_TYPE_BATTERY, 25000, 12345);
+    add(STATS_TYPE_BATTERY, 25000, 75000);
+
+    StatsBucket b;
+    TEST_ASSERT_TRUE(history->getBucket(STATS_TYPE_BATTERY, STATS_RES_1S, 0, &b));
+    TEST_ASSERT_EQUAL_UINT32(12000, b.startMs);
+    TEST_ASSERT_TRUE(history->getBucket(STATS_TYPE_BATTERY, STATS_RES_10S, 0, &b));
+    TEST_ASSERT_EQUAL_UINT32(10000, b.startMs);
+    TEST_ASSERT_TRUE(history->getBucket(STATS_TYPE_BATTERY, STATS_RES_1MIN, 0, &b));
+    TEST_ASSERT_EQUAL_UINT32(0, b.startMs);
+}
+
+void test_coarser_rollups_match_finer() {
+    // 2 minutes at 20 Hz with a sawtooth: every coarse bucket must equal
+    // the rollup of the finer buckets it covers
+    for (uint32_t t = 0; t <= 120000; t += 50) {
+        add(STATS_TYPE_CURRENT, static_cast<int32_t>((t / 50) % 37) * 10 - 100, t);
+    }
+
+    TEST_ASSERT_EQUAL_UINT16(2, history->getCount(STATS_TYPE_CURRENT, STATS_RES_1MIN));
+    TEST_ASSERT_EQUAL_UINT16(12, history->getCount(STATS_TYPE_CURRENT, STATS_RES_10S));
+    TEST_ASSERT_EQUAL_UINT16(60, history->getCount(STATS_TYPE_CURRENT, STATS_RES_1S));
+
+    StatsBucket minute;
+    TEST_ASSERT_TRUE(history->getBucket(STATS_TYPE_CURRENT, STATS_RES_1MIN, 0, &minute));
+    TEST_ASSERT_EQUAL_UINT32(60000, minute.startMs);
+    TEST_ASSERT_EQUAL_UINT16(1200, minute.count);
+
+    int32_t sum = 0;
+    int16_t mn = INT16_MAX;
+    int16_t mx = INT16_MIN;
+    uint32_t count = 0;
+    for (uint16_t age = 0; age < 6; age++) {
+        StatsBucket b;
+        TEST_ASSERT_TRUE(history->getBucket(STATS_TYPE_CURRENT, STATS_RES_10S, age, &b));
+        TEST_ASSERT_EQUAL_UINT32(110000 - age * 10000, b.startMs);
+        sum += b.sum;
+        count += b.count;
+        if (b.min < mn) mn = b.min;
+        if (b.max > mx) mx = b.max;
+    }
+    TEST_ASSERT_EQUAL_INT32(minute.sum, sum);
+    TEST_ASSERT_EQUAL_UINT32(minute.count, count);
+    TEST_ASSERT_EQUAL_INT16(minute.min, mn);
+    TEST_ASSERT_EQUAL_INT16(minute.max, mx);
+}
+
+void test_ring_wraps_and_keeps_newest() {
+    uint16_t length = MoaStatsHistory::getLength(STATS_RES_RAW);
+    for (uint32_t i = 0; i < length + 10u; i++) {
+        add(STATS_TYPE_TEMPERATURE, static_cast<int32_t>(i), i);
+    }
+
+    StatsBucket b;
+    TEST_ASSERT_EQUAL_UINT16(length, history->getCount(STATS_TYPE_TEMPERATURE, STATS_RES_RAW));
+    TEST_ASSERT_TRUE(history->getBucket(STATS_TYPE_TEMPERATURE, STATS_RES_RAW, 0, &b));
+    TEST_ASSERT_EQUAL_INT16(length + 9, b.mean());
+    TEST_ASSERT_TRUE(history->getBucket(STATS_TYPE_TEMPERATURE, STATS_RES_RAW, length - 1, &b));
+    TEST_ASSERT_EQUAL_INT16(10, b.mean());
+    TEST_ASSERT_FALSE(history->getBucket(STATS_TYPE_TEMPERATURE, STATS_RES_RAW, length, &b));
+}
+
+void test_gaps_leave_no_bucket() {
+    add(STATS_TYPE_BATTERY, 24000, 1000);
+    add(STATS_TYPE_BATTERY, 24100, 5000);
+    add(STATS_TYPE_BATTERY, 24200, 6000);
+
+    StatsBucket b;
+    TEST_ASSERT_EQUAL_UINT16(2, history->getCount(STATS_TYPE_BATTERY, STATS_RES_1S));
+    TEST_ASSERT_TRUE(history->getBucket(STATS_TYPE_BATTERY, STATS_RES_1S, 0, &b));
+    TEST_ASSERT_EQUAL_UINT32(5000, b.startMs);
+    TEST_ASSERT_TRUE(history->getBucket(STATS_TYPE_BATTERY, STATS_RES_1S, 1, &b));
+    TEST_ASSERT_EQUAL_UINT32(1000, b.startMs);
+}
+
+void test_session_figures() {
+    add(STATS_TYPE_CURRENT, -150, 0);
+    add(STATS_TYPE_CURRENT, 1420, 50);
+    add(STATS_TYPE_CURRENT, 400, 100);
+    add(STATS_TYPE_TEMPERATURE, 250, 100);
+
+    StatsSessionChannel c = history->getSession(STATS_TYPE_CURRENT);
+    TEST_ASSERT_EQUAL_INT16(-150, c.min);
+    TEST_ASSERT_EQUAL_INT16(1420, c.max);
+    TEST_ASSERT_EQUAL_INT16(557, c.mean);
+    TEST_ASSERT_EQUAL_UINT32(3, c.count);
+    TEST_ASSERT_EQUAL_UINT32(1, history->getSession(STATS_TYPE_TEMPERATURE).count);
+}
+
+void test_summary_and_reset() {
+    add(STATS_TYPE_BATTERY, 25000, 500);
+    add(STATS_TYPE_CURRENT, 800, 500);
+    add(STATS_TYPE_CURRENT, 900, 1500);
+
+    StatsHistorySummary summary;
+    history->getSummary(&summary);
+    TEST_ASSERT_EQUAL_UINT32(500, summary.sessionStartMs);
+    TEST_ASSERT_EQUAL_INT16(900, summary.session[STATS_TYPE_CURRENT - 1].max);
+    TEST_ASSERT_EQUAL_INT16(800, summary.lastClosed[STATS_TYPE_CURRENT - 1][STATS_RES_1S - 1].max);
+    TEST_ASSERT_EQUAL_UINT16(0, summary.lastClosed[STATS_TYPE_CURRENT - 1][STATS_RES_10S - 1].count);
+    TEST_ASSERT_EQUAL_INT32(0, summary.energyMwh);      // Filled by MoaStatsAggregator
+
+    history->reset();
+    history->getSummary(&summary);
+    TEST_ASSERT_EQUAL_UINT32(0, summary.session[STATS_TYPE_CURRENT - 1].count);
+    TEST_ASSERT_EQUAL_UINT16(0, history->getCount(STATS_TYPE_CURRENT, STATS_RES_RAW));
+}
+
+void test_unknown_type_ignored() {
+    add(0, 100, 0);
+    add(99, 100, 0);
+    for (uint8_t t = STATS_TYPE_TEMPERATURE; t <= STATS_TYPE_CURRENT; t++) {
+        TEST_ASSERT_EQUAL_UINT16(0, history->getCount(t, STATS_RES_RAW));
+    }
+}
+
+void test_memory_is_bounded() {
+    size_t buckets = static_cast<size_t>(STATS_CHANNEL_COUNT) * STATS_HISTORY_TOTAL_LENGTH;
+    TEST_ASSERT_EQUAL_UINT32(16, sizeof(StatsBucket));
+    TEST_ASSERT_TRUE(MoaStatsHistory::getMemoryBytes() >= buckets * sizeof(StatsBucket));
+    TEST_ASSERT_TRUE(MoaStatsHistory::getMemoryBytes() < buckets * sizeof(StatsBucket) + 1024);
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "MoaStatsHistory: %u bytes, StatsHistorySummary: %u bytes",
+             static_cast<unsigned>(MoaStatsHistory::getMemoryBytes()),
+             static_cast<unsigned>(sizeof(StatsHistorySummary)));
+    TEST_MESSAGE(msg);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_empty_history);
+    RUN_TEST(test_raw_ring_keeps_each_reading);
+    RUN_TEST(test_one_second_rollup);
+    RUN_TEST(test_bucket_start_is_aligned);
+    RUN_TEST(test_coarser_rollups_match_finer);
+    RUN_TEST(test_ring_wraps_and_keeps_newest);
+    RUN_TEST(test_gaps_leave_no_bucket);
+    RUN_TEST(test_session_figures);
+    RUN_TEST(test_summary_and_reset);
+    RUN_TEST(test_unknown_type_ignored);
+    RUN_TEST(test_memory_is_bounded);
+
+    return UNITY_END();
+}
@@ -0,0 +1,185 @@
+/**
+ * @file test_task_profiler.cpp
+ * @brief Host tests for MoaTaskProfiler (loop period, jitter, busy time, perf record)
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Drives task loops with explicit timestamps and checks the period
+ * statistics against the intended period, the late count, the busy share,
+ * the deferred reset and the layout and CRC of the binary record.
+ *
+ * Run with: pio test -e native -f native/test_task_profiler
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "MoaTaskProfiler.h"
+#include "MoaLogJournal.h"
+
+static MoaTaskProfiler* profiler;
+
+/**
+ * @brief One loop: wake at startUs, busy for busyUs
+ */
+static void runLoop(MoaPerfTask task, uint32_t startUs, uint32_t busyUs) {
+    profiler->loopStart(task, startUs);
+    profiler->loopEnd(task, startUs + busyUs);
+}
+
+void setUp(void) {
+    profiler = new MoaTaskProfiler();
+    profiler->configure(MOA_PERF_SENSOR, "sensor", 4096, 50);
+    profiler->configure(MOA_PERF_CONTROL, "control", 4096, 0);
+}
+
+void tearDown(void) {
+    delete profiler;
+}
+
+void test_nothing_published_before_first_loop() {
+    MoaLoopTiming t = profiler->getTiming(MOA_PERF_SENSOR);
+    TEST_ASSERT_EQUAL_UINT32(0, t.loops);
+    TEST_ASSERT_EQUAL_UINT32(0, t.meanPeriodUs());
+    TEST_ASSERT_EQUAL_UINT32(0, t.maxJitterUs(50000));
+    TEST_ASSERT_EQUAL_UINT16(0, t.busyPermille());
+}
+
+void test_period_statistics_and_jitter() {
+    runLoop(MOA_PERF_SENSOR, 0, 500);
+    runLoop(MOA_PERF_SENSOR, 50000, 500);
+    runLoop(MOA_PERF_SENSOR, 99000, 800);       // 49 ms
+    runLoop(MOA_PERF_SENSOR, 152000, 500);      // 53 ms
+
+    MoaLoopTiming t = profiler->getTiming(MOA_PERF_SENSOR);
+    TEST_ASSERT_EQUAL_UINT32(4, t.loops);
+    TEST_ASSERT_EQUAL_UINT32(3, t.periods);
+    TEST_ASSERT_EQUAL_UINT32(49000, t.minPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(53000, t.maxPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(50666, t.meanPeriodUs());
+    TEST_ASSERT_EQUAL_UINT32(3000, t.maxJitterUs(50000));
+    TEST_ASSERT_EQUAL_UINT32(800, t.maxBusyUs);
+    TEST_ASSERT_EQUAL_UINT32(0, t.lateCount);
+}
+
+void test_late_periods_counted() {
+    runLoop(MOA_PERF_SENSOR, 0, 100);
+    runLoop(MOA_PERF_SENSOR, 75000, 100);       // Exactly +50%: on time
+    runLoop(MOA_PERF_SENSOR, 150001, 100);      // +50% and 1 us: late
+    runLoop(MOA_PERF_SENSOR, 400000, 100);
+
+    MoaLoopTiming t = profiler->getTiming(MOA_PERF_SENSOR);
+    TEST_ASSERT_EQUAL_UINT32(2, t.lateCount);
+    TEST_ASSERT_EQUAL_UINT32(199999, t.maxJitterUs(50000));
+}
+
+void test_event_task_has_no_target() {
+    runLoop(MOA_PERF_CONTROL, 1000, 200);
+    runLoop(MOA_PERF_CONTROL, 901000, 200);
+
+    MoaLoopTiming t = profiler->getTiming(MOA_PERF_CONTROL);
+    TEST_ASSERT_EQUAL_UINT32(900000, t.meanPeriodUs());
+    TEST_ASSERT_EQUAL_UINT32(0, t.lateCount);
+    TEST_ASSERT_EQUAL_UINT32(0, t.maxJitterUs(0));
+}
+
+void test_busy_share() {
+    for (uint32_t i = 0; i < 10; i++) {
+        runLoop(MOA_PERF_SENSOR, i * 50000, 5000);
+    }
+    // 50 ms busy over 455 ms covered
+    TEST_ASSERT_EQUAL_UINT16(109, profiler->getTiming(MOA_PERF_SENSOR).busyPermille());
+}
+
+void test_timestamps_wrap() {
+    runLoop(MOA_PERF_SENSOR, 0xFFFFFFFFUL - 10000, 100);
+    runLoop(MOA_PERF_SENSOR, 39999, 20000);         // Period across the 32-bit wrap
+
+    MoaLoopTiming t = profiler->getTiming(MOA_PERF_SENSOR);
+    TEST_ASSERT_EQUAL_UINT32(50000, t.minPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(20000, t.maxBusyUs);
+}
+
+void test_reset_applied_at_next_loop() {
+    runLoop(MOA_PERF_SENSOR, 0, 100);
+    runLoop(MOA_PERF_SENSOR, 90000, 100);
+    profiler->requestReset();
+
+    // Still visible until the task loops again
+    TEST_ASSERT_EQUAL_UINT32(2, profiler->getTiming(MOA_PERF_SENSOR).loops);
+
+    runLoop(MOA_PERF_SENSOR, 1000000, 100);
+    runLoop(MOA_PERF_SENSOR, 1050000, 100);
+    MoaLoopTiming t = profiler->getTiming(MOA_PERF_SENSOR);
+    TEST_ASSERT_EQUAL_UINT32(2, t.loops);
+    TEST_ASSERT_EQUAL_UINT32(50000, t.maxPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(0, t.lateCount);
+}
+
+void test_perf_row_defaults() {
+    runLoop(MOA_PERF_SENSOR, 0, 100);
+    MoaTaskPerf perf = profiler->getPerf(MOA_PERF_SENSOR);
+    TEST_ASSERT_EQUAL_STRING("sensor", perf.name);
+    TEST_ASSERT_EQUAL_UINT32(4096, perf.stackBytes);
+    TEST_ASSERT_EQUAL_UINT32(50, perf.periodMs);
+    TEST_ASSERT_EQUAL_UINT16(MOA_PERF_UNKNOWN, perf.stackFreeBytes);
+    TEST_ASSERT_EQUAL_UINT16(MOA_PERF_UNKNOWN, perf.cpuPermille);
+    TEST_ASSERT_EQUAL_UINT32(1, perf.timing.loops);
+}
+
+void test_record_layout_and_crc() {
+    TEST_ASSERT_EQUAL(12, sizeof(MoaPerfRecordHeader));
+    TEST_ASSERT_EQUAL(32, sizeof(MoaPerfTaskEntry));
+    TEST_ASSERT_EQUAL(12 + MOA_PERF_TASK_COUNT * 32 + 2, sizeof(MoaPerfRecord));
+
+    runLoop(MOA_PERF_SENSOR, 0, 300);
+    runLoop(MOA_PERF_SENSOR, 51000, 700);
+
+    MoaTaskPerf perf[MOA_PERF_TASK_COUNT];
+    for (uint8_t i = 0; i < MOA_PERF_TASK_COUNT; i++) {
+        perf[i] = profiler->getPerf(static_cast<MoaPerfTask>(i));
+    }
+    perf[MOA_PERF_SENSOR].stackFreeBytes = 1800;
+    perf[MOA_PERF_SENSOR].cpuPermille = 14;
+
+    MoaPerfRecord record;
+    MoaTaskProfiler::packRecord(perf, 123456, record);
+
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&record);
+    TEST_ASSERT_EQUAL_UINT8('M', bytes[0]);
+    TEST_ASSERT_EQUAL_UINT8('O', bytes[1]);
+    TEST_ASSERT_EQUAL_UINT8('A', bytes[2]);
+    TEST_ASSERT_EQUAL_UINT8('P', bytes[3]);
+    TEST_ASSERT_EQUAL_UINT8(MOA_PERF_RECORD_VERSION, record.header.version);
+    TEST_ASSERT_EQUAL_UINT8(MOA_PERF_TASK_COUNT, record.header.taskCount);
+    TEST_ASSERT_EQUAL_UINT32(123456, record.header.uptimeMs);
+
+    const MoaPerfTaskEntry& e = record.tasks[MOA_PERF_SENSOR];
+    TEST_ASSERT_EQUAL_UINT16(4096, e.stackBytes);
+    TEST_ASSERT_EQUAL_UINT16(1800, e.stackFreeBytes);
+    TEST_ASSERT_EQUAL_UINT16(14, e.cpuPermille);
+    TEST_ASSERT_EQUAL_UINT16(50, e.periodMs);
+    TEST_ASSERT_EQUAL_UINT32(2, e.loops);
+    TEST_ASSERT_EQUAL_UINT32(51000, e.meanPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(700, e.maxBusyUs);
+    TEST_ASSERT_EQUAL_UINT16(MOA_PERF_UNKNOWN, record.tasks[MOA_PERF_IO].stackFreeBytes);
+
+    TEST_ASSERT_EQUAL_UINT16(MoaLogJournal::crc16(bytes, sizeof(record) - 2), record.crc);
+    record.tasks[MOA_PERF_SENSOR].loops++;
+    TEST_ASSERT_TRUE(MoaLogJournal::crc16(bytes, sizeof(record) - 2) != record.crc);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_nothing_published_before_first_loop);
+    RUN_TEST(test_period_statistics_and_jitter);
+    RUN_TEST(test_late_periods_counted);
+    RUN_TEST(test_event_task_has_no_target);
+    RUN_TEST(test_busy_share);
+    RUN_TEST(test_timestamps_wrap);
+    RUN_TEST(test_reset_applied_at_next_loop);
+    RUN_TEST(test_perf_row_defaults);
+    RUN_TEST(test_record_layout_and_crc);
+
+    return UNITY_END();
+}
@@ -0,0 +1,355 @@
+/**
+ * @file test_telemetry.cpp
+ * @brief Host tests and throughput benchmark for the telemetry stream
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Round-trips StatsReadings through MoaTelemetryEncoder and the host-side
+ * MoaTelemetryDecoder, checks malformed payloads, batch sealing by period
+ * and by size, and that a full ring drops batches instead of waiting.
+ *
+ * The benchmark feeds 20 Hz current, voltage and temperature with
+ * realistic noise through the stream and reports bytes per reading, link
+ * bandwidth and encode/decode time.
+ *
+ * Run with: pio test -e native -f native/test_telemetry
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "Constants.h"
+#include "MoaTelemetry.h"
+
+void setUp() {}
+void tearDown() {}
+
+static StatsReading makeReading(uint8_t type, int32_t value, uint32_t timestamp) {
+    StatsReading reading;
+    reading.statsType = type;
+    reading.value = value;
+    reading.timestamp = timestamp;
+    return reading;
+}
+
+/**
+ * @brief Deterministic 20 Hz three-channel feed (xorshift noise)
+ */
+struct Feed {
+    uint32_t state = 0x12345678;
+    uint32_t index = 0;
+
+    int32_t noise(int32_t span) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<int32_t>(state % (2 * span + 1)) - span;
+    }
+
+    StatsReading next() {
+        uint32_t tick = index / 3;
+        uint8_t type = static_cast<uint8_t>(index % 3) + 1;
+        uint32_t timestamp = 1000 + tick * 50 + type;
+        index++;
+        switch (type) {
+            case STATS_TYPE_TEMPERATURE: return makeReading(type, 352 + noise(2), timestamp);
+            case STATS_TYPE_BATTERY:     return makeReading(type, 25200 - static_cast<int32_t>(tick / 10) + noise(15), timestamp);
+            default:                     return makeReading(type, 450 + noise(30), timestamp);
+        }
+    }
+};
+
+static void assertSameReading(const StatsReading& expected, const StatsReading& actual) {
+    TEST_ASSERT_EQUAL_UINT8(expected.statsType, actual.statsType);
+    TEST_ASSERT_EQUAL_INT32(expected.value, actual.value);
+    TEST_ASSERT_EQUAL_UINT32(expected.timestamp, actual.timestamp);
+}
+
+// ---------------------------------------------------------------------------
+// Codec
+// ---------------------------------------------------------------------------
+
+void test_roundtrip() {
+    MoaTelemetryEncoder encoder;
+    encoder.begin(1000);
+    StatsReading in[] = {
+        makeReading(STATS_TYPE_BATTERY, 25196, 1000),
+        makeReading(STATS_TYPE_CURRENT, -125, 1003),
+        makeReading(STATS_TYPE_TEMPERATURE, 354, 1010),
+        makeReading(STATS_TYPE_BATTERY, 25190, 1050),
+        makeReading(STATS_TYPE_CURRENT, 2000, 1050),
+    };
+    for (const StatsReading& r : in) {
+        TEST_ASSERT_TRUE(encoder.add(r));
+    }
+    TEST_ASSERT_EQUAL_UINT8(5, encoder.count());
+
+    StatsReading out[8];
+    int n = MoaTelemetryDecoder::decode(encoder.data(), encoder.length(), out, 8);
+    TEST_ASSERT_EQUAL_INT(5, n);
+    for (int i = 0; i < n; i++) {
+        assertSameReading(in[i], out[i]);
+    }
+}
+
+void test_extended_dt_and_extreme_values() {
+    MoaTelemetryEncoder encoder;
+    encoder.begin(0xFFFFFF00);
+    StatsReading in[] = {
+        makeReading(STATS_TYPE_CURRENT, INT32_MIN, 0xFFFFFF00),
+        makeReading(STATS_TYPE_CURRENT, INT32_MAX, 0xFFFFFF3E),   // dt 62: still in the head byte
+        makeReading(STATS_TYPE_CURRENT, 0, 0xFFFFFF7D),           // dt 63: extended
+        makeReading(STATS_TYPE_BATTERY, 1, 0x00000100),           // wraps past 2^32
+    };
+    for (const StatsReading& r : in) {
+        TEST_ASSERT_TRUE(encoder.add(r));
+    }
+
+    StatsReading out[4];
+    TEST_ASSERT_EQUAL_INT(4, MoaTelemetryDecoder::decode(encoder.data(), encoder.length(), out, 4));
+    for (int i = 0; i < 4; i++) {
+        assertSameReading(in[i], out[i]);
+    }
+}
+
+void test_small_deltas_take_two_bytes() {
+    MoaTelemetryEncoder encoder;
+    encoder.begin(0);
+    encoder.add(makeReading(STATS_TYPE_BATTERY, 25200, 0));
+    size_t first = encoder.length();
+    encoder.add(makeReading(STATS_TYPE_BATTERY, 25190, 50));
+    TEST_ASSERT_EQUAL_UINT32(2, encoder.length() - first);
+}
+
+void test_unknown_type_is_skipped() {
+    MoaTelemetryEncoder encoder;
+    encoder.begin(0);
+    TEST_ASSERT_TRUE(encoder.add(makeReading(0, 5, 1)));
+    TEST_ASSERT_TRUE(encoder.add(makeReading(9, 5, 1)));
+    TEST_ASSERT_EQUAL_UINT8(0, encoder.count());
+    TEST_ASSERT_EQUAL_UINT32(MOA_TELEMETRY_HEADER_BYTES, encoder.length());
+}
+
+void test_malformed_payloads_are_rejected() {
+    MoaTelemetryEncoder encoder;
+    encoder.begin(0);
+    encoder.add(makeReading(STATS_TYPE_BATTERY, 25200, 0));
+    encoder.add(makeReading(STATS_TYPE_CURRENT, 300, 100));
+    uint8_t payload[MOA_TELEMETRY_MAX_PAYLOAD];
+    size_t length = encoder.length();
+    memcpy(payload, encoder.data(), length);
+    StatsReading out[4];
+
+    // Truncated anywhere
+    for (size_t cut = 0; cut < length; cut++) {
+        TEST_ASSERT_EQUAL_INT(-1, MoaTelemetryDecoder::decode(payload, cut, out, 4));
+    }
+    // Trailing garbage
+    payload[length] = 0x01;
+    TEST_ASSERT_EQUAL_INT(-1, MoaTelemetryDecoder::decode(payload, length + 1, out, 4));
+    // Output too small
+    TEST_ASSERT_EQUAL_INT(-1, MoaTelemetryDecoder::decode(payload, length, out, 1));
+    // Wrong version
+    payload[0] = MOA_TELEMETRY_VERSION + 1;
+    TEST_ASSERT_EQUAL_INT(-1, MoaTelemetryDecoder::decode(payload, length, out, 4));
+    // Type 0 in a record
+    payload[0] = MOA_TELEMETRY_VERSION;
+    payload[MOA_TELEMETRY_HEADER_BYTES] &= 0xFC;
+    TEST_ASSERT_EQUAL_INT(-1, MoaTelemetryDecoder::decode(payload, length, out, 4));
+}
+
+void test_full_encoder_refuses_reading() {
+    MoaTelemetryEncoder encoder;
+    encoder.begin(0);
+    uint32_t added = 0;
+    while (encoder.add(makeReading(STATS_TYPE_CURRENT, (added & 1) ? INT32_MAX : INT32_MIN, added * 1000))) {
+        added++;
+    }
+    TEST_ASSERT_TRUE(added > 0);
+    TEST_ASSERT_TRUE(encoder.length() <= MOA_TELEMETRY_MAX_PAYLOAD);
+    TEST_ASSERT_EQUAL_UINT8(added, encoder.count());
+}
+
+// ---------------------------------------------------------------------------
+// Stream
+// ---------------------------------------------------------------------------
+
+void test_stream_off_by_default() {
+    MoaTelemetryStream stream;
+    MoaTelemetryFrame frame;
+    for (uint32_t t = 0; t < 1000; t += 10) {
+        TEST_ASSERT_FALSE(stream.offer(makeReading(STATS_TYPE_BATTERY, 25200, t)));
+    }
+    TEST_ASSERT_FALSE(stream.take(frame));
+    TEST_ASSERT_EQUAL_UINT32(0, stream.getStats().readings);
+}
+
+void test_stream_seals_once_per_period() {
+    MoaTelemetryStream stream;
+    stream.setPeriod(200);
+    Feed feed;
+    uint32_t sealed = 0;
+    for (int i = 0; i < 60; i++) {                      // 1 s at 3 x 20 Hz
+        sealed += stream.offer(feed.next()) ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL_UINT32(4, sealed);                // 5th batch still open
+
+    MoaTelemetryFrame frame;
+    StatsReading out[64];
+    Feed replay;
+    uint32_t decoded = 0;
+    while (stream.take(frame)) {
+        int n = MoaTelemetryDecoder::decode(frame.payload, frame.length, out, 64);
+        TEST_ASSERT_EQUAL_INT(12, n);                   // 4 ticks x 3 channels
+        for (int i = 0; i < n; i++) {
+            assertSameReading(replay.next(), out[i]);
+        }
+        decoded += n;
+    }
+    TEST_ASSERT_EQUAL_UINT32(48, decoded);
+    TEST_ASSERT_EQUAL_UINT32(60, stream.getStats().readings);
+    TEST_ASSERT_EQUAL_UINT32(4, stream.getStats().frames);
+}
+
+void test_stream_splits_full_batch_without_loss() {
+    MoaTelemetryStream stream;
+    stream.setPeriod(60000);
+    MoaTelemetryFrame frame;
+    StatsReading out[64];
+    uint32_t next = 0;
+    uint32_t sealed = 0;
+    for (uint32_t i = 0; i < 200; i++) {
+        sealed += stream.offer(makeReading(STATS_TYPE_CURRENT, static_cast<int32_t>(i * 100000), i)) ? 1 : 0;
+        while (stream.take(frame)) {
+            int n = MoaTelemetryDecoder::decode(frame.payload, frame.length, out, 64);
+            TEST_ASSERT_TRUE(n > 0);
+            for (int k = 0; k < n; k++) {
+                TEST_ASSERT_EQUAL_INT32(static_cast<int32_t>(next * 100000), out[k].value);
+                TEST_ASSERT_EQUAL_UINT32(next, out[k].timestamp);
+                next++;
+            }
+        }
+    }
+    TEST_ASSERT_TRUE(sealed > 1);
+    TEST_ASSERT_TRUE(next > 150);                       // Everything but the open batch
+    TEST_ASSERT_EQUAL_UINT32(0, stream.getStats().droppedFrames);
+}
+
+void test_full_ring_drops_instead_of_waiting() {
+    MoaTelemetryStream stream;
+    stream.setPeriod(10);
+    for (uint32_t t = 0; t <= (MOA_TELEMETRY_RING_FRAMES + 3) * 10; t += 10) {
+        stream.offer(makeReading(STATS_TYPE_BATTERY, 25200, t));
+    }
+    MoaTelemetryStats stats = stream.getStats();
+    TEST_ASSERT_EQUAL_UINT32(MOA_TELEMETRY_RING_FRAMES, stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.droppedFrames);
+
+    // The oldest batches are kept; room again once the sender catches up
+    MoaTelemetryFrame frame;
+    StatsReading out[4];
+    TEST_ASSERT_TRUE(stream.take(frame));
+    TEST_ASSERT_EQUAL_INT(1, MoaTelemetryDecoder::decode(frame.payload, frame.length, out, 4));
+    TEST_ASSERT_EQUAL_UINT32(0, out[0].timestamp);
+    TEST_ASSERT_TRUE(stream.offer(makeReading(STATS_TYPE_BATTERY, 25200, 1000)));
+    TEST_ASSERT_EQUAL_UINT32(3, stream.getStats().droppedFrames);
+}
+
+void test_reset_stats() {
+    MoaTelemetryStream stream;
+    stream.setPeriod(10);
+    stream.offer(makeReading(STATS_TYPE_BATTERY, 25200, 0));
+    stream.offer(makeReading(STATS_TYPE_BATTERY, 25200, 20));
+    stream.reportSinkError();
+    TEST_ASSERT_EQUAL_UINT32(1, stream.getStats().sinkErrors);
+    stream.resetStats();
+    MoaTelemetryStats stats = stream.getStats();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.readings);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.sinkErrors);
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+static double benchmark(uint32_t periodMs) {
+    const uint32_t seconds = 600;
+    const uint32_t count = seconds * 60;                // 3 channels x 20 Hz
+    MoaTelemetryStream stream;
+    stream.setPeriod(periodMs);
+    MoaTelemetryFrame frame;
+    StatsReading out[64];
+    Feed feed;
+    Feed replay;
+    uint32_t decoded = 0;
+    uint32_t frames = 0;
+    double decodeUs = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < count; i++) {
+        if (stream.offer(feed.next())) {
+            while (stream.take(frame)) {
+                auto d0 = std::chrono::steady_clock::now();
+                int n = MoaTelemetryDecoder::decode(frame.payload, frame.length, out, 64);
+                decodeUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - d0).count();
+                TEST_ASSERT_TRUE(n > 0);
+                for (int k = 0; k < n; k++) {
+                    assertSameReading(replay.next(), out[k]);
+                }
+                decoded += n;
+                frames++;
+            }
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double totalUs = std::chrono::duration<double, std::micro>(t1 - t0).count();
+
+    MoaTelemetryStats stats = stream.getStats();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.droppedFrames);
+    TEST_ASSERT_TRUE(decoded + 64 >= count);
+
+    // Jetson link cost per batch: COBS (+1 per 254) + delimiter + type/seq/CRC header
+    double linkBytes = stats.bytes + frames * 7.0;
+    double bytesPerReading = static_cast<double>(stats.bytes) / stats.readings;
+    char msg[220];
+    snprintf(msg, sizeof(msg),
+             "%u ms batches: %.2f B/reading payload (raw %u B), %.1f readings/batch, "
+             "%.0f B/s on the link (%.2f%% of %d baud), encode %.3f us/reading, decode %.3f us/reading",
+             static_cast<unsigned>(periodMs), bytesPerReading, static_cast<unsigned>(sizeof(StatsReading)),
+             static_cast<double>(stats.readings) / stats.frames, linkBytes / seconds,
+             linkBytes / seconds * 10.0 / MOA_LINK_BAUD * 100.0, MOA_LINK_BAUD,
+             (totalUs - decodeUs) / count, decodeUs / decoded);
+    TEST_MESSAGE(msg);
+    return bytesPerReading;
+}
+
+void test_benchmark_throughput() {
+    // Each batch restarts its deltas: short batches pay for absolute first values
+    double perReading50 = benchmark(50);
+    double perReading200 = benchmark(200);
+    double perReading1000 = benchmark(1000);
+    TEST_ASSERT_TRUE(perReading200 < perReading50);
+    TEST_ASSERT_TRUE(perReading200 < 3.0);
+    TEST_ASSERT_TRUE(perReading1000 < 2.5);
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_roundtrip);
+    RUN_TEST(test_extended_dt_and_extreme_values);
+    RUN_TEST(test_small_deltas_take_two_bytes);
+    RUN_TEST(test_unknown_type_is_skipped);
+    RUN_TEST(test_malformed_payloads_are_rejected);
+    RUN_TEST(test_full_encoder_refuses_reading);
+    RUN_TEST(test_stream_off_by_default);
+    RUN_TEST(test_stream_seals_once_per_period);
+    RUN_TEST(test_stream_splits_full_batch_without_loss);
+    RUN_TEST(test_full_ring_drops_instead_of_waiting);
+    RUN_TEST(test_reset_stats);
+    RUN_TEST(test_benchmark_throughput);
+
+    return UNITY_END();
+}
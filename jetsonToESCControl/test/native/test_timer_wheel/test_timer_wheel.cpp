@@ -0,0 +1,200 @@
+/**
+ * @file test_timer_wheel.cpp
+ * @brief Host tests for MoaTimerWheel (expiry ticks, cascades, periodic timers, O(1) stop)
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Advances the wheel one tick at a time in virtual time and checks that
+ * every timer expires on exactly the tick it was armed for, including
+ * delays that start in a coarse wheel and cascade down, and across the
+ * 32-bit tick counter wrap.
+ *
+ * Run with: pio test -e native -f native/test_timer_wheel
+ */
+
+#include <unity.h>
+#include "MoaTimerWheel.h"
+
+static MoaTimerWheel* wheel;
+static uint8_t expired[MOA_TIMER_WHEEL_CAPACITY];
+
+/**
+ * @brief Tick until the timer fires (or the limit), return the ticks taken
+ */
+static uint32_t ticksUntilExpiry(uint8_t id, uint32_t limit) {
+    for (uint32_t t = 1; t <= limit; t++) {
+        uint8_t n = wheel->tick(expired);
+        for (uint8_t i = 0; i < n; i++) {
+            if (expired[i] == id) {
+                return t;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Tick n times, return how many expirations were reported
+ */
+static uint32_t runTicks(uint32_t n) {
+    uint32_t total = 0;
+    for (uint32_t t = 0; t < n; t++) {
+        total += wheel->tick(expired);
+    }
+    return total;
+}
+
+void setUp(void) {
+    wheel = new MoaTimerWheel();
+}
+
+void tearDown(void) {
+    delete wheel;
+}
+
+void test_one_shot_expires_on_its_tick() {
+    TEST_ASSERT_TRUE(wheel->start(0, 5));
+    TEST_ASSERT_TRUE(wheel->isRunning(0));
+    TEST_ASSERT_EQUAL_UINT32(5, wheel->getRemainingTicks(0));
+    TEST_ASSERT_EQUAL_UINT32(5, ticksUntilExpiry(0, 100));
+    TEST_ASSERT_FALSE(wheel->isRunning(0));
+    TEST_ASSERT_EQUAL_UINT8(0, wheel->getActiveCount());
+    TEST_ASSERT_EQUAL_UINT32(0, runTicks(200));
+}
+
+void test_zero_delay_is_next_tick() {
+    wheel->start(1, 0);
+    TEST_ASSERT_EQUAL_UINT32(1, ticksUntilExpiry(1, 10));
+}
+
+void test_delays_across_wheel_levels() {
+    // One delay per boundary: end of a wheel, first slot of the next, deep levels
+    const uint32_t delays[] = { 63, 64, 65, 4095, 4096, 4097, 18000, 262143, 262144, 300001 };
+    for (uint8_t i = 0; i < sizeof(delays) / sizeof(delays[0]); i++) {
+        MoaTimerWheel w;
+        // Start from a non-zero phase so cascades happen mid-delay
+        for (uint32_t t = 0; t < 37U + i; t++) {
+            w.tick(expired);
+        }
+        w.start(3, delays[i]);
+
+        uint32_t fired = 0;
+        for (uint32_t t = 1; t <= delays[i] + 1 && fired == 0; t++) {
+            if (w.tick(expired) > 0) {
+                fired = t;
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(delays[i], fired, "expired on the wrong tick");
+    }
+}
+
+void test_periodic_rearms() {
+    wheel->start(2, 10, 10);
+    TEST_ASSERT_EQUAL_UINT32(10, ticksUntilExpiry(2, 100));
+    TEST_ASSERT_EQUAL_UINT32(10, ticksUntilExpiry(2, 100));
+    TEST_ASSERT_TRUE(wheel->isRunning(2));
+    TEST_ASSERT_EQUAL_UINT32(50, runTicks(500));
+}
+
+void test_periodic_with_different_first_delay() {
+    wheel->start(2, 3, 100);
+    TEST_ASSERT_EQUAL_UINT32(3, ticksUntilExpiry(2, 1000));
+    TEST_ASSERT_EQUAL_UINT32(100, ticksUntilExpiry(2, 1000));
+}
+
+void test_stop_and_restart() {
+    wheel->start(4, 100);
+    runTicks(40);
+    TEST_ASSERT_EQUAL_UINT32(60, wheel->getRemainingTicks(4));
+    TEST_ASSERT_TRUE(wheel->stop(4));
+    TEST_ASSERT_FALSE(wheel->stop(4));
+    TEST_ASSERT_EQUAL_UINT32(0, runTicks(200));
+
+    TEST_ASSERT_TRUE(wheel->restart(4));
+    TEST_ASSERT_EQUAL_UINT32(100, ticksUntilExpiry(4, 1000));
+
+    TEST_ASSERT_FALSE(wheel->restart(5));           // Never started
+}
+
+void test_start_replaces_pending_expiry() {
+    wheel->start(6, 5000);                          // Level 2
+    runTicks(10);
+    wheel->start(6, 20);                            // Same ID, now level 0
+    TEST_ASSERT_EQUAL_UINT8(1, wheel->getActiveCount());
+    TEST_ASSERT_EQUAL_UINT32(20, ticksUntilExpiry(6, 10000));
+    TEST_ASSERT_EQUAL_UINT32(0, runTicks(6000));
+}
+
+void test_simultaneous_expiries_in_one_tick() {
+    wheel->start(0, 200);
+    wheel->start(7, 200);
+    wheel->start(15, 200);
+    wheel->start(9, 199);
+    runTicks(199);
+    uint8_t n = wheel->tick(expired);
+    TEST_ASSERT_EQUAL_UINT8(3, n);
+    TEST_ASSERT_EQUAL_UINT8(0, expired[0]);         // Start order within the slot
+    TEST_ASSERT_EQUAL_UINT8(7, expired[1]);
+    TEST_ASSERT_EQUAL_UINT8(15, expired[2]);
+}
+
+void test_stop_middle_of_slot_keeps_others() {
+    wheel->start(1, 30);
+    wheel->start(2, 30);
+    wheel->start(3, 30);
+    wheel->stop(2);
+    runTicks(29);
+    uint8_t n = wheel->tick(expired);
+    TEST_ASSERT_EQUAL_UINT8(2, n);
+    TEST_ASSERT_EQUAL_UINT8(1, expired[0]);
+    TEST_ASSERT_EQUAL_UINT8(3, expired[1]);
+}
+
+void test_invalid_ids_and_clamping() {
+    TEST_ASSERT_FALSE(wheel->start(MOA_TIMER_WHEEL_CAPACITY, 10));
+    TEST_ASSERT_FALSE(wheel->stop(MOA_TIMER_WHEEL_CAPACITY));
+    TEST_ASSERT_FALSE(wheel->isRunning(MOA_TIMER_WHEEL_CAPACITY));
+
+    wheel->start(0, 0xFFFFFFFFUL);
+    TEST_ASSERT_EQUAL_UINT32(MOA_TIMER_WHEEL_MAX_TICKS, wheel->getRemainingTicks(0));
+}
+
+void test_tick_counter_wrap() {
+    MoaTimerWheel w(0xFFFFFFFFUL - 99);
+
+    w.start(8, 300);                                // Expires after the wrap
+    w.start(9, 5000);                               // Cascades down after the wrap
+    uint32_t fired8 = 0;
+    uint32_t fired9 = 0;
+    for (uint32_t t = 1; t <= 6000; t++) {
+        uint8_t n = w.tick(expired);
+        for (uint8_t i = 0; i < n; i++) {
+            if (expired[i] == 8) {
+                fired8 = t;
+            } else if (expired[i] == 9) {
+                fired9 = t;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(300, fired8);
+    TEST_ASSERT_EQUAL_UINT32(5000, fired9);
+    TEST_ASSERT_EQUAL_UINT32(5900, w.getNow());
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_one_shot_expires_on_its_tick);
+    RUN_TEST(test_zero_delay_is_next_tick);
+    RUN_TEST(test_delays_across_wheel_levels);
+    RUN_TEST(test_periodic_rearms);
+    RUN_TEST(test_periodic_with_different_first_delay);
+    RUN_TEST(test_stop_and_restart);
+    RUN_TEST(test_start_replaces_pending_expiry);
+    RUN_TEST(test_simultaneous_expiries_in_one_tick);
+    RUN_TEST(test_stop_middle_of_slot_keeps_others);
+    RUN_TEST(test_invalid_ids_and_clamping);
+    RUN_TEST(test_tick_counter_wrap);
+
+    return UNITY_END();
+}
@@ -0,0 +1,146 @@
+/**
+ * @file test_replay.cpp
+ * @brief Ride trace replay against a golden report
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Plays the shipped ride (sim/traces/ride.csv) through the complete
+ * firmware on the simulated board and compares every state transition,
+ * ESC duty change and flash log entry with sim/traces/ride.golden, the
+ * same file 'program --replay ... --golden' checks. A behaviour change in
+ * the control path (ramp, thresholds, hysteresis) fails here with the
+ * first lines that moved; regenerate the golden with
+ * 'program --replay sim/traces/ride.csv --report sim/traces/ride.golden'
+ * in the commit that means the change.
+ *
+ * Run with: pio test -e sim -f sim/test_replay
+ */
+
+#include <unity.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "MoaMainUnit.h"
+#include "MoaSimBoard.h"
+#include "MoaSimKernel.h"
+#include "MoaSimReport.h"
+#include "MoaSimTrace.h"
+
+/**
+ * @brief The shipped ride and its golden report, relative to the project
+ *        directory (where pio test runs the program)
+ */
+#define RIDE_TRACE_PATH     "sim/traces/ride.csv"
+#define RIDE_GOLDEN_PATH    "sim/traces/ride.golden"
+
+static MoaMainUnit unit;
+static std::string serialOut;
+
+static void simSetup() {
+    unit.begin();
+}
+
+static void simLoop() {
+}
+
+static bool loadTrace(const char* text, MoaSimTrace& trace, std::string& error) {
+    std::istringstream in(text);
+    return trace.load(in, error);
+}
+
+static bool readFile(const char* path, std::string& text) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    text = buffer.str();
+    return true;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_trace_parses_samples_and_buttons(void) {
+    MoaSimTrace trace;
+    std::string error;
+
+    std::string text;
+    TEST_ASSERT_TRUE(readFile(RIDE_TRACE_PATH, text));
+    TEST_ASSERT_TRUE(loadTrace(text.c_str(), trace, error));
+    TEST_ASSERT_EQUAL_UINT32(521, trace.getSampleCount());
+    TEST_ASSERT_EQUAL_UINT32(12, trace.getButtonCount());
+    TEST_ASSERT_EQUAL_UINT64((52000ULL + MOA_SIM_TRACE_TAIL_MS) * 1000ULL, trace.getEndUs());
+}
+
+void test_trace_rejects_malformed_rows(void) {
+    MoaSimTrace trace;
+    std::string error;
+
+    TEST_ASSERT_FALSE(loadTrace("s,0,1.0,25.0\n", trace, error));
+    TEST_ASSERT_EQUAL_STRING("line 1: unknown row 's'", error.c_str());
+    TEST_ASSERT_FALSE(loadTrace("b,0,200,down\n", trace, error));
+    TEST_ASSERT_FALSE(loadTrace("b,0,stop,sideways\n", trace, error));
+    TEST_ASSERT_FALSE(loadTrace("s,x,1.0,25.0,20.0\n", trace, error));
+    TEST_ASSERT_FALSE(loadTrace("s,100,1.0,25.0,20.0\n# later\ns,50,1.0,25.0,20.0\n", trace, error));
+    TEST_ASSERT_EQUAL_STRING("line 3: rows out of order", error.c_str());
+}
+
+void test_diff_lists_first_mismatches(void) {
+    std::string differences;
+
+    TEST_ASSERT_TRUE(MoaSimReport::diff("1 a\n2 b\n", "1 a\n2 b\n", differences));
+    TEST_ASSERT_TRUE(differences.empty());
+
+    TEST_ASSERT_FALSE(MoaSimReport::diff("1 a\n2 b\n", "1 a\n2 c\n3 d\n", differences));
+    TEST_ASSERT_EQUAL_STRING("line 2:\n  - 2 b\n  + 2 c\n"
+                             "line 3:\n  - <end>\n  + 3 d\n", differences.c_str());
+}
+
+void test_replay_matches_golden_report(void) {
+    MoaSimBoard& board = MoaSimBoard::instance();
+    MoaSimKernel& kernel = MoaSimKernel::instance();
+    MoaSimTrace trace;
+    std::string error;
+    std::string text;
+    std::string golden;
+    TEST_ASSERT_TRUE(readFile(RIDE_TRACE_PATH, text));
+    TEST_ASSERT_TRUE(readFile(RIDE_GOLDEN_PATH, golden));
+    TEST_ASSERT_TRUE(loadTrace(text.c_str(), trace, error));
+
+    MoaSimReport report(unit.getStateMachine(), unit.getFlashLog(), board);
+    report.attach();
+    trace.play(board);
+    board.provisionProbes(unit.getConfig());
+    kernel.boot(simSetup, simLoop);
+    kernel.run(trace.getEndUs());
+    report.detach();
+
+    std::string differences;
+    bool same = MoaSimReport::diff(golden, report.getText(), differences);
+    if (!same) {
+        TEST_MESSAGE(differences.c_str());
+    }
+    TEST_ASSERT_TRUE(same);
+    TEST_ASSERT_EQUAL_UINT32(7, report.getTransitionCount());
+}
+
+int main() {
+    Serial.setCapture(&serialOut);
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_trace_parses_samples_and_buttons);
+    RUN_TEST(test_trace_rejects_malformed_rows);
+    RUN_TEST(test_diff_lists_first_mismatches);
+    RUN_TEST(test_replay_matches_golden_report);    // Boots the kernel: last
+
+    // Task threads stay parked on the baton; leave without unwinding them
+    int failures = UNITY_END();
+    fflush(stdout);
+    _Exit(failures);
+}
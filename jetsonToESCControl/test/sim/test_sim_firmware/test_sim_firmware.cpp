@@ -0,0 +1,420 @@
+/**
+ * @file test_sim_firmware.cpp
+ * @brief Firmware-in-the-loop tests on the simulated board
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Boots the complete MoaMainUnit (every task, queue and timer) on the
+ * virtual-time kernel and rides it through the button, protection, CLI
+ * and Jetson link paths, the telemetry stream, the load-compensated
+ * battery levels and the DS18B20 probe bus. The tests run in order on one continuous
+ * simulation, each picking up the state the previous one left.
+ *
+ * Run with: pio test -e sim -f sim/test_sim_firmware
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include "Constants.h"
+#include "PinMapping.h"
+#include "MoaButtonControl.h"
+#include "MoaDs18b20Bus.h"
+#include "MoaLinkProtocol.h"
+#include "MoaMainUnit.h"
+#include "MoaTelemetry.h"
+#include "MoaSimBoard.h"
+#include "MoaSimKernel.h"
+#include "MoaSimPlant.h"
+
+static const uint64_t MS = 1000ULL;
+
+/**
+ * @brief Firmware tasks + Arduino loopTask + timer service + esp_timer task
+ */
+static const uint32_t EXPECTED_TASKS = 12;
+
+static MoaMainUnit unit;
+static std::string serialOut;
+
+static void simSetup() {
+    unit.begin();
+}
+
+static void simLoop() {
+}
+
+static MoaSimBoard& board() {
+    return MoaSimBoard::instance();
+}
+
+static void runMs(uint64_t ms) {
+    MoaSimKernel::instance().run(ms * MS);
+}
+
+static void tapButton(uint8_t mcpPin, uint64_t holdMs) {
+    board().pressButton(mcpPin);
+    runMs(holdMs);
+    board().releaseButton(mcpPin);
+    runMs(200);
+}
+
+/**
+ * @brief Put one request frame on the Jetson link RX line
+ */
+static void sendLink(uint8_t seq, uint8_t type, uint16_t duty = 0) {
+    uint8_t payload[2] = { static_cast<uint8_t>(duty & 0xFF), static_cast<uint8_t>(duty >> 8) };
+    uint8_t wire[MOA_LINK_MAX_ENCODED];
+    size_t n = MoaLinkCodec::encodeFrame(seq, type, payload, (type == MOA_LINK_MSG_THROTTLE) ? 2 : 0,
+                                         wire, sizeof(wire));
+    board().sendUart(MOA_LINK_UART_NUM, wire, n);
+}
+
+/**
+ * @brief Decode the frames written on the link since the last call
+ * @param stream true for telemetry STREAM frames, false for replies
+ */
+static size_t takeLinkFrames(MoaLinkFrame* out, size_t max, bool stream) {
+    MoaLinkDecoder decoder;
+    size_t n = 0;
+    for (uint8_t b : board().takeUartOutput(MOA_LINK_UART_NUM)) {
+        if (n < max && decoder.push(b, out[n]) && (out[n].type == MOA_LINK_MSG_STREAM) == stream) {
+            n++;
+        }
+    }
+    return n;
+}
+
+static size_t takeLinkReplies(MoaLinkFrame* out, size_t max) {
+    return takeLinkFrames(out, max, false);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_boot_starts_all_tasks_with_esc_stopped(void) {
+    runMs(2000);                        // begin() includes the LED intro
+
+    TEST_ASSERT_EQUAL_UINT32(EXPECTED_TASKS, MoaSimKernel::instance().getTaskCount());
+    TEST_ASSERT_TRUE(board().getEscPulseUs() > 0.0f);
+    TEST_ASSERT_TRUE(board().getEscPulseUs() <= ESC_PULSE_MIN_US);
+}
+
+void test_throttle_ignored_while_locked(void) {
+    tapButton(MCP_PIN_BUTTON_25, 150);
+
+    TEST_ASSERT_TRUE(board().getEscPulseUs() <= ESC_PULSE_MIN_US);
+}
+
+void test_unlock_then_throttle_25(void) {
+    tapButton(MCP_PIN_BUTTON_STOP, MOA_BUTTON_DEFAULT_LONG_PRESS_MS + 500);
+    tapButton(MCP_PIN_BUTTON_25, 150);
+    runMs(1000);                        // Idle entry animation, then the throttle ramp
+
+    // Config duties are 10-bit, the PWM runs at ESC_PWM_RESOLUTION
+    TEST_ASSERT_EQUAL_UINT32(ESC_ECO_MODE << (ESC_PWM_RESOLUTION - ESC_THROTTLE_BITS), board().getEscDuty());
+    TEST_ASSERT_TRUE(board().getPlant().getMotorCurrent() > 10.0f);
+}
+
+void test_current_spike_trips_esc(void) {
+    board().getPlant().setExtraCurrent(180.0f);
+    uint64_t startUs = MoaSimKernel::instance().nowUs();
+    uint64_t latencyUs = 0;
+    for (int ms = 0; ms < 50; ms++) {
+        runMs(1);
+        if (board().getEscPulseUs() <= ESC_PULSE_MIN_US) {
+            latencyUs = MoaSimKernel::instance().nowUs() - startUs;
+            break;
+        }
+    }
+    board().getPlant().setExtraCurrent(0.0f);
+
+    TEST_ASSERT_TRUE(latencyUs > 0);
+    TEST_ASSERT_TRUE(latencyUs <= 20 * MS);
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "spike to ESC stop: %llu us (virtual)", static_cast<unsigned long long>(latencyUs));
+    TEST_MESSAGE(msg);
+}
+
+void test_cli_answers_on_serial(void) {
+    serialOut.clear();
+    board().sendSerial("get esc_t25\n");
+    runMs(200);
+
+    TEST_ASSERT_TRUE(serialOut.find("esc_t25") != std::string::npos);
+    TEST_ASSERT_TRUE(serialOut.find("180000 ms") != std::string::npos);
+}
+
+void test_jetson_link_throttle_within_5ms(void) {
+    MoaLinkFrame replies[4];
+    sendLink(1, MOA_LINK_MSG_DISARM);       // From whatever the trip left, back to Init
+    runMs(1500);                            // Lock animation
+    sendLink(2, MOA_LINK_MSG_ARM);
+    runMs(1500);                            // Unlock animation
+    TEST_ASSERT_EQUAL_STRING("Idle", unit.getStateMachine().getStateName());
+    takeLinkReplies(replies, 4);
+
+    uint32_t stoppedDuty = board().getEscDuty();
+    uint64_t startUs = MoaSimKernel::instance().nowUs();
+    uint64_t latencyUs = 0;
+    sendLink(3, MOA_LINK_MSG_THROTTLE, ESC_ECO_MODE);
+    for (int step = 0; step < 100; step++) {
+        MoaSimKernel::instance().run(100);
+        if (board().getEscDuty() != stoppedDuty) {
+            latencyUs = MoaSimKernel::instance().nowUs() - startUs;
+            break;
+        }
+    }
+    TEST_ASSERT_TRUE(latencyUs > 0);
+    TEST_ASSERT_TRUE(latencyUs <= 5 * MS);
+
+    TEST_ASSERT_EQUAL(1, takeLinkReplies(replies, 4));
+    TEST_ASSERT_EQUAL_UINT8(3, replies[0].seq);
+    TEST_ASSERT_EQUAL_HEX8(MOA_LINK_MSG_ACK, replies[0].type);
+    TEST_ASSERT_EQUAL_UINT8(MOA_LINK_STATUS_OK, replies[0].payload[0]);
+
+    // Setpoints every 100 ms hold the throttle past the watchdog
+    for (uint8_t seq = 4; seq < 14; seq++) {
+        sendLink(seq, MOA_LINK_MSG_THROTTLE, ESC_ECO_MODE);
+        runMs(100);
+    }
+    TEST_ASSERT_EQUAL_STRING("Surfing", unit.getStateMachine().getStateName());
+    TEST_ASSERT_EQUAL_UINT32(ESC_ECO_MODE << (ESC_PWM_RESOLUTION - ESC_THROTTLE_BITS), board().getEscDuty());
+
+    // Host goes silent: the watchdog stops the motor
+    runMs(MOA_LINK_WATCHDOG_MS + 500);
+    TEST_ASSERT_EQUAL_STRING("Idle", unit.getStateMachine().getStateName());
+    TEST_ASSERT_TRUE(board().getEscPulseUs() <= ESC_PULSE_MIN_US);
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "link frame to ESC duty: %llu us (virtual)", static_cast<unsigned long long>(latencyUs));
+    TEST_MESSAGE(msg);
+}
+
+void test_telemetry_streams_on_the_link(void) {
+    MoaLinkFrame frames[16];
+    takeLinkFrames(frames, 16, true);
+    unit.getTelemetryStream().resetStats();
+    runMs(2000);
+
+    size_t n = takeLinkFrames(frames, 16, true);
+    TEST_ASSERT_TRUE(n >= 2000 / TELEMETRY_PERIOD_MS - 1);
+
+    uint32_t counts[4] = { 0, 0, 0, 0 };
+    uint32_t lastTimestamp = 0;
+    int32_t battMv = 0;
+    for (size_t i = 0; i < n; i++) {
+        StatsReading readings[64];
+        int count = MoaTelemetryDecoder::decode(frames[i].payload, frames[i].length, readings, 64);
+        TEST_ASSERT_TRUE(count > 0);
+        for (int k = 0; k < count; k++) {
+            TEST_ASSERT_TRUE(readings[k].timestamp >= lastTimestamp);
+            lastTimestamp = readings[k].timestamp;
+            counts[readings[k].statsType]++;
+            if (readings[k].statsType == STATS_TYPE_BATTERY) {
+                battMv = readings[k].value;
+            }
+        }
+    }
+    TEST_ASSERT_TRUE(counts[STATS_TYPE_BATTERY] > 0);
+    TEST_ASSERT_TRUE(counts[STATS_TYPE_CURRENT] > 0);
+    TEST_ASSERT_INT32_WITHIN(200, unit.getStatsAggregator().getSnapshot().batteryVoltageMv, battMv);
+
+    MoaTelemetryStats stats = unit.getTelemetryStream().getStats();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.droppedFrames);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.sinkErrors);
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "telemetry: %u frames, %lu readings, %lu payload bytes in 2 s",
+             static_cast<unsigned>(n), (unsigned long)stats.readings, (unsigned long)stats.bytes);
+    TEST_MESSAGE(msg);
+}
+
+void test_full_throttle_sag_is_not_a_low_battery(void) {
+    // 21.0 V resting (MEDIUM); 120 A through 30 mOhm puts the terminal at 17.4 V, below STOP
+    board().getPlant().setStateOfCharge((21.0f - MOA_SIM_BATTERY_EMPTY_V) /
+                                        (MOA_SIM_BATTERY_FULL_V - MOA_SIM_BATTERY_EMPTY_V));
+    runMs(1000);
+    TEST_ASSERT_TRUE(unit.getBattControl().getLevel() == MoaBattLevel::BATT_MEDIUM);
+
+    for (uint8_t seq = 20; seq < 50; seq++) {
+        sendLink(seq, MOA_LINK_MSG_THROTTLE, ESC_FULL_THROTTLE_MODE);
+        runMs(100);
+    }
+    TEST_ASSERT_EQUAL_STRING("Surfing", unit.getStateMachine().getStateName());
+    TEST_ASSERT_TRUE(unit.getBattControl().getAveragedVoltageMv() < 18900);
+    TEST_ASSERT_TRUE(unit.getBattControl().getLevel() == MoaBattLevel::BATT_MEDIUM);
+    TEST_ASSERT_UINT32_WITHIN(8, 30, unit.getBattControl().getResistance().getResistanceMilliohm());
+    TEST_ASSERT_INT32_WITHIN(300, 21000, unit.getBattControl().getOpenCircuitVoltageMv());
+
+    // On the terminal voltage the same ride reads as an empty pack
+    unit.getBattControl().setLoadCompensation(false);
+    for (uint8_t seq = 50; seq < 60; seq++) {
+        sendLink(seq, MOA_LINK_MSG_THROTTLE, ESC_FULL_THROTTLE_MODE);
+        runMs(100);
+    }
+    TEST_ASSERT_TRUE(unit.getBattControl().getLevel() == MoaBattLevel::BATT_STOP);
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "pack R learned: %lu mOhm from %lu steps",
+             (unsigned long)unit.getBattControl().getResistance().getResistanceMilliohm(),
+             (unsigned long)unit.getBattControl().getResistance().getStepCount());
+    TEST_MESSAGE(msg);
+
+    unit.getBattControl().setLoadCompensation(true);
+    board().getPlant().setStateOfCharge(1.0f);
+    runMs(MOA_LINK_WATCHDOG_MS + 500);
+}
+
+void test_empty_pack_under_a_current_spike_still_stops(void) {
+    // The plant rests at 19.8 V when empty: put the cutoff above it
+    MoaBattControl& batt = unit.getBattControl();
+    batt.setLowThreshold(20.6f);
+    batt.setStopThreshold(20.3f);
+    board().getPlant().setStateOfCharge(0.0f);
+    TEST_ASSERT_TRUE(batt.getResistance().isLearned());
+
+    // Ride with 100 ms load spikes every 300 ms on top of the motor
+    int32_t peakOcvMv = 0;
+    uint8_t seq = 60;
+    for (int i = 0; i < 20; i++) {
+        sendLink(seq++, MOA_LINK_MSG_THROTTLE, ESC_AFTER_FULL_THROTTLE_MODE);
+        board().getPlant().setExtraCurrent(60.0f);
+        for (int ms = 0; ms < 300; ms += TASK_SENSOR_PERIOD_MS) {
+            if (ms == 100) {
+                board().getPlant().setExtraCurrent(0.0f);
+            }
+            runMs(TASK_SENSOR_PERIOD_MS);
+            int32_t ocvMv = batt.getOpenCircuitVoltageMv();
+            peakOcvMv = (ocvMv > peakOcvMv) ? ocvMv : peakOcvMv;
+        }
+    }
+
+    // V and I averaged over the same window: no overshoot over the cutoff
+    TEST_ASSERT_TRUE(batt.getLevel() == MoaBattLevel::BATT_STOP);
+    TEST_ASSERT_TRUE(peakOcvMv < 20300);
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "empty pack under spikes: peak ocv %.2f V (rest 19.80 V)", peakOcvMv / 1000.0f);
+    TEST_MESSAGE(msg);
+
+    batt.setLowThreshold(BATT_THRESHOLD_LOW);
+    batt.setStopThreshold(BATT_THRESHOLD_STOP);
+    board().getPlant().setStateOfCharge(1.0f);
+    runMs(MOA_LINK_WATCHDOG_MS + 500);
+}
+
+void test_ds18b20_probes_feed_the_stats(void) {
+    uint32_t searches = board().oneWire().getSearches();
+    uint32_t conversions[TEMP_PROBE_MAX_COUNT];
+    for (uint8_t probe = 0; probe < TEMP_PROBE_MAX_COUNT; probe++) {
+        conversions[probe] = board().oneWire().getConversions(probe);
+    }
+    runMs(2000);
+    SimulatedDs18b20Bus& bus = board().oneWire();
+
+    // ROMs cached at boot: no search per reading, no read before its conversion is done
+    TEST_ASSERT_EQUAL_UINT32(searches, bus.getSearches());
+    TEST_ASSERT_EQUAL_UINT32(0, bus.getEarlyReads());
+    TEST_ASSERT_EQUAL_UINT8(TEMP_PROBE_RES_MOTOR, bus.getResolution(TEMP_PROBE_MOTOR));
+    TEST_ASSERT_EQUAL_UINT8(TEMP_PROBE_RES_BATTERY, bus.getResolution(TEMP_PROBE_BATTERY));
+
+    // One transaction per SensorTask cycle: start and read each probe in turn
+    for (uint8_t probe = 0; probe < TEMP_PROBE_MAX_COUNT; probe++) {
+        TEST_ASSERT_TRUE(bus.getConversions(probe) - conversions[probe] >=
+                         2000 / (2 * TEMP_PROBE_MAX_COUNT * TASK_SENSOR_PERIOD_MS));
+    }
+
+    MoaSimPlant& plant = board().getPlant();
+    float rise = plant.getTemperature() - plant.getWaterTemperature();
+    StatsSnapshot now = unit.getStatsAggregator().getSnapshot();
+    TEST_ASSERT_TRUE(now.motorTempTimestamp != 0);
+    TEST_ASSERT_TRUE(now.batteryTempTimestamp != 0);
+    TEST_ASSERT_INT32_WITHIN(10, lroundf((plant.getWaterTemperature() + rise * MOA_SIM_MOTOR_PROBE_RISE) * 10.0f),
+                             now.motorTempX10);
+    TEST_ASSERT_INT32_WITHIN(10, lroundf((plant.getWaterTemperature() + rise * MOA_SIM_BATTERY_PROBE_RISE) * 10.0f),
+                             now.batteryTempX10);
+}
+
+static std::string romHex(const uint8_t* rom) {
+    char hex[2 * ONEWIRE_ROM_BYTES + 1];
+    for (uint8_t i = 0; i < ONEWIRE_ROM_BYTES; i++) {
+        snprintf(hex + 2 * i, 3, "%02X", rom[i]);
+    }
+    return hex;
+}
+
+void test_probe_roles_follow_the_stored_roms(void) {
+    SimulatedDs18b20Bus& bus = board().oneWire();
+    ConfigManager& config = unit.getConfig();
+
+    serialOut.clear();
+    board().sendSerial("probes\n");
+    runMs(200);
+    for (uint8_t role = 0; role < TEMP_PROBE_MAX_COUNT; role++) {
+        std::string line = std::string(moaProbeRoleName(role)) + " ";
+        size_t at = serialOut.find("  " + line);
+        TEST_ASSERT_TRUE(at != std::string::npos);
+        TEST_ASSERT_TRUE(serialOut.compare(at + 2 + 9, 16, romHex(bus.getRom(role))) == 0);
+    }
+
+    // Moving a probe to another role frees its old one, saved for the next boot
+    serialOut.clear();
+    board().sendSerial("probes assign 0 battery\n");
+    runMs(200);
+    TEST_ASSERT_TRUE(serialOut.find("OK: #0 is the battery probe") != std::string::npos);
+    TEST_ASSERT_TRUE(memcmp(config.tempProbeRoms[TEMP_PROBE_BATTERY], bus.getRom(TEMP_PROBE_ESC),
+                            ONEWIRE_ROM_BYTES) == 0);
+    TEST_ASSERT_EQUAL_UINT8(0, config.tempProbeRoms[TEMP_PROBE_ESC][0]);
+
+    serialOut.clear();
+    board().sendSerial("probes assign 7 esc\n");
+    runMs(200);
+    TEST_ASSERT_TRUE(serialOut.find("ERR: No probe #7") != std::string::npos);
+
+    board().provisionProbes(config);
+}
+
+void test_ten_minutes_run_faster_than_real_time(void) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    runMs(600000);
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    TEST_ASSERT_EQUAL_UINT32(EXPECTED_TASKS, MoaSimKernel::instance().getTaskCount());
+    TEST_ASSERT_TRUE(wallS < 60.0);
+
+    char msg[80];
+    snprintf(msg, sizeof(msg), "600 s virtual in %.2f s wall (x%.0f)", wallS, 600.0 / wallS);
+    TEST_MESSAGE(msg);
+}
+
+int main() {
+    Serial.setCapture(&serialOut);
+    MoaSimBoard::instance().provisionProbes(unit.getConfig());
+    MoaSimKernel::instance().boot(simSetup, simLoop);
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_boot_starts_all_tasks_with_esc_stopped);
+    RUN_TEST(test_throttle_ignored_while_locked);
+    RUN_TEST(test_unlock_then_throttle_25);
+    RUN_TEST(test_current_spike_trips_esc);
+    RUN_TEST(test_cli_answers_on_serial);
+    RUN_TEST(test_jetson_link_throttle_within_5ms);
+    RUN_TEST(test_telemetry_streams_on_the_link);
+    RUN_TEST(test_full_throttle_sag_is_not_a_low_battery);
+    RUN_TEST(test_empty_pack_under_a_current_spike_still_stops);
+    RUN_TEST(test_ds18b20_probes_feed_the_stats);
+    RUN_TEST(test_probe_roles_follow_the_stored_roms);
+    RUN_TEST(test_ten_minutes_run_faster_than_real_time);
+
+    // Task threads stay parked on the baton; leave without unwinding them
+    int failures = UNITY_END();
+    fflush(stdout);
+    _Exit(failures);
+}
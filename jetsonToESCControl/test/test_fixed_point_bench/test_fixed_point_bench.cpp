@@ -0,0 +1,108 @@
+/**
+ * @file test_fixed_point_bench.cpp
+ * @brief On-target cycle-count benchmark: float vs. fixed-point sensor conversion
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Runs the previous float conversion (MoaCurrentControl::adcToCurrent() /
+ * MoaBattControl::adcToVoltage() followed by the "* 10.0f" / "* 1000.0f"
+ * event scaling) and the folded MoaFixedScale path on the ESP32-C3, which
+ * has no FPU, and prints cycles per sample from the CPU cycle counter.
+ *
+ * Run with: pio test -e dfrobot_beetle_esp32c3 -f test_fixed_point_bench
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "Constants.h"
+#include "MoaFixedPoint.h"
+
+static const int BENCH_SAMPLES = 4096;
+
+static volatile float g_sensitivity = CURRENT_SENSOR_SENSITIVITY;
+static volatile float g_offset = CURRENT_SENSOR_OFFSET;
+static volatile float g_ratio = BATT_DIVIDER_RATIO;
+static volatile int32_t g_sink;
+
+static float legacyCurrent(uint16_t raw) {
+    float maxAdcValue = static_cast<float>((1 << ADC_RESOLUTION_BITS) - 1);
+    float adcVoltage = (static_cast<float>(raw) / maxAdcValue) * ADC_REFERENCE_VOLTAGE;
+    return (adcVoltage - g_offset) / g_sensitivity;
+}
+
+static float legacyVoltage(uint16_t raw) {
+    float maxAdcValue = static_cast<float>((1 << ADC_RESOLUTION_BITS) - 1);
+    float adcVoltage = (static_cast<float>(raw) / maxAdcValue) * ADC_REFERENCE_VOLTAGE;
+    return adcVoltage * g_ratio;
+}
+
+static void report(const char* name, uint32_t floatCycles, uint32_t fixedCycles) {
+    Serial.printf("%s: float=%.1f cycles/sample fixed=%.1f cycles/sample (%.1fx)\n", name,
+                  static_cast<float>(floatCycles) / BENCH_SAMPLES,
+                  static_cast<float>(fixedCycles) / BENCH_SAMPLES,
+                  static_cast<float>(floatCycles) / static_cast<float>(fixedCycles));
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_bench_current_conversion() {
+    float maxAdcValue = static_cast<float>((1 << ADC_RESOLUTION_BITS) - 1);
+    MoaFixedScale scale = MoaFixedScale::fromFloat(
+        ADC_REFERENCE_VOLTAGE * 1000.0f / (maxAdcValue * g_sensitivity),
+        -g_offset * 1000.0f / g_sensitivity);
+
+    uint32_t c0 = ESP.getCycleCount();
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        g_sink = static_cast<int32_t>(legacyCurrent(i & 0xFFF) * 10.0f);
+    }
+    uint32_t c1 = ESP.getCycleCount();
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        g_sink = moaDivRound(scale.apply(i & 0xFFF), 100);
+    }
+    uint32_t c2 = ESP.getCycleCount();
+
+    report("current", c1 - c0, c2 - c1);
+    TEST_ASSERT_TRUE((c2 - c1) < (c1 - c0));
+}
+
+void test_bench_voltage_conversion() {
+    float maxAdcValue = static_cast<float>((1 << ADC_RESOLUTION_BITS) - 1);
+    MoaFixedScale scale = MoaFixedScale::fromFloat(
+        ADC_REFERENCE_VOLTAGE * g_ratio * 1000.0f / maxAdcValue, 0.0f);
+
+    uint32_t c0 = ESP.getCycleCount();
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        g_sink = static_cast<int32_t>(legacyVoltage(i & 0xFFF) * 1000.0f);
+    }
+    uint32_t c1 = ESP.getCycleCount();
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        g_sink = scale.apply(i & 0xFFF);
+    }
+    uint32_t c2 = ESP.getCycleCount();
+
+    report("battery", c1 - c0, c2 - c1);
+    TEST_ASSERT_TRUE((c2 - c1) < (c1 - c0));
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_bench_current_conversion);
+    RUN_TEST(test_bench_voltage_conversion);
+
+    return UNITY_END();
+}
+
+void setup() {
+    delay(1000);
+    Serial.begin(115200);
+    main();
+}
+
+void loop() {
+    // Empty
+}
@@ -0,0 +1,74 @@
+/**
+ * @file test_ntc_bench.cpp
+ * @brief On-target cycle-count benchmark: Beta equation vs. NTC lookup table
+ * @author Oscar Martinez
+ * @date 2026-10-16
+ *
+ * Runs the previous per-read conversion (the NTC_Thermistor Beta equation
+ * on one millivolt read, followed by the "* 100" centi-degC scaling) and
+ * the MoaNtcTable lookup on the ESP32-C3, which has no FPU, and prints
+ * cycles per conversion from the CPU cycle counter. The ADC reads are not
+ * timed: oversampling costs the same for both paths.
+ *
+ * Run with: pio test -e dfrobot_beetle_esp32c3 -f test_ntc_bench
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <math.h>
+#include "Constants.h"
+#include "MoaNtcTable.h"
+
+static const int BENCH_SAMPLES = 4096;
+
+static volatile float g_reference = NTC_REFERENCE_RESISTANCE;
+static volatile float g_beta = NTC_BETA_COEFFICIENT;
+static volatile int32_t g_sink;
+
+static float legacyCelsius(uint32_t mv) {
+    float resistance = g_reference / (NTC_ADC_VREF_MV / static_cast<float>(mv) - 1.0f);
+    return 1.0f / (1.0f / (NTC_NOMINAL_TEMP_C + 273.15f) +
+                   logf(resistance / NTC_NOMINAL_RESISTANCE) / g_beta) - 273.15f;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_bench_ntc_conversion() {
+    uint32_t c0 = ESP.getCycleCount();
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        g_sink = static_cast<int32_t>(legacyCelsius(100 + (i & 0xFFF)) * 100.0f);
+    }
+    uint32_t c1 = ESP.getCycleCount();
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        g_sink = moaNtcCentiCelsius((100 + (i & 0xFFF)) << MOA_NTC_MV_FRAC_BITS);
+    }
+    uint32_t c2 = ESP.getCycleCount();
+
+    Serial.printf("ntc: beta=%.1f cycles/read table=%.1f cycles/read (%.1fx)\n",
+                  static_cast<float>(c1 - c0) / BENCH_SAMPLES,
+                  static_cast<float>(c2 - c1) / BENCH_SAMPLES,
+                  static_cast<float>(c1 - c0) / static_cast<float>(c2 - c1));
+    TEST_ASSERT_TRUE((c2 - c1) < (c1 - c0));
+}
+
+int main() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_bench_ntc_conversion);
+
+    return UNITY_END();
+}
+
+void setup() {
+    delay(1000);
+    Serial.begin(115200);
+    main();
+}
+
+void loop() {
+    // Empty
+}
@@ -80,7 +80,7 @@ void test_temperature_threshold_events() {
     if (eventReceived) {
         TEST_ASSERT_EQUAL_MESSAGE(CONTROL_TYPE_TEMPERATURE, cmd.controlType, "Wrong control type in temperature event");
         TEST_ASSERT_EQUAL_MESSAGE(COMMAND_TEMP_CROSSED_ABOVE, cmd.commandType, "Expected temperature crossed above event");
-        Serial.printf("Temperature event: type=%d, value=%d\n", cmd.commandType, cmd.value);
+        Serial.printf("Temperature event: type=%d, value=%d\n", cmd.commandType, TempEvent(cmd).getDeciCelsius());
     } else {
         // No event might be OK if temperature is below threshold
         Serial.println("No temperature event (temperature below threshold)");
@@ -55,8 +55,9 @@ void test_mcp23018_output_with_pullup() {
     
     // Configure Port B pin 0 as output with pullup via single-pin API
     mcp23018_mcp->setPinMode(8, OUTPUT);  // B0
-    Adafruit_MCP23X18& mcp = mcp23018_mcp->getMcp();
-    mcp.setPullup(8, true);  // Enable pullup on output (MCP23018-specific)
+    MoaMcpRegisterFile& regs = mcp23018_mcp->getRegisters();
+    regs.setBits(MCP23018_REG_GPPUB, 0x01, 0x01);  // Enable pullup on output (MCP23018-specific)
+    regs.commit();
     
     // Write HIGH and verify
     mcp23018_mcp->writePin(8, true);